@@ -0,0 +1,15 @@
+# Resolves find_package(Freetype), as called by SDL3_ttf, to the FreeType submodule target
+# built by the top-level CMakeLists.txt. Falls back to CMake's own module otherwise.
+if(TARGET freetype)
+    if(NOT TARGET Freetype::Freetype)
+        add_library(Freetype::Freetype ALIAS freetype)
+    endif()
+    get_target_property(FREETYPE_INCLUDE_DIRS freetype INTERFACE_INCLUDE_DIRECTORIES)
+    set(FREETYPE_LIBRARIES freetype)
+    set(FREETYPE_FOUND TRUE)
+    set(Freetype_FOUND TRUE)
+else()
+    list(REMOVE_ITEM CMAKE_MODULE_PATH ${CMAKE_CURRENT_LIST_DIR})
+    include(${CMAKE_ROOT}/Modules/FindFreetype.cmake)
+    list(APPEND CMAKE_MODULE_PATH ${CMAKE_CURRENT_LIST_DIR})
+endif()
@@ -0,0 +1,156 @@
+//
+// polaris-bench-jobs: measures how polaris::JobSystem scales an embarrassingly parallel
+// per-frame workload with the number of threads, and the fixed cost of scheduling a job.
+//
+// Usage: polaris-bench-jobs [--elements N] [--frames N] [--max-threads N]
+//
+
+#include "Logger.h"
+#include "jobs/JobSystem.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <thread>
+#include <vector>
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+struct Particle {
+    float x, y, vx, vy;
+};
+
+/**
+ * @brief Roughly a few dozen nanoseconds of floating point work per element, like a
+ * particle or transform update.
+ */
+void updateParticles(Particle* particles, std::size_t begin, std::size_t end) {
+    for (std::size_t i = begin; i < end; ++i) {
+        Particle& p = particles[i];
+        for (int step = 0; step < 4; ++step) {
+            const float distance = std::sqrt(p.x * p.x + p.y * p.y) + 1.0f;
+            p.vx += -p.x / (distance * distance * distance) * 0.01f;
+            p.vy += -p.y / (distance * distance * distance) * 0.01f;
+            p.x += p.vx * 0.016f;
+            p.y += p.vy * 0.016f;
+        }
+    }
+}
+
+void resetParticles(std::vector<Particle>& particles) {
+    for (std::size_t i = 0; i < particles.size(); ++i) {
+        const float angle = static_cast<float>(i) * 0.001f;
+        particles[i] = {std::cos(angle) * 10.0f, std::sin(angle) * 10.0f, 0.0f, 0.0f};
+    }
+}
+
+/**
+ * @brief Median frame time in milliseconds of running the update over all particles.
+ */
+double measureFrames(polaris::JobSystem* jobs, std::vector<Particle>& particles, int frames) {
+    std::vector<double> times;
+    times.reserve(static_cast<std::size_t>(frames));
+    Particle* data = particles.data();
+
+    for (int frame = 0; frame < frames; ++frame) {
+        const Clock::time_point start = Clock::now();
+        if (jobs) {
+            jobs->parallelFor(particles.size(), [data](std::size_t begin, std::size_t end) {
+                updateParticles(data, begin, end);
+            }, 256);
+        } else {
+            updateParticles(data, 0, particles.size());
+        }
+        times.push_back(std::chrono::duration<double, std::milli>(Clock::now() - start).count());
+    }
+
+    std::sort(times.begin(), times.end());
+    return times[times.size() / 2];
+}
+
+/**
+ * @brief Average cost in nanoseconds of scheduling and completing one empty job.
+ */
+double measureJobOverhead(polaris::JobSystem& jobs, int jobCount) {
+    polaris::JobCounter counter;
+    const Clock::time_point start = Clock::now();
+    for (int i = 0; i < jobCount; ++i) {
+        jobs.schedule([]() {}, &counter);
+        if ((i & 1023) == 1023) {
+            jobs.wait(counter);
+        }
+    }
+    jobs.wait(counter);
+    return std::chrono::duration<double, std::nano>(Clock::now() - start).count() / jobCount;
+}
+
+void printUsage() {
+    std::fprintf(stderr, "Usage: polaris-bench-jobs [--elements N] [--frames N] [--max-threads N]\n");
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    std::size_t elements = 1 << 20;
+    int frames = 60;
+    unsigned maxThreads = std::max(1u, std::thread::hardware_concurrency());
+
+    for (int i = 1; i < argc; ++i) {
+        if (std::strcmp(argv[i], "--elements") == 0 && i + 1 < argc) {
+            elements = std::strtoull(argv[++i], nullptr, 10);
+        } else if (std::strcmp(argv[i], "--frames") == 0 && i + 1 < argc) {
+            frames = std::max(1, std::atoi(argv[++i]));
+        } else if (std::strcmp(argv[i], "--max-threads") == 0 && i + 1 < argc) {
+            maxThreads = static_cast<unsigned>(std::max(1, std::atoi(argv[++i])));
+        } else {
+            printUsage();
+            return std::strcmp(argv[i], "--help") == 0 ? 0 : 1;
+        }
+    }
+
+    polaris::LoggerConfig loggerConfig;
+    polaris::Logger::getInstance().initialize("", loggerConfig);
+    polaris::Logger::getInstance().setLogLevel(polaris::LogLevel::WARN);
+
+    std::vector<Particle> particles(elements);
+    resetParticles(particles);
+    const double serialMs = measureFrames(nullptr, particles, frames);
+
+    std::printf("parallelFor over %zu elements, median of %d frames (%u hardware threads)\n",
+                elements, frames, std::thread::hardware_concurrency());
+    std::printf("%8s %12s %10s %12s\n", "threads", "frame ms", "speedup", "efficiency");
+    std::printf("%8s %12.3f %10s %12s\n", "serial", serialMs, "1.00", "-");
+
+    std::vector<unsigned> threadCounts;
+    for (unsigned threads = 1; threads < maxThreads; threads = threads < 4 ? threads + 1 : threads * 2) {
+        threadCounts.push_back(threads);
+    }
+    threadCounts.push_back(maxThreads);
+
+    for (unsigned threads : threadCounts) {
+        // A single thread measures the inline path a JobSystem takes before initialize().
+        polaris::JobSystem jobs;
+        if (threads > 1) {
+            polaris::JobSystemConfig config;
+            config.workerThreads = threads - 1;
+            jobs.initialize(config);
+        }
+
+        resetParticles(particles);
+        const double ms = measureFrames(&jobs, particles, frames);
+        const double speedup = serialMs / ms;
+        std::printf("%8u %12.3f %10.2f %11.0f%%\n", threads, ms, speedup, speedup / threads * 100.0);
+
+        if (threads == maxThreads && jobs.isRunning()) {
+            std::printf("\nschedule + execute of an empty job: %.0f ns (%u threads)\n",
+                        measureJobOverhead(jobs, 200000), threads);
+        }
+    }
+
+    polaris::Logger::getInstance().shutdown();
+    return 0;
+}
@@ -0,0 +1,1044 @@
+//
+// polaris_bench: runs scripted engine scenarios headless, reports frame time percentiles and
+// throughput as JSON, and optionally compares them against a stored baseline.
+//
+// Usage: polaris_bench [--frames N] [--scenario NAME ...] [--output results.json]
+//                      [--baseline baseline.json] [--tolerance 0.10] [--renderer sdl|software|vulkan]
+//                      [--max-allocations-per-frame N] [--list]
+//
+// To record a baseline, run with --output and keep the file. With --baseline, the exit code
+// is 2 if any gated metric is worse than the baseline by more than the tolerance.
+//
+// The frame scenarios also count global operator new calls per frame once warmed up;
+// steady-state frames are expected to make none. With --max-allocations-per-frame, the exit
+// code is 3 if any scenario makes more (CTest runs it with 0 as bench-zero-allocations).
+//
+
+#include "Application.h"
+#include "Logger.h"
+#include "audio/AudioEngine.h"
+#include "math/Batch.h"
+#include <algorithm>
+#include <cctype>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <atomic>
+#include <map>
+#include <memory_resource>
+#include <new>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+#if POLARIS_ENABLE_MEMORY_TRACKING
+
+namespace {
+
+/**
+ * @brief Calls to the global operator new from any thread, as counted by the engine's tracker.
+ */
+std::uint64_t allocationCount() {
+    std::uint64_t count = 0;
+    for (std::size_t tag = 0; tag < static_cast<std::size_t>(polaris::MemoryTag::Count); ++tag) {
+        count += polaris::MemoryTracker::getInstance().getTagStats(static_cast<polaris::MemoryTag>(tag)).totalAllocations;
+    }
+    return count;
+}
+
+} // namespace
+
+#else
+
+namespace {
+
+/**
+ * @brief Calls to the global operator new (every form), from any thread.
+ */
+std::atomic<std::uint64_t> g_allocations{0};
+
+void* countedAllocate(std::size_t size) {
+    g_allocations.fetch_add(1, std::memory_order_relaxed);
+    return std::malloc(size == 0 ? 1 : size);
+}
+
+void* countedAllocateAligned(std::size_t size, std::size_t alignment) {
+    g_allocations.fetch_add(1, std::memory_order_relaxed);
+    size = (size + alignment - 1) / alignment * alignment;
+#ifdef _WIN32
+    return _aligned_malloc(size == 0 ? alignment : size, alignment);
+#else
+    return std::aligned_alloc(alignment, size == 0 ? alignment : size);
+#endif
+}
+
+void freeAligned(void* pointer) {
+#ifdef _WIN32
+    _aligned_free(pointer);
+#else
+    std::free(pointer);
+#endif
+}
+
+} // namespace
+
+void* operator new(std::size_t size) {
+    if (void* pointer = countedAllocate(size)) {
+        return pointer;
+    }
+    throw std::bad_alloc();
+}
+
+void* operator new[](std::size_t size) {
+    return ::operator new(size);
+}
+
+void* operator new(std::size_t size, const std::nothrow_t&) noexcept {
+    return countedAllocate(size);
+}
+
+void* operator new[](std::size_t size, const std::nothrow_t&) noexcept {
+    return countedAllocate(size);
+}
+
+void* operator new(std::size_t size, std::align_val_t alignment) {
+    if (void* pointer = countedAllocateAligned(size, static_cast<std::size_t>(alignment))) {
+        return pointer;
+    }
+    throw std::bad_alloc();
+}
+
+void* operator new[](std::size_t size, std::align_val_t alignment) {
+    return ::operator new(size, alignment);
+}
+
+void operator delete(void* pointer) noexcept { std::free(pointer); }
+void operator delete[](void* pointer) noexcept { std::free(pointer); }
+void operator delete(void* pointer, std::size_t) noexcept { std::free(pointer); }
+void operator delete[](void* pointer, std::size_t) noexcept { std::free(pointer); }
+void operator delete(void* pointer, std::align_val_t) noexcept { freeAligned(pointer); }
+void operator delete[](void* pointer, std::align_val_t) noexcept { freeAligned(pointer); }
+void operator delete(void* pointer, std::size_t, std::align_val_t) noexcept { freeAligned(pointer); }
+void operator delete[](void* pointer, std::size_t, std::align_val_t) noexcept { freeAligned(pointer); }
+
+namespace {
+
+std::uint64_t allocationCount() {
+    return g_allocations.load(std::memory_order_relaxed);
+}
+
+} // namespace
+
+#endif // POLARIS_ENABLE_MEMORY_TRACKING
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+struct Metric {
+    std::string name;
+    double value;
+    bool lowerIsBetter;
+    bool gated; ///< Compared against the baseline; noisy metrics like max are report-only
+};
+
+struct ScenarioResult {
+    std::string name;
+    std::vector<Metric> metrics;
+};
+
+/**
+ * @brief Frames skipped before timing and allocation counting start.
+ */
+constexpr std::uint64_t kWarmupFrames = 10;
+
+struct BenchOptions {
+    std::uint64_t frames = 300;
+    int startupRuns = 5;
+    int logThreads = 4;
+    int logMessagesPerThread = 50000;
+    polaris::RendererBackend renderer = polaris::RendererBackend::SDL;
+};
+
+/**
+ * @brief Nearest-rank percentile of sorted values, p in [0, 1].
+ */
+double percentile(const std::vector<double>& sorted, double p) {
+    if (sorted.empty()) {
+        return 0.0;
+    }
+    const std::size_t rank = static_cast<std::size_t>(std::ceil(p * static_cast<double>(sorted.size())));
+    return sorted[std::min(sorted.size() - 1, rank > 0 ? rank - 1 : 0)];
+}
+
+double mean(const std::vector<double>& values) {
+    double sum = 0.0;
+    for (double value : values) {
+        sum += value;
+    }
+    return values.empty() ? 0.0 : sum / static_cast<double>(values.size());
+}
+
+void addFrameMetrics(ScenarioResult& result, std::vector<double> frameMs) {
+    std::sort(frameMs.begin(), frameMs.end());
+    const double average = mean(frameMs);
+    result.metrics.push_back({"frame_ms_mean", average, true, false});
+    result.metrics.push_back({"frame_ms_p50", percentile(frameMs, 0.50), true, true});
+    result.metrics.push_back({"frame_ms_p90", percentile(frameMs, 0.90), true, false});
+    result.metrics.push_back({"frame_ms_p99", percentile(frameMs, 0.99), true, true});
+    result.metrics.push_back({"frame_ms_max", frameMs.empty() ? 0.0 : frameMs.back(), true, false});
+    result.metrics.push_back({"fps", average > 0.0 ? 1000.0 / average : 0.0, false, false});
+}
+
+/**
+ * @brief Headless application drawing a fixed number of moving sprites every frame and
+ * recording the time between consecutive frames.
+ */
+class BenchApplication : public polaris::Application {
+public:
+    /**
+     * @param worldSize 0 scatters the sprites over the window and draws them all; otherwise they
+     * are scattered over a worldSize square, kept in the engine's spatial index, and a panning
+     * camera draws only those it sees.
+     */
+    BenchApplication(std::size_t spriteCount, std::uint64_t frames, float worldSize = 0.0f,
+                     polaris::EngineConfig config = polaris::EngineConfig())
+        : m_spriteCount(spriteCount), m_worldSize(worldSize) {
+        config.headless = true;
+        config.maxFrames = frames;
+        m_engine.setConfig(config);
+
+        polaris::FrameConfig frameConfig;
+        frameConfig.pacing = polaris::FramePacing::Uncapped;
+        m_engine.setFrameConfig(frameConfig);
+
+        m_frameMs.reserve(static_cast<std::size_t>(frames));
+    }
+
+    void OnCreated() override {
+        if (m_spriteCount == 0) {
+            return;
+        }
+
+        // A white disc, so every sprite samples the same texture and batches into one draw
+        std::vector<std::uint32_t> pixels(32 * 32);
+        for (int y = 0; y < 32; ++y) {
+            for (int x = 0; x < 32; ++x) {
+                const float dx = static_cast<float>(x) - 15.5f;
+                const float dy = static_cast<float>(y) - 15.5f;
+                pixels[y * 32 + x] = dx * dx + dy * dy < 256.0f ? 0xFFFFFFFFu : 0u;
+            }
+        }
+        polaris::CommandList uploads = m_engine.createCommandList();
+        m_texture = uploads.CreateTexture(32, 32, polaris::TextureAccess::Static, pixels.data());
+        m_engine.executeCommands(uploads);
+
+        const polaris::EngineConfig& config = m_engine.getConfig();
+        const std::uint32_t areaWidth = m_worldSize > 0.0f ? static_cast<std::uint32_t>(m_worldSize) : config.windowWidth;
+        const std::uint32_t areaHeight = m_worldSize > 0.0f ? static_cast<std::uint32_t>(m_worldSize) : config.windowHeight;
+        m_sprites.resize(m_spriteCount);
+        m_origins.resize(m_spriteCount);
+        std::uint32_t seed = 12345u;
+        for (std::size_t i = 0; i < m_spriteCount; ++i) {
+            seed = seed * 1664525u + 1013904223u;
+            const float x = static_cast<float>(seed % areaWidth);
+            seed = seed * 1664525u + 1013904223u;
+            const float y = static_cast<float>(seed % areaHeight);
+            m_origins[i] = {x, y};
+
+            polaris::Sprite& sprite = m_sprites[i];
+            sprite.destination = {x, y, 16.0f, 16.0f};
+            sprite.texture = m_texture;
+            sprite.color = {static_cast<float>(i % 7) / 6.0f, 0.5f, 1.0f, 1.0f};
+        }
+
+        if (m_worldSize > 0.0f) {
+            polaris::SpatialGrid& index = getSpatialIndex();
+            m_handles.resize(m_spriteCount);
+            for (std::size_t i = 0; i < m_spriteCount; ++i) {
+                const SDL_FRect& rect = m_sprites[i].destination;
+                m_handles[i] = index.insert(polaris::Bounds::fromRect(rect.x, rect.y, rect.w, rect.h), i);
+            }
+        }
+    }
+
+    void render(double alpha, polaris::CommandList& commands) override {
+        (void)alpha;
+        const Clock::time_point now = Clock::now();
+        if (m_frame > 0) {
+            m_frameMs.push_back(std::chrono::duration<double, std::milli>(now - m_lastFrame).count());
+        }
+        m_lastFrame = now;
+
+        const std::uint64_t allocations = allocationCount();
+        if (m_frame == kWarmupFrames) {
+            m_allocationsAtWarmup = allocations;
+        }
+        m_allocationsAtLastFrame = allocations;
+
+        commands.Clear({0.1f, 0.1f, 0.12f, 1.0f});
+        if (m_worldSize > 0.0f) {
+            renderWorld(commands);
+        } else {
+            renderScreen(commands);
+        }
+
+        m_lastStats = m_engine.getRenderStats();
+        const polaris::SpatialStats& spatial = m_engine.getSpatialStats();
+        if (m_frame > kWarmupFrames) {
+            m_spatialCandidates += spatial.candidates;
+            m_spatialResults += spatial.results;
+        }
+        ++m_frame;
+    }
+
+    /**
+     * @brief All sprites wobble and are culled against the window edges one by one.
+     */
+    void renderScreen(polaris::CommandList& commands) {
+        // Cull into a per-frame list; it lives in the frame arena, so building it costs no heap allocation
+        const float width = static_cast<float>(m_engine.getConfig().windowWidth);
+        const float phase = static_cast<float>(m_frame) * 0.05f;
+        std::pmr::vector<polaris::Sprite> visible(getFrameArena().getResource());
+        visible.reserve(m_sprites.size());
+        for (std::size_t i = 0; i < m_sprites.size(); ++i) {
+            polaris::Sprite& sprite = m_sprites[i];
+            sprite.destination.x = m_origins[i].x + std::sin(phase + static_cast<float>(i)) * 8.0f;
+            if (sprite.destination.x + sprite.destination.w > 0.0f && sprite.destination.x < width) {
+                visible.push_back(sprite);
+            }
+        }
+        if (!visible.empty()) {
+            commands.DrawSprites(visible.data(), visible.size());
+        }
+    }
+
+    /**
+     * @brief A fixed number of sprites move each frame and the camera pans across the world;
+     * only what the spatial index finds in view is drawn, so the cost follows the view.
+     */
+    void renderWorld(polaris::CommandList& commands) {
+        constexpr std::size_t kMovingPerFrame = 1000;
+        polaris::SpatialGrid& index = getSpatialIndex();
+        const float phase = static_cast<float>(m_frame) * 0.05f;
+        for (std::size_t n = 0; n < kMovingPerFrame && n < m_sprites.size(); ++n) {
+            const std::size_t i = (m_frame * kMovingPerFrame + n) % m_sprites.size();
+            SDL_FRect& rect = m_sprites[i].destination;
+            rect.x = m_origins[i].x + std::sin(phase + static_cast<float>(i)) * 8.0f;
+            index.update(m_handles[i], polaris::Bounds::fromRect(rect.x, rect.y, rect.w, rect.h));
+        }
+
+        const polaris::EngineConfig& config = m_engine.getConfig();
+        const float viewWidth = static_cast<float>(config.windowWidth);
+        const float viewHeight = static_cast<float>(config.windowHeight);
+        const float cameraX = std::fmod(static_cast<float>(m_frame) * 4.0f, m_worldSize - viewWidth);
+        const float cameraY = (m_worldSize - viewHeight) * 0.5f;
+
+        std::pmr::vector<polaris::Sprite> visible(getFrameArena().getResource());
+        index.query(polaris::Bounds::fromRect(cameraX, cameraY, viewWidth, viewHeight),
+                    [&](polaris::SpatialHandle, std::uint64_t i) {
+                        polaris::Sprite sprite = m_sprites[static_cast<std::size_t>(i)];
+                        sprite.destination.x -= cameraX;
+                        sprite.destination.y -= cameraY;
+                        visible.push_back(sprite);
+                    });
+        if (!visible.empty()) {
+            commands.DrawSprites(visible.data(), visible.size());
+        }
+    }
+
+    /**
+     * @brief Frame times in milliseconds, without the first warmupFrames frames.
+     */
+    std::vector<double> frameTimes(std::size_t warmupFrames) const {
+        const std::size_t skip = std::min(warmupFrames, m_frameMs.size());
+        return std::vector<double>(m_frameMs.begin() + static_cast<std::ptrdiff_t>(skip), m_frameMs.end());
+    }
+
+    const polaris::RenderStats& lastStats() const { return m_lastStats; }
+
+    /**
+     * @brief Objects tested and objects found by spatial queries, per frame after warm-up.
+     */
+    double spatialCandidatesPerFrame() const { return perTimedFrame(m_spatialCandidates); }
+    double spatialResultsPerFrame() const { return perTimedFrame(m_spatialResults); }
+
+    /**
+     * @brief Average operator new calls per frame after the warm-up frames, on all threads.
+     */
+    double allocationsPerFrame() const {
+        if (m_frame <= kWarmupFrames + 1) {
+            return 0.0;
+        }
+        return static_cast<double>(m_allocationsAtLastFrame - m_allocationsAtWarmup) /
+               static_cast<double>(m_frame - 1 - kWarmupFrames);
+    }
+
+private:
+    struct Origin {
+        float x, y;
+    };
+
+    double perTimedFrame(std::uint64_t total) const {
+        return m_frame > kWarmupFrames + 1 ? static_cast<double>(total) / static_cast<double>(m_frame - 1 - kWarmupFrames)
+                                           : 0.0;
+    }
+
+    std::size_t m_spriteCount;
+    float m_worldSize;
+    std::vector<polaris::SpatialHandle> m_handles;
+    std::uint64_t m_spatialCandidates = 0;
+    std::uint64_t m_spatialResults = 0;
+    polaris::TextureHandle m_texture = 0;
+    std::vector<polaris::Sprite> m_sprites;
+    std::vector<Origin> m_origins;
+    std::vector<double> m_frameMs;
+    Clock::time_point m_lastFrame;
+    std::uint64_t m_frame = 0;
+    std::uint64_t m_allocationsAtWarmup = 0;
+    std::uint64_t m_allocationsAtLastFrame = 0;
+    polaris::RenderStats m_lastStats;
+};
+
+/**
+ * @param windowWidth Window size for the scenario; 0 keeps the engine's default.
+ */
+ScenarioResult runFrameScenario(const std::string& name, std::size_t spriteCount, const BenchOptions& options,
+                                float worldSize = 0.0f, int windowWidth = 0, int windowHeight = 0) {
+    polaris::EngineConfig config;
+    config.renderer = options.renderer;
+    if (windowWidth > 0 && windowHeight > 0) {
+        config.windowWidth = windowWidth;
+        config.windowHeight = windowHeight;
+    }
+    BenchApplication app(spriteCount, options.frames, worldSize, config);
+    app.initialize();
+    const Clock::time_point start = Clock::now();
+    app.run();
+    const double seconds = std::chrono::duration<double>(Clock::now() - start).count();
+
+    ScenarioResult result{name, {}};
+    addFrameMetrics(result, app.frameTimes(kWarmupFrames));
+    result.metrics.push_back({"allocations_per_frame", app.allocationsPerFrame(), true, true});
+    if (spriteCount > 0 && worldSize == 0.0f) {
+        const double spritesPerSecond = seconds > 0.0 ? static_cast<double>(spriteCount * options.frames) / seconds : 0.0;
+        result.metrics.push_back({"sprites_per_s", spritesPerSecond, false, true});
+    }
+    if (spriteCount > 0) {
+        result.metrics.push_back({"draw_calls", static_cast<double>(app.lastStats().drawCalls), true, true});
+    }
+    if (worldSize > 0.0f) {
+        result.metrics.push_back({"visible_per_frame", app.spatialResultsPerFrame(), false, false});
+        result.metrics.push_back({"cull_candidates_per_frame", app.spatialCandidatesPerFrame(), true, true});
+    }
+    return result;
+}
+
+/**
+ * @brief Time to initialize the engine (SDL, window, renderer, job system), render the first
+ * frame and shut down, over several runs.
+ */
+ScenarioResult runStartupScenario(const BenchOptions& options) {
+    std::vector<double> initMs;
+    std::vector<double> totalMs;
+    for (int run = 0; run < options.startupRuns; ++run) {
+        const Clock::time_point start = Clock::now();
+        polaris::EngineConfig config;
+        config.renderer = options.renderer;
+        BenchApplication app(0, 1, 0.0f, config);
+        app.initialize();
+        const Clock::time_point initialized = Clock::now();
+        app.run();
+        const Clock::time_point end = Clock::now();
+        initMs.push_back(std::chrono::duration<double, std::milli>(initialized - start).count());
+        totalMs.push_back(std::chrono::duration<double, std::milli>(end - start).count());
+    }
+    std::sort(initMs.begin(), initMs.end());
+    std::sort(totalMs.begin(), totalMs.end());
+
+    ScenarioResult result{"startup", {}};
+    result.metrics.push_back({"init_ms_p50", percentile(initMs, 0.5), true, true});
+    result.metrics.push_back({"init_ms_max", initMs.back(), true, false});
+    result.metrics.push_back({"first_frame_and_shutdown_ms_p50", percentile(totalMs, 0.5), true, true});
+    return result;
+}
+
+/**
+ * @brief Several threads logging as fast as they can: cost of a LOG_* call on the calling
+ * thread, and end-to-end throughput until the writer has flushed everything.
+ */
+ScenarioResult runLoggingBurstScenario(const BenchOptions& options) {
+    polaris::Logger& logger = polaris::Logger::getInstance();
+    logger.flush();
+
+    std::vector<std::vector<double>> latencies(static_cast<std::size_t>(options.logThreads));
+    const Clock::time_point start = Clock::now();
+    std::vector<std::thread> threads;
+    for (int t = 0; t < options.logThreads; ++t) {
+        threads.emplace_back([t, &options, &latencies]() {
+            std::vector<double>& samples = latencies[static_cast<std::size_t>(t)];
+            samples.reserve(static_cast<std::size_t>(options.logMessagesPerThread));
+            for (int i = 0; i < options.logMessagesPerThread; ++i) {
+                const Clock::time_point before = Clock::now();
+                LOG_INFO("bench thread {} message {} value {:.3f}", t, i, i * 0.5);
+                samples.push_back(std::chrono::duration<double, std::nano>(Clock::now() - before).count());
+            }
+        });
+    }
+    for (std::thread& thread : threads) {
+        thread.join();
+    }
+    logger.flush();
+    const double seconds = std::chrono::duration<double>(Clock::now() - start).count();
+
+    std::vector<double> all;
+    for (const std::vector<double>& samples : latencies) {
+        all.insert(all.end(), samples.begin(), samples.end());
+    }
+    std::sort(all.begin(), all.end());
+
+    const double messages = static_cast<double>(options.logThreads) * options.logMessagesPerThread;
+    ScenarioResult result{"logging_burst", {}};
+    result.metrics.push_back({"log_call_ns_p50", percentile(all, 0.50), true, true});
+    result.metrics.push_back({"log_call_ns_p99", percentile(all, 0.99), true, true});
+    result.metrics.push_back({"log_call_ns_max", all.empty() ? 0.0 : all.back(), true, false});
+    result.metrics.push_back({"messages_per_s", seconds > 0.0 ? messages / seconds : 0.0, false, true});
+    return result;
+}
+
+struct BenchPosition {
+    float x, y, z;
+};
+
+struct BenchVelocity {
+    float x, y, z;
+};
+
+/**
+ * @brief One million entities integrating velocity into position through an ECS query,
+ * against the same loop over plain arrays. The query should stay close to the raw loop, which
+ * is bound by memory bandwidth.
+ */
+ScenarioResult runEcsIterateScenario() {
+    constexpr std::size_t kEntities = 1000000;
+    constexpr int kPasses = 20;
+    const float dt = 1.0f / 60.0f;
+
+    polaris::World world;
+    for (std::size_t i = 0; i < kEntities; ++i) {
+        const float f = static_cast<float>(i);
+        world.create(BenchPosition{f, 0.0f, 0.0f}, BenchVelocity{1.0f, f * 0.001f, -1.0f});
+    }
+    std::vector<BenchPosition> rawPositions(kEntities);
+    std::vector<BenchVelocity> rawVelocities(kEntities);
+    for (std::size_t i = 0; i < kEntities; ++i) {
+        const float f = static_cast<float>(i);
+        rawPositions[i] = BenchPosition{f, 0.0f, 0.0f};
+        rawVelocities[i] = BenchVelocity{1.0f, f * 0.001f, -1.0f};
+    }
+
+    std::vector<double> queryNs;
+    std::vector<double> rawNs;
+    const auto query = world.query<BenchPosition, const BenchVelocity>();
+    for (int pass = 0; pass < kPasses + 2; ++pass) {
+        Clock::time_point start = Clock::now();
+        query.each([dt](BenchPosition& p, const BenchVelocity& v) {
+            p.x += v.x * dt;
+            p.y += v.y * dt;
+            p.z += v.z * dt;
+        });
+        const double queryTime = std::chrono::duration<double, std::nano>(Clock::now() - start).count();
+
+        start = Clock::now();
+        BenchPosition* positions = rawPositions.data();
+        const BenchVelocity* velocities = rawVelocities.data();
+        for (std::size_t i = 0; i < kEntities; ++i) {
+            positions[i].x += velocities[i].x * dt;
+            positions[i].y += velocities[i].y * dt;
+            positions[i].z += velocities[i].z * dt;
+        }
+        const double rawTime = std::chrono::duration<double, std::nano>(Clock::now() - start).count();
+
+        // The first passes fault in pages and warm the caches
+        if (pass >= 2) {
+            queryNs.push_back(queryTime / kEntities);
+            rawNs.push_back(rawTime / kEntities);
+        }
+    }
+    std::sort(queryNs.begin(), queryNs.end());
+    std::sort(rawNs.begin(), rawNs.end());
+
+    // Position is read and written, velocity read: 36 bytes of traffic per entity
+    const double nsPerEntity = percentile(queryNs, 0.5);
+    const double bytesPerEntity = 2.0 * sizeof(BenchPosition) + sizeof(BenchVelocity);
+    ScenarioResult result{"ecs_iterate_1m", {}};
+    result.metrics.push_back({"ns_per_entity", nsPerEntity, true, true});
+    result.metrics.push_back({"raw_ns_per_entity", percentile(rawNs, 0.5), true, false});
+    result.metrics.push_back({"bandwidth_gb_s", nsPerEntity > 0.0 ? bytesPerEntity / nsPerEntity : 0.0, false, false});
+    return result;
+}
+
+/**
+ * @brief Batch 3D point transforms with the scalar kernel and with the widest one this CPU
+ * supports, on a cache-resident batch so the comparison measures the kernels rather than
+ * memory bandwidth.
+ */
+ScenarioResult runMathTransformScenario() {
+    namespace math = polaris::math;
+    constexpr std::size_t kPoints = 4096;
+    constexpr int kRepeats = 2000;
+
+    std::vector<float> x(kPoints), y(kPoints), z(kPoints), outX(kPoints), outY(kPoints), outZ(kPoints);
+    for (std::size_t i = 0; i < kPoints; ++i) {
+        x[i] = static_cast<float>(i);
+        y[i] = static_cast<float>(i % 17);
+        z[i] = -static_cast<float>(i) * 0.25f;
+    }
+    const math::Mat4 transform =
+        math::Mat4::fromTRS({1.0f, 2.0f, 3.0f}, math::Quat::fromAxisAngle({0.0f, 0.0f, 1.0f}, 0.5f), {2.0f, 2.0f, 2.0f});
+
+    // Best of several runs of kRepeats batches, in points per second
+    const auto measure = [&](math::SimdLevel level) {
+        math::setSimdLevel(level);
+        double best = 0.0;
+        for (int run = 0; run < 5; ++run) {
+            const Clock::time_point start = Clock::now();
+            for (int r = 0; r < kRepeats; ++r) {
+                math::transformPoints3(transform, x.data(), y.data(), z.data(), outX.data(), outY.data(), outZ.data(),
+                                       kPoints);
+            }
+            const double seconds = std::chrono::duration<double>(Clock::now() - start).count();
+            best = std::max(best, seconds > 0.0 ? kPoints * static_cast<double>(kRepeats) / seconds : 0.0);
+        }
+        return best;
+    };
+
+    const math::SimdLevel widest = math::getSupportedSimdLevel();
+    const double scalar = measure(math::SimdLevel::Scalar);
+    const double simd = measure(widest);
+    math::setSimdLevel(widest);
+    std::fprintf(stderr, "  math kernels: %s\n", math::getSimdLevelName(widest));
+
+    ScenarioResult result{"math_transform", {}};
+    result.metrics.push_back({"scalar_mpoints_s", scalar / 1e6, false, false});
+    result.metrics.push_back({"simd_mpoints_s", simd / 1e6, false, true});
+    result.metrics.push_back({"simd_speedup", scalar > 0.0 ? simd / scalar : 0.0, false, false});
+    return result;
+}
+
+/**
+ * @brief Writes a one-second 48 kHz stereo 16-bit sine WAV for the audio scenario.
+ */
+bool writeToneWav(const std::string& path) {
+    constexpr std::uint32_t kRate = 48000;
+    constexpr std::uint32_t kFrames = kRate;
+    std::vector<std::int16_t> samples(kFrames * 2);
+    for (std::uint32_t i = 0; i < kFrames; ++i) {
+        const auto value = static_cast<std::int16_t>(std::sin(static_cast<double>(i) * 0.0576) * 8000.0);
+        samples[2 * i] = value;
+        samples[2 * i + 1] = value;
+    }
+
+    const std::uint32_t dataBytes = kFrames * 4;
+    const auto put32 = [](std::ofstream& file, std::uint32_t value) {
+        const char bytes[4] = {static_cast<char>(value), static_cast<char>(value >> 8), static_cast<char>(value >> 16),
+                               static_cast<char>(value >> 24)};
+        file.write(bytes, 4);
+    };
+    const auto put16 = [](std::ofstream& file, std::uint16_t value) {
+        const char bytes[2] = {static_cast<char>(value), static_cast<char>(value >> 8)};
+        file.write(bytes, 2);
+    };
+    std::ofstream file(path, std::ios::binary);
+    file.write("RIFF", 4);
+    put32(file, 36 + dataBytes);
+    file.write("WAVEfmt ", 8);
+    put32(file, 16);
+    put16(file, 1);           // PCM
+    put16(file, 2);           // channels
+    put32(file, kRate);
+    put32(file, kRate * 4);   // bytes per second
+    put16(file, 4);           // bytes per frame
+    put16(file, 16);          // bits per sample
+    file.write("data", 4);
+    put32(file, dataBytes);
+    for (std::int16_t sample : samples) {
+        put16(file, static_cast<std::uint16_t>(sample));
+    }
+    return static_cast<bool>(file);
+}
+
+/**
+ * @brief 256 looping voices mixed for two seconds on SDL's dummy audio driver, which calls
+ * back at the real device rate: mixing cost per callback and callbacks that ran late.
+ */
+ScenarioResult runAudioMixScenario() {
+    constexpr int kVoices = 256;
+    const std::string tonePath = "polaris_bench_tone.wav";
+    if (!writeToneWav(tonePath)) {
+        throw std::runtime_error("cannot write " + tonePath);
+    }
+
+    SDL_SetHint(SDL_HINT_AUDIO_DRIVER, "dummy");
+    polaris::AudioEngine audio;
+    polaris::AudioConfig config;
+    config.maxVoices = kVoices;
+    if (!audio.initialize(config)) {
+        throw std::runtime_error("no audio device");
+    }
+    const polaris::SoundHandle tone = audio.loadSound(tonePath);
+    std::remove(tonePath.c_str());
+    for (int i = 0; i < kVoices; ++i) {
+        polaris::VoiceParams params;
+        params.volume = 1.0f / kVoices;
+        params.pan = static_cast<float>(i % 9) / 4.0f - 1.0f;
+        params.loop = true;
+        audio.play(tone, params);
+    }
+
+    std::this_thread::sleep_for(std::chrono::milliseconds(200));
+    audio.takeStats();
+    std::this_thread::sleep_for(std::chrono::seconds(2));
+    const polaris::AudioStats stats = audio.takeStats();
+    audio.shutdown();
+
+    ScenarioResult result{"audio_mix_256", {}};
+    const double callbacks = static_cast<double>(std::max<std::uint64_t>(stats.callbacks, 1));
+    result.metrics.push_back({"mix_us_per_callback", stats.mixSeconds * 1e6 / callbacks, true, true});
+    result.metrics.push_back({"late_callbacks", static_cast<double>(stats.lateCallbacks), true, true});
+    result.metrics.push_back({"max_callback_ms", stats.maxCallbackMs, true, false});
+    result.metrics.push_back({"voices", static_cast<double>(stats.peakVoices), false, false});
+    return result;
+}
+
+/**
+ * @brief Minimal JSON reader that flattens every number in a document into "a.b.c" paths.
+ * Enough for the files this tool writes.
+ */
+class JsonNumbers {
+public:
+    bool parse(const std::string& text, std::map<std::string, double>& numbers) {
+        m_text = &text;
+        m_pos = 0;
+        m_numbers = &numbers;
+        if (!parseValue("")) {
+            return false;
+        }
+        skipSpace();
+        return m_pos == text.size();
+    }
+
+private:
+    void skipSpace() {
+        while (m_pos < m_text->size() && std::isspace(static_cast<unsigned char>((*m_text)[m_pos]))) {
+            ++m_pos;
+        }
+    }
+
+    bool consume(char c) {
+        skipSpace();
+        if (m_pos < m_text->size() && (*m_text)[m_pos] == c) {
+            ++m_pos;
+            return true;
+        }
+        return false;
+    }
+
+    bool parseString(std::string& out) {
+        if (!consume('"')) {
+            return false;
+        }
+        out.clear();
+        while (m_pos < m_text->size() && (*m_text)[m_pos] != '"') {
+            if ((*m_text)[m_pos] == '\\' && m_pos + 1 < m_text->size()) {
+                ++m_pos;
+            }
+            out += (*m_text)[m_pos++];
+        }
+        return consume('"');
+    }
+
+    bool parseValue(const std::string& path) {
+        skipSpace();
+        if (m_pos >= m_text->size()) {
+            return false;
+        }
+
+        const char c = (*m_text)[m_pos];
+        if (c == '{') {
+            ++m_pos;
+            if (consume('}')) {
+                return true;
+            }
+            do {
+                std::string key;
+                if (!parseString(key) || !consume(':') || !parseValue(path.empty() ? key : path + "." + key)) {
+                    return false;
+                }
+            } while (consume(','));
+            return consume('}');
+        }
+        if (c == '[') {
+            ++m_pos;
+            if (consume(']')) {
+                return true;
+            }
+            int index = 0;
+            do {
+                if (!parseValue(path + "." + std::to_string(index++))) {
+                    return false;
+                }
+            } while (consume(','));
+            return consume(']');
+        }
+        if (c == '"') {
+            std::string ignored;
+            return parseString(ignored);
+        }
+        for (const char* literal : {"true", "false", "null"}) {
+            const std::size_t length = std::strlen(literal);
+            if (m_text->compare(m_pos, length, literal) == 0) {
+                m_pos += length;
+                return true;
+            }
+        }
+
+        const char* begin = m_text->c_str() + m_pos;
+        char* end = nullptr;
+        const double value = std::strtod(begin, &end);
+        if (end == begin) {
+            return false;
+        }
+        m_pos += static_cast<std::size_t>(end - begin);
+        (*m_numbers)[path] = value;
+        return true;
+    }
+
+    const std::string* m_text = nullptr;
+    std::size_t m_pos = 0;
+    std::map<std::string, double>* m_numbers = nullptr;
+};
+
+bool writeJson(const std::string& path, const BenchOptions& options, const std::vector<ScenarioResult>& results) {
+    std::FILE* file = path.empty() ? stdout : std::fopen(path.c_str(), "w");
+    if (!file) {
+        return false;
+    }
+
+    std::fprintf(file, "{\n  \"version\": 1,\n  \"frames\": %llu,\n  \"hardware_threads\": %u,\n  \"scenarios\": {",
+                 static_cast<unsigned long long>(options.frames), std::thread::hardware_concurrency());
+    for (std::size_t i = 0; i < results.size(); ++i) {
+        std::fprintf(file, "%s\n    \"%s\": {", i == 0 ? "" : ",", results[i].name.c_str());
+        for (std::size_t m = 0; m < results[i].metrics.size(); ++m) {
+            const Metric& metric = results[i].metrics[m];
+            std::fprintf(file, "%s\n      \"%s\": %.6g", m == 0 ? "" : ",", metric.name.c_str(), metric.value);
+        }
+        std::fprintf(file, "\n    }");
+    }
+    std::fprintf(file, "\n  }\n}\n");
+
+    if (file != stdout) {
+        std::fclose(file);
+    }
+    return true;
+}
+
+/**
+ * @brief Reports the scenarios whose frames allocate more than allowed once warmed up.
+ * @return Number of such scenarios.
+ */
+int countAllocatingScenarios(const std::vector<ScenarioResult>& results, double maxPerFrame) {
+    int failures = 0;
+    for (const ScenarioResult& result : results) {
+        for (const Metric& metric : result.metrics) {
+            if (metric.name == "allocations_per_frame" && metric.value > maxPerFrame) {
+                std::fprintf(stderr, "%s: %.2f allocations per frame after warm-up, at most %.2f allowed\n",
+                             result.name.c_str(), metric.value, maxPerFrame);
+                ++failures;
+            }
+        }
+    }
+    return failures;
+}
+
+/**
+ * @brief Prints every gated metric next to its baseline value.
+ * @return Number of metrics worse than the baseline by more than the tolerance.
+ */
+int compareWithBaseline(const std::vector<ScenarioResult>& results, const std::map<std::string, double>& baseline,
+                        double tolerance) {
+    int regressions = 0;
+    std::fprintf(stderr, "%-16s %-34s %12s %12s %9s\n", "scenario", "metric", "baseline", "current", "change");
+    for (const ScenarioResult& result : results) {
+        for (const Metric& metric : result.metrics) {
+            if (!metric.gated) {
+                continue;
+            }
+            const auto found = baseline.find("scenarios." + result.name + "." + metric.name);
+            if (found == baseline.end()) {
+                std::fprintf(stderr, "%-16s %-34s %12s %12.4g %9s\n", result.name.c_str(), metric.name.c_str(),
+                             "-", metric.value, "new");
+                continue;
+            }
+
+            const double base = found->second;
+            if (base == 0.0) {
+                // No relative change from zero: for lower-is-better metrics such as allocation
+                // counts, anything above zero is a regression
+                const bool regressed = metric.lowerIsBetter ? metric.value > 0.0 : false;
+                regressions += regressed ? 1 : 0;
+                std::fprintf(stderr, "%-16s %-34s %12.4g %12.4g %9s%s\n", result.name.c_str(), metric.name.c_str(),
+                             base, metric.value, "-", regressed ? "  REGRESSION" : "");
+                continue;
+            }
+            const double change = (metric.value - base) / base;
+            const bool regressed = metric.lowerIsBetter ? change > tolerance : change < -tolerance;
+            regressions += regressed ? 1 : 0;
+            std::fprintf(stderr, "%-16s %-34s %12.4g %12.4g %+8.1f%%%s\n", result.name.c_str(), metric.name.c_str(),
+                         base, metric.value, change * 100.0, regressed ? "  REGRESSION" : "");
+        }
+    }
+    return regressions;
+}
+
+/**
+ * @brief World sizes giving both world_cull scenarios the same sprite density, about a thousand
+ * sprites per 1280x720 view, so their frame times should match.
+ */
+constexpr float kWorldCullSize100k = 9600.0f;
+constexpr float kWorldCullSize1m = 30360.0f;
+
+const char* const kScenarios[] = {
+    "empty_loop", "sprites_1k", "sprites_10k", "sprites_100k", "sprites_10k_1080p", "logging_burst", "startup",
+    "ecs_iterate_1m", "math_transform", "world_cull_100k", "world_cull_1m", "audio_mix_256",
+};
+
+void printUsage() {
+    std::fprintf(stderr,
+                 "Usage: polaris_bench [--frames N] [--scenario NAME ...] [--output results.json]\n"
+                 "                     [--baseline baseline.json] [--tolerance 0.10] [--renderer sdl|software|vulkan]\n"
+                 "                     [--max-allocations-per-frame N] [--list]\n");
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    BenchOptions options;
+    std::vector<std::string> selected;
+    std::string outputPath;
+    std::string baselinePath;
+    double tolerance = 0.10;
+    double maxAllocationsPerFrame = -1.0;
+
+    for (int i = 1; i < argc; ++i) {
+        if (std::strcmp(argv[i], "--frames") == 0 && i + 1 < argc) {
+            options.frames = std::max<std::uint64_t>(20, std::strtoull(argv[++i], nullptr, 10));
+        } else if (std::strcmp(argv[i], "--scenario") == 0 && i + 1 < argc) {
+            selected.push_back(argv[++i]);
+        } else if (std::strcmp(argv[i], "--output") == 0 && i + 1 < argc) {
+            outputPath = argv[++i];
+        } else if (std::strcmp(argv[i], "--baseline") == 0 && i + 1 < argc) {
+            baselinePath = argv[++i];
+        } else if (std::strcmp(argv[i], "--tolerance") == 0 && i + 1 < argc) {
+            tolerance = std::atof(argv[++i]);
+        } else if (std::strcmp(argv[i], "--max-allocations-per-frame") == 0 && i + 1 < argc) {
+            maxAllocationsPerFrame = std::atof(argv[++i]);
+        } else if (std::strcmp(argv[i], "--renderer") == 0 && i + 1 < argc) {
+            const char* renderer = argv[++i];
+            if (std::strcmp(renderer, "software") == 0) {
+                options.renderer = polaris::RendererBackend::Software;
+            } else if (std::strcmp(renderer, "vulkan") == 0) {
+                options.renderer = polaris::RendererBackend::Vulkan;
+            } else if (std::strcmp(renderer, "sdl") != 0) {
+                printUsage();
+                return 1;
+            }
+        } else if (std::strcmp(argv[i], "--list") == 0) {
+            for (const char* scenario : kScenarios) {
+                std::printf("%s\n", scenario);
+            }
+            return 0;
+        } else {
+            printUsage();
+            return std::strcmp(argv[i], "--help") == 0 ? 0 : 1;
+        }
+    }
+    if (selected.empty()) {
+        selected.assign(std::begin(kScenarios), std::end(kScenarios));
+    }
+
+    // Engine logging goes to a file only, so stdout carries nothing but the JSON report
+    polaris::LoggerConfig loggerConfig;
+    loggerConfig.console = false;
+    polaris::Logger::getInstance().initialize("polaris_bench.log", loggerConfig);
+    polaris::Logger::getInstance().setLogLevel(polaris::LogLevel::INFO);
+
+    std::vector<ScenarioResult> results;
+    for (const std::string& name : selected) {
+        std::fprintf(stderr, "running %s...\n", name.c_str());
+        try {
+            if (name == "empty_loop") {
+                results.push_back(runFrameScenario(name, 0, options));
+            } else if (name == "sprites_1k") {
+                results.push_back(runFrameScenario(name, 1000, options));
+            } else if (name == "sprites_10k") {
+                results.push_back(runFrameScenario(name, 10000, options));
+            } else if (name == "sprites_100k") {
+                results.push_back(runFrameScenario(name, 100000, options));
+            } else if (name == "sprites_10k_1080p") {
+                results.push_back(runFrameScenario(name, 10000, options, 0.0f, 1920, 1080));
+            } else if (name == "logging_burst") {
+                results.push_back(runLoggingBurstScenario(options));
+            } else if (name == "startup") {
+                results.push_back(runStartupScenario(options));
+            } else if (name == "ecs_iterate_1m") {
+                results.push_back(runEcsIterateScenario());
+            } else if (name == "world_cull_100k") {
+                results.push_back(runFrameScenario(name, 100000, options, kWorldCullSize100k));
+            } else if (name == "world_cull_1m") {
+                results.push_back(runFrameScenario(name, 1000000, options, kWorldCullSize1m));
+            } else if (name == "math_transform") {
+                results.push_back(runMathTransformScenario());
+            } else if (name == "audio_mix_256") {
+                results.push_back(runAudioMixScenario());
+            } else {
+                std::fprintf(stderr, "unknown scenario %s (see --list)\n", name.c_str());
+                return 1;
+            }
+        } catch (const std::exception& e) {
+            std::fprintf(stderr, "scenario %s failed: %s\n", name.c_str(), e.what());
+            return 1;
+        }
+    }
+
+    if (!writeJson(outputPath, options, results)) {
+        std::fprintf(stderr, "failed to write %s\n", outputPath.c_str());
+        return 1;
+    }
+
+    int exitCode = 0;
+    if (!baselinePath.empty()) {
+        std::ifstream file(baselinePath);
+        const std::string text((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+        std::map<std::string, double> baseline;
+        if (!file.is_open() || !JsonNumbers().parse(text, baseline)) {
+            std::fprintf(stderr, "failed to read baseline %s\n", baselinePath.c_str());
+            return 1;
+        }
+        const int regressions = compareWithBaseline(results, baseline, tolerance);
+        std::fprintf(stderr, "%d regression(s) beyond %.0f%% tolerance\n", regressions, tolerance * 100.0);
+        exitCode = regressions > 0 ? 2 : 0;
+    }
+    if (maxAllocationsPerFrame >= 0.0 && countAllocatingScenarios(results, maxAllocationsPerFrame) > 0) {
+        exitCode = 3;
+    }
+
+    polaris::Logger::getInstance().shutdown();
+    return exitCode;
+}
@@ -3,6 +3,7 @@
 #include <stdexcept>
 #include <SDL3/SDL.h>
 #include "Logger.h"
+#include "profiling/Profiler.h"
 //#include "/rendering/VideoRenderer.h"
 
 namespace polaris {
@@ -60,7 +61,10 @@ namespace polaris {
         }
 
         m_window = window;
-        OnCreated();
+        {
+            POLARIS_PROFILE_SCOPE("Application::OnCreated");
+            OnCreated();
+        }
 
         SDL_ShowWindow(m_window);
     }
@@ -75,6 +79,26 @@ namespace polaris {
         LOG_INFO("Application OnCreated: Window is now available.");
     }
 
+    /**
+     * @brief Advances the simulation by one fixed step.
+     * The default implementation does nothing.
+     * @param dt The fixed timestep in seconds.
+     */
+    void Application::update(double dt) {
+        (void)dt;
+    }
+
+    /**
+     * @brief Records the frame's rendering commands.
+     * The default implementation clears the window to red.
+     * @param alpha Interpolation factor between the last two simulation steps.
+     * @param commands The command list for this frame.
+     */
+    void Application::render(double alpha, CommandList& commands) {
+        (void)alpha;
+        commands.Clear({1.0f, 0.0f, 0.0f, 1.0f});
+    }
+
     /**
      * @brief Called by the Engine before shutdown.
      * This is a virtual method that can be overridden by derived classes
@@ -48,6 +48,25 @@ public:
      */
     virtual void OnCreated();
 
+    /**
+     * @brief Advances the simulation by one fixed step.
+     * Called by the Engine zero or more times per frame, always with the same dt,
+     * so game logic is deterministic regardless of the render frame rate.
+     * @param dt The fixed timestep in seconds (FrameConfig::fixedTimestep).
+     */
+    virtual void update(double dt);
+
+    /**
+     * @brief Records the frame's rendering commands.
+     * Called once per rendered frame, after the frame's simulation steps. The commands are
+     * executed later on the render thread, so record everything the frame needs into the list
+     * instead of calling the renderer directly. The Engine appends Present after this returns.
+     * @param alpha How far (0..1) the current time lies between the last two simulation
+     *        steps; use it to interpolate positions for smooth motion.
+     * @param commands The command list for this frame, empty on entry.
+     */
+    virtual void render(double alpha, CommandList& commands);
+
     /**
      * @brief Called by the Engine before shutdown.
      * This is a virtual method that can be overridden by derived classes
@@ -57,6 +76,51 @@ public:
 
 protected:
 
+    /**
+     * @brief Returns the engine's job system, for spreading update/render work across cores.
+     */
+    JobSystem& getJobSystem() { return m_engine.getJobSystem(); }
+
+    /**
+     * @brief Returns the engine's input system, for polling keyboard/mouse/gamepad state.
+     */
+    InputSystem& getInput() { return m_engine.getInput(); }
+
+    /**
+     * @brief Returns the engine's event bus; subscribe to InputEvent or EngineEvent, e.g. in OnCreated.
+     */
+    EventBus& getEventBus() { return m_engine.getEventBus(); }
+
+    /**
+     * @brief Returns the engine's per-frame arena, for temporary data such as culled draw lists.
+     */
+    FrameArena& getFrameArena() { return m_engine.getFrameArena(); }
+
+    /**
+     * @brief Returns the engine's entity world.
+     */
+    World& getWorld() { return m_engine.getWorld(); }
+
+    /**
+     * @brief Returns the engine's system scheduler; register systems in OnCreated.
+     */
+    SystemScheduler& getSystems() { return m_engine.getSystems(); }
+
+    /**
+     * @brief Returns the engine's spatial index, for culling what render() submits.
+     */
+    SpatialGrid& getSpatialIndex() { return m_engine.getSpatialIndex(); }
+
+    /**
+     * @brief Marks a rectangle of the window as changed, for on-demand rendering.
+     */
+    void markDirty(const SDL_Rect& rect) { m_engine.markDirty(rect); }
+
+    /**
+     * @brief Requests a full redraw of the next frame, for on-demand rendering.
+     */
+    void requestRedraw() { m_engine.requestRedraw(); }
+
     SDL_Window* m_window;
     Engine m_engine;
 };
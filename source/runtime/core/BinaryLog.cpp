@@ -0,0 +1,180 @@
+#include "BinaryLog.h"
+#include <cstring>
+#include <cstdio>
+#include <ctime>
+
+namespace polaris {
+
+namespace {
+
+template <typename T>
+void appendValue(std::string& out, T value) {
+    char bytes[sizeof(T)];
+    std::memcpy(bytes, &value, sizeof(T));
+    out.append(bytes, sizeof(T));
+}
+
+void appendString16(std::string& out, const std::string& value) {
+    const std::uint16_t length = static_cast<std::uint16_t>(value.size() > 0xFFFF ? 0xFFFF : value.size());
+    appendValue(out, length);
+    out.append(value.data(), length);
+}
+
+} // namespace
+
+std::int64_t BinaryLogHeader::tickToSystemNs(std::uint64_t tick) const {
+    const long double elapsedTicks = static_cast<long double>(static_cast<std::int64_t>(tick - baseTick));
+    const long double elapsedNs = elapsedTicks * tickNumerator * 1000000000.0L / tickDenominator;
+    return baseSystemNs + static_cast<std::int64_t>(elapsedNs);
+}
+
+void appendBinaryLogHeader(std::string& out, const BinaryLogHeader& header) {
+    out.append(kBinaryLogMagic, sizeof(kBinaryLogMagic));
+    appendValue(out, header.version);
+    appendValue(out, std::uint16_t(0));
+    appendValue(out, header.tickNumerator);
+    appendValue(out, header.tickDenominator);
+    appendValue(out, header.baseSystemNs);
+    appendValue(out, header.baseTick);
+}
+
+void appendBinaryLogSite(std::string& out, std::uint32_t siteId, LogLevel level, std::uint32_t line,
+                         const std::string& file, const std::string& format) {
+    appendValue(out, static_cast<std::uint8_t>(BinaryLogRecordKind::SiteDefinition));
+    appendValue(out, siteId);
+    appendValue(out, static_cast<std::uint8_t>(level));
+    appendValue(out, line);
+    appendString16(out, file);
+    appendString16(out, format);
+}
+
+void appendBinaryLogEntry(std::string& out, std::uint32_t siteId, LogLevel level, std::uint64_t tick,
+                          const std::uint8_t* args, std::uint16_t argBytes) {
+    appendValue(out, static_cast<std::uint8_t>(BinaryLogRecordKind::Entry));
+    appendValue(out, siteId);
+    appendValue(out, static_cast<std::uint8_t>(level));
+    appendValue(out, tick);
+    appendValue(out, argBytes);
+    out.append(reinterpret_cast<const char*>(args), argBytes);
+}
+
+bool BinaryLogReader::read(void* data, std::size_t size) {
+    m_file.read(static_cast<char*>(data), static_cast<std::streamsize>(size));
+    return static_cast<std::size_t>(m_file.gcount()) == size;
+}
+
+bool BinaryLogReader::open(const std::string& path) {
+    m_file.open(path, std::ios::binary);
+    if (!m_file.is_open()) {
+        return false;
+    }
+
+    char magic[4];
+    std::uint16_t reserved;
+    if (!read(magic, sizeof(magic)) || std::memcmp(magic, kBinaryLogMagic, sizeof(magic)) != 0) {
+        return false;
+    }
+    if (!read(&m_header.version, sizeof(m_header.version)) || m_header.version != kBinaryLogVersion) {
+        return false;
+    }
+    return read(&reserved, sizeof(reserved)) &&
+           read(&m_header.tickNumerator, sizeof(m_header.tickNumerator)) &&
+           read(&m_header.tickDenominator, sizeof(m_header.tickDenominator)) &&
+           read(&m_header.baseSystemNs, sizeof(m_header.baseSystemNs)) &&
+           read(&m_header.baseTick, sizeof(m_header.baseTick)) &&
+           m_header.tickDenominator != 0;
+}
+
+bool BinaryLogReader::next(Entry& entry) {
+    for (;;) {
+        std::uint8_t kind;
+        if (!read(&kind, sizeof(kind))) {
+            m_atEnd = m_file.gcount() == 0;
+            return false;
+        }
+
+        std::uint32_t siteId;
+        std::uint8_t level;
+        if (!read(&siteId, sizeof(siteId)) || !read(&level, sizeof(level))) {
+            return false;
+        }
+
+        if (kind == static_cast<std::uint8_t>(BinaryLogRecordKind::SiteDefinition)) {
+            Site site;
+            std::uint16_t length;
+            site.level = static_cast<LogLevel>(level);
+            if (!read(&site.line, sizeof(site.line)) || !read(&length, sizeof(length))) {
+                return false;
+            }
+            site.file.resize(length);
+            if (!read(&site.file[0], length) || !read(&length, sizeof(length))) {
+                return false;
+            }
+            site.format.resize(length);
+            if (!read(&site.format[0], length)) {
+                return false;
+            }
+            site.defined = true;
+            if (siteId >= m_sites.size()) {
+                m_sites.resize(siteId + 1);
+            }
+            m_sites[siteId] = std::move(site);
+        } else if (kind == static_cast<std::uint8_t>(BinaryLogRecordKind::Entry)) {
+            std::uint16_t argBytes;
+            entry.siteId = siteId;
+            entry.level = static_cast<LogLevel>(level);
+            if (!read(&entry.tick, sizeof(entry.tick)) || !read(&argBytes, sizeof(argBytes))) {
+                return false;
+            }
+            entry.args.resize(argBytes);
+            return argBytes == 0 || read(entry.args.data(), argBytes);
+        } else {
+            return false;
+        }
+    }
+}
+
+const BinaryLogReader::Site* BinaryLogReader::site(std::uint32_t siteId) const {
+    if (siteId < m_sites.size() && m_sites[siteId].defined) {
+        return &m_sites[siteId];
+    }
+    return nullptr;
+}
+
+std::string BinaryLogReader::format(const Entry& entry) const {
+    const std::int64_t systemNs = m_header.tickToSystemNs(entry.tick);
+    const std::time_t seconds = static_cast<std::time_t>(systemNs / 1000000000);
+    const int millis = static_cast<int>((systemNs / 1000000) % 1000);
+
+    std::tm localTime{};
+#ifdef _WIN32
+    localtime_s(&localTime, &seconds);
+#else
+    localtime_r(&seconds, &localTime);
+#endif
+    char timestamp[48];
+    std::size_t length = std::strftime(timestamp, sizeof(timestamp), "[%Y-%m-%d %H:%M:%S", &localTime);
+    std::snprintf(timestamp + length, sizeof(timestamp) - length, ".%03d]", millis);
+
+    std::string line = timestamp;
+    line += " [";
+    line += getLogLevelName(entry.level);
+    line += "] ";
+
+    const Site* entrySite = site(entry.siteId);
+    if (!entrySite) {
+        line += "<undefined log site ";
+        line += std::to_string(entry.siteId);
+        line += '>';
+        return line;
+    }
+
+    LogArg args[kMaxLogArgs];
+    const std::size_t argCount = decodeLogArgs(entry.args.data(), entry.args.size(), args, kMaxLogArgs);
+    char message[4096];
+    const std::size_t messageLength = formatLogMessage(message, sizeof(message), entrySite->format.c_str(), args, argCount);
+    line.append(message, messageLength);
+    return line;
+}
+
+} // namespace polaris
@@ -0,0 +1,126 @@
+#ifndef POLARIS_BINARYLOG_H
+#define POLARIS_BINARYLOG_H
+
+#include <cstddef>
+#include <cstdint>
+#include <fstream>
+#include <string>
+#include <vector>
+#include "LogFormat.h"
+
+namespace polaris {
+
+/**
+ * @brief On-disk layout of binary (.plog) log files.
+ *
+ * A file starts with a BinaryLogHeader, followed by a stream of records. Each record starts
+ * with a one-byte BinaryLogRecordKind:
+ *  - SiteDefinition: u32 siteId, u8 level, u32 line, u16 fileLength, file, u16 formatLength, format
+ *  - Entry:          u32 siteId, u8 level, u64 tick, u16 argBytes, args (see encodeLogArgs)
+ * A site is always defined earlier in the same file than the first entry that references it,
+ * so every rotated file can be decoded on its own. All integers are in host (little-endian) order.
+ */
+constexpr char kBinaryLogMagic[4] = {'P', 'L', 'O', 'G'};
+constexpr std::uint16_t kBinaryLogVersion = 1;
+
+enum class BinaryLogRecordKind : std::uint8_t {
+    SiteDefinition = 1,
+    Entry = 2
+};
+
+/**
+ * @brief File header. Maps the raw steady_clock ticks stored in entries back to wall-clock time:
+ * wallNs = baseSystemNs + (tick - baseTick) * tickNumerator / tickDenominator * 1e9.
+ */
+struct BinaryLogHeader {
+    std::uint16_t version = kBinaryLogVersion;
+    std::uint64_t tickNumerator = 1;
+    std::uint64_t tickDenominator = 1;
+    std::int64_t baseSystemNs = 0;
+    std::uint64_t baseTick = 0;
+
+    /**
+     * @brief Converts a raw tick to nanoseconds since the Unix epoch.
+     */
+    std::int64_t tickToSystemNs(std::uint64_t tick) const;
+};
+
+/**
+ * @brief Serialised size of BinaryLogHeader, including the magic.
+ */
+constexpr std::size_t kBinaryLogHeaderSize = 4 + 2 + 2 + 8 + 8 + 8 + 8;
+
+/**
+ * @brief Appends the serialised header to out.
+ */
+void appendBinaryLogHeader(std::string& out, const BinaryLogHeader& header);
+
+/**
+ * @brief Appends a SiteDefinition record to out.
+ */
+void appendBinaryLogSite(std::string& out, std::uint32_t siteId, LogLevel level, std::uint32_t line,
+                         const std::string& file, const std::string& format);
+
+/**
+ * @brief Appends an Entry record to out. args/argBytes are the output of encodeLogArgs.
+ */
+void appendBinaryLogEntry(std::string& out, std::uint32_t siteId, LogLevel level, std::uint64_t tick,
+                          const std::uint8_t* args, std::uint16_t argBytes);
+
+/**
+ * @brief Sequential reader for .plog files, used by the polaris-logdecode tool.
+ */
+class BinaryLogReader {
+public:
+    struct Site {
+        LogLevel level = LogLevel::INFO;
+        std::uint32_t line = 0;
+        std::string file;
+        std::string format;
+        bool defined = false;
+    };
+
+    struct Entry {
+        std::uint32_t siteId = 0;
+        LogLevel level = LogLevel::INFO;
+        std::uint64_t tick = 0;
+        std::vector<std::uint8_t> args;
+    };
+
+    /**
+     * @brief Opens a file and validates its header.
+     * @return false if the file cannot be opened or is not a supported .plog file.
+     */
+    bool open(const std::string& path);
+
+    /**
+     * @brief Reads records until the next entry, collecting site definitions along the way.
+     * @return false at end of file or on a truncated/corrupt record.
+     */
+    bool next(Entry& entry);
+
+    /**
+     * @brief Formats an entry as "[YYYY-mm-dd HH:MM:SS.mmm] [LEVEL] message" (local time).
+     */
+    std::string format(const Entry& entry) const;
+
+    /**
+     * @brief True once next() has consumed the whole file (as opposed to stopping at a bad record).
+     */
+    bool atEnd() const { return m_atEnd; }
+
+    const BinaryLogHeader& header() const { return m_header; }
+    const Site* site(std::uint32_t siteId) const;
+
+private:
+    bool read(void* data, std::size_t size);
+
+    std::ifstream m_file;
+    BinaryLogHeader m_header;
+    std::vector<Site> m_sites;
+    bool m_atEnd = false;
+};
+
+} // namespace polaris
+
+#endif // POLARIS_BINARYLOG_H
@@ -1,10 +1,17 @@
 #include "Engine.h"
 
 #include "rendering/SDLRenderer.h"
+#include "rendering/SoftwareRenderer.h"
+#include "rendering/VulkanRenderer.h"
 
 #include "Application.h"
 #include "Logger.h"
+#include "memory/MemoryTracker.h"
+#include "profiling/Profiler.h"
 #include <SDL3/SDL.h>
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
 #include <stdexcept>
 
 namespace polaris {
@@ -13,7 +20,7 @@ namespace polaris {
      * Initializes internal pointers to null and logs the construction.
      * The constructor is kept lightweight; actual initialization is done in initialize().
      */
-    Engine::Engine() : m_application(nullptr) {
+    Engine::Engine() : m_window(nullptr), m_renderer(nullptr), m_application(nullptr) {
         LOG_INFO("Engine constructed");
         // Constructor is now lightweight - initialization moved to initialize()
     }
@@ -43,44 +50,266 @@ namespace polaris {
      */
     void Engine::initialize() {
         LOG_INFO("Engine initializing...");
+        m_memorySequence = MemoryTracker::getInstance().getSequence();
+        POLARIS_MEMORY_SCOPE(Engine);
+
+        if (m_config.headless) {
+            // No display, GPU or sound card needed: render into memory with the software renderer
+            // and mix into the dummy audio driver (SDL_AUDIO_DRIVER=disk still takes precedence)
+            SDL_SetHint(SDL_HINT_VIDEO_DRIVER, "offscreen,dummy");
+            SDL_SetHint(SDL_HINT_RENDER_DRIVER, "software");
+            SDL_SetHint(SDL_HINT_AUDIO_DRIVER, "dummy");
+            LOG_INFO("Running headless");
+        }
 
         // Initialize SDL3 with better error handling
-        if (SDL_Init(SDL_INIT_VIDEO) < 0) {
-            LOG_ERROR("SDL initialization failed: " + std::string(SDL_GetError()));
+        if (!SDL_Init(SDL_INIT_VIDEO | SDL_INIT_GAMEPAD)) {
+            LOG_ERROR("SDL initialization failed: {}", SDL_GetError());
             throw std::runtime_error("SDL initialization failed: " + std::string(SDL_GetError()));
         }
 
-        // Create window with better error handling
+        m_frameArena.reserve(m_config.frameArenaSize);
+        m_spatialIndex.setCellSize(m_config.spatialCellSize);
+        m_jobSystem.initialize(m_jobSystemConfig);
+        m_input.initialize(m_jobSystem.getThreadCount());
+
+        // Mapping costs the same for any pack size; the assets themselves page in on first use
+        if (!m_config.assetPackPath.empty() && !m_assets.open(m_config.assetPackPath)) {
+            LOG_WARN("Continuing without asset pack {}", m_config.assetPackPath);
+        }
+
+        // Audio is optional: without a device the game runs silently
+        m_audio.initialize(m_config.audio);
+
+        // Create window with better error handling; the software renderer presents through
+        // the window surface, which a Vulkan window cannot have
+        const bool software = m_config.renderer == RendererBackend::Software;
+        const SDL_WindowFlags windowFlags = m_config.headless
+            ? SDL_WINDOW_HIDDEN
+            : (software ? 0 : SDL_WINDOW_VULKAN) | SDL_WINDOW_HIDDEN | SDL_WINDOW_RESIZABLE;
         m_window = SDL_CreateWindow(
-            "Vega42 - SDL3 + Vulkan",
-            800, 600,
-            SDL_WINDOW_VULKAN | SDL_WINDOW_HIDDEN | SDL_WINDOW_RESIZABLE
+            m_config.windowTitle.c_str(),
+            m_config.windowWidth, m_config.windowHeight,
+            windowFlags
         );
 
         if (!m_window) {
-            LOG_ERROR("Window creation failed: " + std::string(SDL_GetError()));
+            LOG_ERROR("Window creation failed: {}", SDL_GetError());
+            m_audio.shutdown();
+            m_jobSystem.shutdown();
             SDL_Quit();
             throw std::runtime_error("Window creation failed: " + std::string(SDL_GetError()));
         }
 
         LOG_INFO("Engine initialized successfully");
 
-        m_renderer = new SDLRenderer();
+        {
+            POLARIS_MEMORY_SCOPE(Renderer);
+            if (software) {
+                SoftwareRendererConfig softwareConfig = m_config.softwareRenderer;
+                softwareConfig.jobs = &m_jobSystem;
+                softwareConfig.width = m_config.windowWidth;
+                softwareConfig.height = m_config.windowHeight;
+                m_renderer = new SoftwareRenderer(softwareConfig);
+            } else if (m_config.renderer == RendererBackend::Vulkan) {
+#if POLARIS_ENABLE_VULKAN
+                m_renderer = new VulkanRenderer(m_config.vulkanRenderer);
+#else
+                LOG_WARN("Built without POLARIS_ENABLE_VULKAN, using the SDL renderer");
+                m_renderer = new SDLRenderer();
+#endif
+            } else {
+                m_renderer = new SDLRenderer();
+            }
+        }
+
+        // The renderer is created, used and destroyed on the render thread only
+        const FrameConfig& frameConfig = m_frameScheduler.getConfig();
+        m_renderThread.Start(m_renderer, frameConfig.threadedRendering && kRenderThreadSupported, frameConfig.framesInFlight);
+        // Headless, the software renderer keeps its framebuffer in memory for readFramebuffer()
+        // instead of copying every frame to the hidden window
+        SDL_Window* rendererWindow = m_config.headless && software ? nullptr : m_window;
+        m_renderThread.Invoke([this, rendererWindow]() {
+            POLARIS_MEMORY_SCOPE(Renderer);
+            m_renderer->CreateRenderer(rendererWindow);
+        });
+        applyFramePacing();
+
+        // Textures stream from the asset pack, when there is one, before the file system
+        TextureManagerConfig textureConfig = m_config.textures;
+        if (!textureConfig.assets && m_assets.isOpen()) {
+            textureConfig.assets = &m_assets;
+        }
+        m_textures.Initialize(textureConfig);
+
+        m_hotReload.initialize(m_config.hotReload);
+        for (const std::string& directory : m_config.hotReloadDirectories) {
+            m_hotReload.watch(directory);
+        }
+        m_hotReload.addTextures(m_textures);
 
-        // Notify application if set
+        // Notify application if set; the renderer is ready, so OnCreated can load resources
         if (m_application) {
+            POLARIS_MEMORY_SCOPE(Application);
             m_application->setWindow(m_window);
         } else {
             LOG_WARN("No application set, skipping setWindow call");
         }
+    }
+
+    /**
+     * @brief Creates a command list for work recorded outside the frame loop.
+     * @return An empty command list that allocates texture handles from the renderer.
+     * @throws std::logic_error if the engine is not initialized.
+     */
+    CommandList Engine::createCommandList() {
+        if (!m_renderer) {
+            throw std::logic_error("Engine::createCommandList called before initialize");
+        }
+        return CommandList(&m_renderer->GetTextureHandles());
+    }
+
+    /**
+     * @brief Executes a command list on the render thread and waits for it.
+     * @param commands The commands, typically texture uploads recorded at load time.
+     */
+    void Engine::executeCommands(const CommandList& commands) {
+        if (!m_renderer) {
+            LOG_ERROR("Cannot execute commands: renderer not initialized");
+            return;
+        }
+        m_renderThread.Invoke([this, &commands]() { m_renderer->RenderFrame(commands); });
+    }
+
+    /**
+     * @brief Copies the software framebuffer or the Vulkan offscreen image once every submitted
+     * frame has run.
+     * @return false if the renderer keeps no framebuffer the engine can read.
+     */
+    bool Engine::readFramebuffer(std::vector<std::uint32_t>& pixels, int& width, int& height) {
+        if (!m_renderer) {
+            LOG_ERROR("Cannot read the framebuffer: renderer not initialized");
+            return false;
+        }
+        m_renderThread.WaitIdle();
+        bool read = false;
+        m_renderThread.Invoke([this, &pixels, &width, &height, &read]() {
+#if POLARIS_ENABLE_VULKAN
+            if (m_config.renderer == RendererBackend::Vulkan) {
+                read = static_cast<VulkanRenderer*>(m_renderer)->ReadPixels(pixels, width, height);
+                return;
+            }
+#endif
+            if (m_config.renderer != RendererBackend::Software) {
+                return;
+            }
+            const SDL_Surface* surface = static_cast<SoftwareRenderer*>(m_renderer)->GetSurface();
+            width = surface->w;
+            height = surface->h;
+            pixels.resize(static_cast<std::size_t>(width) * height);
+            for (int row = 0; row < height; ++row) {
+                std::memcpy(pixels.data() + static_cast<std::size_t>(row) * width,
+                            static_cast<const std::uint8_t*>(surface->pixels) + static_cast<std::size_t>(row) * surface->pitch,
+                            static_cast<std::size_t>(width) * 4);
+            }
+            read = true;
+        });
+        if (!read) {
+            LOG_ERROR("Cannot read the framebuffer: the renderer draws to the window");
+        }
+        return read;
+    }
+
+    /**
+     * @brief Sets the window and run-mode configuration.
+     * @param config The engine configuration.
+     */
+    void Engine::setConfig(const EngineConfig& config) {
+        if (m_window) {
+            LOG_WARN("Engine already initialized; only maxFrames takes effect");
+            m_config.maxFrames = config.maxFrames;
+            return;
+        }
+        m_config = config;
+    }
+
+    /**
+     * @brief Applies --headless, --frames N, --width N, --height N and --renderer sdl|software|vulkan
+     * to a configuration.
+     * @return The resulting configuration.
+     */
+    EngineConfig Engine::parseCommandLine(int argc, char* argv[], const EngineConfig& defaults) {
+        EngineConfig config = defaults;
+        for (int i = 1; i < argc; ++i) {
+            if (std::strcmp(argv[i], "--headless") == 0) {
+                config.headless = true;
+            } else if (std::strcmp(argv[i], "--frames") == 0 && i + 1 < argc) {
+                config.maxFrames = std::strtoull(argv[++i], nullptr, 10);
+            } else if (std::strcmp(argv[i], "--width") == 0 && i + 1 < argc) {
+                config.windowWidth = std::atoi(argv[++i]);
+            } else if (std::strcmp(argv[i], "--height") == 0 && i + 1 < argc) {
+                config.windowHeight = std::atoi(argv[++i]);
+            } else if (std::strcmp(argv[i], "--renderer") == 0 && i + 1 < argc) {
+                const char* renderer = argv[++i];
+                if (std::strcmp(renderer, "software") == 0) {
+                    config.renderer = RendererBackend::Software;
+                } else if (std::strcmp(renderer, "vulkan") == 0) {
+                    config.renderer = RendererBackend::Vulkan;
+                } else if (std::strcmp(renderer, "sdl") == 0) {
+                    config.renderer = RendererBackend::SDL;
+                } else {
+                    LOG_WARN("Unknown renderer {}, expected sdl, software or vulkan", renderer);
+                }
+            }
+        }
+        return config;
+    }
+
+    /**
+     * @brief Sets the frame loop configuration (fixed timestep, spiral guard, pacing).
+     * @param config The frame configuration.
+     */
+    void Engine::setFrameConfig(const FrameConfig& config) {
+        m_frameScheduler.configure(config);
+        requestRedraw();
+        if (m_renderer) {
+            applyFramePacing();
+        }
+    }
 
-        m_renderer->CreateRenderer(m_window);
+    /**
+     * @brief Sets the job system configuration. Must be called before initialize().
+     * @param config The job system configuration.
+     */
+    void Engine::setJobSystemConfig(const JobSystemConfig& config) {
+        if (m_jobSystem.isRunning()) {
+            LOG_WARN("Job system already running; configuration change ignored");
+            return;
+        }
+        m_jobSystemConfig = config;
+    }
+
+    /**
+     * @brief Applies the pacing mode to the renderer.
+     * If vsync is requested but the renderer cannot provide it, pacing falls back to TargetFps.
+     */
+    void Engine::applyFramePacing() {
+        FrameConfig config = m_frameScheduler.getConfig();
+        const bool wantVSync = config.pacing == FramePacing::VSync;
+        bool applied = false;
+        m_renderThread.Invoke([this, wantVSync, &applied]() { applied = m_renderer->SetVSync(wantVSync); });
+        if (!applied && wantVSync) {
+            LOG_WARN("VSync unavailable, pacing to {} FPS instead", config.targetFps);
+            config.pacing = FramePacing::TargetFps;
+            m_frameScheduler.configure(config);
+        }
     }
 
     /**
      * @brief Runs the main engine loop.
      * This method handles SDL events and keeps the engine running until a quit event is received.
-     * It also ensures the window is shown and includes a basic frame rate cap.
+     * Each frame runs zero or more fixed simulation steps (Application::update), one interpolated
+     * render (Application::render), and then waits for the next frame deadline per FrameConfig.
      * @throws std::runtime_error if the window is not initialized before calling run.
      */
     void Engine::run() {
@@ -91,37 +320,135 @@ namespace polaris {
 
         LOG_INFO("Engine running...");
 
-        SDL_Event event;
         bool quit = false;
+        std::uint64_t frames = 0;
+
+        POLARIS_PROFILE_THREAD("Main");
+        POLARIS_MEMORY_SCOPE(Engine);
+        m_frameScheduler.start();
 
         while (!quit) {
-            // Process all pending events
-            while (SDL_PollEvent(&event)) {
-                switch (event.type) {
-                    case SDL_EVENT_QUIT:
-                        LOG_INFO("Quit event received");
+            runFrame(quit);
+            POLARIS_PROFILE_FRAME_END();
+            POLARIS_MEMORY_FRAME_END();
+            if (m_config.maxFrames != 0 && ++frames >= m_config.maxFrames) {
+                LOG_INFO("Stopping after {} frames", frames);
+                quit = true;
+            }
+        }
+
+        shutdown();
+    }
+
+    /**
+     * @brief Runs one iteration of the main loop: events, fixed simulation steps, render and pacing.
+     * @param quit Set to true when a quit event is received.
+     */
+    void Engine::runFrame(bool& quit) {
+        POLARIS_PROFILE_SCOPE("Engine::frame");
+
+        // In on-demand mode, sleep until there is something to do. A resize damages everything.
+        const FrameConfig& frameConfig = m_frameScheduler.getConfig();
+        if (frameConfig.onDemand) {
+            int width = 0;
+            int height = 0;
+            SDL_GetWindowSizeInPixels(m_window, &width, &height);
+            m_damage.SetBounds(width, height);
+            m_damage.SetFullThreshold(frameConfig.fullRedrawThreshold);
+            if (m_damage.IsEmpty() && m_textures.GetStats().pendingLoads == 0) {
+                waitForEvents();
+            }
+        }
+
+        m_frameScheduler.beginFrame();
+        m_frameArena.beginFrame();
+        m_spatialStats = m_spatialIndex.takeStats();
+
+        // Gather and publish this frame's input; the engine itself only reacts to quitting
+        m_input.pollEvents(m_eventBus);
+        for (const InputEvent& event : m_input.getEvents()) {
+            switch (event.type) {
+                case InputEventType::Quit:
+                    LOG_INFO("Quit event received");
                     quit = true;
                     break;
-                    case SDL_EVENT_KEY_DOWN:
-                        LOG_DEBUG("Key pressed, quitting");
-                    quit = true;
+                case InputEventType::KeyDown:
+                    if (event.code == SDL_SCANCODE_ESCAPE) {
+                        LOG_DEBUG("Escape pressed, quitting");
+                        quit = true;
+                    }
                     break;
-                    case SDL_EVENT_WINDOW_RESIZED:
-                        LOG_DEBUG("Window resized");
+                case InputEventType::WindowResized:
+                    LOG_DEBUG("Window resized to {}x{}", static_cast<int>(event.x), static_cast<int>(event.y));
+                    m_damage.AddAll();
+                    break;
+                case InputEventType::WindowExposed:
+                    m_damage.AddAll();
+                    break;
+                default:
                     break;
-                }
             }
+        }
 
-            // Render frame (placeholder for rendering engine)
-            // renderFrame();
+        // Fixed-step simulation, catching up on however much time the last frame took
+        while (m_frameScheduler.consumeFixedStep()) {
+            {
+                POLARIS_PROFILE_SCOPE("Engine::systems");
+                m_systems.run(m_world, m_jobSystem, m_frameScheduler.getFixedTimestep());
+            }
+            if (m_application) {
+                POLARIS_PROFILE_SCOPE("Application::update");
+                POLARIS_MEMORY_SCOPE(Application);
+                m_application->update(m_frameScheduler.getFixedTimestep());
+            }
+        }
 
-            m_renderer->RenderFrame();
+        // Variable-rate render, interpolated between the last two simulation steps. The commands
+        // are recorded here and executed by the render thread while we simulate the next frame.
+        CommandList& commands = m_renderThread.BeginFrame();
+        m_hotReload.update(commands, m_frameScheduler.getStats());
+        m_textures.Update(commands);
 
-            // Cap frame rate to ~60 FPS
-            //SDL_Delay(16);
+        // On demand, render only damaged frames; a texture upload may change anything on screen.
+        // Idle frames still submit their (usually empty) list, for the uploads.
+        bool render = true;
+        if (frameConfig.onDemand) {
+            if (!commands.GetCommands().empty()) {
+                m_damage.AddAll();
+            }
+            render = !m_damage.IsEmpty();
+            if (render) {
+                const std::vector<SDL_Rect>& rects = m_damage.GetRects();
+                commands.SetDamage(rects.data(), m_damage.IsFull() ? 0 : rects.size());
+                m_damage.Clear();
+            }
         }
+        if (render) {
+            if (m_application) {
+                POLARIS_PROFILE_SCOPE("Application::render");
+                POLARIS_MEMORY_SCOPE(Application);
+                m_application->render(m_frameScheduler.getAlpha(), commands);
+            }
+            commands.Present();
+        }
+        m_renderThread.SubmitFrame();
 
-        shutdown();
+        // Sleep-then-spin until the next frame deadline (no-op when uncapped or vsynced, or
+        // when nothing was rendered)
+        if (render) {
+            POLARIS_PROFILE_SCOPE("Engine::waitForNextFrame");
+            m_frameScheduler.waitForNextFrame();
+        }
+    }
+
+    /**
+     * @brief Blocks in SDL_WaitEventTimeout, leaving the event queued for pollEvents().
+     */
+    void Engine::waitForEvents() {
+        POLARIS_PROFILE_SCOPE("Engine::waitForEvents");
+        const double timeout = std::max(m_frameScheduler.getConfig().idleTimeout, 0.0);
+        SDL_WaitEventTimeout(nullptr, static_cast<Sint32>(std::min(timeout * 1000.0, 2147483647.0)));
+        m_frameScheduler.resume();
     }
 
     /**
@@ -133,18 +460,53 @@ namespace polaris {
 
         // Notify application before cleanup
         if (m_application) {
+            POLARIS_PROFILE_SCOPE("Application::onDestroy");
+            POLARIS_MEMORY_SCOPE(Application);
             m_application->onDestroy();
         } else {
             LOG_WARN("No application set, skipping onDestroy call");
         }
 
+        m_systems.clear();
+        m_world.clear();
+        m_spatialIndex.clear();
+
+        // Finish outstanding jobs and frames before the resources they might use go away;
+        // the renderer is destroyed on the thread that created it. A frame still rendering may
+        // be rasterizing on the job system, so it finishes first.
+        if (m_renderer) {
+            m_renderThread.WaitIdle();
+        }
+        m_jobSystem.shutdown();
+        m_audio.shutdown();
+        m_hotReload.shutdown();
+        m_textures.Shutdown();
+        if (m_renderer) {
+            m_renderThread.WaitIdle();
+            m_renderThread.Invoke([this]() { delete m_renderer; });
+            m_renderer = nullptr;
+        }
+        m_renderThread.Stop();
+        m_input.shutdown();
+        m_eventBus.clear();
+        m_assets.close();
+        m_frameArena.release();
+
         if (m_window) {
             SDL_DestroyWindow(m_window);
             m_window = nullptr;
         }
 
+        // Writes the trace capture, if one was requested
+        POLARIS_PROFILE_SHUTDOWN();
+
         // Quit SDL subsystems
         SDL_Quit();
+
+        // Whatever the engine and application allocated since initialize() and still hold
+        if (MemoryTracker::isEnabled() && !m_config.memoryReportPath.empty()) {
+            MemoryTracker::getInstance().writeLeakReport(m_config.memoryReportPath, m_memorySequence);
+        }
         LOG_INFO("Engine shutdown complete");
     }
 } // namespace polaris
\ No newline at end of file
@@ -2,7 +2,28 @@
 #define POLARIS_ENGINE_H
 
 #include <SDL3/SDL.h>
+#include "rendering/DamageRegion.h"
 #include "rendering/PlatformRenderer.h"
+#include "rendering/RenderThread.h"
+#include "rendering/SoftwareRenderer.h"
+#include "rendering/VulkanRenderer.h"
+#include "rendering/TextureManager.h"
+#include "FrameScheduler.h"
+#include "assets/AssetPack.h"
+#include "assets/HotReload.h"
+#include "audio/AudioEngine.h"
+#include "jobs/JobSystem.h"
+#include "ecs/SystemScheduler.h"
+#include "ecs/World.h"
+#include "spatial/SpatialGrid.h"
+#include "input/EventBus.h"
+#include "input/InputSystem.h"
+#include "memory/LinearArena.h"
+#include "memory/MemoryTracker.h"
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
 
 namespace polaris {
     class Application; // Forward declaration
@@ -10,6 +31,83 @@ namespace polaris {
 
 namespace polaris {
 
+/**
+ * @brief Renderer the engine draws with.
+ */
+enum class RendererBackend : std::uint8_t {
+    SDL,        ///< SDL_Renderer, on the GPU where there is one.
+    Software,   ///< polaris::SoftwareRenderer: tiled CPU rasterizer on the job system.
+    Vulkan      ///< polaris::VulkanRenderer; SDL when built without POLARIS_ENABLE_VULKAN.
+};
+
+/**
+ * @brief Window and run-mode settings read by Engine::initialize.
+ */
+struct EngineConfig {
+    /**
+     * @brief Title of the application window.
+     */
+    std::string windowTitle = "Vega42 - SDL3 + Vulkan";
+    /**
+     * @brief Initial window size in screen coordinates.
+     */
+    int windowWidth = 800;
+    int windowHeight = 600;
+    /**
+     * @brief Run without a display or GPU: SDL's offscreen (or dummy) video driver and the
+     * software renderer. Intended for benchmarks and automated runs on build machines.
+     */
+    bool headless = false;
+    /**
+     * @brief Leave the main loop after this many frames; 0 runs until a quit event.
+     */
+    std::uint64_t maxFrames = 0;
+    /**
+     * @brief Initial size in bytes of each half of the per-frame arena (see Engine::getFrameArena).
+     * The arena grows past this if a frame needs more, and stops growing once it fits.
+     */
+    std::size_t frameArenaSize = 1024 * 1024;
+    /**
+     * @brief File the memory report is written to at shutdown when memory tracking is compiled
+     * in (POLARIS_ENABLE_MEMORY_TRACKING); empty disables the report.
+     */
+    std::string memoryReportPath = "polaris_memory.txt";
+    /**
+     * @brief Cell size in world units of the engine's spatial index (see Engine::getSpatialIndex).
+     */
+    float spatialCellSize = 128.0f;
+    /**
+     * @brief Audio device and mixer settings (see Engine::getAudio). Headless runs use SDL's
+     * dummy audio driver unless SDL_AUDIO_DRIVER says otherwise.
+     */
+    AudioConfig audio;
+    /**
+     * @brief Asset pack (.ppak, built by polaris-pack) mapped at startup and served by
+     * Engine::getAssets; empty opens none.
+     */
+    std::string assetPackPath;
+    /**
+     * @brief Texture streaming budget and decode threads (see Engine::getTextures). Textures
+     * are looked up in the asset pack first when one is open.
+     */
+    TextureManagerConfig textures;
+    /**
+     * @brief Directories watched for changed assets (see Engine::getHotReload), e.g. the
+     * project's asset directory during development; empty watches none.
+     */
+    std::vector<std::string> hotReloadDirectories;
+    FileWatcherConfig hotReload;
+    /**
+     * @brief Renderer to create. The software renderer needs no GPU and rasterizes on the
+     * engine's job system; softwareRenderer.jobs and its size are set by the engine. When
+     * headless, both the software and the Vulkan renderer draw offscreen, and the frame can be
+     * read back with Engine::readFramebuffer().
+     */
+    RendererBackend renderer = RendererBackend::SDL;
+    SoftwareRendererConfig softwareRenderer;
+    VulkanRendererConfig vulkanRenderer;
+};
+
 class Engine {
 public:
     /**
@@ -50,6 +148,174 @@ public:
      */
     void shutdown();
 
+    /**
+     * @brief Sets the window and run-mode configuration.
+     * Must be called before initialize(); only maxFrames may be changed afterwards.
+     * @param config The engine configuration.
+     */
+    void setConfig(const EngineConfig& config);
+
+    /**
+     * @brief Returns the window and run-mode configuration.
+     */
+    const EngineConfig& getConfig() const { return m_config; }
+
+    /**
+     * @brief Applies the engine's command line options to a configuration.
+     * Recognises --headless, --frames N, --width N, --height N and --renderer sdl|software|vulkan
+     * (vulkan falls back to sdl in builds without POLARIS_ENABLE_VULKAN); other arguments are
+     * left for the application.
+     * @param argc Argument count, as passed to main.
+     * @param argv Arguments, as passed to main.
+     * @param defaults Configuration the options are applied to.
+     * @return The resulting configuration.
+     */
+    static EngineConfig parseCommandLine(int argc, char* argv[], const EngineConfig& defaults = EngineConfig());
+
+    /**
+     * @brief Sets the frame loop configuration (fixed timestep, spiral guard, pacing).
+     * May be called before initialize() or while running; takes effect from the next frame.
+     * @param config The frame configuration.
+     */
+    void setFrameConfig(const FrameConfig& config);
+
+    /**
+     * @brief Returns the frame scheduler, e.g. to read frame timing statistics.
+     */
+    const FrameScheduler& getFrameScheduler() const { return m_frameScheduler; }
+
+    /**
+     * @brief Marks a rectangle of the window, in pixels, as changed. In on-demand mode
+     * (FrameConfig::onDemand) the next frame is rendered, and renderers that keep the previous
+     * frame redraw and present only the damaged parts; otherwise every frame is redrawn anyway.
+     * Damage marked during Application::render applies to the following frame. Main thread only.
+     * @param rect The changed rectangle.
+     */
+    void markDirty(const SDL_Rect& rect) { m_damage.Add(rect); }
+
+    /**
+     * @brief Requests a full redraw of the next frame in on-demand mode; call it every frame
+     * while something animates. Main thread only.
+     */
+    void requestRedraw() { m_damage.AddAll(); }
+
+    /**
+     * @brief Sets the job system configuration (worker thread count).
+     * Must be called before initialize().
+     * @param config The job system configuration.
+     */
+    void setJobSystemConfig(const JobSystemConfig& config);
+
+    /**
+     * @brief Returns the job system used to spread per-frame work across cores.
+     * Started in initialize() and stopped in shutdown(); before that, jobs run inline.
+     */
+    JobSystem& getJobSystem() { return m_jobSystem; }
+
+    /**
+     * @brief Returns the input system: this frame's events and keyboard/mouse/gamepad state.
+     * Events are gathered at the start of each frame, before Application::update.
+     */
+    InputSystem& getInput() { return m_input; }
+
+    /**
+     * @brief Returns the event bus on which InputEvents and EngineEvents are published each frame.
+     */
+    EventBus& getEventBus() { return m_eventBus; }
+
+    /**
+     * @brief Returns the per-frame arena, reset at the start of every frame. Allocations stay
+     * valid until the end of the following frame. Main thread only.
+     */
+    FrameArena& getFrameArena() { return m_frameArena; }
+
+    /**
+     * @brief Returns the entity world. Systems registered with getSystems() update it once per
+     * fixed simulation step, before Application::update.
+     */
+    World& getWorld() { return m_world; }
+
+    /**
+     * @brief Returns the scheduler of the systems run on getWorld() every fixed step.
+     */
+    SystemScheduler& getSystems() { return m_systems; }
+
+    /**
+     * @brief Returns the spatial index for view culling and proximity queries. Insert objects
+     * with their world bounds, update them when they move, and query the camera rectangle in
+     * render() so only visible objects are submitted.
+     */
+    SpatialGrid& getSpatialIndex() { return m_spatialIndex; }
+
+    /**
+     * @brief Returns the spatial index's inserts, updates, queries and objects tested during
+     * the last frame.
+     */
+    const SpatialStats& getSpatialStats() const { return m_spatialStats; }
+
+    /**
+     * @brief Returns the audio engine: sound effects, music and bus volumes. Started in
+     * initialize(); if no audio device can be opened it stays silent and ignores every call.
+     */
+    AudioEngine& getAudio() { return m_audio; }
+
+    /**
+     * @brief Returns the asset pack opened from EngineConfig::assetPackPath; not open if there
+     * was none or it could not be mapped.
+     */
+    const AssetPack& getAssets() const { return m_assets; }
+
+    /**
+     * @brief Returns the texture streamer. Its uploads and evictions are recorded at the start
+     * of every frame, before Application::render.
+     */
+    TextureManager& getTextures() { return m_textures; }
+
+    /**
+     * @brief Returns the asset hot reloader. Textures from getTextures() are reloaded when
+     * hotReloadDirectories is set; add atlases, fonts or handlers of your own to it. Reloaded
+     * assets are swapped in at the start of a frame, before the texture uploads.
+     */
+    HotReload& getHotReload() { return m_hotReload; }
+
+    /**
+     * @brief Returns the number of heap allocations and bytes of the last frame, on all threads.
+     * All zero unless memory tracking is compiled in.
+     */
+    MemoryFrameStats getMemoryFrameStats() const { return MemoryTracker::getInstance().getFrameStats(); }
+
+    /**
+     * @brief Returns the renderer's counters (draw calls, sprites, vertices, batch flushes)
+     * for the last frame it executed.
+     */
+    RenderStats getRenderStats() const { return m_renderer ? m_renderer->GetStats() : RenderStats(); }
+
+    /**
+     * @brief Creates a command list for work recorded outside the frame loop, such as
+     * uploading textures while loading. Run it with executeCommands().
+     * Only valid after initialize().
+     */
+    CommandList createCommandList();
+
+    /**
+     * @brief Executes a command list on the render thread and waits until it has run.
+     * Textures it creates can be used by every frame recorded afterwards.
+     * @param commands The commands to execute. Must not contain Present.
+     */
+    void executeCommands(const CommandList& commands);
+
+    /**
+     * @brief Copies the last rendered frame, for screenshots and visual tests. Supported by
+     * RendererBackend::Software, and by RendererBackend::Vulkan when it draws offscreen
+     * (headless); headless, both draw at the window size.
+     * Waits until every submitted frame has been executed and, for Vulkan, completed.
+     * @param pixels Receives width * height pixels, rows top to bottom, each RGBA32 (bytes R, G, B, A).
+     * @param width Receives the framebuffer width in pixels.
+     * @param height Receives the framebuffer height in pixels.
+     * @return false if the engine is not initialized or its renderer keeps no readable framebuffer.
+     */
+    bool readFramebuffer(std::vector<std::uint32_t>& pixels, int& width, int& height);
+
 
 private:
     /**
@@ -60,10 +326,97 @@ private:
      * @brief Pointer to the platform-specific renderer.
      */
     PlatformRenderer* m_renderer;
+    /**
+     * @brief Executes the command lists recorded each frame, on its own thread where supported.
+     */
+    RenderThread m_renderThread;
+    /**
+     * @brief Window and run-mode configuration.
+     */
+    EngineConfig m_config;
     /**
      * @brief Pointer to the application instance.
      */
     polaris::Application* m_application;
+    /**
+     * @brief Fixed-step simulation clock and frame pacer driving run().
+     */
+    FrameScheduler m_frameScheduler;
+    /**
+     * @brief Work-stealing job scheduler; the thread calling initialize() is its worker 0.
+     */
+    JobSystem m_jobSystem;
+    /**
+     * @brief Configuration passed to m_jobSystem in initialize().
+     */
+    JobSystemConfig m_jobSystemConfig;
+    /**
+     * @brief Drains SDL events each frame and keeps the input state snapshots.
+     */
+    InputSystem m_input;
+    /**
+     * @brief Delivers each frame's input and engine events to subscribers.
+     */
+    EventBus m_eventBus;
+    /**
+     * @brief Double-buffered arena for data that lives for a frame.
+     */
+    FrameArena m_frameArena;
+    /**
+     * @brief Entities and components of the running game.
+     */
+    World m_world;
+    /**
+     * @brief Systems run on m_world each fixed step.
+     */
+    SystemScheduler m_systems;
+    /**
+     * @brief Spatial index of the game's objects, and its counters for the previous frame.
+     */
+    SpatialGrid m_spatialIndex;
+    SpatialStats m_spatialStats;
+    /**
+     * @brief Mixes sounds and music on SDL's audio thread.
+     */
+    AudioEngine m_audio;
+    /**
+     * @brief Memory-mapped game assets.
+     */
+    AssetPack m_assets;
+    /**
+     * @brief Streams textures in within the configured memory budget.
+     */
+    TextureManager m_textures;
+    /**
+     * @brief Reloads assets whose files change under the watched directories.
+     */
+    HotReload m_hotReload;
+    /**
+     * @brief Parts of the window to redraw in the next frame in on-demand mode.
+     */
+    DamageRegion m_damage;
+    /**
+     * @brief Memory tracker sequence number when initialize() started; the shutdown report
+     * covers allocations made after it.
+     */
+    std::uint64_t m_memorySequence = 0;
+
+    /**
+     * @brief Runs one iteration of the main loop.
+     * @param quit Set to true when a quit event is received.
+     */
+    void runFrame(bool& quit);
+
+    /**
+     * @brief Waits in on-demand mode until an event arrives or the idle timeout passes, then
+     * resumes the frame clock without simulating the time spent waiting.
+     */
+    void waitForEvents();
+
+    /**
+     * @brief Applies the pacing mode to the renderer (enables or disables vsync).
+     */
+    void applyFramePacing();
 
 };
 
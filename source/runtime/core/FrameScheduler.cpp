@@ -0,0 +1,187 @@
+#include "FrameScheduler.h"
+#include <algorithm>
+#include <thread>
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+#include <immintrin.h>
+#endif
+
+namespace polaris {
+
+namespace {
+
+/**
+ * @brief Smallest and largest sleep margins, in seconds.
+ */
+constexpr double kMinSleepMargin = 0.0002;
+constexpr double kMaxSleepMargin = 0.004;
+
+/**
+ * @brief Weight of a new oversleep sample in the sleep margin estimate.
+ */
+constexpr double kMarginSmoothing = 0.1;
+
+/**
+ * @brief Frames further behind than this resynchronise to "now" instead of trying to catch up.
+ */
+constexpr double kMaxPacingLag = 0.1;
+
+/**
+ * @brief Hints the CPU that we are busy-waiting.
+ */
+inline void cpuRelax() {
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+    _mm_pause();
+#elif defined(__aarch64__) || defined(__arm__)
+    __asm__ __volatile__("yield");
+#else
+    std::this_thread::yield();
+#endif
+}
+
+double toSeconds(FrameScheduler::Clock::duration duration) {
+    return std::chrono::duration<double>(duration).count();
+}
+
+} // namespace
+
+/**
+ * @brief Constructs a FrameScheduler with the default FrameConfig.
+ */
+FrameScheduler::FrameScheduler()
+    : m_accumulator(0.0),
+      m_stepsThisFrame(0),
+      m_sleepMargin(0.001) {
+}
+
+/**
+ * @brief Replaces the configuration. Invalid values are clamped to something usable.
+ * @param config The new frame configuration.
+ */
+void FrameScheduler::configure(const FrameConfig& config) {
+    m_config = config;
+    if (m_config.fixedTimestep <= 0.0) {
+        m_config.fixedTimestep = 1.0 / 60.0;
+    }
+    if (m_config.maxStepsPerFrame < 1) {
+        m_config.maxStepsPerFrame = 1;
+    }
+    if (m_config.targetFps <= 0.0) {
+        m_config.pacing = FramePacing::Uncapped;
+    }
+}
+
+/**
+ * @brief Resets the clocks. Called once before the first frame.
+ */
+void FrameScheduler::start() {
+    m_frameStart = Clock::now();
+    m_nextDeadline = m_frameStart;
+    m_accumulator = 0.0;
+    m_stepsThisFrame = 0;
+    m_stats = FrameTimingStats();
+}
+
+/**
+ * @brief Starts a new frame and feeds the elapsed time into the simulation accumulator.
+ */
+void FrameScheduler::beginFrame() {
+    const Clock::time_point now = Clock::now();
+    const double frameTime = m_stats.frameIndex == 0 ? 0.0 : toSeconds(now - m_frameStart);
+    m_frameStart = now;
+
+    m_stats.frameTime = frameTime;
+    m_stats.averageFrameTime = m_stats.frameIndex <= 1
+        ? frameTime
+        : m_stats.averageFrameTime + (frameTime - m_stats.averageFrameTime) * 0.05;
+    ++m_stats.frameIndex;
+
+    m_accumulator += frameTime;
+    m_stepsThisFrame = 0;
+}
+
+/**
+ * @brief Restarts the frame clock after idling, leaving at least one step to run.
+ */
+void FrameScheduler::resume() {
+    m_frameStart = Clock::now();
+    m_nextDeadline = m_frameStart;
+    m_accumulator = std::max(m_accumulator, m_config.fixedTimestep);
+}
+
+/**
+ * @brief Consumes one fixed step from the accumulator, applying the spiral guard.
+ * @return true if the caller should run one more simulation step this frame.
+ */
+bool FrameScheduler::consumeFixedStep() {
+    const double step = m_config.fixedTimestep;
+    if (m_accumulator < step) {
+        return false;
+    }
+
+    if (m_stepsThisFrame >= m_config.maxStepsPerFrame) {
+        // Too far behind: drop whole steps so the next frame does not start even further behind.
+        const double surplus = m_accumulator - step;
+        const auto dropped = static_cast<std::uint64_t>(surplus / step) + 1;
+        m_stats.droppedSteps += dropped;
+        m_accumulator -= static_cast<double>(dropped) * step;
+        return false;
+    }
+
+    m_accumulator -= step;
+    ++m_stepsThisFrame;
+    ++m_stats.simulationSteps;
+    return true;
+}
+
+/**
+ * @brief Fraction of a fixed step left in the accumulator, in [0, 1).
+ */
+double FrameScheduler::getAlpha() const {
+    return std::clamp(m_accumulator / m_config.fixedTimestep, 0.0, 1.0);
+}
+
+/**
+ * @brief Blocks until the next frame deadline when pacing is TargetFps.
+ */
+void FrameScheduler::waitForNextFrame() {
+    if (m_config.pacing != FramePacing::TargetFps) {
+        return;
+    }
+
+    const auto period = std::chrono::duration_cast<Clock::duration>(
+        std::chrono::duration<double>(1.0 / m_config.targetFps));
+    m_nextDeadline += period;
+
+    Clock::time_point now = Clock::now();
+    if (toSeconds(now - m_nextDeadline) > kMaxPacingLag) {
+        // We missed the deadline by a lot (breakpoint, window drag, load hitch); start over.
+        m_nextDeadline = now;
+        return;
+    }
+
+    // Coarse phase: let the OS sleep us until shortly before the deadline.
+    const double remaining = toSeconds(m_nextDeadline - now);
+    if (remaining > m_sleepMargin) {
+        const auto sleepFor = std::chrono::duration<double>(remaining - m_sleepMargin);
+        const Clock::time_point sleepStart = now;
+        std::this_thread::sleep_for(sleepFor);
+        now = Clock::now();
+
+        // Track how much the OS oversleeps and keep the margin just above it.
+        const double overslept = toSeconds(now - sleepStart) - sleepFor.count();
+        const double target = std::clamp(overslept * 1.5, kMinSleepMargin, kMaxSleepMargin);
+        m_sleepMargin += (target - m_sleepMargin) * (target > m_sleepMargin ? 0.5 : kMarginSmoothing);
+    }
+
+    // Fine phase: spin for the last fraction of a millisecond.
+    while (now < m_nextDeadline) {
+        cpuRelax();
+        now = Clock::now();
+    }
+
+    m_stats.lastWakeError = toSeconds(now - m_nextDeadline);
+    m_stats.maxWakeError = std::max(m_stats.maxWakeError, m_stats.lastWakeError);
+}
+
+} // namespace polaris
@@ -0,0 +1,172 @@
+#ifndef POLARIS_FRAMESCHEDULER_H
+#define POLARIS_FRAMESCHEDULER_H
+
+#include <chrono>
+#include <cstdint>
+
+namespace polaris {
+
+/**
+ * @brief How the engine paces presented frames.
+ */
+enum class FramePacing {
+    Uncapped,   ///< Render as fast as possible.
+    TargetFps,  ///< Sleep-then-spin until the next frame deadline derived from targetFps.
+    VSync       ///< Let the renderer's present call block on the display refresh.
+};
+
+/**
+ * @brief Configuration of the engine's frame loop.
+ */
+struct FrameConfig {
+    /**
+     * @brief Length of one simulation step in seconds, passed to Application::update.
+     */
+    double fixedTimestep = 1.0 / 60.0;
+    /**
+     * @brief Most simulation steps run in a single frame. When the loop falls further behind,
+     * the surplus time is discarded instead of letting the catch-up spiral.
+     */
+    int maxStepsPerFrame = 5;
+    /**
+     * @brief Frame pacing mode.
+     */
+    FramePacing pacing = FramePacing::TargetFps;
+    /**
+     * @brief Frame rate used by FramePacing::TargetFps.
+     */
+    double targetFps = 60.0;
+    /**
+     * @brief Execute command lists on a dedicated render thread. Read once in Engine::initialize;
+     * ignored on platforms that must render on the main thread.
+     */
+    bool threadedRendering = true;
+    /**
+     * @brief Frames the render thread may lag behind the game thread before recording blocks.
+     */
+    int framesInFlight = 1;
+    /**
+     * @brief Render only when something changed: while nothing requested a redraw or marked
+     * damage (see Engine::markDirty), the engine waits for events instead of looping. Meant
+     * for tools and editors, which are idle most of the time.
+     */
+    bool onDemand = false;
+    /**
+     * @brief Longest wait for an event in on-demand mode, in seconds. The loop still wakes
+     * this often to pick up streamed textures, reloaded assets and events posted from other
+     * threads, none of which wake SDL.
+     */
+    double idleTimeout = 0.25;
+    /**
+     * @brief Fraction of the window in on-demand mode beyond which damage is redrawn in full.
+     */
+    float fullRedrawThreshold = 0.5f;
+};
+
+/**
+ * @brief Frame timing counters, updated once per frame.
+ */
+struct FrameTimingStats {
+    double frameTime = 0.0;           ///< Seconds between the last two frame starts.
+    double averageFrameTime = 0.0;    ///< Exponential moving average of frameTime.
+    double lastWakeError = 0.0;       ///< Seconds the last wait overshot its deadline.
+    double maxWakeError = 0.0;        ///< Largest wake error seen since start().
+    std::uint64_t frameIndex = 0;     ///< Number of frames begun since start().
+    std::uint64_t simulationSteps = 0;///< Fixed steps run since start().
+    std::uint64_t droppedSteps = 0;   ///< Fixed steps discarded by the spiral guard.
+};
+
+/**
+ * @brief Drives the engine loop: a fixed-step simulation clock with accumulator-based catch-up,
+ * an interpolation alpha for the variable-rate render, and frame pacing.
+ *
+ * Per frame the engine calls beginFrame(), runs Application::update while consumeFixedStep()
+ * returns true, renders with getAlpha(), and finally calls waitForNextFrame().
+ */
+class FrameScheduler {
+public:
+    using Clock = std::chrono::steady_clock;
+
+    /**
+     * @brief Constructs a FrameScheduler with the default FrameConfig.
+     */
+    FrameScheduler();
+
+    /**
+     * @brief Replaces the configuration. Takes effect from the next frame.
+     * @param config The new frame configuration.
+     */
+    void configure(const FrameConfig& config);
+
+    /**
+     * @brief Returns the current configuration.
+     */
+    const FrameConfig& getConfig() const { return m_config; }
+
+    /**
+     * @brief Resets the clocks. Called once before the first frame.
+     */
+    void start();
+
+    /**
+     * @brief Starts a new frame: measures the time since the previous frame and adds it to
+     * the simulation accumulator.
+     */
+    void beginFrame();
+
+    /**
+     * @brief Discards the time since the last frame, after the loop sat idle waiting for
+     * events, so that it is not simulated. One fixed step is kept for the events that ended
+     * the wait.
+     */
+    void resume();
+
+    /**
+     * @brief Consumes one fixed step from the accumulator.
+     * @return true if the caller should run one more simulation step this frame.
+     */
+    bool consumeFixedStep();
+
+    /**
+     * @brief Fraction of a fixed step left in the accumulator, in [0, 1). Used to
+     * interpolate between the last two simulation states when rendering.
+     */
+    double getAlpha() const;
+
+    /**
+     * @brief Length of one fixed step in seconds.
+     */
+    double getFixedTimestep() const { return m_config.fixedTimestep; }
+
+    /**
+     * @brief Blocks until the next frame deadline when pacing is TargetFps.
+     *
+     * Sleeps with the OS scheduler until shortly before the deadline, then spins for the rest.
+     * The sleep margin adapts to how much the OS has been oversleeping, so the spin stays
+     * short while the wake-up jitter stays well under a millisecond.
+     */
+    void waitForNextFrame();
+
+    /**
+     * @brief Returns the frame timing counters.
+     */
+    const FrameTimingStats& getStats() const { return m_stats; }
+
+private:
+    FrameConfig m_config;
+    FrameTimingStats m_stats;
+
+    Clock::time_point m_frameStart;
+    Clock::time_point m_nextDeadline;
+    double m_accumulator;
+    int m_stepsThisFrame;
+
+    /**
+     * @brief Seconds before a deadline at which sleeping stops and spinning starts.
+     */
+    double m_sleepMargin;
+};
+
+} // namespace polaris
+
+#endif // POLARIS_FRAMESCHEDULER_H
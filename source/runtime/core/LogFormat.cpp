@@ -0,0 +1,280 @@
+#include "LogFormat.h"
+#include <cstdio>
+#include <cstring>
+
+namespace polaris {
+
+namespace {
+
+/**
+ * @brief Bounded output cursor; writes past the end are silently discarded.
+ */
+struct FormatOutput {
+    char* buffer;
+    std::size_t capacity;
+    std::size_t length;
+
+    void put(char c) {
+        if (length < capacity) {
+            buffer[length++] = c;
+        }
+    }
+
+    void put(const char* data, std::size_t size) {
+        std::size_t available = capacity - length;
+        if (size > available) {
+            size = available;
+        }
+        std::memcpy(buffer + length, data, size);
+        length += size;
+    }
+};
+
+struct FormatSpec {
+    int precision = -1;
+    char type = 0;
+};
+
+void putUnsigned(FormatOutput& out, std::uint64_t value, unsigned base, bool upper) {
+    const char* digits = upper ? "0123456789ABCDEF" : "0123456789abcdef";
+    char temp[24];
+    int count = 0;
+    do {
+        temp[count++] = digits[value % base];
+        value /= base;
+    } while (value != 0);
+    while (count > 0) {
+        out.put(temp[--count]);
+    }
+}
+
+void putArg(FormatOutput& out, const LogArg& arg, const FormatSpec& spec) {
+    const bool hex = spec.type == 'x' || spec.type == 'X';
+    switch (arg.type) {
+        case LogArgType::Bool:
+            if (arg.b) {
+                out.put("true", 4);
+            } else {
+                out.put("false", 5);
+            }
+            break;
+        case LogArgType::Char:
+            out.put(arg.c);
+            break;
+        case LogArgType::Int:
+            if (arg.i < 0) {
+                out.put('-');
+                putUnsigned(out, 0 - static_cast<std::uint64_t>(arg.i), hex ? 16 : 10, spec.type == 'X');
+            } else {
+                putUnsigned(out, static_cast<std::uint64_t>(arg.i), hex ? 16 : 10, spec.type == 'X');
+            }
+            break;
+        case LogArgType::UInt:
+            putUnsigned(out, arg.u, hex ? 16 : 10, spec.type == 'X');
+            break;
+        case LogArgType::Float: {
+            char format[8] = {'%', '.', '*', 'g', 0};
+            if (spec.type == 'f' || spec.type == 'e' || spec.type == 'g') {
+                format[3] = spec.type;
+            }
+            char temp[64];
+            int written = std::snprintf(temp, sizeof(temp), format, spec.precision >= 0 ? spec.precision : 6, arg.d);
+            if (written > 0) {
+                out.put(temp, static_cast<std::size_t>(written) < sizeof(temp) ? static_cast<std::size_t>(written) : sizeof(temp) - 1);
+            }
+            break;
+        }
+        case LogArgType::Pointer:
+            out.put("0x", 2);
+            putUnsigned(out, static_cast<std::uint64_t>(reinterpret_cast<std::uintptr_t>(arg.p)), 16, false);
+            break;
+        case LogArgType::String: {
+            std::size_t size = arg.s.size;
+            if (spec.precision >= 0 && static_cast<std::size_t>(spec.precision) < size) {
+                size = static_cast<std::size_t>(spec.precision);
+            }
+            out.put(arg.s.data, size);
+            break;
+        }
+    }
+}
+
+/**
+ * @brief Parses the text between '{' and '}' of a placeholder.
+ * @return false if it is not a placeholder this formatter understands.
+ */
+bool parseSpec(const char* begin, const char* end, FormatSpec& spec) {
+    if (begin == end) {
+        return true;
+    }
+    if (*begin != ':') {
+        return false;
+    }
+    ++begin;
+    if (begin != end && *begin == '.') {
+        ++begin;
+        int precision = 0;
+        while (begin != end && *begin >= '0' && *begin <= '9') {
+            precision = precision * 10 + (*begin - '0');
+            ++begin;
+        }
+        spec.precision = precision;
+    }
+    if (begin != end) {
+        spec.type = *begin++;
+    }
+    return begin == end;
+}
+
+} // namespace
+
+const char* getLogLevelName(LogLevel level) {
+    switch (level) {
+        case LogLevel::TRACE: return "TRACE";
+        case LogLevel::DEBUG_LEVEL: return "DEBUG";
+        case LogLevel::INFO: return "INFO";
+        case LogLevel::WARN: return "WARN";
+        case LogLevel::CRITICAL: return "CRITICAL";
+        case LogLevel::ERROR_LOG: return "ERROR";
+        default: return "UNKNOWN";
+    }
+}
+
+std::size_t formatLogMessage(char* buffer, std::size_t capacity, const char* format,
+                             const LogArg* args, std::size_t argCount) {
+    FormatOutput out{buffer, capacity, 0};
+    std::size_t nextArg = 0;
+
+    const char* cursor = format;
+    while (*cursor != '\0' && out.length < capacity) {
+        const char c = *cursor;
+        if (c == '{') {
+            if (cursor[1] == '{') {
+                out.put('{');
+                cursor += 2;
+                continue;
+            }
+            const char* close = std::strchr(cursor + 1, '}');
+            FormatSpec spec;
+            if (close && nextArg < argCount && parseSpec(cursor + 1, close, spec)) {
+                putArg(out, args[nextArg++], spec);
+                cursor = close + 1;
+                continue;
+            }
+        } else if (c == '}' && cursor[1] == '}') {
+            out.put('}');
+            cursor += 2;
+            continue;
+        }
+        out.put(c);
+        ++cursor;
+    }
+
+    return out.length;
+}
+
+std::size_t encodeLogArgs(std::uint8_t* buffer, std::size_t capacity, const LogArg* args, std::size_t argCount) {
+    std::size_t offset = 0;
+    for (std::size_t i = 0; i < argCount && i < kMaxLogArgs; ++i) {
+        const LogArg& arg = args[i];
+        switch (arg.type) {
+            case LogArgType::Bool:
+            case LogArgType::Char:
+                if (offset + 2 > capacity) return offset;
+                buffer[offset++] = static_cast<std::uint8_t>(arg.type);
+                buffer[offset++] = arg.type == LogArgType::Bool ? static_cast<std::uint8_t>(arg.b) : static_cast<std::uint8_t>(arg.c);
+                break;
+            case LogArgType::Int:
+            case LogArgType::UInt:
+            case LogArgType::Float:
+            case LogArgType::Pointer: {
+                if (offset + 9 > capacity) return offset;
+                buffer[offset++] = static_cast<std::uint8_t>(arg.type);
+                std::uint64_t raw;
+                if (arg.type == LogArgType::Float) {
+                    std::memcpy(&raw, &arg.d, sizeof(raw));
+                } else if (arg.type == LogArgType::Pointer) {
+                    raw = static_cast<std::uint64_t>(reinterpret_cast<std::uintptr_t>(arg.p));
+                } else {
+                    raw = arg.u;
+                }
+                std::memcpy(buffer + offset, &raw, sizeof(raw));
+                offset += sizeof(raw);
+                break;
+            }
+            case LogArgType::String: {
+                if (offset + 3 > capacity) return offset;
+                std::size_t size = arg.s.size;
+                if (size > capacity - offset - 3) {
+                    size = capacity - offset - 3;
+                }
+                if (size > 0xFFFF) {
+                    size = 0xFFFF;
+                }
+                const std::uint16_t length = static_cast<std::uint16_t>(size);
+                buffer[offset++] = static_cast<std::uint8_t>(arg.type);
+                std::memcpy(buffer + offset, &length, sizeof(length));
+                offset += sizeof(length);
+                std::memcpy(buffer + offset, arg.s.data, size);
+                offset += size;
+                break;
+            }
+        }
+    }
+    return offset;
+}
+
+std::size_t decodeLogArgs(const std::uint8_t* data, std::size_t size, LogArg* args, std::size_t maxArgs) {
+    std::size_t offset = 0;
+    std::size_t count = 0;
+    while (offset < size && count < maxArgs) {
+        LogArg& arg = args[count];
+        arg.type = static_cast<LogArgType>(data[offset++]);
+        switch (arg.type) {
+            case LogArgType::Bool:
+            case LogArgType::Char:
+                if (offset + 1 > size) return 0;
+                if (arg.type == LogArgType::Bool) {
+                    arg.b = data[offset] != 0;
+                } else {
+                    arg.c = static_cast<char>(data[offset]);
+                }
+                offset += 1;
+                break;
+            case LogArgType::Int:
+            case LogArgType::UInt:
+            case LogArgType::Float:
+            case LogArgType::Pointer: {
+                std::uint64_t raw;
+                if (offset + sizeof(raw) > size) return 0;
+                std::memcpy(&raw, data + offset, sizeof(raw));
+                offset += sizeof(raw);
+                if (arg.type == LogArgType::Float) {
+                    std::memcpy(&arg.d, &raw, sizeof(raw));
+                } else if (arg.type == LogArgType::Pointer) {
+                    arg.p = reinterpret_cast<const void*>(static_cast<std::uintptr_t>(raw));
+                } else {
+                    arg.u = raw;
+                }
+                break;
+            }
+            case LogArgType::String: {
+                std::uint16_t length;
+                if (offset + sizeof(length) > size) return 0;
+                std::memcpy(&length, data + offset, sizeof(length));
+                offset += sizeof(length);
+                if (offset + length > size) return 0;
+                arg.s.data = reinterpret_cast<const char*>(data + offset);
+                arg.s.size = length;
+                offset += length;
+                break;
+            }
+            default:
+                return 0;
+        }
+        ++count;
+    }
+    return count;
+}
+
+} // namespace polaris
@@ -0,0 +1,178 @@
+#ifndef POLARIS_LOGFORMAT_H
+#define POLARIS_LOGFORMAT_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <type_traits>
+
+namespace polaris {
+
+enum class LogLevel {
+    TRACE = 0,
+    DEBUG_LEVEL = 1,  // Renamed from DEBUG to avoid macro conflicts
+    INFO = 2,
+    WARN = 3,
+    ERROR_LOG = 4,
+    CRITICAL = 5
+};
+
+/**
+ * @brief Returns the upper-case name printed for a level ("TRACE", "DEBUG", ...).
+ */
+const char* getLogLevelName(LogLevel level);
+
+/**
+ * @brief Most arguments a single log call may carry; extra arguments are ignored.
+ */
+constexpr std::size_t kMaxLogArgs = 16;
+
+/**
+ * @brief Type tag of a captured log argument.
+ */
+enum class LogArgType : std::uint8_t {
+    Bool = 0,
+    Char = 1,
+    Int = 2,
+    UInt = 3,
+    Float = 4,
+    Pointer = 5,
+    String = 6
+};
+
+/**
+ * @brief A type-erased, non-owning view of one argument passed to a LOG_* macro.
+ *
+ * Capturing arguments this way lets the formatter live in a single translation unit
+ * instead of being instantiated for every argument combination.
+ */
+struct LogArg {
+    LogArgType type;
+    union {
+        bool b;
+        char c;
+        std::int64_t i;
+        std::uint64_t u;
+        double d;
+        const void* p;
+        struct {
+            const char* data;
+            std::size_t size;
+        } s;
+    };
+};
+
+inline LogArg makeLogArg(bool value) {
+    LogArg arg;
+    arg.type = LogArgType::Bool;
+    arg.b = value;
+    return arg;
+}
+
+inline LogArg makeLogArg(char value) {
+    LogArg arg;
+    arg.type = LogArgType::Char;
+    arg.c = value;
+    return arg;
+}
+
+template <typename T, typename std::enable_if<std::is_integral<T>::value && std::is_signed<T>::value && !std::is_same<T, char>::value, int>::type = 0>
+inline LogArg makeLogArg(T value) {
+    LogArg arg;
+    arg.type = LogArgType::Int;
+    arg.i = static_cast<std::int64_t>(value);
+    return arg;
+}
+
+template <typename T, typename std::enable_if<std::is_integral<T>::value && std::is_unsigned<T>::value && !std::is_same<T, bool>::value, int>::type = 0>
+inline LogArg makeLogArg(T value) {
+    LogArg arg;
+    arg.type = LogArgType::UInt;
+    arg.u = static_cast<std::uint64_t>(value);
+    return arg;
+}
+
+template <typename T, typename std::enable_if<std::is_enum<T>::value, int>::type = 0>
+inline LogArg makeLogArg(T value) {
+    return makeLogArg(static_cast<typename std::underlying_type<T>::type>(value));
+}
+
+inline LogArg makeLogArg(double value) {
+    LogArg arg;
+    arg.type = LogArgType::Float;
+    arg.d = value;
+    return arg;
+}
+
+inline LogArg makeLogArg(float value) {
+    return makeLogArg(static_cast<double>(value));
+}
+
+inline LogArg makeLogArg(std::string_view value) {
+    LogArg arg;
+    arg.type = LogArgType::String;
+    arg.s.data = value.data();
+    arg.s.size = value.size();
+    return arg;
+}
+
+inline LogArg makeLogArg(const std::string& value) {
+    return makeLogArg(std::string_view(value));
+}
+
+inline LogArg makeLogArg(const char* value) {
+    return makeLogArg(std::string_view(value ? value : "(null)"));
+}
+
+inline LogArg makeLogArg(char* value) {
+    return makeLogArg(static_cast<const char*>(value));
+}
+
+template <typename T>
+inline LogArg makeLogArg(const T* value) {
+    LogArg arg;
+    arg.type = LogArgType::Pointer;
+    arg.p = value;
+    return arg;
+}
+
+/**
+ * @brief Formats a "{}"-style format string into a caller-provided buffer.
+ *
+ * Each "{}" is replaced by the next argument. A placeholder may carry a short spec after a
+ * colon: an optional ".N" precision and an optional type of 'x'/'X' (hex), 'f', 'e' or 'g'.
+ * "{{" and "}}" produce literal braces. Placeholders without a matching argument are copied
+ * through unchanged. Output is truncated to fit; the buffer is not NUL-terminated.
+ *
+ * @param buffer Destination buffer.
+ * @param capacity Size of the destination buffer in bytes.
+ * @param format The format string.
+ * @param args The captured arguments.
+ * @param argCount Number of entries in args.
+ * @return The number of bytes written.
+ */
+std::size_t formatLogMessage(char* buffer, std::size_t capacity, const char* format,
+                             const LogArg* args, std::size_t argCount);
+
+/**
+ * @brief Serialises captured arguments into a compact byte stream.
+ *
+ * Each argument is a one-byte type tag followed by its raw value: one byte for Bool/Char,
+ * eight bytes for Int/UInt/Float/Pointer, and a 16-bit length plus the bytes for String.
+ * Values are stored in host byte order. Strings are truncated, and trailing arguments
+ * dropped, when they do not fit.
+ *
+ * @return The number of bytes written.
+ */
+std::size_t encodeLogArgs(std::uint8_t* buffer, std::size_t capacity, const LogArg* args, std::size_t argCount);
+
+/**
+ * @brief Reverses encodeLogArgs. String arguments point into the encoded buffer.
+ * @return The number of arguments decoded (at most maxArgs), or 0 on malformed input.
+ */
+std::size_t decodeLogArgs(const std::uint8_t* data, std::size_t size, LogArg* args, std::size_t maxArgs);
+
+} // namespace polaris
+
+#endif // POLARIS_LOGFORMAT_H
@@ -1,10 +1,17 @@
 #include "Logger.h"
+#include "BinaryLog.h"
+#include "memory/MemoryTracker.h"
+#include "profiling/Profiler.h"
 #include <iostream>
 #include <fstream>
-#include <sstream>
 #include <chrono>
-#include <iomanip>
 #include <mutex>
+#include <condition_variable>
+#include <thread>
+#include <atomic>
+#include <vector>
+#include <cstring>
+#include <cstdio>
 #include <ctime>
 
 #ifdef _WIN32
@@ -17,51 +24,455 @@
 
 namespace polaris {
 
+namespace {
+
+/**
+ * @brief Bytes of encoded arguments a queued record can carry; longer argument lists are truncated.
+ * Sized so that a whole record fits in 512 bytes.
+ */
+constexpr std::size_t kMaxRecordArgs = 512 - 16;
+
+/**
+ * @brief Longest formatted message; also the size of the thread-local formatting buffer.
+ */
+constexpr std::size_t kMaxMessageLength = 1024;
+
+/**
+ * @brief Longest formatted line ("[timestamp] [LEVEL] message").
+ */
+constexpr std::size_t kMaxLineLength = kMaxMessageLength + 64;
+
+/**
+ * @brief Number of records the writer thread dequeues before emitting output.
+ */
+constexpr std::size_t kWriterBatchSize = 64;
+
+/**
+ * @brief Site id used for messages logged verbatim (std::string overloads, trace()/info()/...).
+ * Its format string is "{}" and the record carries the message as a single string argument.
+ */
+constexpr std::uint32_t kVerbatimSiteId = 1;
+
+/**
+ * @brief A log record as stored in the ring buffer: the call site, a raw steady_clock tick,
+ * and the encoded arguments. Formatting is deferred to the sinks.
+ */
+struct LogRecord {
+    std::uint64_t tick;
+    std::uint32_t siteId;
+    std::uint8_t level;
+    std::uint8_t reserved;
+    std::uint16_t argBytes;
+    std::uint8_t args[kMaxRecordArgs];
+};
+
+static_assert(sizeof(LogRecord) == 512, "LogRecord is expected to be 512 bytes");
+
+/**
+ * @brief Number of LogRecord bytes that carry data for a given record.
+ */
+std::size_t usedRecordBytes(const LogRecord& record) {
+    return offsetof(LogRecord, args) + record.argBytes;
+}
+
+std::uint64_t currentTick() {
+    return static_cast<std::uint64_t>(std::chrono::steady_clock::now().time_since_epoch().count());
+}
+
+std::size_t roundUpToPowerOfTwo(std::size_t value) {
+    std::size_t result = 2;
+    while (result < value) {
+        result <<= 1;
+    }
+    return result;
+}
+
+/**
+ * @brief Process-wide table of LOG_* call sites, indexed by site id.
+ *
+ * Entries live in fixed-size chunks that are never moved, so the writer thread can look up
+ * any id below the published count without taking the registration lock.
+ */
+class LogSiteRegistry {
+public:
+    struct Entry {
+        std::string format;
+        std::string file;
+        std::uint32_t line = 0;
+        LogLevel level = LogLevel::INFO;
+    };
+
+    /**
+     * @brief Never destroyed: the Logger singleton may be constructed before it and still
+     * drain records against it from its destructor at exit.
+     */
+    static LogSiteRegistry& get() {
+        static LogSiteRegistry* registry = new LogSiteRegistry();
+        return *registry;
+    }
+
+    std::uint32_t add(const char* format, const char* file, std::uint32_t line, LogLevel level) {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        const std::uint32_t id = m_count.load(std::memory_order_relaxed);
+        const std::size_t chunkIndex = id / kChunkSize;
+        if (chunkIndex >= kMaxChunks) {
+            return kVerbatimSiteId;
+        }
+        if (!m_chunks[chunkIndex]) {
+            m_chunks[chunkIndex].reset(new Entry[kChunkSize]);
+        }
+        Entry& entry = m_chunks[chunkIndex][id % kChunkSize];
+        entry.format = format;
+        entry.file = file;
+        entry.line = line;
+        entry.level = level;
+        m_count.store(id + 1, std::memory_order_release);
+        return id;
+    }
+
+    const Entry* find(std::uint32_t id) const {
+        if (id == 0 || id >= m_count.load(std::memory_order_acquire)) {
+            return nullptr;
+        }
+        return &m_chunks[id / kChunkSize][id % kChunkSize];
+    }
+
+    /**
+     * @brief Serialises the registration of LogSite::id for a given site.
+     */
+    std::mutex& siteMutex() { return m_siteMutex; }
+
+private:
+    static constexpr std::size_t kChunkSize = 256;
+    static constexpr std::size_t kMaxChunks = 256;
+
+    LogSiteRegistry() {
+        // Id 0 means "not registered yet"; id 1 is the verbatim site.
+        m_chunks[0].reset(new Entry[kChunkSize]);
+        m_chunks[0][kVerbatimSiteId].format = "{}";
+        m_count.store(kVerbatimSiteId + 1, std::memory_order_release);
+    }
+
+    std::mutex m_mutex;
+    std::mutex m_siteMutex;
+    std::unique_ptr<Entry[]> m_chunks[kMaxChunks];
+    std::atomic<std::uint32_t> m_count{0};
+};
+
+/**
+ * @brief Bounded lock-free ring buffer of log records.
+ *
+ * Every slot carries a sequence number that tells producers and consumers whether the slot is
+ * free or published, so enqueue and dequeue only need one CAS on their respective cursor.
+ * Many threads may enqueue; the writer thread is the normal consumer, but producers may also
+ * dequeue the oldest record when the Overwrite policy is in effect, so dequeue is CAS-based too.
+ */
+class LogRingBuffer {
+public:
+    explicit LogRingBuffer(std::size_t capacity)
+        : m_mask(roundUpToPowerOfTwo(capacity) - 1),
+          m_slots(new Slot[m_mask + 1]) {
+        for (std::size_t i = 0; i <= m_mask; ++i) {
+            m_slots[i].sequence.store(i, std::memory_order_relaxed);
+        }
+    }
+
+    std::size_t capacity() const { return m_mask + 1; }
+
+    /**
+     * @brief Approximate number of queued records. Only used as a wake-up heuristic.
+     */
+    std::size_t sizeApprox() const {
+        std::size_t tail = m_enqueuePos.load(std::memory_order_relaxed);
+        std::size_t head = m_dequeuePos.load(std::memory_order_relaxed);
+        return tail >= head ? tail - head : 0;
+    }
+
+    bool tryEnqueue(const LogRecord& record) {
+        Slot* slot;
+        std::size_t pos = m_enqueuePos.load(std::memory_order_relaxed);
+        for (;;) {
+            slot = &m_slots[pos & m_mask];
+            std::size_t sequence = slot->sequence.load(std::memory_order_acquire);
+            std::intptr_t diff = static_cast<std::intptr_t>(sequence) - static_cast<std::intptr_t>(pos);
+            if (diff == 0) {
+                if (m_enqueuePos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                    break;
+                }
+            } else if (diff < 0) {
+                return false;
+            } else {
+                pos = m_enqueuePos.load(std::memory_order_relaxed);
+            }
+        }
+
+        std::memcpy(&slot->record, &record, usedRecordBytes(record));
+        slot->sequence.store(pos + 1, std::memory_order_release);
+        return true;
+    }
+
+    /**
+     * @brief Dequeues the oldest record into out (if out is non-null).
+     * @return false if the buffer is empty.
+     */
+    bool tryDequeue(LogRecord* out) {
+        Slot* slot;
+        std::size_t pos = m_dequeuePos.load(std::memory_order_relaxed);
+        for (;;) {
+            slot = &m_slots[pos & m_mask];
+            std::size_t sequence = slot->sequence.load(std::memory_order_acquire);
+            std::intptr_t diff = static_cast<std::intptr_t>(sequence) - static_cast<std::intptr_t>(pos + 1);
+            if (diff == 0) {
+                if (m_dequeuePos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                    break;
+                }
+            } else if (diff < 0) {
+                return false;
+            } else {
+                pos = m_dequeuePos.load(std::memory_order_relaxed);
+            }
+        }
+
+        if (out) {
+            std::memcpy(out, &slot->record, usedRecordBytes(slot->record));
+        }
+        slot->sequence.store(pos + m_mask + 1, std::memory_order_release);
+        return true;
+    }
+
+private:
+    struct Slot {
+        std::atomic<std::size_t> sequence;
+        LogRecord record;
+    };
+
+    const std::size_t m_mask;
+    std::unique_ptr<Slot[]> m_slots;
+    alignas(64) std::atomic<std::size_t> m_enqueuePos{0};
+    alignas(64) std::atomic<std::size_t> m_dequeuePos{0};
+};
+
+/**
+ * @brief An append-only log file that rotates by size and/or age.
+ */
+class RotatingLogFile {
+public:
+    /**
+     * @brief Opens path for appending.
+     * @param startFresh Rotate an existing non-empty file away first, so this session starts a new file.
+     */
+    bool open(const std::string& path, const LogRotationConfig& rotation, bool binary, bool startFresh) {
+        m_path = path;
+        m_rotation = rotation;
+        m_mode = std::ios::app | (binary ? std::ios::binary : std::ios::openmode());
+
+        if (startFresh && currentFileSize() > 0) {
+            shiftRotatedFiles();
+        }
+        return reopen();
+    }
+
+    bool isOpen() const { return m_stream.is_open(); }
+    std::uint64_t size() const { return m_size; }
+
+    /**
+     * @brief True if writing another pendingBytes would cross the size limit, or the file is too old.
+     */
+    bool needsRotation(std::size_t pendingBytes) const {
+        if (m_size == 0) {
+            return false;
+        }
+        if (m_rotation.maxFileBytes > 0 && m_size + pendingBytes > m_rotation.maxFileBytes) {
+            return true;
+        }
+        return m_rotation.maxFileAge.count() > 0 &&
+               std::chrono::steady_clock::now() - m_openedAt >= m_rotation.maxFileAge;
+    }
+
+    void rotate() {
+        m_stream.close();
+        shiftRotatedFiles();
+        reopen();
+    }
+
+    void write(const std::string& data) {
+        if (data.empty()) return;
+        m_stream.write(data.data(), static_cast<std::streamsize>(data.size()));
+        m_size += data.size();
+    }
+
+    void flush() { m_stream.flush(); }
+    void close() { m_stream.close(); }
+
+private:
+    /**
+     * @brief "dir/vega42.log" + 2 -> "dir/vega42.2.log".
+     */
+    std::string rotatedPath(unsigned index) const {
+        const std::size_t slash = m_path.find_last_of("/\\");
+        const std::size_t dot = m_path.find_last_of('.');
+        const std::string suffix = "." + std::to_string(index);
+        if (dot == std::string::npos || (slash != std::string::npos && dot < slash)) {
+            return m_path + suffix;
+        }
+        return m_path.substr(0, dot) + suffix + m_path.substr(dot);
+    }
+
+    void shiftRotatedFiles() {
+        if (m_rotation.maxFiles == 0) {
+            std::remove(m_path.c_str());
+            return;
+        }
+        std::remove(rotatedPath(m_rotation.maxFiles).c_str());
+        for (unsigned index = m_rotation.maxFiles; index > 1; --index) {
+            std::rename(rotatedPath(index - 1).c_str(), rotatedPath(index).c_str());
+        }
+        std::rename(m_path.c_str(), rotatedPath(1).c_str());
+    }
+
+    std::uint64_t currentFileSize() const {
+        std::ifstream existing(m_path, std::ios::binary | std::ios::ate);
+        if (!existing.is_open()) {
+            return 0;
+        }
+        const std::streamoff size = existing.tellg();
+        return size > 0 ? static_cast<std::uint64_t>(size) : 0;
+    }
+
+    bool reopen() {
+        m_size = currentFileSize();
+        m_stream.open(m_path, m_mode);
+        m_openedAt = std::chrono::steady_clock::now();
+        return m_stream.is_open();
+    }
+
+    std::ofstream m_stream;
+    std::string m_path;
+    LogRotationConfig m_rotation;
+    std::ios::openmode m_mode = std::ios::app;
+    std::uint64_t m_size = 0;
+    std::chrono::steady_clock::time_point m_openedAt;
+};
+
+} // namespace
+
 class Logger::Impl {
 public:
-    std::ofstream logFile;
+    RotatingLogFile logFile;
+    RotatingLogFile binaryFile;
     std::mutex logMutex;
     LogLevel currentLevel = LogLevel::INFO;
     bool initialized = false;
 
-    std::string getTimestamp() {
-        auto now = std::chrono::system_clock::now();
-        auto time_t = std::chrono::system_clock::to_time_t(now);
-        auto ms = std::chrono::duration_cast<std::chrono::milliseconds>(
-            now.time_since_epoch()) % 1000;
+    LoggerConfig config;
+
+    // Maps record ticks back to wall-clock time.
+    BinaryLogHeader clockBase;
 
-        std::stringstream ss;
-        ss << std::put_time(std::localtime(&time_t), "%Y-%m-%d %H:%M:%S");
-        ss << '.' << std::setfill('0') << std::setw(3) << ms.count();
-        return ss.str();
+    // Sites already defined in the current binary file; reset whenever it rotates.
+    std::vector<bool> binarySitesWritten;
+
+    // Asynchronous mode state
+    std::unique_ptr<LogRingBuffer> queue;
+    std::thread writerThread;
+    std::mutex writerMutex;
+    std::condition_variable writerWake;
+    std::condition_variable writerProgress;
+    // Producers waiting for room under LogOverflowPolicy::Block
+    std::condition_variable spaceAvailable;
+    std::atomic<int> blockedProducers{0};
+    std::atomic<bool> accepting{false};
+    bool stopRequested = false;
+    // Set by flush() so the writer flushes its next batch without waiting for the interval
+    std::atomic<bool> flushRequested{false};
+    std::atomic<std::uint64_t> enqueuedCount{0};
+    // Records written to the sinks and flushed; what flush() waits on
+    std::atomic<std::uint64_t> writtenCount{0};
+    std::atomic<std::uint64_t> droppedCount{0};
+    std::atomic<std::uint64_t> overwrittenCount{0};
+
+    // Timestamp cache: the "%Y-%m-%d %H:%M:%S" part only changes once per second.
+    std::time_t cachedSecond = -1;
+    char cachedTimestamp[32] = {};
+
+    // Reused by whichever thread formats lines (the writer thread, or callers under logMutex).
+    std::string consoleBatch;
+    std::string fileBatch;
+    std::string binaryBatch;
+    std::string line;
+
+    Impl() {
+        clockBase.tickNumerator = std::chrono::steady_clock::period::num;
+        clockBase.tickDenominator = std::chrono::steady_clock::period::den;
+        clockBase.baseTick = currentTick();
+        clockBase.baseSystemNs = std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::system_clock::now().time_since_epoch()).count();
+        line.reserve(kMaxLineLength);
     }
-    
-    std::string getLevelString(LogLevel level) {
-        switch (level) {
-            case LogLevel::TRACE: return "TRACE";
-            case LogLevel::DEBUG_LEVEL: return "DEBUG";
-            case LogLevel::INFO: return "INFO";
-            case LogLevel::WARN: return "WARN";
-            case LogLevel::CRITICAL: return "CRITICAL";
-            case LogLevel::ERROR_LOG: return "ERROR";
-            default: return "UNKNOWN";
+
+    /**
+     * @brief Appends "[YYYY-mm-dd HH:MM:SS.mmm]" for the given tick to out.
+     * Not thread-safe; called by the writer thread or under logMutex.
+     */
+    void appendTimestamp(std::string& out, std::uint64_t tick) {
+        const std::int64_t systemNs = clockBase.tickToSystemNs(tick);
+        const std::time_t time_t = static_cast<std::time_t>(systemNs / 1000000000);
+        const int ms = static_cast<int>((systemNs / 1000000) % 1000);
+
+        if (time_t != cachedSecond) {
+            std::tm localTime{};
+#ifdef _WIN32
+            localtime_s(&localTime, &time_t);
+#else
+            localtime_r(&time_t, &localTime);
+#endif
+            std::strftime(cachedTimestamp, sizeof(cachedTimestamp), "%Y-%m-%d %H:%M:%S", &localTime);
+            cachedSecond = time_t;
         }
+
+        char millis[8];
+        std::snprintf(millis, sizeof(millis), ".%03d", ms);
+        out += '[';
+        out += cachedTimestamp;
+        out += millis;
+        out += ']';
     }
-    
-    void logToConsole(const std::string& message, LogLevel level) {
-        std::lock_guard<std::mutex> lock(logMutex);
-        
-        std::string timestamp = getTimestamp();
-        std::string levelStr = getLevelString(level);
-        
-        std::string formattedMessage = "[" + timestamp + "] [" + levelStr + "] " + message;
-        
+
+    /**
+     * @brief Appends "[timestamp] [LEVEL] message" (without a newline) to out.
+     * The message is produced here, from the site's format string and the record's arguments.
+     */
+    void formatLine(std::string& out, const LogRecord& record) {
+        appendTimestamp(out, record.tick);
+        out += " [";
+        out += getLogLevelName(static_cast<LogLevel>(record.level));
+        out += "] ";
+
+        const LogSiteRegistry::Entry* site = LogSiteRegistry::get().find(record.siteId);
+        if (!site) {
+            out += "<unknown log site>";
+            return;
+        }
+
+        LogArg args[kMaxLogArgs];
+        const std::size_t argCount = decodeLogArgs(record.args, record.argBytes, args, kMaxLogArgs);
+        char message[kMaxMessageLength];
+        const std::size_t length = formatLogMessage(message, sizeof(message), site->format.c_str(), args, argCount);
+        out.append(message, length);
+    }
+
+    /**
+     * @brief Emits one formatted line to the platform console.
+     * On platforms with a plain stdout console the line is appended to consoleBatch instead,
+     * and the caller writes the whole batch with a single call.
+     */
+    void emitConsole(const std::string& formattedMessage, LogLevel level) {
         // Platform-specific console output
 #ifdef _WIN32
         // Windows: Use colored output if available
         HANDLE hConsole = GetStdHandle(STD_OUTPUT_HANDLE);
         WORD color = FOREGROUND_RED | FOREGROUND_GREEN | FOREGROUND_BLUE; // White
-        
+
         switch (level) {
             case LogLevel::ERROR_LOG:
             case LogLevel::CRITICAL:
@@ -77,11 +488,11 @@ public:
                 color = FOREGROUND_BLUE | FOREGROUND_INTENSITY;
                 break;
         }
-        
+
         SetConsoleTextAttribute(hConsole, color);
-        std::cout << formattedMessage << std::endl;
+        std::cout << formattedMessage << '\n';
         SetConsoleTextAttribute(hConsole, FOREGROUND_RED | FOREGROUND_GREEN | FOREGROUND_BLUE);
-        
+
 #elif defined(__APPLE__)
         // macOS: Use os_log for system integration
         os_log_type_t logType = OS_LOG_TYPE_DEFAULT;
@@ -101,7 +512,7 @@ public:
                 break;
         }
         os_log_with_type(OS_LOG_DEFAULT, logType, "%{public}s", formattedMessage.c_str());
-        
+
 #elif defined(__ANDROID__)
         // Android: Use android_log
         android_LogPriority priority = ANDROID_LOG_INFO;
@@ -121,24 +532,324 @@ public:
                 break;
         }
         __android_log_print(priority, "Vega42", "%s", formattedMessage.c_str());
-        
+
 #else
-        // Linux/Other: Standard console output
-        std::cout << formattedMessage << std::endl;
+        // Linux/Other: Standard console output, written by the caller in one batch
+        (void)level;
+        consoleBatch += formattedMessage;
+        consoleBatch += '\n';
 #endif
     }
-    
-    void logToFile(const std::string& message, LogLevel level) {
-        if (!logFile.is_open()) return;
-        
+
+    /**
+     * @brief Writes whatever emitConsole accumulated in consoleBatch.
+     */
+    void writeConsoleBatch(bool flushStream) {
+        if (!consoleBatch.empty()) {
+            std::cout.write(consoleBatch.data(), static_cast<std::streamsize>(consoleBatch.size()));
+            consoleBatch.clear();
+        }
+        if (flushStream) {
+            std::cout.flush();
+        }
+    }
+
+    /**
+     * @brief Appends one line to the text file batch, rotating the file first if the line would not fit.
+     */
+    void appendTextLine(const std::string& text) {
+        if (!logFile.isOpen()) return;
+
+        if (logFile.needsRotation(fileBatch.size() + text.size() + 1)) {
+            logFile.write(fileBatch);
+            fileBatch.clear();
+            logFile.rotate();
+        }
+        fileBatch += text;
+        fileBatch += '\n';
+    }
+
+    void writeFileBatch(bool flushStream) {
+        if (!logFile.isOpen()) return;
+
+        logFile.write(fileBatch);
+        fileBatch.clear();
+        if (flushStream) {
+            logFile.flush();
+        }
+    }
+
+    /**
+     * @brief Starts a new binary file: header first, and no sites defined yet.
+     */
+    void beginBinaryFile() {
+        binarySitesWritten.assign(binarySitesWritten.size(), false);
+        if (binaryFile.size() == 0) {
+            appendBinaryLogHeader(binaryBatch, clockBase);
+        }
+    }
+
+    /**
+     * @brief Appends a record to the binary batch, defining its site first if this file has not seen it.
+     */
+    void appendBinaryRecord(const LogRecord& record) {
+        if (!binaryFile.isOpen()) return;
+
+        if (binaryFile.needsRotation(binaryBatch.size() + usedRecordBytes(record))) {
+            binaryFile.write(binaryBatch);
+            binaryBatch.clear();
+            binaryFile.rotate();
+            beginBinaryFile();
+        }
+
+        if (record.siteId >= binarySitesWritten.size()) {
+            binarySitesWritten.resize(record.siteId + 1, false);
+        }
+        if (!binarySitesWritten[record.siteId]) {
+            const LogSiteRegistry::Entry* site = LogSiteRegistry::get().find(record.siteId);
+            if (site) {
+                appendBinaryLogSite(binaryBatch, record.siteId, site->level, site->line, site->file, site->format);
+            }
+            binarySitesWritten[record.siteId] = true;
+        }
+        appendBinaryLogEntry(binaryBatch, record.siteId, static_cast<LogLevel>(record.level), record.tick,
+                             record.args, record.argBytes);
+    }
+
+    void writeBinaryBatch(bool flushStream) {
+        if (!binaryFile.isOpen()) return;
+
+        binaryFile.write(binaryBatch);
+        binaryBatch.clear();
+        if (flushStream) {
+            binaryFile.flush();
+        }
+    }
+
+    void logToConsole(const LogRecord& record) {
         std::lock_guard<std::mutex> lock(logMutex);
-        
-        std::string timestamp = getTimestamp();
-        std::string levelStr = getLevelString(level);
-        
-        logFile << "[" + timestamp + "] [" + levelStr + "] " + message << std::endl;
-        logFile.flush();
+
+        line.clear();
+        formatLine(line, record);
+        emitConsole(line, static_cast<LogLevel>(record.level));
+        writeConsoleBatch(true);
     }
+
+    void logToFile(const LogRecord& record) {
+        if (!logFile.isOpen()) return;
+
+        std::lock_guard<std::mutex> lock(logMutex);
+
+        line.clear();
+        formatLine(line, record);
+        appendTextLine(line);
+        writeFileBatch(true);
+    }
+
+    /**
+     * @brief Sends a batch of records to every sink. Holds logMutex so the direct
+     * logToConsole/logToFile entry points can still be used while the writer is running.
+     */
+    void writeRecords(const LogRecord* records, std::size_t count, bool flushStreams) {
+        POLARIS_PROFILE_SCOPE("Logger::writeRecords");
+        std::lock_guard<std::mutex> lock(logMutex);
+
+        for (std::size_t i = 0; i < count; ++i) {
+            const LogRecord& record = records[i];
+            line.clear();
+            formatLine(line, record);
+            if (config.console) {
+                emitConsole(line, static_cast<LogLevel>(record.level));
+            }
+            appendTextLine(line);
+            appendBinaryRecord(record);
+        }
+
+        writeConsoleBatch(flushStreams);
+        writeFileBatch(flushStreams);
+        writeBinaryBatch(flushStreams);
+    }
+
+    /**
+     * @brief Asynchronous path: copies the record into the ring buffer, applying the overflow policy.
+     */
+    void enqueue(const LogRecord& record) {
+        if (!accepting.load(std::memory_order_acquire)) {
+            droppedCount.fetch_add(1, std::memory_order_relaxed);
+            return;
+        }
+
+        while (!queue->tryEnqueue(record)) {
+            switch (config.overflowPolicy) {
+                case LogOverflowPolicy::Drop:
+                    droppedCount.fetch_add(1, std::memory_order_relaxed);
+                    return;
+                case LogOverflowPolicy::Overwrite:
+                    if (queue->tryDequeue(nullptr)) {
+                        overwrittenCount.fetch_add(1, std::memory_order_relaxed);
+                        writtenCount.fetch_add(1, std::memory_order_relaxed);
+                    }
+                    break;
+                case LogOverflowPolicy::Block: {
+                    // The writer signals after each batch it takes; the timeout only bounds a
+                    // wake-up lost between its check of blockedProducers and our wait
+                    std::unique_lock<std::mutex> lock(writerMutex);
+                    blockedProducers.fetch_add(1);
+                    writerWake.notify_one();
+                    spaceAvailable.wait_for(lock, std::chrono::milliseconds(10), [this] {
+                        return stopRequested || queue->sizeApprox() < queue->capacity();
+                    });
+                    blockedProducers.fetch_sub(1);
+                    break;
+                }
+            }
+        }
+
+        enqueuedCount.fetch_add(1, std::memory_order_release);
+
+        // The writer also wakes on its flush interval, so only nudge it when the buffer is
+        // filling up or the record is severe enough that it should reach disk promptly.
+        if (record.level >= static_cast<std::uint8_t>(LogLevel::ERROR_LOG) ||
+            queue->sizeApprox() >= queue->capacity() / 2) {
+            writerWake.notify_one();
+        }
+    }
+
+    void startWriter() {
+        queue = std::make_unique<LogRingBuffer>(config.queueCapacity);
+        consoleBatch.reserve(kWriterBatchSize * kMaxLineLength);
+        fileBatch.reserve(kWriterBatchSize * kMaxLineLength);
+        binaryBatch.reserve(kWriterBatchSize * sizeof(LogRecord));
+        accepting.store(true, std::memory_order_release);
+        writerThread = std::thread(&Impl::writerLoop, this);
+    }
+
+    /**
+     * @brief Stops accepting records, lets the writer drain everything queued so far, and joins it.
+     */
+    void stopWriter() {
+        if (!writerThread.joinable()) return;
+
+        accepting.store(false, std::memory_order_release);
+        {
+            std::lock_guard<std::mutex> lock(writerMutex);
+            stopRequested = true;
+        }
+        writerWake.notify_one();
+        writerThread.join();
+    }
+
+    void flushAsync() {
+        const std::uint64_t target = enqueuedCount.load(std::memory_order_acquire);
+        flushRequested.store(true, std::memory_order_release);
+        std::unique_lock<std::mutex> lock(writerMutex);
+        writerWake.notify_one();
+        writerProgress.wait(lock, [&] {
+            return stopRequested || writtenCount.load(std::memory_order_acquire) >= target;
+        });
+    }
+
+    void writerLoop() {
+        POLARIS_PROFILE_THREAD("LogWriter");
+        POLARIS_MEMORY_THREAD_TAG(Logger);
+        std::unique_ptr<LogRecord[]> batch(new LogRecord[kWriterBatchSize]);
+        auto lastFlush = std::chrono::steady_clock::now();
+        // Records written since the last flush, not yet counted in writtenCount
+        std::uint64_t unflushed = 0;
+
+        for (;;) {
+            std::size_t count = 0;
+            while (count < kWriterBatchSize && queue->tryDequeue(&batch[count])) {
+                ++count;
+            }
+            if (count > 0 && blockedProducers.load() > 0) {
+                {
+                    std::lock_guard<std::mutex> lock(writerMutex);
+                }
+                spaceAvailable.notify_all();
+            }
+
+            auto now = std::chrono::steady_clock::now();
+            const bool flushDue = count == 0 || now - lastFlush >= config.flushInterval ||
+                                  flushRequested.exchange(false, std::memory_order_acq_rel);
+            writeRecords(batch.get(), count, flushDue);
+            unflushed += count;
+            if (flushDue) {
+                lastFlush = now;
+                if (unflushed > 0) {
+                    writtenCount.fetch_add(unflushed, std::memory_order_release);
+                    unflushed = 0;
+                    {
+                        std::lock_guard<std::mutex> lock(writerMutex);
+                    }
+                    writerProgress.notify_all();
+                }
+            }
+
+            if (count > 0) {
+                continue;
+            }
+
+            std::unique_lock<std::mutex> lock(writerMutex);
+            if (stopRequested) {
+                // accepting is already false, so nothing new can be published; one more pass
+                // catches records whose producers were mid-enqueue when we saw the buffer empty.
+                lock.unlock();
+                do {
+                    count = 0;
+                    while (count < kWriterBatchSize && queue->tryDequeue(&batch[count])) {
+                        ++count;
+                    }
+                    writeRecords(batch.get(), count, true);
+                    writtenCount.fetch_add(count, std::memory_order_release);
+                } while (count > 0);
+                writerProgress.notify_all();
+                spaceAvailable.notify_all();
+                return;
+            }
+            writerWake.wait_for(lock, config.flushInterval);
+        }
+    }
+};
+
+namespace {
+
+/**
+ * @brief Builds a verbatim record (site kVerbatimSiteId) carrying message as its only argument.
+ */
+void makeVerbatimRecord(LogRecord& record, LogLevel level, const char* message, std::size_t length) {
+    const LogArg arg = makeLogArg(std::string_view(message, length));
+    record.tick = currentTick();
+    record.siteId = kVerbatimSiteId;
+    record.level = static_cast<std::uint8_t>(level);
+    record.reserved = 0;
+    record.argBytes = static_cast<std::uint16_t>(encodeLogArgs(record.args, sizeof(record.args), &arg, 1));
+}
+
+} // namespace
+
+/**
+ * @brief Marks a call that uses m_impl. isActive() is false once shutdown has begun; otherwise
+ * shutdown waits for the scope to end before destroying m_impl.
+ */
+class Logger::ProducerScope {
+public:
+    explicit ProducerScope(const Logger& logger) : m_logger(logger) {
+        // Both sides are sequentially consistent: either this sees m_initialized cleared, or
+        // shutdown sees this producer counted.
+        m_logger.m_activeProducers.fetch_add(1);
+        m_active = m_logger.m_initialized.load();
+    }
+    ~ProducerScope() { m_logger.m_activeProducers.fetch_sub(1, std::memory_order_release); }
+
+    ProducerScope(const ProducerScope&) = delete;
+    ProducerScope& operator=(const ProducerScope&) = delete;
+
+    bool isActive() const { return m_active; }
+
+private:
+    const Logger& m_logger;
+    bool m_active = false;
 };
 
 Logger& Logger::getInstance() {
@@ -146,93 +857,202 @@ Logger& Logger::getInstance() {
     return instance;
 }
 
-void Logger::initialize(const std::string& logFile) {
+Logger::~Logger() {
+    shutdown();
+}
+
+void Logger::initialize(const std::string& logFile, const LoggerConfig& config) {
     if (m_initialized) return;
-    
+
+    POLARIS_MEMORY_SCOPE(Logger);
     m_impl = std::make_unique<Impl>();
-    
+    m_impl->config = config;
+    m_impl->currentLevel = m_currentLevel;
+
     // Open log file
-    m_impl->logFile.open(logFile, std::ios::app);
-    if (!m_impl->logFile.is_open()) {
+    if (!logFile.empty() && !m_impl->logFile.open(logFile, config.rotation, false, false)) {
         std::cerr << "Failed to open log file: " << logFile << std::endl;
     }
-    
-    m_initialized = true;
+
+    // Each session starts a fresh binary file, so a file never holds two headers.
+    if (!config.binaryLogFile.empty()) {
+        if (m_impl->binaryFile.open(config.binaryLogFile, config.rotation, true, true)) {
+            m_impl->beginBinaryFile();
+        } else {
+            std::cerr << "Failed to open binary log file: " << config.binaryLogFile << std::endl;
+        }
+    }
+
+    if (config.async) {
+        m_impl->startWriter();
+    }
+
+    m_initialized.store(true);
     info("Logger initialized");
 }
 
 void Logger::shutdown() {
-    if (!m_initialized) return;
-    
+    if (!m_initialized.load()) return;
+
     info("Logger shutting down");
-    
-    if (m_impl->logFile.is_open()) {
-        m_impl->logFile.close();
+    if (!m_initialized.exchange(false)) return;
+
+    // New calls now return early; wait for those already using m_impl.
+    while (m_activeProducers.load(std::memory_order_acquire) != 0) {
+        std::this_thread::yield();
+    }
+
+    // Drains every record queued before this point before the files are closed.
+    m_impl->stopWriter();
+
+    {
+        std::lock_guard<std::mutex> lock(m_impl->logMutex);
+        m_impl->writeFileBatch(true);
+        m_impl->writeBinaryBatch(true);
     }
-    
+    m_impl->logFile.close();
+    m_impl->binaryFile.close();
+
     m_impl.reset();
-    m_initialized = false;
 }
 
 void Logger::setLogLevel(LogLevel level) {
-    if (m_impl) {
+    ProducerScope scope(*this);
+    if (scope.isActive()) {
         m_impl->currentLevel = level;
     }
     m_currentLevel = level;
 }
 
+void Logger::flush() {
+    ProducerScope scope(*this);
+    if (!scope.isActive()) return;
+
+    if (m_impl->writerThread.joinable()) {
+        m_impl->flushAsync();
+    } else {
+        std::lock_guard<std::mutex> lock(m_impl->logMutex);
+        m_impl->writeConsoleBatch(true);
+        m_impl->writeFileBatch(true);
+        m_impl->writeBinaryBatch(true);
+    }
+}
+
+std::uint64_t Logger::getDroppedCount() const {
+    ProducerScope scope(*this);
+    return scope.isActive() ? m_impl->droppedCount.load(std::memory_order_relaxed) : 0;
+}
+
+std::uint64_t Logger::getOverwrittenCount() const {
+    ProducerScope scope(*this);
+    return scope.isActive() ? m_impl->overwrittenCount.load(std::memory_order_relaxed) : 0;
+}
+
+std::uint32_t Logger::registerSite(LogSite& site, LogLevel level, const char* format) {
+    POLARIS_MEMORY_SCOPE(Logger);
+    LogSiteRegistry& registry = LogSiteRegistry::get();
+    std::lock_guard<std::mutex> lock(registry.siteMutex());
+
+    // Another thread may have registered this site while we waited for the lock.
+    std::uint32_t id = site.id.load(std::memory_order_acquire);
+    if (id == 0) {
+        id = registry.add(format, site.file, site.line, level);
+        site.id.store(id, std::memory_order_release);
+    }
+    return id;
+}
+
+void Logger::logEncoded(LogLevel level, std::uint32_t siteId, const LogArg* args, std::size_t argCount) {
+    ProducerScope scope(*this);
+    if (!scope.isActive()) return;
+
+    LogRecord record;
+    record.tick = currentTick();
+    record.siteId = siteId;
+    record.level = static_cast<std::uint8_t>(level);
+    record.reserved = 0;
+    record.argBytes = static_cast<std::uint16_t>(encodeLogArgs(record.args, sizeof(record.args), args, argCount));
+
+    if (m_impl->queue) {
+        m_impl->enqueue(record);
+    } else {
+        m_impl->writeRecords(&record, 1, true);
+    }
+}
+
+void Logger::log(LogLevel level, const char* message, std::size_t length) {
+    ProducerScope scope(*this);
+    if (!scope.isActive()) return;
+
+    LogRecord record;
+    makeVerbatimRecord(record, level, message, length);
+
+    if (m_impl->queue) {
+        m_impl->enqueue(record);
+    } else {
+        m_impl->writeRecords(&record, 1, true);
+    }
+}
+
+void Logger::logFormatted(LogLevel level, const char* format, const LogArg* args, std::size_t argCount) {
+    // Large enough for any message the sinks will print.
+    thread_local char formatBuffer[kMaxMessageLength];
+    std::size_t length = formatLogMessage(formatBuffer, sizeof(formatBuffer), format, args, argCount);
+    log(level, formatBuffer, length);
+}
+
 void Logger::trace(const std::string& message) {
-    if (m_currentLevel <= LogLevel::TRACE && m_impl) {
-        m_impl->logToConsole(message, LogLevel::TRACE);
-        m_impl->logToFile(message, LogLevel::TRACE);
+    if (m_currentLevel <= LogLevel::TRACE) {
+        log(LogLevel::TRACE, message.data(), message.size());
     }
 }
 
 void Logger::debug(const std::string& message) {
-    if (m_currentLevel <= LogLevel::DEBUG_LEVEL && m_impl) {
-        m_impl->logToConsole(message, LogLevel::DEBUG_LEVEL);
-        m_impl->logToFile(message, LogLevel::DEBUG_LEVEL);
+    if (m_currentLevel <= LogLevel::DEBUG_LEVEL) {
+        log(LogLevel::DEBUG_LEVEL, message.data(), message.size());
     }
 }
 
 void Logger::info(const std::string& message) {
-    if (m_currentLevel <= LogLevel::INFO && m_impl) {
-        m_impl->logToConsole(message, LogLevel::INFO);
-        m_impl->logToFile(message, LogLevel::INFO);
+    if (m_currentLevel <= LogLevel::INFO) {
+        log(LogLevel::INFO, message.data(), message.size());
     }
 }
 
 void Logger::warn(const std::string& message) {
-    if (m_currentLevel <= LogLevel::WARN && m_impl) {
-        m_impl->logToConsole(message, LogLevel::WARN);
-        m_impl->logToFile(message, LogLevel::WARN);
+    if (m_currentLevel <= LogLevel::WARN) {
+        log(LogLevel::WARN, message.data(), message.size());
     }
 }
 
 void Logger::error(const std::string& message) {
-    if (m_currentLevel <= LogLevel::ERROR_LOG && m_impl) {
-        m_impl->logToConsole(message, LogLevel::ERROR_LOG);
-        m_impl->logToFile(message, LogLevel::ERROR_LOG);
+    if (m_currentLevel <= LogLevel::ERROR_LOG) {
+        log(LogLevel::ERROR_LOG, message.data(), message.size());
     }
 }
 
 void Logger::critical(const std::string& message) {
-    if (m_currentLevel <= LogLevel::CRITICAL && m_impl) {
-        m_impl->logToConsole(message, LogLevel::CRITICAL);
-        m_impl->logToFile(message, LogLevel::CRITICAL);
+    if (m_currentLevel <= LogLevel::CRITICAL) {
+        log(LogLevel::CRITICAL, message.data(), message.size());
     }
 }
 
 void Logger::logToConsole(const std::string& message, LogLevel level) {
-    if (m_impl) {
-        m_impl->logToConsole(message, level);
+    ProducerScope scope(*this);
+    if (scope.isActive()) {
+        LogRecord record;
+        makeVerbatimRecord(record, level, message.data(), message.size());
+        m_impl->logToConsole(record);
     }
 }
 
 void Logger::logToFile(const std::string& message, LogLevel level) {
-    if (m_impl) {
-        m_impl->logToFile(message, level);
+    ProducerScope scope(*this);
+    if (scope.isActive()) {
+        LogRecord record;
+        makeVerbatimRecord(record, level, message.data(), message.size());
+        m_impl->logToFile(record);
     }
 }
 
-} // namespace polaris 
\ No newline at end of file
+} // namespace polaris
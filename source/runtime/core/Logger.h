@@ -1,29 +1,191 @@
 #ifndef POLARIS_LOGGER_H
 #define POLARIS_LOGGER_H
 
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
 #include <memory>
 #include <string>
+#include "LogFormat.h"
+
+/**
+ * @brief Lowest level compiled into LOG_* macros (0 = TRACE ... 5 = CRITICAL).
+ * Calls below this level expand to nothing, so their arguments are never evaluated.
+ */
+#ifndef POLARIS_LOG_MIN_LEVEL
+#define POLARIS_LOG_MIN_LEVEL 0
+#endif
 
 namespace polaris {
 
-enum class LogLevel {
-    TRACE = 0,
-    DEBUG_LEVEL = 1,  // Renamed from DEBUG to avoid macro conflicts
-    INFO = 2,
-    WARN = 3,
-    ERROR_LOG = 4,
-    CRITICAL = 5
+/**
+ * @brief What an asynchronous logger does when its ring buffer is full.
+ */
+enum class LogOverflowPolicy {
+    Block,     ///< The producer waits until the writer thread frees a slot.
+    Drop,      ///< The new record is discarded and the dropped counter is incremented.
+    Overwrite  ///< The oldest queued record is discarded to make room for the new one.
+};
+
+/**
+ * @brief When the text and binary log files are rotated.
+ *
+ * On rotation "vega42.log" becomes "vega42.1.log", an existing "vega42.1.log" becomes
+ * "vega42.2.log", and so on; the oldest file beyond maxFiles is deleted.
+ */
+struct LogRotationConfig {
+    /**
+     * @brief Rotate once the active file would exceed this size. 0 disables size-based rotation.
+     */
+    std::uint64_t maxFileBytes = 16 * 1024 * 1024;
+    /**
+     * @brief Rotate once the active file has been open this long. 0 disables time-based rotation.
+     */
+    std::chrono::minutes maxFileAge{0};
+    /**
+     * @brief Number of rotated files kept next to the active one.
+     */
+    unsigned maxFiles = 5;
+};
+
+/**
+ * @brief Configuration passed to Logger::initialize.
+ */
+struct LoggerConfig {
+    /**
+     * @brief When true, records are queued and written by a dedicated writer thread.
+     * When false, every call formats and writes on the calling thread.
+     */
+    bool async = true;
+    /**
+     * @brief Number of records the ring buffer can hold. Rounded up to a power of two.
+     */
+    std::size_t queueCapacity = 2048;
+    /**
+     * @brief Behaviour when the ring buffer is full.
+     */
+    LogOverflowPolicy overflowPolicy = LogOverflowPolicy::Block;
+    /**
+     * @brief How often the writer thread flushes the console and the log file.
+     */
+    std::chrono::milliseconds flushInterval{100};
+    /**
+     * @brief Path of the binary (.plog) log file, or empty to disable the binary sink.
+     * Binary files store format-string ids and raw arguments; decode them with polaris-logdecode.
+     */
+    std::string binaryLogFile;
+    /**
+     * @brief When false, records are only written to the log files, leaving stdout to the
+     * application (e.g. for tools that print machine-readable output).
+     */
+    bool console = true;
+    /**
+     * @brief Rotation policy applied to both the text and the binary log file.
+     */
+    LogRotationConfig rotation;
+};
+
+/**
+ * @brief Static per-call-site data created by the LOG_* macros.
+ *
+ * The format string used at a call site must be the same on every call. It is registered
+ * on first use and the binary log stores the resulting id instead of the string.
+ */
+struct LogSite {
+    const char* file;
+    std::uint32_t line;
+    std::atomic<std::uint32_t> id{0};
 };
 
 class Logger {
 public:
     static Logger& getInstance();
-    
-    void initialize(const std::string& logFile = "vega42.log");
+
+    /**
+     * @brief Opens the log files and, in async mode, starts the writer thread.
+     * @param logFile Path of the text log file, or empty to disable it.
+     * @param config Queueing, binary sink and rotation settings.
+     */
+    void initialize(const std::string& logFile = "vega42.log", const LoggerConfig& config = LoggerConfig());
+
+    /**
+     * @brief Drains the queue and closes the files. The engine never calls it: whoever called
+     * initialize() owns the logger and shuts it down once nothing else will log, e.g. at the
+     * end of main(); otherwise the singleton's destructor does at exit.
+     */
     void shutdown();
-    
+
     void setLogLevel(LogLevel level);
-    
+
+    /**
+     * @brief Returns true if a record at the given level would be written.
+     * The LOG_* macros call this before evaluating their arguments.
+     */
+    bool isEnabled(LogLevel level) const {
+        return m_initialized.load(std::memory_order_relaxed) && level >= m_currentLevel;
+    }
+
+    /**
+     * @brief Formats a "{}"-style message and logs it at the given level.
+     * Formatting happens into a thread-local buffer, so no heap allocation is made.
+     * See formatLogMessage for the supported placeholder syntax.
+     */
+    template <typename... Args>
+    void logf(LogLevel level, const char* format, const Args&... args) {
+        if (!isEnabled(level)) return;
+        const LogArg logArgs[sizeof...(Args) + 1] = {makeLogArg(args)...};
+        logFormatted(level, format, logArgs, sizeof...(Args));
+    }
+
+    /**
+     * @brief Logs a pre-built message verbatim at the given level.
+     */
+    void logf(LogLevel level, const std::string& message) {
+        if (!isEnabled(level)) return;
+        log(level, message.data(), message.size());
+    }
+
+    /**
+     * @brief Call-site variant used by the LOG_* macros.
+     * Only the site id and the raw argument bytes are captured on the calling thread;
+     * the text is formatted later by whichever sink needs it.
+     */
+    template <typename... Args>
+    void logf(LogSite& site, LogLevel level, const char* format, const Args&... args) {
+        if (!isEnabled(level)) return;
+        const LogArg logArgs[sizeof...(Args) + 1] = {makeLogArg(args)...};
+        std::uint32_t siteId = site.id.load(std::memory_order_acquire);
+        if (siteId == 0) {
+            siteId = registerSite(site, level, format);
+        }
+        logEncoded(level, siteId, logArgs, sizeof...(Args));
+    }
+
+    /**
+     * @brief Call-site variant for pre-built messages, e.g. LOG_INFO(someString).
+     */
+    void logf(LogSite& site, LogLevel level, const std::string& message) {
+        (void)site;
+        logf(level, message);
+    }
+
+    /**
+     * @brief Blocks until every record queued before this call has been written and flushed.
+     * Does nothing beyond flushing the file when the logger runs synchronously.
+     */
+    void flush();
+
+    /**
+     * @brief Number of records discarded by the Drop policy (or after shutdown began).
+     */
+    std::uint64_t getDroppedCount() const;
+
+    /**
+     * @brief Number of queued records discarded by the Overwrite policy.
+     */
+    std::uint64_t getOverwrittenCount() const;
+
     // Logging methods
     void trace(const std::string& message);
     void debug(const std::string& message);
@@ -31,36 +193,87 @@ public:
     void warn(const std::string& message);
     void error(const std::string& message);
     void critical(const std::string& message);
-    
+
     // Platform-specific methods
     void logToConsole(const std::string& message, LogLevel level);
     void logToFile(const std::string& message, LogLevel level);
-    
+
 private:
     Logger() = default;
-    ~Logger() = default;
+    ~Logger();
     Logger(const Logger&) = delete;
     Logger& operator=(const Logger&) = delete;
-    
+
+    void log(LogLevel level, const char* message, std::size_t length);
+    void logFormatted(LogLevel level, const char* format, const LogArg* args, std::size_t argCount);
+    void logEncoded(LogLevel level, std::uint32_t siteId, const LogArg* args, std::size_t argCount);
+    static std::uint32_t registerSite(LogSite& site, LogLevel level, const char* format);
+
     class Impl;
+    class ProducerScope;
     std::unique_ptr<Impl> m_impl;
-    
-    bool m_initialized = false;
+
+    /**
+     * @brief Cleared by shutdown() before it waits for m_activeProducers to reach zero and
+     * destroys m_impl, so a call racing with shutdown either sees it cleared or is waited for.
+     */
+    std::atomic<bool> m_initialized{false};
+    mutable std::atomic<std::uint32_t> m_activeProducers{0};
     LogLevel m_currentLevel = LogLevel::INFO;
 };
 
 // Convenience macros
-#define LOG_TRACE(msg) polaris::Logger::getInstance().trace(msg)
-#define LOG_DEBUG(msg) polaris::Logger::getInstance().debug(msg)
-#define LOG_INFO(msg) polaris::Logger::getInstance().info(msg)
-#define LOG_WARN(msg) polaris::Logger::getInstance().warn(msg)
-#define LOG_ERROR(msg) polaris::Logger::getInstance().error(msg)
-#define LOG_CRITICAL(msg) polaris::Logger::getInstance().critical(msg)
+//
+// Usage: LOG_INFO("Window resized to {}x{}", width, height);
+// The level is checked before any argument is evaluated, and levels below
+// POLARIS_LOG_MIN_LEVEL are compiled out entirely.
+#define POLARIS_LOG_AT(level, ...) \
+    do { \
+        polaris::Logger& polarisLogger = polaris::Logger::getInstance(); \
+        if (polarisLogger.isEnabled(level)) { \
+            static polaris::LogSite polarisLogSite{__FILE__, __LINE__}; \
+            polarisLogger.logf(polarisLogSite, level, __VA_ARGS__); \
+        } \
+    } while (0)
+
+#define POLARIS_LOG_DISABLED(...) do { } while (0)
+
+#if POLARIS_LOG_MIN_LEVEL <= 0
+#define LOG_TRACE(...) POLARIS_LOG_AT(polaris::LogLevel::TRACE, __VA_ARGS__)
+#else
+#define LOG_TRACE(...) POLARIS_LOG_DISABLED(__VA_ARGS__)
+#endif
+
+#if POLARIS_LOG_MIN_LEVEL <= 1
+#define LOG_DEBUG(...) POLARIS_LOG_AT(polaris::LogLevel::DEBUG_LEVEL, __VA_ARGS__)
+#else
+#define LOG_DEBUG(...) POLARIS_LOG_DISABLED(__VA_ARGS__)
+#endif
+
+#if POLARIS_LOG_MIN_LEVEL <= 2
+#define LOG_INFO(...) POLARIS_LOG_AT(polaris::LogLevel::INFO, __VA_ARGS__)
+#else
+#define LOG_INFO(...) POLARIS_LOG_DISABLED(__VA_ARGS__)
+#endif
+
+#if POLARIS_LOG_MIN_LEVEL <= 3
+#define LOG_WARN(...) POLARIS_LOG_AT(polaris::LogLevel::WARN, __VA_ARGS__)
+#else
+#define LOG_WARN(...) POLARIS_LOG_DISABLED(__VA_ARGS__)
+#endif
+
+#if POLARIS_LOG_MIN_LEVEL <= 4
+#define LOG_ERROR(...) POLARIS_LOG_AT(polaris::LogLevel::ERROR_LOG, __VA_ARGS__)
+#else
+#define LOG_ERROR(...) POLARIS_LOG_DISABLED(__VA_ARGS__)
+#endif
+
+#define LOG_CRITICAL(...) POLARIS_LOG_AT(polaris::LogLevel::CRITICAL, __VA_ARGS__)
 
 // Conditional logging
-#define LOG_DEBUG_IF(condition, msg) if(condition) LOG_DEBUG(msg)
-#define LOG_INFO_IF(condition, msg) if(condition) LOG_INFO(msg)
+#define LOG_DEBUG_IF(condition, ...) do { if (condition) { LOG_DEBUG(__VA_ARGS__); } } while (0)
+#define LOG_INFO_IF(condition, ...) do { if (condition) { LOG_INFO(__VA_ARGS__); } } while (0)
 
 } // namespace polaris
 
-#endif // POLARIS_LOGGER_H 
\ No newline at end of file
+#endif // POLARIS_LOGGER_H
@@ -0,0 +1,275 @@
+#include "assets/AssetPack.h"
+
+#include "Logger.h"
+#include "assets/Lz4Block.h"
+#include "profiling/Profiler.h"
+#include <algorithm>
+#include <cstring>
+
+#if defined(_WIN32)
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace polaris {
+
+namespace {
+
+// An LZ4 block never expands by more than this (one length byte encodes at most 255 bytes),
+// which bounds what a corrupt index can make read() allocate
+constexpr std::uint64_t kLz4MaxExpansion = 255;
+
+/**
+ * @brief Maps a whole file read-only. The file handle is closed again; the mapping keeps the
+ * file open until it is unmapped.
+ */
+const std::uint8_t* mapFile(const std::string& path, std::size_t& size) {
+#if defined(_WIN32)
+    HANDLE file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING,
+                              FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (file == INVALID_HANDLE_VALUE) {
+        return nullptr;
+    }
+    LARGE_INTEGER fileSize;
+    const void* view = nullptr;
+    if (GetFileSizeEx(file, &fileSize) && fileSize.QuadPart > 0) {
+        HANDLE mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+        if (mapping) {
+            view = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+            CloseHandle(mapping);
+        }
+        size = static_cast<std::size_t>(fileSize.QuadPart);
+    }
+    CloseHandle(file);
+    return static_cast<const std::uint8_t*>(view);
+#else
+    const int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0) {
+        return nullptr;
+    }
+    struct stat info;
+    void* view = MAP_FAILED;
+    if (fstat(fd, &info) == 0 && info.st_size > 0) {
+        size = static_cast<std::size_t>(info.st_size);
+        view = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+    }
+    ::close(fd);
+    return view == MAP_FAILED ? nullptr : static_cast<const std::uint8_t*>(view);
+#endif
+}
+
+void unmapFile(const std::uint8_t* base, std::size_t size) {
+#if defined(_WIN32)
+    (void)size;
+    UnmapViewOfFile(base);
+#else
+    munmap(const_cast<std::uint8_t*>(base), size);
+#endif
+}
+
+} // namespace
+
+AssetPack::~AssetPack() {
+    close();
+}
+
+bool AssetPack::open(const std::string& path) {
+    POLARIS_PROFILE_SCOPE("AssetPack::open");
+    close();
+    std::size_t size = 0;
+    const std::uint8_t* base = mapFile(path, size);
+    if (!base) {
+        LOG_ERROR("Failed to map asset pack {}", path);
+        return false;
+    }
+    m_path = path;
+    m_base = base;
+    m_size = size;
+    if (!validate()) {
+        LOG_ERROR("{} is not a valid asset pack", path);
+        close();
+        return false;
+    }
+    LOG_INFO("Opened asset pack {}: {} assets, {} bytes", path, m_entryCount, m_size);
+    return true;
+}
+
+void AssetPack::close() {
+    if (m_base) {
+        unmapFile(m_base, m_size);
+    }
+    m_path.clear();
+    m_base = nullptr;
+    m_size = 0;
+    m_entries = nullptr;
+    m_entryCount = 0;
+    m_names = nullptr;
+}
+
+/**
+ * @brief Checks the header and every index entry against the file size, so that lookups and
+ * reads can trust the index afterwards.
+ */
+bool AssetPack::validate() {
+    if (m_size < sizeof(PackHeader)) {
+        return false;
+    }
+    const PackHeader& header = *reinterpret_cast<const PackHeader*>(m_base);
+    if (std::memcmp(header.magic, kPackMagic, sizeof(header.magic)) != 0 || header.version != kPackVersion ||
+        header.fileSize != m_size) {
+        return false;
+    }
+    if (header.entryCount > (m_size - sizeof(PackHeader)) / sizeof(PackEntry) ||
+        header.namesOffset != sizeof(PackHeader) + header.entryCount * sizeof(PackEntry) ||
+        header.namesSize > m_size - header.namesOffset || header.dataOffset > m_size) {
+        return false;
+    }
+
+    const PackEntry* entries = reinterpret_cast<const PackEntry*>(m_base + sizeof(PackHeader));
+    for (std::uint32_t i = 0; i < header.entryCount; ++i) {
+        const PackEntry& entry = entries[i];
+        const bool stored = entry.compression == static_cast<std::uint8_t>(PackCompression::None);
+        const bool compressed = entry.compression == static_cast<std::uint8_t>(PackCompression::Lz4);
+        if (entry.offset < header.dataOffset || entry.offset > m_size || entry.storedSize > m_size - entry.offset ||
+            entry.nameOffset > header.namesSize || entry.nameLength > header.namesSize - entry.nameOffset ||
+            !(stored || compressed) || (stored && entry.storedSize != entry.size) ||
+            (compressed && entry.size / kLz4MaxExpansion > entry.storedSize) ||
+            (i > 0 && entries[i - 1].nameHash >= entry.nameHash)) {
+            return false;
+        }
+    }
+
+    m_entries = entries;
+    m_entryCount = header.entryCount;
+    m_names = reinterpret_cast<const char*>(m_base + header.namesOffset);
+    return true;
+}
+
+const PackEntry* AssetPack::findEntry(std::string_view name) const {
+    const std::uint64_t hash = hashPackName(name);
+    const PackEntry* end = m_entries + m_entryCount;
+    const PackEntry* entry = std::lower_bound(m_entries, end, hash, [](const PackEntry& candidate, std::uint64_t value) {
+        return candidate.nameHash < value;
+    });
+    if (entry == end || entry->nameHash != hash ||
+        std::string_view(m_names + entry->nameOffset, entry->nameLength) != name) {
+        return nullptr;
+    }
+    return entry;
+}
+
+bool AssetPack::stat(std::string_view name, AssetInfo& info) const {
+    const PackEntry* entry = findEntry(name);
+    if (!entry) {
+        return false;
+    }
+    info.size = entry->size;
+    info.storedSize = entry->storedSize;
+    info.compressed = entry->compression != static_cast<std::uint8_t>(PackCompression::None);
+    return true;
+}
+
+AssetData AssetPack::view(std::string_view name) const {
+    const PackEntry* entry = findEntry(name);
+    if (!entry || entry->compression != static_cast<std::uint8_t>(PackCompression::None)) {
+        return AssetData();
+    }
+    return AssetData{m_base + entry->offset, static_cast<std::size_t>(entry->size)};
+}
+
+bool AssetPack::read(std::string_view name, std::vector<std::uint8_t>& out) const {
+    const PackEntry* entry = findEntry(name);
+    if (!entry) {
+        return false;
+    }
+    const std::uint8_t* stored = m_base + entry->offset;
+    out.resize(static_cast<std::size_t>(entry->size));
+    if (entry->compression == static_cast<std::uint8_t>(PackCompression::None)) {
+        if (!out.empty()) {
+            std::memcpy(out.data(), stored, out.size());
+        }
+        return true;
+    }
+
+    POLARIS_PROFILE_SCOPE("AssetPack::decompress");
+    if (!lz4Decompress(stored, static_cast<std::size_t>(entry->storedSize), out.data(), out.size())) {
+        LOG_ERROR("Corrupt asset {} in {}", name, m_path);
+        out.clear();
+        return false;
+    }
+    return true;
+}
+
+void AssetPack::prefetch(const std::vector<std::string>& names) const {
+    std::vector<std::pair<std::uint64_t, std::uint64_t>> ranges;
+    ranges.reserve(names.size());
+    for (const std::string& name : names) {
+        if (const PackEntry* entry = findEntry(name)) {
+            ranges.emplace_back(entry->offset, entry->storedSize);
+        }
+    }
+    adviseWillNeed(ranges);
+}
+
+void AssetPack::prefetchAll() const {
+    std::vector<std::pair<std::uint64_t, std::uint64_t>> ranges;
+    if (m_base) {
+        ranges.emplace_back(0, m_size);
+    }
+    adviseWillNeed(ranges);
+}
+
+std::string_view AssetPack::getName(std::size_t index) const {
+    if (index >= m_entryCount) {
+        return std::string_view();
+    }
+    return std::string_view(m_names + m_entries[index].nameOffset, m_entries[index].nameLength);
+}
+
+void AssetPack::adviseWillNeed(std::vector<std::pair<std::uint64_t, std::uint64_t>>& ranges) const {
+    if (ranges.empty()) {
+        return;
+    }
+    // Page-align, then merge ranges that touch so the kernel sees few, large reads
+    for (auto& range : ranges) {
+        const std::uint64_t end = std::min<std::uint64_t>(range.first + range.second, m_size);
+        range.first &= ~(kPackPageSize - 1);
+        range.second = end - range.first;
+    }
+    std::sort(ranges.begin(), ranges.end());
+    std::size_t merged = 0;
+    for (std::size_t i = 1; i < ranges.size(); ++i) {
+        auto& last = ranges[merged];
+        if (ranges[i].first <= last.first + last.second) {
+            last.second = std::max(last.second, ranges[i].first + ranges[i].second - last.first);
+        } else {
+            ranges[++merged] = ranges[i];
+        }
+    }
+    ranges.resize(merged + 1);
+
+#if defined(_WIN32)
+    std::vector<WIN32_MEMORY_RANGE_ENTRY> entries;
+    entries.reserve(ranges.size());
+    for (const auto& range : ranges) {
+        entries.push_back({const_cast<std::uint8_t*>(m_base + range.first), static_cast<SIZE_T>(range.second)});
+    }
+    PrefetchVirtualMemory(GetCurrentProcess(), entries.size(), entries.data(), 0);
+#else
+    for (const auto& range : ranges) {
+        if (range.second > 0) {
+            madvise(const_cast<std::uint8_t*>(m_base + range.first), static_cast<std::size_t>(range.second),
+                    MADV_WILLNEED);
+        }
+    }
+#endif
+}
+
+} // namespace polaris
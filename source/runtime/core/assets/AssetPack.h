@@ -0,0 +1,125 @@
+#ifndef POLARIS_ASSETPACK_H
+#define POLARIS_ASSETPACK_H
+
+#include "assets/PackFormat.h"
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+namespace polaris {
+
+/**
+ * @brief Bytes of an asset inside a mapped pack; valid until the pack is closed.
+ */
+struct AssetData {
+    const std::uint8_t* data = nullptr;
+    std::size_t size = 0;
+
+    bool empty() const { return size == 0; }
+};
+
+struct AssetInfo {
+    std::uint64_t size = 0;         ///< Decompressed size.
+    std::uint64_t storedSize = 0;
+    bool compressed = false;
+};
+
+/**
+ * @brief Read-only access to a .ppak asset pack through one memory mapping.
+ *
+ * open() maps the whole file and checks the index; nothing else is read until it is used, so
+ * opening costs one open/mmap/close regardless of the number of assets, and each access
+ * costs at most the page faults of the bytes it touches. Lookups are a binary search of the
+ * mapped index by name hash. Uncompressed assets are served in place by view(), without a
+ * copy; read() also decompresses.
+ *
+ * prefetch() tells the OS which assets are about to be used (e.g. a level's list), so their
+ * pages are read ahead in large sequential I/O instead of faulting in one by one.
+ *
+ * Every const method is safe to call from any thread while the pack is open.
+ */
+class AssetPack {
+public:
+    AssetPack() = default;
+    ~AssetPack();
+
+    AssetPack(const AssetPack&) = delete;
+    AssetPack& operator=(const AssetPack&) = delete;
+
+    /**
+     * @brief Maps a pack, closing the current one.
+     * @return false if the file cannot be mapped or is not a valid .ppak.
+     */
+    bool open(const std::string& path);
+
+    /**
+     * @brief Unmaps the pack; every AssetData from it becomes invalid.
+     */
+    void close();
+
+    bool isOpen() const { return m_base != nullptr; }
+    const std::string& getPath() const { return m_path; }
+
+    bool contains(std::string_view name) const { return findEntry(name) != nullptr; }
+
+    /**
+     * @brief Size and storage of an asset.
+     * @return false if the pack has no such asset.
+     */
+    bool stat(std::string_view name, AssetInfo& info) const;
+
+    /**
+     * @brief Zero-copy view of an uncompressed asset.
+     * @return Empty if the asset is missing or compressed (use read()), or empty itself.
+     */
+    AssetData view(std::string_view name) const;
+
+    /**
+     * @brief Copies an asset into out, decompressing it if needed.
+     * @return false if the asset is missing or corrupt.
+     */
+    bool read(std::string_view name, std::vector<std::uint8_t>& out) const;
+
+    /**
+     * @brief Starts reading the given assets' pages in the background. Missing names are
+     * ignored. Returns immediately.
+     */
+    void prefetch(const std::vector<std::string>& names) const;
+
+    /**
+     * @brief Starts reading the whole pack in the background, e.g. at startup when most of it
+     * will be used.
+     */
+    void prefetchAll() const;
+
+    std::size_t getEntryCount() const { return m_entryCount; }
+
+    /**
+     * @brief Name of the entry at index, in name hash order; for listing the pack.
+     */
+    std::string_view getName(std::size_t index) const;
+
+private:
+    const PackEntry* findEntry(std::string_view name) const;
+    bool validate();
+
+    /**
+     * @brief Asks the OS to read the page-aligned ranges covering [offset, offset + size) of
+     * each range, merging neighbours into one request.
+     */
+    void adviseWillNeed(std::vector<std::pair<std::uint64_t, std::uint64_t>>& ranges) const;
+
+    std::string m_path;
+    const std::uint8_t* m_base = nullptr;
+    std::size_t m_size = 0;
+    const PackEntry* m_entries = nullptr;
+    std::size_t m_entryCount = 0;
+    const char* m_names = nullptr;
+};
+
+} // namespace polaris
+
+#endif // POLARIS_ASSETPACK_H
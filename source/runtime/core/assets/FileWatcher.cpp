@@ -0,0 +1,339 @@
+#include "assets/FileWatcher.h"
+
+#include "Logger.h"
+#include "memory/MemoryTracker.h"
+#include "profiling/Profiler.h"
+#include <algorithm>
+#include <cstdint>
+#include <filesystem>
+#include <map>
+#include <unordered_map>
+#include <utility>
+
+#if defined(__linux__)
+#include <poll.h>
+#include <sys/eventfd.h>
+#include <sys/inotify.h>
+#include <unistd.h>
+#define POLARIS_HAVE_INOTIFY 1
+#else
+#define POLARIS_HAVE_INOTIFY 0
+#endif
+
+namespace polaris {
+
+namespace {
+
+std::string joinPath(const std::string& directory, const std::string& name) {
+    return (std::filesystem::path(directory) / name).generic_string();
+}
+
+/**
+ * @brief Calls visit with every regular file under a directory; unreadable parts are skipped.
+ */
+template <typename Visit>
+void forEachFile(const std::string& directory, Visit&& visit) {
+    std::error_code ec;
+    std::filesystem::recursive_directory_iterator it(directory, std::filesystem::directory_options::skip_permission_denied, ec);
+    for (; !ec && it != std::filesystem::recursive_directory_iterator(); it.increment(ec)) {
+        if (it->is_regular_file(ec)) {
+            visit(it->path());
+        }
+    }
+}
+
+} // namespace
+
+FileWatcher::~FileWatcher() {
+    stop();
+}
+
+bool FileWatcher::start(const std::vector<std::string>& roots, const FileWatcherConfig& config) {
+    stop();
+    m_config = config;
+    m_roots.clear();
+    for (const std::string& root : roots) {
+        std::error_code ec;
+        if (std::filesystem::is_directory(root, ec)) {
+            m_roots.push_back(std::filesystem::path(root).generic_string());
+        } else {
+            LOG_WARN("Not watching {}: not a directory", root);
+        }
+    }
+    if (m_roots.empty()) {
+        return false;
+    }
+
+    m_stopping = false;
+#if POLARIS_HAVE_INOTIFY
+    m_watchFd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+    m_wakeFd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    if (m_watchFd < 0 || m_wakeFd < 0) {
+        LOG_ERROR("Failed to create inotify instance");
+        stop();
+        return false;
+    }
+    m_thread = std::thread(&FileWatcher::watchMain, this);
+#else
+    m_thread = std::thread(&FileWatcher::pollMain, this);
+#endif
+    return true;
+}
+
+bool FileWatcher::addRoot(const std::string& root) {
+    if (!isRunning()) {
+        return start({root}, m_config);
+    }
+    std::error_code ec;
+    if (!std::filesystem::is_directory(root, ec)) {
+        LOG_WARN("Not watching {}: not a directory", root);
+        return false;
+    }
+    {
+        std::lock_guard<std::mutex> lock(m_stopMutex);
+        m_addedRoots.push_back(std::filesystem::path(root).generic_string());
+        m_stopRequested.notify_all();
+    }
+#if POLARIS_HAVE_INOTIFY
+    const std::uint64_t one = 1;
+    [[maybe_unused]] const ssize_t written = write(m_wakeFd, &one, sizeof(one));
+#endif
+    return true;
+}
+
+std::vector<std::string> FileWatcher::takeAddedRoots() {
+    std::vector<std::string> added;
+    {
+        std::lock_guard<std::mutex> lock(m_stopMutex);
+        added.swap(m_addedRoots);
+    }
+    m_roots.insert(m_roots.end(), added.begin(), added.end());
+    return added;
+}
+
+void FileWatcher::stop() {
+    m_stopping = true;
+#if POLARIS_HAVE_INOTIFY
+    if (m_wakeFd >= 0) {
+        const std::uint64_t one = 1;
+        [[maybe_unused]] const ssize_t written = write(m_wakeFd, &one, sizeof(one));
+    }
+#endif
+    {
+        std::lock_guard<std::mutex> lock(m_stopMutex);
+        m_stopRequested.notify_all();
+    }
+    if (m_thread.joinable()) {
+        m_thread.join();
+    }
+#if POLARIS_HAVE_INOTIFY
+    if (m_watchFd >= 0) {
+        close(m_watchFd);
+        m_watchFd = -1;
+    }
+    if (m_wakeFd >= 0) {
+        close(m_wakeFd);
+        m_wakeFd = -1;
+    }
+#endif
+    m_pending.clear();
+    {
+        std::lock_guard<std::mutex> lock(m_stopMutex);
+        m_addedRoots.clear();
+    }
+    std::lock_guard<std::mutex> lock(m_readyMutex);
+    m_ready.clear();
+}
+
+bool FileWatcher::takeChanges(std::vector<FileChange>& changes) {
+    std::lock_guard<std::mutex> lock(m_readyMutex);
+    if (m_ready.empty()) {
+        return false;
+    }
+    changes.insert(changes.end(), std::make_move_iterator(m_ready.begin()), std::make_move_iterator(m_ready.end()));
+    m_ready.clear();
+    return true;
+}
+
+void FileWatcher::addPending(const std::string& path, std::chrono::steady_clock::time_point now) {
+    m_lastChange = now;
+    const auto found = std::find_if(m_pending.begin(), m_pending.end(),
+                                    [&path](const FileChange& change) { return change.path == path; });
+    if (found == m_pending.end()) {
+        m_pending.push_back({path, now});
+    }
+}
+
+int FileWatcher::publishIfQuiet(std::chrono::steady_clock::time_point now) {
+    if (m_pending.empty()) {
+        return -1;
+    }
+    const auto due = m_lastChange + std::chrono::milliseconds(m_config.debounceMilliseconds);
+    if (now < due) {
+        return static_cast<int>(std::chrono::ceil<std::chrono::milliseconds>(due - now).count());
+    }
+    std::lock_guard<std::mutex> lock(m_readyMutex);
+    m_ready.insert(m_ready.end(), std::make_move_iterator(m_pending.begin()), std::make_move_iterator(m_pending.end()));
+    m_pending.clear();
+    return -1;
+}
+
+#if POLARIS_HAVE_INOTIFY
+
+/**
+ * @brief Blocks on the inotify descriptor, and on the wake descriptor for stop(), with a
+ * timeout while a batch is waiting out its debounce time.
+ */
+void FileWatcher::watchMain() {
+    POLARIS_PROFILE_THREAD("FileWatcher");
+    POLARIS_MEMORY_THREAD_TAG(Assets);
+
+    constexpr std::uint32_t kDirectoryMask = IN_CLOSE_WRITE | IN_MOVED_TO | IN_CREATE | IN_ONLYDIR;
+    std::unordered_map<int, std::string> directories;
+    std::size_t failedWatches = 0;
+    const auto watchTree = [&](const std::string& root) {
+        std::vector<std::string> pending{root};
+        while (!pending.empty()) {
+            const std::string directory = std::move(pending.back());
+            pending.pop_back();
+            const int wd = inotify_add_watch(m_watchFd, directory.c_str(), kDirectoryMask);
+            if (wd < 0) {
+                ++failedWatches;
+                continue;
+            }
+            directories[wd] = directory;
+            std::error_code ec;
+            for (std::filesystem::directory_iterator it(directory, ec); !ec && it != std::filesystem::directory_iterator();
+                 it.increment(ec)) {
+                if (it->is_directory(ec) && !it->is_symlink(ec)) {
+                    pending.push_back(joinPath(directory, it->path().filename().string()));
+                }
+            }
+        }
+    };
+    for (const std::string& root : m_roots) {
+        watchTree(root);
+    }
+    if (failedWatches > 0) {
+        LOG_WARN("Could not watch {} directories (see fs.inotify.max_user_watches)", failedWatches);
+    }
+    LOG_INFO("Watching {} directories for changes", directories.size());
+
+    alignas(inotify_event) char buffer[16 * 1024];
+    pollfd descriptors[2] = {{m_watchFd, POLLIN, 0}, {m_wakeFd, POLLIN, 0}};
+    while (!m_stopping) {
+        const int timeout = publishIfQuiet(std::chrono::steady_clock::now());
+        if (poll(descriptors, 2, timeout) < 0) {
+            continue;   // EINTR
+        }
+        if ((descriptors[1].revents & POLLIN) != 0) {
+            // stop(), which set m_stopping, or addRoot()
+            std::uint64_t wakes = 0;
+            [[maybe_unused]] const ssize_t drained = read(m_wakeFd, &wakes, sizeof(wakes));
+            for (const std::string& root : takeAddedRoots()) {
+                watchTree(root);
+            }
+            continue;
+        }
+        if ((descriptors[0].revents & POLLIN) == 0) {
+            continue;
+        }
+
+        const auto now = std::chrono::steady_clock::now();
+        ssize_t length;
+        while ((length = read(m_watchFd, buffer, sizeof(buffer))) > 0) {
+            for (ssize_t offset = 0; offset < length;) {
+                const inotify_event* event = reinterpret_cast<const inotify_event*>(buffer + offset);
+                offset += static_cast<ssize_t>(sizeof(inotify_event) + event->len);
+                if (event->mask & IN_Q_OVERFLOW) {
+                    LOG_WARN("File watch queue overflowed; some changes were missed");
+                    continue;
+                }
+                if (event->mask & IN_IGNORED) {
+                    directories.erase(event->wd);
+                    continue;
+                }
+                const auto directory = directories.find(event->wd);
+                if (directory == directories.end() || event->len == 0) {
+                    continue;
+                }
+
+                const std::string path = joinPath(directory->second, event->name);
+                if (event->mask & IN_ISDIR) {
+                    // A new directory may already hold files written before it was watched
+                    if (event->mask & (IN_CREATE | IN_MOVED_TO)) {
+                        watchTree(path);
+                        forEachFile(path, [&](const std::filesystem::path& file) {
+                            addPending(file.generic_string(), now);
+                        });
+                    }
+                } else if (event->mask & (IN_CLOSE_WRITE | IN_MOVED_TO)) {
+                    addPending(path, now);
+                }
+            }
+        }
+    }
+}
+
+#endif
+
+/**
+ * @brief Rescans the trees every pollMilliseconds, reporting files that are new or whose
+ * modification time or size changed since the previous scan.
+ */
+void FileWatcher::pollMain() {
+    POLARIS_PROFILE_THREAD("FileWatcher");
+    POLARIS_MEMORY_THREAD_TAG(Assets);
+
+    using Snapshot = std::map<std::string, std::pair<std::filesystem::file_time_type, std::uintmax_t>>;
+    const auto scanRoot = [](const std::string& root, Snapshot& snapshot) {
+        forEachFile(root, [&snapshot](const std::filesystem::path& file) {
+            std::error_code ec;
+            const auto time = std::filesystem::last_write_time(file, ec);
+            const auto size = std::filesystem::file_size(file, ec);
+            if (!ec) {
+                snapshot[file.generic_string()] = {time, size};
+            }
+        });
+    };
+    const auto scan = [this, &scanRoot](Snapshot& snapshot) {
+        for (const std::string& root : m_roots) {
+            scanRoot(root, snapshot);
+        }
+    };
+
+    Snapshot previous;
+    scan(previous);
+    LOG_INFO("Polling {} files for changes", previous.size());
+
+    auto nextScan = std::chrono::steady_clock::now() + std::chrono::milliseconds(m_config.pollMilliseconds);
+    while (!m_stopping) {
+        const int due = publishIfQuiet(std::chrono::steady_clock::now());
+        {
+            std::unique_lock<std::mutex> lock(m_stopMutex);
+            const auto wake = due < 0 ? nextScan : std::min(nextScan, std::chrono::steady_clock::now() + std::chrono::milliseconds(due));
+            m_stopRequested.wait_until(lock, wake, [this]() { return m_stopping.load() || !m_addedRoots.empty(); });
+        }
+        // Files already under a new root are not changes; take them into the snapshot
+        for (const std::string& root : takeAddedRoots()) {
+            scanRoot(root, previous);
+        }
+        const auto now = std::chrono::steady_clock::now();
+        if (m_stopping || now < nextScan) {
+            continue;
+        }
+
+        Snapshot current;
+        scan(current);
+        for (const auto& [path, state] : current) {
+            const auto found = previous.find(path);
+            if (found == previous.end() || found->second != state) {
+                addPending(path, now);
+            }
+        }
+        previous.swap(current);
+        nextScan = now + std::chrono::milliseconds(m_config.pollMilliseconds);
+    }
+}
+
+} // namespace polaris
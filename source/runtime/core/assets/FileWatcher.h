@@ -0,0 +1,121 @@
+#ifndef POLARIS_FILEWATCHER_H
+#define POLARIS_FILEWATCHER_H
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace polaris {
+
+struct FileWatcherConfig {
+    /**
+     * @brief Quiet time after the last change before a batch is reported, so that a save that
+     * writes, renames and touches a file several times is reported once.
+     */
+    unsigned debounceMilliseconds = 150;
+    /**
+     * @brief Interval between directory scans on platforms without inotify.
+     */
+    unsigned pollMilliseconds = 500;
+};
+
+/**
+ * @brief A file that was written, created or moved into a watched directory.
+ */
+struct FileChange {
+    std::string path;   ///< The watched directory as given, joined with the path below it.
+    std::chrono::steady_clock::time_point detected;   ///< First change of the batch to this file.
+};
+
+/**
+ * @brief Watches directory trees for changed files on a background thread.
+ *
+ * On Linux and Android the thread blocks on inotify, watching every directory under the roots
+ * (including ones created later) for files closed after writing or moved in, which is how
+ * editors save. Elsewhere it scans the trees every pollMilliseconds and compares modification
+ * times and sizes. Either way changes are debounced and handed over in batches through
+ * takeChanges(), which never blocks.
+ */
+class FileWatcher {
+public:
+    FileWatcher() = default;
+    ~FileWatcher();
+
+    FileWatcher(const FileWatcher&) = delete;
+    FileWatcher& operator=(const FileWatcher&) = delete;
+
+    /**
+     * @brief Starts watching, replacing any directories watched before.
+     * @return false if no root is a directory or the OS watch cannot be created.
+     */
+    bool start(const std::vector<std::string>& roots, const FileWatcherConfig& config = FileWatcherConfig());
+
+    /**
+     * @brief Watches another directory tree as well, without restarting, so changes pending
+     * under the other roots are kept. Starts watching if not running.
+     * @return false if it is not a directory.
+     */
+    bool addRoot(const std::string& root);
+
+    /**
+     * @brief Stops the thread; pending changes are dropped.
+     */
+    void stop();
+
+    bool isRunning() const { return m_thread.joinable(); }
+
+    /**
+     * @brief Appends the changes of every batch completed since the last call.
+     * @return false if there were none.
+     */
+    bool takeChanges(std::vector<FileChange>& changes);
+
+private:
+    void watchMain();
+    void pollMain();
+
+    /**
+     * @brief Watch thread: moves the roots passed to addRoot() into m_roots.
+     * @return The roots added since the last call.
+     */
+    std::vector<std::string> takeAddedRoots();
+
+    /**
+     * @brief Collects a change, keeping the first detection time of a file already pending.
+     */
+    void addPending(const std::string& path, std::chrono::steady_clock::time_point now);
+
+    /**
+     * @brief Moves the pending changes to the ready list once debounceMilliseconds have passed
+     * without a new one.
+     * @return Milliseconds until the pending batch is due, or -1 if nothing is pending.
+     */
+    int publishIfQuiet(std::chrono::steady_clock::time_point now);
+
+    FileWatcherConfig m_config;
+    std::vector<std::string> m_roots;
+    std::thread m_thread;
+    std::atomic<bool> m_stopping{false};
+
+    /// Wakes the polling thread on stop() and addRoot(); also guards m_addedRoots.
+    std::mutex m_stopMutex;
+    std::condition_variable m_stopRequested;
+    std::vector<std::string> m_addedRoots;
+    int m_watchFd = -1;   ///< inotify instance.
+    int m_wakeFd = -1;    ///< eventfd written by stop() and addRoot() to wake the inotify thread.
+
+    // Watch thread only
+    std::vector<FileChange> m_pending;
+    std::chrono::steady_clock::time_point m_lastChange;
+
+    std::mutex m_readyMutex;
+    std::vector<FileChange> m_ready;
+};
+
+} // namespace polaris
+
+#endif // POLARIS_FILEWATCHER_H
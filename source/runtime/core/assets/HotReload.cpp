@@ -0,0 +1,307 @@
+#include "assets/HotReload.h"
+
+#include "Logger.h"
+#include "memory/MemoryTracker.h"
+#include "profiling/Profiler.h"
+#include "rendering/AtlasRegistry.h"
+#include "rendering/TextRenderer.h"
+#include "rendering/TextureManager.h"
+#include <algorithm>
+#include <fstream>
+#include <iterator>
+#include <memory>
+
+namespace polaris {
+
+HotReload::~HotReload() {
+    shutdown();
+}
+
+void HotReload::shutdown() {
+    m_watcher.stop();
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_stopping = true;
+        m_jobs.clear();
+    }
+    m_jobReady.notify_all();
+    if (m_thread.joinable()) {
+        m_thread.join();
+    }
+    m_loaded.clear();
+    m_applying.clear();
+    m_inFlight.clear();
+    m_deferred.clear();
+    m_directories.clear();
+    for (const auto& entry : m_handlers) {
+        if (entry.second.detach) {
+            entry.second.detach();
+        }
+    }
+    m_handlers.clear();
+    m_nextHandler = 1;
+    m_stats.pending = 0;
+}
+
+bool HotReload::watch(const std::string& directory) {
+    if (std::find(m_directories.begin(), m_directories.end(), directory) != m_directories.end()) {
+        return true;
+    }
+    // Added to the running watcher, so changes still being debounced under the others survive
+    const bool watching = m_watcher.isRunning() ? m_watcher.addRoot(directory) : m_watcher.start({directory}, m_config);
+    if (!watching) {
+        return false;
+    }
+    m_directories.push_back(directory);
+
+    if (!m_thread.joinable()) {
+        m_stopping = false;
+        m_thread = std::thread(&HotReload::reloadMain, this);
+    }
+    LOG_INFO("Hot reloading assets under {}", directory);
+    return true;
+}
+
+int HotReload::addHandler(HotReloadHandler handler) {
+    const int id = m_nextHandler++;
+    m_handlers.emplace_back(id, std::move(handler));
+    return id;
+}
+
+void HotReload::removeHandler(int id) {
+    for (const auto& entry : m_handlers) {
+        if (entry.first == id && entry.second.detach) {
+            entry.second.detach();
+        }
+    }
+    m_deferred.erase(std::remove_if(m_deferred.begin(), m_deferred.end(),
+                                    [id](const Deferred& deferred) { return deferred.handler == id; }),
+                     m_deferred.end());
+    m_handlers.erase(std::remove_if(m_handlers.begin(), m_handlers.end(),
+                                    [id](const auto& handler) { return handler.first == id; }),
+                     m_handlers.end());
+}
+
+int HotReload::addTextures(TextureManager& textures) {
+    HotReloadHandler handler;
+    handler.match = [&textures](const std::string& file, std::string& asset) {
+        asset = file;
+        return textures.Contains(file);
+    };
+    // The manager decodes on its own threads; there is nothing to read here
+    handler.load = [&textures](const std::string& asset) -> Apply {
+        return [&textures, asset](CommandList&) { return textures.Reload(asset); };
+    };
+    // Reload() only queues the decode; the manager reports when the new version is resident
+    handler.deferred = true;
+    handler.detach = [&textures]() { textures.SetReloadCallback(nullptr); };
+    const int id = addHandler(std::move(handler));
+    textures.SetReloadCallback([this, id](const std::string& name, bool loaded) { complete(id, name, loaded); });
+    return id;
+}
+
+int HotReload::addAtlases(AtlasRegistry& atlases) {
+    HotReloadHandler handler;
+    handler.match = [&atlases](const std::string& file, std::string& asset) {
+        asset = atlases.FindAtlas(file);
+        return !asset.empty();
+    };
+    handler.load = [&atlases](const std::string& asset) -> Apply {
+        auto decoded = std::make_shared<DecodedAtlas>();
+        if (!AtlasRegistry::Decode(asset, *decoded)) {
+            return Apply();
+        }
+        return [&atlases, decoded](CommandList& commands) { return atlases.Reload(*decoded, commands); };
+    };
+    return addHandler(std::move(handler));
+}
+
+int HotReload::addFonts(TextRenderer& fonts) {
+    HotReloadHandler handler;
+    handler.match = [&fonts](const std::string& file, std::string& asset) {
+        asset = file;
+        return fonts.FindFont(file) != 0;
+    };
+    handler.load = [&fonts](const std::string& asset) -> Apply {
+        std::ifstream file(asset, std::ios::binary);
+        auto data = std::make_shared<std::vector<std::uint8_t>>(std::istreambuf_iterator<char>(file),
+                                                                std::istreambuf_iterator<char>());
+        if (data->empty()) {
+            LOG_ERROR("Failed to read font {}", asset);
+            return Apply();
+        }
+        return [&fonts, asset, data](CommandList&) { return fonts.ReloadFont(asset, std::move(*data)); };
+    };
+    return addHandler(std::move(handler));
+}
+
+void HotReload::update(CommandList& commands, const FrameTimingStats& timing) {
+    if (!m_thread.joinable()) {
+        return;
+    }
+    POLARIS_PROFILE_SCOPE("HotReload::update");
+
+    // frameTime is now the length of the previous frame, which swapped assets in if this is set
+    if (m_appliedLastFrame) {
+        m_stats.lastSpikeMilliseconds = std::max(0.0, timing.frameTime - timing.averageFrameTime) * 1000.0;
+        m_stats.maxSpikeMilliseconds = std::max(m_stats.maxSpikeMilliseconds, m_stats.lastSpikeMilliseconds);
+        m_appliedLastFrame = false;
+    }
+
+    apply(commands);
+
+    if (!m_watcher.takeChanges(m_changes)) {
+        return;
+    }
+    POLARIS_MEMORY_SCOPE(Assets);
+    for (const FileChange& change : m_changes) {
+        ++m_stats.changes;
+        for (const auto& [id, handler] : m_handlers) {
+            std::string asset;
+            if (handler.match(change.path, asset)) {
+                queue(id, asset, change.detected);
+            }
+        }
+    }
+    m_changes.clear();
+}
+
+/**
+ * @brief Queues an asset for the reload thread, unless it is already being loaded, in which
+ * case it is loaded again once that finishes.
+ */
+void HotReload::queue(int handler, const std::string& asset, std::chrono::steady_clock::time_point detected) {
+    for (InFlight& inFlight : m_inFlight) {
+        if (inFlight.handler == handler && inFlight.asset == asset) {
+            inFlight.changedAgain = true;
+            return;
+        }
+    }
+    const auto found = std::find_if(m_handlers.begin(), m_handlers.end(),
+                                    [handler](const auto& entry) { return entry.first == handler; });
+    if (found == m_handlers.end()) {
+        return;
+    }
+
+    m_inFlight.push_back({handler, asset, false});
+    ++m_stats.pending;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_jobs.push_back({handler, asset, detected, found->second.load});
+    }
+    m_jobReady.notify_one();
+}
+
+void HotReload::apply(CommandList& commands) {
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (m_loaded.empty()) {
+            return;
+        }
+        m_applying.swap(m_loaded);
+    }
+
+    const auto start = std::chrono::steady_clock::now();
+    bool swapped = false;
+    for (Loaded& loaded : m_applying) {
+        const auto inFlight = std::find_if(m_inFlight.begin(), m_inFlight.end(), [&loaded](const InFlight& entry) {
+            return entry.handler == loaded.handler && entry.asset == loaded.asset;
+        });
+        const bool changedAgain = inFlight != m_inFlight.end() && inFlight->changedAgain;
+        if (inFlight != m_inFlight.end()) {
+            m_inFlight.erase(inFlight);
+        }
+        --m_stats.pending;
+
+        const auto handler = std::find_if(m_handlers.begin(), m_handlers.end(),
+                                          [&loaded](const auto& entry) { return entry.first == loaded.handler; });
+        if (handler == m_handlers.end()) {
+            continue;
+        }
+        if (changedAgain) {
+            // This version is already out of date
+            queue(loaded.handler, loaded.asset, loaded.detected);
+            continue;
+        }
+
+        const bool started = loaded.apply && loaded.apply(commands);
+        if (started && handler->second.deferred) {
+            m_deferred.push_back({loaded.handler, std::move(loaded.asset), loaded.detected});
+            continue;
+        }
+        record(loaded.asset, loaded.detected, started);
+        swapped = true;
+    }
+    m_applying.clear();
+
+    // Frames that only started deferred swaps are measured when those finish
+    if (!swapped) {
+        return;
+    }
+    m_stats.lastApplyMilliseconds =
+        std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    m_stats.maxApplyMilliseconds = std::max(m_stats.maxApplyMilliseconds, m_stats.lastApplyMilliseconds);
+    m_appliedLastFrame = true;
+}
+
+void HotReload::complete(int handler, const std::string& asset, bool swapped) {
+    const auto deferred = std::find_if(m_deferred.begin(), m_deferred.end(), [&](const Deferred& entry) {
+        return entry.handler == handler && entry.asset == asset;
+    });
+    if (deferred == m_deferred.end()) {
+        // Not started by a file change, e.g. the handler's own retry
+        return;
+    }
+    const auto detected = deferred->detected;
+    m_deferred.erase(deferred);
+    record(asset, detected, swapped);
+    m_appliedLastFrame = true;
+}
+
+/**
+ * @brief Counts a finished reload, with its latency from the first change to the file.
+ */
+void HotReload::record(const std::string& asset, std::chrono::steady_clock::time_point detected, bool swapped) {
+    if (!swapped) {
+        ++m_stats.failures;
+        LOG_WARN("Failed to reload {}; keeping the current version", asset);
+        return;
+    }
+    const auto now = std::chrono::steady_clock::now();
+    const double latency = std::chrono::duration<double, std::milli>(now - detected).count();
+    ++m_stats.reloads;
+    m_stats.lastLatencyMilliseconds = latency;
+    m_stats.maxLatencyMilliseconds = std::max(m_stats.maxLatencyMilliseconds, latency);
+    m_stats.averageLatencyMilliseconds +=
+        (latency - m_stats.averageLatencyMilliseconds) / static_cast<double>(m_stats.reloads);
+    LOG_INFO("Reloaded {} in {:.1f} ms", asset, latency);
+}
+
+void HotReload::reloadMain() {
+    POLARIS_PROFILE_THREAD("HotReload");
+    POLARIS_MEMORY_THREAD_TAG(Assets);
+
+    for (;;) {
+        Job job;
+        {
+            std::unique_lock<std::mutex> lock(m_mutex);
+            m_jobReady.wait(lock, [this]() { return m_stopping || !m_jobs.empty(); });
+            if (m_stopping) {
+                return;
+            }
+            job = std::move(m_jobs.front());
+            m_jobs.pop_front();
+        }
+
+        Apply apply;
+        {
+            POLARIS_PROFILE_SCOPE("HotReload::load");
+            apply = job.load(job.asset);
+        }
+
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_loaded.push_back({job.handler, std::move(job.asset), job.detected, std::move(apply)});
+    }
+}
+
+} // namespace polaris
@@ -0,0 +1,204 @@
+#ifndef POLARIS_HOTRELOAD_H
+#define POLARIS_HOTRELOAD_H
+
+#include "FrameScheduler.h"
+#include "assets/FileWatcher.h"
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace polaris {
+
+class AtlasRegistry;
+class CommandList;
+class TextRenderer;
+class TextureManager;
+
+/**
+ * @brief Hot reload activity. Counters are totals since the first watched directory.
+ */
+struct HotReloadStats {
+    std::uint64_t changes = 0;                ///< Changed files reported by the watcher.
+    std::uint64_t reloads = 0;                ///< Assets swapped for their new version.
+    std::uint64_t failures = 0;               ///< New versions that could not be loaded; the old ones stay.
+    std::uint32_t pending = 0;                ///< Assets being read on the reload thread.
+    double lastLatencyMilliseconds = 0.0;     ///< From the first change to the file to the swap.
+    double averageLatencyMilliseconds = 0.0;
+    double maxLatencyMilliseconds = 0.0;
+    double lastApplyMilliseconds = 0.0;       ///< Time the last frame with reloads spent swapping them in; texture
+                                              ///< uploads are spread over frames by the TextureManager instead.
+    double maxApplyMilliseconds = 0.0;
+    double lastSpikeMilliseconds = 0.0;       ///< How much longer than average the last frame with reloads took.
+    double maxSpikeMilliseconds = 0.0;
+};
+
+/**
+ * @brief Reloads one kind of asset for HotReload.
+ */
+struct HotReloadHandler {
+    /**
+     * @brief Game thread: whether a changed file belongs to one of the handler's assets, and
+     * if so which, e.g. the atlas a page image is part of.
+     */
+    std::function<bool(const std::string& file, std::string& asset)> match;
+    /**
+     * @brief Reload thread: reads and decodes the new version of an asset without touching
+     * anything the game thread uses.
+     * @return The step that swaps it in on the game thread, returning false if it could not;
+     * or an empty function if the asset could not be read.
+     */
+    std::function<std::function<bool(CommandList&)>(const std::string& asset)> load;
+    /**
+     * @brief The apply step only starts the swap, which finishes in a later frame; the reload
+     * is counted once the handler reports it with HotReload::complete().
+     */
+    bool deferred = false;
+    /**
+     * @brief Optional; undoes whatever the handler hooked into when it is removed.
+     */
+    std::function<void()> detach;
+};
+
+/**
+ * @brief Reloads assets whose files change while the game runs, without restarting it.
+ *
+ * A FileWatcher reports debounced batches of changed files under the watched directories.
+ * update(), called by the engine at the start of every frame, offers each file to the
+ * handlers; the assets they claim are read and decoded on a background reload thread, so the
+ * frame never waits for the disk or a decoder. Decoded assets are swapped in by a later
+ * update(), at a frame boundary, before anything is drawn with them. A file that changes
+ * again while its asset is loading is loaded once more afterwards.
+ *
+ * Changed paths are the watched directory as given joined with the path below it, so assets
+ * match when they were loaded with the same prefix (e.g. "assets" and "assets/ui/font.ttf").
+ * Assets served from an asset pack are not reloaded.
+ *
+ * Everything but the handlers' load step runs on the thread recording frames.
+ */
+class HotReload {
+public:
+    HotReload() = default;
+    ~HotReload();
+
+    HotReload(const HotReload&) = delete;
+    HotReload& operator=(const HotReload&) = delete;
+
+    void initialize(const FileWatcherConfig& config = FileWatcherConfig()) { m_config = config; }
+
+    /**
+     * @brief Stops watching, drops reloads in progress and removes every handler, so that
+     * none outlives the objects it reloads.
+     */
+    void shutdown();
+
+    /**
+     * @brief Starts watching a directory tree, and the reload thread with the first one.
+     * @return false if it is not a directory or cannot be watched.
+     */
+    bool watch(const std::string& directory);
+
+    /**
+     * @brief Adds a handler; the objects it uses must outlive it or be removed with it.
+     * @return Id for removeHandler().
+     */
+    int addHandler(HotReloadHandler handler);
+    void removeHandler(int id);
+
+    /**
+     * @brief Reloads textures loaded through a TextureManager. The new image streams in
+     * through the manager itself, replacing the old one once fully uploaded, which is when
+     * the reload is counted. Only one HotReload can reload a given manager's textures.
+     */
+    int addTextures(TextureManager& textures);
+
+    /**
+     * @brief Reloads atlases, when their index or a page image changes.
+     */
+    int addAtlases(AtlasRegistry& atlases);
+
+    /**
+     * @brief Reloads the fonts of a TextRenderer.
+     */
+    int addFonts(TextRenderer& fonts);
+
+    /**
+     * @brief Swaps in the assets loaded since the last call, then queues the assets of newly
+     * changed files. Call once per frame, before recording anything that uses them.
+     * @param timing Frame timing, whose last frameTime shows how much a previous swap cost.
+     */
+    void update(CommandList& commands, const FrameTimingStats& timing);
+
+    /**
+     * @brief Reports that the swap a deferred handler's apply step started has finished, or
+     * failed and the current version stays.
+     */
+    void complete(int handler, const std::string& asset, bool swapped);
+
+    const HotReloadStats& getStats() const { return m_stats; }
+
+private:
+    using Apply = std::function<bool(CommandList&)>;
+
+    struct Job {
+        int handler;
+        std::string asset;
+        std::chrono::steady_clock::time_point detected;
+        std::function<Apply(const std::string&)> load;   ///< Copied, so removing the handler is safe.
+    };
+
+    struct Loaded {
+        int handler;
+        std::string asset;
+        std::chrono::steady_clock::time_point detected;
+        Apply apply;   ///< Empty if the asset could not be read.
+    };
+
+    struct Deferred {
+        int handler;
+        std::string asset;
+        std::chrono::steady_clock::time_point detected;
+    };
+
+    struct InFlight {
+        int handler;
+        std::string asset;
+        bool changedAgain;
+    };
+
+    void reloadMain();
+    void apply(CommandList& commands);
+    void queue(int handler, const std::string& asset, std::chrono::steady_clock::time_point detected);
+    void record(const std::string& asset, std::chrono::steady_clock::time_point detected, bool swapped);
+
+    FileWatcherConfig m_config;
+    FileWatcher m_watcher;
+    std::vector<std::string> m_directories;
+    std::vector<std::pair<int, HotReloadHandler>> m_handlers;
+    int m_nextHandler = 1;
+
+    std::thread m_thread;
+    std::mutex m_mutex;
+    std::condition_variable m_jobReady;
+    std::deque<Job> m_jobs;
+    std::vector<Loaded> m_loaded;
+    bool m_stopping = false;
+
+    // Game thread only
+    std::vector<FileChange> m_changes;
+    std::vector<Loaded> m_applying;
+    std::vector<InFlight> m_inFlight;
+    std::vector<Deferred> m_deferred;   ///< Swaps started by deferred handlers, oldest first.
+    bool m_appliedLastFrame = false;
+    HotReloadStats m_stats;
+};
+
+} // namespace polaris
+
+#endif // POLARIS_HOTRELOAD_H
@@ -0,0 +1,202 @@
+#include "assets/Lz4Block.h"
+
+#include <cstring>
+
+namespace polaris {
+
+namespace {
+
+// Format limits from the LZ4 block specification
+constexpr std::size_t kMinMatch = 4;
+constexpr std::size_t kLastLiterals = 5;     ///< The block always ends with at least this many literals.
+constexpr std::size_t kMatchStartLimit = 12; ///< No match may start within this many bytes of the end.
+constexpr std::size_t kMaxOffset = 65535;
+
+constexpr int kHashBits = 12;
+
+std::uint32_t read32(const std::uint8_t* p) {
+    std::uint32_t value;
+    std::memcpy(&value, p, sizeof(value));
+    return value;
+}
+
+std::uint32_t hash4(std::uint32_t sequence) {
+    return (sequence * 2654435761u) >> (32 - kHashBits);
+}
+
+/**
+ * @brief Writes the 255-continued remainder of a length whose nibble was saturated.
+ */
+bool writeLength(std::size_t length, std::uint8_t*& out, const std::uint8_t* end) {
+    while (length >= 255) {
+        if (out == end) {
+            return false;
+        }
+        *out++ = 255;
+        length -= 255;
+    }
+    if (out == end) {
+        return false;
+    }
+    *out++ = static_cast<std::uint8_t>(length);
+    return true;
+}
+
+bool readLength(std::size_t& length, const std::uint8_t*& in, const std::uint8_t* end) {
+    std::uint8_t byte = 255;
+    while (byte == 255) {
+        if (in == end) {
+            return false;
+        }
+        byte = *in++;
+        length += byte;
+    }
+    return true;
+}
+
+/**
+ * @brief Writes one sequence: literals, then a match unless matchLength is 0 (the last sequence).
+ */
+bool writeSequence(const std::uint8_t* literals, std::size_t literalLength, std::size_t offset,
+                   std::size_t matchLength, std::uint8_t*& out, const std::uint8_t* end) {
+    if (out == end) {
+        return false;
+    }
+    const std::size_t matchCode = matchLength > 0 ? matchLength - kMinMatch : 0;
+    std::uint8_t* token = out++;
+    *token = static_cast<std::uint8_t>(((literalLength < 15 ? literalLength : 15) << 4) |
+                                       (matchCode < 15 ? matchCode : 15));
+    if (literalLength >= 15 && !writeLength(literalLength - 15, out, end)) {
+        return false;
+    }
+    if (static_cast<std::size_t>(end - out) < literalLength) {
+        return false;
+    }
+    if (literalLength > 0) {
+        std::memcpy(out, literals, literalLength);
+        out += literalLength;
+    }
+
+    if (matchLength == 0) {
+        return true;
+    }
+    if (end - out < 2) {
+        return false;
+    }
+    *out++ = static_cast<std::uint8_t>(offset);
+    *out++ = static_cast<std::uint8_t>(offset >> 8);
+    return matchCode < 15 || writeLength(matchCode - 15, out, end);
+}
+
+} // namespace
+
+std::size_t lz4Compress(const std::uint8_t* source, std::size_t size, std::uint8_t* destination,
+                        std::size_t capacity) {
+    std::uint8_t* out = destination;
+    const std::uint8_t* const outEnd = destination + capacity;
+    std::size_t anchor = 0;
+
+    if (size > kMatchStartLimit) {
+        // Positions + 1 of the last occurrence of each hashed 4-byte sequence; 0 is empty
+        std::uint32_t table[1 << kHashBits] = {};
+        const std::size_t matchStartEnd = size - kMatchStartLimit;
+        const std::size_t matchEnd = size - kLastLiterals;
+        std::size_t position = 0;
+        std::size_t misses = 0;
+
+        while (position < matchStartEnd) {
+            const std::uint32_t sequence = read32(source + position);
+            std::uint32_t& slot = table[hash4(sequence)];
+            const std::size_t candidate = slot;
+            slot = static_cast<std::uint32_t>(position + 1);
+
+            if (candidate == 0 || position - (candidate - 1) > kMaxOffset || read32(source + candidate - 1) != sequence) {
+                // Skip ahead faster through data that does not compress
+                position += 1 + (misses++ >> 6);
+                continue;
+            }
+            misses = 0;
+
+            std::size_t match = candidate - 1;
+            std::size_t length = kMinMatch;
+            while (position + length < matchEnd && source[match + length] == source[position + length]) {
+                ++length;
+            }
+            // Extend backwards over literals that also match
+            while (position > anchor && match > 0 && source[position - 1] == source[match - 1]) {
+                --position;
+                --match;
+                ++length;
+            }
+
+            if (!writeSequence(source + anchor, position - anchor, position - match, length, out, outEnd)) {
+                return 0;
+            }
+            position += length;
+            anchor = position;
+            if (position - 2 < matchStartEnd) {
+                table[hash4(read32(source + position - 2))] = static_cast<std::uint32_t>(position - 1);
+            }
+        }
+    }
+
+    if (!writeSequence(source + anchor, size - anchor, 0, 0, out, outEnd)) {
+        return 0;
+    }
+    return static_cast<std::size_t>(out - destination);
+}
+
+bool lz4Decompress(const std::uint8_t* source, std::size_t sourceSize, std::uint8_t* destination,
+                   std::size_t size) {
+    const std::uint8_t* in = source;
+    const std::uint8_t* const inEnd = source + sourceSize;
+    std::size_t written = 0;
+
+    while (in < inEnd) {
+        const std::uint8_t token = *in++;
+        std::size_t literalLength = token >> 4;
+        if (literalLength == 15 && !readLength(literalLength, in, inEnd)) {
+            return false;
+        }
+        if (static_cast<std::size_t>(inEnd - in) < literalLength || size - written < literalLength) {
+            return false;
+        }
+        if (literalLength > 0) {
+            std::memcpy(destination + written, in, literalLength);
+            in += literalLength;
+            written += literalLength;
+        }
+
+        if (in == inEnd) {
+            break;   // The last sequence has no match
+        }
+        if (inEnd - in < 2) {
+            return false;
+        }
+        const std::size_t offset = static_cast<std::size_t>(in[0]) | (static_cast<std::size_t>(in[1]) << 8);
+        in += 2;
+        std::size_t matchLength = token & 15;
+        if (matchLength == 15 && !readLength(matchLength, in, inEnd)) {
+            return false;
+        }
+        matchLength += kMinMatch;
+        if (offset == 0 || offset > written || size - written < matchLength) {
+            return false;
+        }
+
+        std::uint8_t* out = destination + written;
+        const std::uint8_t* match = out - offset;
+        if (offset >= matchLength) {
+            std::memcpy(out, match, matchLength);
+        } else {
+            // Overlapping copy repeats the last offset bytes, e.g. a run when offset is 1
+            for (std::size_t i = 0; i < matchLength; ++i) {
+                out[i] = match[i];
+            }
+        }
+        written += matchLength;
+    }
+    return written == size;
+}
+
+} // namespace polaris
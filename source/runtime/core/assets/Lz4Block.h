@@ -0,0 +1,35 @@
+#ifndef POLARIS_LZ4BLOCK_H
+#define POLARIS_LZ4BLOCK_H
+
+#include <cstddef>
+#include <cstdint>
+
+namespace polaris {
+
+/**
+ * @brief Largest compressed size of size bytes, for sizing the output of lz4Compress.
+ */
+constexpr std::size_t lz4CompressBound(std::size_t size) {
+    return size + size / 255 + 16;
+}
+
+/**
+ * @brief Compresses a buffer into the LZ4 block format (no frame header, no checksum), with
+ * a greedy single-probe match finder: fast rather than tight, like LZ4's default level.
+ * The output can be decoded by any LZ4 block decoder.
+ * @return The compressed size, or 0 if it does not fit in capacity.
+ */
+std::size_t lz4Compress(const std::uint8_t* source, std::size_t size, std::uint8_t* destination,
+                        std::size_t capacity);
+
+/**
+ * @brief Decompresses an LZ4 block whose decompressed size is known. Every read and write is
+ * bounds-checked, so corrupt input fails instead of overrunning.
+ * @return false unless the block decodes to exactly size bytes.
+ */
+bool lz4Decompress(const std::uint8_t* source, std::size_t sourceSize, std::uint8_t* destination,
+                   std::size_t size);
+
+} // namespace polaris
+
+#endif // POLARIS_LZ4BLOCK_H
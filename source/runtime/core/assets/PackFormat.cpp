@@ -0,0 +1,154 @@
+#include "assets/PackFormat.h"
+
+#include "assets/Lz4Block.h"
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+
+namespace polaris {
+
+namespace {
+
+std::uint64_t alignUp(std::uint64_t value, std::uint64_t alignment) {
+    return (value + alignment - 1) & ~(alignment - 1);
+}
+
+bool readFile(const std::string& path, std::vector<std::uint8_t>& data) {
+    std::ifstream file(path, std::ios::binary | std::ios::ate);
+    if (!file.is_open()) {
+        return false;
+    }
+    const std::streamoff size = file.tellg();
+    if (size < 0) {
+        return false;
+    }
+    data.resize(static_cast<std::size_t>(size));
+    file.seekg(0);
+    return size == 0 || static_cast<bool>(file.read(reinterpret_cast<char*>(data.data()), size));
+}
+
+} // namespace
+
+bool writePack(const std::string& path, std::vector<PackSource> sources, const PackWriteOptions& options,
+               PackWriteStats& stats, std::string& error) {
+    stats = PackWriteStats();
+    const std::uint32_t alignment = std::max<std::uint32_t>(options.alignment, 1);
+    if ((alignment & (alignment - 1)) != 0 || alignment > kPackPageSize) {
+        error = "alignment must be a power of two no larger than a page";
+        return false;
+    }
+
+    // Entries and names in source order, which is also the order the data is written in
+    std::vector<PackEntry> entries(sources.size());
+    std::string names;
+    for (std::size_t i = 0; i < sources.size(); ++i) {
+        const std::string& name = sources[i].name;
+        if (name.empty() || name.size() > 0xFFFF) {
+            error = "invalid asset name '" + name + "'";
+            return false;
+        }
+        PackEntry& entry = entries[i];
+        std::memset(&entry, 0, sizeof(entry));
+        entry.nameHash = hashPackName(name);
+        entry.nameOffset = static_cast<std::uint32_t>(names.size());
+        entry.nameLength = static_cast<std::uint16_t>(name.size());
+        names += name;
+    }
+    if (names.size() > 0xFFFFFFFFu) {
+        error = "too many asset names";
+        return false;
+    }
+
+    std::vector<std::size_t> order(sources.size());
+    for (std::size_t i = 0; i < order.size(); ++i) {
+        order[i] = i;
+    }
+    std::sort(order.begin(), order.end(),
+              [&entries](std::size_t a, std::size_t b) { return entries[a].nameHash < entries[b].nameHash; });
+    for (std::size_t i = 1; i < order.size(); ++i) {
+        if (entries[order[i]].nameHash == entries[order[i - 1]].nameHash) {
+            error = "'" + sources[order[i]].name + "' and '" + sources[order[i - 1]].name + "' have the same name hash";
+            return false;
+        }
+    }
+
+    PackHeader header;
+    std::memcpy(header.magic, kPackMagic, sizeof(header.magic));
+    header.version = kPackVersion;
+    header.reserved = 0;
+    header.entryCount = static_cast<std::uint32_t>(entries.size());
+    header.namesSize = static_cast<std::uint32_t>(names.size());
+    header.namesOffset = sizeof(PackHeader) + entries.size() * sizeof(PackEntry);
+    header.dataOffset = alignUp(header.namesOffset + names.size(), kPackPageSize);
+
+    std::ofstream file(path, std::ios::binary | std::ios::trunc);
+    if (!file.is_open()) {
+        error = "cannot create " + path;
+        return false;
+    }
+    // The header and index are written last, once the entries' offsets are known
+    const std::vector<char> zeros(kPackPageSize, 0);
+    std::uint64_t position = 0;
+    const auto padTo = [&](std::uint64_t target) {
+        while (position < target) {
+            const std::uint64_t count = std::min<std::uint64_t>(target - position, zeros.size());
+            file.write(zeros.data(), static_cast<std::streamsize>(count));
+            position += count;
+        }
+    };
+    padTo(header.dataOffset);
+
+    std::vector<std::uint8_t> data;
+    std::vector<std::uint8_t> compressed;
+    for (std::size_t i = 0; i < sources.size(); ++i) {
+        if (!readFile(sources[i].path, data)) {
+            error = "cannot read " + sources[i].path;
+            return false;
+        }
+        PackEntry& entry = entries[i];
+        entry.size = data.size();
+
+        const std::uint8_t* stored = data.data();
+        std::size_t storedSize = data.size();
+        entry.compression = static_cast<std::uint8_t>(PackCompression::None);
+        if (options.compress && sources[i].compress && !data.empty()) {
+            compressed.resize(lz4CompressBound(data.size()));
+            const std::size_t size = lz4Compress(data.data(), data.size(), compressed.data(), compressed.size());
+            if (size > 0 && static_cast<double>(size) <= static_cast<double>(data.size()) * options.maxCompressedRatio) {
+                stored = compressed.data();
+                storedSize = size;
+                entry.compression = static_cast<std::uint8_t>(PackCompression::Lz4);
+                ++stats.compressedEntries;
+            }
+        }
+
+        padTo(alignUp(position, storedSize >= kPackPageSize ? kPackPageSize : alignment));
+        entry.offset = position;
+        entry.storedSize = storedSize;
+        file.write(reinterpret_cast<const char*>(stored), static_cast<std::streamsize>(storedSize));
+        position += storedSize;
+
+        stats.originalBytes += entry.size;
+        stats.storedBytes += storedSize;
+    }
+    header.fileSize = position;
+
+    file.seekp(0);
+    file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    for (std::size_t index : order) {
+        file.write(reinterpret_cast<const char*>(&entries[index]), sizeof(PackEntry));
+    }
+    file.write(names.data(), static_cast<std::streamsize>(names.size()));
+    file.close();
+    if (!file) {
+        error = "failed writing " + path;
+        return false;
+    }
+
+    stats.entries = header.entryCount;
+    stats.fileBytes = header.fileSize;
+    return true;
+}
+
+} // namespace polaris
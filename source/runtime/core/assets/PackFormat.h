@@ -0,0 +1,113 @@
+#ifndef POLARIS_PACKFORMAT_H
+#define POLARIS_PACKFORMAT_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace polaris {
+
+/**
+ * @brief On-disk layout of asset packs (.ppak), written by polaris-pack and read by AssetPack.
+ *
+ * A pack is laid out so that it can be used straight from a memory mapping:
+ *  - PackHeader at offset 0
+ *  - PackEntry[entryCount] right after it, sorted by nameHash for binary search
+ *  - the names, concatenated without separators, at namesOffset
+ *  - the entry data from dataOffset on; each entry starts on a multiple of the pack's
+ *    alignment, and entries of a page or more start on a page boundary, so prefetching
+ *    or dropping one never touches a neighbour's pages
+ * Entries are stored as-is or as one LZ4 block (see Lz4Block.h). All integers are
+ * little-endian, and every field is naturally aligned.
+ */
+constexpr char kPackMagic[4] = {'P', 'P', 'A', 'K'};
+constexpr std::uint16_t kPackVersion = 1;
+constexpr std::uint64_t kPackPageSize = 4096;
+
+enum class PackCompression : std::uint8_t {
+    None = 0,
+    Lz4 = 1,
+};
+
+struct PackHeader {
+    char magic[4];
+    std::uint16_t version;
+    std::uint16_t reserved;
+    std::uint32_t entryCount;
+    std::uint32_t namesSize;
+    std::uint64_t namesOffset;
+    std::uint64_t dataOffset;
+    std::uint64_t fileSize;       ///< Catches truncated files.
+};
+
+struct PackEntry {
+    std::uint64_t nameHash;
+    std::uint64_t offset;         ///< From the start of the file.
+    std::uint64_t storedSize;     ///< Bytes in the file.
+    std::uint64_t size;           ///< Bytes once decompressed.
+    std::uint32_t nameOffset;     ///< Into the names.
+    std::uint16_t nameLength;
+    std::uint8_t compression;     ///< PackCompression.
+    std::uint8_t reserved;
+};
+
+static_assert(sizeof(PackHeader) == 40, "PackHeader is read in place and must not be padded");
+static_assert(sizeof(PackEntry) == 40, "PackEntry is read in place and must not be padded");
+
+/**
+ * @brief 64-bit FNV-1a hash of an asset name. Names are paths relative to the packed
+ * directory with '/' separators, including the extension, e.g. "textures/player.png".
+ */
+constexpr std::uint64_t hashPackName(std::string_view name) {
+    std::uint64_t hash = 14695981039346656037ull;
+    for (char c : name) {
+        hash ^= static_cast<unsigned char>(c);
+        hash *= 1099511628211ull;
+    }
+    return hash;
+}
+
+/**
+ * @brief A file to put in a pack.
+ */
+struct PackSource {
+    std::string name;   ///< Name in the pack; see hashPackName.
+    std::string path;   ///< File to read the contents from.
+    bool compress = true;
+};
+
+struct PackWriteOptions {
+    /**
+     * @brief Alignment of entries smaller than a page; a power of two.
+     */
+    std::uint32_t alignment = 16;
+    /**
+     * @brief Compress entries whose source allows it, keeping the compressed form only if it
+     * is at most this fraction of the original (already-compressed formats such as PNG or OGG
+     * then stay as they are).
+     */
+    bool compress = true;
+    float maxCompressedRatio = 0.9f;
+};
+
+struct PackWriteStats {
+    std::uint32_t entries = 0;
+    std::uint32_t compressedEntries = 0;
+    std::uint64_t originalBytes = 0;
+    std::uint64_t storedBytes = 0;
+    std::uint64_t fileBytes = 0;
+};
+
+/**
+ * @brief Writes a pack, reading one source file at a time.
+ * @param error Set to a description of the failure.
+ * @return false if a source cannot be read, two names collide, or the pack cannot be written.
+ */
+bool writePack(const std::string& path, std::vector<PackSource> sources, const PackWriteOptions& options,
+               PackWriteStats& stats, std::string& error);
+
+} // namespace polaris
+
+#endif // POLARIS_PACKFORMAT_H
@@ -0,0 +1,575 @@
+#include "audio/AudioEngine.h"
+
+#include "Logger.h"
+#include "math/Batch.h"
+#include "memory/MemoryTracker.h"
+#include "profiling/Profiler.h"
+#include <SDL3_mixer/SDL_mixer.h>
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <limits>
+
+namespace polaris {
+
+namespace {
+
+constexpr std::size_t kBusCount = static_cast<std::size_t>(AudioBus::Count);
+constexpr std::uint32_t kSlotMask = 0xFFFF;
+
+/**
+ * @brief Floats decoded per MIX_DecodeAudio call while loading a sound.
+ */
+constexpr std::size_t kLoadChunk = 16384;
+
+std::uint32_t slotOf(VoiceHandle voice) {
+    return voice & kSlotMask;
+}
+
+/**
+ * @brief Balance pan law: the centre plays both channels at full volume and panning fades
+ * out the opposite side.
+ */
+void panGains(float volume, float pan, float gains[2]) {
+    gains[0] = volume * std::min(1.0f, 1.0f - pan);
+    gains[1] = volume * std::min(1.0f, 1.0f + pan);
+}
+
+} // namespace
+
+AudioEngine::AudioEngine()
+    : m_stream(nullptr),
+      m_mixerInitialized(false),
+      m_playSequence(0),
+      m_commandsDropped(0),
+      m_voicesStolen(0),
+      m_busVolumes{},
+      m_busGains{},
+      m_masterVolume(1.0f),
+      m_blockFrames(0),
+      m_blockSeconds(0.0),
+      m_activeCount(0),
+      m_peakVoices(0),
+      m_voicesStarted(0),
+      m_callbacks(0),
+      m_lateCallbacks(0),
+      m_mixNanoseconds(0),
+      m_maxCallbackNanoseconds(0),
+      m_musicUnderrunsTaken(0) {
+}
+
+AudioEngine::~AudioEngine() {
+    shutdown();
+}
+
+/**
+ * @brief Sizes the voice pool, queues and mix buffers, then opens the device; nothing the
+ * callback touches is reallocated until shutdown().
+ */
+bool AudioEngine::initialize(const AudioConfig& config) {
+    if (!config.enabled) {
+        LOG_INFO("Audio disabled");
+        return false;
+    }
+    if (m_stream) {
+        LOG_WARN("Audio already initialized");
+        return true;
+    }
+    POLARIS_MEMORY_SCOPE(Audio);
+    m_config = config;
+    m_config.maxVoices = std::min(std::max(config.maxVoices, 1), static_cast<int>(kSlotMask) + 1);
+    m_config.bufferFrames = std::max(config.bufferFrames, 64);
+
+    if (!SDL_InitSubSystem(SDL_INIT_AUDIO)) {
+        LOG_WARN("Audio unavailable: {}", SDL_GetError());
+        return false;
+    }
+    if (!MIX_Init()) {
+        LOG_WARN("SDL_mixer initialization failed: {}", SDL_GetError());
+        SDL_QuitSubSystem(SDL_INIT_AUDIO);
+        return false;
+    }
+    m_mixerInitialized = true;
+
+    const std::size_t voiceCount = static_cast<std::size_t>(m_config.maxVoices);
+    m_commands = std::make_unique<SpscQueue<Command>>(static_cast<std::size_t>(std::max(config.commandQueueSize, 16)));
+    m_finished = std::make_unique<SpscQueue<VoiceHandle>>(voiceCount);
+    m_slotHandles.assign(voiceCount, 0);
+    m_slotStarted.assign(voiceCount, 0);
+    m_slotGenerations.assign(voiceCount, 0);
+    m_freeSlots.clear();
+    m_freeSlots.reserve(voiceCount);
+    for (std::size_t slot = voiceCount; slot > 0; --slot) {
+        m_freeSlots.push_back(static_cast<std::uint32_t>(slot - 1));
+    }
+
+    m_voices.assign(voiceCount, Voice());
+    m_activeVoices.clear();
+    m_activeVoices.reserve(voiceCount);
+    m_blockFrames = static_cast<std::size_t>(m_config.bufferFrames);
+    m_blockSeconds = static_cast<double>(m_blockFrames) / m_config.sampleRate;
+    m_busBuffers.assign(kBusCount * m_blockFrames * 2, 0.0f);
+    m_output.assign(m_blockFrames * 2, 0.0f);
+    for (std::size_t bus = 0; bus < kBusCount; ++bus) {
+        m_busVolumes[bus] = 1.0f;
+        m_busGains[bus] = 1.0f;
+    }
+    m_masterVolume = 1.0f;
+
+    // Ask for device buffers of bufferFrames; SDL converts if the device wants another format
+    SDL_SetHint(SDL_HINT_AUDIO_DEVICE_SAMPLE_FRAMES, std::to_string(m_config.bufferFrames).c_str());
+    const SDL_AudioSpec spec = {SDL_AUDIO_F32, 2, m_config.sampleRate};
+    m_stream = SDL_OpenAudioDeviceStream(SDL_AUDIO_DEVICE_DEFAULT_PLAYBACK, &spec, audioCallback, this);
+    if (!m_stream) {
+        LOG_WARN("Failed to open audio device: {}", SDL_GetError());
+        shutdown();
+        return false;
+    }
+
+    m_music.start(spec, static_cast<std::size_t>(std::max(config.musicBufferSeconds, 0.1f) * m_config.sampleRate));
+    SDL_ResumeAudioStreamDevice(m_stream);
+    LOG_INFO("Audio initialized: {} driver, {} Hz, {} frame buffers, {} voices", SDL_GetCurrentAudioDriver(),
+             m_config.sampleRate, m_config.bufferFrames, m_config.maxVoices);
+    return true;
+}
+
+void AudioEngine::shutdown() {
+    // Destroying the device stream closes the device and waits out a running callback
+    if (m_stream) {
+        SDL_DestroyAudioStream(m_stream);
+        m_stream = nullptr;
+    }
+    m_music.shutdown();
+    if (m_mixerInitialized) {
+        MIX_Quit();
+        SDL_QuitSubSystem(SDL_INIT_AUDIO);
+        m_mixerInitialized = false;
+    }
+    m_sounds.clear();
+    m_voices.clear();
+    m_activeVoices.clear();
+    m_activeCount.store(0, std::memory_order_relaxed);
+    m_slotHandles.clear();
+    m_freeSlots.clear();
+    m_commands.reset();
+    m_finished.reset();
+}
+
+SoundHandle AudioEngine::loadSound(const std::string& path) {
+    if (!m_stream) {
+        return 0;
+    }
+    for (std::size_t i = 0; i < m_sounds.size(); ++i) {
+        if (m_sounds[i]->path == path) {
+            return static_cast<SoundHandle>(i + 1);
+        }
+    }
+
+    POLARIS_PROFILE_SCOPE("AudioEngine::loadSound");
+    POLARIS_MEMORY_SCOPE(Audio);
+    MIX_AudioDecoder* decoder = MIX_CreateAudioDecoder(path.c_str(), 0);
+    if (!decoder) {
+        LOG_ERROR("Failed to open sound {}: {}", path, SDL_GetError());
+        return 0;
+    }
+
+    const SDL_AudioSpec spec = {SDL_AUDIO_F32, 2, m_config.sampleRate};
+    std::unique_ptr<Sound> sound = std::make_unique<Sound>();
+    sound->path = path;
+    for (;;) {
+        const std::size_t size = sound->samples.size();
+        sound->samples.resize(size + kLoadChunk);
+        const int bytes = MIX_DecodeAudio(decoder, sound->samples.data() + size,
+                                          static_cast<int>(kLoadChunk * sizeof(float)), &spec);
+        if (bytes <= 0) {
+            sound->samples.resize(size);
+            if (bytes < 0) {
+                LOG_ERROR("Failed to decode sound {}: {}", path, SDL_GetError());
+            }
+            break;
+        }
+        sound->samples.resize(size + static_cast<std::size_t>(bytes) / (2 * sizeof(float)) * 2);
+    }
+    MIX_DestroyAudioDecoder(decoder);
+
+    const std::size_t frames = sound->samples.size() / 2;
+    if (frames == 0 || frames > std::numeric_limits<std::uint32_t>::max()) {
+        LOG_ERROR("Sound {} is empty or too long", path);
+        return 0;
+    }
+    sound->samples.shrink_to_fit();
+    LOG_DEBUG("Loaded sound {}: {:.2f} s", path, static_cast<double>(frames) / m_config.sampleRate);
+    m_sounds.push_back(std::move(sound));
+    return static_cast<SoundHandle>(m_sounds.size());
+}
+
+VoiceHandle AudioEngine::play(SoundHandle sound, const VoiceParams& params) {
+    if (!m_stream || sound == 0 || sound > m_sounds.size() || params.bus == AudioBus::Count) {
+        return 0;
+    }
+    const Sound& data = *m_sounds[sound - 1];
+    const VoiceHandle voice = allocateVoice();
+
+    Command command = {};
+    command.type = CommandType::Play;
+    command.bus = params.bus;
+    command.loop = params.loop;
+    command.voice = voice;
+    command.samples = data.samples.data();
+    command.frames = static_cast<std::uint32_t>(data.samples.size() / 2);
+    command.volume = std::max(params.volume, 0.0f);
+    command.pan = std::min(std::max(params.pan, -1.0f), 1.0f);
+    if (!pushCommand(command)) {
+        const std::uint32_t slot = slotOf(voice);
+        m_slotHandles[slot] = 0;
+        m_freeSlots.push_back(slot);
+        return 0;
+    }
+    return voice;
+}
+
+void AudioEngine::stop(VoiceHandle voice) {
+    if (m_stream && voice != 0) {
+        Command command = {};
+        command.type = CommandType::Stop;
+        command.voice = voice;
+        pushCommand(command);
+    }
+}
+
+void AudioEngine::setVolume(VoiceHandle voice, float volume) {
+    if (m_stream && voice != 0) {
+        Command command = {};
+        command.type = CommandType::SetVolume;
+        command.voice = voice;
+        command.volume = std::max(volume, 0.0f);
+        pushCommand(command);
+    }
+}
+
+void AudioEngine::setPan(VoiceHandle voice, float pan) {
+    if (m_stream && voice != 0) {
+        Command command = {};
+        command.type = CommandType::SetPan;
+        command.voice = voice;
+        command.pan = std::min(std::max(pan, -1.0f), 1.0f);
+        pushCommand(command);
+    }
+}
+
+void AudioEngine::stopAll() {
+    if (m_stream) {
+        Command command = {};
+        command.type = CommandType::StopAll;
+        pushCommand(command);
+    }
+}
+
+bool AudioEngine::isPlaying(VoiceHandle voice) {
+    if (!m_stream || voice == 0) {
+        return false;
+    }
+    collectFinishedVoices();
+    const std::uint32_t slot = slotOf(voice);
+    return slot < m_slotHandles.size() && m_slotHandles[slot] == voice;
+}
+
+void AudioEngine::setBusVolume(AudioBus bus, float volume) {
+    if (m_stream && bus != AudioBus::Count) {
+        Command command = {};
+        command.type = CommandType::SetBusVolume;
+        command.bus = bus;
+        command.volume = std::max(volume, 0.0f);
+        pushCommand(command);
+    }
+}
+
+void AudioEngine::setMasterVolume(float volume) {
+    if (m_stream) {
+        // AudioBus::Count stands for the master volume
+        Command command = {};
+        command.type = CommandType::SetBusVolume;
+        command.bus = AudioBus::Count;
+        command.volume = std::max(volume, 0.0f);
+        pushCommand(command);
+    }
+}
+
+void AudioEngine::playMusic(const std::string& path, bool loop) {
+    if (m_stream) {
+        m_music.play(path, loop);
+    }
+}
+
+void AudioEngine::stopMusic() {
+    if (m_stream) {
+        m_music.stop();
+    }
+}
+
+AudioStats AudioEngine::takeStats() {
+    AudioStats stats;
+    stats.activeVoices = m_activeCount.load(std::memory_order_relaxed);
+    stats.peakVoices = std::max(m_peakVoices.exchange(stats.activeVoices, std::memory_order_relaxed),
+                                stats.activeVoices);
+    stats.voicesStarted = m_voicesStarted.exchange(0, std::memory_order_relaxed);
+    stats.voicesStolen = m_voicesStolen;
+    stats.commandsDropped = m_commandsDropped;
+    stats.callbacks = m_callbacks.exchange(0, std::memory_order_relaxed);
+    stats.lateCallbacks = m_lateCallbacks.exchange(0, std::memory_order_relaxed);
+    stats.mixSeconds = static_cast<double>(m_mixNanoseconds.exchange(0, std::memory_order_relaxed)) * 1e-9;
+    stats.maxCallbackMs = static_cast<double>(m_maxCallbackNanoseconds.exchange(0, std::memory_order_relaxed)) * 1e-6;
+    const std::uint64_t underruns = m_music.getUnderruns();
+    stats.musicUnderruns = underruns - m_musicUnderrunsTaken;
+    m_musicUnderrunsTaken = underruns;
+    m_voicesStolen = 0;
+    m_commandsDropped = 0;
+    return stats;
+}
+
+bool AudioEngine::pushCommand(const Command& command) {
+    if (!m_commands->tryPush(command)) {
+        ++m_commandsDropped;
+        return false;
+    }
+    return true;
+}
+
+/**
+ * @brief Returns the slots of voices the callback has finished to the free list, unless the
+ * slot has since been stolen for another voice.
+ */
+void AudioEngine::collectFinishedVoices() {
+    VoiceHandle voice = 0;
+    while (m_finished->tryPop(voice)) {
+        const std::uint32_t slot = slotOf(voice);
+        if (m_slotHandles[slot] == voice) {
+            m_slotHandles[slot] = 0;
+            m_freeSlots.push_back(slot);
+        }
+    }
+}
+
+/**
+ * @brief Takes a free slot, or steals the one started longest ago, and gives it a new handle:
+ * the slot in the low 16 bits and a nonzero generation in the high 16.
+ */
+VoiceHandle AudioEngine::allocateVoice() {
+    collectFinishedVoices();
+    std::uint32_t slot = 0;
+    if (!m_freeSlots.empty()) {
+        slot = m_freeSlots.back();
+        m_freeSlots.pop_back();
+    } else {
+        slot = static_cast<std::uint32_t>(std::min_element(m_slotStarted.begin(), m_slotStarted.end()) -
+                                          m_slotStarted.begin());
+        ++m_voicesStolen;
+    }
+
+    std::uint16_t& generation = m_slotGenerations[slot];
+    generation = static_cast<std::uint16_t>(generation == 0xFFFF ? 1 : generation + 1);
+    const VoiceHandle voice = (static_cast<VoiceHandle>(generation) << 16) | slot;
+    m_slotHandles[slot] = voice;
+    m_slotStarted[slot] = ++m_playSequence;
+    return voice;
+}
+
+void SDLCALL AudioEngine::audioCallback(void* userdata, SDL_AudioStream* stream, int additionalAmount, int) {
+    static_cast<AudioEngine*>(userdata)->mix(stream, additionalAmount);
+}
+
+/**
+ * @brief Audio callback: applies queued commands and renders the requested bytes block by
+ * block. Must not allocate, lock or wait.
+ */
+void AudioEngine::mix(SDL_AudioStream* stream, int bytes) {
+    if (bytes <= 0) {
+        return;
+    }
+    const std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    applyCommands();
+
+    std::size_t frames = (static_cast<std::size_t>(bytes) + 2 * sizeof(float) - 1) / (2 * sizeof(float));
+    const double seconds = static_cast<double>(frames) * m_blockSeconds / static_cast<double>(m_blockFrames);
+    while (frames > 0) {
+        const std::size_t count = std::min(frames, m_blockFrames);
+        renderBlock(count);
+        SDL_PutAudioStreamData(stream, m_output.data(), static_cast<int>(count * 2 * sizeof(float)));
+        frames -= count;
+    }
+
+    const std::uint64_t elapsed = static_cast<std::uint64_t>(
+        std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count());
+    m_callbacks.fetch_add(1, std::memory_order_relaxed);
+    m_mixNanoseconds.fetch_add(elapsed, std::memory_order_relaxed);
+    if (elapsed > m_maxCallbackNanoseconds.load(std::memory_order_relaxed)) {
+        m_maxCallbackNanoseconds.store(elapsed, std::memory_order_relaxed);
+    }
+    if (static_cast<double>(elapsed) * 1e-9 > seconds) {
+        m_lateCallbacks.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    const std::uint32_t active = static_cast<std::uint32_t>(m_activeVoices.size());
+    m_activeCount.store(active, std::memory_order_relaxed);
+    if (active > m_peakVoices.load(std::memory_order_relaxed)) {
+        m_peakVoices.store(active, std::memory_order_relaxed);
+    }
+}
+
+void AudioEngine::applyCommands() {
+    Command command;
+    while (m_commands->tryPop(command)) {
+        switch (command.type) {
+            case CommandType::Play: {
+                // A slot that is still playing was stolen by the game thread; replace its voice
+                const std::uint32_t slot = slotOf(command.voice);
+                Voice& voice = m_voices[slot];
+                if (voice.handle == 0) {
+                    voice.activeIndex = static_cast<std::uint32_t>(m_activeVoices.size());
+                    m_activeVoices.push_back(slot);
+                }
+                voice.handle = command.voice;
+                voice.samples = command.samples;
+                voice.frames = command.frames;
+                voice.position = 0;
+                voice.volume = command.volume;
+                voice.pan = command.pan;
+                panGains(voice.volume, voice.pan, voice.gains);
+                voice.bus = command.bus;
+                voice.loop = command.loop;
+                voice.stopping = false;
+                m_voicesStarted.fetch_add(1, std::memory_order_relaxed);
+                break;
+            }
+            case CommandType::Stop: {
+                Voice& voice = m_voices[slotOf(command.voice)];
+                if (voice.handle == command.voice) {
+                    // Fade out over the next block rather than cutting off mid-waveform
+                    voice.volume = 0.0f;
+                    voice.stopping = true;
+                }
+                break;
+            }
+            case CommandType::SetVolume: {
+                Voice& voice = m_voices[slotOf(command.voice)];
+                if (voice.handle == command.voice && !voice.stopping) {
+                    voice.volume = command.volume;
+                }
+                break;
+            }
+            case CommandType::SetPan: {
+                Voice& voice = m_voices[slotOf(command.voice)];
+                if (voice.handle == command.voice) {
+                    voice.pan = command.pan;
+                }
+                break;
+            }
+            case CommandType::SetBusVolume:
+                if (command.bus == AudioBus::Count) {
+                    m_masterVolume = command.volume;
+                } else {
+                    m_busVolumes[static_cast<std::size_t>(command.bus)] = command.volume;
+                }
+                break;
+            case CommandType::StopAll:
+                for (std::uint32_t slot : m_activeVoices) {
+                    m_voices[slot].volume = 0.0f;
+                    m_voices[slot].stopping = true;
+                }
+                break;
+        }
+    }
+}
+
+/**
+ * @brief Renders frames (at most one block) into m_output: voices into their buses, the
+ * music track into the music bus, then the buses into the output at their volumes.
+ */
+void AudioEngine::renderBlock(std::size_t frames) {
+    const std::size_t samples = frames * 2;
+    bool busUsed[kBusCount] = {};
+    std::fill(m_busBuffers.begin(), m_busBuffers.end(), 0.0f);
+
+    for (std::size_t i = 0; i < m_activeVoices.size();) {
+        const std::uint32_t slot = m_activeVoices[i];
+        Voice& voice = m_voices[slot];
+        busUsed[static_cast<std::size_t>(voice.bus)] = true;
+        if (mixVoice(voice, frames)) {
+            ++i;
+        } else {
+            releaseVoice(slot);   // Moves the last active voice to index i
+        }
+    }
+
+    // The output block is free until the buses are summed; borrow it for the music frames
+    const std::size_t musicFrames = m_music.read(m_output.data(), frames);
+    if (musicFrames > 0) {
+        const std::size_t music = static_cast<std::size_t>(AudioBus::Music);
+        const float unity[4] = {1.0f, 1.0f, 1.0f, 1.0f};
+        math::mixStereo(m_output.data(), m_busBuffers.data() + music * m_blockFrames * 2, musicFrames, unity);
+        busUsed[music] = true;
+    }
+
+    std::fill(m_output.begin(), m_output.begin() + static_cast<std::ptrdiff_t>(samples), 0.0f);
+    for (std::size_t bus = 0; bus < kBusCount; ++bus) {
+        const float target = m_busVolumes[bus] * m_masterVolume;
+        if (busUsed[bus] && (target > 0.0f || m_busGains[bus] > 0.0f)) {
+            const float gains[4] = {m_busGains[bus], m_busGains[bus], target, target};
+            math::mixStereo(m_busBuffers.data() + bus * m_blockFrames * 2, m_output.data(), frames, gains);
+        }
+        m_busGains[bus] = target;
+    }
+    math::clampSamples(m_output.data(), samples);
+}
+
+/**
+ * @brief Mixes one block of a voice, wrapping looped sounds, with its gains ramping from the
+ * last block's towards the current volume and pan.
+ */
+bool AudioEngine::mixVoice(Voice& voice, std::size_t frames) {
+    float target[2];
+    panGains(voice.volume, voice.pan, target);
+    const float blockFrames = static_cast<float>(frames);
+    const float stepLeft = (target[0] - voice.gains[0]) / blockFrames;
+    const float stepRight = (target[1] - voice.gains[1]) / blockFrames;
+    float* out = m_busBuffers.data() + static_cast<std::size_t>(voice.bus) * m_blockFrames * 2;
+
+    std::size_t done = 0;
+    while (done < frames) {
+        if (voice.position >= voice.frames) {
+            if (!voice.loop) {
+                break;
+            }
+            voice.position = 0;
+        }
+        const std::size_t count = std::min(frames - done, static_cast<std::size_t>(voice.frames - voice.position));
+        const float from = static_cast<float>(done);
+        const float to = static_cast<float>(done + count);
+        const float gains[4] = {voice.gains[0] + stepLeft * from, voice.gains[1] + stepRight * from,
+                                voice.gains[0] + stepLeft * to, voice.gains[1] + stepRight * to};
+        math::mixStereo(voice.samples + static_cast<std::size_t>(voice.position) * 2, out + done * 2, count, gains);
+        voice.position += static_cast<std::uint32_t>(count);
+        done += count;
+    }
+
+    voice.gains[0] = target[0];
+    voice.gains[1] = target[1];
+    return !voice.stopping && (voice.loop || voice.position < voice.frames);
+}
+
+/**
+ * @brief Removes a voice from the active list and reports its handle to the game thread.
+ */
+void AudioEngine::releaseVoice(std::uint32_t slot) {
+    Voice& voice = m_voices[slot];
+    const std::uint32_t last = m_activeVoices.back();
+    m_activeVoices[voice.activeIndex] = last;
+    m_voices[last].activeIndex = voice.activeIndex;
+    m_activeVoices.pop_back();
+
+    // Holds every handle the game thread can be waiting on, so this cannot fail
+    m_finished->tryPush(voice.handle);
+    voice.handle = 0;
+}
+
+} // namespace polaris
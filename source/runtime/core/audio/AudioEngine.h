@@ -0,0 +1,274 @@
+#ifndef POLARIS_AUDIOENGINE_H
+#define POLARIS_AUDIOENGINE_H
+
+#include "audio/MusicStream.h"
+#include "input/SpscQueue.h"
+#include <SDL3/SDL.h>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace polaris {
+
+/**
+ * @brief Mix buses. Every voice plays on one bus, and each bus has its own volume under the
+ * master volume, e.g. for separate music and effects sliders.
+ */
+enum class AudioBus : std::uint8_t {
+    Effects,
+    Music,      ///< Also carries the streamed music track.
+    Voice,
+    Interface,
+    Count
+};
+
+/**
+ * @brief Identifies a sound loaded by AudioEngine::loadSound. 0 means "no sound".
+ */
+using SoundHandle = std::uint32_t;
+
+/**
+ * @brief Identifies one playing instance of a sound. 0 means "no voice". Handles of voices
+ * that have finished or were stolen are ignored by every call taking one.
+ */
+using VoiceHandle = std::uint32_t;
+
+/**
+ * @brief Audio device and mixer settings read by AudioEngine::initialize.
+ */
+struct AudioConfig {
+    /**
+     * @brief Open an audio device at all; false makes every AudioEngine call a no-op.
+     */
+    bool enabled = true;
+    /**
+     * @brief Output sample rate. Sounds are converted to it when loaded, so the mixer never resamples.
+     */
+    int sampleRate = 48000;
+    /**
+     * @brief Device buffer size in frames, the main latency control: 512 frames is about 11 ms
+     * at 48 kHz. Also the size of the blocks the mixer renders.
+     */
+    int bufferFrames = 512;
+    /**
+     * @brief Size of the voice pool; playing more at once steals the oldest voice.
+     */
+    int maxVoices = 256;
+    /**
+     * @brief Commands (play, stop, volume...) that can be queued for the audio callback
+     * between two of its runs. Commands beyond that are dropped.
+     */
+    int commandQueueSize = 4096;
+    /**
+     * @brief Seconds of the music track decoded ahead of playback.
+     */
+    float musicBufferSeconds = 1.0f;
+};
+
+/**
+ * @brief Audio activity since the stats were last taken.
+ */
+struct AudioStats {
+    std::uint32_t activeVoices = 0;       ///< Voices playing when the stats were taken.
+    std::uint32_t peakVoices = 0;
+    std::uint64_t voicesStarted = 0;
+    std::uint64_t voicesStolen = 0;       ///< Voices cut off because the pool was full.
+    std::uint64_t commandsDropped = 0;    ///< Commands lost to a full command queue.
+    std::uint64_t callbacks = 0;
+    std::uint64_t lateCallbacks = 0;      ///< Callbacks that took longer to mix than the audio they produced.
+    std::uint64_t musicUnderruns = 0;     ///< Callbacks the music decoder could not keep up with.
+    double mixSeconds = 0.0;              ///< Time spent in the audio callback.
+    double maxCallbackMs = 0.0;
+};
+
+/**
+ * @brief Per-voice settings for AudioEngine::play.
+ */
+struct VoiceParams {
+    AudioBus bus = AudioBus::Effects;
+    float volume = 1.0f;
+    float pan = 0.0f;       ///< -1 is left, 0 centre and 1 right.
+    bool loop = false;
+};
+
+/**
+ * @brief Mixes sound effects and a streamed music track into an SDL audio device.
+ *
+ * Sounds are decoded with SDL_mixer's decoders into stereo float at the device rate when they
+ * are loaded. Music is decoded while it plays, on MusicStream's thread. The mixer itself runs
+ * in SDL's audio callback over a fixed pool of voices and never allocates, locks or waits:
+ * the game thread sends it commands through a lock-free single-producer queue, and it returns
+ * the handles of finished voices through another. Voices are summed per bus and the buses
+ * into the output with the batch SIMD kernels (math::mixStereo), with every gain change
+ * ramped over one block so it does not click.
+ *
+ * All methods other than the constructor are for one thread, normally the game thread.
+ * Headless runs use SDL's dummy audio driver; set SDL_AUDIO_DRIVER=disk to record the mix
+ * to a file instead.
+ */
+class AudioEngine {
+public:
+    AudioEngine();
+    ~AudioEngine();
+
+    AudioEngine(const AudioEngine&) = delete;
+    AudioEngine& operator=(const AudioEngine&) = delete;
+
+    /**
+     * @brief Opens the default playback device and starts mixing.
+     * @return false if audio is disabled or no device can be opened; the engine then runs
+     * silently, with every call a no-op.
+     */
+    bool initialize(const AudioConfig& config);
+
+    /**
+     * @brief Closes the device and frees every sound.
+     */
+    void shutdown();
+
+    bool isInitialized() const { return m_stream != nullptr; }
+
+    /**
+     * @brief Decodes a sound file (WAV, OGG, MP3, FLAC...) completely into memory. Loading the
+     * same path again returns the same handle. Sounds stay loaded until shutdown().
+     * @return The sound, or 0 if it cannot be decoded.
+     */
+    SoundHandle loadSound(const std::string& path);
+
+    /**
+     * @brief Starts playing a sound. Takes effect in the next audio callback.
+     * @return The voice, or 0 if the sound is invalid or the command could not be queued.
+     */
+    VoiceHandle play(SoundHandle sound, const VoiceParams& params = VoiceParams());
+
+    void stop(VoiceHandle voice);
+    void setVolume(VoiceHandle voice, float volume);
+    void setPan(VoiceHandle voice, float pan);
+
+    /**
+     * @brief Stops every voice; the music track keeps playing.
+     */
+    void stopAll();
+
+    /**
+     * @brief Whether a voice has not yet finished, as of the last audio callback.
+     */
+    bool isPlaying(VoiceHandle voice);
+
+    void setBusVolume(AudioBus bus, float volume);
+    void setMasterVolume(float volume);
+
+    /**
+     * @brief Streams a music file on the Music bus, replacing the current track.
+     */
+    void playMusic(const std::string& path, bool loop = true);
+    void stopMusic();
+
+    /**
+     * @brief Returns the counters accumulated since the last call and resets them.
+     */
+    AudioStats takeStats();
+
+private:
+    enum class CommandType : std::uint8_t {
+        Play,
+        Stop,
+        SetVolume,
+        SetPan,
+        SetBusVolume,
+        StopAll,
+    };
+
+    struct Command {
+        CommandType type;
+        AudioBus bus;
+        bool loop;
+        VoiceHandle voice;
+        const float* samples;     ///< Play: the sound's frames, which outlive every voice.
+        std::uint32_t frames;
+        float volume;             ///< Also the bus volume of SetBusVolume.
+        float pan;
+    };
+
+    struct Sound {
+        std::string path;
+        std::vector<float> samples;   ///< Interleaved stereo at the device rate.
+    };
+
+    /**
+     * @brief A pool slot, owned by the audio callback.
+     */
+    struct Voice {
+        VoiceHandle handle;
+        const float* samples;
+        std::uint32_t frames;
+        std::uint32_t position;
+        float volume;
+        float pan;
+        float gains[2];           ///< Left and right gains the last block ended on.
+        AudioBus bus;
+        bool loop;
+        bool stopping;            ///< Fading out over its last block.
+        std::uint32_t activeIndex;
+    };
+
+    static void SDLCALL audioCallback(void* userdata, SDL_AudioStream* stream, int additionalAmount, int totalAmount);
+
+    void mix(SDL_AudioStream* stream, int bytes);
+    void applyCommands();
+    void renderBlock(std::size_t frames);
+
+    /**
+     * @brief Mixes a voice into its bus. @return false once the voice has finished.
+     */
+    bool mixVoice(Voice& voice, std::size_t frames);
+    void releaseVoice(std::uint32_t slot);
+
+    bool pushCommand(const Command& command);
+    void collectFinishedVoices();
+    VoiceHandle allocateVoice();
+
+    AudioConfig m_config;
+    SDL_AudioStream* m_stream;
+    bool m_mixerInitialized;
+    std::vector<std::unique_ptr<Sound>> m_sounds;   ///< SoundHandle - 1 indexes this.
+    MusicStream m_music;
+
+    // Game thread side of the voice pool: which slots are taken and by which handle
+    std::unique_ptr<SpscQueue<Command>> m_commands;
+    std::unique_ptr<SpscQueue<VoiceHandle>> m_finished;
+    std::vector<VoiceHandle> m_slotHandles;          ///< 0 for free slots.
+    std::vector<std::uint64_t> m_slotStarted;        ///< play() sequence number, to find the oldest voice.
+    std::vector<std::uint32_t> m_freeSlots;
+    std::vector<std::uint16_t> m_slotGenerations;
+    std::uint64_t m_playSequence;
+    std::uint64_t m_commandsDropped;
+    std::uint64_t m_voicesStolen;
+
+    // Audio callback side; sized by initialize() and never reallocated while the device runs
+    std::vector<Voice> m_voices;
+    std::vector<std::uint32_t> m_activeVoices;       ///< Slots of playing voices.
+    std::vector<float> m_busBuffers;                 ///< One block per bus.
+    std::vector<float> m_output;
+    float m_busVolumes[static_cast<std::size_t>(AudioBus::Count)];
+    float m_busGains[static_cast<std::size_t>(AudioBus::Count)];   ///< Bus times master gain the last block ended on.
+    float m_masterVolume;
+    std::size_t m_blockFrames;
+    double m_blockSeconds;
+
+    std::atomic<std::uint32_t> m_activeCount;
+    std::atomic<std::uint32_t> m_peakVoices;
+    std::atomic<std::uint64_t> m_voicesStarted;
+    std::atomic<std::uint64_t> m_callbacks;
+    std::atomic<std::uint64_t> m_lateCallbacks;
+    std::atomic<std::uint64_t> m_mixNanoseconds;
+    std::atomic<std::uint64_t> m_maxCallbackNanoseconds;
+    std::uint64_t m_musicUnderrunsTaken;
+};
+
+} // namespace polaris
+
+#endif // POLARIS_AUDIOENGINE_H
@@ -0,0 +1,202 @@
+#include "audio/MusicStream.h"
+
+#include "Logger.h"
+#include "memory/MemoryTracker.h"
+#include "profiling/Profiler.h"
+#include <SDL3_mixer/SDL_mixer.h>
+#include <algorithm>
+#include <cstring>
+
+namespace polaris {
+
+namespace {
+
+/**
+ * @brief Frames decoded per MIX_DecodeAudio call.
+ */
+constexpr std::size_t kChunkFrames = 4096;
+
+} // namespace
+
+MusicStream::~MusicStream() {
+    shutdown();
+}
+
+void MusicStream::start(const SDL_AudioSpec& spec, std::size_t bufferFrames) {
+    POLARIS_MEMORY_SCOPE(Audio);
+    m_spec = spec;
+
+    std::size_t frames = kChunkFrames * 2;
+    while (frames < bufferFrames) {
+        frames *= 2;
+    }
+    m_ring.reset(new float[frames * 2]);
+    m_ringMask = frames * 2 - 1;
+    m_readPosition.store(0, std::memory_order_relaxed);
+    m_writePosition.store(0, std::memory_order_relaxed);
+    m_chunk.resize(kChunkFrames * 2);
+
+    // Top up about four times per buffer length, so the ring never gets close to empty
+    const long long bufferMilliseconds = static_cast<long long>(frames) * 1000 / std::max(spec.freq, 1);
+    m_refillInterval = std::chrono::milliseconds(std::min(std::max(bufferMilliseconds / 4, 5LL), 50LL));
+
+    m_stopping = false;
+    m_thread = std::thread(&MusicStream::decodeMain, this);
+}
+
+void MusicStream::shutdown() {
+    if (m_thread.joinable()) {
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_stopping = true;
+        }
+        m_changed.notify_all();
+        m_thread.join();
+    }
+    if (m_decoder) {
+        MIX_DestroyAudioDecoder(m_decoder);
+        m_decoder = nullptr;
+    }
+    m_streaming.store(false, std::memory_order_relaxed);
+}
+
+void MusicStream::play(const std::string& path, bool loop) {
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_requestPending = true;
+        m_pendingPath = path;
+        m_pendingLoop = loop;
+    }
+    m_changed.notify_all();
+}
+
+void MusicStream::stop() {
+    play(std::string(), false);
+}
+
+/**
+ * @brief Lock-free single-reader side of the ring; see the class comment.
+ */
+std::size_t MusicStream::read(float* out, std::size_t frames) {
+    if (!m_ring) {
+        return 0;
+    }
+    if (m_flushRequested.load(std::memory_order_acquire)) {
+        m_readPosition.store(m_writePosition.load(std::memory_order_acquire), std::memory_order_release);
+        m_flushRequested.store(false, std::memory_order_release);
+    }
+
+    const std::size_t read = m_readPosition.load(std::memory_order_relaxed);
+    const std::size_t available = (m_writePosition.load(std::memory_order_acquire) - read) / 2;
+    const std::size_t count = std::min(frames, available) * 2;
+    const std::size_t start = read & m_ringMask;
+    const std::size_t first = std::min(count, m_ringMask + 1 - start);
+    std::memcpy(out, m_ring.get() + start, first * sizeof(float));
+    std::memcpy(out + first, m_ring.get(), (count - first) * sizeof(float));
+    m_readPosition.store(read + count, std::memory_order_release);
+
+    if (count / 2 < frames && m_streaming.load(std::memory_order_relaxed)) {
+        m_underruns.fetch_add(1, std::memory_order_relaxed);
+    }
+    return count / 2;
+}
+
+/**
+ * @brief Decode thread: applies track requests and keeps the ring full, waking every
+ * m_refillInterval or when a request arrives.
+ */
+void MusicStream::decodeMain() {
+    POLARIS_PROFILE_THREAD("AudioDecode");
+    POLARIS_MEMORY_THREAD_TAG(Audio);
+    std::unique_lock<std::mutex> lock(m_mutex);
+
+    while (!m_stopping) {
+        if (m_requestPending) {
+            m_requestPending = false;
+            m_path = m_pendingPath;
+            m_loop = m_pendingLoop;
+            m_streaming.store(false, std::memory_order_relaxed);
+            if (m_decoder) {
+                MIX_DestroyAudioDecoder(m_decoder);
+                m_decoder = nullptr;
+            }
+            flush(lock);
+            if (!m_path.empty()) {
+                lock.unlock();
+                openTrack();
+                lock.lock();
+            }
+            continue;
+        }
+
+        if (m_decoder) {
+            lock.unlock();
+            bool more = fill();
+            if (!more && m_loop) {
+                // The decoder cannot rewind; reopening the file is cheap next to decoding it
+                MIX_DestroyAudioDecoder(m_decoder);
+                m_decoder = nullptr;
+                more = openTrack() && fill();
+            }
+            lock.lock();
+            if (!more && m_decoder) {
+                MIX_DestroyAudioDecoder(m_decoder);
+                m_decoder = nullptr;
+            }
+            m_streaming.store(m_decoder != nullptr, std::memory_order_relaxed);
+        }
+
+        m_changed.wait_for(lock, m_refillInterval, [this]() { return m_stopping || m_requestPending; });
+    }
+}
+
+void MusicStream::flush(std::unique_lock<std::mutex>& lock) {
+    m_flushRequested.store(true, std::memory_order_release);
+    while (m_flushRequested.load(std::memory_order_acquire) && !m_stopping) {
+        // Cleared by the audio callback's next read(), within one device buffer
+        m_changed.wait_for(lock, std::chrono::milliseconds(1));
+    }
+}
+
+bool MusicStream::openTrack() {
+    POLARIS_PROFILE_SCOPE("MusicStream::openTrack");
+    m_decoder = MIX_CreateAudioDecoder(m_path.c_str(), 0);
+    if (!m_decoder) {
+        LOG_ERROR("Failed to open music {}: {}", m_path, SDL_GetError());
+        return false;
+    }
+    LOG_DEBUG("Streaming music {}", m_path);
+    return true;
+}
+
+bool MusicStream::fill() {
+    POLARIS_PROFILE_SCOPE("MusicStream::fill");
+    const std::size_t capacity = m_ringMask + 1;
+    for (;;) {
+        const std::size_t write = m_writePosition.load(std::memory_order_relaxed);
+        const std::size_t space = capacity - (write - m_readPosition.load(std::memory_order_acquire));
+        if (space < m_chunk.size()) {
+            return true;
+        }
+
+        const int bytes = MIX_DecodeAudio(m_decoder, m_chunk.data(), static_cast<int>(m_chunk.size() * sizeof(float)),
+                                          &m_spec);
+        if (bytes < 0) {
+            LOG_ERROR("Failed to decode music {}: {}", m_path, SDL_GetError());
+            return false;
+        }
+        if (bytes == 0) {
+            return false;
+        }
+
+        const std::size_t count = static_cast<std::size_t>(bytes) / (2 * sizeof(float)) * 2;
+        const std::size_t start = write & m_ringMask;
+        const std::size_t first = std::min(count, capacity - start);
+        std::memcpy(m_ring.get() + start, m_chunk.data(), first * sizeof(float));
+        std::memcpy(m_ring.get(), m_chunk.data() + first, (count - first) * sizeof(float));
+        m_writePosition.store(write + count, std::memory_order_release);
+        m_streaming.store(true, std::memory_order_relaxed);
+    }
+}
+
+} // namespace polaris
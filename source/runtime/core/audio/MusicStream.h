@@ -0,0 +1,121 @@
+#ifndef POLARIS_MUSICSTREAM_H
+#define POLARIS_MUSICSTREAM_H
+
+#include <SDL3/SDL.h>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+typedef struct MIX_AudioDecoder MIX_AudioDecoder;
+
+namespace polaris {
+
+/**
+ * @brief Decodes one long track (music, ambience) at a time on a background thread, so it
+ * never has to be fully in memory and decoding never runs in the audio callback.
+ *
+ * The decode thread keeps a ring buffer of interleaved stereo float frames topped up, and the
+ * audio callback takes frames from it with read(). The ring is lock-free with exactly one
+ * writer (the decode thread) and one reader (the callback), so read() neither locks nor
+ * allocates. Switching or stopping tracks asks the reader to discard what is buffered, which
+ * it does on its next read().
+ *
+ * play() and stop() are for the game thread; read() is for the audio callback only.
+ */
+class MusicStream {
+public:
+    MusicStream() = default;
+    ~MusicStream();
+
+    MusicStream(const MusicStream&) = delete;
+    MusicStream& operator=(const MusicStream&) = delete;
+
+    /**
+     * @brief Allocates the ring buffer and starts the decode thread.
+     * @param spec Output format; must be stereo float.
+     * @param bufferFrames Frames decoded ahead of playback.
+     */
+    void start(const SDL_AudioSpec& spec, std::size_t bufferFrames);
+
+    /**
+     * @brief Stops the decode thread and closes the track. Call after the audio device is closed.
+     */
+    void shutdown();
+
+    /**
+     * @brief Replaces the current track; the file is opened on the decode thread.
+     * @param loop Start again from the beginning at the end of the file.
+     */
+    void play(const std::string& path, bool loop);
+
+    /**
+     * @brief Ends the current track.
+     */
+    void stop();
+
+    /**
+     * @brief Copies up to frames buffered frames to out. Audio callback only.
+     * @return The frames copied; fewer than requested while a track is playing means the
+     * decoder fell behind (counted by getUnderruns()).
+     */
+    std::size_t read(float* out, std::size_t frames);
+
+    /**
+     * @brief Reads that came up short while a track was playing.
+     */
+    std::uint64_t getUnderruns() const { return m_underruns.load(std::memory_order_relaxed); }
+
+private:
+    void decodeMain();
+
+    /**
+     * @brief Asks the reader to discard the buffer and waits until it has. Decode thread only.
+     */
+    void flush(std::unique_lock<std::mutex>& lock);
+
+    /**
+     * @brief Opens the pending track's decoder. Decode thread only.
+     */
+    bool openTrack();
+
+    /**
+     * @brief Decodes into the free part of the ring.
+     * @return false at the end of the track.
+     */
+    bool fill();
+
+    SDL_AudioSpec m_spec = {};
+    std::unique_ptr<float[]> m_ring;                ///< Interleaved stereo; a power of two of frames.
+    std::size_t m_ringMask = 0;                     ///< Ring size in floats, minus one.
+    std::atomic<std::size_t> m_readPosition{0};     ///< Floats read, written by read() only.
+    std::atomic<std::size_t> m_writePosition{0};    ///< Floats written, written by the decode thread only.
+    std::vector<float> m_chunk;                     ///< Decode thread's buffer for MIX_DecodeAudio.
+    std::chrono::milliseconds m_refillInterval{10};  ///< How often the decode thread tops the ring up.
+
+    std::atomic<bool> m_flushRequested{false};      ///< Set by the decode thread, cleared by read().
+    std::atomic<bool> m_streaming{false};           ///< A track is open and not yet fully decoded.
+    std::atomic<std::uint64_t> m_underruns{0};
+
+    std::thread m_thread;
+    std::mutex m_mutex;
+    std::condition_variable m_changed;
+    bool m_stopping = false;
+    bool m_requestPending = false;
+    std::string m_pendingPath;                      ///< Empty with a pending request means stop.
+    bool m_pendingLoop = false;
+
+    MIX_AudioDecoder* m_decoder = nullptr;          ///< Owned by the decode thread while it runs.
+    std::string m_path;
+    bool m_loop = false;
+};
+
+} // namespace polaris
+
+#endif // POLARIS_MUSICSTREAM_H
@@ -0,0 +1,54 @@
+#include "ecs/CommandBuffer.h"
+#include "ecs/World.h"
+
+namespace polaris {
+
+/**
+ * @brief Replays the buffer against the world. Values are read with memcpy, since the packed
+ * buffer keeps no alignment.
+ */
+void CommandBuffer::apply(World& world) {
+    std::size_t position = 0;
+    while (position < m_data.size()) {
+        Header header;
+        std::memcpy(&header, m_data.data() + position, sizeof(header));
+        position += sizeof(header);
+
+        switch (header.op) {
+            case Op::Create: {
+                // First pass: the component set; second pass: the values
+                ComponentMask mask = 0;
+                std::size_t scan = position;
+                for (std::uint32_t i = 0; i < header.componentCount; ++i) {
+                    ComponentId id;
+                    std::memcpy(&id, m_data.data() + scan, sizeof(id));
+                    mask |= ComponentMask(1) << id;
+                    scan += sizeof(id) + ComponentRegistry::info(id).size;
+                }
+                const Entity entity = world.createWithMask(mask);
+                for (std::uint32_t i = 0; i < header.componentCount; ++i) {
+                    ComponentId id;
+                    std::memcpy(&id, m_data.data() + position, sizeof(id));
+                    position += sizeof(id);
+                    const std::size_t size = ComponentRegistry::info(id).size;
+                    std::memcpy(world.getRaw(entity, id), m_data.data() + position, size);
+                    position += size;
+                }
+                break;
+            }
+            case Op::Destroy:
+                world.destroy(header.entity);
+                break;
+            case Op::Add:
+                world.addRaw(header.entity, header.component, m_data.data() + position);
+                position += ComponentRegistry::info(header.component).size;
+                break;
+            case Op::Remove:
+                world.removeRaw(header.entity, header.component);
+                break;
+        }
+    }
+    m_data.clear();
+}
+
+} // namespace polaris
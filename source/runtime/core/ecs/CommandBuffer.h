@@ -0,0 +1,91 @@
+#ifndef POLARIS_COMMANDBUFFER_H
+#define POLARIS_COMMANDBUFFER_H
+
+#include "ecs/Component.h"
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+namespace polaris {
+
+class World;
+
+/**
+ * @brief Records structural changes (create, destroy, add, remove) for a World to apply later,
+ * at a point where no system is iterating it.
+ *
+ * Commands are packed into one byte buffer whose storage is kept between frames, so recording
+ * does not allocate once the buffer has grown to its working size. Not thread-safe: each
+ * system gets its own buffer. Commands aimed at entities that are gone by the time they are
+ * applied are skipped.
+ */
+class CommandBuffer {
+public:
+    /**
+     * @brief Creates an entity with the given components when applied.
+     */
+    template <typename... C>
+    void create(const C&... components) {
+        writeHeader(Op::Create, Entity(), 0, static_cast<std::uint32_t>(sizeof...(C)));
+        (writeComponent(ComponentRegistry::id<C>(), &components, sizeof(C)), ...);
+    }
+
+    void destroy(Entity entity) {
+        writeHeader(Op::Destroy, entity, 0, 0);
+    }
+
+    /**
+     * @brief Adds a component, or overwrites it if the entity already has one.
+     */
+    template <typename C>
+    void add(Entity entity, const C& component = C()) {
+        writeHeader(Op::Add, entity, ComponentRegistry::id<C>(), 0);
+        append(&component, sizeof(C));
+    }
+
+    template <typename C>
+    void remove(Entity entity) {
+        writeHeader(Op::Remove, entity, ComponentRegistry::id<C>(), 0);
+    }
+
+    /**
+     * @brief Executes the recorded commands in order and clears the buffer.
+     */
+    void apply(World& world);
+
+    bool isEmpty() const { return m_data.empty(); }
+    void clear() { m_data.clear(); }
+
+private:
+    enum class Op : std::uint8_t { Create, Destroy, Add, Remove };
+
+    struct Header {
+        Op op;
+        Entity entity;
+        ComponentId component;
+        std::uint32_t componentCount;   ///< Create: number of (id, value) pairs that follow
+    };
+
+    void writeHeader(Op op, Entity entity, ComponentId component, std::uint32_t componentCount) {
+        const Header header{op, entity, component, componentCount};
+        append(&header, sizeof(header));
+    }
+
+    void writeComponent(ComponentId id, const void* data, std::size_t size) {
+        append(&id, sizeof(id));
+        append(data, size);
+    }
+
+    void append(const void* data, std::size_t size) {
+        const std::size_t offset = m_data.size();
+        m_data.resize(offset + size);
+        std::memcpy(m_data.data() + offset, data, size);
+    }
+
+    std::vector<unsigned char> m_data;
+};
+
+} // namespace polaris
+
+#endif // POLARIS_COMMANDBUFFER_H
@@ -0,0 +1,103 @@
+#ifndef POLARIS_COMPONENT_H
+#define POLARIS_COMPONENT_H
+
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+
+namespace polaris {
+
+/**
+ * @brief Handle of an entity in a World. The generation makes handles of destroyed entities
+ * stale rather than silently referring to whatever reuses the slot.
+ */
+struct Entity {
+    static constexpr std::uint32_t kInvalidIndex = 0xFFFFFFFFu;
+
+    std::uint32_t index = kInvalidIndex;
+    std::uint32_t generation = 0;
+
+    bool isValid() const { return index != kInvalidIndex; }
+    bool operator==(const Entity& other) const { return index == other.index && generation == other.generation; }
+    bool operator!=(const Entity& other) const { return !(*this == other); }
+};
+
+using ComponentId = std::uint32_t;
+
+/**
+ * @brief One bit per component type.
+ */
+using ComponentMask = std::uint64_t;
+
+/**
+ * @brief Upper bound on distinct component types, the width of ComponentMask.
+ */
+constexpr std::size_t kMaxComponentTypes = 64;
+
+/**
+ * @brief Largest component alignment; chunks are aligned to this.
+ */
+constexpr std::size_t kMaxComponentAlignment = 64;
+
+struct ComponentInfo {
+    std::size_t size;
+    std::size_t alignment;
+};
+
+/**
+ * @brief Assigns every component type a dense id on first use.
+ *
+ * Components are plain data: they must be trivially copyable, since chunks move them with
+ * memcpy and never run constructors or destructors.
+ */
+class ComponentRegistry {
+public:
+    template <typename C>
+    static ComponentId id() {
+        if constexpr (!std::is_same<C, std::remove_cv_t<C>>::value) {
+            // const C shares the id of C
+            return id<std::remove_cv_t<C>>();
+        } else {
+            static_assert(std::is_trivially_copyable<C>::value, "Components must be trivially copyable");
+            static_assert(alignof(C) <= kMaxComponentAlignment, "Component alignment exceeds the chunk alignment");
+            static const ComponentId componentId = registerType(sizeof(C), alignof(C));
+            return componentId;
+        }
+    }
+
+    static const ComponentInfo& info(ComponentId id);
+
+private:
+    /**
+     * @throws std::length_error if more than kMaxComponentTypes types are registered.
+     */
+    static ComponentId registerType(std::size_t size, std::size_t alignment);
+};
+
+/**
+ * @brief Mask of the given component types; cv-qualifiers are ignored.
+ */
+template <typename... C>
+ComponentMask componentMask() {
+    return (ComponentMask(0) | ... | (ComponentMask(1) << ComponentRegistry::id<C>()));
+}
+
+/**
+ * @brief Mask of the types in C... accessed read-only, i.e. declared const.
+ */
+template <typename... C>
+ComponentMask readMask() {
+    return (ComponentMask(0) | ... | (std::is_const<C>::value ? ComponentMask(1) << ComponentRegistry::id<C>() : 0));
+}
+
+/**
+ * @brief Mask of the types in C... accessed for writing, i.e. declared non-const.
+ */
+template <typename... C>
+ComponentMask writeMask() {
+    return (ComponentMask(0) | ... | (std::is_const<C>::value ? 0 : ComponentMask(1) << ComponentRegistry::id<C>()));
+}
+
+} // namespace polaris
+
+#endif // POLARIS_COMPONENT_H
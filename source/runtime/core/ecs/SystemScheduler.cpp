@@ -0,0 +1,77 @@
+#include "ecs/SystemScheduler.h"
+#include "profiling/Profiler.h"
+#include <algorithm>
+#include <utility>
+
+namespace polaris {
+
+/**
+ * @brief Appends a system and places it in the first stage after every earlier system it
+ * conflicts with.
+ */
+void SystemScheduler::addSystem(const char* name, ComponentMask reads, ComponentMask writes, SystemFunction function) {
+    std::size_t stage = 0;
+    for (std::size_t s = 0; s < m_stages.size(); ++s) {
+        for (std::size_t index : m_stages[s]) {
+            const System& other = m_systems[index];
+            const bool conflicts = (writes & (other.reads | other.writes)) != 0 || (other.writes & reads) != 0;
+            if (conflicts) {
+                stage = s + 1;
+            }
+        }
+    }
+
+    m_systems.push_back(System{name, reads, writes, std::move(function), CommandBuffer()});
+    if (stage == m_stages.size()) {
+        m_stages.emplace_back();
+    }
+    m_stages[stage].push_back(m_systems.size() - 1);
+}
+
+/**
+ * @brief Runs the stages in order, each stage's systems in parallel, with the world locked
+ * against structural changes; then plays back the command buffers.
+ */
+void SystemScheduler::run(World& world, JobSystem& jobs, double dt) {
+    world.lock();
+    try {
+        for (const std::vector<std::size_t>& stage : m_stages) {
+            if (stage.size() == 1) {
+                runSystem(m_systems[stage.front()], world, jobs, dt);
+                continue;
+            }
+            jobs.parallelFor(stage.size(), [&](std::size_t begin, std::size_t end) {
+                for (std::size_t i = begin; i < end; ++i) {
+                    runSystem(m_systems[stage[i]], world, jobs, dt);
+                }
+            });
+        }
+    } catch (...) {
+        world.unlock();
+        for (System& system : m_systems) {
+            system.commands.clear();
+        }
+        throw;
+    }
+    world.unlock();
+
+    POLARIS_PROFILE_SCOPE("SystemScheduler::applyCommands");
+    for (System& system : m_systems) {
+        if (!system.commands.isEmpty()) {
+            system.commands.apply(world);
+        }
+    }
+}
+
+void SystemScheduler::clear() {
+    std::vector<System>().swap(m_systems);
+    std::vector<std::vector<std::size_t>>().swap(m_stages);
+}
+
+void SystemScheduler::runSystem(System& system, World& world, JobSystem& jobs, double dt) {
+    POLARIS_PROFILE_SCOPE(system.name);
+    SystemContext context{world, system.commands, jobs, dt, system.reads, system.writes};
+    system.function(context);
+}
+
+} // namespace polaris
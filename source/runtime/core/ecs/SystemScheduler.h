@@ -0,0 +1,95 @@
+#ifndef POLARIS_SYSTEMSCHEDULER_H
+#define POLARIS_SYSTEMSCHEDULER_H
+
+#include "ecs/CommandBuffer.h"
+#include "ecs/World.h"
+#include "jobs/JobSystem.h"
+#include <cstddef>
+#include <functional>
+#include <stdexcept>
+#include <vector>
+
+namespace polaris {
+
+/**
+ * @brief What a system gets while it runs: the world, its own command buffer and the step length.
+ */
+struct SystemContext {
+    World& world;
+    CommandBuffer& commands;   ///< Structural changes; applied after all systems have run
+    JobSystem& jobs;           ///< For Query::eachParallel within the system
+    double dt;
+    ComponentMask reads;
+    ComponentMask writes;
+
+    /**
+     * @brief Query limited to the components the system declared.
+     * @throws std::logic_error if the query reads or writes a component the system did not
+     *         declare, since the scheduler could otherwise run it alongside a writer.
+     */
+    template <typename... C>
+    Query<C...> query() const {
+        if ((readMask<C...>() & ~(reads | writes)) != 0 || (writeMask<C...>() & ~writes) != 0) {
+            throw std::logic_error("System queries components it did not declare");
+        }
+        return world.query<C...>();
+    }
+};
+
+/**
+ * @brief Runs the registered systems once per simulation step, in parallel where their
+ * component access allows.
+ *
+ * Each system declares the components it touches, const for read-only access. Systems are
+ * grouped into stages: a system goes into the stage after the last earlier-registered system
+ * it conflicts with (one writes a component the other reads or writes), so registration order
+ * is kept wherever it matters and systems within a stage run concurrently on the job system.
+ * The world is locked while systems run; their command buffers are applied afterwards, in
+ * registration order.
+ */
+class SystemScheduler {
+public:
+    using SystemFunction = std::function<void(SystemContext&)>;
+
+    /**
+     * @brief Registers a system accessing the components C... (const for reads).
+     * @param name Name in profiler captures; must be a string literal.
+     */
+    template <typename... C, typename F>
+    void add(const char* name, F&& function) {
+        addSystem(name, readMask<C...>(), writeMask<C...>(), SystemFunction(std::forward<F>(function)));
+    }
+
+    void addSystem(const char* name, ComponentMask reads, ComponentMask writes, SystemFunction function);
+
+    /**
+     * @brief Runs every system once, then applies their command buffers.
+     */
+    void run(World& world, JobSystem& jobs, double dt);
+
+    /**
+     * @brief Removes all systems.
+     */
+    void clear();
+
+    std::size_t getSystemCount() const { return m_systems.size(); }
+    std::size_t getStageCount() const { return m_stages.size(); }
+
+private:
+    struct System {
+        const char* name;
+        ComponentMask reads;
+        ComponentMask writes;
+        SystemFunction function;
+        CommandBuffer commands;
+    };
+
+    void runSystem(System& system, World& world, JobSystem& jobs, double dt);
+
+    std::vector<System> m_systems;
+    std::vector<std::vector<std::size_t>> m_stages;   ///< System indices per stage
+};
+
+} // namespace polaris
+
+#endif // POLARIS_SYSTEMSCHEDULER_H
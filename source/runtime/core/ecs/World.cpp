@@ -0,0 +1,290 @@
+#include "ecs/World.h"
+#include <algorithm>
+#include <atomic>
+#include <stdexcept>
+#include <string>
+
+namespace polaris {
+
+namespace {
+
+ComponentInfo g_componentInfos[kMaxComponentTypes];
+std::atomic<ComponentId> g_componentCount{0};
+
+/**
+ * @brief Chunks are carved from the pool this many at a time (256 KB).
+ */
+constexpr std::size_t kChunksPerPoolBlock = 16;
+
+std::size_t alignUp(std::size_t value, std::size_t alignment) {
+    return (value + alignment - 1) & ~(alignment - 1);
+}
+
+} // namespace
+
+ComponentId ComponentRegistry::registerType(std::size_t size, std::size_t alignment) {
+    const ComponentId id = g_componentCount.fetch_add(1);
+    if (id >= kMaxComponentTypes) {
+        throw std::length_error("Too many component types; ComponentMask holds 64");
+    }
+    g_componentInfos[id] = ComponentInfo{size, alignment};
+    return id;
+}
+
+const ComponentInfo& ComponentRegistry::info(ComponentId id) {
+    return g_componentInfos[id];
+}
+
+/**
+ * @brief Creates the world with the empty archetype that component-less entities live in.
+ */
+World::World() : m_chunkPool(kChunkSize, kMaxComponentAlignment, kChunksPerPoolBlock) {
+    findArchetype(0);
+}
+
+World::~World() {
+    clear();
+}
+
+Entity World::create() {
+    return createWithMask(0);
+}
+
+/**
+ * @brief Creates an entity in the archetype for mask. Its components are left uninitialized.
+ */
+Entity World::createWithMask(ComponentMask mask) {
+    checkUnlocked("create");
+    const std::uint32_t archetype = findArchetype(mask);
+    const Entity entity = allocateEntity();
+    insertRow(archetype, entity);
+    ++m_entityCount;
+    return entity;
+}
+
+void World::destroy(Entity entity) {
+    checkUnlocked("destroy");
+    if (!isAlive(entity)) {
+        return;
+    }
+    EntityRecord& record = m_records[entity.index];
+    removeRow(record.archetype, record.chunk, record.row);
+    record.archetype = kNoArchetype;
+    ++record.generation;
+    m_freeIndices.push_back(entity.index);
+    --m_entityCount;
+}
+
+void World::addRaw(Entity entity, ComponentId id, const void* data) {
+    if (!isAlive(entity)) {
+        return;
+    }
+    const EntityRecord& record = m_records[entity.index];
+    if ((m_archetypes[record.archetype]->mask & (ComponentMask(1) << id)) == 0) {
+        checkUnlocked("add");
+        moveEntity(entity, findNeighbour(record.archetype, id));
+    }
+    std::memcpy(getRaw(entity, id), data, ComponentRegistry::info(id).size);
+}
+
+void World::removeRaw(Entity entity, ComponentId id) {
+    if (!isAlive(entity)) {
+        return;
+    }
+    const EntityRecord& record = m_records[entity.index];
+    if ((m_archetypes[record.archetype]->mask & (ComponentMask(1) << id)) != 0) {
+        checkUnlocked("remove");
+        moveEntity(entity, findNeighbour(record.archetype, id));
+    }
+}
+
+void* World::getRaw(Entity entity, ComponentId id) {
+    if (!isAlive(entity)) {
+        return nullptr;
+    }
+    const EntityRecord& record = m_records[entity.index];
+    const Archetype& archetype = *m_archetypes[record.archetype];
+    const int column = archetype.columnOf[id];
+    if (column < 0) {
+        return nullptr;
+    }
+    return archetype.component(archetype.chunks[record.chunk], static_cast<std::size_t>(column), record.row);
+}
+
+/**
+ * @brief Destroys every entity and returns all chunks; archetypes are kept.
+ */
+void World::clear() {
+    checkUnlocked("clear");
+    for (const std::unique_ptr<Archetype>& archetype : m_archetypes) {
+        for (const Chunk& chunk : archetype->chunks) {
+            m_chunkPool.deallocate(chunk.data);
+        }
+        std::vector<Chunk>().swap(archetype->chunks);
+        archetype->entityCount = 0;
+    }
+    for (std::uint32_t index = 0; index < m_records.size(); ++index) {
+        EntityRecord& record = m_records[index];
+        if (record.archetype != kNoArchetype) {
+            record.archetype = kNoArchetype;
+            ++record.generation;
+            m_freeIndices.push_back(index);
+        }
+    }
+    m_entityCount = 0;
+}
+
+/**
+ * @brief Returns the archetype for a component mask, creating it and its chunk layout if needed.
+ * @throws std::length_error if one entity's components do not fit in a chunk.
+ */
+std::uint32_t World::findArchetype(ComponentMask mask) {
+    const auto found = m_archetypeLookup.find(mask);
+    if (found != m_archetypeLookup.end()) {
+        return found->second;
+    }
+
+    std::unique_ptr<Archetype> archetype(new Archetype());
+    archetype->mask = mask;
+    std::fill(std::begin(archetype->columnOf), std::end(archetype->columnOf), static_cast<std::int8_t>(-1));
+    std::size_t bytesPerEntity = sizeof(Entity);
+    for (ComponentId id = 0; id < kMaxComponentTypes; ++id) {
+        if (mask & (ComponentMask(1) << id)) {
+            const ComponentInfo& info = ComponentRegistry::info(id);
+            archetype->columnOf[id] = static_cast<std::int8_t>(archetype->columns.size());
+            archetype->columns.push_back(Column{id, 0, static_cast<std::uint32_t>(info.size)});
+            bytesPerEntity += info.size;
+        }
+    }
+
+    // As many entities as fit once every array is aligned: entity handles first, then one
+    // array per component
+    std::uint32_t capacity = static_cast<std::uint32_t>(kChunkSize / bytesPerEntity);
+    for (; capacity > 0; --capacity) {
+        std::size_t offset = sizeof(Entity) * capacity;
+        for (Column& column : archetype->columns) {
+            offset = alignUp(offset, ComponentRegistry::info(column.id).alignment);
+            column.offset = static_cast<std::uint32_t>(offset);
+            offset += static_cast<std::size_t>(column.size) * capacity;
+        }
+        if (offset <= kChunkSize) {
+            break;
+        }
+    }
+    if (capacity == 0) {
+        throw std::length_error("Entity components do not fit in a 16 KB chunk");
+    }
+    archetype->capacity = capacity;
+
+    const std::uint32_t index = static_cast<std::uint32_t>(m_archetypes.size());
+    m_archetypes.push_back(std::move(archetype));
+    m_archetypeLookup.emplace(mask, index);
+    return index;
+}
+
+/**
+ * @brief Archetype with component id toggled, cached on the source archetype.
+ */
+std::uint32_t World::findNeighbour(std::uint32_t archetype, ComponentId id) {
+    for (const auto& edge : m_archetypes[archetype]->edges) {
+        if (edge.first == id) {
+            return edge.second;
+        }
+    }
+    const std::uint32_t target = findArchetype(m_archetypes[archetype]->mask ^ (ComponentMask(1) << id));
+    m_archetypes[archetype]->edges.emplace_back(id, target);
+    return target;
+}
+
+Entity World::allocateEntity() {
+    Entity entity;
+    if (!m_freeIndices.empty()) {
+        entity.index = m_freeIndices.back();
+        m_freeIndices.pop_back();
+    } else {
+        entity.index = static_cast<std::uint32_t>(m_records.size());
+        m_records.push_back(EntityRecord{kNoArchetype, 0, 0, 0});
+    }
+    entity.generation = m_records[entity.index].generation;
+    return entity;
+}
+
+/**
+ * @brief Appends an entity to the archetype's last chunk (taking a new chunk if it is full)
+ * and points its record there. Component values are left uninitialized.
+ */
+void World::insertRow(std::uint32_t archetypeIndex, Entity entity) {
+    Archetype& archetype = *m_archetypes[archetypeIndex];
+    if (archetype.chunks.empty() || archetype.chunks.back().count == archetype.capacity) {
+        archetype.chunks.push_back(Chunk{static_cast<unsigned char*>(m_chunkPool.allocate()), 0});
+    }
+    Chunk& chunk = archetype.chunks.back();
+    const std::uint32_t row = chunk.count++;
+    archetype.entities(chunk)[row] = entity;
+    ++archetype.entityCount;
+
+    EntityRecord& record = m_records[entity.index];
+    record.archetype = archetypeIndex;
+    record.chunk = static_cast<std::uint32_t>(archetype.chunks.size() - 1);
+    record.row = row;
+}
+
+/**
+ * @brief Fills the hole left by a removed row with the archetype's last entity, and returns
+ * the last chunk to the pool once it is empty.
+ */
+void World::removeRow(std::uint32_t archetypeIndex, std::uint32_t chunkIndex, std::uint32_t row) {
+    Archetype& archetype = *m_archetypes[archetypeIndex];
+    Chunk& last = archetype.chunks.back();
+    const std::uint32_t lastChunk = static_cast<std::uint32_t>(archetype.chunks.size() - 1);
+    const std::uint32_t lastRow = last.count - 1;
+
+    if (chunkIndex != lastChunk || row != lastRow) {
+        Chunk& chunk = archetype.chunks[chunkIndex];
+        const Entity moved = archetype.entities(last)[lastRow];
+        archetype.entities(chunk)[row] = moved;
+        for (std::size_t column = 0; column < archetype.columns.size(); ++column) {
+            std::memcpy(archetype.component(chunk, column, row), archetype.component(last, column, lastRow),
+                        archetype.columns[column].size);
+        }
+        m_records[moved.index].chunk = chunkIndex;
+        m_records[moved.index].row = row;
+    }
+
+    --archetype.entityCount;
+    if (--last.count == 0) {
+        m_chunkPool.deallocate(last.data);
+        archetype.chunks.pop_back();
+    }
+}
+
+/**
+ * @brief Moves an entity to another archetype, copying the components both have in common.
+ */
+void World::moveEntity(Entity entity, std::uint32_t target) {
+    const EntityRecord source = m_records[entity.index];
+    insertRow(target, entity);
+
+    const Archetype& from = *m_archetypes[source.archetype];
+    const Archetype& to = *m_archetypes[target];
+    const EntityRecord& destination = m_records[entity.index];
+    for (std::size_t column = 0; column < to.columns.size(); ++column) {
+        const int sourceColumn = from.columnOf[to.columns[column].id];
+        if (sourceColumn >= 0) {
+            std::memcpy(to.component(to.chunks[destination.chunk], column, destination.row),
+                        from.component(from.chunks[source.chunk], static_cast<std::size_t>(sourceColumn), source.row),
+                        to.columns[column].size);
+        }
+    }
+
+    removeRow(source.archetype, source.chunk, source.row);
+}
+
+void World::checkUnlocked(const char* operation) const {
+    if (m_locked) {
+        throw std::logic_error(std::string("World::") + operation +
+                               " while systems are running; record it in a CommandBuffer instead");
+    }
+}
+
+} // namespace polaris
@@ -0,0 +1,299 @@
+#ifndef POLARIS_WORLD_H
+#define POLARIS_WORLD_H
+
+#include "ecs/Component.h"
+#include "jobs/JobSystem.h"
+#include "memory/PoolAllocator.h"
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <tuple>
+#include <type_traits>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace polaris {
+
+template <typename... C>
+class Query;
+
+/**
+ * @brief Entity-component store with archetype chunks.
+ *
+ * Entities with the same set of component types share an archetype. An archetype keeps its
+ * entities in 16 KB chunks laid out as structure-of-arrays: the entity handles, then one
+ * contiguous array per component type. Queries walk the matching archetypes chunk by chunk,
+ * so iteration reads memory linearly. Removing an entity moves the archetype's last entity
+ * into the hole, so every chunk but the last is full.
+ *
+ * Adding or removing components moves the entity to another archetype. Such structural
+ * changes are not allowed while systems run (see lock()); record them in a CommandBuffer.
+ * Reading and writing component values is fine at any time, as long as no two threads write
+ * the same component type, which the SystemScheduler guarantees.
+ */
+class World {
+public:
+    static constexpr std::size_t kChunkSize = 16 * 1024;
+
+    World();
+    ~World();
+
+    World(const World&) = delete;
+    World& operator=(const World&) = delete;
+
+    /**
+     * @brief Creates an entity without components.
+     */
+    Entity create();
+
+    /**
+     * @brief Creates an entity with the given components.
+     */
+    template <typename... C>
+    Entity create(const C&... components) {
+        const Entity entity = createWithMask(componentMask<C...>());
+        (std::memcpy(getRaw(entity, ComponentRegistry::id<C>()), &components, sizeof(C)), ...);
+        return entity;
+    }
+
+    /**
+     * @brief Destroys an entity. Stale handles are ignored.
+     */
+    void destroy(Entity entity);
+
+    bool isAlive(Entity entity) const {
+        return entity.index < m_records.size() && m_records[entity.index].generation == entity.generation &&
+               m_records[entity.index].archetype != kNoArchetype;
+    }
+
+    /**
+     * @brief Adds a component, or overwrites it if the entity already has one.
+     */
+    template <typename C>
+    void add(Entity entity, const C& component = C()) {
+        addRaw(entity, ComponentRegistry::id<C>(), &component);
+    }
+
+    template <typename C>
+    void remove(Entity entity) {
+        removeRaw(entity, ComponentRegistry::id<C>());
+    }
+
+    template <typename C>
+    bool has(Entity entity) const {
+        return isAlive(entity) &&
+               (m_archetypes[m_records[entity.index].archetype]->mask & componentMask<C>()) != 0;
+    }
+
+    /**
+     * @brief Returns the entity's component, or null if it has none or the handle is stale.
+     * The pointer is invalidated by the next structural change.
+     */
+    template <typename C>
+    C* get(Entity entity) {
+        return static_cast<C*>(getRaw(entity, ComponentRegistry::id<C>()));
+    }
+
+    /**
+     * @brief Query over every entity that has all of C... Declare read-only components const.
+     */
+    template <typename... C>
+    Query<C...> query() {
+        return Query<C...>(*this);
+    }
+
+    /**
+     * @brief Destroys every entity and frees the chunk memory.
+     */
+    void clear();
+
+    std::size_t getEntityCount() const { return m_entityCount; }
+    std::size_t getArchetypeCount() const { return m_archetypes.size(); }
+
+    /**
+     * @brief While locked, structural changes throw std::logic_error. The SystemScheduler
+     * locks the world while systems run.
+     */
+    void lock() { m_locked = true; }
+    void unlock() { m_locked = false; }
+    bool isLocked() const { return m_locked; }
+
+    /**
+     * @brief Type-erased forms of create/add/remove/get, used by CommandBuffer.
+     * addRaw copies ComponentRegistry::info(id).size bytes from data.
+     */
+    Entity createWithMask(ComponentMask mask);
+    void addRaw(Entity entity, ComponentId id, const void* data);
+    void removeRaw(Entity entity, ComponentId id);
+    void* getRaw(Entity entity, ComponentId id);
+
+private:
+    template <typename... C>
+    friend class Query;
+
+    static constexpr std::uint32_t kNoArchetype = 0xFFFFFFFFu;
+
+    struct Chunk {
+        unsigned char* data;
+        std::uint32_t count;
+    };
+
+    struct Column {
+        ComponentId id;
+        std::uint32_t offset;   ///< Start of the component array within a chunk
+        std::uint32_t size;
+    };
+
+    struct Archetype {
+        ComponentMask mask = 0;
+        std::uint32_t capacity = 0;     ///< Entities per chunk
+        std::vector<Column> columns;
+        std::int8_t columnOf[kMaxComponentTypes];   ///< Index into columns, or -1
+        std::vector<Chunk> chunks;
+        std::size_t entityCount = 0;
+        /// Archetype reached by adding or removing one component, filled in on first use
+        std::vector<std::pair<ComponentId, std::uint32_t>> edges;
+
+        Entity* entities(const Chunk& chunk) const { return reinterpret_cast<Entity*>(chunk.data); }
+        void* component(const Chunk& chunk, std::size_t column, std::uint32_t row) const {
+            return chunk.data + columns[column].offset + static_cast<std::size_t>(columns[column].size) * row;
+        }
+    };
+
+    struct EntityRecord {
+        std::uint32_t archetype;
+        std::uint32_t chunk;
+        std::uint32_t row;
+        std::uint32_t generation;
+    };
+
+    std::uint32_t findArchetype(ComponentMask mask);
+    std::uint32_t findNeighbour(std::uint32_t archetype, ComponentId id);
+    Entity allocateEntity();
+    void insertRow(std::uint32_t archetype, Entity entity);
+    void removeRow(std::uint32_t archetype, std::uint32_t chunk, std::uint32_t row);
+    void moveEntity(Entity entity, std::uint32_t target);
+    void checkUnlocked(const char* operation) const;
+
+    std::vector<std::unique_ptr<Archetype>> m_archetypes;
+    std::unordered_map<ComponentMask, std::uint32_t> m_archetypeLookup;
+    std::vector<EntityRecord> m_records;
+    std::vector<std::uint32_t> m_freeIndices;
+    std::size_t m_entityCount = 0;
+    PoolAllocator m_chunkPool;
+    bool m_locked = false;
+};
+
+/**
+ * @brief Iterates the entities that have every component in C..., chunk by chunk.
+ *
+ * Declare components that are only read as const, e.g. query<Position, const Velocity>();
+ * the SystemScheduler uses that to decide which systems may run in parallel.
+ */
+template <typename... C>
+class Query {
+public:
+    explicit Query(World& world) : m_world(&world), m_mask(componentMask<C...>()) {}
+
+    /**
+     * @brief Calls function(C&...) or function(Entity, C&...) for every matching entity.
+     */
+    template <typename F>
+    void each(F&& function) const {
+        for (const std::unique_ptr<World::Archetype>& archetype : m_world->m_archetypes) {
+            if (!visits(*archetype)) {
+                continue;
+            }
+            for (const World::Chunk& chunk : archetype->chunks) {
+                eachInChunk(*archetype, chunk, function, std::index_sequence_for<C...>());
+            }
+        }
+    }
+
+    /**
+     * @brief Like each(), spreading the chunks over the job system's threads. The function is
+     * called concurrently, so it must only touch the entity it is given.
+     */
+    template <typename F>
+    void eachParallel(JobSystem& jobs, F&& function) const {
+        const std::size_t chunkCount = getChunkCount();
+        jobs.parallelFor(chunkCount, [this, &function](std::size_t begin, std::size_t end) {
+            std::size_t index = 0;
+            for (const std::unique_ptr<World::Archetype>& archetype : m_world->m_archetypes) {
+                if (!visits(*archetype)) {
+                    continue;
+                }
+                const std::size_t chunks = archetype->chunks.size();
+                if (index + chunks > begin) {
+                    for (std::size_t c = begin > index ? begin - index : 0; c < chunks && index + c < end; ++c) {
+                        eachInChunk(*archetype, archetype->chunks[c], function, std::index_sequence_for<C...>());
+                    }
+                }
+                index += chunks;
+                if (index >= end) {
+                    break;
+                }
+            }
+        });
+    }
+
+    /**
+     * @brief Number of matching entities.
+     */
+    std::size_t count() const {
+        std::size_t total = 0;
+        for (const std::unique_ptr<World::Archetype>& archetype : m_world->m_archetypes) {
+            if ((archetype->mask & m_mask) == m_mask) {
+                total += archetype->entityCount;
+            }
+        }
+        return total;
+    }
+
+private:
+    /**
+     * @brief Whether iteration walks an archetype: it must match and hold entities. Shared by
+     * eachParallel() and getChunkCount(), so the chunk ranges handed to the jobs line up.
+     */
+    bool visits(const World::Archetype& archetype) const {
+        return (archetype.mask & m_mask) == m_mask && archetype.entityCount != 0;
+    }
+
+    std::size_t getChunkCount() const {
+        std::size_t total = 0;
+        for (const std::unique_ptr<World::Archetype>& archetype : m_world->m_archetypes) {
+            if (visits(*archetype)) {
+                total += archetype->chunks.size();
+            }
+        }
+        return total;
+    }
+
+    template <typename F, std::size_t... I>
+    static void eachInChunk(const World::Archetype& archetype, const World::Chunk& chunk, F& function,
+                            std::index_sequence<I...>) {
+        // One base pointer per component array; the loop below then walks them in lockstep
+        std::tuple<C*...> arrays(reinterpret_cast<C*>(
+            chunk.data + archetype.columns[static_cast<std::size_t>(archetype.columnOf[ComponentRegistry::id<C>()])].offset)...);
+        const std::size_t count = chunk.count;
+        if constexpr (std::is_invocable<F&, Entity, C&...>::value) {
+            const Entity* entities = archetype.entities(chunk);
+            for (std::size_t i = 0; i < count; ++i) {
+                function(entities[i], std::get<I>(arrays)[i]...);
+            }
+        } else {
+            for (std::size_t i = 0; i < count; ++i) {
+                function(std::get<I>(arrays)[i]...);
+            }
+        }
+    }
+
+    World* m_world;
+    ComponentMask m_mask;
+};
+
+} // namespace polaris
+
+#endif // POLARIS_WORLD_H
@@ -0,0 +1,209 @@
+#ifndef POLARIS_EVENTBUS_H
+#define POLARIS_EVENTBUS_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <utility>
+#include <vector>
+
+namespace polaris {
+
+/**
+ * @brief Delivers events of any type to the handlers subscribed to that type.
+ *
+ * Handlers are stored per event type in contiguous arrays, found by a per-type index rather
+ * than a map lookup, and called directly by publish(); nothing is allocated per event, only
+ * when subscribing. Main thread only: other threads hand events over through
+ * InputSystem::postEvent.
+ *
+ * Handlers may subscribe and unsubscribe from inside a handler. Unsubscribed handlers are not
+ * called again; new subscriptions take effect from the next publish().
+ */
+class EventBus {
+public:
+    using SubscriptionId = std::uint32_t;
+
+    EventBus() = default;
+    EventBus(const EventBus&) = delete;
+    EventBus& operator=(const EventBus&) = delete;
+
+    /**
+     * @brief Subscribes a callable taking const Event&.
+     * @return Id for unsubscribe(), never 0.
+     */
+    template <typename Event, typename F>
+    SubscriptionId subscribe(F&& handler) {
+        Channel<Event>& channel = getChannel<Event>();
+        const SubscriptionId id = ++m_lastId;
+        if (channel.dispatching > 0) {
+            channel.pending.push_back({id, std::function<void(const Event&)>(std::forward<F>(handler))});
+        } else {
+            channel.handlers.push_back({id, std::function<void(const Event&)>(std::forward<F>(handler))});
+        }
+        m_subscriptionTypes.push_back({id, typeIndex<Event>()});
+        return id;
+    }
+
+    /**
+     * @brief Removes a subscription. Unknown ids are ignored.
+     */
+    void unsubscribe(SubscriptionId id) {
+        for (std::size_t i = 0; i < m_subscriptionTypes.size(); ++i) {
+            if (m_subscriptionTypes[i].first == id) {
+                m_channels[m_subscriptionTypes[i].second]->remove(id);
+                m_subscriptionTypes[i] = m_subscriptionTypes.back();
+                m_subscriptionTypes.pop_back();
+                return;
+            }
+        }
+    }
+
+    /**
+     * @brief Removes every subscription and frees the handler storage. Not from inside a handler.
+     */
+    void clear() {
+        std::vector<std::unique_ptr<ChannelBase>>().swap(m_channels);
+        std::vector<std::pair<SubscriptionId, std::size_t>>().swap(m_subscriptionTypes);
+    }
+
+    /**
+     * @brief Calls every handler subscribed to Event, in subscription order.
+     */
+    template <typename Event>
+    void publish(const Event& event) {
+        publish(&event, 1);
+    }
+
+    /**
+     * @brief Publishes a batch of events; cheaper than publishing them one by one.
+     */
+    template <typename Event>
+    void publish(const Event* events, std::size_t count) {
+        const std::size_t index = typeIndex<Event>();
+        if (count == 0 || index >= m_channels.size() || !m_channels[index]) {
+            return;
+        }
+
+        Channel<Event>& channel = static_cast<Channel<Event>&>(*m_channels[index]);
+        ++channel.dispatching;
+        for (std::size_t e = 0; e < count; ++e) {
+            for (std::size_t h = 0; h < channel.handlers.size(); ++h) {
+                if (channel.handlers[h].first != 0) {
+                    channel.handlers[h].second(events[e]);
+                }
+            }
+        }
+        if (--channel.dispatching == 0) {
+            channel.settle();
+        }
+    }
+
+    /**
+     * @brief True if at least one handler is subscribed to Event.
+     */
+    template <typename Event>
+    bool hasSubscribers() const {
+        const std::size_t index = typeIndex<Event>();
+        return index < m_channels.size() && m_channels[index] && !m_channels[index]->empty();
+    }
+
+private:
+    struct ChannelBase {
+        virtual ~ChannelBase() = default;
+        virtual void remove(SubscriptionId id) = 0;
+        virtual bool empty() const = 0;
+    };
+
+    template <typename Event>
+    struct Channel : ChannelBase {
+        using Handler = std::pair<SubscriptionId, std::function<void(const Event&)>>;
+
+        std::vector<Handler> handlers;  ///< Id 0 marks a handler removed during dispatch
+        std::vector<Handler> pending;   ///< Subscribed during dispatch
+        int dispatching = 0;
+
+        void remove(SubscriptionId id) override {
+            for (Handler& handler : handlers) {
+                if (handler.first == id) {
+                    handler.first = 0;
+                }
+            }
+            for (Handler& handler : pending) {
+                if (handler.first == id) {
+                    handler.first = 0;
+                }
+            }
+            if (dispatching == 0) {
+                settle();
+            }
+        }
+
+        bool empty() const override {
+            for (const Handler& handler : handlers) {
+                if (handler.first != 0) {
+                    return false;
+                }
+            }
+            return true;
+        }
+
+        /**
+         * @brief Drops removed handlers and appends those subscribed during dispatch.
+         */
+        void settle() {
+            std::size_t kept = 0;
+            for (std::size_t i = 0; i < handlers.size(); ++i) {
+                if (handlers[i].first != 0) {
+                    if (kept != i) {
+                        handlers[kept] = std::move(handlers[i]);
+                    }
+                    ++kept;
+                }
+            }
+            handlers.resize(kept);
+            for (Handler& handler : pending) {
+                if (handler.first != 0) {
+                    handlers.push_back(std::move(handler));
+                }
+            }
+            pending.clear();
+        }
+    };
+
+    static std::size_t nextTypeIndex() {
+        static std::atomic<std::size_t> next{0};
+        return next.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    /**
+     * @brief Dense index of an event type, assigned on first use.
+     */
+    template <typename Event>
+    static std::size_t typeIndex() {
+        static const std::size_t index = nextTypeIndex();
+        return index;
+    }
+
+    template <typename Event>
+    Channel<Event>& getChannel() {
+        const std::size_t index = typeIndex<Event>();
+        if (index >= m_channels.size()) {
+            m_channels.resize(index + 1);
+        }
+        if (!m_channels[index]) {
+            m_channels[index] = std::make_unique<Channel<Event>>();
+        }
+        return static_cast<Channel<Event>&>(*m_channels[index]);
+    }
+
+    std::vector<std::unique_ptr<ChannelBase>> m_channels;
+    std::vector<std::pair<SubscriptionId, std::size_t>> m_subscriptionTypes;
+    SubscriptionId m_lastId = 0;
+};
+
+} // namespace polaris
+
+#endif // POLARIS_EVENTBUS_H
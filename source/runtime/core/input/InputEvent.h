@@ -0,0 +1,114 @@
+#ifndef POLARIS_INPUTEVENT_H
+#define POLARIS_INPUTEVENT_H
+
+#include <SDL3/SDL.h>
+#include <bitset>
+#include <cstdint>
+
+namespace polaris {
+
+enum class InputEventType : std::uint8_t {
+    Quit,
+    WindowResized,      ///< x, y: new size
+    WindowFocusGained,
+    WindowFocusLost,
+    WindowExposed,      ///< The window's contents were lost and must be redrawn
+    KeyDown,            ///< code: SDL_Scancode, modifiers, repeat
+    KeyUp,              ///< code: SDL_Scancode, modifiers
+    MouseMotion,        ///< x, y: position; dx, dy: motion since the previous event
+    MouseButtonDown,    ///< code: SDL mouse button; x, y: position
+    MouseButtonUp,      ///< code: SDL mouse button; x, y: position
+    MouseWheel,         ///< x, y: scroll amount
+    GamepadAdded,       ///< device: gamepad slot
+    GamepadRemoved,     ///< device: gamepad slot
+    GamepadButtonDown,  ///< device: gamepad slot; code: SDL_GamepadButton
+    GamepadButtonUp,    ///< device: gamepad slot; code: SDL_GamepadButton
+    GamepadAxis         ///< device: gamepad slot; code: SDL_GamepadAxis; x: value in [-1, 1]
+};
+
+/**
+ * @brief One input event of a frame, translated from SDL_Event.
+ *
+ * 32 bytes instead of SDL_Event's 128, so a frame's events sit in a few cache lines.
+ * Consecutive mouse motion, mouse wheel and same-axis gamepad events are merged into one,
+ * so a 1000 Hz mouse or a jittery stick adds one event per frame rather than dozens.
+ */
+struct InputEvent {
+    InputEventType type;
+    std::uint8_t device;        ///< Gamepad slot, see InputSystem::kMaxGamepads
+    std::uint16_t code;         ///< Scancode, mouse/gamepad button or gamepad axis
+    std::uint16_t modifiers;    ///< SDL_Keymod at the time of a key event
+    bool repeat;                ///< Key repeat
+    std::uint8_t merged;        ///< Number of SDL events merged into this one, minus one (saturating)
+    float x;
+    float y;
+    float dx;
+    float dy;
+    std::uint32_t timestampMs;  ///< SDL timestamp in milliseconds
+    std::uint32_t reserved;
+};
+
+static_assert(sizeof(InputEvent) == 32, "InputEvent should stay two per cache line");
+
+/**
+ * @brief An event posted from any thread with InputSystem::postEvent and delivered on the
+ * main thread at the start of the next frame. The meaning of id and the payload is up to
+ * the application.
+ */
+struct EngineEvent {
+    std::uint32_t id;
+    std::uint32_t arg;
+    std::uint64_t data;
+};
+
+/**
+ * @brief Keyboard state at the start of the frame, after this frame's events.
+ */
+struct KeyboardState {
+    std::bitset<SDL_SCANCODE_COUNT> down;
+    std::bitset<SDL_SCANCODE_COUNT> pressed;    ///< Went down during the last poll
+    std::bitset<SDL_SCANCODE_COUNT> released;   ///< Went up during the last poll
+    std::uint16_t modifiers = 0;
+
+    bool isDown(SDL_Scancode key) const { return down.test(key); }
+    bool wasPressed(SDL_Scancode key) const { return pressed.test(key); }
+    bool wasReleased(SDL_Scancode key) const { return released.test(key); }
+};
+
+/**
+ * @brief Mouse state at the start of the frame. Motion and wheel are totals for the frame.
+ */
+struct MouseState {
+    float x = 0.0f;
+    float y = 0.0f;
+    float deltaX = 0.0f;
+    float deltaY = 0.0f;
+    float wheelX = 0.0f;
+    float wheelY = 0.0f;
+    std::uint32_t buttons = 0;          ///< Bit (button - 1) set while held
+    std::uint32_t pressed = 0;
+    std::uint32_t released = 0;
+
+    bool isDown(int button) const { return (buttons >> (button - 1)) & 1u; }
+    bool wasPressed(int button) const { return (pressed >> (button - 1)) & 1u; }
+    bool wasReleased(int button) const { return (released >> (button - 1)) & 1u; }
+};
+
+/**
+ * @brief State of one gamepad slot at the start of the frame.
+ */
+struct GamepadState {
+    bool connected = false;
+    std::uint32_t buttons = 0;          ///< Bit SDL_GamepadButton set while held
+    std::uint32_t pressed = 0;
+    std::uint32_t released = 0;
+    float axes[SDL_GAMEPAD_AXIS_COUNT] = {};  ///< SDL_GamepadAxis values in [-1, 1]
+
+    bool isDown(int button) const { return (buttons >> button) & 1u; }
+    bool wasPressed(int button) const { return (pressed >> button) & 1u; }
+    bool wasReleased(int button) const { return (released >> button) & 1u; }
+};
+
+} // namespace polaris
+
+#endif // POLARIS_INPUTEVENT_H
@@ -0,0 +1,355 @@
+#include "input/InputSystem.h"
+#include "jobs/JobSystem.h"
+#include "profiling/Profiler.h"
+#include <algorithm>
+
+namespace polaris {
+
+namespace {
+
+/**
+ * @brief Capacity of each worker's engine event queue; overflow goes to the locked list.
+ */
+constexpr std::size_t kWorkerQueueCapacity = 1024;
+
+/**
+ * @brief Initial capacity of the per-frame event array.
+ */
+constexpr std::size_t kInitialEventCapacity = 256;
+
+} // namespace
+
+InputSystem::InputSystem() {
+    m_openGamepads.fill(nullptr);
+    m_gamepadIds.fill(0);
+    m_events.reserve(kInitialEventCapacity);
+}
+
+InputSystem::~InputSystem() {
+    shutdown();
+}
+
+/**
+ * @brief Creates one lock-free queue per job system thread for postEvent().
+ * @param workerThreads JobSystem::getThreadCount().
+ */
+void InputSystem::initialize(unsigned workerThreads) {
+    m_workerQueues.clear();
+    for (unsigned i = 0; i < workerThreads; ++i) {
+        m_workerQueues.push_back(std::make_unique<SpscQueue<EngineEvent>>(kWorkerQueueCapacity));
+    }
+}
+
+/**
+ * @brief Closes open gamepads and drops queued engine events.
+ */
+void InputSystem::shutdown() {
+    for (int slot = 0; slot < kMaxGamepads; ++slot) {
+        if (m_openGamepads[slot]) {
+            SDL_CloseGamepad(m_openGamepads[slot]);
+            m_openGamepads[slot] = nullptr;
+        }
+        m_gamepads[slot] = GamepadState();
+    }
+    std::vector<std::unique_ptr<SpscQueue<EngineEvent>>>().swap(m_workerQueues);
+    std::vector<InputEvent>().swap(m_events);
+    std::vector<EngineEvent>().swap(m_engineEvents);
+    std::lock_guard<std::mutex> lock(m_externalMutex);
+    std::vector<EngineEvent>().swap(m_externalEvents);
+}
+
+/**
+ * @brief Queues an event for the main thread: the worker's own SPSC queue if the caller is a
+ * job system thread and its queue has room, the locked list otherwise.
+ */
+void InputSystem::postEvent(const EngineEvent& event) {
+    const int worker = JobSystem::getCurrentWorkerIndex();
+    if (worker >= 0 && static_cast<std::size_t>(worker) < m_workerQueues.size() &&
+        m_workerQueues[static_cast<std::size_t>(worker)]->tryPush(event)) {
+        return;
+    }
+
+    std::lock_guard<std::mutex> lock(m_externalMutex);
+    m_externalEvents.push_back(event);
+}
+
+/**
+ * @brief Drains SDL in batches, updates the snapshots and publishes the frame's events.
+ * @param bus Receives the InputEvents, then the EngineEvents.
+ */
+void InputSystem::pollEvents(EventBus& bus) {
+    POLARIS_PROFILE_SCOPE("InputSystem::pollEvents");
+    beginFrame();
+
+    SDL_PumpEvents();
+    for (;;) {
+        const int count = SDL_PeepEvents(m_sdlEvents.data(), kPeepBatch, SDL_GETEVENT,
+                                         SDL_EVENT_FIRST, SDL_EVENT_LAST);
+        for (int i = 0; i < count; ++i) {
+            translate(m_sdlEvents[static_cast<std::size_t>(i)]);
+        }
+        if (count < kPeepBatch) {
+            break;
+        }
+    }
+
+    drainEngineEvents();
+
+    bus.publish(m_events.data(), m_events.size());
+    bus.publish(m_engineEvents.data(), m_engineEvents.size());
+}
+
+/**
+ * @brief Clears the per-frame parts of the state: event array, edges, motion and wheel totals.
+ */
+void InputSystem::beginFrame() {
+    m_events.clear();
+    m_engineEvents.clear();
+    m_keyboard.pressed.reset();
+    m_keyboard.released.reset();
+    m_mouse.deltaX = m_mouse.deltaY = 0.0f;
+    m_mouse.wheelX = m_mouse.wheelY = 0.0f;
+    m_mouse.pressed = m_mouse.released = 0;
+    for (GamepadState& gamepad : m_gamepads) {
+        gamepad.pressed = gamepad.released = 0;
+    }
+}
+
+/**
+ * @brief Moves the events posted since the last frame into m_engineEvents.
+ */
+void InputSystem::drainEngineEvents() {
+    EngineEvent event;
+    for (const std::unique_ptr<SpscQueue<EngineEvent>>& queue : m_workerQueues) {
+        while (queue->tryPop(event)) {
+            m_engineEvents.push_back(event);
+        }
+    }
+
+    std::lock_guard<std::mutex> lock(m_externalMutex);
+    m_engineEvents.insert(m_engineEvents.end(), m_externalEvents.begin(), m_externalEvents.end());
+    m_externalEvents.clear();
+}
+
+InputEvent& InputSystem::append(InputEventType type, const SDL_Event& event) {
+    InputEvent translated = {};
+    translated.type = type;
+    translated.timestampMs = static_cast<std::uint32_t>(event.common.timestamp / 1000000);
+    m_events.push_back(translated);
+    return m_events.back();
+}
+
+int InputSystem::findGamepad(SDL_JoystickID id) const {
+    for (int slot = 0; slot < kMaxGamepads; ++slot) {
+        if (m_openGamepads[slot] && m_gamepadIds[slot] == id) {
+            return slot;
+        }
+    }
+    return -1;
+}
+
+/**
+ * @brief Translates one SDL event, updating the state snapshots. Bursts of mouse motion,
+ * wheel and same-axis gamepad events are merged into the previous InputEvent.
+ */
+void InputSystem::translate(const SDL_Event& event) {
+    InputEvent* last = m_events.empty() ? nullptr : &m_events.back();
+
+    switch (event.type) {
+        case SDL_EVENT_QUIT:
+            append(InputEventType::Quit, event);
+            break;
+
+        case SDL_EVENT_WINDOW_RESIZED: {
+            InputEvent& resized = append(InputEventType::WindowResized, event);
+            resized.x = static_cast<float>(event.window.data1);
+            resized.y = static_cast<float>(event.window.data2);
+            break;
+        }
+
+        case SDL_EVENT_WINDOW_EXPOSED:
+            append(InputEventType::WindowExposed, event);
+            break;
+
+        case SDL_EVENT_WINDOW_FOCUS_GAINED:
+            append(InputEventType::WindowFocusGained, event);
+            break;
+
+        case SDL_EVENT_WINDOW_FOCUS_LOST:
+            // Key and button releases are not delivered while unfocused; avoid stuck input
+            m_keyboard.down.reset();
+            m_mouse.buttons = 0;
+            append(InputEventType::WindowFocusLost, event);
+            break;
+
+        case SDL_EVENT_KEY_DOWN:
+        case SDL_EVENT_KEY_UP: {
+            const SDL_KeyboardEvent& key = event.key;
+            if (key.scancode <= SDL_SCANCODE_UNKNOWN || key.scancode >= SDL_SCANCODE_COUNT) {
+                break;
+            }
+            const bool down = event.type == SDL_EVENT_KEY_DOWN;
+            InputEvent& translated = append(down ? InputEventType::KeyDown : InputEventType::KeyUp, event);
+            translated.code = static_cast<std::uint16_t>(key.scancode);
+            translated.modifiers = static_cast<std::uint16_t>(key.mod);
+            translated.repeat = key.repeat;
+
+            m_keyboard.modifiers = static_cast<std::uint16_t>(key.mod);
+            if (down && !key.repeat) {
+                m_keyboard.down.set(key.scancode);
+                m_keyboard.pressed.set(key.scancode);
+            } else if (!down) {
+                m_keyboard.down.reset(key.scancode);
+                m_keyboard.released.set(key.scancode);
+            }
+            break;
+        }
+
+        case SDL_EVENT_MOUSE_MOTION: {
+            const SDL_MouseMotionEvent& motion = event.motion;
+            m_mouse.x = motion.x;
+            m_mouse.y = motion.y;
+            m_mouse.deltaX += motion.xrel;
+            m_mouse.deltaY += motion.yrel;
+
+            if (last && last->type == InputEventType::MouseMotion) {
+                last->x = motion.x;
+                last->y = motion.y;
+                last->dx += motion.xrel;
+                last->dy += motion.yrel;
+                last->merged = static_cast<std::uint8_t>(std::min(255, last->merged + 1));
+                break;
+            }
+            InputEvent& translated = append(InputEventType::MouseMotion, event);
+            translated.x = motion.x;
+            translated.y = motion.y;
+            translated.dx = motion.xrel;
+            translated.dy = motion.yrel;
+            break;
+        }
+
+        case SDL_EVENT_MOUSE_BUTTON_DOWN:
+        case SDL_EVENT_MOUSE_BUTTON_UP: {
+            const SDL_MouseButtonEvent& button = event.button;
+            if (button.button < 1 || button.button > 32) {
+                break;
+            }
+            const std::uint32_t bit = 1u << (button.button - 1);
+            const bool down = event.type == SDL_EVENT_MOUSE_BUTTON_DOWN;
+            if (down) {
+                m_mouse.buttons |= bit;
+                m_mouse.pressed |= bit;
+            } else {
+                m_mouse.buttons &= ~bit;
+                m_mouse.released |= bit;
+            }
+            m_mouse.x = button.x;
+            m_mouse.y = button.y;
+
+            InputEvent& translated = append(down ? InputEventType::MouseButtonDown : InputEventType::MouseButtonUp, event);
+            translated.code = button.button;
+            translated.x = button.x;
+            translated.y = button.y;
+            break;
+        }
+
+        case SDL_EVENT_MOUSE_WHEEL: {
+            const SDL_MouseWheelEvent& wheel = event.wheel;
+            const float sign = wheel.direction == SDL_MOUSEWHEEL_FLIPPED ? -1.0f : 1.0f;
+            m_mouse.wheelX += wheel.x * sign;
+            m_mouse.wheelY += wheel.y * sign;
+
+            if (last && last->type == InputEventType::MouseWheel) {
+                last->x += wheel.x * sign;
+                last->y += wheel.y * sign;
+                last->merged = static_cast<std::uint8_t>(std::min(255, last->merged + 1));
+                break;
+            }
+            InputEvent& translated = append(InputEventType::MouseWheel, event);
+            translated.x = wheel.x * sign;
+            translated.y = wheel.y * sign;
+            break;
+        }
+
+        case SDL_EVENT_GAMEPAD_ADDED: {
+            if (findGamepad(event.gdevice.which) >= 0) {
+                break;
+            }
+            for (int slot = 0; slot < kMaxGamepads; ++slot) {
+                if (!m_openGamepads[slot]) {
+                    m_openGamepads[slot] = SDL_OpenGamepad(event.gdevice.which);
+                    if (!m_openGamepads[slot]) {
+                        break;
+                    }
+                    m_gamepadIds[slot] = event.gdevice.which;
+                    m_gamepads[slot] = GamepadState();
+                    m_gamepads[slot].connected = true;
+                    append(InputEventType::GamepadAdded, event).device = static_cast<std::uint8_t>(slot);
+                    break;
+                }
+            }
+            break;
+        }
+
+        case SDL_EVENT_GAMEPAD_REMOVED: {
+            const int slot = findGamepad(event.gdevice.which);
+            if (slot < 0) {
+                break;
+            }
+            SDL_CloseGamepad(m_openGamepads[slot]);
+            m_openGamepads[slot] = nullptr;
+            m_gamepads[slot] = GamepadState();
+            append(InputEventType::GamepadRemoved, event).device = static_cast<std::uint8_t>(slot);
+            break;
+        }
+
+        case SDL_EVENT_GAMEPAD_BUTTON_DOWN:
+        case SDL_EVENT_GAMEPAD_BUTTON_UP: {
+            const int slot = findGamepad(event.gbutton.which);
+            if (slot < 0 || event.gbutton.button >= 32) {
+                break;
+            }
+            GamepadState& gamepad = m_gamepads[slot];
+            const std::uint32_t bit = 1u << event.gbutton.button;
+            const bool down = event.type == SDL_EVENT_GAMEPAD_BUTTON_DOWN;
+            if (down) {
+                gamepad.buttons |= bit;
+                gamepad.pressed |= bit;
+            } else {
+                gamepad.buttons &= ~bit;
+                gamepad.released |= bit;
+            }
+
+            InputEvent& translated = append(down ? InputEventType::GamepadButtonDown : InputEventType::GamepadButtonUp, event);
+            translated.device = static_cast<std::uint8_t>(slot);
+            translated.code = event.gbutton.button;
+            break;
+        }
+
+        case SDL_EVENT_GAMEPAD_AXIS_MOTION: {
+            const int slot = findGamepad(event.gaxis.which);
+            if (slot < 0 || event.gaxis.axis >= SDL_GAMEPAD_AXIS_COUNT) {
+                break;
+            }
+            const float value = std::max(-1.0f, static_cast<float>(event.gaxis.value) / SDL_JOYSTICK_AXIS_MAX);
+            m_gamepads[slot].axes[event.gaxis.axis] = value;
+
+            if (last && last->type == InputEventType::GamepadAxis && last->device == slot &&
+                last->code == event.gaxis.axis) {
+                last->x = value;
+                last->merged = static_cast<std::uint8_t>(std::min(255, last->merged + 1));
+                break;
+            }
+            InputEvent& translated = append(InputEventType::GamepadAxis, event);
+            translated.device = static_cast<std::uint8_t>(slot);
+            translated.code = event.gaxis.axis;
+            translated.x = value;
+            break;
+        }
+
+        default:
+            break;
+    }
+}
+
+} // namespace polaris
@@ -0,0 +1,102 @@
+#ifndef POLARIS_INPUTSYSTEM_H
+#define POLARIS_INPUTSYSTEM_H
+
+#include "input/EventBus.h"
+#include "input/InputEvent.h"
+#include "input/SpscQueue.h"
+#include <SDL3/SDL.h>
+#include <array>
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace polaris {
+
+/**
+ * @brief Collects the frame's input and engine events and publishes them on an EventBus.
+ *
+ * pollEvents() pumps SDL once and drains its queue in batches with SDL_PeepEvents, translates
+ * the events into a compact InputEvent array (merging bursts of motion), updates the keyboard,
+ * mouse and gamepad snapshots, then publishes the InputEvents followed by any EngineEvents
+ * posted since the last frame. Storage is reused, so steady-state polling does not allocate.
+ *
+ * postEvent() may be called from any thread. Job system workers each push into their own
+ * lock-free single-producer queue; other threads fall back to a mutex-protected list.
+ */
+class InputSystem {
+public:
+    /**
+     * @brief Number of gamepads tracked at once; further gamepads are ignored.
+     */
+    static constexpr int kMaxGamepads = 4;
+
+    InputSystem();
+    ~InputSystem();
+
+    InputSystem(const InputSystem&) = delete;
+    InputSystem& operator=(const InputSystem&) = delete;
+
+    /**
+     * @brief Prepares one engine event queue per job system thread.
+     * @param workerThreads JobSystem::getThreadCount().
+     */
+    void initialize(unsigned workerThreads);
+
+    /**
+     * @brief Closes open gamepads, drops queued engine events and frees the event storage.
+     */
+    void shutdown();
+
+    /**
+     * @brief Gathers this frame's events, updates the state snapshots and publishes the events.
+     * Main thread only.
+     * @param bus Receives InputEvent and EngineEvent publications.
+     */
+    void pollEvents(EventBus& bus);
+
+    /**
+     * @brief Queues an event for delivery on the main thread at the next pollEvents().
+     * Thread-safe.
+     */
+    void postEvent(const EngineEvent& event);
+
+    /**
+     * @brief This frame's input events, in the order they occurred.
+     */
+    const std::vector<InputEvent>& getEvents() const { return m_events; }
+
+    const KeyboardState& getKeyboard() const { return m_keyboard; }
+    const MouseState& getMouse() const { return m_mouse; }
+    const GamepadState& getGamepad(int slot) const { return m_gamepads[static_cast<std::size_t>(slot)]; }
+
+private:
+    void beginFrame();
+    void translate(const SDL_Event& event);
+    InputEvent& append(InputEventType type, const SDL_Event& event);
+    int findGamepad(SDL_JoystickID id) const;
+    void drainEngineEvents();
+
+    /**
+     * @brief SDL events fetched per SDL_PeepEvents call.
+     */
+    static constexpr int kPeepBatch = 128;
+
+    std::array<SDL_Event, kPeepBatch> m_sdlEvents;
+    std::vector<InputEvent> m_events;
+
+    KeyboardState m_keyboard;
+    MouseState m_mouse;
+    std::array<GamepadState, kMaxGamepads> m_gamepads;
+    std::array<SDL_Gamepad*, kMaxGamepads> m_openGamepads;
+    std::array<SDL_JoystickID, kMaxGamepads> m_gamepadIds;
+
+    std::vector<std::unique_ptr<SpscQueue<EngineEvent>>> m_workerQueues;
+    std::mutex m_externalMutex;
+    std::vector<EngineEvent> m_externalEvents;
+    std::vector<EngineEvent> m_engineEvents;
+};
+
+} // namespace polaris
+
+#endif // POLARIS_INPUTSYSTEM_H
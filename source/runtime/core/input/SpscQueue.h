@@ -0,0 +1,89 @@
+#ifndef POLARIS_SPSCQUEUE_H
+#define POLARIS_SPSCQUEUE_H
+
+#include <atomic>
+#include <cstddef>
+#include <memory>
+#include <type_traits>
+
+namespace polaris {
+
+/**
+ * @brief Bounded lock-free queue for exactly one producer thread and one consumer thread.
+ *
+ * The producer only writes m_tail and the consumer only writes m_head, each on its own cache
+ * line, and each side keeps a cached copy of the other's index so that most operations touch
+ * no shared cache line at all. T must be trivially copyable.
+ */
+template <typename T>
+class SpscQueue {
+    static_assert(std::is_trivially_copyable<T>::value, "SpscQueue elements must be trivially copyable");
+
+public:
+    /**
+     * @param capacity Number of elements the queue can hold. Rounded up to a power of two.
+     */
+    explicit SpscQueue(std::size_t capacity) {
+        std::size_t size = 2;
+        while (size < capacity) {
+            size *= 2;
+        }
+        m_mask = size - 1;
+        m_slots.reset(new T[size]);
+    }
+
+    SpscQueue(const SpscQueue&) = delete;
+    SpscQueue& operator=(const SpscQueue&) = delete;
+
+    /**
+     * @brief Appends an element. Producer thread only.
+     * @return false if the queue is full.
+     */
+    bool tryPush(const T& value) {
+        const std::size_t tail = m_tail.load(std::memory_order_relaxed);
+        if (tail - m_cachedHead > m_mask) {
+            m_cachedHead = m_head.load(std::memory_order_acquire);
+            if (tail - m_cachedHead > m_mask) {
+                return false;
+            }
+        }
+        m_slots[tail & m_mask] = value;
+        m_tail.store(tail + 1, std::memory_order_release);
+        return true;
+    }
+
+    /**
+     * @brief Removes the oldest element. Consumer thread only.
+     * @return false if the queue is empty.
+     */
+    bool tryPop(T& value) {
+        const std::size_t head = m_head.load(std::memory_order_relaxed);
+        if (head == m_cachedTail) {
+            m_cachedTail = m_tail.load(std::memory_order_acquire);
+            if (head == m_cachedTail) {
+                return false;
+            }
+        }
+        value = m_slots[head & m_mask];
+        m_head.store(head + 1, std::memory_order_release);
+        return true;
+    }
+
+    std::size_t capacity() const { return m_mask + 1; }
+
+private:
+    static constexpr std::size_t kCacheLine = 64;
+
+    std::unique_ptr<T[]> m_slots;
+    std::size_t m_mask = 0;
+
+    alignas(kCacheLine) std::atomic<std::size_t> m_head{0};
+    std::size_t m_cachedTail = 0;   ///< Consumer's copy of m_tail
+
+    alignas(kCacheLine) std::atomic<std::size_t> m_tail{0};
+    std::size_t m_cachedHead = 0;   ///< Producer's copy of m_head
+};
+
+} // namespace polaris
+
+#endif // POLARIS_SPSCQUEUE_H
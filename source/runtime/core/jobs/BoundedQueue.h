@@ -0,0 +1,150 @@
+#ifndef POLARIS_BOUNDEDQUEUE_H
+#define POLARIS_BOUNDEDQUEUE_H
+
+#include <condition_variable>
+#include <cstddef>
+#include <mutex>
+#include <vector>
+
+namespace polaris {
+
+/**
+ * @brief Fixed-capacity FIFO between threads, where the producer and consumer may block.
+ *
+ * push() waits while the queue is full, which bounds how far a producer runs ahead, and pop()
+ * waits while it is empty. The try* variants never block, for threads such as the main loop
+ * that must not stall. close() wakes every waiting thread and makes blocking calls fail, for
+ * shutting the producer and consumer down. Storage is allocated once, by the constructor.
+ *
+ * Unlike SpscQueue, any number of threads may use either end.
+ */
+template <typename T>
+class BoundedQueue {
+public:
+    explicit BoundedQueue(std::size_t capacity) : m_items(capacity) {}
+
+    BoundedQueue(const BoundedQueue&) = delete;
+    BoundedQueue& operator=(const BoundedQueue&) = delete;
+
+    /**
+     * @brief Appends an item, waiting for room.
+     * @return false if the queue was closed.
+     */
+    bool push(const T& item) {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        m_notFull.wait(lock, [this]() { return m_count < m_items.size() || m_closed; });
+        if (m_closed) {
+            return false;
+        }
+        append(item);
+        return true;
+    }
+
+    /**
+     * @return false if the queue is full or closed.
+     */
+    bool tryPush(const T& item) {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (m_count == m_items.size() || m_closed) {
+            return false;
+        }
+        append(item);
+        return true;
+    }
+
+    /**
+     * @brief Removes the oldest item, waiting for one.
+     * @return false if the queue was closed.
+     */
+    bool pop(T& item) {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        m_notEmpty.wait(lock, [this]() { return m_count > 0 || m_closed; });
+        if (m_closed) {
+            return false;
+        }
+        removeFront(item);
+        return true;
+    }
+
+    /**
+     * @return false if the queue is empty.
+     */
+    bool tryPop(T& item) {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (m_count == 0) {
+            return false;
+        }
+        removeFront(item);
+        return true;
+    }
+
+    /**
+     * @brief Copies the oldest item without removing it.
+     * @return false if the queue is empty.
+     */
+    bool tryPeek(T& item) const {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (m_count == 0) {
+            return false;
+        }
+        item = m_items[m_head];
+        return true;
+    }
+
+    /**
+     * @brief Removes every item, passing each to function (e.g. to recycle it), oldest first.
+     */
+    template <typename F>
+    void drain(F&& function) {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        T item;
+        while (m_count > 0) {
+            removeFront(item);
+            function(item);
+        }
+    }
+
+    /**
+     * @brief Wakes every waiting thread; push() and pop() fail from now on, while the try*
+     * variants keep working so items can still be recycled.
+     */
+    void close() {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_closed = true;
+        m_notFull.notify_all();
+        m_notEmpty.notify_all();
+    }
+
+    std::size_t size() const {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        return m_count;
+    }
+
+    std::size_t capacity() const { return m_items.size(); }
+
+private:
+    void append(const T& item) {
+        m_items[(m_head + m_count) % m_items.size()] = item;
+        ++m_count;
+        m_notEmpty.notify_one();
+    }
+
+    void removeFront(T& item) {
+        item = m_items[m_head];
+        m_head = (m_head + 1) % m_items.size();
+        --m_count;
+        m_notFull.notify_one();
+    }
+
+    mutable std::mutex m_mutex;
+    std::condition_variable m_notFull;
+    std::condition_variable m_notEmpty;
+    std::vector<T> m_items;
+    std::size_t m_head = 0;
+    std::size_t m_count = 0;
+    bool m_closed = false;
+};
+
+} // namespace polaris
+
+#endif // POLARIS_BOUNDEDQUEUE_H
@@ -0,0 +1,486 @@
+#include "jobs/JobSystem.h"
+#include "Logger.h"
+#include "memory/LinearArena.h"
+#include "profiling/Profiler.h"
+#include <cstdio>
+#include <exception>
+#include <thread>
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+#include <immintrin.h>
+#endif
+
+namespace polaris {
+
+namespace {
+
+/**
+ * @brief Jobs each worker can have allocated at once, and the capacity of its deque.
+ */
+constexpr std::size_t kJobPoolSize = 4096;
+
+/**
+ * @brief Upper bound on worker threads; also the size of the static thread name table.
+ */
+constexpr unsigned kMaxWorkers = 64;
+
+/**
+ * @brief Rounds of failed job searches a worker spins through before going to sleep.
+ */
+constexpr int kSpinRounds = 64;
+
+/**
+ * @brief parallelFor aims for this many batches per thread, so stealing can even out the load.
+ */
+constexpr std::size_t kBatchesPerThread = 4;
+
+/**
+ * @brief The job system and worker index of the calling thread.
+ */
+thread_local JobSystem* t_jobSystem = nullptr;
+thread_local int t_workerIndex = -1;
+
+inline void cpuRelax() {
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+    _mm_pause();
+#elif defined(__aarch64__) || defined(__arm__)
+    __asm__ __volatile__("yield");
+#else
+    std::this_thread::yield();
+#endif
+}
+
+/**
+ * @brief Thread names handed to the profiler, which keeps the pointers.
+ */
+const char* workerThreadName(unsigned index) {
+    static char names[kMaxWorkers][16];
+    std::snprintf(names[index], sizeof(names[index]), "Worker %u", index);
+    return names[index];
+}
+
+/**
+ * @brief Fixed-capacity Chase-Lev work-stealing deque of job pointers.
+ *
+ * The owner pushes and pops at the bottom; any thread may steal from the top. Only the last
+ * remaining job is contended, which both sides resolve with a CAS on top.
+ * See Le et al., "Correct and Efficient Work-Stealing for Weak Memory Models" (PPoPP 2013).
+ */
+class WorkStealingDeque {
+public:
+    explicit WorkStealingDeque(std::size_t capacity)
+        : m_mask(capacity - 1),
+          m_buffer(new std::atomic<Job*>[capacity]) {
+    }
+
+    /**
+     * @brief Owner only. @return false if the deque is full.
+     */
+    bool push(Job* job) {
+        const std::int64_t bottom = m_bottom.load(std::memory_order_relaxed);
+        const std::int64_t top = m_top.load(std::memory_order_acquire);
+        if (bottom - top > static_cast<std::int64_t>(m_mask)) {
+            return false;
+        }
+        m_buffer[bottom & m_mask].store(job, std::memory_order_relaxed);
+        m_bottom.store(bottom + 1, std::memory_order_release);
+        return true;
+    }
+
+    /**
+     * @brief Owner only. Takes the most recently pushed job.
+     */
+    Job* pop() {
+        const std::int64_t bottom = m_bottom.load(std::memory_order_relaxed) - 1;
+        m_bottom.store(bottom, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        std::int64_t top = m_top.load(std::memory_order_relaxed);
+
+        if (top > bottom) {
+            m_bottom.store(bottom + 1, std::memory_order_relaxed);
+            return nullptr;
+        }
+
+        Job* job = m_buffer[bottom & m_mask].load(std::memory_order_relaxed);
+        if (top == bottom) {
+            // Last job: race the thieves for it.
+            if (!m_top.compare_exchange_strong(top, top + 1, std::memory_order_seq_cst, std::memory_order_relaxed)) {
+                job = nullptr;
+            }
+            m_bottom.store(bottom + 1, std::memory_order_relaxed);
+        }
+        return job;
+    }
+
+    /**
+     * @brief Any thread. Takes the oldest job, or returns nullptr if empty or lost a race.
+     */
+    Job* steal() {
+        std::int64_t top = m_top.load(std::memory_order_acquire);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        const std::int64_t bottom = m_bottom.load(std::memory_order_acquire);
+        if (top >= bottom) {
+            return nullptr;
+        }
+
+        Job* job = m_buffer[top & m_mask].load(std::memory_order_relaxed);
+        if (!m_top.compare_exchange_strong(top, top + 1, std::memory_order_seq_cst, std::memory_order_relaxed)) {
+            return nullptr;
+        }
+        return job;
+    }
+
+private:
+    alignas(64) std::atomic<std::int64_t> m_top{0};
+    alignas(64) std::atomic<std::int64_t> m_bottom{0};
+    const std::size_t m_mask;
+    std::unique_ptr<std::atomic<Job*>[]> m_buffer;
+};
+
+} // namespace
+
+/**
+ * @brief Per-thread state: the deque, the job pool the thread allocates from, and the thread.
+ */
+struct JobSystem::Worker {
+    Worker() : deque(kJobPoolSize), jobs(new Job[kJobPoolSize]), nextJob(0), random(0) {}
+
+    WorkStealingDeque deque;
+    std::unique_ptr<Job[]> jobs;
+    std::size_t nextJob;
+    std::uint32_t random;
+    std::thread thread;
+};
+
+/**
+ * @brief Constructs a stopped JobSystem. Jobs run inline until initialize() is called.
+ */
+JobSystem::JobSystem()
+    : m_running(false),
+      m_stopping(false),
+      m_scratchArenaSize(0),
+      m_injectedCount(0),
+      m_nextExternalJob(0),
+      m_queuedJobs(0),
+      m_sleepingWorkers(0) {
+}
+
+JobSystem::~JobSystem() {
+    shutdown();
+}
+
+/**
+ * @brief Starts the worker threads. The calling thread becomes worker 0.
+ * @param config The job system configuration.
+ */
+void JobSystem::initialize(const JobSystemConfig& config) {
+    if (m_running) {
+        LOG_WARN("JobSystem already initialized");
+        return;
+    }
+
+    unsigned workerThreads = config.workerThreads;
+    if (workerThreads == 0) {
+        const unsigned hardwareThreads = std::thread::hardware_concurrency();
+        workerThreads = hardwareThreads > 1 ? hardwareThreads - 1 : 0;
+    }
+    workerThreads = std::min(workerThreads, kMaxWorkers - 1);
+
+    m_stopping.store(false);
+    m_scratchArenaSize = config.scratchArenaSize;
+    m_externalJobs.reset(new Job[kJobPoolSize]);
+    m_workers.clear();
+    for (unsigned i = 0; i <= workerThreads; ++i) {
+        m_workers.emplace_back(new Worker());
+        m_workers.back()->random = 0x9E3779B9u * (i + 1);
+    }
+
+    t_jobSystem = this;
+    t_workerIndex = 0;
+    ScratchArena::reserve(m_scratchArenaSize);
+    m_running = true;
+
+    for (unsigned i = 1; i <= workerThreads; ++i) {
+        m_workers[i]->thread = std::thread(&JobSystem::workerLoop, this, static_cast<int>(i));
+    }
+
+    LOG_INFO("JobSystem started with {} worker threads", workerThreads);
+}
+
+/**
+ * @brief Runs every remaining runnable job and joins the worker threads.
+ */
+void JobSystem::shutdown() {
+    if (!m_running) {
+        return;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(m_sleepMutex);
+        m_stopping.store(true);
+    }
+    m_wakeCondition.notify_all();
+
+    // Help drain whatever is still queued, then wait for the workers to finish theirs.
+    while (Job* job = findJob(0)) {
+        execute(*job);
+    }
+    for (std::size_t i = 1; i < m_workers.size(); ++i) {
+        if (m_workers[i]->thread.joinable()) {
+            m_workers[i]->thread.join();
+        }
+    }
+
+    m_running = false;
+    t_jobSystem = nullptr;
+    t_workerIndex = -1;
+    std::vector<std::unique_ptr<Worker>>().swap(m_workers);
+    std::deque<Job*>().swap(m_injected);
+    m_externalJobs.reset();
+    ScratchArena::get().release();
+    m_injectedCount.store(0);
+    m_queuedJobs.store(0);
+    LOG_INFO("JobSystem shut down");
+}
+
+/**
+ * @brief Index of the calling thread in [0, getThreadCount()), or -1 for other threads.
+ */
+int JobSystem::getCurrentWorkerIndex() {
+    return t_workerIndex;
+}
+
+/**
+ * @brief Takes a free job from the calling thread's pool.
+ * @return nullptr if the pool is exhausted; the caller then runs the job inline.
+ */
+Job* JobSystem::allocateJob() {
+    std::size_t* nextJob;
+    Job* pool;
+    std::unique_lock<std::mutex> lock;
+    if (t_jobSystem == this) {
+        Worker& worker = *m_workers[t_workerIndex];
+        nextJob = &worker.nextJob;
+        pool = worker.jobs.get();
+    } else {
+        lock = std::unique_lock<std::mutex>(m_injectMutex);
+        nextJob = &m_nextExternalJob;
+        pool = m_externalJobs.get();
+    }
+
+    // The pool is a ring; slots are normally free again long before it wraps around.
+    for (std::size_t attempt = 0; attempt < kJobPoolSize; ++attempt) {
+        Job& job = pool[*nextJob];
+        *nextJob = (*nextJob + 1) & (kJobPoolSize - 1);
+        if (!job.inUse.load(std::memory_order_acquire)) {
+            job.inUse.store(true, std::memory_order_relaxed);
+            return &job;
+        }
+    }
+    return nullptr;
+}
+
+/**
+ * @brief Queues a job now, or parks it on its dependency until the dependency reaches zero.
+ */
+void JobSystem::submit(Job* job, JobCounter* dependency) {
+    if (dependency) {
+        dependency->lock();
+        if (!dependency->isDone()) {
+            job->nextContinuation = dependency->m_continuations;
+            dependency->m_continuations = job;
+            dependency->unlock();
+            return;
+        }
+        dependency->unlock();
+    }
+    enqueue(job);
+}
+
+/**
+ * @brief Makes a runnable job visible to the workers and wakes one if any are asleep.
+ */
+void JobSystem::enqueue(Job* job) {
+    bool queued = false;
+    if (t_jobSystem == this) {
+        queued = m_workers[t_workerIndex]->deque.push(job);
+    }
+    if (!queued) {
+        std::lock_guard<std::mutex> lock(m_injectMutex);
+        m_injected.push_back(job);
+        m_injectedCount.fetch_add(1, std::memory_order_release);
+    }
+
+    m_queuedJobs.fetch_add(1);
+    if (m_sleepingWorkers.load() > 0) {
+        // Taking the lock orders this wake-up after a sleeper's last check of m_queuedJobs.
+        { std::lock_guard<std::mutex> lock(m_sleepMutex); }
+        m_wakeCondition.notify_one();
+    }
+}
+
+/**
+ * @brief Looks for a runnable job: own deque first, then the injection queue, then stealing.
+ * @param workerIndex The caller's worker index, or -1 for threads without a deque.
+ */
+Job* JobSystem::findJob(int workerIndex) {
+    Job* job = nullptr;
+    if (workerIndex >= 0) {
+        job = m_workers[workerIndex]->deque.pop();
+    }
+
+    if (!job && m_injectedCount.load(std::memory_order_acquire) > 0) {
+        std::lock_guard<std::mutex> lock(m_injectMutex);
+        if (!m_injected.empty()) {
+            job = m_injected.front();
+            m_injected.pop_front();
+            m_injectedCount.fetch_sub(1, std::memory_order_relaxed);
+        }
+    }
+
+    if (!job) {
+        const std::size_t workerCount = m_workers.size();
+        std::uint32_t start = 0;
+        if (workerIndex >= 0) {
+            // xorshift32 keeps thieves from all hammering the same victim.
+            std::uint32_t& random = m_workers[workerIndex]->random;
+            random ^= random << 13;
+            random ^= random >> 17;
+            random ^= random << 5;
+            start = random;
+        }
+        for (std::size_t i = 0; i < workerCount && !job; ++i) {
+            const std::size_t victim = (start + i) % workerCount;
+            if (static_cast<int>(victim) != workerIndex) {
+                job = m_workers[victim]->deque.steal();
+            }
+        }
+    }
+
+    if (job) {
+        m_queuedJobs.fetch_sub(1);
+    }
+    return job;
+}
+
+/**
+ * @brief Runs a job, releases its pool slot and signals its counter.
+ */
+void JobSystem::execute(Job& job) {
+    try {
+        job.invoke(job);
+    } catch (const std::exception& e) {
+        LOG_ERROR("Unhandled exception in job: {}", e.what());
+    } catch (...) {
+        LOG_ERROR("Unhandled exception in job");
+    }
+    job.destroy(job);
+
+    JobCounter* signal = job.signal;
+    job.inUse.store(false, std::memory_order_release);
+    if (signal) {
+        finish(*signal);
+    }
+}
+
+/**
+ * @brief Decrements a counter and, when it reaches zero, queues the jobs that depended on it.
+ */
+void JobSystem::finish(JobCounter& counter) {
+    // Every decrement but the last needs no lock.
+    int count = counter.m_count.load(std::memory_order_relaxed);
+    while (count > 1) {
+        if (counter.m_count.compare_exchange_weak(count, count - 1, std::memory_order_acq_rel, std::memory_order_relaxed)) {
+            return;
+        }
+    }
+
+    // Possibly the last one. Reaching zero under the lock means a waiter that saw zero can
+    // synchronise with us (see wait()) before it destroys the counter.
+    counter.lock();
+    Job* continuation = nullptr;
+    if (counter.m_count.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+        continuation = counter.m_continuations;
+        counter.m_continuations = nullptr;
+    }
+    counter.unlock();
+
+    while (continuation) {
+        Job* next = continuation->nextContinuation;
+        enqueue(continuation);
+        continuation = next;
+    }
+}
+
+/**
+ * @brief Executes queued jobs on the calling thread until counter reaches zero.
+ */
+void JobSystem::wait(JobCounter& counter) {
+    const int workerIndex = t_jobSystem == this ? t_workerIndex : -1;
+    while (!counter.isDone()) {
+        if (Job* job = m_running ? findJob(workerIndex) : nullptr) {
+            execute(*job);
+        } else {
+            cpuRelax();
+        }
+    }
+
+    // The job that brought the count to zero may still hold the lock; after this it no longer
+    // touches the counter and the caller is free to destroy it.
+    counter.lock();
+    counter.unlock();
+}
+
+/**
+ * @brief Main loop of a worker thread: run jobs, spin briefly when idle, then sleep.
+ */
+void JobSystem::workerLoop(int workerIndex) {
+    t_jobSystem = this;
+    t_workerIndex = workerIndex;
+    POLARIS_PROFILE_THREAD(workerThreadName(static_cast<unsigned>(workerIndex)));
+    ScratchArena::reserve(m_scratchArenaSize);
+
+    int idleRounds = 0;
+    for (;;) {
+        if (Job* job = findJob(workerIndex)) {
+            execute(*job);
+            idleRounds = 0;
+            continue;
+        }
+
+        if (m_stopping.load()) {
+            break;
+        }
+
+        if (++idleRounds < kSpinRounds) {
+            cpuRelax();
+            continue;
+        }
+
+        std::unique_lock<std::mutex> lock(m_sleepMutex);
+        m_sleepingWorkers.fetch_add(1);
+        if (m_queuedJobs.load() <= 0 && !m_stopping.load()) {
+            m_wakeCondition.wait(lock);
+        }
+        m_sleepingWorkers.fetch_sub(1);
+        idleRounds = 0;
+    }
+
+    t_jobSystem = nullptr;
+    t_workerIndex = -1;
+}
+
+/**
+ * @brief Batch size for parallelFor: large enough to amortise scheduling, small enough that
+ * every thread gets several batches to balance uneven work.
+ */
+std::size_t JobSystem::getBatchSize(std::size_t count, std::size_t minBatchSize) const {
+    if (getThreadCount() == 1) {
+        return count;
+    }
+    const std::size_t targetBatches = static_cast<std::size_t>(getThreadCount()) * kBatchesPerThread;
+    const std::size_t batchSize = (count + targetBatches - 1) / targetBatches;
+    return std::max(batchSize, std::max<std::size_t>(minBatchSize, 1));
+}
+
+} // namespace polaris
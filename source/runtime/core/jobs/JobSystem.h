@@ -0,0 +1,272 @@
+#ifndef POLARIS_JOBSYSTEM_H
+#define POLARIS_JOBSYSTEM_H
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <new>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace polaris {
+
+class JobSystem;
+class JobCounter;
+
+/**
+ * @brief A unit of work as stored in the job pools. Internal to JobSystem; use
+ * JobSystem::schedule() to create jobs.
+ */
+struct Job {
+    /**
+     * @brief Bytes available for the job's callable. Larger lambdas should capture by reference.
+     */
+    static constexpr std::size_t kStorageSize = 64;
+
+    void (*invoke)(Job& job) = nullptr;
+    void (*destroy)(Job& job) = nullptr;
+    JobCounter* signal = nullptr;
+    Job* nextContinuation = nullptr;
+    std::atomic<bool> inUse{false};
+    alignas(std::max_align_t) unsigned char storage[kStorageSize];
+};
+
+/**
+ * @brief Counts outstanding jobs.
+ *
+ * Jobs scheduled with a counter as their signal increment it when scheduled and decrement it
+ * when they finish, so JobSystem::wait() on the counter waits for all of them. Jobs scheduled
+ * with a counter as their dependency do not start until it reaches zero. A counter must outlive
+ * the jobs that reference it: only destroy or reuse it after JobSystem::wait() has returned.
+ */
+class JobCounter {
+public:
+    JobCounter() = default;
+    JobCounter(const JobCounter&) = delete;
+    JobCounter& operator=(const JobCounter&) = delete;
+
+    /**
+     * @brief True once every job signalling this counter has finished.
+     */
+    bool isDone() const { return m_count.load(std::memory_order_acquire) == 0; }
+
+private:
+    friend class JobSystem;
+
+    void lock() {
+        while (m_lock.test_and_set(std::memory_order_acquire)) {
+        }
+    }
+    void unlock() { m_lock.clear(std::memory_order_release); }
+
+    std::atomic<int> m_count{0};
+    /**
+     * @brief Spin lock guarding m_continuations and the transition of m_count to zero.
+     */
+    std::atomic_flag m_lock = ATOMIC_FLAG_INIT;
+    /**
+     * @brief Jobs waiting for this counter to reach zero, linked through Job::nextContinuation.
+     */
+    Job* m_continuations = nullptr;
+};
+
+/**
+ * @brief Job system configuration.
+ */
+struct JobSystemConfig {
+    /**
+     * @brief Number of worker threads to start in addition to the thread calling initialize().
+     * 0 means one less than the number of hardware threads.
+     */
+    unsigned workerThreads = 0;
+    /**
+     * @brief Size in bytes of the ScratchArena each worker reserves when it starts.
+     */
+    std::size_t scratchArenaSize = 256 * 1024;
+};
+
+/**
+ * @brief Work-stealing job scheduler.
+ *
+ * Every worker thread, and the thread that called initialize() (normally the engine's main
+ * thread), owns a Chase-Lev deque: it pushes and pops its own jobs at the bottom without locking,
+ * and idle workers steal from the top of the others. Jobs scheduled from any other thread go
+ * through a shared injection queue. Workers that find nothing to do spin briefly and then sleep
+ * until new work is scheduled.
+ *
+ * wait() never blocks idly: the waiting thread keeps executing queued jobs until the counter it
+ * waits on reaches zero, so the main thread helps out instead of stalling the frame.
+ *
+ * Before initialize() and after shutdown(), schedule() runs jobs inline on the calling thread.
+ */
+class JobSystem {
+public:
+    JobSystem();
+    ~JobSystem();
+
+    JobSystem(const JobSystem&) = delete;
+    JobSystem& operator=(const JobSystem&) = delete;
+
+    /**
+     * @brief Starts the worker threads. The calling thread becomes worker 0.
+     * @param config The job system configuration.
+     */
+    void initialize(const JobSystemConfig& config = JobSystemConfig());
+
+    /**
+     * @brief Runs every remaining runnable job and joins the worker threads.
+     * Must be called from the thread that called initialize().
+     */
+    void shutdown();
+
+    /**
+     * @brief True between initialize() and shutdown().
+     */
+    bool isRunning() const { return m_running; }
+
+    /**
+     * @brief Number of threads executing jobs, including the thread that called initialize().
+     * 1 when the job system is not running.
+     */
+    unsigned getThreadCount() const { return m_running ? static_cast<unsigned>(m_workers.size()) : 1; }
+
+    /**
+     * @brief Index of the calling thread in [0, getThreadCount()), or -1 if it is not one of the
+     * job system's threads. Useful for indexing per-thread scratch data.
+     */
+    static int getCurrentWorkerIndex();
+
+    /**
+     * @brief Schedules a callable to run on some worker.
+     * @param function A callable taking no arguments, at most Job::kStorageSize bytes large.
+     * @param signal Optional counter incremented now and decremented when the job finishes.
+     * @param dependency Optional counter the job waits for: it is not started before the
+     *        counter reaches zero.
+     */
+    template <typename F>
+    void schedule(F&& function, JobCounter* signal = nullptr, JobCounter* dependency = nullptr);
+
+    /**
+     * @brief Executes queued jobs on the calling thread until counter reaches zero.
+     */
+    void wait(JobCounter& counter);
+
+    /**
+     * @brief Splits [0, count) into batches and runs body(begin, end) for each batch in parallel,
+     * returning once all batches are done. The calling thread runs one batch itself and then
+     * helps with the rest.
+     * @param count Number of elements.
+     * @param body Callable invoked as body(std::size_t begin, std::size_t end).
+     * @param minBatchSize Smallest batch worth a job of its own; raise it for very cheap elements.
+     */
+    template <typename F>
+    void parallelFor(std::size_t count, F&& body, std::size_t minBatchSize = 1);
+
+private:
+    struct Worker;
+
+    Job* allocateJob();
+    void submit(Job* job, JobCounter* dependency);
+    void enqueue(Job* job);
+    Job* findJob(int workerIndex);
+    void execute(Job& job);
+    void finish(JobCounter& counter);
+    void workerLoop(int workerIndex);
+    std::size_t getBatchSize(std::size_t count, std::size_t minBatchSize) const;
+
+    std::vector<std::unique_ptr<Worker>> m_workers;
+    bool m_running;
+    std::atomic<bool> m_stopping;
+    std::size_t m_scratchArenaSize;
+
+    /**
+     * @brief Jobs scheduled from threads that do not own a deque, and their job pool.
+     */
+    std::mutex m_injectMutex;
+    std::deque<Job*> m_injected;
+    std::atomic<std::size_t> m_injectedCount;
+    std::unique_ptr<Job[]> m_externalJobs;
+    std::size_t m_nextExternalJob;
+
+    /**
+     * @brief Runnable jobs not yet picked up; workers only go to sleep while this is zero.
+     */
+    std::atomic<int> m_queuedJobs;
+    std::atomic<int> m_sleepingWorkers;
+    std::mutex m_sleepMutex;
+    std::condition_variable m_wakeCondition;
+};
+
+template <typename F>
+void JobSystem::schedule(F&& function, JobCounter* signal, JobCounter* dependency) {
+    using Function = std::decay_t<F>;
+    static_assert(sizeof(Function) <= Job::kStorageSize,
+                  "Job callable is too large; capture large state by reference or pointer");
+    static_assert(alignof(Function) <= alignof(std::max_align_t), "Job callable is over-aligned");
+
+    if (signal) {
+        signal->m_count.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    Job inlineJob;
+    Job* job = m_running ? allocateJob() : nullptr;
+    const bool runInline = job == nullptr;
+    if (runInline) {
+        job = &inlineJob;
+    }
+
+    new (job->storage) Function(std::forward<F>(function));
+    job->invoke = [](Job& self) { (*std::launder(reinterpret_cast<Function*>(self.storage)))(); };
+    job->destroy = [](Job& self) { std::launder(reinterpret_cast<Function*>(self.storage))->~Function(); };
+    job->signal = signal;
+    job->nextContinuation = nullptr;
+
+    if (runInline) {
+        // Not running, or every pool slot is taken: do the work right here.
+        if (dependency) {
+            wait(*dependency);
+        }
+        execute(*job);
+        return;
+    }
+    submit(job, dependency);
+}
+
+template <typename F>
+void JobSystem::parallelFor(std::size_t count, F&& body, std::size_t minBatchSize) {
+    if (count == 0) {
+        return;
+    }
+
+    const std::size_t batchSize = getBatchSize(count, minBatchSize);
+    if (batchSize >= count) {
+        body(std::size_t(0), count);
+        return;
+    }
+
+    JobCounter counter;
+    auto* bodyPointer = &body;
+    for (std::size_t begin = batchSize; begin < count; begin += batchSize) {
+        const std::size_t end = std::min(begin + batchSize, count);
+        schedule([bodyPointer, begin, end]() { (*bodyPointer)(begin, end); }, &counter);
+    }
+
+    try {
+        body(std::size_t(0), batchSize);
+    } catch (...) {
+        // The queued batches still reference body; let them finish before unwinding.
+        wait(counter);
+        throw;
+    }
+    wait(counter);
+}
+
+} // namespace polaris
+
+#endif // POLARIS_JOBSYSTEM_H
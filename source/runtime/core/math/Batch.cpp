@@ -0,0 +1,169 @@
+#include "math/Batch.h"
+#include "math/BatchKernels.h"
+#include <atomic>
+
+#if defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+#include <immintrin.h>
+#include <intrin.h>
+#endif
+
+namespace polaris {
+namespace math {
+
+namespace {
+
+#if defined(__x86_64__) || defined(__i386__) || defined(_M_X64) || defined(_M_IX86)
+/**
+ * @brief AVX2 and FMA in the CPU, with the OS saving the YMM registers.
+ */
+bool cpuSupportsAVX2() {
+#if defined(_MSC_VER)
+    int info[4];
+    __cpuid(info, 1);
+    const bool fma = (info[2] & (1 << 12)) != 0;
+    const bool osxsave = (info[2] & (1 << 27)) != 0;
+    const bool avx = (info[2] & (1 << 28)) != 0;
+    if (!fma || !osxsave || !avx || (_xgetbv(0) & 0x6) != 0x6) {
+        return false;
+    }
+    __cpuidex(info, 7, 0);
+    return (info[1] & (1 << 5)) != 0;
+#else
+    // libgcc/compiler-rt also check that the OS has enabled the AVX state
+    __builtin_cpu_init();
+    return __builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma");
+#endif
+}
+#endif
+
+SimdLevel detectSimdLevel() {
+    if (getAVX2Kernels()) {
+#if defined(__x86_64__) || defined(__i386__) || defined(_M_X64) || defined(_M_IX86)
+        if (cpuSupportsAVX2()) {
+            return SimdLevel::AVX2;
+        }
+#endif
+    }
+    if (getSSE2Kernels()) {
+        return SimdLevel::SSE2;
+    }
+    if (getNEONKernels()) {
+        return SimdLevel::NEON;
+    }
+    return SimdLevel::Scalar;
+}
+
+const BatchKernels* getKernels(SimdLevel level) {
+    switch (level) {
+        case SimdLevel::SSE2: return getSSE2Kernels();
+        case SimdLevel::AVX2: return getAVX2Kernels();
+        case SimdLevel::NEON: return getNEONKernels();
+        case SimdLevel::Scalar:
+        default: return getScalarKernels();
+    }
+}
+
+/**
+ * @brief Whether a machine supporting `supported` can run `level`.
+ */
+bool canRun(SimdLevel level, SimdLevel supported) {
+    switch (level) {
+        case SimdLevel::Scalar: return true;
+        case SimdLevel::SSE2: return supported == SimdLevel::SSE2 || supported == SimdLevel::AVX2;
+        default: return level == supported;
+    }
+}
+
+struct ActiveKernels {
+    std::atomic<SimdLevel> level;
+    std::atomic<const BatchKernels*> kernels;
+
+    ActiveKernels() : level(getSupportedSimdLevel()), kernels(getKernels(level.load())) {}
+};
+
+ActiveKernels& getActive() {
+    static ActiveKernels active;
+    return active;
+}
+
+void transformPoints2Portable(const float* m, const float* x, const float* y, float* outX, float* outY,
+                              std::size_t count) {
+    transformPoints2Scalar(m, x, y, outX, outY, 0, count);
+}
+
+void transformPoints3Portable(const float* m, const float* x, const float* y, const float* z, float* outX,
+                              float* outY, float* outZ, std::size_t count) {
+    transformPoints3Scalar(m, x, y, z, outX, outY, outZ, 0, count);
+}
+
+void mixStereoPortable(const float* in, float* out, std::size_t frames, const float* gains) {
+    const float count = static_cast<float>(frames);
+    mixStereoScalar(in, out, gains, (gains[2] - gains[0]) / count, (gains[3] - gains[1]) / count, 0, frames);
+}
+
+void clampSamplesPortable(float* samples, std::size_t count) {
+    clampSamplesScalar(samples, 0, count);
+}
+
+const BatchKernels g_scalarKernels = {transformPoints2Portable, transformPoints3Portable, mixStereoPortable,
+                                      clampSamplesPortable};
+
+} // namespace
+
+const BatchKernels* getScalarKernels() {
+    return &g_scalarKernels;
+}
+
+const char* getSimdLevelName(SimdLevel level) {
+    switch (level) {
+        case SimdLevel::Scalar: return "scalar";
+        case SimdLevel::SSE2: return "sse2";
+        case SimdLevel::AVX2: return "avx2";
+        case SimdLevel::NEON: return "neon";
+    }
+    return "unknown";
+}
+
+SimdLevel getSupportedSimdLevel() {
+    static const SimdLevel supported = detectSimdLevel();
+    return supported;
+}
+
+SimdLevel getSimdLevel() {
+    return getActive().level.load(std::memory_order_relaxed);
+}
+
+SimdLevel setSimdLevel(SimdLevel level) {
+    if (!canRun(level, getSupportedSimdLevel())) {
+        level = getSupportedSimdLevel();
+    }
+    ActiveKernels& active = getActive();
+    active.kernels.store(getKernels(level), std::memory_order_relaxed);
+    active.level.store(level, std::memory_order_relaxed);
+    return level;
+}
+
+void transformPoints2(const Mat3& transform, const float* x, const float* y, float* outX, float* outY,
+                      std::size_t count) {
+    getActive().kernels.load(std::memory_order_relaxed)->transformPoints2(transform.m, x, y, outX, outY, count);
+}
+
+void transformPoints3(const Mat4& transform, const float* x, const float* y, const float* z, float* outX,
+                      float* outY, float* outZ, std::size_t count) {
+    getActive().kernels.load(std::memory_order_relaxed)->transformPoints3(transform.m, x, y, z, outX, outY, outZ,
+                                                                         count);
+}
+
+void mixStereo(const float* in, float* out, std::size_t frames, const float gains[4]) {
+    if (frames == 0) {
+        return;
+    }
+    getActive().kernels.load(std::memory_order_relaxed)->mixStereo(in, out, frames, gains);
+}
+
+void clampSamples(float* samples, std::size_t count) {
+    getActive().kernels.load(std::memory_order_relaxed)->clampSamples(samples, count);
+}
+
+} // namespace math
+} // namespace polaris
@@ -0,0 +1,72 @@
+#ifndef POLARIS_BATCH_H
+#define POLARIS_BATCH_H
+
+#include "math/Matrix.h"
+#include <cstddef>
+
+namespace polaris {
+namespace math {
+
+/**
+ * @brief Instruction sets the batch kernels are written for.
+ */
+enum class SimdLevel {
+    Scalar,
+    SSE2,
+    AVX2,   ///< AVX2 with FMA
+    NEON,
+};
+
+const char* getSimdLevelName(SimdLevel level);
+
+/**
+ * @brief Widest instruction set supported by both this build and the CPU it runs on,
+ * detected once on first use.
+ */
+SimdLevel getSupportedSimdLevel();
+
+/**
+ * @brief Instruction set the batch functions currently use; getSupportedSimdLevel() unless
+ * changed with setSimdLevel().
+ */
+SimdLevel getSimdLevel();
+
+/**
+ * @brief Restricts the batch functions to a narrower instruction set, e.g. to compare kernels
+ * in benchmarks. Levels this machine cannot run fall back to getSupportedSimdLevel().
+ * @return The level now in use.
+ */
+SimdLevel setSimdLevel(SimdLevel level);
+
+/**
+ * @brief Transforms count 2D points given as separate x and y arrays (SoA) by an affine
+ * transform. The output arrays may be the input arrays (in place) but must not otherwise
+ * overlap them. No alignment is required.
+ */
+void transformPoints2(const Mat3& transform, const float* x, const float* y, float* outX, float* outY,
+                      std::size_t count);
+
+/**
+ * @brief Transforms count 3D points given as separate x, y and z arrays. The projective row of
+ * the matrix is ignored (w is taken as 1). Same aliasing rules as transformPoints2.
+ */
+void transformPoints3(const Mat4& transform, const float* x, const float* y, const float* z, float* outX,
+                      float* outY, float* outZ, std::size_t count);
+
+/**
+ * @brief Adds frames of interleaved stereo audio (left, right) to out, scaled per channel.
+ * The gains ramp linearly from gains[0] (left) and gains[1] (right) at the first frame towards
+ * gains[2] and gains[3] at the end, so volume and pan changes do not click. in and out must
+ * not overlap.
+ */
+void mixStereo(const float* in, float* out, std::size_t frames, const float gains[4]);
+
+/**
+ * @brief Clamps count samples to [-1, 1] in place, e.g. a mix before it goes to the device.
+ */
+void clampSamples(float* samples, std::size_t count);
+
+} // namespace math
+} // namespace polaris
+
+#endif // POLARIS_BATCH_H
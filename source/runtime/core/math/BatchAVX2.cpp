@@ -0,0 +1,105 @@
+// Built with AVX2 and FMA enabled (see CMakeLists.txt) and only called once the CPU has been
+// checked for them, so keep standard headers out: their inline functions would be compiled
+// with AVX2 too and could end up shared with the rest of the program.
+#include "math/BatchKernels.h"
+
+#if (defined(__AVX2__) && defined(__FMA__)) || (defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86)))
+#define POLARIS_BATCH_AVX2 1
+#include <immintrin.h>
+#else
+#define POLARIS_BATCH_AVX2 0
+#endif
+
+namespace polaris {
+namespace math {
+
+#if POLARIS_BATCH_AVX2
+
+namespace {
+
+void transformPoints2AVX2(const float* m, const float* x, const float* y, float* outX, float* outY,
+                          std::size_t count) {
+    const __m256 m0 = _mm256_set1_ps(m[0]), m1 = _mm256_set1_ps(m[1]);
+    const __m256 m3 = _mm256_set1_ps(m[3]), m4 = _mm256_set1_ps(m[4]);
+    const __m256 m6 = _mm256_set1_ps(m[6]), m7 = _mm256_set1_ps(m[7]);
+
+    std::size_t i = 0;
+    for (; i + 8 <= count; i += 8) {
+        const __m256 px = _mm256_loadu_ps(x + i);
+        const __m256 py = _mm256_loadu_ps(y + i);
+        _mm256_storeu_ps(outX + i, _mm256_fmadd_ps(m0, px, _mm256_fmadd_ps(m3, py, m6)));
+        _mm256_storeu_ps(outY + i, _mm256_fmadd_ps(m1, px, _mm256_fmadd_ps(m4, py, m7)));
+    }
+    transformPoints2Scalar(m, x, y, outX, outY, i, count);
+    _mm256_zeroupper();
+}
+
+void transformPoints3AVX2(const float* m, const float* x, const float* y, const float* z, float* outX,
+                          float* outY, float* outZ, std::size_t count) {
+    const __m256 m0 = _mm256_set1_ps(m[0]), m1 = _mm256_set1_ps(m[1]), m2 = _mm256_set1_ps(m[2]);
+    const __m256 m4 = _mm256_set1_ps(m[4]), m5 = _mm256_set1_ps(m[5]), m6 = _mm256_set1_ps(m[6]);
+    const __m256 m8 = _mm256_set1_ps(m[8]), m9 = _mm256_set1_ps(m[9]), m10 = _mm256_set1_ps(m[10]);
+    const __m256 m12 = _mm256_set1_ps(m[12]), m13 = _mm256_set1_ps(m[13]), m14 = _mm256_set1_ps(m[14]);
+
+    std::size_t i = 0;
+    for (; i + 8 <= count; i += 8) {
+        const __m256 px = _mm256_loadu_ps(x + i);
+        const __m256 py = _mm256_loadu_ps(y + i);
+        const __m256 pz = _mm256_loadu_ps(z + i);
+        _mm256_storeu_ps(outX + i, _mm256_fmadd_ps(m0, px, _mm256_fmadd_ps(m4, py, _mm256_fmadd_ps(m8, pz, m12))));
+        _mm256_storeu_ps(outY + i, _mm256_fmadd_ps(m1, px, _mm256_fmadd_ps(m5, py, _mm256_fmadd_ps(m9, pz, m13))));
+        _mm256_storeu_ps(outZ + i, _mm256_fmadd_ps(m2, px, _mm256_fmadd_ps(m6, py, _mm256_fmadd_ps(m10, pz, m14))));
+    }
+    transformPoints3Scalar(m, x, y, z, outX, outY, outZ, i, count);
+    _mm256_zeroupper();
+}
+
+void mixStereoAVX2(const float* in, float* out, std::size_t frames, const float* gains) {
+    const float count = static_cast<float>(frames);
+    const float stepLeft = (gains[2] - gains[0]) / count;
+    const float stepRight = (gains[3] - gains[1]) / count;
+    const __m256 start = _mm256_setr_ps(gains[0], gains[1], gains[0] + stepLeft, gains[1] + stepRight,
+                                        gains[0] + 2.0f * stepLeft, gains[1] + 2.0f * stepRight,
+                                        gains[0] + 3.0f * stepLeft, gains[1] + 3.0f * stepRight);
+    const __m256 step = _mm256_setr_ps(stepLeft, stepRight, stepLeft, stepRight, stepLeft, stepRight, stepLeft,
+                                       stepRight);
+
+    std::size_t i = 0;
+    for (; i + 4 <= frames; i += 4) {
+        const __m256 gain = _mm256_fmadd_ps(step, _mm256_set1_ps(static_cast<float>(i)), start);
+        _mm256_storeu_ps(out + 2 * i, _mm256_fmadd_ps(_mm256_loadu_ps(in + 2 * i), gain, _mm256_loadu_ps(out + 2 * i)));
+    }
+    mixStereoScalar(in, out, gains, stepLeft, stepRight, i, frames);
+    _mm256_zeroupper();
+}
+
+void clampSamplesAVX2(float* samples, std::size_t count) {
+    const __m256 low = _mm256_set1_ps(-1.0f);
+    const __m256 high = _mm256_set1_ps(1.0f);
+
+    std::size_t i = 0;
+    for (; i + 8 <= count; i += 8) {
+        _mm256_storeu_ps(samples + i, _mm256_min_ps(_mm256_max_ps(_mm256_loadu_ps(samples + i), low), high));
+    }
+    clampSamplesScalar(samples, i, count);
+    _mm256_zeroupper();
+}
+
+const BatchKernels g_avx2Kernels = {transformPoints2AVX2, transformPoints3AVX2, mixStereoAVX2, clampSamplesAVX2};
+
+} // namespace
+
+const BatchKernels* getAVX2Kernels() {
+    return &g_avx2Kernels;
+}
+
+#else
+
+const BatchKernels* getAVX2Kernels() {
+    return nullptr;
+}
+
+#endif
+
+} // namespace math
+} // namespace polaris
@@ -0,0 +1,86 @@
+#ifndef POLARIS_BATCHKERNELS_H
+#define POLARIS_BATCHKERNELS_H
+
+// Internal to the math module: the per-instruction-set implementations behind math/Batch.h.
+//
+// BatchAVX2.cpp is compiled with AVX2 enabled, so this header must not define any non-static
+// inline function: the linker could pick the AVX2 build of it for every caller, and the
+// scalar path would then fault on older CPUs.
+
+#include <cstddef>
+
+namespace polaris {
+namespace math {
+
+/**
+ * @brief One instruction set's batch functions. Matrices are passed as their column-major
+ * float arrays.
+ */
+struct BatchKernels {
+    void (*transformPoints2)(const float* m, const float* x, const float* y, float* outX, float* outY,
+                             std::size_t count);
+    void (*transformPoints3)(const float* m, const float* x, const float* y, const float* z, float* outX,
+                             float* outY, float* outZ, std::size_t count);
+    /// gains are the start and end gains of math::mixStereo; frames is at least 1.
+    void (*mixStereo)(const float* in, float* out, std::size_t frames, const float* gains);
+    void (*clampSamples)(float* samples, std::size_t count);
+};
+
+/**
+ * @brief Kernel tables; the SIMD ones return null when this build does not target their
+ * instruction set.
+ */
+const BatchKernels* getScalarKernels();
+const BatchKernels* getSSE2Kernels();
+const BatchKernels* getAVX2Kernels();
+const BatchKernels* getNEONKernels();
+
+/**
+ * @brief Scalar loops for the elements left over after the last full vector.
+ */
+static inline void transformPoints2Scalar(const float* m, const float* x, const float* y, float* outX, float* outY,
+                                          std::size_t begin, std::size_t end) {
+    for (std::size_t i = begin; i < end; ++i) {
+        const float px = x[i];
+        const float py = y[i];
+        outX[i] = m[0] * px + m[3] * py + m[6];
+        outY[i] = m[1] * px + m[4] * py + m[7];
+    }
+}
+
+static inline void transformPoints3Scalar(const float* m, const float* x, const float* y, const float* z, float* outX,
+                                          float* outY, float* outZ, std::size_t begin, std::size_t end) {
+    for (std::size_t i = begin; i < end; ++i) {
+        const float px = x[i];
+        const float py = y[i];
+        const float pz = z[i];
+        outX[i] = m[0] * px + m[4] * py + m[8] * pz + m[12];
+        outY[i] = m[1] * px + m[5] * py + m[9] * pz + m[13];
+        outZ[i] = m[2] * px + m[6] * py + m[10] * pz + m[14];
+    }
+}
+
+/**
+ * @brief Mixes frames [begin, end) of math::mixStereo, the gain of frame i being
+ * gains[channel] + step * i.
+ */
+static inline void mixStereoScalar(const float* in, float* out, const float* gains, float stepLeft, float stepRight,
+                                   std::size_t begin, std::size_t end) {
+    for (std::size_t i = begin; i < end; ++i) {
+        const float frame = static_cast<float>(i);
+        out[2 * i] += in[2 * i] * (gains[0] + stepLeft * frame);
+        out[2 * i + 1] += in[2 * i + 1] * (gains[1] + stepRight * frame);
+    }
+}
+
+static inline void clampSamplesScalar(float* samples, std::size_t begin, std::size_t end) {
+    for (std::size_t i = begin; i < end; ++i) {
+        const float sample = samples[i];
+        samples[i] = sample < -1.0f ? -1.0f : (sample > 1.0f ? 1.0f : sample);
+    }
+}
+
+} // namespace math
+} // namespace polaris
+
+#endif // POLARIS_BATCHKERNELS_H
@@ -0,0 +1,106 @@
+#include "math/BatchKernels.h"
+
+#if defined(__ARM_NEON) || defined(_M_ARM64)
+#define POLARIS_BATCH_NEON 1
+#include <arm_neon.h>
+#else
+#define POLARIS_BATCH_NEON 0
+#endif
+
+namespace polaris {
+namespace math {
+
+#if POLARIS_BATCH_NEON
+
+namespace {
+
+/**
+ * @brief a + b * s; fused on AArch64, where FMA is always available.
+ */
+inline float32x4_t multiplyAdd(float32x4_t a, float32x4_t b, float s) {
+#if defined(__aarch64__) || defined(_M_ARM64)
+    return vfmaq_n_f32(a, b, s);
+#else
+    return vmlaq_n_f32(a, b, s);
+#endif
+}
+
+void transformPoints2NEON(const float* m, const float* x, const float* y, float* outX, float* outY,
+                          std::size_t count) {
+    const float32x4_t m6 = vdupq_n_f32(m[6]);
+    const float32x4_t m7 = vdupq_n_f32(m[7]);
+
+    std::size_t i = 0;
+    for (; i + 4 <= count; i += 4) {
+        const float32x4_t px = vld1q_f32(x + i);
+        const float32x4_t py = vld1q_f32(y + i);
+        vst1q_f32(outX + i, multiplyAdd(multiplyAdd(m6, px, m[0]), py, m[3]));
+        vst1q_f32(outY + i, multiplyAdd(multiplyAdd(m7, px, m[1]), py, m[4]));
+    }
+    transformPoints2Scalar(m, x, y, outX, outY, i, count);
+}
+
+void transformPoints3NEON(const float* m, const float* x, const float* y, const float* z, float* outX,
+                          float* outY, float* outZ, std::size_t count) {
+    const float32x4_t m12 = vdupq_n_f32(m[12]);
+    const float32x4_t m13 = vdupq_n_f32(m[13]);
+    const float32x4_t m14 = vdupq_n_f32(m[14]);
+
+    std::size_t i = 0;
+    for (; i + 4 <= count; i += 4) {
+        const float32x4_t px = vld1q_f32(x + i);
+        const float32x4_t py = vld1q_f32(y + i);
+        const float32x4_t pz = vld1q_f32(z + i);
+        vst1q_f32(outX + i, multiplyAdd(multiplyAdd(multiplyAdd(m12, px, m[0]), py, m[4]), pz, m[8]));
+        vst1q_f32(outY + i, multiplyAdd(multiplyAdd(multiplyAdd(m13, px, m[1]), py, m[5]), pz, m[9]));
+        vst1q_f32(outZ + i, multiplyAdd(multiplyAdd(multiplyAdd(m14, px, m[2]), py, m[6]), pz, m[10]));
+    }
+    transformPoints3Scalar(m, x, y, z, outX, outY, outZ, i, count);
+}
+
+void mixStereoNEON(const float* in, float* out, std::size_t frames, const float* gains) {
+    const float count = static_cast<float>(frames);
+    const float stepLeft = (gains[2] - gains[0]) / count;
+    const float stepRight = (gains[3] - gains[1]) / count;
+    const float startValues[4] = {gains[0], gains[1], gains[0] + stepLeft, gains[1] + stepRight};
+    const float stepValues[4] = {stepLeft, stepRight, stepLeft, stepRight};
+    const float32x4_t start = vld1q_f32(startValues);
+    const float32x4_t step = vld1q_f32(stepValues);
+
+    std::size_t i = 0;
+    for (; i + 2 <= frames; i += 2) {
+        const float32x4_t gain = multiplyAdd(start, step, static_cast<float>(i));
+        vst1q_f32(out + 2 * i, vaddq_f32(vld1q_f32(out + 2 * i), vmulq_f32(vld1q_f32(in + 2 * i), gain)));
+    }
+    mixStereoScalar(in, out, gains, stepLeft, stepRight, i, frames);
+}
+
+void clampSamplesNEON(float* samples, std::size_t count) {
+    const float32x4_t low = vdupq_n_f32(-1.0f);
+    const float32x4_t high = vdupq_n_f32(1.0f);
+
+    std::size_t i = 0;
+    for (; i + 4 <= count; i += 4) {
+        vst1q_f32(samples + i, vminq_f32(vmaxq_f32(vld1q_f32(samples + i), low), high));
+    }
+    clampSamplesScalar(samples, i, count);
+}
+
+const BatchKernels g_neonKernels = {transformPoints2NEON, transformPoints3NEON, mixStereoNEON, clampSamplesNEON};
+
+} // namespace
+
+const BatchKernels* getNEONKernels() {
+    return &g_neonKernels;
+}
+
+#else
+
+const BatchKernels* getNEONKernels() {
+    return nullptr;
+}
+
+#endif
+
+} // namespace math
+} // namespace polaris
@@ -0,0 +1,103 @@
+#include "math/BatchKernels.h"
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define POLARIS_BATCH_SSE2 1
+#include <emmintrin.h>
+#else
+#define POLARIS_BATCH_SSE2 0
+#endif
+
+namespace polaris {
+namespace math {
+
+#if POLARIS_BATCH_SSE2
+
+namespace {
+
+void transformPoints2SSE2(const float* m, const float* x, const float* y, float* outX, float* outY,
+                          std::size_t count) {
+    const __m128 m0 = _mm_set1_ps(m[0]), m1 = _mm_set1_ps(m[1]);
+    const __m128 m3 = _mm_set1_ps(m[3]), m4 = _mm_set1_ps(m[4]);
+    const __m128 m6 = _mm_set1_ps(m[6]), m7 = _mm_set1_ps(m[7]);
+
+    std::size_t i = 0;
+    for (; i + 4 <= count; i += 4) {
+        const __m128 px = _mm_loadu_ps(x + i);
+        const __m128 py = _mm_loadu_ps(y + i);
+        _mm_storeu_ps(outX + i, _mm_add_ps(_mm_add_ps(_mm_mul_ps(m0, px), _mm_mul_ps(m3, py)), m6));
+        _mm_storeu_ps(outY + i, _mm_add_ps(_mm_add_ps(_mm_mul_ps(m1, px), _mm_mul_ps(m4, py)), m7));
+    }
+    transformPoints2Scalar(m, x, y, outX, outY, i, count);
+}
+
+void transformPoints3SSE2(const float* m, const float* x, const float* y, const float* z, float* outX,
+                          float* outY, float* outZ, std::size_t count) {
+    const __m128 m0 = _mm_set1_ps(m[0]), m1 = _mm_set1_ps(m[1]), m2 = _mm_set1_ps(m[2]);
+    const __m128 m4 = _mm_set1_ps(m[4]), m5 = _mm_set1_ps(m[5]), m6 = _mm_set1_ps(m[6]);
+    const __m128 m8 = _mm_set1_ps(m[8]), m9 = _mm_set1_ps(m[9]), m10 = _mm_set1_ps(m[10]);
+    const __m128 m12 = _mm_set1_ps(m[12]), m13 = _mm_set1_ps(m[13]), m14 = _mm_set1_ps(m[14]);
+
+    std::size_t i = 0;
+    for (; i + 4 <= count; i += 4) {
+        const __m128 px = _mm_loadu_ps(x + i);
+        const __m128 py = _mm_loadu_ps(y + i);
+        const __m128 pz = _mm_loadu_ps(z + i);
+        _mm_storeu_ps(outX + i, _mm_add_ps(_mm_add_ps(_mm_mul_ps(m0, px), _mm_mul_ps(m4, py)),
+                                           _mm_add_ps(_mm_mul_ps(m8, pz), m12)));
+        _mm_storeu_ps(outY + i, _mm_add_ps(_mm_add_ps(_mm_mul_ps(m1, px), _mm_mul_ps(m5, py)),
+                                           _mm_add_ps(_mm_mul_ps(m9, pz), m13)));
+        _mm_storeu_ps(outZ + i, _mm_add_ps(_mm_add_ps(_mm_mul_ps(m2, px), _mm_mul_ps(m6, py)),
+                                           _mm_add_ps(_mm_mul_ps(m10, pz), m14)));
+    }
+    transformPoints3Scalar(m, x, y, z, outX, outY, outZ, i, count);
+}
+
+/**
+ * @brief Two stereo frames per vector; the gain of the pair starting at frame i is
+ * start + step * i.
+ */
+void mixStereoSSE2(const float* in, float* out, std::size_t frames, const float* gains) {
+    const float count = static_cast<float>(frames);
+    const float stepLeft = (gains[2] - gains[0]) / count;
+    const float stepRight = (gains[3] - gains[1]) / count;
+    const __m128 start = _mm_setr_ps(gains[0], gains[1], gains[0] + stepLeft, gains[1] + stepRight);
+    const __m128 step = _mm_setr_ps(stepLeft, stepRight, stepLeft, stepRight);
+
+    std::size_t i = 0;
+    for (; i + 2 <= frames; i += 2) {
+        const __m128 gain = _mm_add_ps(start, _mm_mul_ps(step, _mm_set1_ps(static_cast<float>(i))));
+        const __m128 sum = _mm_add_ps(_mm_loadu_ps(out + 2 * i), _mm_mul_ps(_mm_loadu_ps(in + 2 * i), gain));
+        _mm_storeu_ps(out + 2 * i, sum);
+    }
+    mixStereoScalar(in, out, gains, stepLeft, stepRight, i, frames);
+}
+
+void clampSamplesSSE2(float* samples, std::size_t count) {
+    const __m128 low = _mm_set1_ps(-1.0f);
+    const __m128 high = _mm_set1_ps(1.0f);
+
+    std::size_t i = 0;
+    for (; i + 4 <= count; i += 4) {
+        _mm_storeu_ps(samples + i, _mm_min_ps(_mm_max_ps(_mm_loadu_ps(samples + i), low), high));
+    }
+    clampSamplesScalar(samples, i, count);
+}
+
+const BatchKernels g_sse2Kernels = {transformPoints2SSE2, transformPoints3SSE2, mixStereoSSE2, clampSamplesSSE2};
+
+} // namespace
+
+const BatchKernels* getSSE2Kernels() {
+    return &g_sse2Kernels;
+}
+
+#else
+
+const BatchKernels* getSSE2Kernels() {
+    return nullptr;
+}
+
+#endif
+
+} // namespace math
+} // namespace polaris
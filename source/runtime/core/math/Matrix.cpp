@@ -0,0 +1,184 @@
+#include "math/Matrix.h"
+
+namespace polaris {
+namespace math {
+
+Mat3 Mat3::transposed() const {
+    Mat3 r;
+    for (int row = 0; row < 3; ++row) {
+        for (int c = 0; c < 3; ++c) {
+            r.m[c * 3 + row] = m[row * 3 + c];
+        }
+    }
+    return r;
+}
+
+/**
+ * @brief Inverse by the adjugate over the determinant.
+ */
+Mat3 Mat3::inverse() const {
+    const float a = m[0], b = m[3], c = m[6];
+    const float d = m[1], e = m[4], f = m[7];
+    const float g = m[2], h = m[5], i = m[8];
+
+    const float c00 = e * i - f * h;
+    const float c01 = f * g - d * i;
+    const float c02 = d * h - e * g;
+    const float det = a * c00 + b * c01 + c * c02;
+    if (det == 0.0f) {
+        return Mat3();
+    }
+    const float inv = 1.0f / det;
+
+    Mat3 r;
+    r(0, 0) = c00 * inv;
+    r(0, 1) = (c * h - b * i) * inv;
+    r(0, 2) = (b * f - c * e) * inv;
+    r(1, 0) = c01 * inv;
+    r(1, 1) = (a * i - c * g) * inv;
+    r(1, 2) = (c * d - a * f) * inv;
+    r(2, 0) = c02 * inv;
+    r(2, 1) = (b * g - a * h) * inv;
+    r(2, 2) = (a * e - b * d) * inv;
+    return r;
+}
+
+Mat4 Mat4::rotation(const Quat& q) {
+    const float xx = q.x * q.x, yy = q.y * q.y, zz = q.z * q.z;
+    const float xy = q.x * q.y, xz = q.x * q.z, yz = q.y * q.z;
+    const float wx = q.w * q.x, wy = q.w * q.y, wz = q.w * q.z;
+
+    Mat4 r;
+    r.m[0] = 1.0f - 2.0f * (yy + zz);
+    r.m[1] = 2.0f * (xy + wz);
+    r.m[2] = 2.0f * (xz - wy);
+    r.m[4] = 2.0f * (xy - wz);
+    r.m[5] = 1.0f - 2.0f * (xx + zz);
+    r.m[6] = 2.0f * (yz + wx);
+    r.m[8] = 2.0f * (xz + wy);
+    r.m[9] = 2.0f * (yz - wx);
+    r.m[10] = 1.0f - 2.0f * (xx + yy);
+    return r;
+}
+
+Mat4 Mat4::fromTRS(const Vec3& t, const Quat& q, const Vec3& s) {
+    Mat4 r = rotation(q);
+    for (int row = 0; row < 3; ++row) {
+        r.m[row] *= s.x;
+        r.m[4 + row] *= s.y;
+        r.m[8 + row] *= s.z;
+    }
+    r.m[12] = t.x;
+    r.m[13] = t.y;
+    r.m[14] = t.z;
+    return r;
+}
+
+Mat4 Mat4::orthographic(float left, float right, float bottom, float top, float nearPlane, float farPlane) {
+    Mat4 r;
+    r.m[0] = 2.0f / (right - left);
+    r.m[5] = 2.0f / (top - bottom);
+    r.m[10] = -2.0f / (farPlane - nearPlane);
+    r.m[12] = -(right + left) / (right - left);
+    r.m[13] = -(top + bottom) / (top - bottom);
+    r.m[14] = -(farPlane + nearPlane) / (farPlane - nearPlane);
+    return r;
+}
+
+Mat4 Mat4::perspective(float fovY, float aspect, float nearPlane, float farPlane) {
+    const float f = 1.0f / std::tan(fovY * 0.5f);
+    Mat4 r;
+    r.m[0] = f / aspect;
+    r.m[5] = f;
+    r.m[10] = (farPlane + nearPlane) / (nearPlane - farPlane);
+    r.m[11] = -1.0f;
+    r.m[14] = 2.0f * farPlane * nearPlane / (nearPlane - farPlane);
+    r.m[15] = 0.0f;
+    return r;
+}
+
+Mat4 Mat4::lookAt(const Vec3& eye, const Vec3& target, const Vec3& up) {
+    const Vec3 forward = normalize(target - eye);
+    const Vec3 side = normalize(cross(forward, up));
+    const Vec3 upward = cross(side, forward);
+
+    Mat4 r;
+    r.m[0] = side.x;
+    r.m[4] = side.y;
+    r.m[8] = side.z;
+    r.m[1] = upward.x;
+    r.m[5] = upward.y;
+    r.m[9] = upward.z;
+    r.m[2] = -forward.x;
+    r.m[6] = -forward.y;
+    r.m[10] = -forward.z;
+    r.m[12] = -dot(side, eye);
+    r.m[13] = -dot(upward, eye);
+    r.m[14] = dot(forward, eye);
+    return r;
+}
+
+Mat4 Mat4::transposed() const {
+    Mat4 r;
+    for (int row = 0; row < 4; ++row) {
+        for (int c = 0; c < 4; ++c) {
+            r.m[c * 4 + row] = m[row * 4 + c];
+        }
+    }
+    return r;
+}
+
+/**
+ * @brief Inverse by cofactor expansion over 2x2 sub-determinants.
+ */
+Mat4 Mat4::inverse() const {
+    const float* a = m;
+    float inv[16];
+
+    inv[0] = a[5] * a[10] * a[15] - a[5] * a[11] * a[14] - a[9] * a[6] * a[15] + a[9] * a[7] * a[14] +
+             a[13] * a[6] * a[11] - a[13] * a[7] * a[10];
+    inv[4] = -a[4] * a[10] * a[15] + a[4] * a[11] * a[14] + a[8] * a[6] * a[15] - a[8] * a[7] * a[14] -
+             a[12] * a[6] * a[11] + a[12] * a[7] * a[10];
+    inv[8] = a[4] * a[9] * a[15] - a[4] * a[11] * a[13] - a[8] * a[5] * a[15] + a[8] * a[7] * a[13] +
+             a[12] * a[5] * a[11] - a[12] * a[7] * a[9];
+    inv[12] = -a[4] * a[9] * a[14] + a[4] * a[10] * a[13] + a[8] * a[5] * a[14] - a[8] * a[6] * a[13] -
+              a[12] * a[5] * a[10] + a[12] * a[6] * a[9];
+    inv[1] = -a[1] * a[10] * a[15] + a[1] * a[11] * a[14] + a[9] * a[2] * a[15] - a[9] * a[3] * a[14] -
+             a[13] * a[2] * a[11] + a[13] * a[3] * a[10];
+    inv[5] = a[0] * a[10] * a[15] - a[0] * a[11] * a[14] - a[8] * a[2] * a[15] + a[8] * a[3] * a[14] +
+             a[12] * a[2] * a[11] - a[12] * a[3] * a[10];
+    inv[9] = -a[0] * a[9] * a[15] + a[0] * a[11] * a[13] + a[8] * a[1] * a[15] - a[8] * a[3] * a[13] -
+             a[12] * a[1] * a[11] + a[12] * a[3] * a[9];
+    inv[13] = a[0] * a[9] * a[14] - a[0] * a[10] * a[13] - a[8] * a[1] * a[14] + a[8] * a[2] * a[13] +
+              a[12] * a[1] * a[10] - a[12] * a[2] * a[9];
+    inv[2] = a[1] * a[6] * a[15] - a[1] * a[7] * a[14] - a[5] * a[2] * a[15] + a[5] * a[3] * a[14] +
+             a[13] * a[2] * a[7] - a[13] * a[3] * a[6];
+    inv[6] = -a[0] * a[6] * a[15] + a[0] * a[7] * a[14] + a[4] * a[2] * a[15] - a[4] * a[3] * a[14] -
+             a[12] * a[2] * a[7] + a[12] * a[3] * a[6];
+    inv[10] = a[0] * a[5] * a[15] - a[0] * a[7] * a[13] - a[4] * a[1] * a[15] + a[4] * a[3] * a[13] +
+              a[12] * a[1] * a[7] - a[12] * a[3] * a[5];
+    inv[14] = -a[0] * a[5] * a[14] + a[0] * a[6] * a[13] + a[4] * a[1] * a[14] - a[4] * a[2] * a[13] -
+              a[12] * a[1] * a[6] + a[12] * a[2] * a[5];
+    inv[3] = -a[1] * a[6] * a[11] + a[1] * a[7] * a[10] + a[5] * a[2] * a[11] - a[5] * a[3] * a[10] -
+             a[9] * a[2] * a[7] + a[9] * a[3] * a[6];
+    inv[7] = a[0] * a[6] * a[11] - a[0] * a[7] * a[10] - a[4] * a[2] * a[11] + a[4] * a[3] * a[10] +
+             a[8] * a[2] * a[7] - a[8] * a[3] * a[6];
+    inv[11] = -a[0] * a[5] * a[11] + a[0] * a[7] * a[9] + a[4] * a[1] * a[11] - a[4] * a[3] * a[9] -
+              a[8] * a[1] * a[7] + a[8] * a[3] * a[5];
+    inv[15] = a[0] * a[5] * a[10] - a[0] * a[6] * a[9] - a[4] * a[1] * a[10] + a[4] * a[2] * a[9] +
+              a[8] * a[1] * a[6] - a[8] * a[2] * a[5];
+
+    const float det = a[0] * inv[0] + a[1] * inv[4] + a[2] * inv[8] + a[3] * inv[12];
+    if (det == 0.0f) {
+        return Mat4();
+    }
+    const float scale = 1.0f / det;
+    Mat4 r;
+    for (int i = 0; i < 16; ++i) {
+        r.m[i] = inv[i] * scale;
+    }
+    return r;
+}
+
+} // namespace math
+} // namespace polaris
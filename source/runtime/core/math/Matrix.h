@@ -0,0 +1,187 @@
+#ifndef POLARIS_MATRIX_H
+#define POLARIS_MATRIX_H
+
+#include "math/Quaternion.h"
+#include "math/Vector.h"
+#include <cmath>
+
+namespace polaris {
+namespace math {
+
+/**
+ * @brief 3x3 matrix, column-major, used as a homogeneous 2D transform: points are (x, y, 1)
+ * columns multiplied from the right, so (a * b) applies b first.
+ */
+struct Mat3 {
+    float m[9] = {1.0f, 0.0f, 0.0f,
+                  0.0f, 1.0f, 0.0f,
+                  0.0f, 0.0f, 1.0f};
+
+    static Mat3 identity() { return {}; }
+
+    static Mat3 translation(const Vec2& t) {
+        Mat3 r;
+        r.m[6] = t.x;
+        r.m[7] = t.y;
+        return r;
+    }
+
+    /**
+     * @brief Counter-clockwise rotation by angle radians (clockwise on screen, where y points down).
+     */
+    static Mat3 rotation(float angle) {
+        const float c = std::cos(angle);
+        const float s = std::sin(angle);
+        Mat3 r;
+        r.m[0] = c;
+        r.m[1] = s;
+        r.m[3] = -s;
+        r.m[4] = c;
+        return r;
+    }
+
+    static Mat3 scale(const Vec2& s) {
+        Mat3 r;
+        r.m[0] = s.x;
+        r.m[4] = s.y;
+        return r;
+    }
+
+    /**
+     * @brief Scale, then rotate, then translate: the usual sprite or node transform.
+     */
+    static Mat3 fromTRS(const Vec2& t, float angle, const Vec2& s) {
+        const float c = std::cos(angle);
+        const float sn = std::sin(angle);
+        Mat3 r;
+        r.m[0] = c * s.x;
+        r.m[1] = sn * s.x;
+        r.m[3] = -sn * s.y;
+        r.m[4] = c * s.y;
+        r.m[6] = t.x;
+        r.m[7] = t.y;
+        return r;
+    }
+
+    /**
+     * @brief Element at row, column.
+     */
+    float& operator()(int row, int column) { return m[column * 3 + row]; }
+    float operator()(int row, int column) const { return m[column * 3 + row]; }
+
+    Mat3 operator*(const Mat3& o) const {
+        Mat3 r;
+        for (int c = 0; c < 3; ++c) {
+            for (int row = 0; row < 3; ++row) {
+                r.m[c * 3 + row] = m[row] * o.m[c * 3] + m[3 + row] * o.m[c * 3 + 1] + m[6 + row] * o.m[c * 3 + 2];
+            }
+        }
+        return r;
+    }
+
+    Vec2 transformPoint(const Vec2& p) const { return {m[0] * p.x + m[3] * p.y + m[6], m[1] * p.x + m[4] * p.y + m[7]}; }
+    Vec2 transformVector(const Vec2& v) const { return {m[0] * v.x + m[3] * v.y, m[1] * v.x + m[4] * v.y}; }
+
+    Mat3 transposed() const;
+
+    /**
+     * @brief General inverse; returns identity if the matrix is singular.
+     */
+    Mat3 inverse() const;
+};
+
+/**
+ * @brief 4x4 matrix, column-major (the layout GPU APIs expect), for column vectors multiplied
+ * from the right: (a * b) applies b first.
+ */
+struct Mat4 {
+    float m[16] = {1.0f, 0.0f, 0.0f, 0.0f,
+                   0.0f, 1.0f, 0.0f, 0.0f,
+                   0.0f, 0.0f, 1.0f, 0.0f,
+                   0.0f, 0.0f, 0.0f, 1.0f};
+
+    static Mat4 identity() { return {}; }
+
+    static Mat4 translation(const Vec3& t) {
+        Mat4 r;
+        r.m[12] = t.x;
+        r.m[13] = t.y;
+        r.m[14] = t.z;
+        return r;
+    }
+
+    static Mat4 scale(const Vec3& s) {
+        Mat4 r;
+        r.m[0] = s.x;
+        r.m[5] = s.y;
+        r.m[10] = s.z;
+        return r;
+    }
+
+    static Mat4 rotation(const Quat& q);
+
+    /**
+     * @brief Scale, then rotate, then translate.
+     */
+    static Mat4 fromTRS(const Vec3& t, const Quat& q, const Vec3& s);
+
+    /**
+     * @brief Orthographic projection of the box [left, right] x [bottom, top] x [near, far]
+     * onto clip space with z in [-1, 1]. For screen space with y down, pass top < bottom.
+     */
+    static Mat4 orthographic(float left, float right, float bottom, float top, float nearPlane, float farPlane);
+
+    /**
+     * @brief Right-handed perspective projection, z in [-1, 1]. fovY is in radians.
+     */
+    static Mat4 perspective(float fovY, float aspect, float nearPlane, float farPlane);
+
+    /**
+     * @brief Right-handed view matrix looking from eye towards target.
+     */
+    static Mat4 lookAt(const Vec3& eye, const Vec3& target, const Vec3& up);
+
+    float& operator()(int row, int column) { return m[column * 4 + row]; }
+    float operator()(int row, int column) const { return m[column * 4 + row]; }
+
+    Mat4 operator*(const Mat4& o) const {
+        Mat4 r;
+        for (int c = 0; c < 4; ++c) {
+            for (int row = 0; row < 4; ++row) {
+                r.m[c * 4 + row] = m[row] * o.m[c * 4] + m[4 + row] * o.m[c * 4 + 1] + m[8 + row] * o.m[c * 4 + 2] +
+                                   m[12 + row] * o.m[c * 4 + 3];
+            }
+        }
+        return r;
+    }
+
+    Vec4 operator*(const Vec4& v) const {
+        return {m[0] * v.x + m[4] * v.y + m[8] * v.z + m[12] * v.w, m[1] * v.x + m[5] * v.y + m[9] * v.z + m[13] * v.w,
+                m[2] * v.x + m[6] * v.y + m[10] * v.z + m[14] * v.w, m[3] * v.x + m[7] * v.y + m[11] * v.z + m[15] * v.w};
+    }
+
+    /**
+     * @brief Transforms a point, ignoring the projective row (w is taken as 1).
+     */
+    Vec3 transformPoint(const Vec3& p) const {
+        return {m[0] * p.x + m[4] * p.y + m[8] * p.z + m[12], m[1] * p.x + m[5] * p.y + m[9] * p.z + m[13],
+                m[2] * p.x + m[6] * p.y + m[10] * p.z + m[14]};
+    }
+
+    Vec3 transformVector(const Vec3& v) const {
+        return {m[0] * v.x + m[4] * v.y + m[8] * v.z, m[1] * v.x + m[5] * v.y + m[9] * v.z,
+                m[2] * v.x + m[6] * v.y + m[10] * v.z};
+    }
+
+    Mat4 transposed() const;
+
+    /**
+     * @brief General inverse; returns identity if the matrix is singular.
+     */
+    Mat4 inverse() const;
+};
+
+} // namespace math
+} // namespace polaris
+
+#endif // POLARIS_MATRIX_H
@@ -0,0 +1,102 @@
+#ifndef POLARIS_QUATERNION_H
+#define POLARIS_QUATERNION_H
+
+#include "math/Vector.h"
+#include <cmath>
+
+namespace polaris {
+namespace math {
+
+/**
+ * @brief Rotation quaternion, x/y/z the vector part and w the scalar part.
+ */
+struct Quat {
+    float x = 0.0f;
+    float y = 0.0f;
+    float z = 0.0f;
+    float w = 1.0f;
+
+    Quat() = default;
+    Quat(float x, float y, float z, float w) : x(x), y(y), z(z), w(w) {}
+
+    static Quat identity() { return {}; }
+
+    /**
+     * @brief Rotation by angle radians around axis, which must be unit length.
+     */
+    static Quat fromAxisAngle(const Vec3& axis, float angle) {
+        const float s = std::sin(angle * 0.5f);
+        return {axis.x * s, axis.y * s, axis.z * s, std::cos(angle * 0.5f)};
+    }
+
+    /**
+     * @brief Rotation by yaw around Y, then pitch around X, then roll around Z (radians).
+     */
+    static Quat fromEuler(float pitch, float yaw, float roll) {
+        return fromAxisAngle({0.0f, 1.0f, 0.0f}, yaw) * fromAxisAngle({1.0f, 0.0f, 0.0f}, pitch) *
+               fromAxisAngle({0.0f, 0.0f, 1.0f}, roll);
+    }
+
+    /**
+     * @brief Composition: (a * b) rotates by b first, then by a.
+     */
+    Quat operator*(const Quat& o) const {
+        return {w * o.x + x * o.w + y * o.z - z * o.y,
+                w * o.y - x * o.z + y * o.w + z * o.x,
+                w * o.z + x * o.y - y * o.x + z * o.w,
+                w * o.w - x * o.x - y * o.y - z * o.z};
+    }
+
+    bool operator==(const Quat& o) const { return x == o.x && y == o.y && z == o.z && w == o.w; }
+    bool operator!=(const Quat& o) const { return !(*this == o); }
+
+    /**
+     * @brief Inverse of a unit quaternion.
+     */
+    Quat conjugate() const { return {-x, -y, -z, w}; }
+
+    /**
+     * @brief Rotates v by this (unit) quaternion.
+     */
+    Vec3 rotate(const Vec3& v) const {
+        // v + 2w(q x v) + 2(q x (q x v)), without building a matrix
+        const Vec3 q(x, y, z);
+        const Vec3 t = cross(q, v) * 2.0f;
+        return v + t * w + cross(q, t);
+    }
+};
+
+inline float dot(const Quat& a, const Quat& b) { return a.x * b.x + a.y * b.y + a.z * b.z + a.w * b.w; }
+
+inline Quat normalize(const Quat& q) {
+    const float len = std::sqrt(dot(q, q));
+    return len > 0.0f ? Quat(q.x / len, q.y / len, q.z / len, q.w / len) : Quat();
+}
+
+/**
+ * @brief Spherical interpolation along the shorter arc between two unit quaternions.
+ */
+inline Quat slerp(const Quat& a, const Quat& b, float t) {
+    float cosine = dot(a, b);
+    Quat end = b;
+    if (cosine < 0.0f) {
+        cosine = -cosine;
+        end = Quat(-b.x, -b.y, -b.z, -b.w);
+    }
+
+    float wa = 1.0f - t;
+    float wb = t;
+    // Nearly parallel: the sine below vanishes, and a normalized lerp is indistinguishable
+    if (cosine < 0.9995f) {
+        const float angle = std::acos(cosine);
+        const float sine = std::sin(angle);
+        wa = std::sin(wa * angle) / sine;
+        wb = std::sin(wb * angle) / sine;
+    }
+    return normalize(Quat(a.x * wa + end.x * wb, a.y * wa + end.y * wb, a.z * wa + end.z * wb, a.w * wa + end.w * wb));
+}
+
+} // namespace math
+} // namespace polaris
+
+#endif // POLARIS_QUATERNION_H
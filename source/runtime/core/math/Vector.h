@@ -0,0 +1,122 @@
+#ifndef POLARIS_VECTOR_H
+#define POLARIS_VECTOR_H
+
+#include <cmath>
+
+namespace polaris {
+namespace math {
+
+/**
+ * @brief 2D vector. Plain data, so it can be stored in ECS components and vertex arrays.
+ */
+struct Vec2 {
+    float x = 0.0f;
+    float y = 0.0f;
+
+    Vec2() = default;
+    Vec2(float x, float y) : x(x), y(y) {}
+
+    Vec2 operator+(const Vec2& o) const { return {x + o.x, y + o.y}; }
+    Vec2 operator-(const Vec2& o) const { return {x - o.x, y - o.y}; }
+    Vec2 operator*(const Vec2& o) const { return {x * o.x, y * o.y}; }
+    Vec2 operator*(float s) const { return {x * s, y * s}; }
+    Vec2 operator/(float s) const { return {x / s, y / s}; }
+    Vec2 operator-() const { return {-x, -y}; }
+    Vec2& operator+=(const Vec2& o) { x += o.x; y += o.y; return *this; }
+    Vec2& operator-=(const Vec2& o) { x -= o.x; y -= o.y; return *this; }
+    Vec2& operator*=(float s) { x *= s; y *= s; return *this; }
+    bool operator==(const Vec2& o) const { return x == o.x && y == o.y; }
+    bool operator!=(const Vec2& o) const { return !(*this == o); }
+};
+
+/**
+ * @brief 3D vector.
+ */
+struct Vec3 {
+    float x = 0.0f;
+    float y = 0.0f;
+    float z = 0.0f;
+
+    Vec3() = default;
+    Vec3(float x, float y, float z) : x(x), y(y), z(z) {}
+
+    Vec3 operator+(const Vec3& o) const { return {x + o.x, y + o.y, z + o.z}; }
+    Vec3 operator-(const Vec3& o) const { return {x - o.x, y - o.y, z - o.z}; }
+    Vec3 operator*(const Vec3& o) const { return {x * o.x, y * o.y, z * o.z}; }
+    Vec3 operator*(float s) const { return {x * s, y * s, z * s}; }
+    Vec3 operator/(float s) const { return {x / s, y / s, z / s}; }
+    Vec3 operator-() const { return {-x, -y, -z}; }
+    Vec3& operator+=(const Vec3& o) { x += o.x; y += o.y; z += o.z; return *this; }
+    Vec3& operator-=(const Vec3& o) { x -= o.x; y -= o.y; z -= o.z; return *this; }
+    Vec3& operator*=(float s) { x *= s; y *= s; z *= s; return *this; }
+    bool operator==(const Vec3& o) const { return x == o.x && y == o.y && z == o.z; }
+    bool operator!=(const Vec3& o) const { return !(*this == o); }
+};
+
+/**
+ * @brief 4D vector, also used for homogeneous points.
+ */
+struct Vec4 {
+    float x = 0.0f;
+    float y = 0.0f;
+    float z = 0.0f;
+    float w = 0.0f;
+
+    Vec4() = default;
+    Vec4(float x, float y, float z, float w) : x(x), y(y), z(z), w(w) {}
+    Vec4(const Vec3& v, float w) : x(v.x), y(v.y), z(v.z), w(w) {}
+
+    Vec4 operator+(const Vec4& o) const { return {x + o.x, y + o.y, z + o.z, w + o.w}; }
+    Vec4 operator-(const Vec4& o) const { return {x - o.x, y - o.y, z - o.z, w - o.w}; }
+    Vec4 operator*(const Vec4& o) const { return {x * o.x, y * o.y, z * o.z, w * o.w}; }
+    Vec4 operator*(float s) const { return {x * s, y * s, z * s, w * s}; }
+    Vec4 operator/(float s) const { return {x / s, y / s, z / s, w / s}; }
+    Vec4 operator-() const { return {-x, -y, -z, -w}; }
+    Vec4& operator+=(const Vec4& o) { x += o.x; y += o.y; z += o.z; w += o.w; return *this; }
+    Vec4& operator-=(const Vec4& o) { x -= o.x; y -= o.y; z -= o.z; w -= o.w; return *this; }
+    Vec4& operator*=(float s) { x *= s; y *= s; z *= s; w *= s; return *this; }
+    bool operator==(const Vec4& o) const { return x == o.x && y == o.y && z == o.z && w == o.w; }
+    bool operator!=(const Vec4& o) const { return !(*this == o); }
+
+    Vec3 xyz() const { return {x, y, z}; }
+};
+
+inline Vec2 operator*(float s, const Vec2& v) { return v * s; }
+inline Vec3 operator*(float s, const Vec3& v) { return v * s; }
+inline Vec4 operator*(float s, const Vec4& v) { return v * s; }
+
+inline float dot(const Vec2& a, const Vec2& b) { return a.x * b.x + a.y * b.y; }
+inline float dot(const Vec3& a, const Vec3& b) { return a.x * b.x + a.y * b.y + a.z * b.z; }
+inline float dot(const Vec4& a, const Vec4& b) { return a.x * b.x + a.y * b.y + a.z * b.z + a.w * b.w; }
+
+/**
+ * @brief z component of the 3D cross product; positive if b is counter-clockwise from a.
+ */
+inline float cross(const Vec2& a, const Vec2& b) { return a.x * b.y - a.y * b.x; }
+
+inline Vec3 cross(const Vec3& a, const Vec3& b) {
+    return {a.y * b.z - a.z * b.y, a.z * b.x - a.x * b.z, a.x * b.y - a.y * b.x};
+}
+
+template <typename V>
+float lengthSquared(const V& v) { return dot(v, v); }
+
+template <typename V>
+float length(const V& v) { return std::sqrt(dot(v, v)); }
+
+/**
+ * @brief v scaled to unit length; the zero vector is returned unchanged.
+ */
+template <typename V>
+V normalize(const V& v) {
+    const float len = length(v);
+    return len > 0.0f ? v / len : v;
+}
+
+template <typename V>
+V lerp(const V& a, const V& b, float t) { return a + (b - a) * t; }
+
+} // namespace math
+} // namespace polaris
+
+#endif // POLARIS_VECTOR_H
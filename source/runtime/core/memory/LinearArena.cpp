@@ -0,0 +1,169 @@
+#include "memory/LinearArena.h"
+#include <algorithm>
+#include <cstdint>
+
+namespace polaris {
+
+namespace {
+
+/**
+ * @brief Size of the first block of an arena created without a capacity.
+ */
+constexpr std::size_t kMinBlockSize = 4096;
+
+} // namespace
+
+/**
+ * @brief Creates an arena, allocating its first block if a capacity is given.
+ */
+LinearArena::LinearArena(std::size_t capacity) {
+    if (capacity > 0) {
+        addBlock(capacity, 0);
+    }
+}
+
+LinearArena::~LinearArena() {
+    releaseBlocks();
+}
+
+/**
+ * @brief Replaces the blocks with one of at least the given size, if nothing is allocated.
+ */
+void LinearArena::reserve(std::size_t capacity) {
+    if (getUsed() != 0 || capacity <= m_capacity) {
+        return;
+    }
+    releaseBlocks();
+    addBlock(capacity, 0);
+}
+
+/**
+ * @brief Bumps the offset in the current block, moving to another block if it is full.
+ */
+void* LinearArena::allocate(std::size_t size, std::size_t alignment) {
+    if (!m_blocks.empty()) {
+        const Block& block = m_blocks[m_current];
+        const std::uintptr_t base = reinterpret_cast<std::uintptr_t>(block.data);
+        const std::uintptr_t aligned = (base + m_offset + alignment - 1) & ~(static_cast<std::uintptr_t>(alignment) - 1);
+        const std::size_t end = static_cast<std::size_t>(aligned - base) + size;
+        if (end <= block.size) {
+            m_offset = end;
+            m_peak = std::max(m_peak, m_base + m_offset);
+            return reinterpret_cast<void*>(aligned);
+        }
+    }
+    return allocateSlow(size, alignment);
+}
+
+/**
+ * @brief Continues in the next block if the allocation fits there, otherwise inserts a new
+ * block after the current one.
+ */
+void* LinearArena::allocateSlow(std::size_t size, std::size_t alignment) {
+    std::size_t next = m_blocks.empty() ? 0 : m_current + 1;
+    if (next >= m_blocks.size() || m_blocks[next].size < size + alignment) {
+        addBlock(std::max(size + alignment, m_capacity == 0 ? kMinBlockSize : m_capacity), next);
+    }
+    if (!m_blocks.empty() && next != m_current) {
+        m_base += m_blocks[m_current].size;
+    }
+    m_current = next;
+    m_offset = 0;
+    return allocate(size, alignment);
+}
+
+/**
+ * @brief Frees everything; a grown chain of blocks is merged into one block of the same total.
+ */
+void LinearArena::reset() {
+    if (m_blocks.size() > 1) {
+        const std::size_t capacity = m_capacity;
+        releaseBlocks();
+        addBlock(capacity, 0);
+    }
+    m_current = 0;
+    m_offset = 0;
+    m_base = 0;
+}
+
+/**
+ * @brief Rewinds to a marker; rewinding to the very start is a reset().
+ */
+void LinearArena::rewind(const Marker& marker) {
+    if (marker.block == 0 && marker.offset == 0) {
+        reset();
+        return;
+    }
+    m_current = marker.block;
+    m_offset = marker.offset;
+    m_base = 0;
+    for (std::size_t i = 0; i < m_current; ++i) {
+        m_base += m_blocks[i].size;
+    }
+}
+
+/**
+ * @brief Allocates a block and inserts it at the given position in the chain.
+ */
+void LinearArena::addBlock(std::size_t size, std::size_t at) {
+    Block block;
+    block.data = static_cast<unsigned char*>(::operator new(size));
+    block.size = size;
+    m_blocks.insert(m_blocks.begin() + static_cast<std::ptrdiff_t>(at), block);
+    m_capacity += size;
+}
+
+void LinearArena::releaseBlocks() {
+    for (const Block& block : m_blocks) {
+        ::operator delete(block.data);
+    }
+    m_blocks.clear();
+    m_capacity = 0;
+    m_current = 0;
+    m_offset = 0;
+    m_base = 0;
+}
+
+/**
+ * @brief Creates both arenas with the given capacity.
+ */
+FrameArena::FrameArena(std::size_t capacity)
+    : m_arenas{LinearArena(capacity), LinearArena(capacity)},
+      m_resources{ArenaResource(m_arenas[0]), ArenaResource(m_arenas[1])} {
+}
+
+void FrameArena::reserve(std::size_t capacity) {
+    m_arenas[0].reserve(capacity);
+    m_arenas[1].reserve(capacity);
+}
+
+/**
+ * @brief Switches arenas; the one being switched to held the frame before last.
+ */
+void FrameArena::beginFrame() {
+    m_index ^= 1u;
+    m_arenas[m_index].reset();
+}
+
+void FrameArena::release() {
+    m_arenas[0].release();
+    m_arenas[1].release();
+}
+
+std::size_t FrameArena::getPeak() const {
+    return std::max(m_arenas[0].getPeak(), m_arenas[1].getPeak());
+}
+
+/**
+ * @brief Returns the calling thread's arena, created with the default capacity on first use.
+ */
+LinearArena& ScratchArena::get() {
+    thread_local LinearArena arena(kDefaultCapacity);
+    return arena;
+}
+
+void ScratchArena::reserve(std::size_t capacity) {
+    get().reserve(capacity);
+}
+
+} // namespace polaris
@@ -0,0 +1,282 @@
+#ifndef POLARIS_LINEARARENA_H
+#define POLARIS_LINEARARENA_H
+
+#include <cstddef>
+#include <memory_resource>
+#include <new>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace polaris {
+
+/**
+ * @brief Bump allocator: allocation is a pointer increment, and everything is freed at once
+ * by reset() or rewind().
+ *
+ * Memory comes from one or more heap blocks. When a block is full the arena chains a new one
+ * (at least twice as large), and the next reset() replaces the chain with a single block of
+ * the combined size, so after a warm-up frame or two the arena stops touching the heap.
+ * Destructors are never run; store only trivially destructible data, or destroy objects
+ * yourself before resetting. Not thread-safe.
+ */
+class LinearArena {
+public:
+    /**
+     * @brief Position in the arena, for rewinding to it later. See getMarker().
+     */
+    struct Marker {
+        std::size_t block = 0;
+        std::size_t offset = 0;
+    };
+
+    /**
+     * @param capacity Size of the first block in bytes; 0 defers allocation to first use.
+     */
+    explicit LinearArena(std::size_t capacity = 0);
+    ~LinearArena();
+
+    LinearArena(const LinearArena&) = delete;
+    LinearArena& operator=(const LinearArena&) = delete;
+
+    /**
+     * @brief Ensures the arena holds at least this many bytes without growing.
+     * Only takes effect while the arena is empty.
+     */
+    void reserve(std::size_t capacity);
+
+    /**
+     * @brief Returns uninitialized memory; never returns null.
+     * @param size Bytes to allocate.
+     * @param alignment Power of two.
+     * @throws std::bad_alloc if a new block cannot be allocated.
+     */
+    void* allocate(std::size_t size, std::size_t alignment = alignof(std::max_align_t));
+
+    /**
+     * @brief Returns uninitialized storage for count objects of type T.
+     */
+    template <typename T>
+    T* allocateArray(std::size_t count) {
+        return static_cast<T*>(allocate(sizeof(T) * count, alignof(T)));
+    }
+
+    /**
+     * @brief Constructs a T in the arena. It is never destroyed, so T must be trivially destructible.
+     */
+    template <typename T, typename... Args>
+    T* create(Args&&... args) {
+        static_assert(std::is_trivially_destructible<T>::value, "LinearArena never runs destructors");
+        return new (allocate(sizeof(T), alignof(T))) T(std::forward<Args>(args)...);
+    }
+
+    /**
+     * @brief Releases every allocation, and merges the blocks into one if the arena grew.
+     */
+    void reset();
+
+    /**
+     * @brief Returns the current position; rewind() to it releases everything allocated since.
+     */
+    Marker getMarker() const { return Marker{m_current, m_offset}; }
+
+    /**
+     * @brief Releases everything allocated after the marker was taken.
+     */
+    void rewind(const Marker& marker);
+
+    /**
+     * @brief Frees every block. The arena can still be used; it allocates again on demand.
+     */
+    void release() {
+        releaseBlocks();
+        std::vector<Block>().swap(m_blocks);
+    }
+
+    /**
+     * @brief Bytes allocated since the last reset, including alignment padding and the
+     * unused ends of filled blocks.
+     */
+    std::size_t getUsed() const { return m_base + m_offset; }
+
+    /**
+     * @brief Bytes held in all blocks.
+     */
+    std::size_t getCapacity() const { return m_capacity; }
+
+    /**
+     * @brief Largest getUsed() value seen so far.
+     */
+    std::size_t getPeak() const { return m_peak; }
+
+private:
+    struct Block {
+        unsigned char* data;
+        std::size_t size;
+    };
+
+    void* allocateSlow(std::size_t size, std::size_t alignment);
+    void addBlock(std::size_t size, std::size_t at);
+    void releaseBlocks();
+
+    std::vector<Block> m_blocks;
+    std::size_t m_current = 0;   ///< Block being allocated from
+    std::size_t m_offset = 0;    ///< Bytes used in m_blocks[m_current]
+    std::size_t m_base = 0;      ///< Combined size of the blocks before m_current
+    std::size_t m_capacity = 0;
+    std::size_t m_peak = 0;
+};
+
+/**
+ * @brief std::pmr adapter for a LinearArena, so standard containers can allocate from it.
+ * deallocate() does nothing; the memory comes back when the arena is reset.
+ */
+class ArenaResource : public std::pmr::memory_resource {
+public:
+    explicit ArenaResource(LinearArena& arena) : m_arena(&arena) {}
+
+    LinearArena& getArena() const { return *m_arena; }
+
+private:
+    void* do_allocate(std::size_t bytes, std::size_t alignment) override {
+        return m_arena->allocate(bytes, alignment);
+    }
+
+    void do_deallocate(void*, std::size_t, std::size_t) override {}
+
+    bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override {
+        return this == &other;
+    }
+
+    LinearArena* m_arena;
+};
+
+/**
+ * @brief Double-buffered per-frame arena.
+ *
+ * beginFrame() switches to the other arena and resets it, so memory allocated during a frame
+ * stays valid until the end of the next one. Use it for data that lives for a frame, such as
+ * culled draw lists or temporary arrays built in update() and read in render(). Main thread
+ * only; the render thread never sees it, since command lists copy what they record.
+ */
+class FrameArena {
+public:
+    /**
+     * @param capacity Initial size of each of the two arenas; 0 defers allocation to first use.
+     */
+    explicit FrameArena(std::size_t capacity = 0);
+
+    FrameArena(const FrameArena&) = delete;
+    FrameArena& operator=(const FrameArena&) = delete;
+
+    /**
+     * @brief Sizes both arenas. Only takes effect while they are empty.
+     */
+    void reserve(std::size_t capacity);
+
+    /**
+     * @brief Starts a new frame: frees the allocations made two frames ago.
+     */
+    void beginFrame();
+
+    /**
+     * @brief Frees both arenas' memory, e.g. at shutdown.
+     */
+    void release();
+
+    void* allocate(std::size_t size, std::size_t alignment = alignof(std::max_align_t)) {
+        return getArena().allocate(size, alignment);
+    }
+
+    template <typename T>
+    T* allocateArray(std::size_t count) {
+        return getArena().allocateArray<T>(count);
+    }
+
+    /**
+     * @brief The arena for the current frame.
+     */
+    LinearArena& getArena() { return m_arenas[m_index]; }
+
+    /**
+     * @brief Memory resource for std::pmr containers that live until the end of the next frame.
+     */
+    std::pmr::memory_resource* getResource() { return &m_resources[m_index]; }
+
+    /**
+     * @brief Bytes allocated from the current frame's arena.
+     */
+    std::size_t getUsed() const { return m_arenas[m_index].getUsed(); }
+
+    /**
+     * @brief Largest per-frame usage seen by either arena.
+     */
+    std::size_t getPeak() const;
+
+private:
+    LinearArena m_arenas[2];
+    ArenaResource m_resources[2];
+    unsigned m_index = 0;
+};
+
+/**
+ * @brief Per-thread scratch arena for short-lived temporaries inside a function or job.
+ *
+ * Allocate through a ScratchScope, which rewinds the arena when it goes out of scope, so
+ * scopes nest naturally. Job system workers reserve their arena when they start, so jobs can
+ * use it without touching the heap.
+ */
+class ScratchArena {
+public:
+    /**
+     * @brief Default size of a thread's scratch arena, used when it is first touched.
+     */
+    static constexpr std::size_t kDefaultCapacity = 256 * 1024;
+
+    /**
+     * @brief The calling thread's scratch arena.
+     */
+    static LinearArena& get();
+
+    /**
+     * @brief Sizes the calling thread's scratch arena, e.g. when a worker thread starts.
+     */
+    static void reserve(std::size_t capacity);
+};
+
+/**
+ * @brief RAII scope on the calling thread's scratch arena; everything allocated through it is
+ * released when the scope ends.
+ */
+class ScratchScope {
+public:
+    ScratchScope()
+        : m_arena(ScratchArena::get()), m_marker(m_arena.getMarker()), m_resource(m_arena) {}
+    ~ScratchScope() { m_arena.rewind(m_marker); }
+
+    ScratchScope(const ScratchScope&) = delete;
+    ScratchScope& operator=(const ScratchScope&) = delete;
+
+    void* allocate(std::size_t size, std::size_t alignment = alignof(std::max_align_t)) {
+        return m_arena.allocate(size, alignment);
+    }
+
+    template <typename T>
+    T* allocateArray(std::size_t count) {
+        return m_arena.allocateArray<T>(count);
+    }
+
+    /**
+     * @brief Memory resource for std::pmr containers that do not outlive the scope.
+     */
+    std::pmr::memory_resource* getResource() { return &m_resource; }
+
+private:
+    LinearArena& m_arena;
+    LinearArena::Marker m_marker;
+    ArenaResource m_resource;
+};
+
+} // namespace polaris
+
+#endif // POLARIS_LINEARARENA_H
@@ -0,0 +1,551 @@
+#include "memory/MemoryTracker.h"
+#include "Logger.h"
+
+#if POLARIS_ENABLE_MEMORY_TRACKING
+#include <algorithm>
+#include <atomic>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <mutex>
+#include <new>
+#include <vector>
+
+#if defined(_WIN32)
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#else
+#include <cxxabi.h>
+#include <dlfcn.h>
+#include <unwind.h>
+#endif
+#endif
+
+namespace polaris {
+
+namespace {
+
+const char* const kTagNames[] = {
+    "Untagged", "Engine", "Renderer", "Logger", "Profiler", "Assets", "Audio", "Application",
+};
+
+static_assert(sizeof(kTagNames) / sizeof(kTagNames[0]) == static_cast<std::size_t>(MemoryTag::Count),
+              "Every MemoryTag needs a name");
+
+#if POLARIS_ENABLE_MEMORY_TRACKING
+
+constexpr std::size_t kTagCount = static_cast<std::size_t>(MemoryTag::Count);
+
+/**
+ * @brief Live lists are split this many ways so threads rarely contend for the same lock.
+ */
+constexpr std::size_t kShardCount = 16;
+
+constexpr int kCallstackDepth = POLARIS_MEMORY_CALLSTACK_DEPTH;
+
+// The capture skips a fixed number of frames (its own, trackedAllocate's and operator new's),
+// so those two must stay real frames
+#if defined(_MSC_VER)
+#define POLARIS_MEMORY_NOINLINE __declspec(noinline)
+#else
+#define POLARIS_MEMORY_NOINLINE __attribute__((noinline))
+#endif
+
+enum HeaderFlags : std::uint8_t {
+    kTracked = 1,        ///< Counted and linked into a live list
+    kAlignedBlock = 2,   ///< Block came from the over-aligned allocator
+};
+
+/**
+ * @brief Placed directly in front of every block returned by operator new.
+ */
+struct alignas(std::max_align_t) AllocationHeader {
+    AllocationHeader* prev;
+    AllocationHeader* next;
+    std::size_t size;
+    std::uint64_t sequence;
+    std::uint32_t offset;       ///< Bytes from the start of the underlying block to the header
+    std::uint8_t tag;
+    std::uint8_t shard;
+    std::uint8_t flags;
+    std::uint8_t frameCount;
+#if POLARIS_MEMORY_CALLSTACK_DEPTH > 0
+    void* callstack[kCallstackDepth];
+#endif
+};
+
+struct Shard {
+    std::mutex mutex;
+    AllocationHeader* head = nullptr;
+};
+
+struct TagCounters {
+    std::atomic<std::uint64_t> liveBytes{0};
+    std::atomic<std::uint64_t> peakBytes{0};
+    std::atomic<std::uint64_t> liveCount{0};
+    std::atomic<std::uint64_t> totalAllocations{0};
+};
+
+// All constant-initialized, so they work for allocations made before main()
+Shard g_shards[kShardCount];
+TagCounters g_tags[kTagCount];
+std::atomic<std::uint64_t> g_sequence{0};
+std::atomic<std::uint64_t> g_allocations{0};
+std::atomic<std::uint64_t> g_deallocations{0};
+std::atomic<std::uint64_t> g_bytesAllocated{0};
+std::atomic<bool> g_captureCallstacks{true};
+std::atomic<unsigned> g_nextShard{0};
+
+thread_local MemoryTag t_tag = MemoryTag::Untagged;
+thread_local int t_shard = -1;
+thread_local bool t_untracked = false;   ///< Set while the tracker itself allocates
+
+/**
+ * @brief Makes the calling thread's allocations untracked for the lifetime of the scope.
+ */
+class UntrackedScope {
+public:
+    UntrackedScope() : m_previous(t_untracked) { t_untracked = true; }
+    ~UntrackedScope() { t_untracked = m_previous; }
+
+private:
+    bool m_previous;
+};
+
+std::size_t roundUp(std::size_t value, std::size_t alignment) {
+    return (value + alignment - 1) & ~(alignment - 1);
+}
+
+void* allocateAlignedBlock(std::size_t size, std::size_t alignment) {
+#if defined(_WIN32)
+    return _aligned_malloc(size, alignment);
+#else
+    return std::aligned_alloc(alignment, roundUp(size, alignment));
+#endif
+}
+
+void freeAlignedBlock(void* block) {
+#if defined(_WIN32)
+    _aligned_free(block);
+#else
+    std::free(block);
+#endif
+}
+
+#if POLARIS_MEMORY_CALLSTACK_DEPTH > 0 && !defined(_WIN32)
+struct UnwindState {
+    void** frames;
+    int count;
+    int skip;
+};
+
+_Unwind_Reason_Code unwindFrame(_Unwind_Context* context, void* argument) {
+    UnwindState* state = static_cast<UnwindState*>(argument);
+    const std::uintptr_t address = _Unwind_GetIP(context);
+    if (address == 0) {
+        return _URC_END_OF_STACK;
+    }
+    if (state->skip > 0) {
+        --state->skip;
+        return _URC_NO_REASON;
+    }
+    state->frames[state->count++] = reinterpret_cast<void*>(address);
+    return state->count < kCallstackDepth ? _URC_NO_REASON : _URC_END_OF_STACK;
+}
+#endif
+
+/**
+ * @brief Stores the caller's return addresses, skipping the tracker's own frames.
+ * @return Number of frames stored.
+ */
+POLARIS_MEMORY_NOINLINE int captureCallstack(void** frames) {
+#if POLARIS_MEMORY_CALLSTACK_DEPTH == 0
+    (void)frames;
+    return 0;
+#elif defined(_WIN32)
+    return static_cast<int>(RtlCaptureStackBackTrace(3, kCallstackDepth, frames, nullptr));
+#else
+    UnwindState state{frames, 0, 3};
+    _Unwind_Backtrace(unwindFrame, &state);
+    return state.count;
+#endif
+}
+
+int threadShard() {
+    if (t_shard < 0) {
+        t_shard = static_cast<int>(g_nextShard.fetch_add(1, std::memory_order_relaxed) % kShardCount);
+    }
+    return t_shard;
+}
+
+/**
+ * @brief Allocates a block with a header in front of it and, unless the thread is untracked,
+ * charges it to the thread's tag and links it into a live list.
+ * @return The user pointer, or null if the underlying allocation failed.
+ */
+POLARIS_MEMORY_NOINLINE void* trackedAllocate(std::size_t size, std::size_t alignment) noexcept {
+    const bool overAligned = alignment > alignof(AllocationHeader);
+    const std::size_t prefix = overAligned ? roundUp(sizeof(AllocationHeader), alignment) : sizeof(AllocationHeader);
+    void* block = overAligned ? allocateAlignedBlock(prefix + size, alignment) : std::malloc(prefix + size);
+    if (!block) {
+        return nullptr;
+    }
+
+    unsigned char* user = static_cast<unsigned char*>(block) + prefix;
+    AllocationHeader* header = reinterpret_cast<AllocationHeader*>(user) - 1;
+    header->prev = nullptr;
+    header->next = nullptr;
+    header->size = size;
+    header->sequence = 0;
+    header->offset = static_cast<std::uint32_t>(prefix - sizeof(AllocationHeader));
+    header->tag = static_cast<std::uint8_t>(MemoryTag::Untagged);
+    header->shard = 0;
+    header->flags = overAligned ? kAlignedBlock : 0;
+    header->frameCount = 0;
+    if (t_untracked) {
+        return user;
+    }
+
+    const MemoryTag tag = t_tag;
+    TagCounters& counters = g_tags[static_cast<std::size_t>(tag)];
+    const std::uint64_t live = counters.liveBytes.fetch_add(size, std::memory_order_relaxed) + size;
+    std::uint64_t peak = counters.peakBytes.load(std::memory_order_relaxed);
+    while (live > peak && !counters.peakBytes.compare_exchange_weak(peak, live, std::memory_order_relaxed)) {
+    }
+    counters.liveCount.fetch_add(1, std::memory_order_relaxed);
+    counters.totalAllocations.fetch_add(1, std::memory_order_relaxed);
+    g_allocations.fetch_add(1, std::memory_order_relaxed);
+    g_bytesAllocated.fetch_add(size, std::memory_order_relaxed);
+
+    header->tag = static_cast<std::uint8_t>(tag);
+    header->flags |= kTracked;
+    header->sequence = g_sequence.fetch_add(1, std::memory_order_relaxed) + 1;
+#if POLARIS_MEMORY_CALLSTACK_DEPTH > 0
+    if (g_captureCallstacks.load(std::memory_order_relaxed)) {
+        header->frameCount = static_cast<std::uint8_t>(captureCallstack(header->callstack));
+    }
+#endif
+
+    const int shardIndex = threadShard();
+    header->shard = static_cast<std::uint8_t>(shardIndex);
+    Shard& shard = g_shards[shardIndex];
+    std::lock_guard<std::mutex> lock(shard.mutex);
+    header->next = shard.head;
+    if (shard.head) {
+        shard.head->prev = header;
+    }
+    shard.head = header;
+    return user;
+}
+
+void trackedFree(void* pointer) noexcept {
+    if (!pointer) {
+        return;
+    }
+
+    AllocationHeader* header = static_cast<AllocationHeader*>(pointer) - 1;
+    if (header->flags & kTracked) {
+        {
+            Shard& shard = g_shards[header->shard];
+            std::lock_guard<std::mutex> lock(shard.mutex);
+            if (header->prev) {
+                header->prev->next = header->next;
+            } else {
+                shard.head = header->next;
+            }
+            if (header->next) {
+                header->next->prev = header->prev;
+            }
+        }
+        TagCounters& counters = g_tags[header->tag];
+        counters.liveBytes.fetch_sub(header->size, std::memory_order_relaxed);
+        counters.liveCount.fetch_sub(1, std::memory_order_relaxed);
+        g_deallocations.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    void* block = reinterpret_cast<unsigned char*>(header) - header->offset;
+    if (header->flags & kAlignedBlock) {
+        freeAlignedBlock(block);
+    } else {
+        std::free(block);
+    }
+}
+
+/**
+ * @brief A live allocation copied out of the live lists for the report.
+ */
+struct LiveAllocation {
+    std::size_t size;
+    std::uint8_t tag;
+    std::uint8_t frameCount;
+    void* callstack[kCallstackDepth > 0 ? kCallstackDepth : 1];
+};
+
+bool sameSite(const LiveAllocation& a, const LiveAllocation& b) {
+    return a.tag == b.tag && a.frameCount == b.frameCount &&
+           std::equal(a.callstack, a.callstack + a.frameCount, b.callstack);
+}
+
+bool siteLess(const LiveAllocation& a, const LiveAllocation& b) {
+    if (a.tag != b.tag) {
+        return a.tag < b.tag;
+    }
+    if (a.frameCount != b.frameCount) {
+        return a.frameCount < b.frameCount;
+    }
+    return std::lexicographical_compare(a.callstack, a.callstack + a.frameCount, b.callstack, b.callstack + b.frameCount);
+}
+
+void writeFrame(std::FILE* file, int index, void* address) {
+#if defined(_WIN32)
+    std::fprintf(file, "    #%d %p\n", index, address);
+#else
+    Dl_info info;
+    if (dladdr(address, &info) && info.dli_sname) {
+        int status = 0;
+        char* demangled = abi::__cxa_demangle(info.dli_sname, nullptr, nullptr, &status);
+        const char* name = status == 0 && demangled ? demangled : info.dli_sname;
+        std::fprintf(file, "    #%d %p %s+0x%zx (%s)\n", index, address, name,
+                     static_cast<std::size_t>(static_cast<char*>(address) - static_cast<char*>(info.dli_saddr)),
+                     info.dli_fname ? info.dli_fname : "?");
+        std::free(demangled);
+    } else {
+        std::fprintf(file, "    #%d %p (%s)\n", index, address, info.dli_fname ? info.dli_fname : "?");
+    }
+#endif
+}
+
+#endif // POLARIS_ENABLE_MEMORY_TRACKING
+
+} // namespace
+
+const char* getMemoryTagName(MemoryTag tag) {
+    const std::size_t index = static_cast<std::size_t>(tag);
+    return index < static_cast<std::size_t>(MemoryTag::Count) ? kTagNames[index] : "Unknown";
+}
+
+MemoryTracker& MemoryTracker::getInstance() {
+    static MemoryTracker instance;
+    return instance;
+}
+
+#if POLARIS_ENABLE_MEMORY_TRACKING
+
+MemoryTag MemoryTracker::getThreadTag() {
+    return t_tag;
+}
+
+void MemoryTracker::setThreadTag(MemoryTag tag) {
+    t_tag = tag;
+}
+
+void MemoryTracker::setCallstackCapture(bool enabled) {
+    g_captureCallstacks.store(enabled, std::memory_order_relaxed);
+}
+
+std::uint64_t MemoryTracker::getSequence() const {
+    return g_sequence.load(std::memory_order_relaxed);
+}
+
+MemoryTagStats MemoryTracker::getTagStats(MemoryTag tag) const {
+    const TagCounters& counters = g_tags[static_cast<std::size_t>(tag)];
+    MemoryTagStats stats;
+    stats.liveBytes = counters.liveBytes.load(std::memory_order_relaxed);
+    stats.peakBytes = counters.peakBytes.load(std::memory_order_relaxed);
+    stats.liveCount = counters.liveCount.load(std::memory_order_relaxed);
+    stats.totalAllocations = counters.totalAllocations.load(std::memory_order_relaxed);
+    return stats;
+}
+
+/**
+ * @brief Turns the running totals into the counts for the frame that just ended.
+ */
+void MemoryTracker::endFrame() {
+    MemoryFrameStats now;
+    now.allocations = g_allocations.load(std::memory_order_relaxed);
+    now.deallocations = g_deallocations.load(std::memory_order_relaxed);
+    now.bytesAllocated = g_bytesAllocated.load(std::memory_order_relaxed);
+
+    m_lastFrame.allocations = now.allocations - m_frameStart.allocations;
+    m_lastFrame.deallocations = now.deallocations - m_frameStart.deallocations;
+    m_lastFrame.bytesAllocated = now.bytesAllocated - m_frameStart.bytesAllocated;
+    m_frameStart = now;
+}
+
+/**
+ * @brief Copies the qualifying live allocations out of the live lists, groups them by tag and
+ * callstack, and writes the groups, largest first, after a table of per-tag totals.
+ */
+std::size_t MemoryTracker::writeLeakReport(const std::string& path, std::uint64_t sinceSequence) {
+    // Anything allocated while building the report is neither tracked nor reported
+    UntrackedScope untracked;
+
+    std::vector<LiveAllocation> live;
+    for (Shard& shard : g_shards) {
+        std::lock_guard<std::mutex> lock(shard.mutex);
+        for (const AllocationHeader* header = shard.head; header; header = header->next) {
+            const MemoryTag tag = static_cast<MemoryTag>(header->tag);
+            if (header->sequence <= sinceSequence || tag == MemoryTag::Logger || tag == MemoryTag::Profiler) {
+                continue;
+            }
+            LiveAllocation allocation;
+            allocation.size = header->size;
+            allocation.tag = header->tag;
+            allocation.frameCount = header->frameCount;
+#if POLARIS_MEMORY_CALLSTACK_DEPTH > 0
+            std::copy(header->callstack, header->callstack + header->frameCount, allocation.callstack);
+#endif
+            live.push_back(allocation);
+        }
+    }
+
+    struct Site {
+        std::size_t first;
+        std::size_t count;
+        std::size_t bytes;
+    };
+    std::sort(live.begin(), live.end(), siteLess);
+    std::vector<Site> sites;
+    std::size_t totalBytes = 0;
+    for (std::size_t i = 0; i < live.size(); ++i) {
+        if (sites.empty() || !sameSite(live[sites.back().first], live[i])) {
+            sites.push_back({i, 0, 0});
+        }
+        ++sites.back().count;
+        sites.back().bytes += live[i].size;
+        totalBytes += live[i].size;
+    }
+    std::sort(sites.begin(), sites.end(), [](const Site& a, const Site& b) { return a.bytes > b.bytes; });
+
+    std::FILE* file = std::fopen(path.c_str(), "w");
+    if (!file) {
+        LOG_ERROR("Failed to write memory report {}", path.c_str());
+        return live.size();
+    }
+
+    std::fprintf(file, "Polaris memory report\n\n%-12s %14s %14s %12s %14s\n", "tag", "live bytes", "peak bytes",
+                 "live count", "allocations");
+    for (std::size_t i = 0; i < kTagCount; ++i) {
+        const MemoryTagStats stats = getTagStats(static_cast<MemoryTag>(i));
+        std::fprintf(file, "%-12s %14llu %14llu %12llu %14llu\n", kTagNames[i],
+                     static_cast<unsigned long long>(stats.liveBytes), static_cast<unsigned long long>(stats.peakBytes),
+                     static_cast<unsigned long long>(stats.liveCount),
+                     static_cast<unsigned long long>(stats.totalAllocations));
+    }
+
+    std::fprintf(file, "\n%zu allocations (%zu bytes) made after sequence %llu are still live, from %zu call sites\n",
+                 live.size(), totalBytes, static_cast<unsigned long long>(sinceSequence), sites.size());
+    for (const Site& site : sites) {
+        const LiveAllocation& sample = live[site.first];
+        std::fprintf(file, "\n%zu bytes in %zu allocations, tag %s\n", site.bytes, site.count, kTagNames[sample.tag]);
+        for (int frame = 0; frame < sample.frameCount; ++frame) {
+            writeFrame(file, frame, sample.callstack[frame]);
+        }
+        if (sample.frameCount == 0) {
+            std::fprintf(file, "    (no callstack captured)\n");
+        }
+    }
+    std::fclose(file);
+
+    if (live.empty()) {
+        LOG_INFO("Memory report written to {}: no live allocations", path.c_str());
+    } else {
+        LOG_WARN("Memory report written to {}: {} allocations ({} bytes) still live", path.c_str(), live.size(), totalBytes);
+    }
+    return live.size();
+}
+
+#else // POLARIS_ENABLE_MEMORY_TRACKING
+
+MemoryTag MemoryTracker::getThreadTag() {
+    return MemoryTag::Untagged;
+}
+
+void MemoryTracker::setThreadTag(MemoryTag tag) {
+    (void)tag;
+}
+
+void MemoryTracker::setCallstackCapture(bool enabled) {
+    (void)enabled;
+}
+
+std::uint64_t MemoryTracker::getSequence() const {
+    return 0;
+}
+
+MemoryTagStats MemoryTracker::getTagStats(MemoryTag tag) const {
+    (void)tag;
+    return MemoryTagStats();
+}
+
+void MemoryTracker::endFrame() {
+}
+
+std::size_t MemoryTracker::writeLeakReport(const std::string& path, std::uint64_t sinceSequence) {
+    (void)path;
+    (void)sinceSequence;
+    return 0;
+}
+
+#endif // POLARIS_ENABLE_MEMORY_TRACKING
+
+} // namespace polaris
+
+#if POLARIS_ENABLE_MEMORY_TRACKING
+
+// Replacements for every form of the global operator new and delete
+
+void* operator new(std::size_t size) {
+    if (void* pointer = polaris::trackedAllocate(size, alignof(std::max_align_t))) {
+        return pointer;
+    }
+    throw std::bad_alloc();
+}
+
+void* operator new[](std::size_t size) {
+    return ::operator new(size);
+}
+
+void* operator new(std::size_t size, const std::nothrow_t&) noexcept {
+    return polaris::trackedAllocate(size, alignof(std::max_align_t));
+}
+
+void* operator new[](std::size_t size, const std::nothrow_t&) noexcept {
+    return polaris::trackedAllocate(size, alignof(std::max_align_t));
+}
+
+void* operator new(std::size_t size, std::align_val_t alignment) {
+    if (void* pointer = polaris::trackedAllocate(size, static_cast<std::size_t>(alignment))) {
+        return pointer;
+    }
+    throw std::bad_alloc();
+}
+
+void* operator new[](std::size_t size, std::align_val_t alignment) {
+    return ::operator new(size, alignment);
+}
+
+void* operator new(std::size_t size, std::align_val_t alignment, const std::nothrow_t&) noexcept {
+    return polaris::trackedAllocate(size, static_cast<std::size_t>(alignment));
+}
+
+void* operator new[](std::size_t size, std::align_val_t alignment, const std::nothrow_t&) noexcept {
+    return polaris::trackedAllocate(size, static_cast<std::size_t>(alignment));
+}
+
+void operator delete(void* pointer) noexcept { polaris::trackedFree(pointer); }
+void operator delete[](void* pointer) noexcept { polaris::trackedFree(pointer); }
+void operator delete(void* pointer, std::size_t) noexcept { polaris::trackedFree(pointer); }
+void operator delete[](void* pointer, std::size_t) noexcept { polaris::trackedFree(pointer); }
+void operator delete(void* pointer, const std::nothrow_t&) noexcept { polaris::trackedFree(pointer); }
+void operator delete[](void* pointer, const std::nothrow_t&) noexcept { polaris::trackedFree(pointer); }
+void operator delete(void* pointer, std::align_val_t) noexcept { polaris::trackedFree(pointer); }
+void operator delete[](void* pointer, std::align_val_t) noexcept { polaris::trackedFree(pointer); }
+void operator delete(void* pointer, std::size_t, std::align_val_t) noexcept { polaris::trackedFree(pointer); }
+void operator delete[](void* pointer, std::size_t, std::align_val_t) noexcept { polaris::trackedFree(pointer); }
+void operator delete(void* pointer, std::align_val_t, const std::nothrow_t&) noexcept { polaris::trackedFree(pointer); }
+void operator delete[](void* pointer, std::align_val_t, const std::nothrow_t&) noexcept { polaris::trackedFree(pointer); }
+
+#endif // POLARIS_ENABLE_MEMORY_TRACKING
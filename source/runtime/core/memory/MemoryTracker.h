@@ -0,0 +1,166 @@
+#ifndef POLARIS_MEMORYTRACKER_H
+#define POLARIS_MEMORYTRACKER_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+/**
+ * @brief Set to 1 (the CMake option POLARIS_ENABLE_MEMORY_TRACKING=ON) to replace the global
+ * operator new/delete with tracking versions. Off by default; meant for debug and QA builds.
+ */
+#ifndef POLARIS_ENABLE_MEMORY_TRACKING
+#define POLARIS_ENABLE_MEMORY_TRACKING 0
+#endif
+
+/**
+ * @brief Return addresses kept per tracked allocation for the leak report; 0 disables capture.
+ */
+#ifndef POLARIS_MEMORY_CALLSTACK_DEPTH
+#define POLARIS_MEMORY_CALLSTACK_DEPTH 8
+#endif
+
+namespace polaris {
+
+/**
+ * @brief Subsystem an allocation is charged to. Set per thread with POLARIS_MEMORY_SCOPE or
+ * POLARIS_MEMORY_THREAD_TAG.
+ */
+enum class MemoryTag : std::uint8_t {
+    Untagged,
+    Engine,         ///< Engine core: job system, input, frame arena
+    Renderer,       ///< Render thread and renderer objects
+    Logger,
+    Profiler,
+    Assets,         ///< Textures, atlases and other loaded data
+    Audio,          ///< Audio engine: voice pool, decoded sounds and music streaming
+    Application,    ///< Application callbacks
+    Count
+};
+
+const char* getMemoryTagName(MemoryTag tag);
+
+/**
+ * @brief Live and cumulative usage of one tag.
+ */
+struct MemoryTagStats {
+    std::uint64_t liveBytes = 0;
+    std::uint64_t peakBytes = 0;
+    std::uint64_t liveCount = 0;
+    std::uint64_t totalAllocations = 0;
+};
+
+/**
+ * @brief Heap activity during the last completed frame, on all threads.
+ */
+struct MemoryFrameStats {
+    std::uint64_t allocations = 0;
+    std::uint64_t deallocations = 0;
+    std::uint64_t bytesAllocated = 0;
+};
+
+/**
+ * @brief Tracks every global operator new/delete when POLARIS_ENABLE_MEMORY_TRACKING is set.
+ *
+ * Each allocation carries a small header with its size, tag, sequence number and (optionally)
+ * the return addresses of its caller, and is linked into one of several lock-sharded live
+ * lists, so counting costs a few atomic adds and an uncontended lock. Per-tag counters and
+ * per-frame totals can be read at any time; writeLeakReport() lists the allocations still live,
+ * grouped by tag and callstack.
+ *
+ * When tracking is compiled out every query returns zeros and the report is not written.
+ */
+class MemoryTracker {
+public:
+    static MemoryTracker& getInstance();
+
+    /**
+     * @brief True if the tracking operator new/delete are compiled in.
+     */
+    static constexpr bool isEnabled() { return POLARIS_ENABLE_MEMORY_TRACKING != 0; }
+
+    /**
+     * @brief Tag charged for the calling thread's allocations.
+     */
+    static MemoryTag getThreadTag();
+    static void setThreadTag(MemoryTag tag);
+
+    /**
+     * @brief Turns callstack capture on or off for new allocations (on by default).
+     * Unwinding dominates the cost of tracking: roughly 2 us per allocation with capture and
+     * 0.1 us without on a desktop CPU. Steady-state frames should not allocate, so in practice
+     * the cost falls on loading.
+     */
+    void setCallstackCapture(bool enabled);
+
+    /**
+     * @brief Sequence number of the most recent allocation; pass it to writeLeakReport()
+     * to report only allocations made after this point.
+     */
+    std::uint64_t getSequence() const;
+
+    MemoryTagStats getTagStats(MemoryTag tag) const;
+
+    /**
+     * @brief Closes the current frame and makes its totals available through getFrameStats().
+     * Called once per frame by the engine's main loop.
+     */
+    void endFrame();
+
+    /**
+     * @brief Heap activity during the last completed frame.
+     */
+    MemoryFrameStats getFrameStats() const { return m_lastFrame; }
+
+    /**
+     * @brief Writes per-tag totals and every allocation made after sinceSequence that is still
+     * live, grouped by tag and callstack, largest first. Logger and Profiler allocations belong
+     * to process-lifetime singletons and are only counted in the totals.
+     * @param path Output text file.
+     * @param sinceSequence Allocations up to and including this sequence number are ignored.
+     * @return Number of live allocations reported, or 0 if tracking is compiled out.
+     */
+    std::size_t writeLeakReport(const std::string& path, std::uint64_t sinceSequence);
+
+private:
+    MemoryTracker() = default;
+
+    MemoryFrameStats m_frameStart;  ///< Running totals when the current frame started
+    MemoryFrameStats m_lastFrame;
+};
+
+/**
+ * @brief RAII tag for the calling thread's allocations; restores the previous tag on exit.
+ */
+class MemoryTagScope {
+public:
+    explicit MemoryTagScope(MemoryTag tag) : m_previous(MemoryTracker::getThreadTag()) {
+        MemoryTracker::setThreadTag(tag);
+    }
+    ~MemoryTagScope() { MemoryTracker::setThreadTag(m_previous); }
+
+    MemoryTagScope(const MemoryTagScope&) = delete;
+    MemoryTagScope& operator=(const MemoryTagScope&) = delete;
+
+private:
+    MemoryTag m_previous;
+};
+
+} // namespace polaris
+
+#define POLARIS_MEMORY_CONCAT_INNER(a, b) a##b
+#define POLARIS_MEMORY_CONCAT(a, b) POLARIS_MEMORY_CONCAT_INNER(a, b)
+
+#if POLARIS_ENABLE_MEMORY_TRACKING
+// Charges the enclosing scope's allocations to a tag, e.g. POLARIS_MEMORY_SCOPE(Renderer).
+#define POLARIS_MEMORY_SCOPE(tag) polaris::MemoryTagScope POLARIS_MEMORY_CONCAT(polarisMemoryScope, __LINE__)(polaris::MemoryTag::tag)
+// Sets the default tag of the calling thread, e.g. at the top of a thread's main function.
+#define POLARIS_MEMORY_THREAD_TAG(tag) polaris::MemoryTracker::setThreadTag(polaris::MemoryTag::tag)
+#define POLARIS_MEMORY_FRAME_END() polaris::MemoryTracker::getInstance().endFrame()
+#else
+#define POLARIS_MEMORY_SCOPE(tag) ((void)0)
+#define POLARIS_MEMORY_THREAD_TAG(tag) ((void)0)
+#define POLARIS_MEMORY_FRAME_END() ((void)0)
+#endif
+
+#endif // POLARIS_MEMORYTRACKER_H
@@ -0,0 +1,45 @@
+#include "memory/PoolAllocator.h"
+#include <algorithm>
+
+namespace polaris {
+
+/**
+ * @brief Creates an empty pool; the first chunk is allocated on first use or by reserve().
+ */
+PoolAllocator::PoolAllocator(std::size_t blockSize, std::size_t blockAlignment, std::size_t blocksPerChunk)
+    : m_blockAlignment(std::max(blockAlignment, alignof(FreeBlock))),
+      m_blocksPerChunk(std::max<std::size_t>(blocksPerChunk, 1)) {
+    // Every block must hold a free-list link and keep the next block aligned
+    const std::size_t size = std::max(blockSize, sizeof(FreeBlock));
+    m_blockSize = (size + m_blockAlignment - 1) & ~(m_blockAlignment - 1);
+}
+
+PoolAllocator::~PoolAllocator() {
+    for (void* chunk : m_chunks) {
+        ::operator delete(chunk, std::align_val_t(m_blockAlignment));
+    }
+}
+
+void PoolAllocator::reserve(std::size_t blocks) {
+    while (getCapacity() < blocks) {
+        addChunk();
+    }
+}
+
+/**
+ * @brief Allocates a chunk and threads its blocks onto the free list in address order.
+ */
+void PoolAllocator::addChunk() {
+    m_chunks.reserve(m_chunks.size() + 1);
+    unsigned char* chunk = static_cast<unsigned char*>(
+        ::operator new(m_blockSize * m_blocksPerChunk, std::align_val_t(m_blockAlignment)));
+    m_chunks.push_back(chunk);
+
+    for (std::size_t i = m_blocksPerChunk; i-- > 0;) {
+        FreeBlock* block = reinterpret_cast<FreeBlock*>(chunk + i * m_blockSize);
+        block->next = m_freeList;
+        m_freeList = block;
+    }
+}
+
+} // namespace polaris
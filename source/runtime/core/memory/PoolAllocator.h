@@ -0,0 +1,178 @@
+#ifndef POLARIS_POOLALLOCATOR_H
+#define POLARIS_POOLALLOCATOR_H
+
+#include <cstddef>
+#include <memory_resource>
+#include <new>
+#include <utility>
+#include <vector>
+
+namespace polaris {
+
+/**
+ * @brief Fixed-size block allocator with an intrusive free list.
+ *
+ * Blocks are carved from chunks of blocksPerChunk blocks; allocate() and deallocate() are O(1)
+ * and only allocate() touches the heap, when every chunk is full. Chunks are kept until the
+ * pool is destroyed, so a pool sized for its peak use never allocates again. Not thread-safe:
+ * give each thread its own pool or guard it with a lock.
+ */
+class PoolAllocator {
+public:
+    /**
+     * @param blockSize Size of each block; rounded up to hold a pointer and keep alignment.
+     * @param blockAlignment Alignment of each block, a power of two.
+     * @param blocksPerChunk Blocks allocated from the heap at a time.
+     */
+    explicit PoolAllocator(std::size_t blockSize,
+                           std::size_t blockAlignment = alignof(std::max_align_t),
+                           std::size_t blocksPerChunk = 64);
+    ~PoolAllocator();
+
+    PoolAllocator(const PoolAllocator&) = delete;
+    PoolAllocator& operator=(const PoolAllocator&) = delete;
+
+    /**
+     * @brief Returns an uninitialized block.
+     * @throws std::bad_alloc if a new chunk cannot be allocated.
+     */
+    void* allocate() {
+        if (!m_freeList) {
+            addChunk();
+        }
+        FreeBlock* block = m_freeList;
+        m_freeList = block->next;
+        ++m_liveCount;
+        return block;
+    }
+
+    /**
+     * @brief Returns a block obtained from allocate(). Null is ignored.
+     */
+    void deallocate(void* pointer) {
+        if (!pointer) {
+            return;
+        }
+        FreeBlock* block = static_cast<FreeBlock*>(pointer);
+        block->next = m_freeList;
+        m_freeList = block;
+        --m_liveCount;
+    }
+
+    /**
+     * @brief Makes sure at least this many blocks exist, so that many allocations will not touch the heap.
+     */
+    void reserve(std::size_t blocks);
+
+    std::size_t getBlockSize() const { return m_blockSize; }
+    std::size_t getBlockAlignment() const { return m_blockAlignment; }
+
+    /**
+     * @brief Blocks currently allocated.
+     */
+    std::size_t getLiveCount() const { return m_liveCount; }
+
+    /**
+     * @brief Blocks in all chunks, allocated or free.
+     */
+    std::size_t getCapacity() const { return m_chunks.size() * m_blocksPerChunk; }
+
+private:
+    struct FreeBlock {
+        FreeBlock* next;
+    };
+
+    void addChunk();
+
+    std::size_t m_blockSize;
+    std::size_t m_blockAlignment;
+    std::size_t m_blocksPerChunk;
+    std::vector<void*> m_chunks;
+    FreeBlock* m_freeList = nullptr;
+    std::size_t m_liveCount = 0;
+};
+
+/**
+ * @brief Typed front end of a PoolAllocator: constructs and destroys objects of type T.
+ */
+template <typename T>
+class ObjectPool {
+public:
+    explicit ObjectPool(std::size_t objectsPerChunk = 64)
+        : m_pool(sizeof(T), alignof(T), objectsPerChunk) {}
+
+    template <typename... Args>
+    T* create(Args&&... args) {
+        void* memory = m_pool.allocate();
+        try {
+            return new (memory) T(std::forward<Args>(args)...);
+        } catch (...) {
+            m_pool.deallocate(memory);
+            throw;
+        }
+    }
+
+    /**
+     * @brief Destroys an object made by create(). Null is ignored.
+     */
+    void destroy(T* object) {
+        if (!object) {
+            return;
+        }
+        object->~T();
+        m_pool.deallocate(object);
+    }
+
+    void reserve(std::size_t objects) { m_pool.reserve(objects); }
+
+    /**
+     * @brief Objects created and not yet destroyed. Objects still alive when the pool is
+     * destroyed are not destructed.
+     */
+    std::size_t getLiveCount() const { return m_pool.getLiveCount(); }
+
+private:
+    PoolAllocator m_pool;
+};
+
+/**
+ * @brief std::pmr adapter for a PoolAllocator. Requests that fit a pool block are served by the
+ * pool; larger or more strictly aligned ones go to the upstream resource. Suits node-based
+ * containers such as std::pmr::list or std::pmr::map whose nodes match the block size.
+ */
+class PoolResource : public std::pmr::memory_resource {
+public:
+    explicit PoolResource(PoolAllocator& pool,
+                          std::pmr::memory_resource* upstream = std::pmr::get_default_resource())
+        : m_pool(&pool), m_upstream(upstream) {}
+
+    PoolAllocator& getPool() const { return *m_pool; }
+
+private:
+    bool fits(std::size_t bytes, std::size_t alignment) const {
+        return bytes <= m_pool->getBlockSize() && alignment <= m_pool->getBlockAlignment();
+    }
+
+    void* do_allocate(std::size_t bytes, std::size_t alignment) override {
+        return fits(bytes, alignment) ? m_pool->allocate() : m_upstream->allocate(bytes, alignment);
+    }
+
+    void do_deallocate(void* pointer, std::size_t bytes, std::size_t alignment) override {
+        if (fits(bytes, alignment)) {
+            m_pool->deallocate(pointer);
+        } else {
+            m_upstream->deallocate(pointer, bytes, alignment);
+        }
+    }
+
+    bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override {
+        return this == &other;
+    }
+
+    PoolAllocator* m_pool;
+    std::pmr::memory_resource* m_upstream;
+};
+
+} // namespace polaris
+
+#endif // POLARIS_POOLALLOCATOR_H
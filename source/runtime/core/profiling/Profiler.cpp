@@ -0,0 +1,328 @@
+#include "Profiler.h"
+#include "Logger.h"
+#include "memory/MemoryTracker.h"
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <cstdlib>
+#include <fstream>
+
+namespace polaris {
+
+namespace {
+
+/**
+ * @brief Writes s as a JSON string literal.
+ */
+void writeJsonString(std::ostream& out, const char* s) {
+    out << '"';
+    for (; *s; ++s) {
+        const char c = *s;
+        if (c == '"' || c == '\\') {
+            out << '\\' << c;
+        } else if (static_cast<unsigned char>(c) < 0x20) {
+            out << ' ';
+        } else {
+            out << c;
+        }
+    }
+    out << '"';
+}
+
+} // namespace
+
+/**
+ * @brief Returns the process-wide profiler.
+ * If the POLARIS_PROFILE_CAPTURE environment variable names a file, a capture is started
+ * immediately and written at shutdown (or after POLARIS_PROFILE_CAPTURE_FRAMES frames).
+ */
+Profiler& Profiler::getInstance() {
+    static Profiler instance;
+    return instance;
+}
+
+Profiler::Profiler() {
+    if (const char* path = std::getenv("POLARIS_PROFILE_CAPTURE")) {
+        std::uint32_t frames = 0;
+        if (const char* frameCount = std::getenv("POLARIS_PROFILE_CAPTURE_FRAMES")) {
+            frames = static_cast<std::uint32_t>(std::strtoul(frameCount, nullptr, 10));
+        }
+        startCapture(path, frames);
+    }
+}
+
+std::uint64_t Profiler::now() {
+    return static_cast<std::uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count());
+}
+
+/**
+ * @brief Returns the calling thread's buffer, registering it on first use.
+ */
+Profiler::ThreadBuffer& Profiler::threadBuffer() {
+    thread_local ThreadBufferOwner owner{getInstance().registerThread()};
+    return *owner.buffer;
+}
+
+/**
+ * @brief Hands the calling thread a buffer, reusing one whose thread has exited if possible.
+ */
+Profiler::ThreadBuffer* Profiler::registerThread() {
+    POLARIS_MEMORY_SCOPE(Profiler);
+    std::lock_guard<std::mutex> lock(m_threadsMutex);
+    ThreadBuffer* buffer = nullptr;
+    if (!m_freeThreads.empty()) {
+        buffer = m_freeThreads.back();
+        m_freeThreads.pop_back();
+        buffer->threadName.store(nullptr, std::memory_order_relaxed);
+        buffer->retired.store(false, std::memory_order_relaxed);
+    } else {
+        m_threads.push_back(std::make_unique<ThreadBuffer>());
+        buffer = m_threads.back().get();
+    }
+    // A fresh id keeps the reused buffer's events apart from the previous thread's in captures.
+    buffer->threadId = m_nextThreadId++;
+    return buffer;
+}
+
+void Profiler::record(const char* name, std::uint64_t start, std::uint64_t end) {
+    ThreadBuffer& buffer = threadBuffer();
+    // Single producer: only this thread writes the buffer, the main thread only reads it.
+    const std::uint64_t index = buffer.writeIndex.load(std::memory_order_relaxed);
+    Slot& slot = buffer.slots[index & (kThreadBufferSize - 1)];
+    // Release stores: a reader that sees any new field also sees the sequence cleared.
+    slot.sequence.store(0, std::memory_order_relaxed);
+    slot.name.store(name, std::memory_order_release);
+    slot.start.store(start, std::memory_order_release);
+    slot.end.store(end, std::memory_order_release);
+    slot.sequence.store(index + 1, std::memory_order_release);
+    buffer.writeIndex.store(index + 1, std::memory_order_release);
+}
+
+void Profiler::setThreadName(const char* name) {
+    threadBuffer().threadName.store(name, std::memory_order_relaxed);
+}
+
+Profiler::Zone& Profiler::findZone(const char* name) {
+    for (const auto& entry : m_zoneLookup) {
+        if (entry.first == name) {
+            return *entry.second;
+        }
+    }
+
+    // The same literal can have different addresses in different translation units,
+    // so fall back to comparing the text before creating a new zone.
+    Zone* zone = nullptr;
+    for (const auto& existing : m_zones) {
+        if (std::strcmp(existing->name, name) == 0) {
+            zone = existing.get();
+            break;
+        }
+    }
+    if (!zone) {
+        m_zones.push_back(std::make_unique<Zone>());
+        zone = m_zones.back().get();
+        zone->name = name;
+    }
+    m_zoneLookup.emplace_back(name, zone);
+    return *zone;
+}
+
+/**
+ * @brief Consumes everything a thread recorded since the last drain.
+ */
+void Profiler::drain(ThreadBuffer& buffer) {
+    thread_local std::vector<Event> scratch;
+
+    const std::uint64_t writeIndex = buffer.writeIndex.load(std::memory_order_acquire);
+    std::uint64_t readIndex = buffer.readIndex;
+    if (writeIndex - readIndex > kThreadBufferSize) {
+        m_lostEvents += writeIndex - readIndex - kThreadBufferSize;
+        readIndex = writeIndex - kThreadBufferSize;
+    }
+
+    // The producer keeps running while we copy, so a slot can be rewritten under us: keep a
+    // copy only if the slot still holds the same event once the fields have been read.
+    scratch.clear();
+    for (std::uint64_t i = readIndex; i < writeIndex; ++i) {
+        const Slot& slot = buffer.slots[i & (kThreadBufferSize - 1)];
+        if (slot.sequence.load(std::memory_order_acquire) != i + 1) {
+            ++m_lostEvents;
+            continue;
+        }
+        Event event;
+        event.name = slot.name.load(std::memory_order_acquire);
+        event.start = slot.start.load(std::memory_order_acquire);
+        event.end = slot.end.load(std::memory_order_acquire);
+        if (slot.sequence.load(std::memory_order_relaxed) != i + 1) {
+            ++m_lostEvents;
+            continue;
+        }
+        scratch.push_back(event);
+    }
+    buffer.readIndex = writeIndex;
+
+    for (const Event& event : scratch) {
+        Zone& zone = findZone(event.name);
+        zone.frameTicks += event.end - event.start;
+        ++zone.frameCalls;
+
+        if (m_capturing) {
+            m_captured.push_back(CapturedEvent{event.name, event.start, event.end, buffer.threadId});
+        }
+    }
+}
+
+void Profiler::endFrame() {
+    POLARIS_MEMORY_SCOPE(Profiler);
+    {
+        std::lock_guard<std::mutex> lock(m_threadsMutex);
+        for (const auto& buffer : m_threads) {
+            if (buffer->threadId == 0) {
+                continue;
+            }
+            // Read before draining: once set, the thread has recorded its last event.
+            const bool retired = buffer->retired.load(std::memory_order_acquire);
+            drain(*buffer);
+            if (retired) {
+                if (m_capturing) {
+                    m_capturedThreads.push_back(ThreadName{buffer->threadId, buffer->threadName.load(std::memory_order_relaxed)});
+                }
+                buffer->threadId = 0;
+                m_freeThreads.push_back(buffer.get());
+            }
+        }
+    }
+
+    for (const auto& zone : m_zones) {
+        zone->lastCalls = zone->frameCalls;
+        if (zone->frameCalls > 0) {
+            zone->history[zone->historyHead] = static_cast<double>(zone->frameTicks) / 1.0e6;
+            zone->historyHead = (zone->historyHead + 1) % kHistoryFrames;
+            zone->historyCount = std::min<std::uint32_t>(zone->historyCount + 1, kHistoryFrames);
+        }
+        zone->frameTicks = 0;
+        zone->frameCalls = 0;
+    }
+
+    if (m_capturing && m_captureFramesLeft > 0 && --m_captureFramesLeft == 0) {
+        writeCapture();
+    }
+}
+
+void Profiler::startCapture(const std::string& path, std::uint32_t frames) {
+    POLARIS_MEMORY_SCOPE(Profiler);
+    m_capturePath = path;
+    m_captureFramesLeft = frames;
+    m_captured.clear();
+    m_captured.reserve(64 * 1024);
+    m_capturedThreads.clear();
+    m_capturing = true;
+    LOG_INFO("Profiler capture started: {} ({} frames)", path, frames);
+}
+
+bool Profiler::writeCapture() {
+    if (!m_capturing) {
+        return false;
+    }
+    m_capturing = false;
+
+    std::ofstream out(m_capturePath);
+    if (!out.is_open()) {
+        LOG_ERROR("Failed to write profiler capture: {}", m_capturePath);
+        return false;
+    }
+
+    std::uint64_t base = ~std::uint64_t(0);
+    for (const CapturedEvent& event : m_captured) {
+        base = std::min(base, event.start);
+    }
+
+    out << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n";
+    bool first = true;
+    {
+        std::lock_guard<std::mutex> lock(m_threadsMutex);
+        std::vector<ThreadName> threads = m_capturedThreads;
+        for (const auto& buffer : m_threads) {
+            if (buffer->threadId != 0) {
+                threads.push_back(ThreadName{buffer->threadId, buffer->threadName.load(std::memory_order_relaxed)});
+            }
+        }
+        for (const ThreadName& thread : threads) {
+            out << (first ? "" : ",\n") << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":" << thread.threadId
+                << ",\"args\":{\"name\":";
+            writeJsonString(out, thread.name ? thread.name : "Thread");
+            out << "}}";
+            first = false;
+        }
+    }
+
+    out.setf(std::ios::fixed);
+    out.precision(3);
+    for (const CapturedEvent& event : m_captured) {
+        out << (first ? "" : ",\n") << "{\"name\":";
+        writeJsonString(out, event.name);
+        out << ",\"cat\":\"polaris\",\"ph\":\"X\",\"pid\":1,\"tid\":" << event.threadId
+            << ",\"ts\":" << static_cast<double>(event.start - base) / 1000.0
+            << ",\"dur\":" << static_cast<double>(event.end - event.start) / 1000.0 << '}';
+        first = false;
+    }
+    out << "\n]}\n";
+
+    LOG_INFO("Profiler capture written: {} ({} events)", m_capturePath, m_captured.size());
+    m_captured.clear();
+    m_captured.shrink_to_fit();
+    m_capturedThreads.clear();
+    return static_cast<bool>(out);
+}
+
+void Profiler::shutdown() {
+    if (m_capturing) {
+        endFrame();
+        writeCapture();
+    }
+}
+
+std::vector<ProfileZoneStats> Profiler::getZoneStats() const {
+    std::vector<ProfileZoneStats> result;
+    std::vector<double> samples;
+    result.reserve(m_zones.size());
+
+    for (const auto& zone : m_zones) {
+        if (zone->historyCount == 0) {
+            continue;
+        }
+        samples.assign(zone->history, zone->history + zone->historyCount);
+        std::sort(samples.begin(), samples.end());
+
+        ProfileZoneStats stats;
+        stats.name = zone->name;
+        stats.frames = zone->historyCount;
+        stats.minMs = samples.front();
+        stats.maxMs = samples.back();
+        double sum = 0.0;
+        for (double sample : samples) {
+            sum += sample;
+        }
+        stats.avgMs = sum / static_cast<double>(samples.size());
+        const std::size_t p99Index = (samples.size() * 99 + 99) / 100 - 1;
+        stats.p99Ms = samples[std::min(p99Index, samples.size() - 1)];
+        stats.lastMs = zone->history[(zone->historyHead + kHistoryFrames - 1) % kHistoryFrames];
+        stats.lastCalls = zone->lastCalls;
+        result.push_back(stats);
+    }
+
+    std::sort(result.begin(), result.end(), [](const ProfileZoneStats& a, const ProfileZoneStats& b) {
+        return a.avgMs > b.avgMs;
+    });
+    return result;
+}
+
+void Profiler::logZoneStats() const {
+    for (const ProfileZoneStats& stats : getZoneStats()) {
+        LOG_INFO("[profile] {}: min {:.3f} ms, avg {:.3f} ms, p99 {:.3f} ms ({} calls last frame, {} frames)",
+                 stats.name, stats.minMs, stats.avgMs, stats.p99Ms, stats.lastCalls, stats.frames);
+    }
+}
+
+} // namespace polaris
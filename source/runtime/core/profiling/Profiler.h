@@ -0,0 +1,239 @@
+#ifndef POLARIS_PROFILER_H
+#define POLARIS_PROFILER_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+/**
+ * @brief Set to 0 (the CMake option POLARIS_ENABLE_PROFILER=OFF) to compile every
+ * POLARIS_PROFILE_* macro out to nothing.
+ */
+#ifndef POLARIS_ENABLE_PROFILER
+#define POLARIS_ENABLE_PROFILER 1
+#endif
+
+namespace polaris {
+
+/**
+ * @brief Aggregated timings of one named zone over the recent frame history.
+ * Times are the per-frame totals of the zone, in milliseconds.
+ */
+struct ProfileZoneStats {
+    const char* name = nullptr;
+    double minMs = 0.0;
+    double avgMs = 0.0;
+    double p99Ms = 0.0;
+    double maxMs = 0.0;
+    double lastMs = 0.0;
+    std::uint32_t lastCalls = 0;   ///< Times the zone was entered in the last frame.
+    std::uint32_t frames = 0;      ///< Frames of history the statistics cover.
+};
+
+/**
+ * @brief CPU instrumentation profiler.
+ *
+ * POLARIS_PROFILE_SCOPE records the begin/end ticks of a scope into a per-thread ring buffer
+ * that only its own thread writes, so recording takes no lock. Once per frame the engine calls
+ * endFrame() on the main thread, which drains every thread's buffer, folds the zones into the
+ * per-frame statistics and, while a capture is active, keeps the raw events so they can be
+ * written as a Chrome trace / Perfetto JSON file.
+ *
+ * When a thread exits its buffer is drained one last time and kept for the next thread that
+ * records, so engines that recreate their worker threads do not grow the profiler.
+ */
+class Profiler {
+public:
+    /**
+     * @brief One completed zone as recorded by a thread.
+     */
+    struct Event {
+        const char* name;
+        std::uint64_t start;
+        std::uint64_t end;
+    };
+
+    static Profiler& getInstance();
+
+    /**
+     * @brief Current time in profiler ticks (nanoseconds of the steady clock).
+     */
+    static std::uint64_t now();
+
+    /**
+     * @brief Records a completed zone for the calling thread.
+     * @param name A string with static storage duration.
+     */
+    static void record(const char* name, std::uint64_t start, std::uint64_t end);
+
+    /**
+     * @brief Names the calling thread in captures.
+     * @param name A string with static storage duration.
+     */
+    static void setThreadName(const char* name);
+
+    /**
+     * @brief Closes the current frame: drains the thread buffers and updates the zone statistics.
+     * Must be called from one thread (the engine's main loop).
+     */
+    void endFrame();
+
+    /**
+     * @brief Starts keeping raw events for a trace capture.
+     * @param path File the capture is written to.
+     * @param frames Number of frames to capture before writing the file automatically,
+     *        or 0 to keep capturing until writeCapture() or shutdown().
+     */
+    void startCapture(const std::string& path, std::uint32_t frames = 0);
+
+    /**
+     * @brief Writes the events captured so far as Chrome trace JSON and stops capturing.
+     * @return false if nothing was being captured or the file could not be written.
+     */
+    bool writeCapture();
+
+    /**
+     * @brief True while a capture is in progress.
+     */
+    bool isCapturing() const { return m_capturing; }
+
+    /**
+     * @brief Writes any pending capture. Called by Engine::shutdown.
+     */
+    void shutdown();
+
+    /**
+     * @brief Returns statistics for every zone seen so far, sorted by average time, descending.
+     */
+    std::vector<ProfileZoneStats> getZoneStats() const;
+
+    /**
+     * @brief Logs a one-line summary per zone (min/avg/p99) at INFO level.
+     */
+    void logZoneStats() const;
+
+    /**
+     * @brief Number of events lost because a thread overran its ring buffer between two frames.
+     */
+    std::uint64_t getLostEventCount() const { return m_lostEvents; }
+
+private:
+    static constexpr std::size_t kThreadBufferSize = 16384;
+    static constexpr std::size_t kHistoryFrames = 240;
+
+    /**
+     * @brief One ring buffer entry. The fields are atomics so the main thread can copy a slot
+     * while its thread overwrites it; sequence is 0 during a write and index + 1 after it, and
+     * a copy is only kept if sequence had the expected value both before and after.
+     */
+    struct Slot {
+        std::atomic<std::uint64_t> sequence{0};
+        std::atomic<const char*> name{nullptr};
+        std::atomic<std::uint64_t> start{0};
+        std::atomic<std::uint64_t> end{0};
+    };
+
+    struct ThreadBuffer {
+        Slot slots[kThreadBufferSize];
+        std::atomic<std::uint64_t> writeIndex{0};
+        std::atomic<bool> retired{false};   ///< Set when the thread exits.
+        std::uint64_t readIndex = 0;
+        std::uint32_t threadId = 0;
+        std::atomic<const char*> threadName{nullptr};
+    };
+
+    /**
+     * @brief Thread-local handle that retires its thread's buffer when the thread exits.
+     */
+    struct ThreadBufferOwner {
+        ThreadBuffer* buffer;
+        ~ThreadBufferOwner() { buffer->retired.store(true, std::memory_order_release); }
+    };
+
+    struct ThreadName {
+        std::uint32_t threadId;
+        const char* name;
+    };
+
+    struct Zone {
+        const char* name;
+        double history[kHistoryFrames];
+        std::uint32_t historyCount = 0;
+        std::uint32_t historyHead = 0;
+        std::uint64_t frameTicks = 0;
+        std::uint32_t frameCalls = 0;
+        std::uint32_t lastCalls = 0;
+    };
+
+    struct CapturedEvent {
+        const char* name;
+        std::uint64_t start;
+        std::uint64_t end;
+        std::uint32_t threadId;
+    };
+
+    Profiler();
+
+    static ThreadBuffer& threadBuffer();
+    ThreadBuffer* registerThread();
+    Zone& findZone(const char* name);
+    void drain(ThreadBuffer& buffer);
+
+    mutable std::mutex m_threadsMutex;
+    std::vector<std::unique_ptr<ThreadBuffer>> m_threads;
+    std::vector<ThreadBuffer*> m_freeThreads;
+    std::uint32_t m_nextThreadId = 1;
+
+    std::vector<std::unique_ptr<Zone>> m_zones;
+    std::vector<std::pair<const char*, Zone*>> m_zoneLookup;
+
+    bool m_capturing = false;
+    std::string m_capturePath;
+    std::uint32_t m_captureFramesLeft = 0;
+    std::vector<CapturedEvent> m_captured;
+    std::vector<ThreadName> m_capturedThreads;   ///< Threads that exited during the capture.
+
+    std::uint64_t m_lostEvents = 0;
+};
+
+/**
+ * @brief RAII zone created by POLARIS_PROFILE_SCOPE.
+ */
+class ProfileScope {
+public:
+    explicit ProfileScope(const char* name) : m_name(name), m_start(Profiler::now()) {}
+    ~ProfileScope() { Profiler::record(m_name, m_start, Profiler::now()); }
+
+    ProfileScope(const ProfileScope&) = delete;
+    ProfileScope& operator=(const ProfileScope&) = delete;
+
+private:
+    const char* m_name;
+    std::uint64_t m_start;
+};
+
+} // namespace polaris
+
+#define POLARIS_PROFILE_CONCAT_INNER(a, b) a##b
+#define POLARIS_PROFILE_CONCAT(a, b) POLARIS_PROFILE_CONCAT_INNER(a, b)
+
+#if POLARIS_ENABLE_PROFILER
+// Times the enclosing scope. name must be a string literal (or otherwise static).
+#define POLARIS_PROFILE_SCOPE(name) polaris::ProfileScope POLARIS_PROFILE_CONCAT(polarisProfileScope, __LINE__)(name)
+#define POLARIS_PROFILE_FUNCTION() POLARIS_PROFILE_SCOPE(__func__)
+#define POLARIS_PROFILE_THREAD(name) polaris::Profiler::setThreadName(name)
+#define POLARIS_PROFILE_FRAME_END() polaris::Profiler::getInstance().endFrame()
+#define POLARIS_PROFILE_SHUTDOWN() polaris::Profiler::getInstance().shutdown()
+#else
+#define POLARIS_PROFILE_SCOPE(name) ((void)0)
+#define POLARIS_PROFILE_FUNCTION() ((void)0)
+#define POLARIS_PROFILE_THREAD(name) ((void)0)
+#define POLARIS_PROFILE_FRAME_END() ((void)0)
+#define POLARIS_PROFILE_SHUTDOWN() ((void)0)
+#endif
+
+#endif // POLARIS_PROFILER_H
@@ -0,0 +1,164 @@
+#include "AtlasFormat.h"
+
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+
+namespace polaris
+{
+    namespace
+    {
+        template <typename T>
+        void AppendValue(std::string& out, T value)
+        {
+            char bytes[sizeof(T)];
+            std::memcpy(bytes, &value, sizeof(T));
+            out.append(bytes, sizeof(T));
+        }
+
+        /**
+         * @brief Bounds-checked reader over the file contents.
+         */
+        struct Reader
+        {
+            const char* data;
+            std::size_t size;
+            std::size_t offset;
+
+            template <typename T>
+            bool Read(T& value)
+            {
+                if (size - offset < sizeof(T))
+                {
+                    return false;
+                }
+                std::memcpy(&value, data + offset, sizeof(T));
+                offset += sizeof(T);
+                return true;
+            }
+
+            bool ReadString(std::string& value, std::size_t length)
+            {
+                if (size - offset < length)
+                {
+                    return false;
+                }
+                value.assign(data + offset, length);
+                offset += length;
+                return true;
+            }
+        };
+    }
+
+    bool WriteAtlasIndex(const std::string& path, const std::vector<AtlasPageInfo>& pages,
+                         std::vector<AtlasSpriteEntry> sprites)
+    {
+        std::sort(sprites.begin(), sprites.end(), [](const AtlasSpriteEntry& a, const AtlasSpriteEntry& b) {
+            return a.nameHash < b.nameHash;
+        });
+
+        std::string out(kAtlasMagic, sizeof(kAtlasMagic));
+        AppendValue(out, kAtlasVersion);
+        AppendValue(out, static_cast<std::uint16_t>(pages.size()));
+        AppendValue(out, static_cast<std::uint32_t>(sprites.size()));
+
+        for (const AtlasPageInfo& page : pages)
+        {
+            AppendValue(out, page.width);
+            AppendValue(out, page.height);
+            AppendValue(out, static_cast<std::uint16_t>(page.file.size()));
+            out += page.file;
+        }
+
+        for (const AtlasSpriteEntry& sprite : sprites)
+        {
+            AppendValue(out, sprite.nameHash);
+            AppendValue(out, sprite.page);
+            AppendValue(out, sprite.x);
+            AppendValue(out, sprite.y);
+            AppendValue(out, sprite.width);
+            AppendValue(out, sprite.height);
+            AppendValue(out, sprite.trimX);
+            AppendValue(out, sprite.trimY);
+            AppendValue(out, sprite.sourceWidth);
+            AppendValue(out, sprite.sourceHeight);
+            AppendValue(out, sprite.u0);
+            AppendValue(out, sprite.v0);
+            AppendValue(out, sprite.u1);
+            AppendValue(out, sprite.v1);
+        }
+
+        std::ofstream file(path, std::ios::binary | std::ios::trunc);
+        file.write(out.data(), static_cast<std::streamsize>(out.size()));
+        return static_cast<bool>(file);
+    }
+
+    bool ReadAtlasIndex(const std::string& path, std::vector<AtlasPageInfo>& pages,
+                        std::vector<AtlasSpriteEntry>& sprites)
+    {
+        std::ifstream file(path, std::ios::binary);
+        if (!file.is_open())
+        {
+            return false;
+        }
+        const std::string contents((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+
+        Reader reader{contents.data(), contents.size(), 0};
+        char magic[4];
+        std::uint16_t version;
+        std::uint16_t pageCount;
+        std::uint32_t spriteCount;
+        if (contents.size() < sizeof(magic) || std::memcmp(contents.data(), kAtlasMagic, sizeof(magic)) != 0)
+        {
+            return false;
+        }
+        reader.offset = sizeof(magic);
+        if (!reader.Read(version) || version != kAtlasVersion || !reader.Read(pageCount) || !reader.Read(spriteCount))
+        {
+            return false;
+        }
+
+        // Reject counts the remaining bytes cannot hold before allocating; pages are at least
+        // their fixed fields, the file name adds to that
+        constexpr std::size_t kPageRecordSize = sizeof(AtlasPageInfo::width) + sizeof(AtlasPageInfo::height) +
+                                                sizeof(std::uint16_t);
+        if (pageCount > (reader.size - reader.offset) / kPageRecordSize)
+        {
+            return false;
+        }
+        pages.resize(pageCount);
+        for (AtlasPageInfo& page : pages)
+        {
+            std::uint16_t length;
+            if (!reader.Read(page.width) || !reader.Read(page.height) || !reader.Read(length) ||
+                !reader.ReadString(page.file, length))
+            {
+                return false;
+            }
+        }
+
+        constexpr std::size_t kSpriteRecordSize = sizeof(AtlasSpriteEntry::nameHash) + 9 * sizeof(std::uint16_t) +
+                                                  4 * sizeof(float);
+        if (spriteCount > (reader.size - reader.offset) / kSpriteRecordSize)
+        {
+            return false;
+        }
+        sprites.resize(spriteCount);
+        for (AtlasSpriteEntry& sprite : sprites)
+        {
+            if (!reader.Read(sprite.nameHash) || !reader.Read(sprite.page) ||
+                !reader.Read(sprite.x) || !reader.Read(sprite.y) ||
+                !reader.Read(sprite.width) || !reader.Read(sprite.height) ||
+                !reader.Read(sprite.trimX) || !reader.Read(sprite.trimY) ||
+                !reader.Read(sprite.sourceWidth) || !reader.Read(sprite.sourceHeight) ||
+                !reader.Read(sprite.u0) || !reader.Read(sprite.v0) ||
+                !reader.Read(sprite.u1) || !reader.Read(sprite.v1) ||
+                sprite.page >= pageCount)
+            {
+                return false;
+            }
+        }
+        return true;
+    }
+}
@@ -0,0 +1,78 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace polaris
+{
+    /**
+     * @brief On-disk layout of texture atlas indices (.patlas), written by polaris-atlas.
+     *
+     * A file starts with the magic and a header, followed by the page table and the sprite table:
+     *  - header: u16 version, u16 pageCount, u32 spriteCount
+     *  - page:   u16 width, u16 height, u16 fileLength, file (path relative to the .patlas)
+     *  - sprite: u64 nameHash, u16 page, u16 x, u16 y, u16 width, u16 height,
+     *            u16 trimX, u16 trimY, u16 sourceWidth, u16 sourceHeight,
+     *            f32 u0, f32 v0, f32 u1, f32 v1
+     * Sprites are sorted by nameHash. All integers are little-endian.
+     */
+    constexpr char kAtlasMagic[4] = {'P', 'A', 'T', 'L'};
+    constexpr std::uint16_t kAtlasVersion = 1;
+
+    /**
+     * @brief 64-bit FNV-1a hash of a sprite name. Names are the image path relative to the
+     * atlas source directory, with '/' separators and without the extension, e.g. "player/idle_0".
+     */
+    constexpr std::uint64_t HashAtlasName(std::string_view name)
+    {
+        std::uint64_t hash = 14695981039346656037ull;
+        for (char c : name)
+        {
+            hash ^= static_cast<unsigned char>(c);
+            hash *= 1099511628211ull;
+        }
+        return hash;
+    }
+
+    struct AtlasPageInfo
+    {
+        std::uint16_t width = 0;
+        std::uint16_t height = 0;
+        std::string file;
+    };
+
+    struct AtlasSpriteEntry
+    {
+        std::uint64_t nameHash = 0;
+        std::uint16_t page = 0;
+        std::uint16_t x = 0;             ///< Trimmed image position in the page, in texels.
+        std::uint16_t y = 0;
+        std::uint16_t width = 0;         ///< Trimmed image size, in texels.
+        std::uint16_t height = 0;
+        std::uint16_t trimX = 0;         ///< Offset of the trimmed image inside the original image.
+        std::uint16_t trimY = 0;
+        std::uint16_t sourceWidth = 0;   ///< Size of the original, untrimmed image.
+        std::uint16_t sourceHeight = 0;
+        float u0 = 0.0f;                 ///< Normalised texture coordinates of the trimmed image.
+        float v0 = 0.0f;
+        float u1 = 0.0f;
+        float v1 = 0.0f;
+    };
+
+    /**
+     * @brief Writes an atlas index. Sprites are sorted by hash before writing.
+     * @return false if the file cannot be written.
+     */
+    bool WriteAtlasIndex(const std::string& path, const std::vector<AtlasPageInfo>& pages,
+                         std::vector<AtlasSpriteEntry> sprites);
+
+    /**
+     * @brief Reads an atlas index.
+     * @return false if the file cannot be read or is not a supported .patlas file.
+     */
+    bool ReadAtlasIndex(const std::string& path, std::vector<AtlasPageInfo>& pages,
+                        std::vector<AtlasSpriteEntry>& sprites);
+}
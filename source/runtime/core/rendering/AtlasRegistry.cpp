@@ -0,0 +1,312 @@
+#include "AtlasRegistry.h"
+
+#include "Logger.h"
+#include "memory/MemoryTracker.h"
+#include <SDL3_image/SDL_image.h>
+#include <algorithm>
+#include <filesystem>
+
+namespace polaris
+{
+    namespace
+    {
+        /**
+         * @brief Folds the high bits of a name hash into the slot index.
+         */
+        std::size_t SlotOf(std::uint64_t nameHash, std::size_t mask)
+        {
+            return static_cast<std::size_t>(nameHash ^ (nameHash >> 32)) & mask;
+        }
+    }
+
+    DecodedAtlas::~DecodedAtlas()
+    {
+        for (SDL_Surface* surface : surfaces)
+        {
+            SDL_DestroySurface(surface);
+        }
+    }
+
+    AtlasRegistry::AtlasRegistry() : m_count(0)
+    {
+    }
+
+    /**
+     * @brief Loads an atlas index, uploads its pages and adds its sprites to the table.
+     * Loading a file that is already loaded does nothing.
+     */
+    bool AtlasRegistry::Load(const std::string& path, CommandList& commands)
+    {
+        POLARIS_MEMORY_SCOPE(Assets);
+        const std::string indexPath = std::filesystem::path(path).lexically_normal().string();
+        for (const LoadedAtlas& loaded : m_atlases)
+        {
+            if (loaded.path == indexPath)
+            {
+                return true;
+            }
+        }
+
+        DecodedAtlas decoded;
+        if (!Decode(indexPath, decoded))
+        {
+            return false;
+        }
+
+        LoadedAtlas atlas;
+        atlas.path = decoded.path;
+        atlas.pageInfo = decoded.pages;
+        atlas.entries = decoded.entries;
+        for (std::size_t i = 0; i < decoded.pages.size(); ++i)
+        {
+            SDL_Surface* surface = decoded.surfaces[i];
+            const TextureHandle texture = commands.CreateTexture(surface->w, surface->h, TextureAccess::Static);
+            commands.UpdateTexture(texture, nullptr, surface->pixels, surface->pitch, surface->h);
+            atlas.pages.push_back(texture);
+            atlas.pageFiles.push_back(
+                (std::filesystem::path(indexPath).parent_path() / decoded.pages[i].file).lexically_normal().string());
+        }
+
+        Reserve(m_count + atlas.entries.size());
+        AddSprites(atlas);
+        m_atlases.push_back(std::move(atlas));
+        LOG_INFO("Loaded atlas {}: {} sprites on {} pages", indexPath, decoded.entries.size(), decoded.pages.size());
+        return true;
+    }
+
+    /**
+     * @brief Records the destruction of every page and empties the table.
+     */
+    void AtlasRegistry::Clear(CommandList& commands)
+    {
+        for (const LoadedAtlas& atlas : m_atlases)
+        {
+            for (TextureHandle page : atlas.pages)
+            {
+                commands.DestroyTexture(page);
+            }
+        }
+        m_atlases.clear();
+        std::fill(m_keys.begin(), m_keys.end(), 0);
+        m_count = 0;
+    }
+
+    /**
+     * @brief Reads the index and decodes every page, so that a missing page is reported before
+     * anything is recorded and never leaves a half-loaded atlas.
+     */
+    bool AtlasRegistry::Decode(const std::string& path, DecodedAtlas& atlas)
+    {
+        const std::filesystem::path indexPath = std::filesystem::path(path).lexically_normal();
+        atlas.path = indexPath.string();
+        if (!ReadAtlasIndex(atlas.path, atlas.pages, atlas.entries))
+        {
+            LOG_ERROR("Failed to read atlas index {}", atlas.path);
+            return false;
+        }
+
+        for (const AtlasPageInfo& page : atlas.pages)
+        {
+            const std::string pagePath = (indexPath.parent_path() / page.file).string();
+            SDL_Surface* loaded = IMG_Load(pagePath.c_str());
+            SDL_Surface* surface = loaded ? SDL_ConvertSurface(loaded, SDL_PIXELFORMAT_RGBA32) : nullptr;
+            if (loaded)
+            {
+                SDL_DestroySurface(loaded);
+            }
+            if (!surface || surface->w != page.width || surface->h != page.height)
+            {
+                LOG_ERROR("Failed to load atlas page {}: {}", pagePath, surface ? "size mismatch" : SDL_GetError());
+                if (surface)
+                {
+                    SDL_DestroySurface(surface);
+                }
+                return false;
+            }
+            atlas.surfaces.push_back(surface);
+        }
+        return true;
+    }
+
+    /**
+     * @brief Uploads the new pages over the old ones where the sizes allow, then rebuilds the
+     * table from every loaded atlas, since sprites may have been removed or renamed.
+     */
+    bool AtlasRegistry::Reload(const DecodedAtlas& decoded, CommandList& commands)
+    {
+        POLARIS_MEMORY_SCOPE(Assets);
+        const auto found = std::find_if(m_atlases.begin(), m_atlases.end(),
+                                        [&decoded](const LoadedAtlas& atlas) { return atlas.path == decoded.path; });
+        if (found == m_atlases.end() || decoded.surfaces.size() != decoded.pages.size())
+        {
+            return false;
+        }
+
+        LoadedAtlas& atlas = *found;
+        const std::filesystem::path directory = std::filesystem::path(decoded.path).parent_path();
+        std::vector<TextureHandle> pages;
+        std::vector<std::string> pageFiles;
+        for (std::size_t i = 0; i < decoded.pages.size(); ++i)
+        {
+            const SDL_Surface* surface = decoded.surfaces[i];
+            TextureHandle texture;
+            if (i < atlas.pages.size() && atlas.pageInfo[i].width == decoded.pages[i].width &&
+                atlas.pageInfo[i].height == decoded.pages[i].height)
+            {
+                texture = atlas.pages[i];
+            }
+            else
+            {
+                texture = commands.CreateTexture(surface->w, surface->h, TextureAccess::Static);
+                if (i < atlas.pages.size())
+                {
+                    commands.DestroyTexture(atlas.pages[i]);
+                }
+            }
+            commands.UpdateTexture(texture, nullptr, surface->pixels, surface->pitch, surface->h);
+            pages.push_back(texture);
+            pageFiles.push_back((directory / decoded.pages[i].file).lexically_normal().string());
+        }
+        for (std::size_t i = decoded.pages.size(); i < atlas.pages.size(); ++i)
+        {
+            commands.DestroyTexture(atlas.pages[i]);
+        }
+
+        atlas.pages = std::move(pages);
+        atlas.pageFiles = std::move(pageFiles);
+        atlas.pageInfo = decoded.pages;
+        atlas.entries = decoded.entries;
+
+        std::size_t count = 0;
+        for (const LoadedAtlas& loaded : m_atlases)
+        {
+            count += loaded.entries.size();
+        }
+        std::fill(m_keys.begin(), m_keys.end(), 0);
+        m_count = 0;
+        Reserve(count);
+        for (const LoadedAtlas& loaded : m_atlases)
+        {
+            AddSprites(loaded);
+        }
+        LOG_INFO("Reloaded atlas {}: {} sprites on {} pages", decoded.path, decoded.entries.size(), decoded.pages.size());
+        return true;
+    }
+
+    std::string AtlasRegistry::FindAtlas(const std::string& file) const
+    {
+        const std::filesystem::path query = std::filesystem::path(file).lexically_normal();
+        for (const LoadedAtlas& atlas : m_atlases)
+        {
+            if (query == std::filesystem::path(atlas.path) ||
+                std::any_of(atlas.pageFiles.begin(), atlas.pageFiles.end(),
+                            [&query](const std::string& page) { return query == std::filesystem::path(page); }))
+            {
+                return atlas.path;
+            }
+        }
+        return std::string();
+    }
+
+    void AtlasRegistry::Reserve(std::size_t count)
+    {
+        if (count * 2 <= m_keys.size())
+        {
+            return;
+        }
+        std::size_t capacity = std::max<std::size_t>(m_keys.size(), 16);
+        while (count * 2 > capacity)
+        {
+            capacity *= 2;
+        }
+        Rehash(capacity);
+    }
+
+    void AtlasRegistry::AddSprites(const LoadedAtlas& atlas)
+    {
+        for (const AtlasSpriteEntry& entry : atlas.entries)
+        {
+            AtlasSprite sprite;
+            sprite.texture = atlas.pages[entry.page];
+            sprite.source = {static_cast<float>(entry.x), static_cast<float>(entry.y),
+                             static_cast<float>(entry.width), static_cast<float>(entry.height)};
+            sprite.u0 = entry.u0;
+            sprite.v0 = entry.v0;
+            sprite.u1 = entry.u1;
+            sprite.v1 = entry.v1;
+            sprite.trimX = entry.trimX;
+            sprite.trimY = entry.trimY;
+            sprite.width = entry.sourceWidth;
+            sprite.height = entry.sourceHeight;
+            Insert(entry.nameHash, sprite);
+        }
+    }
+
+    /**
+     * @brief Linear probe from the hash's slot until the key or an empty slot is found.
+     */
+    const AtlasSprite* AtlasRegistry::Find(std::uint64_t nameHash) const
+    {
+        if (m_keys.empty() || nameHash == 0)
+        {
+            return nullptr;
+        }
+
+        const std::size_t mask = m_keys.size() - 1;
+        for (std::size_t slot = SlotOf(nameHash, mask);; slot = (slot + 1) & mask)
+        {
+            if (m_keys[slot] == nameHash)
+            {
+                return &m_values[slot];
+            }
+            if (m_keys[slot] == 0)
+            {
+                return nullptr;
+            }
+        }
+    }
+
+    /**
+     * @brief Inserts or replaces a sprite. The table must have a free slot.
+     */
+    void AtlasRegistry::Insert(std::uint64_t nameHash, const AtlasSprite& sprite)
+    {
+        const std::size_t mask = m_keys.size() - 1;
+        for (std::size_t slot = SlotOf(nameHash, mask);; slot = (slot + 1) & mask)
+        {
+            if (m_keys[slot] == nameHash)
+            {
+                LOG_WARN("Atlas sprite {:x} defined more than once; using the last one", nameHash);
+                m_values[slot] = sprite;
+                return;
+            }
+            if (m_keys[slot] == 0)
+            {
+                m_keys[slot] = nameHash;
+                m_values[slot] = sprite;
+                ++m_count;
+                return;
+            }
+        }
+    }
+
+    /**
+     * @brief Grows the table to a new power-of-two capacity, reinserting every sprite.
+     */
+    void AtlasRegistry::Rehash(std::size_t capacity)
+    {
+        std::vector<std::uint64_t> keys(capacity, 0);
+        std::vector<AtlasSprite> values(capacity);
+        keys.swap(m_keys);
+        values.swap(m_values);
+        m_count = 0;
+
+        for (std::size_t i = 0; i < keys.size(); ++i)
+        {
+            if (keys[i] != 0)
+            {
+                Insert(keys[i], values[i]);
+            }
+        }
+    }
+}
@@ -0,0 +1,150 @@
+#pragma once
+
+#include "AtlasFormat.h"
+#include "CommandList.h"
+#include <SDL3/SDL.h>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace polaris
+{
+    /**
+     * @brief Where a named sprite lives inside a loaded atlas.
+     */
+    struct AtlasSprite
+    {
+        TextureHandle texture = 0;                       ///< The atlas page.
+        SDL_FRect source = {0.0f, 0.0f, 0.0f, 0.0f};     ///< Trimmed image in the page, in texels; use as Sprite::source.
+        float u0 = 0.0f;                                 ///< Normalised texture coordinates of source.
+        float v0 = 0.0f;
+        float u1 = 0.0f;
+        float v1 = 0.0f;
+        float trimX = 0.0f;                              ///< Offset of the trimmed image inside the original image.
+        float trimY = 0.0f;
+        float width = 0.0f;                              ///< Size of the original, untrimmed image.
+        float height = 0.0f;
+
+        /**
+         * @brief Destination rectangle for drawing the sprite as if it were the original image
+         * with its top-left corner at (x, y), accounting for the trimmed transparent border.
+         */
+        SDL_FRect Place(float x, float y, float scale = 1.0f) const
+        {
+            return {x + trimX * scale, y + trimY * scale, source.w * scale, source.h * scale};
+        }
+    };
+
+    /**
+     * @brief An atlas index and its page images read from disk. Decoding touches no registry,
+     * so it can run on any thread; see AtlasRegistry::Decode().
+     */
+    struct DecodedAtlas
+    {
+        std::string path;
+        std::vector<AtlasPageInfo> pages;
+        std::vector<AtlasSpriteEntry> entries;
+        std::vector<SDL_Surface*> surfaces;   ///< RGBA32 page images, destroyed with the DecodedAtlas.
+
+        DecodedAtlas() = default;
+        ~DecodedAtlas();
+
+        DecodedAtlas(const DecodedAtlas&) = delete;
+        DecodedAtlas& operator=(const DecodedAtlas&) = delete;
+    };
+
+    /**
+     * @brief Resolves sprite names to atlas pages and rectangles.
+     *
+     * Load() reads a .patlas index written by polaris-atlas and records the creation of its
+     * pages, once per file. Lookups hash the name (or take a precomputed HashAtlasName()) and
+     * probe a flat open-addressing table, so resolving a sprite is O(1) and never allocates.
+     * Names from all loaded atlases share one namespace.
+     */
+    class AtlasRegistry
+    {
+    public:
+        AtlasRegistry();
+
+        /**
+         * @brief Loads an atlas index and its page images.
+         * @param path Path of the .patlas file; page images are resolved relative to it.
+         * @param commands Command list to record the page uploads into.
+         * @return false if the index or one of its pages cannot be loaded.
+         */
+        bool Load(const std::string& path, CommandList& commands);
+
+        /**
+         * @brief Records the destruction of every page and forgets all sprites.
+         */
+        void Clear(CommandList& commands);
+
+        /**
+         * @brief Reads an atlas index and decodes its pages, without loading them.
+         * @param path Path of the .patlas file; page images are resolved relative to it.
+         * @return false if the index or one of its pages cannot be read.
+         */
+        static bool Decode(const std::string& path, DecodedAtlas& atlas);
+
+        /**
+         * @brief Replaces a loaded atlas with a new version of it, e.g. after it was rebuilt.
+         * Pages that kept their size are updated in place, so their handles and any copied
+         * AtlasSprite stay valid; other pages are recreated. Sprites are looked up in the new
+         * version from then on.
+         * @return false if the atlas is not loaded or was not fully decoded.
+         */
+        bool Reload(const DecodedAtlas& atlas, CommandList& commands);
+
+        /**
+         * @brief Finds the loaded atlas that a file belongs to, as its index or a page image.
+         * @return The atlas path to Decode() and Reload(), or empty if no loaded atlas uses the file.
+         */
+        std::string FindAtlas(const std::string& file) const;
+
+        /**
+         * @brief Looks a sprite up by name, e.g. "player/idle_0".
+         * @return The sprite, or nullptr if no loaded atlas contains it.
+         */
+        const AtlasSprite* Find(std::string_view name) const { return Find(HashAtlasName(name)); }
+
+        /**
+         * @brief Looks a sprite up by HashAtlasName() of its name.
+         */
+        const AtlasSprite* Find(std::uint64_t nameHash) const;
+
+        /**
+         * @brief Number of sprites across all loaded atlases.
+         */
+        std::size_t GetSpriteCount() const { return m_count; }
+
+    private:
+        struct LoadedAtlas
+        {
+            std::string path;
+            std::vector<AtlasPageInfo> pageInfo;
+            std::vector<std::string> pageFiles;   ///< Page image paths, normalised like path.
+            std::vector<TextureHandle> pages;
+            std::vector<AtlasSpriteEntry> entries;
+        };
+
+        /**
+         * @brief Grows the table to hold count sprites at most half full.
+         */
+        void Reserve(std::size_t count);
+        void AddSprites(const LoadedAtlas& atlas);
+        void Insert(std::uint64_t nameHash, const AtlasSprite& sprite);
+        void Rehash(std::size_t capacity);
+
+        /**
+         * @brief Slot keys (name hashes, 0 for empty) and values. The capacity is a power of
+         * two kept at least twice the sprite count, so probe sequences stay short.
+         */
+        std::vector<std::uint64_t> m_keys;
+        std::vector<AtlasSprite> m_values;
+        std::size_t m_count;
+
+        std::vector<LoadedAtlas> m_atlases;
+    };
+}
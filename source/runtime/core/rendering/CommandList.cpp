@@ -0,0 +1,388 @@
+#include "CommandList.h"
+
+#include <cstring>
+#include <stdexcept>
+
+namespace polaris
+{
+    /**
+     * @brief Returns a recycled handle if one is available, otherwise a new one.
+     */
+    TextureHandle TextureHandlePool::Allocate()
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (!m_free.empty())
+        {
+            const TextureHandle handle = m_free.back();
+            m_free.pop_back();
+            return handle;
+        }
+        return m_next++;
+    }
+
+    /**
+     * @brief Makes a handle available again. Called by the renderer after DestroyTexture executes.
+     */
+    void TextureHandlePool::Release(TextureHandle handle)
+    {
+        if (handle == 0)
+        {
+            return;
+        }
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_free.push_back(handle);
+    }
+
+    /**
+     * @brief Constructs an empty command list.
+     * @param textureHandles Pool CreateTexture allocates handles from; required for CreateTexture.
+     */
+    CommandList::CommandList(TextureHandlePool* textureHandles) : m_textureHandles(textureHandles) {
+    }
+
+    RenderCommand& CommandList::Append(RenderCommandType type)
+    {
+        // Value-initialised, so every field a command does not use is zero.
+        RenderCommand& command = m_commands.emplace_back();
+        command.type = type;
+        return command;
+    }
+
+    std::uint32_t CommandList::AppendPayload(const void* data, std::size_t size)
+    {
+        const std::size_t offset = m_payload.size();
+        m_payload.resize(offset + size);
+        std::memcpy(m_payload.data() + offset, data, size);
+        return static_cast<std::uint32_t>(offset);
+    }
+
+    /**
+     * @brief Appends rowCount rows of rowSize bytes, pitch bytes apart in the source, without gaps.
+     */
+    void CommandList::AppendPlane(const std::uint8_t* rows, int pitch, std::size_t rowSize, int rowCount)
+    {
+        std::size_t offset = m_payload.size();
+        m_payload.resize(offset + rowSize * static_cast<std::size_t>(rowCount));
+        for (int row = 0; row < rowCount; ++row, offset += rowSize)
+        {
+            std::memcpy(m_payload.data() + offset, rows + static_cast<std::ptrdiff_t>(row) * pitch, rowSize);
+        }
+    }
+
+    /**
+     * @brief Clears the current target to a colour.
+     */
+    void CommandList::Clear(const SDL_FColor& color)
+    {
+        Append(RenderCommandType::Clear).color = color;
+    }
+
+    /**
+     * @brief Returns the DrawSprites command sprites are appended to, starting a new one if the
+     * previous command was something else.
+     */
+    RenderCommand& CommandList::SpriteRun()
+    {
+        if (!m_commands.empty() && m_commands.back().type == RenderCommandType::DrawSprites)
+        {
+            return m_commands.back();
+        }
+        RenderCommand& command = Append(RenderCommandType::DrawSprites);
+        command.first = static_cast<std::uint32_t>(m_sprites.size());
+        return command;
+    }
+
+    /**
+     * @brief Draws a solid or textured axis-aligned rectangle.
+     */
+    void CommandList::DrawQuad(const SDL_FRect& destination, const SDL_FColor& color,
+                               TextureHandle texture, const SDL_FRect* source)
+    {
+        Sprite sprite;
+        sprite.destination = destination;
+        sprite.color = color;
+        sprite.texture = texture;
+        if (source)
+        {
+            sprite.source = *source;
+        }
+        DrawSprite(sprite);
+    }
+
+    /**
+     * @brief Draws a sprite.
+     */
+    void CommandList::DrawSprite(const Sprite& sprite)
+    {
+        SpriteRun().count += 1;
+        m_sprites.push_back(sprite);
+    }
+
+    /**
+     * @brief Draws many sprites at once.
+     */
+    void CommandList::DrawSprites(const Sprite* sprites, std::size_t count)
+    {
+        if (count == 0)
+        {
+            return;
+        }
+        SpriteRun().count += static_cast<std::uint32_t>(count);
+        m_sprites.insert(m_sprites.end(), sprites, sprites + count);
+    }
+
+    /**
+     * @brief Draws triangles, copying the vertex and index data into the list.
+     */
+    void CommandList::DrawGeometry(TextureHandle texture, const SDL_Vertex* vertices, int vertexCount,
+                                   const int* indices, int indexCount)
+    {
+        if (vertexCount <= 0)
+        {
+            return;
+        }
+
+        RenderCommand& command = Append(RenderCommandType::DrawGeometry);
+        command.texture = texture;
+        command.first = static_cast<std::uint32_t>(m_vertices.size());
+        command.count = static_cast<std::uint32_t>(vertexCount);
+        m_vertices.insert(m_vertices.end(), vertices, vertices + vertexCount);
+
+        if (indices && indexCount > 0)
+        {
+            command.firstIndex = static_cast<std::uint32_t>(m_indices.size());
+            command.indexCount = static_cast<std::uint32_t>(indexCount);
+            m_indices.insert(m_indices.end(), indices, indices + indexCount);
+        }
+    }
+
+    /**
+     * @brief Redirects subsequent drawing into a target texture, or back to the window with 0.
+     */
+    void CommandList::SetTarget(TextureHandle target)
+    {
+        Append(RenderCommandType::SetTarget).texture = target;
+    }
+
+    /**
+     * @brief Presents the window.
+     */
+    void CommandList::Present()
+    {
+        Append(RenderCommandType::Present);
+    }
+
+    /**
+     * @brief Allocates a handle and records the creation of an RGBA8 texture.
+     * @throws std::logic_error if the list has no texture handle pool.
+     */
+    TextureHandle CommandList::CreateTexture(int width, int height, TextureAccess access, const void* pixels)
+    {
+        if (!m_textureHandles)
+        {
+            throw std::logic_error("CommandList::CreateTexture requires a texture handle pool");
+        }
+
+        const TextureHandle handle = m_textureHandles->Allocate();
+        RenderCommand& command = Append(RenderCommandType::CreateTexture);
+        command.texture = handle;
+        command.access = access;
+        command.width = width;
+        command.height = height;
+        if (pixels)
+        {
+            const std::size_t size = static_cast<std::size_t>(width) * static_cast<std::size_t>(height) * 4;
+            // AppendPayload may reallocate m_payload but not m_commands, so command stays valid.
+            command.first = AppendPayload(pixels, size);
+            command.count = static_cast<std::uint32_t>(size);
+        }
+        return handle;
+    }
+
+    /**
+     * @brief Records the creation of an empty texture of any format.
+     * @throws std::logic_error if the list has no texture handle pool.
+     */
+    TextureHandle CommandList::CreateTexture(int width, int height, TextureFormat format, TextureAccess access,
+                                             YUVColorspace colorspace)
+    {
+        const TextureHandle handle = CreateTexture(width, height, access);
+        m_commands.back().format = format;
+        m_commands.back().colorspace = colorspace;
+        return handle;
+    }
+
+    /**
+     * @brief Records an upload of RGBA8 pixels into a texture.
+     */
+    void CommandList::UpdateTexture(TextureHandle texture, const SDL_Rect* region, const void* pixels, int pitch, int rows)
+    {
+        if (texture == 0 || !pixels || pitch <= 0 || rows <= 0)
+        {
+            return;
+        }
+
+        RenderCommand& command = Append(RenderCommandType::UpdateTexture);
+        command.texture = texture;
+        command.pitch = pitch;
+        if (region)
+        {
+            command.region = *region;
+            command.hasRegion = true;
+        }
+        const std::size_t size = static_cast<std::size_t>(pitch) * static_cast<std::size_t>(rows);
+        command.first = AppendPayload(pixels, size);
+        command.count = static_cast<std::uint32_t>(size);
+    }
+
+    /**
+     * @brief Records a YUV 4:2:0 upload. The payload holds the Y, U and V planes back to back,
+     * width and (width + 1) / 2 bytes per row.
+     */
+    void CommandList::UpdateTextureYUV(TextureHandle texture, int width, int height,
+                                       const std::uint8_t* yPlane, int yPitch,
+                                       const std::uint8_t* uPlane, int uPitch,
+                                       const std::uint8_t* vPlane, int vPitch)
+    {
+        if (texture == 0 || width <= 0 || height <= 0 || !yPlane || !uPlane || !vPlane)
+        {
+            return;
+        }
+
+        RenderCommand& command = Append(RenderCommandType::UpdateTextureYUV);
+        command.texture = texture;
+        command.region = {0, 0, width, height};
+        command.hasRegion = true;
+        command.pitch = width;
+        command.first = static_cast<std::uint32_t>(m_payload.size());
+        const std::size_t chromaWidth = static_cast<std::size_t>(width + 1) / 2;
+        const int chromaHeight = (height + 1) / 2;
+        AppendPlane(yPlane, yPitch, static_cast<std::size_t>(width), height);
+        AppendPlane(uPlane, uPitch, chromaWidth, chromaHeight);
+        AppendPlane(vPlane, vPitch, chromaWidth, chromaHeight);
+        command.count = static_cast<std::uint32_t>(m_payload.size() - command.first);
+    }
+
+    /**
+     * @brief Records an NV12 upload. The payload holds the Y plane, width bytes per row,
+     * followed by the UV plane, (width + 1) / 2 * 2 bytes per row.
+     */
+    void CommandList::UpdateTextureNV(TextureHandle texture, int width, int height,
+                                      const std::uint8_t* yPlane, int yPitch,
+                                      const std::uint8_t* uvPlane, int uvPitch)
+    {
+        if (texture == 0 || width <= 0 || height <= 0 || !yPlane || !uvPlane)
+        {
+            return;
+        }
+
+        RenderCommand& command = Append(RenderCommandType::UpdateTextureNV);
+        command.texture = texture;
+        command.region = {0, 0, width, height};
+        command.hasRegion = true;
+        command.pitch = width;
+        command.first = static_cast<std::uint32_t>(m_payload.size());
+        AppendPlane(yPlane, yPitch, static_cast<std::size_t>(width), height);
+        AppendPlane(uvPlane, uvPitch, static_cast<std::size_t>(width + 1) / 2 * 2, (height + 1) / 2);
+        command.count = static_cast<std::uint32_t>(m_payload.size() - command.first);
+    }
+
+    /**
+     * @brief Records the destruction of a texture.
+     */
+    void CommandList::DestroyTexture(TextureHandle texture)
+    {
+        if (texture != 0)
+        {
+            Append(RenderCommandType::DestroyTexture).texture = texture;
+        }
+    }
+
+    namespace
+    {
+        /**
+         * @brief YUV to RGB conversion in 8.8 fixed point: the luma offset and scale, then the
+         * V weight of red, the U and V weights of green and the U weight of blue.
+         */
+        struct YUVMatrix
+        {
+            int yOffset;
+            int yScale;
+            int rv;
+            int gu;
+            int gv;
+            int bu;
+        };
+
+        // Indexed by YUVColorspace
+        constexpr YUVMatrix kYUVMatrices[] = {
+            {16, 298, 409, 100, 208, 516},   // BT.601 limited
+            {0, 256, 359, 88, 183, 454},     // BT.601 full
+            {16, 298, 459, 55, 136, 541},    // BT.709 limited
+            {0, 256, 403, 48, 120, 475}      // BT.709 full
+        };
+
+        std::uint32_t YUVToRGBA(const YUVMatrix& matrix, int y, int u, int v)
+        {
+            const int c = (y - matrix.yOffset) * matrix.yScale + 128;
+            const int d = u - 128;
+            const int e = v - 128;
+            const auto channel = [](int value) {
+                value >>= 8;
+                return static_cast<std::uint32_t>(value < 0 ? 0 : (value > 255 ? 255 : value));
+            };
+            return channel(c + matrix.rv * e) | (channel(c - matrix.gu * d - matrix.gv * e) << 8) |
+                   (channel(c + matrix.bu * d) << 16) | 0xFF000000u;
+        }
+    }
+
+    /**
+     * @brief Converts a YUV or NV12 upload to RGBA8, one chroma sample per 2x2 pixels.
+     */
+    void CommandList::DecodeYUV(const RenderCommand& command, YUVColorspace colorspace, std::uint32_t* pixels,
+                                int pitch) const
+    {
+        const YUVMatrix& matrix = kYUVMatrices[static_cast<int>(colorspace)];
+        const bool planar = command.type == RenderCommandType::UpdateTextureYUV;
+        const int width = command.region.w;
+        const int height = command.region.h;
+        const std::size_t chromaPitch = planar ? static_cast<std::size_t>(width + 1) / 2
+                                               : static_cast<std::size_t>(width + 1) / 2 * 2;
+        const std::uint8_t* y = GetPayload(command.first);
+        const std::uint8_t* u = y + static_cast<std::size_t>(width) * height;
+        const std::uint8_t* v = u + chromaPitch * static_cast<std::size_t>((height + 1) / 2);
+        for (int row = 0; row < height; ++row)
+        {
+            const std::uint8_t* luma = y + static_cast<std::size_t>(row) * width;
+            const std::size_t chromaRow = static_cast<std::size_t>(row / 2) * chromaPitch;
+            std::uint32_t* out = pixels + static_cast<std::size_t>(row) * pitch;
+            for (int column = 0; column < width; ++column)
+            {
+                const std::size_t sample = static_cast<std::size_t>(column / 2);
+                out[column] = planar ? YUVToRGBA(matrix, luma[column], u[chromaRow + sample], v[chromaRow + sample])
+                                     : YUVToRGBA(matrix, luma[column], u[chromaRow + sample * 2],
+                                                 u[chromaRow + sample * 2 + 1]);
+            }
+        }
+    }
+
+    void CommandList::SetDamage(const SDL_Rect* rects, std::size_t count)
+    {
+        m_damage.assign(rects, rects + count);
+        m_tracksDamage = true;
+    }
+
+    /**
+     * @brief Empties the list, keeping its storage for the next frame.
+     */
+    void CommandList::Reset()
+    {
+        m_commands.clear();
+        m_sprites.clear();
+        m_vertices.clear();
+        m_indices.clear();
+        m_payload.clear();
+        m_damage.clear();
+        m_tracksDamage = false;
+    }
+}
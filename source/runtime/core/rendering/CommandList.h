@@ -0,0 +1,311 @@
+#pragma once
+
+#include <SDL3/SDL.h>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <vector>
+
+namespace polaris
+{
+    /**
+     * @brief Identifies a texture owned by the renderer. 0 means "no texture" (or, for
+     * SetTarget, the window).
+     *
+     * Handles are allocated on the recording thread, while the texture itself is created when
+     * the render thread executes the CreateTexture command, so a handle may be used in the same
+     * command list that creates it.
+     */
+    using TextureHandle = std::uint32_t;
+
+    /**
+     * @brief How a texture will be used, mirroring SDL_TextureAccess.
+     */
+    enum class TextureAccess : std::uint8_t
+    {
+        Static,     ///< Uploaded rarely.
+        Streaming,  ///< Updated frequently, e.g. video frames.
+        Target      ///< Can be bound with SetTarget and rendered into.
+    };
+
+    /**
+     * @brief Pixel layout of a texture.
+     */
+    enum class TextureFormat : std::uint8_t
+    {
+        RGBA8,      ///< 8-bit RGBA, the format of every texture created with pixels.
+        IYUV,       ///< Planar YUV 4:2:0: Y plane, then U and V planes at half resolution.
+        NV12        ///< Y plane, then one plane of interleaved U and V samples at half resolution.
+    };
+
+    /**
+     * @brief Matrix and range YUV samples of a texture are converted to RGB with.
+     * Limited range puts black at 16 and white at 235; full range uses all 256 levels.
+     */
+    enum class YUVColorspace : std::uint8_t
+    {
+        BT601Limited,   ///< Standard definition video.
+        BT601Full,      ///< JPEG and most full range SD sources.
+        BT709Limited,   ///< HD video.
+        BT709Full
+    };
+
+    /**
+     * @brief Thread-safe allocator of texture handles. Handles are returned to the pool by the
+     * renderer once the DestroyTexture command has executed, so they are never reused while
+     * still referenced by a frame in flight.
+     */
+    class TextureHandlePool
+    {
+    public:
+        TextureHandle Allocate();
+        void Release(TextureHandle handle);
+
+    private:
+        std::mutex m_mutex;
+        std::vector<TextureHandle> m_free;
+        TextureHandle m_next = 1;
+    };
+
+    /**
+     * @brief How a sprite is composited onto the target.
+     */
+    enum class BlendMode : std::uint8_t
+    {
+        Blend,      ///< Alpha blending.
+        Add,        ///< Additive, for glows and particles.
+        Multiply,   ///< Multiplies the target by the source colour.
+        None        ///< Overwrites the target.
+    };
+
+    /**
+     * @brief A textured, tinted, optionally rotated quad.
+     *
+     * Sprites are batched by the renderer: within a frame they are drawn in ascending layer
+     * order, and within a layer grouped by blend mode and texture, otherwise keeping the order
+     * they were recorded in. Use layers wherever overlapping sprites with different textures
+     * must stack in a particular order.
+     */
+    struct Sprite
+    {
+        SDL_FRect destination = {0.0f, 0.0f, 0.0f, 0.0f};        ///< Rectangle in target pixels.
+        SDL_FRect source = {0.0f, 0.0f, 0.0f, 0.0f};             ///< Texels to draw; zero width means the whole texture.
+        SDL_FColor color = {1.0f, 1.0f, 1.0f, 1.0f};             ///< Tint, or fill colour without a texture.
+        TextureHandle texture = 0;                               ///< 0 draws a solid rectangle.
+        float rotation = 0.0f;                                   ///< Radians, clockwise about the centre.
+        std::int16_t layer = 0;                                  ///< Lower layers are drawn first.
+        BlendMode blend = BlendMode::Blend;
+    };
+
+    enum class RenderCommandType : std::uint8_t
+    {
+        Clear,
+        DrawSprites,
+        DrawGeometry,
+        SetTarget,
+        Present,
+        CreateTexture,
+        UpdateTexture,
+        UpdateTextureYUV,
+        UpdateTextureNV,
+        DestroyTexture
+    };
+
+    /**
+     * @brief One recorded command. Variable-sized data (vertices, indices, pixels) lives in the
+     * owning CommandList and is referenced by offset and count.
+     */
+    struct RenderCommand
+    {
+        RenderCommandType type;
+        TextureAccess access;     ///< CreateTexture
+        TextureFormat format;     ///< CreateTexture
+        YUVColorspace colorspace; ///< CreateTexture of an IYUV or NV12 texture
+        bool hasRegion;           ///< UpdateTexture: region is valid
+        TextureHandle texture;    ///< Texture drawn with, bound as target, or created/updated/destroyed
+        SDL_FColor color;         ///< Clear colour
+        SDL_Rect region;          ///< UpdateTexture; the updated size for UpdateTextureYUV/NV
+        std::uint32_t first;      ///< First sprite or vertex, or offset of the pixel payload
+        std::uint32_t count;      ///< Sprite or vertex count, or payload size in bytes
+        std::uint32_t firstIndex; ///< DrawGeometry
+        std::uint32_t indexCount; ///< DrawGeometry; 0 for non-indexed geometry
+        int width;                ///< CreateTexture
+        int height;               ///< CreateTexture
+        int pitch;                ///< UpdateTexture: bytes per row of the payload; YUV/NV planes are tightly packed
+    };
+
+    /**
+     * @brief A recorded frame of rendering commands.
+     *
+     * The game thread records frame N into one CommandList while the render thread executes
+     * frame N-1 from another. Everything a command needs is copied into the list, so callers
+     * may reuse their buffers as soon as a recording call returns. Reset() keeps the storage,
+     * so after the first few frames recording does not allocate.
+     */
+    class CommandList
+    {
+    public:
+        explicit CommandList(TextureHandlePool* textureHandles = nullptr);
+
+        /**
+         * @brief Clears the current target to a colour.
+         */
+        void Clear(const SDL_FColor& color);
+
+        /**
+         * @brief Draws an axis-aligned rectangle, either filled with color or textured and tinted by it.
+         * Shorthand for a layer 0, alpha-blended DrawSprite.
+         * @param destination Rectangle in target pixels.
+         * @param color Fill colour, or texture tint.
+         * @param texture Texture to draw, or 0 for a solid rectangle.
+         * @param source Area of the texture to draw, in texels; nullptr for the whole texture.
+         */
+        void DrawQuad(const SDL_FRect& destination, const SDL_FColor& color,
+                      TextureHandle texture = 0, const SDL_FRect* source = nullptr);
+
+        /**
+         * @brief Draws a sprite. Consecutive sprites are stored as a single command and batched.
+         */
+        void DrawSprite(const Sprite& sprite);
+
+        /**
+         * @brief Draws many sprites at once.
+         */
+        void DrawSprites(const Sprite* sprites, std::size_t count);
+
+        /**
+         * @brief Draws triangles.
+         * @param texture Texture sampled with the vertices' texture coordinates, or 0.
+         * @param vertices Vertex data, copied into the list.
+         * @param vertexCount Number of vertices.
+         * @param indices Optional triangle indices into vertices, copied into the list.
+         * @param indexCount Number of indices; 0 draws vertices as a triangle list.
+         */
+        void DrawGeometry(TextureHandle texture, const SDL_Vertex* vertices, int vertexCount,
+                          const int* indices = nullptr, int indexCount = 0);
+
+        /**
+         * @brief Redirects subsequent drawing into a target texture, or back to the window with 0.
+         */
+        void SetTarget(TextureHandle target);
+
+        /**
+         * @brief Presents the window. Normally recorded by the Engine at the end of each frame.
+         */
+        void Present();
+
+        /**
+         * @brief Allocates a handle and records the creation of an RGBA8 texture.
+         * @param width Width in texels.
+         * @param height Height in texels.
+         * @param access How the texture will be used.
+         * @param pixels Optional initial contents, width * height * 4 bytes, copied into the list.
+         * @return The new handle, usable immediately in this and later command lists.
+         */
+        TextureHandle CreateTexture(int width, int height, TextureAccess access, const void* pixels = nullptr);
+
+        /**
+         * @brief Allocates a handle and records the creation of an empty texture of any format,
+         * e.g. a streaming IYUV texture for video frames.
+         * @param colorspace How the samples of an IYUV or NV12 texture convert to RGB;
+         *        ignored for RGBA8.
+         * @return The new handle, usable immediately in this and later command lists.
+         */
+        TextureHandle CreateTexture(int width, int height, TextureFormat format, TextureAccess access,
+                                    YUVColorspace colorspace = YUVColorspace::BT601Limited);
+
+        /**
+         * @brief Records an upload of RGBA8 pixels into a texture.
+         * @param texture The texture to update.
+         * @param region Area to update, or nullptr for the whole texture.
+         * @param pixels Pixel data, copied into the list.
+         * @param pitch Bytes per row of pixels.
+         * @param rows Number of rows in pixels.
+         */
+        void UpdateTexture(TextureHandle texture, const SDL_Rect* region, const void* pixels, int pitch, int rows);
+
+        /**
+         * @brief Records an upload of planar YUV 4:2:0 pixels into the top-left width x height
+         * texels of an IYUV texture. Each plane is copied into the list row by row, without
+         * any colour conversion.
+         * @param yPlane Full-resolution luma rows, yPitch bytes apart.
+         * @param uPlane Half-resolution U rows, uPitch bytes apart.
+         * @param vPlane Half-resolution V rows, vPitch bytes apart.
+         */
+        void UpdateTextureYUV(TextureHandle texture, int width, int height,
+                              const std::uint8_t* yPlane, int yPitch,
+                              const std::uint8_t* uPlane, int uPitch,
+                              const std::uint8_t* vPlane, int vPitch);
+
+        /**
+         * @brief Records an upload of NV12 pixels into the top-left width x height texels of an
+         * NV12 texture, copied as for UpdateTextureYUV().
+         * @param uvPlane Half-resolution rows of interleaved U and V samples, uvPitch bytes apart.
+         */
+        void UpdateTextureNV(TextureHandle texture, int width, int height,
+                             const std::uint8_t* yPlane, int yPitch,
+                             const std::uint8_t* uvPlane, int uvPitch);
+
+        /**
+         * @brief Records the destruction of a texture. Its handle is recycled once this executes.
+         */
+        void DestroyTexture(TextureHandle texture);
+
+        /**
+         * @brief Declares which parts of the window changed since the previous frame, so that
+         * renderers keeping a copy of the last frame redraw and present only those. The frame
+         * must still be recorded in full: renderers without damage tracking redraw everything,
+         * and the others clip to the damage.
+         * @param rects Damaged rectangles in window pixels, copied into the list.
+         * @param count Number of rectangles; 0 damages the whole window.
+         */
+        void SetDamage(const SDL_Rect* rects, std::size_t count);
+
+        /**
+         * @brief Empties the list, keeping its storage for the next frame.
+         */
+        void Reset();
+
+        const std::vector<RenderCommand>& GetCommands() const { return m_commands; }
+        const std::vector<Sprite>& GetSprites() const { return m_sprites; }
+        const std::vector<SDL_Vertex>& GetVertices() const { return m_vertices; }
+        const std::vector<int>& GetIndices() const { return m_indices; }
+        const std::uint8_t* GetPayload(std::uint32_t offset) const { return m_payload.data() + offset; }
+        TextureHandlePool* GetTextureHandles() const { return m_textureHandles; }
+
+        /**
+         * @brief True if SetDamage() was called for this frame.
+         */
+        bool TracksDamage() const { return m_tracksDamage; }
+        /**
+         * @brief The damaged rectangles; empty when the whole window is damaged.
+         */
+        const std::vector<SDL_Rect>& GetDamage() const { return m_damage; }
+
+        /**
+         * @brief Converts the payload of an UpdateTextureYUV or UpdateTextureNV command to RGBA8,
+         * for renderers without YUV textures.
+         * @param command The command, which must belong to this list.
+         * @param colorspace The colorspace the texture was created with, so the result matches
+         *        what SDLRenderer shows for the same texture.
+         * @param pixels Receives region.w x region.h pixels.
+         * @param pitch Pixels per row of pixels.
+         */
+        void DecodeYUV(const RenderCommand& command, YUVColorspace colorspace, std::uint32_t* pixels, int pitch) const;
+
+    private:
+        RenderCommand& Append(RenderCommandType type);
+        std::uint32_t AppendPayload(const void* data, std::size_t size);
+        void AppendPlane(const std::uint8_t* rows, int pitch, std::size_t rowSize, int rowCount);
+        RenderCommand& SpriteRun();
+
+        std::vector<RenderCommand> m_commands;
+        std::vector<Sprite> m_sprites;
+        std::vector<SDL_Vertex> m_vertices;
+        std::vector<int> m_indices;
+        std::vector<std::uint8_t> m_payload;
+        std::vector<SDL_Rect> m_damage;
+        TextureHandlePool* m_textureHandles;
+        bool m_tracksDamage = false;
+    };
+}
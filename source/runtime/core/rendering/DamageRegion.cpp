@@ -0,0 +1,149 @@
+#include "DamageRegion.h"
+
+#include <algorithm>
+#include <limits>
+
+namespace polaris
+{
+    namespace
+    {
+        std::int64_t Area(const SDL_Rect& rect)
+        {
+            return static_cast<std::int64_t>(rect.w) * rect.h;
+        }
+
+        SDL_Rect Union(const SDL_Rect& a, const SDL_Rect& b)
+        {
+            SDL_Rect result;
+            SDL_GetRectUnion(&a, &b, &result);
+            return result;
+        }
+    }
+
+    void DamageRegion::SetBounds(int width, int height)
+    {
+        if (width != m_width || height != m_height)
+        {
+            m_width = width;
+            m_height = height;
+            AddAll();
+        }
+    }
+
+    /**
+     * @brief Clips the rectangle to the window and merges it into the region.
+     */
+    void DamageRegion::Add(const SDL_Rect& rect)
+    {
+        if (m_full)
+        {
+            return;
+        }
+        SDL_Rect clipped = rect;
+        if (m_width > 0 && m_height > 0)
+        {
+            const SDL_Rect bounds = {0, 0, m_width, m_height};
+            if (!SDL_GetRectIntersection(&rect, &bounds, &clipped))
+            {
+                return;
+            }
+        }
+        else if (rect.w <= 0 || rect.h <= 0)
+        {
+            return;
+        }
+
+        Insert(clipped);
+        if (m_rects.size() > kMaxRects)
+        {
+            MergeClosestPair();
+        }
+        if (m_width > 0 && m_height > 0 &&
+            static_cast<double>(m_area) > static_cast<double>(m_fullThreshold) * m_width * m_height)
+        {
+            AddAll();
+        }
+    }
+
+    void DamageRegion::AddAll()
+    {
+        m_full = true;
+        m_rects.clear();
+        m_area = 0;
+    }
+
+    void DamageRegion::Clear()
+    {
+        m_full = false;
+        m_rects.clear();
+        m_area = 0;
+    }
+
+    float DamageRegion::GetCoverage() const
+    {
+        if (m_full)
+        {
+            return 1.0f;
+        }
+        if (m_width <= 0 || m_height <= 0)
+        {
+            return m_rects.empty() ? 0.0f : 1.0f;
+        }
+        return std::min(1.0f, static_cast<float>(static_cast<double>(m_area) / (static_cast<double>(m_width) * m_height)));
+    }
+
+    /**
+     * @brief Adds a rectangle, first absorbing every rectangle it overlaps or sits close to.
+     * Merging can make the union reach further rectangles, so the scan restarts after each.
+     */
+    void DamageRegion::Insert(SDL_Rect rect)
+    {
+        for (std::size_t i = 0; i < m_rects.size();)
+        {
+            const SDL_Rect& other = m_rects[i];
+            const SDL_Rect merged = Union(rect, other);
+            // Joining is worth it while the bounding box wastes at most a quarter of the area
+            if (SDL_HasRectIntersection(&rect, &other) || Area(merged) * 4 <= (Area(rect) + Area(other)) * 5)
+            {
+                m_area -= Area(other);
+                m_rects[i] = m_rects.back();
+                m_rects.pop_back();
+                rect = merged;
+                i = 0;
+                continue;
+            }
+            ++i;
+        }
+        m_rects.push_back(rect);
+        m_area += Area(rect);
+    }
+
+    /**
+     * @brief Replaces the two rectangles whose bounding box adds the least area with that box.
+     */
+    void DamageRegion::MergeClosestPair()
+    {
+        std::size_t first = 0;
+        std::size_t second = 1;
+        std::int64_t bestGrowth = std::numeric_limits<std::int64_t>::max();
+        for (std::size_t i = 0; i < m_rects.size(); ++i)
+        {
+            for (std::size_t j = i + 1; j < m_rects.size(); ++j)
+            {
+                const std::int64_t growth = Area(Union(m_rects[i], m_rects[j])) - Area(m_rects[i]) - Area(m_rects[j]);
+                if (growth < bestGrowth)
+                {
+                    bestGrowth = growth;
+                    first = i;
+                    second = j;
+                }
+            }
+        }
+
+        const SDL_Rect merged = Union(m_rects[first], m_rects[second]);
+        m_area -= Area(m_rects[first]) + Area(m_rects[second]);
+        m_rects.erase(m_rects.begin() + static_cast<std::ptrdiff_t>(second));
+        m_rects.erase(m_rects.begin() + static_cast<std::ptrdiff_t>(first));
+        Insert(merged);
+    }
+}
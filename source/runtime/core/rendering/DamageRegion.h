@@ -0,0 +1,77 @@
+#pragma once
+
+#include <SDL3/SDL.h>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace polaris
+{
+    /**
+     * @brief The parts of the window that changed since the last presented frame.
+     *
+     * Rectangles are clipped to the window and kept disjoint: one that overlaps another, or
+     * would add little area by joining it, is merged into their bounding box. Beyond kMaxRects
+     * the closest pair is merged, so the list stays short no matter how many small changes a
+     * frame makes. Once the damage covers more than the full redraw threshold of the window,
+     * the region is simply full.
+     */
+    class DamageRegion
+    {
+    public:
+        /**
+         * @brief Most rectangles kept before neighbours are merged.
+         */
+        static constexpr std::size_t kMaxRects = 8;
+
+        /**
+         * @brief Sets the window size in pixels. A change of size damages the whole window.
+         */
+        void SetBounds(int width, int height);
+
+        /**
+         * @brief Fraction of the window, in [0, 1], above which the whole window is redrawn.
+         * A single full redraw is cheaper than many large partial ones.
+         */
+        void SetFullThreshold(float threshold) { m_fullThreshold = threshold; }
+
+        /**
+         * @brief Adds a changed rectangle, in window pixels.
+         */
+        void Add(const SDL_Rect& rect);
+
+        /**
+         * @brief Damages the whole window.
+         */
+        void AddAll();
+
+        /**
+         * @brief Forgets all damage, once a frame covering it has been recorded.
+         */
+        void Clear();
+
+        bool IsEmpty() const { return !m_full && m_rects.empty(); }
+        bool IsFull() const { return m_full; }
+
+        /**
+         * @brief The damaged rectangles, disjoint; empty when the region is empty or full.
+         */
+        const std::vector<SDL_Rect>& GetRects() const { return m_rects; }
+
+        /**
+         * @brief Fraction of the window damaged, in [0, 1].
+         */
+        float GetCoverage() const;
+
+    private:
+        void Insert(SDL_Rect rect);
+        void MergeClosestPair();
+
+        std::vector<SDL_Rect> m_rects;
+        std::int64_t m_area = 0;
+        int m_width = 0;
+        int m_height = 0;
+        float m_fullThreshold = 0.5f;
+        bool m_full = false;
+    };
+}
@@ -0,0 +1,430 @@
+#include "GlyphAtlas.h"
+
+#include "memory/MemoryTracker.h"
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+
+namespace polaris
+{
+    namespace
+    {
+        /**
+         * @brief Transparent texels around every glyph, so filtering never picks up a neighbour.
+         */
+        constexpr int kGlyphPadding = 1;
+
+        /**
+         * @brief New shelves are rounded up to this many rows, so glyphs of similar height share them.
+         */
+        constexpr int kShelfGranularity = 4;
+
+        template <typename T>
+        void AppendValue(std::string& out, T value)
+        {
+            char bytes[sizeof(T)];
+            std::memcpy(bytes, &value, sizeof(T));
+            out.append(bytes, sizeof(T));
+        }
+
+        /**
+         * @brief Bounds-checked reader over the file contents.
+         */
+        struct Reader
+        {
+            const char* data;
+            std::size_t size;
+            std::size_t offset;
+
+            template <typename T>
+            bool Read(T& value)
+            {
+                if (size - offset < sizeof(T))
+                {
+                    return false;
+                }
+                std::memcpy(&value, data + offset, sizeof(T));
+                offset += sizeof(T);
+                return true;
+            }
+
+            bool ReadBytes(std::uint8_t* out, std::size_t length)
+            {
+                if (size - offset < length)
+                {
+                    return false;
+                }
+                std::memcpy(out, data + offset, length);
+                offset += length;
+                return true;
+            }
+        };
+
+        /**
+         * @brief Expands coverage to white RGBA texels with the coverage as alpha. Transparent
+         * texels stay white too, so filtering at glyph edges does not darken them.
+         */
+        void ExpandCoverage(const std::uint8_t* coverage, std::size_t count, std::uint8_t* rgba)
+        {
+            for (std::size_t i = 0; i < count; ++i)
+            {
+                rgba[i * 4 + 0] = 255;
+                rgba[i * 4 + 1] = 255;
+                rgba[i * 4 + 2] = 255;
+                rgba[i * 4 + 3] = coverage[i];
+            }
+        }
+    }
+
+    GlyphAtlas::GlyphAtlas(int pageSize, int maxPages)
+        : m_pageSize(std::clamp(pageSize, 64, 4096)),
+          m_maxPages(static_cast<std::size_t>(std::max(maxPages, 1))),
+          m_frame(1),
+          m_epoch(1)
+    {
+    }
+
+    const AtlasGlyph* GlyphAtlas::Find(const GlyphKey& key) const
+    {
+        const auto found = m_glyphs.find(key);
+        return found != m_glyphs.end() ? &found->second : nullptr;
+    }
+
+    /**
+     * @brief Packs the glyph into the first page with room, then into a new page, then into the
+     * least recently used page after evicting it.
+     */
+    const AtlasGlyph* GlyphAtlas::Add(const GlyphKey& key, const std::uint8_t* coverage, int width, int height,
+                                      int pitch, float offsetX, float offsetY, CommandList& commands)
+    {
+        if (width <= 0 || height <= 0 || !coverage)
+        {
+            AtlasGlyph& glyph = m_glyphs[key];
+            glyph = AtlasGlyph();
+            glyph.offsetX = offsetX;
+            glyph.offsetY = offsetY;
+            ++m_stats.glyphsAdded;
+            return &glyph;
+        }
+
+        const int paddedWidth = width + kGlyphPadding * 2;
+        const int paddedHeight = height + kGlyphPadding * 2;
+        if (paddedWidth > m_pageSize || paddedHeight > m_pageSize)
+        {
+            ++m_stats.glyphsDropped;
+            return nullptr;
+        }
+
+        std::size_t pageIndex = m_pages.size();
+        int x = 0;
+        int y = 0;
+        for (std::size_t i = 0; i < m_pages.size(); ++i)
+        {
+            if (Allocate(m_pages[i], paddedWidth, paddedHeight, x, y))
+            {
+                pageIndex = i;
+                break;
+            }
+        }
+
+        if (pageIndex == m_pages.size())
+        {
+            if (m_pages.size() < m_maxPages)
+            {
+                pageIndex = AddPage(commands);
+            }
+            else
+            {
+                std::size_t victim = m_pages.size();
+                for (std::size_t i = 0; i < m_pages.size(); ++i)
+                {
+                    if (m_pages[i].lastUsed != m_frame &&
+                        (victim == m_pages.size() || m_pages[i].lastUsed < m_pages[victim].lastUsed))
+                    {
+                        victim = i;
+                    }
+                }
+                if (victim == m_pages.size())
+                {
+                    ++m_stats.glyphsDropped;
+                    return nullptr;
+                }
+                EvictPage(victim);
+                pageIndex = victim;
+            }
+            // An empty page always has room for a glyph no larger than the page.
+            Allocate(m_pages[pageIndex], paddedWidth, paddedHeight, x, y);
+        }
+
+        Page& page = m_pages[pageIndex];
+        m_upload.resize(static_cast<std::size_t>(paddedWidth) * paddedHeight * 4);
+        for (int row = 0; row < paddedHeight; ++row)
+        {
+            std::uint8_t* pageRow = page.coverage.data() + static_cast<std::size_t>(y + row) * m_pageSize + x;
+            std::fill(pageRow, pageRow + paddedWidth, std::uint8_t(0));
+            if (row >= kGlyphPadding && row < height + kGlyphPadding)
+            {
+                std::memcpy(pageRow + kGlyphPadding, coverage + static_cast<std::size_t>(row - kGlyphPadding) * pitch,
+                            static_cast<std::size_t>(width));
+            }
+            ExpandCoverage(pageRow, static_cast<std::size_t>(paddedWidth),
+                           m_upload.data() + static_cast<std::size_t>(row) * paddedWidth * 4);
+        }
+        const SDL_Rect region = {x, y, paddedWidth, paddedHeight};
+        commands.UpdateTexture(page.texture, &region, m_upload.data(), paddedWidth * 4, paddedHeight);
+        m_stats.bytesUploaded += m_upload.size();
+        page.lastUsed = m_frame;
+
+        AtlasGlyph& glyph = m_glyphs[key];
+        glyph.texture = page.texture;
+        glyph.source = {static_cast<float>(x + kGlyphPadding), static_cast<float>(y + kGlyphPadding),
+                        static_cast<float>(width), static_cast<float>(height)};
+        glyph.offsetX = offsetX;
+        glyph.offsetY = offsetY;
+        glyph.page = static_cast<std::uint16_t>(pageIndex);
+        ++m_stats.glyphsAdded;
+        return &glyph;
+    }
+
+    bool GlyphAtlas::Save(const std::string& path) const
+    {
+        std::string out(kGlyphCacheMagic, sizeof(kGlyphCacheMagic));
+        AppendValue(out, kGlyphCacheVersion);
+        AppendValue(out, static_cast<std::uint16_t>(m_pageSize));
+        AppendValue(out, static_cast<std::uint16_t>(m_pages.size()));
+        AppendValue(out, static_cast<std::uint32_t>(m_glyphs.size()));
+
+        for (const Page& page : m_pages)
+        {
+            AppendValue(out, static_cast<std::uint16_t>(page.usedHeight));
+            AppendValue(out, static_cast<std::uint16_t>(page.shelves.size()));
+            for (const Shelf& shelf : page.shelves)
+            {
+                AppendValue(out, shelf.y);
+                AppendValue(out, shelf.height);
+                AppendValue(out, shelf.x);
+            }
+            out.append(reinterpret_cast<const char*>(page.coverage.data()),
+                       static_cast<std::size_t>(page.usedHeight) * m_pageSize);
+        }
+
+        for (const auto& [key, glyph] : m_glyphs)
+        {
+            AppendValue(out, key.font);
+            AppendValue(out, key.size);
+            AppendValue(out, key.codepoint);
+            AppendValue(out, glyph.page);
+            AppendValue(out, static_cast<std::uint16_t>(glyph.source.x));
+            AppendValue(out, static_cast<std::uint16_t>(glyph.source.y));
+            AppendValue(out, static_cast<std::uint16_t>(glyph.source.w));
+            AppendValue(out, static_cast<std::uint16_t>(glyph.source.h));
+            AppendValue(out, glyph.offsetX);
+            AppendValue(out, glyph.offsetY);
+        }
+
+        std::ofstream file(path, std::ios::binary | std::ios::trunc);
+        file.write(out.data(), static_cast<std::streamsize>(out.size()));
+        return static_cast<bool>(file);
+    }
+
+    /**
+     * @brief Parses and validates the whole file before touching the atlas, then replaces the
+     * pages and uploads the used part of each.
+     */
+    bool GlyphAtlas::Load(const std::string& path, CommandList& commands)
+    {
+        POLARIS_MEMORY_SCOPE(Assets);
+        std::ifstream file(path, std::ios::binary);
+        if (!file.is_open())
+        {
+            return false;
+        }
+        const std::string contents((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+
+        Reader reader{contents.data(), contents.size(), 0};
+        std::uint16_t version;
+        std::uint16_t pageSize;
+        std::uint16_t pageCount;
+        std::uint32_t glyphCount;
+        if (contents.size() < sizeof(kGlyphCacheMagic) ||
+            std::memcmp(contents.data(), kGlyphCacheMagic, sizeof(kGlyphCacheMagic)) != 0)
+        {
+            return false;
+        }
+        reader.offset = sizeof(kGlyphCacheMagic);
+        if (!reader.Read(version) || version != kGlyphCacheVersion || !reader.Read(pageSize) ||
+            pageSize != m_pageSize || !reader.Read(pageCount) || pageCount > m_maxPages || !reader.Read(glyphCount))
+        {
+            return false;
+        }
+
+        std::vector<Page> pages(pageCount);
+        for (Page& page : pages)
+        {
+            std::uint16_t usedHeight;
+            std::uint16_t shelfCount;
+            if (!reader.Read(usedHeight) || usedHeight > m_pageSize || !reader.Read(shelfCount))
+            {
+                return false;
+            }
+            page.usedHeight = usedHeight;
+            page.shelves.resize(shelfCount);
+            for (Shelf& shelf : page.shelves)
+            {
+                if (!reader.Read(shelf.y) || !reader.Read(shelf.height) || !reader.Read(shelf.x) ||
+                    shelf.y + shelf.height > usedHeight || shelf.x > m_pageSize)
+                {
+                    return false;
+                }
+            }
+            page.coverage.assign(static_cast<std::size_t>(m_pageSize) * m_pageSize, 0);
+            if (!reader.ReadBytes(page.coverage.data(), static_cast<std::size_t>(usedHeight) * m_pageSize))
+            {
+                return false;
+            }
+            page.lastUsed = 0;
+        }
+
+        // Check the count against the bytes left before allocating, so a corrupt count fails
+        // here rather than as a huge allocation
+        constexpr std::size_t kGlyphRecordSize = sizeof(GlyphKey::font) + sizeof(GlyphKey::size) +
+                                                 sizeof(GlyphKey::codepoint) + sizeof(AtlasGlyph::page) +
+                                                 4 * sizeof(std::uint16_t) + sizeof(AtlasGlyph::offsetX) +
+                                                 sizeof(AtlasGlyph::offsetY);
+        if (glyphCount > (reader.size - reader.offset) / kGlyphRecordSize)
+        {
+            return false;
+        }
+
+        std::vector<std::pair<GlyphKey, AtlasGlyph>> glyphs(glyphCount);
+        for (auto& [key, glyph] : glyphs)
+        {
+            std::uint16_t x;
+            std::uint16_t y;
+            std::uint16_t width;
+            std::uint16_t height;
+            if (!reader.Read(key.font) || !reader.Read(key.size) || !reader.Read(key.codepoint) ||
+                !reader.Read(glyph.page) || !reader.Read(x) || !reader.Read(y) ||
+                !reader.Read(width) || !reader.Read(height) ||
+                !reader.Read(glyph.offsetX) || !reader.Read(glyph.offsetY))
+            {
+                return false;
+            }
+            if (glyph.page != kNoGlyphPage &&
+                (glyph.page >= pageCount || x + width > m_pageSize || y + height > pages[glyph.page].usedHeight))
+            {
+                return false;
+            }
+            glyph.source = {static_cast<float>(x), static_cast<float>(y),
+                            static_cast<float>(width), static_cast<float>(height)};
+        }
+
+        Clear(commands);
+        m_pages = std::move(pages);
+        for (Page& page : m_pages)
+        {
+            page.texture = commands.CreateTexture(m_pageSize, m_pageSize, TextureAccess::Static);
+            if (page.usedHeight > 0)
+            {
+                const std::size_t texels = static_cast<std::size_t>(page.usedHeight) * m_pageSize;
+                m_upload.resize(texels * 4);
+                ExpandCoverage(page.coverage.data(), texels, m_upload.data());
+                const SDL_Rect region = {0, 0, m_pageSize, page.usedHeight};
+                commands.UpdateTexture(page.texture, &region, m_upload.data(), m_pageSize * 4, page.usedHeight);
+            }
+        }
+        m_glyphs.reserve(glyphs.size());
+        for (auto& [key, glyph] : glyphs)
+        {
+            glyph.texture = glyph.page != kNoGlyphPage ? m_pages[glyph.page].texture : 0;
+            m_glyphs.emplace(key, glyph);
+        }
+        return true;
+    }
+
+    void GlyphAtlas::Clear(CommandList& commands)
+    {
+        for (const Page& page : m_pages)
+        {
+            commands.DestroyTexture(page.texture);
+        }
+        m_pages.clear();
+        m_glyphs.clear();
+        ++m_epoch;
+    }
+
+    GlyphAtlasStats GlyphAtlas::TakeStats()
+    {
+        const GlyphAtlasStats stats = m_stats;
+        m_stats = GlyphAtlasStats();
+        return stats;
+    }
+
+    /**
+     * @brief Best-fit shelf allocation: the lowest shelf tall enough with room left at its end,
+     * as long as it wastes no more than half the glyph's height; otherwise a new shelf below
+     * the last one.
+     */
+    bool GlyphAtlas::Allocate(Page& page, int width, int height, int& x, int& y) const
+    {
+        Shelf* best = nullptr;
+        for (Shelf& shelf : page.shelves)
+        {
+            if (shelf.height >= height && shelf.height <= height + height / 2 && m_pageSize - shelf.x >= width &&
+                (!best || shelf.height < best->height))
+            {
+                best = &shelf;
+            }
+        }
+
+        if (!best)
+        {
+            const int free = m_pageSize - page.usedHeight;
+            if (free < height)
+            {
+                return false;
+            }
+            const int rounded = (height + kShelfGranularity - 1) / kShelfGranularity * kShelfGranularity;
+            const int shelfHeight = std::min(rounded, free);
+            page.shelves.push_back({static_cast<std::uint16_t>(page.usedHeight), static_cast<std::uint16_t>(shelfHeight), 0});
+            page.usedHeight += shelfHeight;
+            best = &page.shelves.back();
+        }
+
+        x = best->x;
+        y = best->y;
+        best->x = static_cast<std::uint16_t>(best->x + width);
+        return true;
+    }
+
+    std::size_t GlyphAtlas::AddPage(CommandList& commands)
+    {
+        POLARIS_MEMORY_SCOPE(Assets);
+        Page page;
+        page.texture = commands.CreateTexture(m_pageSize, m_pageSize, TextureAccess::Static);
+        page.usedHeight = 0;
+        page.lastUsed = m_frame;
+        page.coverage.assign(static_cast<std::size_t>(m_pageSize) * m_pageSize, 0);
+        m_pages.push_back(std::move(page));
+        return m_pages.size() - 1;
+    }
+
+    /**
+     * @brief Forgets the page's glyphs and empties it for reuse. Its texels are left as they
+     * are; new glyphs overwrite everything they sample, padding included.
+     */
+    void GlyphAtlas::EvictPage(std::size_t index)
+    {
+        for (auto it = m_glyphs.begin(); it != m_glyphs.end();)
+        {
+            it = it->second.page == index ? m_glyphs.erase(it) : std::next(it);
+        }
+        Page& page = m_pages[index];
+        page.shelves.clear();
+        page.usedHeight = 0;
+        std::fill(page.coverage.begin(), page.coverage.end(), std::uint8_t(0));
+        ++m_epoch;
+        ++m_stats.pagesEvicted;
+    }
+}
@@ -0,0 +1,199 @@
+#pragma once
+
+#include "CommandList.h"
+#include <SDL3/SDL.h>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace polaris
+{
+    /**
+     * @brief On-disk layout of glyph atlas caches (.pglyph), written by GlyphAtlas::Save.
+     *
+     * A file starts with the magic and a header, followed by the pages and the glyph table:
+     *  - header: u16 version, u16 pageSize, u16 pageCount, u32 glyphCount
+     *  - page:   u16 usedHeight, u16 shelfCount, shelves, usedHeight * pageSize coverage bytes
+     *  - shelf:  u16 y, u16 height, u16 x
+     *  - glyph:  u64 font, u16 size, u32 codepoint, u16 page, u16 x, u16 y, u16 width, u16 height,
+     *            f32 offsetX, f32 offsetY
+     * Pages hold 8-bit coverage; page 0xFFFF marks glyphs without pixels, such as spaces.
+     * All integers are little-endian.
+     */
+    constexpr char kGlyphCacheMagic[4] = {'P', 'G', 'L', 'Y'};
+    constexpr std::uint16_t kGlyphCacheVersion = 1;
+
+    constexpr std::uint16_t kNoGlyphPage = 0xFFFF;
+
+    /**
+     * @brief Identifies a rasterized glyph.
+     */
+    struct GlyphKey
+    {
+        std::uint64_t font = 0;        ///< Hash of the font file's contents, so cached pages survive renames.
+        std::uint16_t size = 0;        ///< Pixel size the glyph was rasterized at.
+        std::uint32_t codepoint = 0;
+
+        bool operator==(const GlyphKey& other) const
+        {
+            return font == other.font && size == other.size && codepoint == other.codepoint;
+        }
+    };
+
+    /**
+     * @brief Where a glyph image lives inside the atlas.
+     */
+    struct AtlasGlyph
+    {
+        TextureHandle texture = 0;                       ///< The page; 0 for glyphs without pixels.
+        SDL_FRect source = {0.0f, 0.0f, 0.0f, 0.0f};     ///< Glyph image in the page, in texels; use as Sprite::source.
+        float offsetX = 0.0f;                            ///< Image position relative to the pen position,
+        float offsetY = 0.0f;                            ///< and to the top of the line.
+        std::uint16_t page = kNoGlyphPage;
+    };
+
+    /**
+     * @brief Atlas activity since the stats were last taken.
+     */
+    struct GlyphAtlasStats
+    {
+        std::uint64_t glyphsAdded = 0;
+        std::uint64_t glyphsDropped = 0;    ///< Glyphs that did not fit without evicting a page used this frame.
+        std::uint64_t pagesEvicted = 0;
+        std::uint64_t bytesUploaded = 0;
+    };
+
+    /**
+     * @brief Dynamic texture atlas of glyph images.
+     *
+     * Glyphs are packed into fixed-size pages on shelves (rows of similar height) and uploaded
+     * as white texels with the glyph's coverage as alpha, so sprites tint them with their
+     * colour. Once maxPages pages are full, the least recently used page is evicted whole: its
+     * glyphs are forgotten and GetEpoch() changes, telling holders of AtlasGlyph copies to look
+     * their glyphs up again. Pages touched in the current frame are never evicted, since sprites
+     * already recorded this frame still sample them.
+     *
+     * The pages and glyph table can be saved to disk and loaded at startup, so text drawn in
+     * earlier runs needs no rasterization.
+     */
+    class GlyphAtlas
+    {
+    public:
+        /**
+         * @param pageSize Width and height of each page in texels, at most 4096.
+         * @param maxPages Number of pages kept before the least recently used is evicted.
+         */
+        explicit GlyphAtlas(int pageSize = 1024, int maxPages = 4);
+
+        /**
+         * @brief Looks a glyph up. The pointer stays valid until the glyph's page is evicted,
+         * that is until GetEpoch() changes.
+         * @return The glyph, or nullptr if it is not in the atlas.
+         */
+        const AtlasGlyph* Find(const GlyphKey& key) const;
+
+        /**
+         * @brief Adds a glyph image and records its upload.
+         * @param key The glyph.
+         * @param coverage 8-bit coverage, width * height values with pitch bytes per row; may be
+         * nullptr if the glyph has no pixels.
+         * @param offsetX Image position relative to the pen position.
+         * @param offsetY Image position relative to the top of the line.
+         * @param commands Command list to record the page creation and upload into.
+         * @return The glyph, or nullptr if it is larger than a page or there is no room left
+         * without evicting a page used this frame.
+         */
+        const AtlasGlyph* Add(const GlyphKey& key, const std::uint8_t* coverage, int width, int height, int pitch,
+                              float offsetX, float offsetY, CommandList& commands);
+
+        /**
+         * @brief Marks a page as used by the current frame, protecting it from eviction.
+         */
+        void Touch(std::uint16_t page)
+        {
+            if (page != kNoGlyphPage)
+            {
+                m_pages[page].lastUsed = m_frame;
+            }
+        }
+
+        /**
+         * @brief Starts a new frame for the LRU bookkeeping.
+         */
+        void BeginFrame() { ++m_frame; }
+
+        /**
+         * @brief Changes whenever glyphs are removed (eviction, Clear, Load).
+         */
+        std::uint32_t GetEpoch() const { return m_epoch; }
+
+        /**
+         * @brief Writes the pages and glyph table to a .pglyph file.
+         * @return false if the file cannot be written.
+         */
+        bool Save(const std::string& path) const;
+
+        /**
+         * @brief Replaces the atlas contents with a .pglyph file written by Save().
+         * @param commands Command list to record the page uploads into.
+         * @return false if the file cannot be read, is not a supported .pglyph file or does not
+         * match this atlas's page size and page limit; the atlas is then left unchanged.
+         */
+        bool Load(const std::string& path, CommandList& commands);
+
+        /**
+         * @brief Records the destruction of every page and forgets all glyphs.
+         */
+        void Clear(CommandList& commands);
+
+        std::size_t GetGlyphCount() const { return m_glyphs.size(); }
+        std::size_t GetPageCount() const { return m_pages.size(); }
+        int GetPageSize() const { return m_pageSize; }
+
+        /**
+         * @brief Returns the counters accumulated since the last call and resets them.
+         */
+        GlyphAtlasStats TakeStats();
+
+    private:
+        struct Shelf
+        {
+            std::uint16_t y;
+            std::uint16_t height;
+            std::uint16_t x;         ///< Start of the free space at the end of the shelf.
+        };
+
+        struct Page
+        {
+            TextureHandle texture;
+            std::vector<Shelf> shelves;
+            int usedHeight;          ///< Rows taken by shelves.
+            std::uint64_t lastUsed;  ///< Frame the page was last touched in.
+            std::vector<std::uint8_t> coverage;   ///< CPU copy of the page, for Save().
+        };
+
+        struct KeyHash
+        {
+            std::size_t operator()(const GlyphKey& key) const
+            {
+                const std::uint64_t hash = key.font ^ ((static_cast<std::uint64_t>(key.size) << 32) | key.codepoint);
+                return static_cast<std::size_t>((hash * 0x9E3779B97F4A7C15ull) >> 16);
+            }
+        };
+
+        bool Allocate(Page& page, int width, int height, int& x, int& y) const;
+        std::size_t AddPage(CommandList& commands);
+        void EvictPage(std::size_t index);
+
+        int m_pageSize;
+        std::size_t m_maxPages;
+        std::vector<Page> m_pages;
+        std::unordered_map<GlyphKey, AtlasGlyph, KeyHash> m_glyphs;
+        std::vector<std::uint8_t> m_upload;   ///< RGBA staging for glyph uploads.
+        std::uint64_t m_frame;
+        std::uint32_t m_epoch;
+        GlyphAtlasStats m_stats;
+    };
+}
@@ -11,23 +11,29 @@ PlatformRenderer* PlatformRenderer::_instance = nullptr;
  * @brief Constructs a PlatformRenderer object.
  */
 PlatformRenderer::PlatformRenderer() {
-
+    if (!_instance) {
+        _instance = this;
+    }
 }
 
 /**
- * @brief Destroys the PlatformRenderer object.
+ * @brief Destroys the PlatformRenderer object and clears the singleton if it was this one.
  */
 PlatformRenderer::~PlatformRenderer() {
+    if (_instance == this) {
+        _instance = nullptr;
+    }
 }
 
 /**
- * @brief Renders a single frame.
+ * @brief Renders a single frame by executing a recorded command list.
+ * @param commands The frame's commands.
  *
  * This is a placeholder implementation for the base class. Subclasses should override this
  * to provide actual rendering logic.
  */
-void PlatformRenderer::RenderFrame() {
-
+void PlatformRenderer::RenderFrame(const polaris::CommandList& commands) {
+    (void)commands;
 }
 
 /**
@@ -38,10 +44,34 @@ void PlatformRenderer::RenderFrame() {
  * to initialize and create the platform-specific renderer.
  */
 void PlatformRenderer::CreateRenderer(SDL_Window *window) {
-    _instance = new PlatformRenderer();
+    (void)window;
 }
 
+/**
+ * @brief Enables or disables vsync.
+ * @param enabled true to enable vsync.
+ * @return false when vsync is requested, since the base class presents nothing; true otherwise.
+ */
+bool PlatformRenderer::SetVSync(bool enabled) {
+    return !enabled;
+}
 
+/**
+ * @brief Returns the counters of the last executed frame.
+ */
+polaris::RenderStats PlatformRenderer::GetStats() const {
+    std::lock_guard<std::mutex> lock(m_statsMutex);
+    return m_stats;
+}
+
+/**
+ * @brief Publishes the counters of a finished frame for GetStats().
+ * @param stats The frame's counters.
+ */
+void PlatformRenderer::PublishStats(const polaris::RenderStats& stats) {
+    std::lock_guard<std::mutex> lock(m_statsMutex);
+    m_stats = stats;
+}
 
 /**
  * @brief Gets the singleton instance of the PlatformRenderer.
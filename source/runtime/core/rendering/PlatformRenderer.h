@@ -5,6 +5,21 @@
 #ifndef PLATFORMRENDERING_H
 #define PLATFORMRENDERING_H
 #include <SDL3/SDL.h>
+#include "CommandList.h"
+#include <cstdint>
+#include <mutex>
+
+namespace polaris {
+    /**
+     * @brief Counters for the last frame a renderer executed.
+     */
+    struct RenderStats {
+        std::uint32_t drawCalls = 0;   ///< Draw calls issued to the underlying API.
+        std::uint32_t sprites = 0;     ///< Sprites drawn through the sprite batch.
+        std::uint32_t vertices = 0;    ///< Vertices submitted, including those of DrawGeometry.
+        std::uint32_t flushes = 0;     ///< Times the sprite batch was drained.
+    };
+}
 
 /**
  * @brief Abstract base class for platform-specific rendering.
@@ -26,12 +41,13 @@ class PlatformRenderer {
     virtual ~PlatformRenderer();
 
     /**
-     * @brief Renders a single frame.
+     * @brief Renders a single frame by executing a recorded command list.
+     * @param commands The frame's commands, normally ending with Present.
      *
-     * This pure virtual function must be implemented by subclasses to perform the actual rendering
-     * operations for a frame.
+     * Called on the render thread (or the main thread in synchronous mode). Subclasses must
+     * implement this to translate the commands into their rendering API.
      */
-    virtual void RenderFrame();
+    virtual void RenderFrame(const polaris::CommandList& commands);
 
     /**
      * @brief Creates the renderer for the given window.
@@ -42,18 +58,50 @@ class PlatformRenderer {
      */
     virtual void CreateRenderer(SDL_Window* window);
 
+    /**
+     * @brief Enables or disables waiting for the display refresh on present.
+     * @param enabled true to enable vsync.
+     * @return true if the requested mode is in effect. The base implementation has no
+     *         presentation and reports vsync as unsupported.
+     */
+    virtual bool SetVSync(bool enabled);
+
     /**
      * @brief Gets the singleton instance of the PlatformRenderer.
-     * @return A pointer to the singleton PlatformRenderer instance.
+     * @return The first renderer constructed and not yet destroyed, or null. Not owning.
      */
     static PlatformRenderer* getInstance();
 
+    /**
+     * @brief Allocator of the texture handles used by command lists recorded for this renderer.
+     */
+    polaris::TextureHandlePool& GetTextureHandles() { return m_textureHandles; }
+
+    /**
+     * @brief Returns the counters of the last executed frame. Safe to call from any thread.
+     */
+    polaris::RenderStats GetStats() const;
+
 protected:
     /**
-     * @brief The singleton instance of the PlatformRenderer.
+     * @brief Publishes the counters of a finished frame for GetStats().
+     */
+    void PublishStats(const polaris::RenderStats& stats);
+
+    /**
+     * @brief Texture handles; subclasses release a handle after executing its DestroyTexture command.
+     */
+    polaris::TextureHandlePool m_textureHandles;
+
+    /**
+     * @brief The singleton instance of the PlatformRenderer; set by the constructor, cleared by
+     * the destructor. The engine owns the renderer.
      */
     static PlatformRenderer* _instance;
 
+private:
+    mutable std::mutex m_statsMutex;
+    polaris::RenderStats m_stats;
 };
 
 #endif //PLATFORMRENDERING_H
@@ -0,0 +1,160 @@
+// Built with AVX2 and FMA enabled (see CMakeLists.txt) and only called once the CPU has been
+// checked for them, so keep standard headers out: their inline functions would be compiled
+// with AVX2 too and could end up shared with the rest of the program.
+#include "RasterKernels.h"
+
+#if (defined(__AVX2__) && defined(__FMA__)) || (defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86)))
+#define POLARIS_RASTER_AVX2 1
+#include <immintrin.h>
+#else
+#define POLARIS_RASTER_AVX2 0
+#endif
+
+namespace polaris
+{
+#if POLARIS_RASTER_AVX2
+
+    namespace
+    {
+        struct Pixels8
+        {
+            __m256 r, g, b, a;
+        };
+
+        /**
+         * @brief Splits eight RGBA32 pixels into 0-255 float channels.
+         */
+        inline Pixels8 Unpack(__m256i pixels)
+        {
+            const __m256i mask = _mm256_set1_epi32(0xFF);
+            return {_mm256_cvtepi32_ps(_mm256_and_si256(pixels, mask)),
+                    _mm256_cvtepi32_ps(_mm256_and_si256(_mm256_srli_epi32(pixels, 8), mask)),
+                    _mm256_cvtepi32_ps(_mm256_and_si256(_mm256_srli_epi32(pixels, 16), mask)),
+                    _mm256_cvtepi32_ps(_mm256_srli_epi32(pixels, 24))};
+        }
+
+        inline __m256i PackChannel(__m256 channel)
+        {
+            const __m256 clamped = _mm256_min_ps(_mm256_max_ps(channel, _mm256_setzero_ps()), _mm256_set1_ps(255.0f));
+            return _mm256_cvttps_epi32(_mm256_add_ps(clamped, _mm256_set1_ps(0.5f)));
+        }
+
+        inline __m256i Pack(const Pixels8& pixels)
+        {
+            return _mm256_or_si256(_mm256_or_si256(PackChannel(pixels.r), _mm256_slli_epi32(PackChannel(pixels.g), 8)),
+                                   _mm256_or_si256(_mm256_slli_epi32(PackChannel(pixels.b), 16),
+                                                   _mm256_slli_epi32(PackChannel(pixels.a), 24)));
+        }
+
+        /**
+         * @brief Eight pixels at a time: colours and texel coordinates are stepped from the span
+         * start, texels fetched with one gather, and the blend done in float.
+         */
+        template <int Blend>
+        void ShadeSpanAVX2(std::uint32_t* pixels, int count, const RasterSpan& span)
+        {
+            const __m256 lane = _mm256_setr_ps(0.0f, 1.0f, 2.0f, 3.0f, 4.0f, 5.0f, 6.0f, 7.0f);
+            const __m256 toUnit = _mm256_set1_ps(1.0f / 255.0f);
+            const __m256 full = _mm256_set1_ps(255.0f);
+            const __m256 one = _mm256_set1_ps(1.0f);
+            const __m256 maxU = _mm256_set1_ps(static_cast<float>(span.textureWidth - 1));
+            const __m256 maxV = _mm256_set1_ps(static_cast<float>(span.textureHeight - 1));
+            const __m256i pitch = _mm256_set1_epi32(span.texturePitch);
+            const int* texels = reinterpret_cast<const int*>(span.texels);
+
+            int i = 0;
+            for (; i + 8 <= count; i += 8)
+            {
+                const __m256 step = _mm256_add_ps(_mm256_set1_ps(static_cast<float>(i)), lane);
+                Pixels8 source = {_mm256_fmadd_ps(_mm256_set1_ps(span.dr), step, _mm256_set1_ps(span.r)),
+                                  _mm256_fmadd_ps(_mm256_set1_ps(span.dg), step, _mm256_set1_ps(span.g)),
+                                  _mm256_fmadd_ps(_mm256_set1_ps(span.db), step, _mm256_set1_ps(span.b)),
+                                  _mm256_fmadd_ps(_mm256_set1_ps(span.da), step, _mm256_set1_ps(span.a))};
+                if (texels)
+                {
+                    __m256 u = _mm256_fmadd_ps(_mm256_set1_ps(span.du), step, _mm256_set1_ps(span.u));
+                    __m256 v = _mm256_fmadd_ps(_mm256_set1_ps(span.dv), step, _mm256_set1_ps(span.v));
+                    u = _mm256_min_ps(_mm256_max_ps(u, _mm256_setzero_ps()), maxU);
+                    v = _mm256_min_ps(_mm256_max_ps(v, _mm256_setzero_ps()), maxV);
+                    const __m256i offsets = _mm256_add_epi32(_mm256_mullo_epi32(_mm256_cvttps_epi32(v), pitch),
+                                                             _mm256_cvttps_epi32(u));
+                    const Pixels8 texel = Unpack(_mm256_i32gather_epi32(texels, offsets, 4));
+                    source.r = _mm256_mul_ps(source.r, _mm256_mul_ps(texel.r, toUnit));
+                    source.g = _mm256_mul_ps(source.g, _mm256_mul_ps(texel.g, toUnit));
+                    source.b = _mm256_mul_ps(source.b, _mm256_mul_ps(texel.b, toUnit));
+                    source.a = _mm256_mul_ps(source.a, _mm256_mul_ps(texel.a, toUnit));
+                }
+
+                __m256i* target = reinterpret_cast<__m256i*>(pixels + i);
+                Pixels8 out;
+                if (Blend == 3)
+                {
+                    out = {_mm256_mul_ps(source.r, full), _mm256_mul_ps(source.g, full), _mm256_mul_ps(source.b, full),
+                           _mm256_mul_ps(source.a, full)};
+                }
+                else
+                {
+                    const Pixels8 destination = Unpack(_mm256_loadu_si256(target));
+                    if (Blend == 1)
+                    {
+                        const __m256 scale = _mm256_mul_ps(source.a, full);
+                        out = {_mm256_fmadd_ps(source.r, scale, destination.r), _mm256_fmadd_ps(source.g, scale, destination.g),
+                               _mm256_fmadd_ps(source.b, scale, destination.b), destination.a};
+                    }
+                    else if (Blend == 2)
+                    {
+                        const __m256 keep = _mm256_sub_ps(one, source.a);
+                        out = {_mm256_mul_ps(destination.r, _mm256_add_ps(source.r, keep)),
+                               _mm256_mul_ps(destination.g, _mm256_add_ps(source.g, keep)),
+                               _mm256_mul_ps(destination.b, _mm256_add_ps(source.b, keep)), destination.a};
+                    }
+                    else
+                    {
+                        const __m256 scale = _mm256_mul_ps(source.a, full);
+                        const __m256 keep = _mm256_sub_ps(one, source.a);
+                        out = {_mm256_fmadd_ps(source.r, scale, _mm256_mul_ps(destination.r, keep)),
+                               _mm256_fmadd_ps(source.g, scale, _mm256_mul_ps(destination.g, keep)),
+                               _mm256_fmadd_ps(source.b, scale, _mm256_mul_ps(destination.b, keep)),
+                               _mm256_fmadd_ps(destination.a, keep, scale)};
+                    }
+                }
+                _mm256_storeu_si256(target, Pack(out));
+            }
+            ShadeSpanScalar(Blend, pixels, i, count, span);
+            _mm256_zeroupper();
+        }
+
+        void FillAVX2(std::uint32_t* pixels, int count, std::uint32_t color)
+        {
+            const __m256i value = _mm256_set1_epi32(static_cast<int>(color));
+            int i = 0;
+            for (; i + 8 <= count; i += 8)
+            {
+                _mm256_storeu_si256(reinterpret_cast<__m256i*>(pixels + i), value);
+            }
+            for (; i < count; ++i)
+            {
+                pixels[i] = color;
+            }
+            _mm256_zeroupper();
+        }
+
+        const RasterKernels g_avx2Kernels = {
+            {ShadeSpanAVX2<0>, ShadeSpanAVX2<1>, ShadeSpanAVX2<2>, ShadeSpanAVX2<3>}, FillAVX2
+        };
+    }
+
+    const RasterKernels* GetAVX2RasterKernels()
+    {
+        return &g_avx2Kernels;
+    }
+
+#else
+
+    const RasterKernels* GetAVX2RasterKernels()
+    {
+        return nullptr;
+    }
+
+#endif
+}
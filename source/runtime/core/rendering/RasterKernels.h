@@ -0,0 +1,128 @@
+#pragma once
+
+// Internal to the software renderer: the per-instruction-set span functions behind
+// SoftwareRenderer, which picks the widest table math::getSimdLevel() allows. RasterAVX2.cpp
+// includes it, so it must not define non-static inline functions (see math/BatchKernels.h).
+
+#include <cstdint>
+
+namespace polaris
+{
+    /**
+     * @brief One horizontal run of pixels of a primitive: its colour and texel coordinates at
+     * the first pixel's centre and how they change per pixel to the right.
+     *
+     * Pixels are RGBA32 (R in the low byte). The colour is the vertex colour in 0-1, multiplied
+     * with the texel when there is a texture. Textures are sampled nearest-neighbour with
+     * coordinates clamped to the edge.
+     */
+    struct RasterSpan
+    {
+        float r, g, b, a;
+        float dr, dg, db, da;
+        float u, v;               ///< In texels.
+        float du, dv;
+        const std::uint32_t* texels;   ///< RGBA32 texture, or null to draw the colour alone.
+        int textureWidth;
+        int textureHeight;
+        int texturePitch;         ///< In texels.
+    };
+
+    using ShadeSpanFunction = void (*)(std::uint32_t* pixels, int count, const RasterSpan& span);
+
+    /**
+     * @brief One instruction set's span functions.
+     */
+    struct RasterKernels
+    {
+        /**
+         * @brief Shades count pixels and composites them onto the target, indexed by BlendMode
+         * (Blend, Add, Multiply, None), with SDL's blend equations.
+         */
+        ShadeSpanFunction shade[4];
+        /**
+         * @brief Overwrites count pixels with one packed colour.
+         */
+        void (*fill)(std::uint32_t* pixels, int count, std::uint32_t color);
+    };
+
+    /**
+     * @brief Kernel tables; the SIMD ones return null when this build does not target their
+     * instruction set.
+     */
+    const RasterKernels* GetScalarRasterKernels();
+    const RasterKernels* GetSSE2RasterKernels();
+    const RasterKernels* GetAVX2RasterKernels();
+
+    /**
+     * @brief Scalar code for pixels [begin, end) of a span, for the pixels left over after the
+     * last full vector. blend is a BlendMode value.
+     */
+    static inline void ShadeSpanScalar(int blend, std::uint32_t* pixels, int begin, int end, const RasterSpan& span)
+    {
+        constexpr float kToUnit = 1.0f / 255.0f;
+        for (int i = begin; i < end; ++i)
+        {
+            const float step = static_cast<float>(i);
+            float r = span.r + span.dr * step;
+            float g = span.g + span.dg * step;
+            float b = span.b + span.db * step;
+            float a = span.a + span.da * step;
+            if (span.texels)
+            {
+                float u = span.u + span.du * step;
+                float v = span.v + span.dv * step;
+                const float maxU = static_cast<float>(span.textureWidth - 1);
+                const float maxV = static_cast<float>(span.textureHeight - 1);
+                u = u < 0.0f ? 0.0f : (u > maxU ? maxU : u);
+                v = v < 0.0f ? 0.0f : (v > maxV ? maxV : v);
+                const std::uint32_t texel = span.texels[static_cast<int>(v) * span.texturePitch + static_cast<int>(u)];
+                r *= static_cast<float>(texel & 0xFF) * kToUnit;
+                g *= static_cast<float>((texel >> 8) & 0xFF) * kToUnit;
+                b *= static_cast<float>((texel >> 16) & 0xFF) * kToUnit;
+                a *= static_cast<float>(texel >> 24) * kToUnit;
+            }
+
+            // Destination channels stay in 0-255, so the source is scaled by 255 as it is blended
+            const std::uint32_t destination = pixels[i];
+            const float dr = static_cast<float>(destination & 0xFF);
+            const float dg = static_cast<float>((destination >> 8) & 0xFF);
+            const float db = static_cast<float>((destination >> 16) & 0xFF);
+            const float da = static_cast<float>(destination >> 24);
+            float outR, outG, outB, outA;
+            switch (blend)
+            {
+                case 1: // Add
+                    outR = r * a * 255.0f + dr;
+                    outG = g * a * 255.0f + dg;
+                    outB = b * a * 255.0f + db;
+                    outA = da;
+                    break;
+                case 2: // Multiply
+                    outR = dr * (r + 1.0f - a);
+                    outG = dg * (g + 1.0f - a);
+                    outB = db * (b + 1.0f - a);
+                    outA = da;
+                    break;
+                case 3: // None
+                    outR = r * 255.0f;
+                    outG = g * 255.0f;
+                    outB = b * 255.0f;
+                    outA = a * 255.0f;
+                    break;
+                default: // Blend
+                    outR = r * a * 255.0f + dr * (1.0f - a);
+                    outG = g * a * 255.0f + dg * (1.0f - a);
+                    outB = b * a * 255.0f + db * (1.0f - a);
+                    outA = a * 255.0f + da * (1.0f - a);
+                    break;
+            }
+
+            const auto pack = [](float channel) {
+                channel = channel < 0.0f ? 0.0f : (channel > 255.0f ? 255.0f : channel);
+                return static_cast<std::uint32_t>(channel + 0.5f);
+            };
+            pixels[i] = pack(outR) | (pack(outG) << 8) | (pack(outB) << 16) | (pack(outA) << 24);
+        }
+    }
+}
@@ -0,0 +1,161 @@
+#include "RasterKernels.h"
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define POLARIS_RASTER_SSE2 1
+#include <emmintrin.h>
+#else
+#define POLARIS_RASTER_SSE2 0
+#endif
+
+namespace polaris
+{
+#if POLARIS_RASTER_SSE2
+
+    namespace
+    {
+        struct Pixels4
+        {
+            __m128 r, g, b, a;
+        };
+
+        /**
+         * @brief Splits four RGBA32 pixels into 0-255 float channels.
+         */
+        inline Pixels4 Unpack(__m128i pixels)
+        {
+            const __m128i mask = _mm_set1_epi32(0xFF);
+            return {_mm_cvtepi32_ps(_mm_and_si128(pixels, mask)),
+                    _mm_cvtepi32_ps(_mm_and_si128(_mm_srli_epi32(pixels, 8), mask)),
+                    _mm_cvtepi32_ps(_mm_and_si128(_mm_srli_epi32(pixels, 16), mask)),
+                    _mm_cvtepi32_ps(_mm_srli_epi32(pixels, 24))};
+        }
+
+        inline __m128i PackChannel(__m128 channel)
+        {
+            const __m128 clamped = _mm_min_ps(_mm_max_ps(channel, _mm_setzero_ps()), _mm_set1_ps(255.0f));
+            return _mm_cvttps_epi32(_mm_add_ps(clamped, _mm_set1_ps(0.5f)));
+        }
+
+        inline __m128i Pack(const Pixels4& pixels)
+        {
+            return _mm_or_si128(_mm_or_si128(PackChannel(pixels.r), _mm_slli_epi32(PackChannel(pixels.g), 8)),
+                                _mm_or_si128(_mm_slli_epi32(PackChannel(pixels.b), 16),
+                                             _mm_slli_epi32(PackChannel(pixels.a), 24)));
+        }
+
+        /**
+         * @brief Four pixels at a time. SSE2 has no gather, so the texel addresses are computed
+         * in vectors and the texels loaded one by one.
+         */
+        template <int Blend>
+        void ShadeSpanSSE2(std::uint32_t* pixels, int count, const RasterSpan& span)
+        {
+            const __m128 lane = _mm_setr_ps(0.0f, 1.0f, 2.0f, 3.0f);
+            const __m128 toUnit = _mm_set1_ps(1.0f / 255.0f);
+            const __m128 full = _mm_set1_ps(255.0f);
+            const __m128 one = _mm_set1_ps(1.0f);
+            const __m128 maxU = _mm_set1_ps(static_cast<float>(span.textureWidth - 1));
+            const __m128 maxV = _mm_set1_ps(static_cast<float>(span.textureHeight - 1));
+
+            int i = 0;
+            for (; i + 4 <= count; i += 4)
+            {
+                const __m128 step = _mm_add_ps(_mm_set1_ps(static_cast<float>(i)), lane);
+                Pixels4 source = {_mm_add_ps(_mm_mul_ps(_mm_set1_ps(span.dr), step), _mm_set1_ps(span.r)),
+                                  _mm_add_ps(_mm_mul_ps(_mm_set1_ps(span.dg), step), _mm_set1_ps(span.g)),
+                                  _mm_add_ps(_mm_mul_ps(_mm_set1_ps(span.db), step), _mm_set1_ps(span.b)),
+                                  _mm_add_ps(_mm_mul_ps(_mm_set1_ps(span.da), step), _mm_set1_ps(span.a))};
+                if (span.texels)
+                {
+                    __m128 u = _mm_add_ps(_mm_mul_ps(_mm_set1_ps(span.du), step), _mm_set1_ps(span.u));
+                    __m128 v = _mm_add_ps(_mm_mul_ps(_mm_set1_ps(span.dv), step), _mm_set1_ps(span.v));
+                    u = _mm_min_ps(_mm_max_ps(u, _mm_setzero_ps()), maxU);
+                    v = _mm_min_ps(_mm_max_ps(v, _mm_setzero_ps()), maxV);
+                    alignas(16) int x[4];
+                    alignas(16) int y[4];
+                    _mm_store_si128(reinterpret_cast<__m128i*>(x), _mm_cvttps_epi32(u));
+                    _mm_store_si128(reinterpret_cast<__m128i*>(y), _mm_cvttps_epi32(v));
+                    const std::uint32_t* texels = span.texels;
+                    const int pitch = span.texturePitch;
+                    const Pixels4 texel = Unpack(_mm_setr_epi32(static_cast<int>(texels[y[0] * pitch + x[0]]),
+                                                                static_cast<int>(texels[y[1] * pitch + x[1]]),
+                                                                static_cast<int>(texels[y[2] * pitch + x[2]]),
+                                                                static_cast<int>(texels[y[3] * pitch + x[3]])));
+                    source.r = _mm_mul_ps(source.r, _mm_mul_ps(texel.r, toUnit));
+                    source.g = _mm_mul_ps(source.g, _mm_mul_ps(texel.g, toUnit));
+                    source.b = _mm_mul_ps(source.b, _mm_mul_ps(texel.b, toUnit));
+                    source.a = _mm_mul_ps(source.a, _mm_mul_ps(texel.a, toUnit));
+                }
+
+                __m128i* target = reinterpret_cast<__m128i*>(pixels + i);
+                Pixels4 out;
+                if (Blend == 3)
+                {
+                    out = {_mm_mul_ps(source.r, full), _mm_mul_ps(source.g, full), _mm_mul_ps(source.b, full),
+                           _mm_mul_ps(source.a, full)};
+                }
+                else
+                {
+                    const Pixels4 destination = Unpack(_mm_loadu_si128(target));
+                    if (Blend == 1)
+                    {
+                        const __m128 scale = _mm_mul_ps(source.a, full);
+                        out = {_mm_add_ps(_mm_mul_ps(source.r, scale), destination.r),
+                               _mm_add_ps(_mm_mul_ps(source.g, scale), destination.g),
+                               _mm_add_ps(_mm_mul_ps(source.b, scale), destination.b), destination.a};
+                    }
+                    else if (Blend == 2)
+                    {
+                        const __m128 keep = _mm_sub_ps(one, source.a);
+                        out = {_mm_mul_ps(destination.r, _mm_add_ps(source.r, keep)),
+                               _mm_mul_ps(destination.g, _mm_add_ps(source.g, keep)),
+                               _mm_mul_ps(destination.b, _mm_add_ps(source.b, keep)), destination.a};
+                    }
+                    else
+                    {
+                        const __m128 scale = _mm_mul_ps(source.a, full);
+                        const __m128 keep = _mm_sub_ps(one, source.a);
+                        out = {_mm_add_ps(_mm_mul_ps(source.r, scale), _mm_mul_ps(destination.r, keep)),
+                               _mm_add_ps(_mm_mul_ps(source.g, scale), _mm_mul_ps(destination.g, keep)),
+                               _mm_add_ps(_mm_mul_ps(source.b, scale), _mm_mul_ps(destination.b, keep)),
+                               _mm_add_ps(_mm_mul_ps(destination.a, keep), scale)};
+                    }
+                }
+                _mm_storeu_si128(target, Pack(out));
+            }
+            ShadeSpanScalar(Blend, pixels, i, count, span);
+        }
+
+        void FillSSE2(std::uint32_t* pixels, int count, std::uint32_t color)
+        {
+            const __m128i value = _mm_set1_epi32(static_cast<int>(color));
+            int i = 0;
+            for (; i + 4 <= count; i += 4)
+            {
+                _mm_storeu_si128(reinterpret_cast<__m128i*>(pixels + i), value);
+            }
+            for (; i < count; ++i)
+            {
+                pixels[i] = color;
+            }
+        }
+
+        const RasterKernels g_sse2Kernels = {
+            {ShadeSpanSSE2<0>, ShadeSpanSSE2<1>, ShadeSpanSSE2<2>, ShadeSpanSSE2<3>}, FillSSE2
+        };
+    }
+
+    const RasterKernels* GetSSE2RasterKernels()
+    {
+        return &g_sse2Kernels;
+    }
+
+#else
+
+    const RasterKernels* GetSSE2RasterKernels()
+    {
+        return nullptr;
+    }
+
+#endif
+}
@@ -0,0 +1,249 @@
+#include "RenderThread.h"
+
+#include "Logger.h"
+#include "memory/MemoryTracker.h"
+#include "profiling/Profiler.h"
+#include <algorithm>
+#include <stdexcept>
+
+namespace polaris
+{
+    /**
+     * @brief Constructs a stopped RenderThread.
+     */
+    RenderThread::RenderThread()
+        : m_renderer(nullptr),
+          m_submitted(0),
+          m_executed(0),
+          m_recording(false),
+          m_stopping(false),
+          m_task(nullptr) {
+    }
+
+    /**
+     * @brief Stops the render thread if it is still running.
+     */
+    RenderThread::~RenderThread()
+    {
+        Stop();
+    }
+
+    /**
+     * @brief Starts executing frames for a renderer.
+     * @param renderer The renderer. Not owned; must outlive Stop().
+     * @param threaded true to start a render thread, false for synchronous execution.
+     * @param framesInFlight How many submitted frames may be pending while the next is recorded.
+     * @throws std::logic_error if already started.
+     */
+    void RenderThread::Start(PlatformRenderer* renderer, bool threaded, int framesInFlight)
+    {
+        if (m_renderer)
+        {
+            throw std::logic_error("RenderThread already started");
+        }
+
+        m_renderer = renderer;
+        m_submitted = 0;
+        m_executed = 0;
+        m_recording = false;
+        m_stopping = false;
+
+        const int listCount = std::max(1, framesInFlight) + 1;
+        m_lists.clear();
+        for (int i = 0; i < listCount; ++i)
+        {
+            m_lists.emplace_back(new CommandList(&m_renderer->GetTextureHandles()));
+        }
+
+        if (threaded)
+        {
+            m_thread = std::thread(&RenderThread::ThreadMain, this);
+            LOG_INFO("Render thread started ({} frames in flight)", listCount - 1);
+        }
+        else
+        {
+            LOG_INFO("Rendering synchronously on the main thread");
+        }
+    }
+
+    /**
+     * @brief Executes all submitted frames and joins the render thread.
+     */
+    void RenderThread::Stop()
+    {
+        if (!m_renderer)
+        {
+            return;
+        }
+
+        if (m_thread.joinable())
+        {
+            {
+                std::lock_guard<std::mutex> lock(m_mutex);
+                m_stopping = true;
+            }
+            m_frameSubmitted.notify_one();
+            m_thread.join();
+        }
+
+        std::vector<std::unique_ptr<CommandList>>().swap(m_lists);
+        m_renderer = nullptr;
+    }
+
+    /**
+     * @brief Returns the command list for the next frame, waiting for one to become free.
+     * @throws std::logic_error if not started or the previous frame was not submitted.
+     */
+    CommandList& RenderThread::BeginFrame()
+    {
+        if (!m_renderer || m_recording)
+        {
+            throw std::logic_error("RenderThread::BeginFrame called out of order");
+        }
+
+        {
+            POLARIS_PROFILE_SCOPE("RenderThread::waitForFreeList");
+            std::unique_lock<std::mutex> lock(m_mutex);
+            m_frameExecuted.wait(lock, [this]() {
+                return m_submitted - m_executed < m_lists.size();
+            });
+        }
+
+        m_recording = true;
+        CommandList& commands = *m_lists[m_submitted % m_lists.size()];
+        commands.Reset();
+        return commands;
+    }
+
+    /**
+     * @brief Queues the list returned by BeginFrame() for execution.
+     */
+    void RenderThread::SubmitFrame()
+    {
+        if (!m_recording)
+        {
+            throw std::logic_error("RenderThread::SubmitFrame called without BeginFrame");
+        }
+        m_recording = false;
+
+        if (!m_thread.joinable())
+        {
+            Execute(*m_lists[m_submitted % m_lists.size()]);
+            ++m_submitted;
+            ++m_executed;
+            return;
+        }
+
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            ++m_submitted;
+        }
+        m_frameSubmitted.notify_one();
+    }
+
+    /**
+     * @brief Runs a task on the render thread and waits for it.
+     * @throws Whatever the task threw.
+     */
+    void RenderThread::Invoke(const std::function<void()>& task)
+    {
+        if (!m_thread.joinable())
+        {
+            task();
+            return;
+        }
+
+        std::unique_lock<std::mutex> lock(m_mutex);
+        m_frameExecuted.wait(lock, [this]() { return m_task == nullptr; });
+        m_task = &task;
+        m_taskError = nullptr;
+        m_frameSubmitted.notify_one();
+        m_frameExecuted.wait(lock, [this, &task]() { return m_task != &task; });
+
+        if (m_taskError)
+        {
+            std::exception_ptr error = m_taskError;
+            m_taskError = nullptr;
+            lock.unlock();
+            std::rethrow_exception(error);
+        }
+    }
+
+    /**
+     * @brief Waits until every submitted frame has been executed.
+     */
+    void RenderThread::WaitIdle()
+    {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        m_frameExecuted.wait(lock, [this]() { return m_executed == m_submitted; });
+    }
+
+    /**
+     * @brief Executes one command list on the renderer.
+     */
+    void RenderThread::Execute(CommandList& commands)
+    {
+        POLARIS_PROFILE_SCOPE("RenderThread::execute");
+        m_renderer->RenderFrame(commands);
+    }
+
+    /**
+     * @brief Render thread loop: run tasks and submitted frames in order until stopped.
+     */
+    void RenderThread::ThreadMain()
+    {
+        POLARIS_PROFILE_THREAD("Render");
+        POLARIS_MEMORY_THREAD_TAG(Renderer);
+
+        std::unique_lock<std::mutex> lock(m_mutex);
+        for (;;)
+        {
+            m_frameSubmitted.wait(lock, [this]() {
+                return m_task != nullptr || m_executed != m_submitted || m_stopping;
+            });
+
+            if (m_task)
+            {
+                const std::function<void()>* task = m_task;
+                lock.unlock();
+                std::exception_ptr error;
+                try
+                {
+                    (*task)();
+                }
+                catch (...)
+                {
+                    error = std::current_exception();
+                }
+                lock.lock();
+                m_taskError = error;
+                m_task = nullptr;
+                m_frameExecuted.notify_all();
+                continue;
+            }
+
+            if (m_executed != m_submitted)
+            {
+                CommandList& commands = *m_lists[m_executed % m_lists.size()];
+                lock.unlock();
+                try
+                {
+                    Execute(commands);
+                }
+                catch (const std::exception& e)
+                {
+                    LOG_ERROR("Render thread: frame failed: {}", e.what());
+                }
+                lock.lock();
+                ++m_executed;
+                m_frameExecuted.notify_all();
+                continue;
+            }
+
+            if (m_stopping)
+            {
+                break;
+            }
+        }
+    }
+}
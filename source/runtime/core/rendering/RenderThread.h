@@ -0,0 +1,110 @@
+#pragma once
+
+#include "CommandList.h"
+#include "PlatformRenderer.h"
+#include <condition_variable>
+#include <cstdint>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace polaris
+{
+    /**
+     * @brief Whether this platform lets a renderer live on a thread other than the main thread.
+     * Apple platforms and Android expect presentation from the main (UI) thread, so they use the
+     * synchronous fallback.
+     */
+#if defined(__APPLE__) || defined(__ANDROID__)
+    constexpr bool kRenderThreadSupported = false;
+#else
+    constexpr bool kRenderThreadSupported = true;
+#endif
+
+    /**
+     * @brief Runs a PlatformRenderer on a dedicated thread, fed with double-buffered command lists.
+     *
+     * The game thread calls BeginFrame() to get the command list for frame N, records into it and
+     * hands it over with SubmitFrame(), while the render thread executes frame N-1. There are
+     * framesInFlight + 1 command lists: BeginFrame() blocks while all of them are still queued or
+     * executing, which bounds how far the game thread can run ahead of the display, so a frame
+     * costs max(simulation, rendering) instead of their sum.
+     *
+     * In synchronous mode no thread is started and SubmitFrame() executes the list immediately on
+     * the calling thread; callers do not need to know which mode is active.
+     *
+     * Every call into the renderer, including its creation and destruction, goes through this
+     * class, so the renderer is only ever touched by one thread.
+     */
+    class RenderThread
+    {
+    public:
+        RenderThread();
+        ~RenderThread();
+
+        RenderThread(const RenderThread&) = delete;
+        RenderThread& operator=(const RenderThread&) = delete;
+
+        /**
+         * @brief Starts executing frames for a renderer.
+         * @param renderer The renderer. Not owned; must outlive Stop().
+         * @param threaded true to start a render thread, false for synchronous execution.
+         * @param framesInFlight How many submitted frames may be pending while the next is recorded.
+         */
+        void Start(PlatformRenderer* renderer, bool threaded, int framesInFlight = 1);
+
+        /**
+         * @brief Executes all submitted frames and joins the render thread.
+         */
+        void Stop();
+
+        /**
+         * @brief True if frames execute on a separate thread.
+         */
+        bool IsThreaded() const { return m_thread.joinable(); }
+
+        /**
+         * @brief Returns the command list for the next frame, waiting for one to become free.
+         * The list is reset and starts empty.
+         */
+        CommandList& BeginFrame();
+
+        /**
+         * @brief Queues the list returned by BeginFrame() for execution.
+         */
+        void SubmitFrame();
+
+        /**
+         * @brief Runs a task on the render thread (or inline in synchronous mode) and waits for it.
+         * Exceptions thrown by the task are rethrown on the calling thread.
+         */
+        void Invoke(const std::function<void()>& task);
+
+        /**
+         * @brief Waits until every submitted frame has been executed.
+         */
+        void WaitIdle();
+
+    private:
+        void ThreadMain();
+        void Execute(CommandList& commands);
+
+        PlatformRenderer* m_renderer;
+        std::vector<std::unique_ptr<CommandList>> m_lists;
+        std::thread m_thread;
+
+        std::mutex m_mutex;
+        std::condition_variable m_frameSubmitted;
+        std::condition_variable m_frameExecuted;
+        std::uint64_t m_submitted;
+        std::uint64_t m_executed;
+        bool m_recording;
+        bool m_stopping;
+
+        const std::function<void()>* m_task;
+        std::exception_ptr m_taskError;
+    };
+}
@@ -1,6 +1,8 @@
 #include "SDLRenderer.h"
 
 #include "PlatformRenderer.h"
+#include "Logger.h"
+#include "profiling/Profiler.h"
 #include <stdexcept>
 
 namespace polaris
@@ -14,7 +16,9 @@ namespace polaris
     /**
      * @brief Constructs an SDLRenderer object.
      */
-    SDLRenderer::SDLRenderer(): m_pSdlRenderer(nullptr) {
+    SDLRenderer::SDLRenderer(): m_pSdlRenderer(nullptr), m_pBackbuffer(nullptr), m_backbufferWidth(0),
+          m_backbufferHeight(0), m_damageBounds{0, 0, 0, 0}, m_clipToDamage(false), m_useBackbuffer(false),
+          m_windowBound(true) {
 
     }
 
@@ -23,8 +27,21 @@ namespace polaris
      */
     SDLRenderer::~SDLRenderer()
     {
-        SDL_DestroyRenderer(m_pSdlRenderer);
-        SDL_Quit();
+        for (const SpriteBatch::Texture& texture : m_textures)
+        {
+            if (texture.texture)
+            {
+                SDL_DestroyTexture(texture.texture);
+            }
+        }
+        if (m_pBackbuffer)
+        {
+            SDL_DestroyTexture(m_pBackbuffer);
+        }
+        if (m_pSdlRenderer)
+        {
+            SDL_DestroyRenderer(m_pSdlRenderer);
+        }
     }
 
     /**
@@ -38,18 +55,259 @@ namespace polaris
         {
             throw std::runtime_error("Failed to create SDL3 renderer");
         }
+        SDL_SetRenderDrawBlendMode(m_pSdlRenderer, SDL_BLENDMODE_BLEND);
+    }
+
+
+    /**
+     * @brief Enables or disables vsync on the SDL renderer.
+     * @param enabled true to enable vsync.
+     * @return true if SDL accepted the setting.
+     */
+    bool SDLRenderer::SetVSync(bool enabled) {
+        if (m_pSdlRenderer == nullptr) {
+            return false;
+        }
+        return SDL_SetRenderVSync(m_pSdlRenderer, enabled ? 1 : 0);
     }
 
+    SDL_Texture* SDLRenderer::GetTexture(TextureHandle handle) const
+    {
+        return handle < m_textures.size() ? m_textures[handle].texture : nullptr;
+    }
 
     /**
-     * @brief Renders a single frame using SDL.
+     * @brief Recreates the backbuffer when the window size changed, which forces a full redraw,
+     * and otherwise clips window drawing to the bounding box of the damage. SDL has a single
+     * clip rectangle, and replaying the frame once per damaged rectangle would cost more than
+     * the pixels it saves, so the box is used even when the damage is several rectangles.
+     */
+    void SDLRenderer::BeginDamage(const CommandList& commands)
+    {
+        m_useBackbuffer = false;
+        m_clipToDamage = false;
+        if (commands.TracksDamage())
+        {
+            int width = 0;
+            int height = 0;
+            SDL_GetRenderOutputSize(m_pSdlRenderer, &width, &height);
+            bool recreated = false;
+            if (!m_pBackbuffer || width != m_backbufferWidth || height != m_backbufferHeight)
+            {
+                if (m_pBackbuffer)
+                {
+                    SDL_DestroyTexture(m_pBackbuffer);
+                }
+                m_pBackbuffer = SDL_CreateTexture(m_pSdlRenderer, SDL_PIXELFORMAT_RGBA32, SDL_TEXTUREACCESS_TARGET,
+                                                  width, height);
+                m_backbufferWidth = width;
+                m_backbufferHeight = height;
+                recreated = true;
+                if (m_pBackbuffer)
+                {
+                    SDL_SetTextureBlendMode(m_pBackbuffer, SDL_BLENDMODE_NONE);
+                }
+                else
+                {
+                    LOG_ERROR("Failed to create {}x{} backbuffer, redrawing the whole window: {}", width, height,
+                              SDL_GetError());
+                }
+            }
+
+            const std::vector<SDL_Rect>& damage = commands.GetDamage();
+            m_useBackbuffer = m_pBackbuffer != nullptr;
+            if (m_useBackbuffer && !recreated && !damage.empty())
+            {
+                m_damageBounds = damage[0];
+                for (const SDL_Rect& rect : damage)
+                {
+                    SDL_GetRectUnion(&m_damageBounds, &rect, &m_damageBounds);
+                }
+                m_clipToDamage = true;
+            }
+        }
+        BindWindow();
+    }
+
+    void SDLRenderer::BindWindow()
+    {
+        SDL_SetRenderTarget(m_pSdlRenderer, m_useBackbuffer ? m_pBackbuffer : nullptr);
+        SDL_SetRenderClipRect(m_pSdlRenderer, m_clipToDamage ? &m_damageBounds : nullptr);
+        m_windowBound = true;
+    }
+
+    /**
+     * @brief Renders a single frame by executing a command list with the SDL renderer.
      *
-     * This method clears the renderer with a red color, and then presents the renderer.
+     * Sprites are queued in the sprite batch, which is flushed before any other command so
+     * that sprites still appear in order relative to clears, target switches and geometry.
+     * When the list tracks damage, window drawing goes to the backbuffer, clipped to the
+     * damage, and the backbuffer is copied to the window at Present.
+     * @param commands The frame's commands.
      */
-    void SDLRenderer::RenderFrame()
+    void SDLRenderer::RenderFrame(const CommandList& commands)
     {
-        SDL_SetRenderDrawColor(m_pSdlRenderer, 255, 0, 0, 255);
-        SDL_RenderClear(m_pSdlRenderer);
-        SDL_RenderPresent(m_pSdlRenderer);
+        POLARIS_PROFILE_SCOPE("SDLRenderer::RenderFrame");
+        const std::vector<Sprite>& sprites = commands.GetSprites();
+        const std::vector<SDL_Vertex>& vertices = commands.GetVertices();
+        const std::vector<int>& indices = commands.GetIndices();
+        RenderStats stats;
+        BeginDamage(commands);
+
+        for (const RenderCommand& command : commands.GetCommands())
+        {
+            if (command.type == RenderCommandType::DrawSprites)
+            {
+                m_spriteBatch.Add(sprites.data() + command.first, command.count);
+                continue;
+            }
+            m_spriteBatch.Flush(m_pSdlRenderer, m_textures, stats);
+
+            switch (command.type)
+            {
+                case RenderCommandType::Clear:
+                    SDL_SetRenderDrawColorFloat(m_pSdlRenderer, command.color.r, command.color.g, command.color.b, command.color.a);
+                    if (m_windowBound && m_clipToDamage)
+                    {
+                        // SDL_RenderClear ignores the clip rectangle
+                        const SDL_FRect area = {static_cast<float>(m_damageBounds.x), static_cast<float>(m_damageBounds.y),
+                                                static_cast<float>(m_damageBounds.w), static_cast<float>(m_damageBounds.h)};
+                        SDL_SetRenderDrawBlendMode(m_pSdlRenderer, SDL_BLENDMODE_NONE);
+                        SDL_RenderFillRect(m_pSdlRenderer, &area);
+                        SDL_SetRenderDrawBlendMode(m_pSdlRenderer, SDL_BLENDMODE_BLEND);
+                    }
+                    else
+                    {
+                        SDL_RenderClear(m_pSdlRenderer);
+                    }
+                    ++stats.drawCalls;
+                    break;
+
+                case RenderCommandType::DrawGeometry:
+                    SDL_RenderGeometry(m_pSdlRenderer, GetTexture(command.texture),
+                                       vertices.data() + command.first, static_cast<int>(command.count),
+                                       command.indexCount ? indices.data() + command.firstIndex : nullptr,
+                                       static_cast<int>(command.indexCount));
+                    ++stats.drawCalls;
+                    stats.vertices += command.count;
+                    break;
+
+                case RenderCommandType::SetTarget:
+                    if (SDL_Texture* target = GetTexture(command.texture))
+                    {
+                        SDL_SetRenderTarget(m_pSdlRenderer, target);
+                        m_windowBound = false;
+                    }
+                    else
+                    {
+                        BindWindow();
+                    }
+                    break;
+
+                case RenderCommandType::Present:
+                    if (m_useBackbuffer)
+                    {
+                        SDL_SetRenderTarget(m_pSdlRenderer, nullptr);
+                        SDL_RenderTexture(m_pSdlRenderer, m_pBackbuffer, nullptr, nullptr);
+                        ++stats.drawCalls;
+                        SDL_RenderPresent(m_pSdlRenderer);
+                        BindWindow();
+                    }
+                    else
+                    {
+                        SDL_RenderPresent(m_pSdlRenderer);
+                    }
+                    break;
+
+                case RenderCommandType::CreateTexture:
+                {
+                    static const SDL_TextureAccess kAccess[] = {
+                        SDL_TEXTUREACCESS_STATIC, SDL_TEXTUREACCESS_STREAMING, SDL_TEXTUREACCESS_TARGET
+                    };
+                    static const SDL_PixelFormat kFormat[] = {
+                        SDL_PIXELFORMAT_RGBA32, SDL_PIXELFORMAT_IYUV, SDL_PIXELFORMAT_NV12
+                    };
+                    static const SDL_Colorspace kColorspace[] = {
+                        SDL_COLORSPACE_BT601_LIMITED, SDL_COLORSPACE_BT601_FULL,
+                        SDL_COLORSPACE_BT709_LIMITED, SDL_COLORSPACE_BT709_FULL
+                    };
+                    const SDL_PropertiesID properties = SDL_CreateProperties();
+                    SDL_SetNumberProperty(properties, SDL_PROP_TEXTURE_CREATE_FORMAT_NUMBER, kFormat[static_cast<int>(command.format)]);
+                    SDL_SetNumberProperty(properties, SDL_PROP_TEXTURE_CREATE_ACCESS_NUMBER, kAccess[static_cast<int>(command.access)]);
+                    SDL_SetNumberProperty(properties, SDL_PROP_TEXTURE_CREATE_WIDTH_NUMBER, command.width);
+                    SDL_SetNumberProperty(properties, SDL_PROP_TEXTURE_CREATE_HEIGHT_NUMBER, command.height);
+                    if (command.format != TextureFormat::RGBA8)
+                    {
+                        // SDL would otherwise treat YUV textures as full range BT.601 (JPEG)
+                        SDL_SetNumberProperty(properties, SDL_PROP_TEXTURE_CREATE_COLORSPACE_NUMBER,
+                                              kColorspace[static_cast<int>(command.colorspace)]);
+                    }
+                    SDL_Texture* texture = SDL_CreateTextureWithProperties(m_pSdlRenderer, properties);
+                    SDL_DestroyProperties(properties);
+                    if (!texture)
+                    {
+                        LOG_ERROR("Failed to create {}x{} texture: {}", command.width, command.height, SDL_GetError());
+                        break;
+                    }
+                    SDL_SetTextureBlendMode(texture, SDL_BLENDMODE_BLEND);
+                    if (command.count > 0)
+                    {
+                        SDL_UpdateTexture(texture, nullptr, commands.GetPayload(command.first), command.width * 4);
+                    }
+                    if (command.texture >= m_textures.size())
+                    {
+                        m_textures.resize(command.texture + 1);
+                    }
+                    m_textures[command.texture] = {texture, static_cast<float>(command.width), static_cast<float>(command.height)};
+                    break;
+                }
+
+                case RenderCommandType::UpdateTexture:
+                    if (SDL_Texture* texture = GetTexture(command.texture))
+                    {
+                        SDL_UpdateTexture(texture, command.hasRegion ? &command.region : nullptr,
+                                          commands.GetPayload(command.first), command.pitch);
+                    }
+                    break;
+
+                case RenderCommandType::UpdateTextureYUV:
+                    if (SDL_Texture* texture = GetTexture(command.texture))
+                    {
+                        const int width = command.region.w;
+                        const int height = command.region.h;
+                        const int chromaPitch = (width + 1) / 2;
+                        const Uint8* y = commands.GetPayload(command.first);
+                        const Uint8* u = y + static_cast<std::size_t>(width) * height;
+                        const Uint8* v = u + static_cast<std::size_t>(chromaPitch) * ((height + 1) / 2);
+                        SDL_UpdateYUVTexture(texture, &command.region, y, width, u, chromaPitch, v, chromaPitch);
+                    }
+                    break;
+
+                case RenderCommandType::UpdateTextureNV:
+                    if (SDL_Texture* texture = GetTexture(command.texture))
+                    {
+                        const int width = command.region.w;
+                        const Uint8* y = commands.GetPayload(command.first);
+                        const Uint8* uv = y + static_cast<std::size_t>(width) * command.region.h;
+                        SDL_UpdateNVTexture(texture, &command.region, y, width, uv, (width + 1) / 2 * 2);
+                    }
+                    break;
+
+                case RenderCommandType::DestroyTexture:
+                    if (SDL_Texture* texture = GetTexture(command.texture))
+                    {
+                        SDL_DestroyTexture(texture);
+                        m_textures[command.texture] = SpriteBatch::Texture();
+                    }
+                    m_textureHandles.Release(command.texture);
+                    break;
+
+                case RenderCommandType::DrawSprites:
+                    break;
+            }
+        }
+
+        m_spriteBatch.Flush(m_pSdlRenderer, m_textures, stats);
+        PublishStats(stats);
     }
 }
\ No newline at end of file
@@ -1,7 +1,9 @@
 #pragma once
 
 #include "PlatformRenderer.h"
+#include "SpriteBatch.h"
 #include <SDL3/SDL.h>
+#include <vector>
 
 namespace polaris
 {
@@ -29,14 +31,64 @@ namespace polaris
          */
         void CreateRenderer(SDL_Window* window) override;
         /**
-         * @brief Renders a single frame using SDL.
+         * @brief Renders a single frame by executing a command list with the SDL renderer.
+         * @param commands The frame's commands.
          */
-        void RenderFrame() override;
+        void RenderFrame(const CommandList& commands) override;
+        /**
+         * @brief Enables or disables vsync on the SDL renderer.
+         * @param enabled true to enable vsync.
+         * @return true if SDL accepted the setting.
+         */
+        bool SetVSync(bool enabled) override;
 
     private:
+        /**
+         * @brief Looks up the SDL texture for a handle; nullptr for 0 or unknown handles.
+         */
+        SDL_Texture* GetTexture(TextureHandle handle) const;
+
+        /**
+         * @brief Chooses where window drawing goes this frame: the backbuffer texture, clipped
+         * to the damage, when the command list tracks damage, otherwise the window itself.
+         */
+        void BeginDamage(const CommandList& commands);
+
+        /**
+         * @brief Binds the window, or the backbuffer standing in for it, as the render target.
+         */
+        void BindWindow();
+
         /**
          * @brief Pointer to the SDL_Renderer instance.
          */
         SDL_Renderer* m_pSdlRenderer;
+        /**
+         * @brief Copy of the last frame that window drawing goes to while damage is tracked.
+         * Swapchain contents are undefined after a present, so partial redraws need a target
+         * that keeps its pixels; the whole texture is copied to the window at Present.
+         */
+        SDL_Texture* m_pBackbuffer;
+        int m_backbufferWidth;
+        int m_backbufferHeight;
+        /**
+         * @brief Bounding box of the frame's damage, and whether drawing is clipped to it.
+         */
+        SDL_Rect m_damageBounds;
+        bool m_clipToDamage;
+        /**
+         * @brief Whether the backbuffer stands in for the window this frame, and whether the
+         * window (or the backbuffer) is the current target.
+         */
+        bool m_useBackbuffer;
+        bool m_windowBound;
+        /**
+         * @brief SDL textures and their sizes, indexed by TextureHandle.
+         */
+        std::vector<SpriteBatch::Texture> m_textures;
+        /**
+         * @brief Batches the sprites of each frame into SDL_RenderGeometry calls.
+         */
+        SpriteBatch m_spriteBatch;
     };
 }
\ No newline at end of file
@@ -0,0 +1,861 @@
+#include "SoftwareRenderer.h"
+
+#include "RasterKernels.h"
+#include "Logger.h"
+#include "jobs/JobSystem.h"
+#include "math/Batch.h"
+#include "profiling/Profiler.h"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <stdexcept>
+#include <utility>
+
+namespace polaris
+{
+    namespace
+    {
+        /**
+         * @brief Largest texture edge accepted, as a guard against corrupt sizes.
+         */
+        constexpr int kMaxTextureSize = 16384;
+
+        /**
+         * @brief Triangles reaching further than this many pixels from the origin are not drawn;
+         * it keeps the fixed-point edge functions well within 64 bits.
+         */
+        constexpr float kMaxCoordinate = 1.0e6f;
+
+        template <int Blend>
+        void ShadeSpanPortable(std::uint32_t* pixels, int count, const RasterSpan& span)
+        {
+            ShadeSpanScalar(Blend, pixels, 0, count, span);
+        }
+
+        void FillPortable(std::uint32_t* pixels, int count, std::uint32_t color)
+        {
+            std::fill_n(pixels, count, color);
+        }
+
+        const RasterKernels g_scalarKernels = {
+            {ShadeSpanPortable<0>, ShadeSpanPortable<1>, ShadeSpanPortable<2>, ShadeSpanPortable<3>}, FillPortable
+        };
+
+        /**
+         * @brief The widest kernels allowed by math::getSimdLevel(), which has checked the CPU.
+         */
+        const RasterKernels* SelectKernels()
+        {
+            switch (math::getSimdLevel())
+            {
+                case math::SimdLevel::AVX2:
+                    if (const RasterKernels* kernels = GetAVX2RasterKernels())
+                    {
+                        return kernels;
+                    }
+                    [[fallthrough]];
+                case math::SimdLevel::SSE2:
+                    if (const RasterKernels* kernels = GetSSE2RasterKernels())
+                    {
+                        return kernels;
+                    }
+                    [[fallthrough]];
+                default:
+                    return GetScalarRasterKernels();
+            }
+        }
+
+        std::uint32_t PackColor(const SDL_FColor& color)
+        {
+            const auto channel = [](float value) {
+                value = value < 0.0f ? 0.0f : (value > 1.0f ? 1.0f : value);
+                return static_cast<std::uint32_t>(value * 255.0f + 0.5f);
+            };
+            return channel(color.r) | (channel(color.g) << 8) | (channel(color.b) << 16) | (channel(color.a) << 24);
+        }
+
+        bool SameColor(const SDL_FColor& a, const SDL_FColor& b)
+        {
+            return a.r == b.r && a.g == b.g && a.b == b.b && a.a == b.a;
+        }
+
+        /**
+         * @brief Whether an untextured primitive of this colour and blend mode simply replaces
+         * the pixels it covers.
+         */
+        bool IsSolid(const SDL_FColor& color, BlendMode blend)
+        {
+            return blend == BlendMode::None || (blend == BlendMode::Blend && color.a >= 1.0f);
+        }
+
+        /**
+         * @brief First pixel whose centre is at or right of (below) an edge, clamped to [0, limit].
+         */
+        int FirstPixel(float edge, int limit)
+        {
+            const float first = std::ceil(edge - 0.5f);
+            return first <= 0.0f ? 0 : (first >= static_cast<float>(limit) ? limit : static_cast<int>(first));
+        }
+
+        std::int64_t CeilDiv(std::int64_t numerator, std::int64_t denominator)
+        {
+            return numerator >= 0 ? (numerator + denominator - 1) / denominator : -((-numerator) / denominator);
+        }
+
+        std::int64_t FloorDiv(std::int64_t numerator, std::int64_t denominator)
+        {
+            return numerator >= 0 ? numerator / denominator : -((-numerator + denominator - 1) / denominator);
+        }
+    }
+
+    const RasterKernels* GetScalarRasterKernels()
+    {
+        return &g_scalarKernels;
+    }
+
+    SoftwareRenderer::SoftwareRenderer(const SoftwareRendererConfig& config)
+        : m_config(config), m_window(nullptr), m_framebuffer(nullptr), m_kernels(GetScalarRasterKernels()),
+          m_targetHandle(0), m_tilesX(0), m_tilesY(0)
+    {
+        m_config.tileSize = std::max(m_config.tileSize, 8);
+    }
+
+    SoftwareRenderer::~SoftwareRenderer()
+    {
+        if (m_framebuffer)
+        {
+            SDL_DestroySurface(m_framebuffer);
+        }
+    }
+
+    /**
+     * @brief Creates the framebuffer for a window, or an offscreen one without.
+     * @throws std::runtime_error if the framebuffer cannot be created.
+     */
+    void SoftwareRenderer::CreateRenderer(SDL_Window* window)
+    {
+        m_window = window;
+        int width = m_config.width;
+        int height = m_config.height;
+        if (window && !SDL_GetWindowSizeInPixels(window, &width, &height))
+        {
+            throw std::runtime_error("Failed to get window size: " + std::string(SDL_GetError()));
+        }
+        Resize(width, height);
+        BindTarget(0);
+
+        m_kernels = SelectKernels();
+        LOG_INFO("Software renderer {}x{}, {} px tiles, {} kernels", width, height, m_config.tileSize,
+                 math::getSimdLevelName(math::getSimdLevel()));
+    }
+
+    void SoftwareRenderer::Resize(int width, int height)
+    {
+        SDL_Surface* framebuffer = SDL_CreateSurface(std::max(width, 1), std::max(height, 1), SDL_PIXELFORMAT_RGBA32);
+        if (!framebuffer)
+        {
+            throw std::runtime_error("Failed to create framebuffer: " + std::string(SDL_GetError()));
+        }
+        SDL_SetSurfaceBlendMode(framebuffer, SDL_BLENDMODE_NONE);
+        if (m_framebuffer)
+        {
+            SDL_DestroySurface(m_framebuffer);
+        }
+        m_framebuffer = framebuffer;
+    }
+
+    SoftwareRenderer::Texture* SoftwareRenderer::GetTexture(TextureHandle handle)
+    {
+        return handle != 0 && handle < m_textures.size() && !m_textures[handle].pixels.empty() ? &m_textures[handle]
+                                                                                                : nullptr;
+    }
+
+    /**
+     * @brief Draws into a target texture from now on, or into the framebuffer for 0 or a
+     * handle that is not a texture. Nothing may be binned.
+     */
+    void SoftwareRenderer::BindTarget(TextureHandle handle)
+    {
+        if (Texture* texture = GetTexture(handle))
+        {
+            m_target = {texture->pixels.data(), texture->width, texture->height, texture->width};
+            m_targetHandle = handle;
+        }
+        else
+        {
+            m_target = {static_cast<std::uint32_t*>(m_framebuffer->pixels), m_framebuffer->w, m_framebuffer->h,
+                        m_framebuffer->pitch / 4};
+            m_targetHandle = 0;
+        }
+
+        const int tileSize = m_config.tileSize;
+        m_tilesX = (m_target.width + tileSize - 1) / tileSize;
+        m_tilesY = (m_target.height + tileSize - 1) / tileSize;
+        m_bins.resize(static_cast<std::size_t>(m_tilesX) * m_tilesY);
+    }
+
+    /**
+     * @brief Executes a command list. Draws are binned as they come; everything else first
+     * rasterizes what is binned, so it sees the pixels as they would be at that point.
+     */
+    void SoftwareRenderer::RenderFrame(const CommandList& commands)
+    {
+        if (!m_framebuffer)
+        {
+            return;
+        }
+        POLARIS_PROFILE_SCOPE("SoftwareRenderer::RenderFrame");
+        m_kernels = SelectKernels();
+
+        // Follow the window size; the framebuffer is only ever replaced between frames, and a
+        // new one has to be drawn in full
+        m_damage.clear();
+        bool resized = false;
+        if (m_window)
+        {
+            int width = 0;
+            int height = 0;
+            if (SDL_GetWindowSizeInPixels(m_window, &width, &height) && width > 0 && height > 0 &&
+                (width != m_framebuffer->w || height != m_framebuffer->h))
+            {
+                Resize(width, height);
+                BindTarget(m_targetHandle);
+                resized = true;
+            }
+        }
+        if (commands.TracksDamage() && !resized)
+        {
+            m_damage = commands.GetDamage();
+        }
+
+        const std::vector<SDL_Vertex>& vertices = commands.GetVertices();
+        const std::vector<int>& indices = commands.GetIndices();
+        const std::vector<Sprite>& sprites = commands.GetSprites();
+        RenderStats stats;
+
+        for (const RenderCommand& command : commands.GetCommands())
+        {
+            if (command.type == RenderCommandType::DrawSprites)
+            {
+                m_spriteBatch.Add(sprites.data() + command.first, command.count);
+                continue;
+            }
+            BinSprites(stats);
+
+            switch (command.type)
+            {
+                case RenderCommandType::Clear:
+                    BinClear(command.color);
+                    ++stats.drawCalls;
+                    break;
+
+                case RenderCommandType::DrawGeometry:
+                {
+                    const Texture* texture = GetTexture(command.texture);
+                    const SDL_Vertex* first = vertices.data() + command.first;
+                    const std::uint32_t count = command.indexCount ? command.indexCount : command.count;
+                    for (std::uint32_t i = 0; i + 2 < count; i += 3)
+                    {
+                        if (command.indexCount == 0)
+                        {
+                            BinTriangle(first[i], first[i + 1], first[i + 2], texture, BlendMode::Blend);
+                            continue;
+                        }
+                        const int* triangle = indices.data() + command.firstIndex + i;
+                        if (std::all_of(triangle, triangle + 3, [&command](int index) {
+                                return index >= 0 && static_cast<std::uint32_t>(index) < command.count;
+                            }))
+                        {
+                            BinTriangle(first[triangle[0]], first[triangle[1]], first[triangle[2]], texture,
+                                        BlendMode::Blend);
+                        }
+                    }
+                    ++stats.drawCalls;
+                    stats.vertices += command.count;
+                    break;
+                }
+
+                case RenderCommandType::SetTarget:
+                    Flush();
+                    BindTarget(command.texture);
+                    break;
+
+                case RenderCommandType::Present:
+                    Flush();
+                    PresentToWindow();
+                    break;
+
+                case RenderCommandType::CreateTexture:
+                {
+                    Flush();
+                    if (command.width <= 0 || command.height <= 0 || command.width > kMaxTextureSize ||
+                        command.height > kMaxTextureSize)
+                    {
+                        LOG_ERROR("Failed to create {}x{} texture: unsupported size", command.width, command.height);
+                        break;
+                    }
+                    if (command.texture >= m_textures.size())
+                    {
+                        m_textures.resize(command.texture + 1);
+                        m_textureSizes.resize(command.texture + 1);
+                    }
+
+                    // YUV textures start out black, like freshly created SDL ones
+                    Texture& texture = m_textures[command.texture];
+                    texture.width = command.width;
+                    texture.height = command.height;
+                    texture.colorspace = command.colorspace;
+                    texture.pixels.assign(static_cast<std::size_t>(command.width) * command.height,
+                                          command.format == TextureFormat::RGBA8 ? 0u : 0xFF000000u);
+                    if (command.count > 0)
+                    {
+                        std::memcpy(texture.pixels.data(), commands.GetPayload(command.first),
+                                    std::min<std::size_t>(command.count, texture.pixels.size() * 4));
+                    }
+                    m_textureSizes[command.texture] = {nullptr, static_cast<float>(command.width),
+                                                       static_cast<float>(command.height)};
+                    break;
+                }
+
+                case RenderCommandType::UpdateTexture:
+                {
+                    Flush();
+                    Texture* texture = GetTexture(command.texture);
+                    if (!texture || command.pitch <= 0)
+                    {
+                        break;
+                    }
+                    SDL_Rect region = {0, 0, texture->width, texture->height};
+                    if (command.hasRegion)
+                    {
+                        region = command.region;
+                    }
+                    const int rows = std::min(region.h, static_cast<int>(command.count / command.pitch));
+                    const int columns = std::min(region.w, command.pitch / 4);
+                    const std::uint8_t* payload = commands.GetPayload(command.first);
+                    for (int row = 0; row < rows; ++row)
+                    {
+                        const int y = region.y + row;
+                        const int begin = std::max(region.x, 0);
+                        const int end = std::min(region.x + columns, texture->width);
+                        if (y < 0 || y >= texture->height || begin >= end)
+                        {
+                            continue;
+                        }
+                        std::memcpy(&texture->pixels[static_cast<std::size_t>(y) * texture->width + begin],
+                                    payload + static_cast<std::size_t>(row) * command.pitch + (begin - region.x) * 4,
+                                    static_cast<std::size_t>(end - begin) * 4);
+                    }
+                    break;
+                }
+
+                case RenderCommandType::UpdateTextureYUV:
+                case RenderCommandType::UpdateTextureNV:
+                {
+                    Flush();
+                    Texture* texture = GetTexture(command.texture);
+                    if (!texture)
+                    {
+                        break;
+                    }
+                    if (command.region.w > texture->width || command.region.h > texture->height)
+                    {
+                        LOG_ERROR("Failed to update texture {}: {}x{} YUV upload is larger than the texture",
+                                  command.texture, command.region.w, command.region.h);
+                        break;
+                    }
+                    commands.DecodeYUV(command, texture->colorspace, texture->pixels.data(), texture->width);
+                    break;
+                }
+
+                case RenderCommandType::DestroyTexture:
+                    Flush();
+                    if (command.texture < m_textures.size())
+                    {
+                        std::vector<std::uint32_t>().swap(m_textures[command.texture].pixels);
+                        m_textureSizes[command.texture] = SpriteBatch::Texture();
+                        if (command.texture == m_targetHandle)
+                        {
+                            BindTarget(0);
+                        }
+                    }
+                    m_textureHandles.Release(command.texture);
+                    break;
+
+                case RenderCommandType::DrawSprites:
+                    break;
+            }
+        }
+
+        BinSprites(stats);
+        Flush();
+        PublishStats(stats);
+    }
+
+    /**
+     * @brief Bins the queued sprites in the sprite batch's draw order: unrotated ones as
+     * rectangles, the others as two triangles. Counts a draw call per run of sprites sharing a
+     * texture and blend mode, as the SDL renderer would issue.
+     */
+    void SoftwareRenderer::BinSprites(RenderStats& stats)
+    {
+        const std::vector<const Sprite*>& sprites = m_spriteBatch.Prepare(m_textureSizes);
+        if (sprites.empty())
+        {
+            return;
+        }
+
+        POLARIS_PROFILE_SCOPE("SoftwareRenderer::BinSprites");
+        const std::vector<SDL_Vertex>& vertices = m_spriteBatch.GetVertices();
+        for (std::size_t i = 0; i < sprites.size(); ++i)
+        {
+            const Sprite& sprite = *sprites[i];
+            if (i == 0 || sprite.texture != sprites[i - 1]->texture || sprite.blend != sprites[i - 1]->blend)
+            {
+                ++stats.drawCalls;
+            }
+
+            const SDL_Vertex* corners = vertices.data() + i * 4;
+            const Texture* texture = GetTexture(sprite.texture);
+            if (corners[0].position.y == corners[1].position.y && corners[1].position.x == corners[2].position.x &&
+                corners[2].position.y == corners[3].position.y && corners[3].position.x == corners[0].position.x)
+            {
+                BinRectangle(corners, texture, sprite.blend);
+            }
+            else
+            {
+                BinTriangle(corners[0], corners[1], corners[2], texture, sprite.blend);
+                BinTriangle(corners[2], corners[3], corners[0], texture, sprite.blend);
+            }
+        }
+
+        stats.sprites += static_cast<std::uint32_t>(sprites.size());
+        stats.vertices += static_cast<std::uint32_t>(sprites.size() * 4);
+        ++stats.flushes;
+    }
+
+    /**
+     * @brief A clear overwrites everything binned so far, so it replaces the bins' contents.
+     */
+    void SoftwareRenderer::BinClear(const SDL_FColor& color)
+    {
+        m_primitives.clear();
+        m_edges.clear();
+        m_activeTiles.clear();
+        for (std::size_t tile = 0; tile < m_bins.size(); ++tile)
+        {
+            m_bins[tile].assign(1, 0);
+            m_activeTiles.push_back(static_cast<std::uint32_t>(tile));
+        }
+
+        Primitive primitive = {};
+        primitive.type = PrimitiveType::Rectangle;
+        primitive.blend = BlendMode::None;
+        primitive.solid = true;
+        primitive.color = PackColor(color);
+        primitive.maxX = m_target.width;
+        primitive.maxY = m_target.height;
+        m_primitives.push_back(primitive);
+    }
+
+    /**
+     * @brief Bins an axis-aligned quad given as four corners (see SpriteBatch::Prepare()). It
+     * covers the pixels whose centres lie inside, like two triangles would.
+     */
+    void SoftwareRenderer::BinRectangle(const SDL_Vertex* corners, const Texture* texture, BlendMode blend)
+    {
+        const float width = texture ? static_cast<float>(texture->width) : 0.0f;
+        const float height = texture ? static_cast<float>(texture->height) : 0.0f;
+        float x0 = corners[0].position.x, x1 = corners[2].position.x;
+        float y0 = corners[0].position.y, y1 = corners[2].position.y;
+        float u0 = corners[0].tex_coord.x * width, u1 = corners[2].tex_coord.x * width;
+        float v0 = corners[0].tex_coord.y * height, v1 = corners[2].tex_coord.y * height;
+        if (x1 < x0)
+        {
+            std::swap(x0, x1);
+            std::swap(u0, u1);
+        }
+        if (y1 < y0)
+        {
+            std::swap(y0, y1);
+            std::swap(v0, v1);
+        }
+
+        Primitive primitive;
+        primitive.type = PrimitiveType::Rectangle;
+        primitive.blend = blend;
+        primitive.minX = FirstPixel(x0, m_target.width);
+        primitive.maxX = FirstPixel(x1, m_target.width);
+        primitive.minY = FirstPixel(y0, m_target.height);
+        primitive.maxY = FirstPixel(y1, m_target.height);
+        if (primitive.minX >= primitive.maxX || primitive.minY >= primitive.maxY)
+        {
+            return;
+        }
+
+        const SDL_FColor& color = corners[0].color;
+        primitive.solid = !texture && IsSolid(color, blend);
+        primitive.color = PackColor(color);
+        primitive.edges = 0;
+        primitive.texture = texture;
+
+        Gradients& gradients = primitive.gradients;
+        const float values[4] = {color.r, color.g, color.b, color.a};
+        for (int i = 0; i < 4; ++i)
+        {
+            gradients.base[i] = values[i];
+            gradients.dx[i] = 0.0f;
+            gradients.dy[i] = 0.0f;
+        }
+        const float du = (u1 - u0) / (x1 - x0);
+        const float dv = (v1 - v0) / (y1 - y0);
+        gradients.base[4] = u0 + (0.5f - x0) * du;
+        gradients.dx[4] = du;
+        gradients.dy[4] = 0.0f;
+        gradients.base[5] = v0 + (0.5f - y0) * dv;
+        gradients.dx[5] = 0.0f;
+        gradients.dy[5] = dv;
+
+        m_primitives.push_back(primitive);
+        Bin(static_cast<std::uint32_t>(m_primitives.size() - 1));
+    }
+
+    /**
+     * @brief Sets up and bins a triangle: positions snapped to 1/16 pixel for exact edge
+     * functions, so triangles sharing an edge never both cover a pixel on it, and colour and
+     * texel coordinates as planes over the screen.
+     */
+    void SoftwareRenderer::BinTriangle(const SDL_Vertex& a, const SDL_Vertex& b, const SDL_Vertex& c,
+                                       const Texture* texture, BlendMode blend)
+    {
+        const SDL_Vertex* vertex[3] = {&a, &b, &c};
+        std::int64_t x[3];
+        std::int64_t y[3];
+        for (int i = 0; i < 3; ++i)
+        {
+            const SDL_FPoint& position = vertex[i]->position;
+            if (!(std::fabs(position.x) <= kMaxCoordinate && std::fabs(position.y) <= kMaxCoordinate))
+            {
+                return;
+            }
+            x[i] = std::llround(position.x * 16.0f);
+            y[i] = std::llround(position.y * 16.0f);
+        }
+
+        std::int64_t area = (x[1] - x[0]) * (y[2] - y[0]) - (y[1] - y[0]) * (x[2] - x[0]);
+        if (area == 0)
+        {
+            return;
+        }
+        if (area < 0)
+        {
+            std::swap(vertex[1], vertex[2]);
+            std::swap(x[1], x[2]);
+            std::swap(y[1], y[2]);
+            area = -area;
+        }
+
+        Primitive primitive;
+        primitive.type = PrimitiveType::Triangle;
+        primitive.blend = blend;
+        const float minX = static_cast<float>(std::min({x[0], x[1], x[2]})) / 16.0f;
+        const float maxX = static_cast<float>(std::max({x[0], x[1], x[2]})) / 16.0f;
+        const float minY = static_cast<float>(std::min({y[0], y[1], y[2]})) / 16.0f;
+        const float maxY = static_cast<float>(std::max({y[0], y[1], y[2]})) / 16.0f;
+        primitive.minX = FirstPixel(minX, m_target.width);
+        primitive.maxX = FirstPixel(maxX, m_target.width);
+        primitive.minY = FirstPixel(minY, m_target.height);
+        primitive.maxY = FirstPixel(maxY, m_target.height);
+        if (primitive.minX >= primitive.maxX || primitive.minY >= primitive.maxY)
+        {
+            return;
+        }
+
+        // Inside is where every edge function is >= 0; pixels exactly on an edge belong to
+        // the triangle only if it is a top or left edge.
+        Edges edges;
+        for (int i = 0; i < 3; ++i)
+        {
+            const int j = (i + 1) % 3;
+            const std::int64_t stepX = y[i] - y[j];
+            const std::int64_t stepY = x[j] - x[i];
+            const std::int64_t offset = -(stepX * x[i] + stepY * y[i]);
+            const bool topLeft = stepX > 0 || (stepX == 0 && stepY > 0);
+            edges.step[i][0] = stepX * 16;
+            edges.step[i][1] = stepY * 16;
+            edges.origin[i] = (stepX + stepY) * 8 + offset - (topLeft ? 0 : 1);
+        }
+
+        const SDL_FColor& color = vertex[0]->color;
+        primitive.solid = !texture && SameColor(color, vertex[1]->color) && SameColor(color, vertex[2]->color) &&
+                          IsSolid(color, blend);
+        primitive.color = PackColor(color);
+        primitive.texture = texture;
+
+        const float width = texture ? static_cast<float>(texture->width) : 0.0f;
+        const float height = texture ? static_cast<float>(texture->height) : 0.0f;
+        float values[3][6];
+        float px[3];
+        float py[3];
+        for (int i = 0; i < 3; ++i)
+        {
+            const SDL_Vertex& source = *vertex[i];
+            values[i][0] = source.color.r;
+            values[i][1] = source.color.g;
+            values[i][2] = source.color.b;
+            values[i][3] = source.color.a;
+            values[i][4] = source.tex_coord.x * width;
+            values[i][5] = source.tex_coord.y * height;
+            px[i] = static_cast<float>(x[i]) / 16.0f;
+            py[i] = static_cast<float>(y[i]) / 16.0f;
+        }
+        const float dx1 = px[1] - px[0], dy1 = py[1] - py[0];
+        const float dx2 = px[2] - px[0], dy2 = py[2] - py[0];
+        const float determinant = static_cast<float>(area) / 256.0f;
+        Gradients& gradients = primitive.gradients;
+        for (int k = 0; k < 6; ++k)
+        {
+            const float df1 = values[1][k] - values[0][k];
+            const float df2 = values[2][k] - values[0][k];
+            gradients.dx[k] = (df1 * dy2 - df2 * dy1) / determinant;
+            gradients.dy[k] = (df2 * dx1 - df1 * dx2) / determinant;
+            gradients.base[k] = values[0][k] + gradients.dx[k] * (0.5f - px[0]) + gradients.dy[k] * (0.5f - py[0]);
+        }
+
+        primitive.edges = static_cast<std::uint32_t>(m_edges.size());
+        m_edges.push_back(edges);
+        m_primitives.push_back(primitive);
+        Bin(static_cast<std::uint32_t>(m_primitives.size() - 1));
+    }
+
+    /**
+     * @brief Adds a primitive to the bins of the tiles it overlaps. Tiles a triangle's bounds
+     * reach but that lie entirely outside one of its edges are skipped.
+     */
+    void SoftwareRenderer::Bin(std::uint32_t index)
+    {
+        const Primitive& primitive = m_primitives[index];
+        const Edges* edges = primitive.type == PrimitiveType::Triangle ? &m_edges[primitive.edges] : nullptr;
+        const int tileSize = m_config.tileSize;
+        const int firstX = primitive.minX / tileSize, lastX = (primitive.maxX - 1) / tileSize;
+        const int firstY = primitive.minY / tileSize, lastY = (primitive.maxY - 1) / tileSize;
+        const bool singleTile = firstX == lastX && firstY == lastY;
+
+        for (int tileY = firstY; tileY <= lastY; ++tileY)
+        {
+            for (int tileX = firstX; tileX <= lastX; ++tileX)
+            {
+                if (edges && !singleTile)
+                {
+                    const std::int64_t left = tileX * tileSize, right = std::min((tileX + 1) * tileSize, m_target.width) - 1;
+                    const std::int64_t top = tileY * tileSize, bottom = std::min((tileY + 1) * tileSize, m_target.height) - 1;
+                    bool outside = false;
+                    for (int i = 0; i < 3 && !outside; ++i)
+                    {
+                        const std::int64_t* step = edges->step[i];
+                        const std::int64_t best = edges->origin[i] + step[0] * (step[0] > 0 ? right : left) +
+                                                  step[1] * (step[1] > 0 ? bottom : top);
+                        outside = best < 0;
+                    }
+                    if (outside)
+                    {
+                        continue;
+                    }
+                }
+
+                const std::size_t tile = static_cast<std::size_t>(tileY) * m_tilesX + tileX;
+                if (m_bins[tile].empty())
+                {
+                    m_activeTiles.push_back(static_cast<std::uint32_t>(tile));
+                }
+                m_bins[tile].push_back(index);
+            }
+        }
+    }
+
+    /**
+     * @brief Rasterizes every tile with something binned, one job per tile batch. Tiles never
+     * share pixels, so the jobs need no synchronisation.
+     */
+    void SoftwareRenderer::Flush()
+    {
+        if (m_targetHandle == 0 && !m_damage.empty())
+        {
+            // Undamaged tiles of the framebuffer keep the previous frame's pixels
+            const auto undamaged = [this](std::uint32_t tile) {
+                if (IsTileDamaged(tile))
+                {
+                    return false;
+                }
+                m_bins[tile].clear();
+                return true;
+            };
+            m_activeTiles.erase(std::remove_if(m_activeTiles.begin(), m_activeTiles.end(), undamaged),
+                                m_activeTiles.end());
+        }
+
+        if (!m_activeTiles.empty())
+        {
+            POLARIS_PROFILE_SCOPE("SoftwareRenderer::Flush");
+            const auto rasterize = [this](std::size_t begin, std::size_t end) {
+                POLARIS_PROFILE_SCOPE("SoftwareRenderer::RasterizeTiles");
+                for (std::size_t i = begin; i < end; ++i)
+                {
+                    RasterizeTile(m_activeTiles[i]);
+                }
+            };
+            if (m_config.jobs)
+            {
+                m_config.jobs->parallelFor(m_activeTiles.size(), rasterize);
+            }
+            else
+            {
+                rasterize(0, m_activeTiles.size());
+            }
+
+            for (std::uint32_t tile : m_activeTiles)
+            {
+                m_bins[tile].clear();
+            }
+            m_activeTiles.clear();
+        }
+        m_primitives.clear();
+        m_edges.clear();
+    }
+
+    bool SoftwareRenderer::IsTileDamaged(std::size_t tile) const
+    {
+        const int tileSize = m_config.tileSize;
+        const SDL_Rect bounds = {static_cast<int>(tile % m_tilesX) * tileSize, static_cast<int>(tile / m_tilesX) * tileSize,
+                                 tileSize, tileSize};
+        return std::any_of(m_damage.begin(), m_damage.end(),
+                           [&bounds](const SDL_Rect& rect) { return SDL_HasRectIntersection(&bounds, &rect); });
+    }
+
+    void SoftwareRenderer::RasterizeTile(std::size_t tile)
+    {
+        const int tileSize = m_config.tileSize;
+        const int tileLeft = static_cast<int>(tile % m_tilesX) * tileSize;
+        const int tileTop = static_cast<int>(tile / m_tilesX) * tileSize;
+        const int tileRight = std::min(tileLeft + tileSize, m_target.width);
+        const int tileBottom = std::min(tileTop + tileSize, m_target.height);
+
+        for (std::uint32_t index : m_bins[tile])
+        {
+            const Primitive& primitive = m_primitives[index];
+            const int left = std::max(primitive.minX, tileLeft);
+            const int right = std::min(primitive.maxX, tileRight);
+            const int top = std::max(primitive.minY, tileTop);
+            const int bottom = std::min(primitive.maxY, tileBottom);
+
+            if (primitive.type == PrimitiveType::Rectangle)
+            {
+                for (int y = top; y < bottom; ++y)
+                {
+                    ShadeRow(primitive, m_target.pixels + static_cast<std::size_t>(y) * m_target.pitch, y, left, right);
+                }
+                continue;
+            }
+
+            // Each edge bounds the row's span on one side, found by solving its function for x
+            const Edges& edges = m_edges[primitive.edges];
+            for (int y = top; y < bottom; ++y)
+            {
+                std::int64_t begin = left;
+                std::int64_t end = right;
+                for (int i = 0; i < 3 && begin < end; ++i)
+                {
+                    const std::int64_t stepX = edges.step[i][0];
+                    const std::int64_t rowValue = edges.step[i][1] * y + edges.origin[i];
+                    if (stepX > 0)
+                    {
+                        begin = std::max(begin, CeilDiv(-rowValue, stepX));
+                    }
+                    else if (stepX < 0)
+                    {
+                        end = std::min(end, FloorDiv(rowValue, -stepX) + 1);
+                    }
+                    else if (rowValue < 0)
+                    {
+                        end = begin;
+                    }
+                }
+                if (begin < end)
+                {
+                    ShadeRow(primitive, m_target.pixels + static_cast<std::size_t>(y) * m_target.pitch, y,
+                             static_cast<int>(begin), static_cast<int>(end));
+                }
+            }
+        }
+    }
+
+    void SoftwareRenderer::ShadeRow(const Primitive& primitive, std::uint32_t* row, int y, int begin, int end) const
+    {
+        if (primitive.solid)
+        {
+            m_kernels->fill(row + begin, end - begin, primitive.color);
+            return;
+        }
+
+        const Gradients& gradients = primitive.gradients;
+        const float x = static_cast<float>(begin);
+        const float rowY = static_cast<float>(y);
+        float start[6];
+        for (int k = 0; k < 6; ++k)
+        {
+            start[k] = gradients.base[k] + gradients.dx[k] * x + gradients.dy[k] * rowY;
+        }
+
+        RasterSpan span;
+        span.r = start[0];
+        span.g = start[1];
+        span.b = start[2];
+        span.a = start[3];
+        span.dr = gradients.dx[0];
+        span.dg = gradients.dx[1];
+        span.db = gradients.dx[2];
+        span.da = gradients.dx[3];
+        span.u = start[4];
+        span.v = start[5];
+        span.du = gradients.dx[4];
+        span.dv = gradients.dx[5];
+        const Texture* texture = primitive.texture;
+        span.texels = texture ? texture->pixels.data() : nullptr;
+        span.textureWidth = texture ? texture->width : 0;
+        span.textureHeight = texture ? texture->height : 0;
+        span.texturePitch = span.textureWidth;
+        m_kernels->shade[static_cast<int>(primitive.blend)](row + begin, end - begin, span);
+    }
+
+    /**
+     * @brief Copies the framebuffer to the window surface, converting to its pixel format. With
+     * damage, only the damaged rectangles are copied and updated on screen.
+     */
+    void SoftwareRenderer::PresentToWindow()
+    {
+        if (!m_window)
+        {
+            return;
+        }
+        POLARIS_PROFILE_SCOPE("SoftwareRenderer::Present");
+        SDL_Surface* surface = SDL_GetWindowSurface(m_window);
+        if (!surface)
+        {
+            return;
+        }
+        if (m_damage.empty())
+        {
+            if (SDL_BlitSurface(m_framebuffer, nullptr, surface, nullptr))
+            {
+                SDL_UpdateWindowSurface(m_window);
+            }
+            return;
+        }
+
+        for (const SDL_Rect& rect : m_damage)
+        {
+            SDL_BlitSurface(m_framebuffer, &rect, surface, &rect);
+        }
+        SDL_UpdateWindowSurfaceRects(m_window, m_damage.data(), static_cast<int>(m_damage.size()));
+    }
+}
@@ -0,0 +1,184 @@
+#pragma once
+
+#include "PlatformRenderer.h"
+#include "SpriteBatch.h"
+#include <SDL3/SDL.h>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace polaris
+{
+    class JobSystem;
+    struct RasterKernels;
+
+    /**
+     * @brief Settings of the software renderer.
+     */
+    struct SoftwareRendererConfig
+    {
+        /**
+         * @brief Edge length in pixels of the square tiles the target is split into. Each tile
+         * is rasterized by one job, so smaller tiles balance better and larger ones bin faster.
+         */
+        int tileSize = 64;
+        /**
+         * @brief Framebuffer size when the renderer is created without a window.
+         */
+        int width = 1280;
+        int height = 720;
+        /**
+         * @brief Job system the tiles are rasterized on, or null to rasterize them on the render
+         * thread. The engine passes its own.
+         */
+        JobSystem* jobs = nullptr;
+    };
+
+    /**
+     * @brief Renders on the CPU, for machines without a GPU (headless servers, thumbnails,
+     * replays, visual tests).
+     *
+     * Draws are binned into square tiles of the target on the render thread: sprites without
+     * rotation as rectangles, everything else as triangles with fixed-point edge functions and
+     * the top-left fill rule. The tiles are then rasterized in parallel on the job system, each
+     * in recorded order, with SIMD span kernels (AVX2 or SSE2 where math::getSimdLevel() allows,
+     * scalar otherwise). Pending draws are rasterized before anything that changes a texture or
+     * the target, and at Present.
+     *
+     * Textures are kept as RGBA32 in memory (YUV uploads are converted) and sampled
+     * nearest-neighbour. The framebuffer is an RGBA32 SDL_Surface; with a window, Present copies
+     * it to the window surface. When the command list tracks damage, only framebuffer tiles
+     * touching it are rasterized and only the damaged rectangles are presented.
+     */
+    class SoftwareRenderer: public PlatformRenderer
+    {
+    public:
+        explicit SoftwareRenderer(const SoftwareRendererConfig& config = SoftwareRendererConfig());
+        ~SoftwareRenderer();
+
+        /**
+         * @brief Creates the framebuffer, the size of the window in pixels, or of the configured
+         * size when window is null.
+         * @throws std::runtime_error if the framebuffer cannot be created.
+         */
+        void CreateRenderer(SDL_Window* window) override;
+
+        void RenderFrame(const CommandList& commands) override;
+
+        /**
+         * @brief The framebuffer, holding the last rendered frame once RenderFrame() returns.
+         * Replaced when the window is resized; use it on the render thread or while no frame is
+         * being rendered.
+         */
+        SDL_Surface* GetSurface() const { return m_framebuffer; }
+
+    private:
+        struct Texture
+        {
+            std::vector<std::uint32_t> pixels;
+            int width = 0;
+            int height = 0;
+            YUVColorspace colorspace = YUVColorspace::BT601Limited;   ///< Used to decode YUV uploads
+        };
+
+        /**
+         * @brief The pixels being drawn into: the framebuffer, or a target texture.
+         */
+        struct Target
+        {
+            std::uint32_t* pixels = nullptr;
+            int width = 0;
+            int height = 0;
+            int pitch = 0;   ///< In pixels.
+        };
+
+        enum class PrimitiveType : std::uint8_t
+        {
+            Rectangle,   ///< Axis-aligned, including clears.
+            Triangle
+        };
+
+        /**
+         * @brief Value of an attribute at the centre of pixel (x, y): base + dx * x + dy * y.
+         * Attributes are r, g, b, a and the texel coordinates u, v.
+         */
+        struct Gradients
+        {
+            float base[6];
+            float dx[6];
+            float dy[6];
+        };
+
+        /**
+         * @brief A triangle's edge functions in 1/16 pixel fixed point, evaluated at pixel centres
+         * and biased for the fill rule: pixel (x, y) is inside if step[i][0] * x + step[i][1] * y
+         * + origin[i] >= 0 for all three edges.
+         */
+        struct Edges
+        {
+            std::int64_t step[3][2];
+            std::int64_t origin[3];
+        };
+
+        struct Primitive
+        {
+            PrimitiveType type;
+            BlendMode blend;
+            bool solid;                 ///< Overwrites its pixels with color; no shading needed
+            std::uint32_t color;        ///< Packed colour of a solid primitive
+            std::uint32_t edges;        ///< Triangle: index into m_edges
+            const Texture* texture;     ///< null for untextured
+            int minX, minY, maxX, maxY; ///< Pixels covered, clipped to the target; max exclusive
+            Gradients gradients;
+        };
+
+        Texture* GetTexture(TextureHandle handle);
+        void Resize(int width, int height);
+        void BindTarget(TextureHandle handle);
+
+        void BinSprites(RenderStats& stats);
+        void BinClear(const SDL_FColor& color);
+        void BinRectangle(const SDL_Vertex* corners, const Texture* texture, BlendMode blend);
+        void BinTriangle(const SDL_Vertex& a, const SDL_Vertex& b, const SDL_Vertex& c, const Texture* texture,
+                         BlendMode blend);
+        void Bin(std::uint32_t index);
+
+        /**
+         * @brief Rasterizes and clears the binned primitives.
+         */
+        void Flush();
+        bool IsTileDamaged(std::size_t tile) const;
+        void RasterizeTile(std::size_t tile);
+        void ShadeRow(const Primitive& primitive, std::uint32_t* row, int y, int begin, int end) const;
+
+        void PresentToWindow();
+
+        SoftwareRendererConfig m_config;
+        SDL_Window* m_window;
+        SDL_Surface* m_framebuffer;
+        const RasterKernels* m_kernels;
+
+        /**
+         * @brief Textures indexed by TextureHandle, and their sizes for the sprite batch.
+         */
+        std::vector<Texture> m_textures;
+        std::vector<SpriteBatch::Texture> m_textureSizes;
+        SpriteBatch m_spriteBatch;
+
+        Target m_target;
+        TextureHandle m_targetHandle;
+        int m_tilesX;
+        int m_tilesY;
+        std::vector<Primitive> m_primitives;
+        std::vector<Edges> m_edges;
+        /**
+         * @brief Primitive indices per tile, in draw order, and the tiles that have any.
+         */
+        std::vector<std::vector<std::uint32_t>> m_bins;
+        std::vector<std::uint32_t> m_activeTiles;
+        /**
+         * @brief The frame's damage; empty when the whole framebuffer is redrawn.
+         */
+        std::vector<SDL_Rect> m_damage;
+    };
+}
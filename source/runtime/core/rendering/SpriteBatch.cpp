@@ -0,0 +1,280 @@
+#include "SpriteBatch.h"
+
+#include "profiling/Profiler.h"
+#include <cmath>
+
+namespace polaris
+{
+    namespace
+    {
+        SDL_BlendMode ToSDLBlendMode(BlendMode blend)
+        {
+            switch (blend)
+            {
+                case BlendMode::Add: return SDL_BLENDMODE_ADD;
+                case BlendMode::Multiply: return SDL_BLENDMODE_MUL;
+                case BlendMode::None: return SDL_BLENDMODE_NONE;
+                case BlendMode::Blend:
+                default: return SDL_BLENDMODE_BLEND;
+            }
+        }
+
+        /**
+         * @brief Bits of the sort key that decide whether two sprites can share a draw call.
+         */
+        constexpr std::uint64_t kStateMask = 0xFFFFFFFFFFull;
+    }
+
+    /**
+     * @brief Queues sprites for the next Flush().
+     */
+    void SpriteBatch::Add(const Sprite* sprites, std::size_t count)
+    {
+        for (std::size_t i = 0; i < count; ++i)
+        {
+            m_sprites.push_back(sprites + i);
+        }
+    }
+
+    /**
+     * @brief Layer in the top bits, then blend mode, then texture, so sorting by key orders
+     * sprites by layer first and groups them by state within a layer.
+     */
+    std::uint64_t SpriteBatch::SortKey(const Sprite& sprite)
+    {
+        const std::uint64_t layer = static_cast<std::uint16_t>(sprite.layer + 32768);
+        return (layer << 40) | (static_cast<std::uint64_t>(sprite.blend) << 32) | sprite.texture;
+    }
+
+    /**
+     * @brief Sorts m_sprites into m_sorted (and m_keys alongside), stably. Skips the sort when
+     * the sprites are already in order, which is the common case of a single atlas and layer.
+     */
+    void SpriteBatch::SortSprites()
+    {
+        const std::size_t count = m_sprites.size();
+        m_keys.resize(count);
+        bool sorted = true;
+        for (std::size_t i = 0; i < count; ++i)
+        {
+            m_keys[i] = SortKey(*m_sprites[i]);
+            sorted = sorted && (i == 0 || m_keys[i - 1] <= m_keys[i]);
+        }
+
+        if (sorted)
+        {
+            m_sorted.assign(m_sprites.begin(), m_sprites.end());
+            return;
+        }
+
+        // LSD radix sort on the key bytes, which is stable, so sprites with equal keys keep
+        // their recorded order. Bytes that are the same in every key are skipped, so the usual
+        // handful of layers and textures costs one or two passes.
+        m_order.resize(count);
+        m_orderScratch.resize(count);
+        m_keysScratch.resize(count);
+        for (std::size_t i = 0; i < count; ++i)
+        {
+            m_order[i] = static_cast<std::uint32_t>(i);
+        }
+
+        std::uint64_t differing = 0;
+        for (std::size_t i = 1; i < count; ++i)
+        {
+            differing |= m_keys[i] ^ m_keys[0];
+        }
+
+        for (int shift = 0; shift < 64; shift += 8)
+        {
+            if (((differing >> shift) & 0xFF) == 0)
+            {
+                continue;
+            }
+
+            std::size_t offsets[256] = {};
+            for (std::size_t i = 0; i < count; ++i)
+            {
+                ++offsets[(m_keys[i] >> shift) & 0xFF];
+            }
+            std::size_t total = 0;
+            for (std::size_t& offset : offsets)
+            {
+                const std::size_t bucket = offset;
+                offset = total;
+                total += bucket;
+            }
+            for (std::size_t i = 0; i < count; ++i)
+            {
+                const std::size_t target = offsets[(m_keys[i] >> shift) & 0xFF]++;
+                m_keysScratch[target] = m_keys[i];
+                m_orderScratch[target] = m_order[i];
+            }
+            m_keys.swap(m_keysScratch);
+            m_order.swap(m_orderScratch);
+        }
+
+        m_sorted.resize(count);
+        for (std::size_t i = 0; i < count; ++i)
+        {
+            m_sorted[i] = m_sprites[m_order[i]];
+        }
+    }
+
+    /**
+     * @brief Expands the sorted sprites into four vertices each.
+     */
+    void SpriteBatch::BuildVertices(const std::vector<Texture>& textures)
+    {
+        m_vertices.resize(m_sorted.size() * 4);
+        SDL_Vertex* vertex = m_vertices.data();
+
+        for (const Sprite* sprite : m_sorted)
+        {
+            float u0 = 0.0f, v0 = 0.0f, u1 = 1.0f, v1 = 1.0f;
+            if (sprite->source.w > 0.0f && sprite->texture < textures.size())
+            {
+                const Texture& texture = textures[sprite->texture];
+                if (texture.width > 0.0f && texture.height > 0.0f)
+                {
+                    u0 = sprite->source.x / texture.width;
+                    v0 = sprite->source.y / texture.height;
+                    u1 = (sprite->source.x + sprite->source.w) / texture.width;
+                    v1 = (sprite->source.y + sprite->source.h) / texture.height;
+                }
+            }
+
+            const SDL_FRect& rect = sprite->destination;
+            float x[4] = {rect.x, rect.x + rect.w, rect.x + rect.w, rect.x};
+            float y[4] = {rect.y, rect.y, rect.y + rect.h, rect.y + rect.h};
+            if (sprite->rotation != 0.0f)
+            {
+                const float centerX = rect.x + rect.w * 0.5f;
+                const float centerY = rect.y + rect.h * 0.5f;
+                const float c = std::cos(sprite->rotation);
+                const float s = std::sin(sprite->rotation);
+                for (int corner = 0; corner < 4; ++corner)
+                {
+                    const float dx = x[corner] - centerX;
+                    const float dy = y[corner] - centerY;
+                    x[corner] = centerX + dx * c - dy * s;
+                    y[corner] = centerY + dx * s + dy * c;
+                }
+            }
+
+            const float u[4] = {u0, u1, u1, u0};
+            const float v[4] = {v0, v0, v1, v1};
+            for (int corner = 0; corner < 4; ++corner)
+            {
+                vertex->position = {x[corner], y[corner]};
+                vertex->color = sprite->color;
+                vertex->tex_coord = {u[corner], v[corner]};
+                ++vertex;
+            }
+        }
+    }
+
+    /**
+     * @brief Grows the shared quad index pattern to cover spriteCount sprites.
+     */
+    void SpriteBatch::EnsureIndices(std::size_t spriteCount)
+    {
+        std::size_t quads = m_indices.size() / 6;
+        if (quads >= spriteCount)
+        {
+            return;
+        }
+        m_indices.resize(spriteCount * 6);
+        for (; quads < spriteCount; ++quads)
+        {
+            const int base = static_cast<int>(quads * 4);
+            int* index = &m_indices[quads * 6];
+            index[0] = base;
+            index[1] = base + 1;
+            index[2] = base + 2;
+            index[3] = base + 2;
+            index[4] = base + 3;
+            index[5] = base;
+        }
+    }
+
+    /**
+     * @brief Sorts and expands the queued sprites, and clears the queue.
+     */
+    const std::vector<const Sprite*>& SpriteBatch::Prepare(const std::vector<Texture>& textures)
+    {
+        if (m_sprites.empty())
+        {
+            m_sorted.clear();
+            m_vertices.clear();
+            return m_sorted;
+        }
+
+        POLARIS_PROFILE_SCOPE("SpriteBatch::Prepare");
+        SortSprites();
+        BuildVertices(textures);
+        m_sprites.clear();
+        return m_sorted;
+    }
+
+    /**
+     * @brief Draws and clears the queued sprites with one SDL_RenderGeometry call per run of
+     * sprites sharing a texture and blend mode. The renderer's draw blend mode, which untextured
+     * runs set, is restored afterwards.
+     */
+    void SpriteBatch::Flush(SDL_Renderer* renderer, const std::vector<Texture>& textures, RenderStats& stats)
+    {
+        if (m_sprites.empty())
+        {
+            return;
+        }
+
+        POLARIS_PROFILE_SCOPE("SpriteBatch::Flush");
+        SortSprites();
+        BuildVertices(textures);
+
+        SDL_BlendMode drawBlend = SDL_BLENDMODE_NONE;
+        SDL_GetRenderDrawBlendMode(renderer, &drawBlend);
+
+        const std::size_t count = m_sorted.size();
+        std::size_t runStart = 0;
+        std::size_t longestRun = 0;
+        for (std::size_t i = 1; i <= count; ++i)
+        {
+            if (i < count && (m_keys[i] & kStateMask) == (m_keys[runStart] & kStateMask))
+            {
+                continue;
+            }
+
+            // Sprites [runStart, i) share texture and blend mode, even across layers.
+            const std::size_t runLength = i - runStart;
+            if (runLength > longestRun)
+            {
+                EnsureIndices(runLength);
+                longestRun = runLength;
+            }
+
+            const Sprite& first = *m_sorted[runStart];
+            SDL_Texture* texture = first.texture < textures.size() ? textures[first.texture].texture : nullptr;
+            const SDL_BlendMode blend = ToSDLBlendMode(first.blend);
+            if (texture)
+            {
+                SDL_SetTextureBlendMode(texture, blend);
+            }
+            else
+            {
+                SDL_SetRenderDrawBlendMode(renderer, blend);
+            }
+
+            SDL_RenderGeometry(renderer, texture, m_vertices.data() + runStart * 4, static_cast<int>(runLength * 4),
+                               m_indices.data(), static_cast<int>(runLength * 6));
+            ++stats.drawCalls;
+            runStart = i;
+        }
+        SDL_SetRenderDrawBlendMode(renderer, drawBlend);
+
+        stats.sprites += static_cast<std::uint32_t>(count);
+        stats.vertices += static_cast<std::uint32_t>(count * 4);
+        ++stats.flushes;
+        m_sprites.clear();
+    }
+}
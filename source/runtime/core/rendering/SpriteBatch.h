@@ -0,0 +1,83 @@
+#pragma once
+
+#include "CommandList.h"
+#include "PlatformRenderer.h"
+#include <SDL3/SDL.h>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace polaris
+{
+    /**
+     * @brief Turns the sprites of a frame into as few SDL_RenderGeometry calls as possible.
+     *
+     * Sprites are collected until the next non-sprite command (or the end of the frame), sorted
+     * by layer, blend mode and texture, expanded into one CPU vertex stream, and then drawn with
+     * one SDL_RenderGeometry call per run of sprites sharing a texture and blend mode. With an
+     * atlas, a whole layer of sprites is usually a single call.
+     */
+    class SpriteBatch
+    {
+    public:
+        /**
+         * @brief A texture as known to the renderer, with its size for normalising source rects.
+         */
+        struct Texture
+        {
+            SDL_Texture* texture = nullptr;
+            float width = 0.0f;
+            float height = 0.0f;
+        };
+
+        /**
+         * @brief Queues sprites. They are referenced, not copied, and must stay valid until Flush().
+         */
+        void Add(const Sprite* sprites, std::size_t count);
+
+        /**
+         * @brief True if no sprites are queued.
+         */
+        bool IsEmpty() const { return m_sprites.empty(); }
+
+        /**
+         * @brief Draws and clears the queued sprites.
+         * @param renderer The SDL renderer to draw with.
+         * @param textures Textures indexed by TextureHandle; unknown handles draw untextured.
+         * @param stats Frame statistics to add the draw calls, sprites and vertices to.
+         */
+        void Flush(SDL_Renderer* renderer, const std::vector<Texture>& textures, RenderStats& stats);
+
+        /**
+         * @brief Sorts the queued sprites into draw order and expands them into vertices without
+         * drawing them, for renderers that rasterize sprites themselves, then clears the queue.
+         * @param textures Textures indexed by TextureHandle; only their sizes are used.
+         * @return The sprites in draw order. The corners of sprite i are GetVertices()[4 * i]
+         * onwards, top left, top right, bottom right, bottom left before rotation.
+         */
+        const std::vector<const Sprite*>& Prepare(const std::vector<Texture>& textures);
+
+        /**
+         * @brief Vertices built by the last Prepare() or Flush().
+         */
+        const std::vector<SDL_Vertex>& GetVertices() const { return m_vertices; }
+
+    private:
+        static std::uint64_t SortKey(const Sprite& sprite);
+        void SortSprites();
+        void BuildVertices(const std::vector<Texture>& textures);
+        void EnsureIndices(std::size_t spriteCount);
+
+        std::vector<const Sprite*> m_sprites;
+        std::vector<std::uint64_t> m_keys;
+        std::vector<std::uint32_t> m_order;
+        std::vector<std::uint64_t> m_keysScratch;
+        std::vector<std::uint32_t> m_orderScratch;
+        std::vector<const Sprite*> m_sorted;
+        std::vector<SDL_Vertex> m_vertices;
+        /**
+         * @brief The quad index pattern 0,1,2, 2,3,0, 4,5,6, ... shared by every draw call.
+         */
+        std::vector<int> m_indices;
+    };
+}
@@ -0,0 +1,466 @@
+#include "TextRenderer.h"
+
+#include "Logger.h"
+#include "memory/MemoryTracker.h"
+#include <SDL3_ttf/SDL_ttf.h>
+#include <algorithm>
+#include <cmath>
+#include <fstream>
+#include <iterator>
+
+namespace polaris
+{
+    namespace
+    {
+        /**
+         * @brief Layouts unused for longer than the configured age are dropped this often, in frames.
+         */
+        constexpr std::uint64_t kLayoutSweepInterval = 64;
+
+        /**
+         * @brief 64-bit FNV-1a hash of a byte range.
+         */
+        std::uint64_t HashBytes(const void* data, std::size_t size)
+        {
+            const unsigned char* bytes = static_cast<const unsigned char*>(data);
+            std::uint64_t hash = 14695981039346656037ull;
+            for (std::size_t i = 0; i < size; ++i)
+            {
+                hash ^= bytes[i];
+                hash *= 1099511628211ull;
+            }
+            return hash;
+        }
+    }
+
+    TextRenderer::TextRenderer(const TextRendererConfig& config)
+        : m_atlas(config.atlasPageSize, config.atlasMaxPages),
+          m_frame(1),
+          m_layoutMaxAge(config.layoutMaxAge),
+          m_ttfInitialized(false)
+    {
+    }
+
+    TextRenderer::~TextRenderer()
+    {
+        for (Font& font : m_fonts)
+        {
+            for (auto& [size, ttf] : font.sizes)
+            {
+                if (ttf)
+                {
+                    TTF_CloseFont(ttf);
+                }
+            }
+        }
+        if (m_ttfInitialized)
+        {
+            TTF_Quit();
+        }
+    }
+
+    /**
+     * @brief Reads the whole file, since SDL_ttf opens each size from it, and hashes it for
+     * the glyph keys. One size is opened right away so that a bad file is reported here.
+     */
+    FontHandle TextRenderer::LoadFont(const std::string& path)
+    {
+        POLARIS_MEMORY_SCOPE(Assets);
+        if (const FontHandle loaded = FindFont(path))
+        {
+            return loaded;
+        }
+
+        if (!m_ttfInitialized)
+        {
+            if (!TTF_Init())
+            {
+                LOG_ERROR("Failed to initialize SDL_ttf: {}", SDL_GetError());
+                return 0;
+            }
+            m_ttfInitialized = true;
+        }
+
+        std::ifstream file(path, std::ios::binary);
+        if (!file.is_open())
+        {
+            LOG_ERROR("Failed to open font {}", path);
+            return 0;
+        }
+
+        Font font;
+        font.path = path;
+        font.data.assign(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+        font.hash = HashBytes(font.data.data(), font.data.size());
+        m_fonts.push_back(std::move(font));
+
+        const FontHandle handle = static_cast<FontHandle>(m_fonts.size());
+        if (!GetSizedFont(handle, 16))
+        {
+            m_fonts.pop_back();
+            return 0;
+        }
+        LOG_INFO("Loaded font {}", path);
+        return handle;
+    }
+
+    FontHandle TextRenderer::FindFont(const std::string& path) const
+    {
+        for (std::size_t i = 0; i < m_fonts.size(); ++i)
+        {
+            if (m_fonts[i].path == path)
+            {
+                return static_cast<FontHandle>(i + 1);
+            }
+        }
+        return 0;
+    }
+
+    /**
+     * @brief Closes the sizes opened from the old contents and drops the font's layouts. The
+     * glyph keys include the content hash, so the old glyphs are never drawn again.
+     */
+    bool TextRenderer::ReloadFont(const std::string& path, std::vector<std::uint8_t> data)
+    {
+        POLARIS_MEMORY_SCOPE(Assets);
+        const FontHandle handle = FindFont(path);
+        if (handle == 0)
+        {
+            return false;
+        }
+
+        Font& font = m_fonts[handle - 1];
+        for (auto& [size, ttf] : font.sizes)
+        {
+            if (ttf)
+            {
+                TTF_CloseFont(ttf);
+            }
+        }
+        font.sizes.clear();
+        font.data = std::move(data);
+        font.hash = HashBytes(font.data.data(), font.data.size());
+        for (auto it = m_layouts.begin(); it != m_layouts.end();)
+        {
+            it = it->second.font == handle ? m_layouts.erase(it) : std::next(it);
+        }
+        LOG_INFO("Reloaded font {}", path);
+        return true;
+    }
+
+    /**
+     * @brief Advances the frame and every so often drops the layouts of strings no longer drawn.
+     */
+    void TextRenderer::BeginFrame()
+    {
+        ++m_frame;
+        m_atlas.BeginFrame();
+        if (m_frame % kLayoutSweepInterval != 0)
+        {
+            return;
+        }
+        for (auto it = m_layouts.begin(); it != m_layouts.end();)
+        {
+            it = m_frame - it->second.lastUsed > m_layoutMaxAge ? m_layouts.erase(it) : std::next(it);
+        }
+    }
+
+    /**
+     * @brief Copies the string's cached quads into the command list at (x, y), resolving them
+     * against the atlas first if it changed since they were built.
+     */
+    void TextRenderer::Draw(CommandList& commands, FontHandle font, int size, std::string_view text, float x, float y,
+                            const SDL_FColor& color, std::int16_t layer)
+    {
+        Layout* layout = GetLayout(font, size, text);
+        if (!layout)
+        {
+            return;
+        }
+        ++m_stats.strings;
+
+        if (layout->epoch != m_atlas.GetEpoch())
+        {
+            Resolve(*layout, commands);
+        }
+        else
+        {
+            for (std::uint16_t page : layout->pages)
+            {
+                m_atlas.Touch(page);
+            }
+        }
+
+        // Whole pixels keep the glyphs' texels aligned with the target's
+        const float originX = std::round(x);
+        const float originY = std::round(y);
+        m_sprites.resize(layout->quads.size());
+        for (std::size_t i = 0; i < m_sprites.size(); ++i)
+        {
+            Sprite& sprite = m_sprites[i];
+            sprite = layout->quads[i];
+            sprite.destination.x += originX;
+            sprite.destination.y += originY;
+            sprite.color = color;
+            sprite.layer = layer;
+        }
+        if (!m_sprites.empty())
+        {
+            commands.DrawSprites(m_sprites.data(), m_sprites.size());
+        }
+        m_stats.glyphsDrawn += m_sprites.size();
+    }
+
+    SDL_FPoint TextRenderer::Measure(FontHandle font, int size, std::string_view text)
+    {
+        const Layout* layout = GetLayout(font, size, text);
+        return layout ? layout->extent : SDL_FPoint{0.0f, 0.0f};
+    }
+
+    bool TextRenderer::LoadCache(const std::string& path, CommandList& commands)
+    {
+        if (!m_atlas.Load(path, commands))
+        {
+            LOG_INFO("No usable glyph cache at {}", path);
+            return false;
+        }
+        LOG_INFO("Loaded glyph cache {}: {} glyphs on {} pages", path, m_atlas.GetGlyphCount(), m_atlas.GetPageCount());
+        return true;
+    }
+
+    bool TextRenderer::SaveCache(const std::string& path) const
+    {
+        return m_atlas.Save(path);
+    }
+
+    void TextRenderer::Clear(CommandList& commands)
+    {
+        m_atlas.Clear(commands);
+        m_layouts.clear();
+    }
+
+    TextStats TextRenderer::TakeStats()
+    {
+        TextStats stats = m_stats;
+        const GlyphAtlasStats atlasStats = m_atlas.TakeStats();
+        stats.glyphsDropped = atlasStats.glyphsDropped;
+        stats.pagesEvicted = atlasStats.pagesEvicted;
+        m_stats = TextStats();
+        return stats;
+    }
+
+    /**
+     * @brief Finds or opens the font at a pixel size. A size that fails to open is remembered
+     * as nullptr, so the error is logged once.
+     */
+    TTF_Font* TextRenderer::GetSizedFont(FontHandle font, int size)
+    {
+        Font& entry = m_fonts[font - 1];
+        for (const auto& [openSize, ttf] : entry.sizes)
+        {
+            if (openSize == size)
+            {
+                return ttf;
+            }
+        }
+
+        TTF_Font* ttf = TTF_OpenFontIO(SDL_IOFromConstMem(entry.data.data(), entry.data.size()), true,
+                                       static_cast<float>(size));
+        if (!ttf)
+        {
+            LOG_ERROR("Failed to open font {} at size {}: {}", entry.path, size, SDL_GetError());
+        }
+        entry.sizes.emplace_back(size, ttf);
+        return ttf;
+    }
+
+    /**
+     * @brief Looks the string up by a hash of its font, size and text, laying it out on a miss.
+     * Pen positions come from the glyph advances and kerning pairs; on a hash collision the
+     * other string's layout is replaced.
+     */
+    TextRenderer::Layout* TextRenderer::GetLayout(FontHandle font, int size, std::string_view text)
+    {
+        if (font == 0 || font > m_fonts.size() || size <= 0 || size > 0xFFFF || text.empty())
+        {
+            return nullptr;
+        }
+
+        const std::uint64_t key = HashBytes(text.data(), text.size()) ^
+                                  (((static_cast<std::uint64_t>(font) << 32) | static_cast<std::uint32_t>(size)) *
+                                   0x9E3779B97F4A7C15ull);
+        Layout& layout = m_layouts[key];
+        if (layout.lastUsed != 0 && layout.font == font && layout.size == size && layout.text == text)
+        {
+            layout.lastUsed = m_frame;
+            return &layout;
+        }
+
+        TTF_Font* ttf = GetSizedFont(font, size);
+        if (!ttf)
+        {
+            m_layouts.erase(key);
+            return nullptr;
+        }
+        ++m_stats.layoutMisses;
+
+        layout.text.assign(text);
+        layout.font = font;
+        layout.size = size;
+        layout.glyphs.clear();
+        layout.quads.clear();
+        layout.pages.clear();
+        layout.epoch = 0;
+        layout.lastUsed = m_frame;
+
+        const float lineSkip = static_cast<float>(TTF_GetFontLineSkip(ttf));
+        float penX = 0.0f;
+        float penY = 0.0f;
+        float width = 0.0f;
+        Uint32 previous = 0;
+        const char* cursor = text.data();
+        std::size_t remaining = text.size();
+        while (remaining > 0)
+        {
+            const Uint32 codepoint = SDL_StepUTF8(&cursor, &remaining);
+            if (codepoint == 0)
+            {
+                break;
+            }
+            if (codepoint == '\n')
+            {
+                width = std::max(width, penX);
+                penX = 0.0f;
+                penY += lineSkip;
+                previous = 0;
+                continue;
+            }
+
+            int kerning = 0;
+            if (previous != 0 && TTF_GetGlyphKerning(ttf, previous, codepoint, &kerning))
+            {
+                penX += static_cast<float>(kerning);
+            }
+            layout.glyphs.push_back({codepoint, penX, penY});
+            int advance = 0;
+            if (TTF_GetGlyphMetrics(ttf, codepoint, nullptr, nullptr, nullptr, nullptr, &advance))
+            {
+                penX += static_cast<float>(advance);
+            }
+            previous = codepoint;
+        }
+        layout.extent = {std::max(width, penX), penY + static_cast<float>(TTF_GetFontHeight(ttf))};
+        return &layout;
+    }
+
+    /**
+     * @brief Rebuilds the layout's quads from the atlas, rasterizing missing glyphs. If a
+     * glyph could not be added the layout stays unresolved, so the next draw tries again.
+     */
+    void TextRenderer::Resolve(Layout& layout, CommandList& commands)
+    {
+        layout.quads.clear();
+        layout.pages.clear();
+        const std::uint64_t fontHash = m_fonts[layout.font - 1].hash;
+        TTF_Font* ttf = nullptr;
+        bool complete = true;
+
+        for (const LayoutGlyph& placed : layout.glyphs)
+        {
+            const GlyphKey key{fontHash, static_cast<std::uint16_t>(layout.size), placed.codepoint};
+            const AtlasGlyph* glyph = m_atlas.Find(key);
+            if (!glyph)
+            {
+                if (!ttf)
+                {
+                    ttf = GetSizedFont(layout.font, layout.size);
+                }
+                glyph = ttf ? Rasterize(key, ttf, commands) : nullptr;
+                if (!glyph)
+                {
+                    complete = false;
+                    continue;
+                }
+            }
+            if (glyph->page == kNoGlyphPage)
+            {
+                continue;
+            }
+
+            m_atlas.Touch(glyph->page);
+            if (std::find(layout.pages.begin(), layout.pages.end(), glyph->page) == layout.pages.end())
+            {
+                layout.pages.push_back(glyph->page);
+            }
+            Sprite sprite;
+            sprite.destination = {placed.x + glyph->offsetX, placed.y + glyph->offsetY, glyph->source.w, glyph->source.h};
+            sprite.source = glyph->source;
+            sprite.texture = glyph->texture;
+            layout.quads.push_back(sprite);
+        }
+        layout.epoch = complete ? m_atlas.GetEpoch() : 0;
+    }
+
+    /**
+     * @brief Renders one glyph with SDL_ttf, trims it to its covered texels and adds it to the atlas.
+     */
+    const AtlasGlyph* TextRenderer::Rasterize(const GlyphKey& key, TTF_Font* ttf, CommandList& commands)
+    {
+        POLARIS_MEMORY_SCOPE(Assets);
+        ++m_stats.glyphsRasterized;
+
+        int minX = 0;
+        int maxY = 0;
+        TTF_GetGlyphMetrics(ttf, key.codepoint, &minX, nullptr, nullptr, &maxY, nullptr);
+        SDL_Surface* rendered = TTF_RenderGlyph_Blended(ttf, key.codepoint, SDL_Color{255, 255, 255, 255});
+        SDL_Surface* surface = rendered ? SDL_ConvertSurface(rendered, SDL_PIXELFORMAT_RGBA32) : nullptr;
+        if (rendered)
+        {
+            SDL_DestroySurface(rendered);
+        }
+        if (!surface)
+        {
+            // Keep the glyph as an empty one rather than trying again every frame
+            return m_atlas.Add(key, nullptr, 0, 0, 0, 0.0f, 0.0f, commands);
+        }
+
+        const std::uint8_t* pixels = static_cast<const std::uint8_t*>(surface->pixels);
+        int left = surface->w;
+        int top = surface->h;
+        int right = -1;
+        int bottom = -1;
+        for (int y = 0; y < surface->h; ++y)
+        {
+            const std::uint8_t* row = pixels + static_cast<std::size_t>(y) * surface->pitch;
+            for (int x = 0; x < surface->w; ++x)
+            {
+                if (row[x * 4 + 3] != 0)
+                {
+                    left = std::min(left, x);
+                    right = std::max(right, x);
+                    top = std::min(top, y);
+                    bottom = std::max(bottom, y);
+                }
+            }
+        }
+
+        const int width = right >= 0 ? right - left + 1 : 0;
+        const int height = bottom >= 0 ? bottom - top + 1 : 0;
+        m_coverage.resize(static_cast<std::size_t>(width) * height);
+        for (int y = 0; y < height; ++y)
+        {
+            const std::uint8_t* row = pixels + static_cast<std::size_t>(top + y) * surface->pitch;
+            for (int x = 0; x < width; ++x)
+            {
+                m_coverage[static_cast<std::size_t>(y) * width + x] = row[(left + x) * 4 + 3];
+            }
+        }
+        SDL_DestroySurface(surface);
+
+        // SDL_ttf's surface starts at the pen position and the top of the line, moved left or up
+        // by however far the glyph reaches past them
+        const float offsetX = static_cast<float>(left - std::max(0, -minX));
+        const float offsetY = static_cast<float>(top - std::max(0, maxY - TTF_GetFontAscent(ttf)));
+        return m_atlas.Add(key, m_coverage.data(), width, height, width, offsetX, offsetY, commands);
+    }
+}
@@ -0,0 +1,183 @@
+#pragma once
+
+#include "CommandList.h"
+#include "GlyphAtlas.h"
+#include <SDL3/SDL.h>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+typedef struct TTF_Font TTF_Font;
+
+namespace polaris
+{
+    /**
+     * @brief Identifies a font loaded by a TextRenderer. 0 means "no font".
+     */
+    using FontHandle = std::uint32_t;
+
+    struct TextRendererConfig
+    {
+        int atlasPageSize = 1024;           ///< See GlyphAtlas.
+        int atlasMaxPages = 4;
+        std::uint32_t layoutMaxAge = 120;   ///< Frames a string's layout is kept without being drawn.
+    };
+
+    /**
+     * @brief Text activity since the stats were last taken.
+     */
+    struct TextStats
+    {
+        std::uint64_t strings = 0;            ///< Draw calls.
+        std::uint64_t layoutMisses = 0;       ///< Strings that had to be laid out.
+        std::uint64_t glyphsRasterized = 0;
+        std::uint64_t glyphsDrawn = 0;
+        std::uint64_t glyphsDropped = 0;      ///< Glyphs left out because the atlas was full.
+        std::uint64_t pagesEvicted = 0;
+    };
+
+    /**
+     * @brief Draws UTF-8 text with SDL_ttf through the sprite batch.
+     *
+     * Each glyph is rasterized once per (font, size) into a GlyphAtlas. Each string's layout
+     * (glyph positions, with kerning and line breaks) is cached along with its ready-made
+     * sprites, so drawing a string seen in an earlier frame is a hash lookup plus a copy of its
+     * quads into the command list, and does not allocate. Layouts not drawn for
+     * TextRendererConfig::layoutMaxAge frames are dropped.
+     *
+     * The atlas can be saved with SaveCache() and restored with LoadCache() on the next run, so
+     * startup does not rasterize the glyphs again. Glyphs are keyed by a hash of the font file's
+     * contents, so a changed font never reuses stale glyphs.
+     *
+     * Call BeginFrame() once per frame before drawing, and Clear() before destroying the renderer
+     * to release the atlas textures. Not thread-safe; use from the thread recording the frame.
+     */
+    class TextRenderer
+    {
+    public:
+        explicit TextRenderer(const TextRendererConfig& config = TextRendererConfig());
+        ~TextRenderer();
+
+        TextRenderer(const TextRenderer&) = delete;
+        TextRenderer& operator=(const TextRenderer&) = delete;
+
+        /**
+         * @brief Loads a TrueType or OpenType font. Loading the same path again returns the same handle.
+         * @return The font, or 0 if it cannot be loaded.
+         */
+        FontHandle LoadFont(const std::string& path);
+
+        /**
+         * @brief Returns the handle of a loaded font file, or 0.
+         */
+        FontHandle FindFont(const std::string& path) const;
+
+        /**
+         * @brief Replaces a loaded font with new contents of its file, keeping its handle. Text
+         * is laid out again with the new font from the next Draw(); glyphs of the old one age
+         * out of the atlas.
+         * @param data The new file contents.
+         * @return false if no font was loaded from path.
+         */
+        bool ReloadFont(const std::string& path, std::vector<std::uint8_t> data);
+
+        /**
+         * @brief Starts a new frame: ages cached layouts and protects the atlas pages drawn from
+         * in this frame from eviction.
+         */
+        void BeginFrame();
+
+        /**
+         * @brief Draws a string, lines separated by '\n'.
+         * @param commands Command list to record the glyph sprites and any atlas uploads into.
+         * @param font Font to draw with.
+         * @param size Pixel size.
+         * @param text UTF-8 text.
+         * @param x Left edge of the text, in target pixels.
+         * @param y Top of the first line, in target pixels.
+         * @param color Text colour.
+         * @param layer Sprite layer.
+         */
+        void Draw(CommandList& commands, FontHandle font, int size, std::string_view text, float x, float y,
+                  const SDL_FColor& color = {1.0f, 1.0f, 1.0f, 1.0f}, std::int16_t layer = 0);
+
+        /**
+         * @brief Size of a string as Draw() would lay it out: the widest line and the height
+         * of all lines.
+         */
+        SDL_FPoint Measure(FontHandle font, int size, std::string_view text);
+
+        /**
+         * @brief Replaces the glyph atlas with a cache written by SaveCache(). A missing or
+         * outdated cache is not an error; glyphs are then rasterized as they are drawn.
+         * @return false if no cache was loaded.
+         */
+        bool LoadCache(const std::string& path, CommandList& commands);
+
+        /**
+         * @brief Writes the glyph atlas to disk, e.g. at shutdown.
+         * @return false if the file cannot be written.
+         */
+        bool SaveCache(const std::string& path) const;
+
+        /**
+         * @brief Records the destruction of the atlas pages and forgets every cached layout. Fonts stay loaded.
+         */
+        void Clear(CommandList& commands);
+
+        const GlyphAtlas& GetAtlas() const { return m_atlas; }
+
+        /**
+         * @brief Returns the counters accumulated since the last call and resets them.
+         */
+        TextStats TakeStats();
+
+    private:
+        struct Font
+        {
+            std::string path;
+            std::vector<std::uint8_t> data;   ///< File contents; SDL_ttf reads from them for as long as the font is open.
+            std::uint64_t hash;
+            std::vector<std::pair<int, TTF_Font*>> sizes;
+        };
+
+        struct LayoutGlyph
+        {
+            std::uint32_t codepoint;
+            float x;     ///< Pen position,
+            float y;     ///< and top of the line.
+        };
+
+        struct Layout
+        {
+            std::string text;
+            FontHandle font;
+            int size;
+            std::vector<LayoutGlyph> glyphs;
+            std::vector<Sprite> quads;            ///< Glyph sprites relative to the text's origin.
+            std::vector<std::uint16_t> pages;     ///< Atlas pages the quads sample.
+            std::uint32_t epoch;                  ///< Atlas epoch the quads were resolved in; 0 if unresolved.
+            std::uint64_t lastUsed;
+            SDL_FPoint extent;
+        };
+
+        TTF_Font* GetSizedFont(FontHandle font, int size);
+        Layout* GetLayout(FontHandle font, int size, std::string_view text);
+        void Resolve(Layout& layout, CommandList& commands);
+        const AtlasGlyph* Rasterize(const GlyphKey& key, TTF_Font* ttf, CommandList& commands);
+
+        std::vector<Font> m_fonts;   ///< FontHandle - 1 indexes this.
+        std::unordered_map<std::uint64_t, Layout> m_layouts;
+        GlyphAtlas m_atlas;
+        std::vector<Sprite> m_sprites;          ///< Quads of the string being drawn, placed and tinted.
+        std::vector<std::uint8_t> m_coverage;   ///< Glyph being rasterized.
+        std::uint64_t m_frame;
+        std::uint32_t m_layoutMaxAge;
+        bool m_ttfInitialized;
+        TextStats m_stats;
+    };
+}
@@ -0,0 +1,757 @@
+#include "TextureManager.h"
+
+#include "Logger.h"
+#include "assets/AssetPack.h"
+#include "memory/MemoryTracker.h"
+#include "profiling/Profiler.h"
+#include <SDL3_image/SDL_image.h>
+#include <algorithm>
+
+namespace polaris
+{
+    namespace
+    {
+        std::size_t TexelBytes(int width, int height)
+        {
+            return static_cast<std::size_t>(width) * static_cast<std::size_t>(height) * 4;
+        }
+
+        /**
+         * @brief Box-filters an RGBA32 image by the smallest power of two that brings both sides
+         * within maxSide.
+         * @return false, leaving pixels empty, if the image already fits.
+         */
+        bool Downsample(const SDL_Surface* image, int maxSide, std::vector<std::uint8_t>& pixels, int& width, int& height)
+        {
+            int factor = 1;
+            while ((image->w + factor - 1) / factor > maxSide || (image->h + factor - 1) / factor > maxSide)
+            {
+                factor *= 2;
+            }
+            if (factor == 1)
+            {
+                return false;
+            }
+
+            width = (image->w + factor - 1) / factor;
+            height = (image->h + factor - 1) / factor;
+            pixels.resize(TexelBytes(width, height));
+            const std::uint8_t* source = static_cast<const std::uint8_t*>(image->pixels);
+            std::uint8_t* out = pixels.data();
+            for (int y = 0; y < height; ++y)
+            {
+                const int y1 = std::min((y + 1) * factor, image->h);
+                for (int x = 0; x < width; ++x)
+                {
+                    // Blocks on the right and bottom edges may be clipped by the image
+                    const int x1 = std::min((x + 1) * factor, image->w);
+                    std::uint32_t sum[4] = {0, 0, 0, 0};
+                    for (int sy = y * factor; sy < y1; ++sy)
+                    {
+                        const std::uint8_t* texel = source + sy * image->pitch + x * factor * 4;
+                        for (int sx = x * factor; sx < x1; ++sx, texel += 4)
+                        {
+                            sum[0] += texel[0];
+                            sum[1] += texel[1];
+                            sum[2] += texel[2];
+                            sum[3] += texel[3];
+                        }
+                    }
+                    const std::uint32_t count = static_cast<std::uint32_t>((y1 - y * factor) * (x1 - x * factor));
+                    for (int c = 0; c < 4; ++c)
+                    {
+                        *out++ = static_cast<std::uint8_t>((sum[c] + count / 2) / count);
+                    }
+                }
+            }
+            return true;
+        }
+    }
+
+    TextureRef::TextureRef(const TextureRef& other)
+        : m_manager(other.m_manager), m_slot(other.m_slot), m_epoch(other.m_epoch)
+    {
+        if (m_manager)
+        {
+            m_manager->AddRef(m_slot, m_epoch);
+        }
+    }
+
+    TextureRef::TextureRef(TextureRef&& other) noexcept
+        : m_manager(other.m_manager), m_slot(other.m_slot), m_epoch(other.m_epoch)
+    {
+        other.m_manager = nullptr;
+    }
+
+    TextureRef& TextureRef::operator=(const TextureRef& other)
+    {
+        if (other.m_manager)
+        {
+            other.m_manager->AddRef(other.m_slot, other.m_epoch);
+        }
+        Reset();
+        m_manager = other.m_manager;
+        m_slot = other.m_slot;
+        m_epoch = other.m_epoch;
+        return *this;
+    }
+
+    TextureRef& TextureRef::operator=(TextureRef&& other) noexcept
+    {
+        if (this != &other)
+        {
+            Reset();
+            m_manager = other.m_manager;
+            m_slot = other.m_slot;
+            m_epoch = other.m_epoch;
+            other.m_manager = nullptr;
+        }
+        return *this;
+    }
+
+    TextureRef::~TextureRef()
+    {
+        Reset();
+    }
+
+    TextureView TextureRef::View() const
+    {
+        return m_manager ? m_manager->View(m_slot, m_epoch) : TextureView();
+    }
+
+    void TextureRef::Reset()
+    {
+        if (m_manager)
+        {
+            m_manager->Release(m_slot, m_epoch);
+            m_manager = nullptr;
+        }
+    }
+
+    TextureManager::TextureManager()
+        : m_epoch(0),
+          m_firstFree(kNone),
+          m_stopping(false),
+          m_residentBytes(0),
+          m_residentTextures(0),
+          m_placeholders(0),
+          m_pendingLoads(0),
+          m_loads(0),
+          m_failures(0),
+          m_evictions(0),
+          m_reloads(0),
+          m_uploadedBytes(0),
+          m_totalLoadMilliseconds(0.0),
+          m_maxLoadMilliseconds(0.0)
+    {
+    }
+
+    TextureManager::~TextureManager()
+    {
+        Shutdown();
+    }
+
+    void TextureManager::Initialize(const TextureManagerConfig& config)
+    {
+        Shutdown();
+        m_config = config;
+        m_stopping = false;
+        const int threads = std::max(config.decodeThreads, 1);
+        for (int i = 0; i < threads; ++i)
+        {
+            m_threads.emplace_back(&TextureManager::DecodeMain, this);
+        }
+        LOG_INFO("Texture manager started: {} MB budget, {} decode threads",
+                 m_config.memoryBudget / (1024 * 1024), threads);
+    }
+
+    void TextureManager::Shutdown()
+    {
+        {
+            std::lock_guard<std::mutex> lock(m_requestMutex);
+            m_stopping = true;
+            m_requests.clear();
+        }
+        m_requestReady.notify_all();
+        for (std::thread& thread : m_threads)
+        {
+            thread.join();
+        }
+        m_threads.clear();
+
+        for (const DecodeResult& result : m_results)
+        {
+            if (result.image)
+            {
+                SDL_DestroySurface(result.image);
+            }
+        }
+        m_results.clear();
+        for (const Entry& entry : m_entries)
+        {
+            if (entry.pending)
+            {
+                SDL_DestroySurface(entry.pending);
+            }
+        }
+
+        // References still held belong to the old epoch and are ignored
+        ++m_epoch;
+        m_entries.clear();
+        m_firstFree = kNone;
+        m_slots.clear();
+        m_unusedTextures = LruList();
+        m_unusedPlaceholders = LruList();
+        m_uploads.clear();
+        m_residentBytes = 0;
+        m_residentTextures = 0;
+        m_placeholders = 0;
+        m_pendingLoads = 0;
+    }
+
+    TextureRef TextureManager::Load(const std::string& name)
+    {
+        POLARIS_MEMORY_SCOPE(Assets);
+        std::uint32_t slot;
+        const auto found = m_slots.find(name);
+        if (found != m_slots.end())
+        {
+            slot = found->second;
+            Entry& entry = m_entries[slot];
+            if (entry.lru)
+            {
+                Unlink(slot);
+            }
+            if (entry.state == State::Evicted)
+            {
+                Request(slot);
+            }
+        }
+        else
+        {
+            if (m_firstFree != kNone)
+            {
+                slot = m_firstFree;
+                m_firstFree = m_entries[slot].nextFree;
+            }
+            else
+            {
+                slot = static_cast<std::uint32_t>(m_entries.size());
+                m_entries.emplace_back();
+            }
+            m_entries[slot].name = name;
+            m_slots.emplace(name, slot);
+            Request(slot);
+        }
+
+        ++m_entries[slot].refCount;
+        return TextureRef(this, slot, m_epoch);
+    }
+
+    /**
+     * @brief Starts loading a new version, keeping the current full texture as the one viewed
+     * until FinishLoad() replaces it.
+     */
+    bool TextureManager::Reload(const std::string& name)
+    {
+        const auto found = m_slots.find(name);
+        if (found == m_slots.end())
+        {
+            return false;
+        }
+        const std::uint32_t slot = found->second;
+        Entry& entry = m_entries[slot];
+        if (entry.state == State::Decoding || entry.state == State::Uploading)
+        {
+            entry.dirty = true;
+            return true;
+        }
+
+        if (entry.lru)
+        {
+            Unlink(slot);
+        }
+        if (entry.state == State::Resident)
+        {
+            entry.previous = entry.texture;
+            entry.previousWidth = entry.width;
+            entry.previousHeight = entry.height;
+            entry.texture = 0;
+        }
+        entry.reloading = true;
+        Request(slot);
+        return true;
+    }
+
+    void TextureManager::Update(CommandList& commands)
+    {
+        POLARIS_PROFILE_SCOPE("TextureManager::Update");
+        Receive(commands);
+        UploadRows(commands);
+        Evict(commands);
+    }
+
+    TextureStats TextureManager::GetStats() const
+    {
+        TextureStats stats;
+        stats.residentBytes = m_residentBytes;
+        stats.memoryBudget = m_config.memoryBudget;
+        stats.residentTextures = m_residentTextures;
+        stats.placeholders = m_placeholders;
+        stats.pendingLoads = m_pendingLoads;
+        stats.loads = m_loads;
+        stats.failures = m_failures;
+        stats.evictions = m_evictions;
+        stats.reloads = m_reloads;
+        stats.uploadedBytes = m_uploadedBytes;
+        stats.averageLoadMilliseconds = m_loads > 0 ? m_totalLoadMilliseconds / static_cast<double>(m_loads) : 0.0;
+        stats.maxLoadMilliseconds = m_maxLoadMilliseconds;
+        return stats;
+    }
+
+    /**
+     * @brief Adds a reference, unless it predates the last Shutdown().
+     */
+    void TextureManager::AddRef(std::uint32_t slot, std::uint32_t epoch)
+    {
+        if (IsCurrent(slot, epoch))
+        {
+            ++m_entries[slot].refCount;
+        }
+    }
+
+    /**
+     * @brief Drops a reference. Textures nobody references join the eviction order once
+     * loaded; failed ones are forgotten, so that a later Load() tries again.
+     */
+    void TextureManager::Release(std::uint32_t slot, std::uint32_t epoch)
+    {
+        if (!IsCurrent(slot, epoch) || --m_entries[slot].refCount > 0)
+        {
+            return;
+        }
+        Entry& entry = m_entries[slot];
+        if (entry.state == State::Resident)
+        {
+            Link(m_unusedTextures, slot);
+        }
+        else if (entry.state == State::Failed)
+        {
+            FreeSlot(slot);
+        }
+    }
+
+    TextureView TextureManager::View(std::uint32_t slot, std::uint32_t epoch) const
+    {
+        TextureView view;
+        if (!IsCurrent(slot, epoch))
+        {
+            return view;
+        }
+        const Entry& entry = m_entries[slot];
+        view.width = entry.width;
+        view.height = entry.height;
+        view.failed = entry.state == State::Failed;
+        if (entry.state == State::Resident)
+        {
+            view.texture = entry.texture;
+            view.ready = true;
+        }
+        else if (entry.previous != 0)
+        {
+            view.texture = entry.previous;
+            view.width = entry.previousWidth;
+            view.height = entry.previousHeight;
+            view.ready = true;
+        }
+        else if (entry.placeholder != 0)
+        {
+            view.texture = entry.placeholder;
+            view.scaleX = static_cast<float>(entry.placeholderWidth) / static_cast<float>(entry.width);
+            view.scaleY = static_cast<float>(entry.placeholderHeight) / static_cast<float>(entry.height);
+        }
+        return view;
+    }
+
+    void TextureManager::Request(std::uint32_t slot)
+    {
+        Entry& entry = m_entries[slot];
+        entry.state = State::Decoding;
+        entry.requested = std::chrono::steady_clock::now();
+        ++m_pendingLoads;
+        {
+            std::lock_guard<std::mutex> lock(m_requestMutex);
+            m_requests.push_back({slot, entry.generation, entry.name});
+        }
+        m_requestReady.notify_one();
+    }
+
+    void TextureManager::DecodeMain()
+    {
+        POLARIS_PROFILE_THREAD("TextureDecode");
+        POLARIS_MEMORY_THREAD_TAG(Assets);
+
+        for (;;)
+        {
+            DecodeRequest request;
+            {
+                std::unique_lock<std::mutex> lock(m_requestMutex);
+                m_requestReady.wait(lock, [this]() { return m_stopping || !m_requests.empty(); });
+                if (m_stopping)
+                {
+                    return;
+                }
+                request = std::move(m_requests.front());
+                m_requests.pop_front();
+            }
+
+            DecodeResult result{request.slot, request.generation, nullptr, {}, 0, 0};
+            {
+                POLARIS_PROFILE_SCOPE("TextureManager::decode");
+                result.image = Decode(request.name);
+                if (result.image && m_config.placeholderSize > 0)
+                {
+                    Downsample(result.image, m_config.placeholderSize, result.placeholder,
+                               result.placeholderWidth, result.placeholderHeight);
+                }
+            }
+
+            std::lock_guard<std::mutex> lock(m_resultMutex);
+            m_results.push_back(std::move(result));
+        }
+    }
+
+    /**
+     * @brief Decodes an image from the asset pack if it has one by that name, else from disk.
+     * @return The image as RGBA32, or nullptr.
+     */
+    SDL_Surface* TextureManager::Decode(const std::string& name) const
+    {
+        SDL_Surface* loaded = nullptr;
+        if (m_config.assets && m_config.assets->contains(name))
+        {
+            // Stored images are decoded straight from the mapping; compressed ones need a copy
+            std::vector<std::uint8_t> buffer;
+            AssetData data = m_config.assets->view(name);
+            if (data.empty() && m_config.assets->read(name, buffer))
+            {
+                data = {buffer.data(), buffer.size()};
+            }
+            SDL_IOStream* stream = data.empty() ? nullptr : SDL_IOFromConstMem(data.data, data.size);
+            loaded = stream ? IMG_Load_IO(stream, true) : nullptr;
+        }
+        else
+        {
+            loaded = IMG_Load(name.c_str());
+        }
+        if (!loaded)
+        {
+            LOG_WARN("Failed to load texture {}: {}", name, SDL_GetError());
+            return nullptr;
+        }
+
+        SDL_Surface* image = SDL_ConvertSurface(loaded, SDL_PIXELFORMAT_RGBA32);
+        SDL_DestroySurface(loaded);
+        if (!image)
+        {
+            LOG_WARN("Failed to convert texture {}: {}", name, SDL_GetError());
+        }
+        return image;
+    }
+
+    /**
+     * @brief Takes the decoded images, uploads their placeholders and queues their full
+     * images for UploadRows().
+     */
+    void TextureManager::Receive(CommandList& commands)
+    {
+        {
+            std::lock_guard<std::mutex> lock(m_resultMutex);
+            m_received.swap(m_results);
+        }
+
+        for (DecodeResult& result : m_received)
+        {
+            Entry& entry = m_entries[result.slot];
+            if (entry.generation != result.generation || entry.state != State::Decoding)
+            {
+                if (result.image)
+                {
+                    SDL_DestroySurface(result.image);
+                }
+                continue;
+            }
+            if (!result.image)
+            {
+                FailLoad(result.slot, commands);
+                continue;
+            }
+
+            entry.width = result.image->w;
+            entry.height = result.image->h;
+            if (entry.reloading && entry.placeholder != 0)
+            {
+                // The placeholder of the earlier version
+                commands.DestroyTexture(entry.placeholder);
+                m_residentBytes -= TexelBytes(entry.placeholderWidth, entry.placeholderHeight);
+                --m_placeholders;
+                entry.placeholder = 0;
+            }
+            if (entry.placeholder == 0 && !result.placeholder.empty())
+            {
+                entry.placeholderWidth = result.placeholderWidth;
+                entry.placeholderHeight = result.placeholderHeight;
+                entry.placeholder = commands.CreateTexture(entry.placeholderWidth, entry.placeholderHeight,
+                                                           TextureAccess::Static, result.placeholder.data());
+                const std::size_t bytes = TexelBytes(entry.placeholderWidth, entry.placeholderHeight);
+                m_residentBytes += bytes;
+                m_uploadedBytes += bytes;
+                ++m_placeholders;
+            }
+            entry.pending = result.image;
+            entry.uploadedRows = 0;
+            entry.state = State::Uploading;
+            m_uploads.push_back(result.slot);
+        }
+        m_received.clear();
+    }
+
+    /**
+     * @brief Records bands of rows of the textures being uploaded, oldest first, until this
+     * frame's upload budget is spent. At least one row is recorded per frame.
+     */
+    void TextureManager::UploadRows(CommandList& commands)
+    {
+        std::size_t budget = m_config.uploadBytesPerFrame;
+        while (!m_uploads.empty() && budget > 0)
+        {
+            const std::uint32_t slot = m_uploads.front();
+            Entry& entry = m_entries[slot];
+            if (entry.texture == 0)
+            {
+                entry.texture = commands.CreateTexture(entry.width, entry.height, TextureAccess::Static);
+                m_residentBytes += TexelBytes(entry.width, entry.height);
+                ++m_residentTextures;
+            }
+
+            const std::size_t rowBytes = TexelBytes(entry.width, 1);
+            const int rows = static_cast<int>(std::min<std::size_t>(
+                static_cast<std::size_t>(entry.height - entry.uploadedRows), std::max<std::size_t>(budget / rowBytes, 1)));
+            const SDL_Rect region = {0, entry.uploadedRows, entry.width, rows};
+            const std::uint8_t* pixels = static_cast<const std::uint8_t*>(entry.pending->pixels);
+            commands.UpdateTexture(entry.texture, &region, pixels + entry.uploadedRows * entry.pending->pitch,
+                                   entry.pending->pitch, rows);
+            entry.uploadedRows += rows;
+            const std::size_t uploaded = rowBytes * static_cast<std::size_t>(rows);
+            budget -= std::min(budget, uploaded);
+            m_uploadedBytes += uploaded;
+
+            if (entry.uploadedRows == entry.height)
+            {
+                m_uploads.pop_front();
+                FinishLoad(slot, commands);
+            }
+        }
+    }
+
+    /**
+     * @brief Destroys unreferenced textures, least recently released first, while resident
+     * memory is over budget: every full image before any placeholder.
+     */
+    void TextureManager::Evict(CommandList& commands)
+    {
+        while (m_residentBytes > m_config.memoryBudget)
+        {
+            if (m_unusedTextures.head != kNone)
+            {
+                const std::uint32_t slot = m_unusedTextures.head;
+                Entry& entry = m_entries[slot];
+                Unlink(slot);
+                commands.DestroyTexture(entry.texture);
+                entry.texture = 0;
+                m_residentBytes -= TexelBytes(entry.width, entry.height);
+                --m_residentTextures;
+                ++m_evictions;
+                if (entry.placeholder != 0)
+                {
+                    entry.state = State::Evicted;
+                    Link(m_unusedPlaceholders, slot);
+                }
+                else
+                {
+                    FreeSlot(slot);
+                }
+            }
+            else if (m_unusedPlaceholders.head != kNone)
+            {
+                const std::uint32_t slot = m_unusedPlaceholders.head;
+                Entry& entry = m_entries[slot];
+                Unlink(slot);
+                commands.DestroyTexture(entry.placeholder);
+                entry.placeholder = 0;
+                m_residentBytes -= TexelBytes(entry.placeholderWidth, entry.placeholderHeight);
+                --m_placeholders;
+                ++m_evictions;
+                FreeSlot(slot);
+            }
+            else
+            {
+                break;
+            }
+        }
+    }
+
+    /**
+     * @brief Returns a slot without textures to the free list. Its generation changes, so a
+     * decode still in flight for it is recognisable as stale.
+     */
+    void TextureManager::FreeSlot(std::uint32_t slot)
+    {
+        Entry& entry = m_entries[slot];
+        m_slots.erase(entry.name);
+        const std::uint32_t generation = entry.generation + 1;
+        entry = Entry();
+        entry.generation = generation;
+        entry.nextFree = m_firstFree;
+        m_firstFree = slot;
+    }
+
+    /**
+     * @brief Makes a fully uploaded texture the one viewed, replacing any earlier version.
+     */
+    void TextureManager::FinishLoad(std::uint32_t slot, CommandList& commands)
+    {
+        Entry& entry = m_entries[slot];
+        SDL_DestroySurface(entry.pending);
+        entry.pending = nullptr;
+        entry.state = State::Resident;
+        if (entry.previous != 0)
+        {
+            commands.DestroyTexture(entry.previous);
+            m_residentBytes -= TexelBytes(entry.previousWidth, entry.previousHeight);
+            --m_residentTextures;
+            entry.previous = 0;
+        }
+        const bool reloaded = entry.reloading;
+        if (entry.reloading)
+        {
+            entry.reloading = false;
+            ++m_reloads;
+        }
+
+        const double milliseconds =
+            std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - entry.requested).count();
+        m_totalLoadMilliseconds += milliseconds;
+        m_maxLoadMilliseconds = std::max(m_maxLoadMilliseconds, milliseconds);
+        ++m_loads;
+        --m_pendingLoads;
+        // A file that changed again during the load is reported once its newest version is in
+        if (reloaded && !entry.dirty && m_reloadCallback)
+        {
+            m_reloadCallback(entry.name, true);
+        }
+
+        if (entry.dirty)
+        {
+            entry.dirty = false;
+            Reload(entry.name);
+        }
+        else if (entry.refCount == 0)
+        {
+            Link(m_unusedTextures, slot);
+        }
+    }
+
+    /**
+     * @brief Handles an image that could not be decoded. A reload falls back to the version
+     * already resident; otherwise the texture is marked failed, or forgotten if unreferenced.
+     */
+    void TextureManager::FailLoad(std::uint32_t slot, CommandList& commands)
+    {
+        Entry& entry = m_entries[slot];
+        --m_pendingLoads;
+        if (entry.dirty)
+        {
+            // The file changed again since this load started; it may be complete now
+            entry.dirty = false;
+            Request(slot);
+            return;
+        }
+        ++m_failures;
+        if (entry.reloading && m_reloadCallback)
+        {
+            m_reloadCallback(entry.name, false);
+        }
+        entry.reloading = false;
+
+        if (entry.previous != 0)
+        {
+            LOG_WARN("Keeping the previous version of texture {}", entry.name);
+            entry.texture = entry.previous;
+            entry.width = entry.previousWidth;
+            entry.height = entry.previousHeight;
+            entry.previous = 0;
+            entry.state = State::Resident;
+            if (entry.refCount == 0)
+            {
+                Link(m_unusedTextures, slot);
+            }
+            return;
+        }
+
+        if (entry.placeholder != 0)
+        {
+            commands.DestroyTexture(entry.placeholder);
+            m_residentBytes -= TexelBytes(entry.placeholderWidth, entry.placeholderHeight);
+            --m_placeholders;
+            entry.placeholder = 0;
+        }
+        entry.state = State::Failed;
+        if (entry.refCount == 0)
+        {
+            FreeSlot(slot);
+        }
+    }
+
+    void TextureManager::Link(LruList& list, std::uint32_t slot)
+    {
+        Entry& entry = m_entries[slot];
+        entry.lru = &list;
+        entry.lruPrev = list.tail;
+        entry.lruNext = kNone;
+        if (list.tail != kNone)
+        {
+            m_entries[list.tail].lruNext = slot;
+        }
+        else
+        {
+            list.head = slot;
+        }
+        list.tail = slot;
+    }
+
+    void TextureManager::Unlink(std::uint32_t slot)
+    {
+        Entry& entry = m_entries[slot];
+        LruList& list = *entry.lru;
+        if (entry.lruPrev != kNone)
+        {
+            m_entries[entry.lruPrev].lruNext = entry.lruNext;
+        }
+        else
+        {
+            list.head = entry.lruNext;
+        }
+        if (entry.lruNext != kNone)
+        {
+            m_entries[entry.lruNext].lruPrev = entry.lruPrev;
+        }
+        else
+        {
+            list.tail = entry.lruPrev;
+        }
+        entry.lru = nullptr;
+        entry.lruPrev = kNone;
+        entry.lruNext = kNone;
+    }
+}
@@ -0,0 +1,323 @@
+#pragma once
+
+#include "CommandList.h"
+#include <SDL3/SDL.h>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace polaris
+{
+    class AssetPack;
+    class TextureManager;
+
+    struct TextureManagerConfig
+    {
+#if defined(__ANDROID__)
+        std::size_t memoryBudget = 96 * 1024 * 1024;          ///< Bytes of texture memory kept resident.
+        std::size_t uploadBytesPerFrame = 4 * 1024 * 1024;    ///< Texel bytes recorded for upload per Update().
+#else
+        std::size_t memoryBudget = 512 * 1024 * 1024;
+        std::size_t uploadBytesPerFrame = 16 * 1024 * 1024;
+#endif
+        int decodeThreads = 2;        ///< Background threads decoding images.
+        int placeholderSize = 32;     ///< Largest side of the low-resolution placeholder; 0 disables placeholders.
+        const AssetPack* assets = nullptr;   ///< Pack searched for texture names before the file system.
+    };
+
+    /**
+     * @brief Texture memory and streaming activity. Counters are totals since Initialize().
+     */
+    struct TextureStats
+    {
+        std::size_t residentBytes = 0;        ///< Full textures and placeholders, 4 bytes per texel.
+        std::size_t memoryBudget = 0;
+        std::uint32_t residentTextures = 0;   ///< Full-resolution textures, complete or uploading.
+        std::uint32_t placeholders = 0;
+        std::uint32_t pendingLoads = 0;       ///< Queued, decoding or uploading.
+        std::uint64_t loads = 0;              ///< Textures that became fully resident.
+        std::uint64_t failures = 0;
+        std::uint64_t evictions = 0;          ///< Full textures and placeholders destroyed to stay within budget.
+        std::uint64_t reloads = 0;            ///< Textures replaced by a new version of their file.
+        std::uint64_t uploadedBytes = 0;
+        double averageLoadMilliseconds = 0.0; ///< From the first request to the last upload being recorded.
+        double maxLoadMilliseconds = 0.0;
+    };
+
+    /**
+     * @brief What to draw for a texture this frame.
+     *
+     * While the full image streams in, texture is its low-resolution placeholder and scale is
+     * less than 1: multiply source rectangles given in full-resolution texels by it (or use
+     * MapSource()). Before even the placeholder is available texture is 0, which draws a solid
+     * rectangle.
+     */
+    struct TextureView
+    {
+        TextureHandle texture = 0;
+        int width = 0;            ///< Size of the full image, once decoded.
+        int height = 0;
+        float scaleX = 1.0f;      ///< Texels of texture per texel of the full image.
+        float scaleY = 1.0f;
+        bool ready = false;       ///< texture is the full-resolution image.
+        bool failed = false;      ///< The image could not be loaded; texture stays 0.
+
+        /**
+         * @brief Converts a source rectangle in full-resolution texels to texels of texture.
+         */
+        SDL_FRect MapSource(const SDL_FRect& source) const
+        {
+            return {source.x * scaleX, source.y * scaleY, source.w * scaleX, source.h * scaleY};
+        }
+    };
+
+    /**
+     * @brief Counted reference to a managed texture. While any reference to it exists, a texture
+     * is never evicted. Copy, assign and destroy references only on the recording thread.
+     */
+    class TextureRef
+    {
+    public:
+        TextureRef() = default;
+        TextureRef(const TextureRef& other);
+        TextureRef(TextureRef&& other) noexcept;
+        TextureRef& operator=(const TextureRef& other);
+        TextureRef& operator=(TextureRef&& other) noexcept;
+        ~TextureRef();
+
+        bool IsValid() const { return m_manager != nullptr; }
+
+        /**
+         * @brief What to draw this frame; see TextureView.
+         */
+        TextureView View() const;
+
+        /**
+         * @brief Drops the reference.
+         */
+        void Reset();
+
+    private:
+        friend class TextureManager;
+
+        TextureRef(TextureManager* manager, std::uint32_t slot, std::uint32_t epoch)
+            : m_manager(manager), m_slot(slot), m_epoch(epoch) {}
+
+        TextureManager* m_manager = nullptr;
+        std::uint32_t m_slot = 0;
+        std::uint32_t m_epoch = 0;   ///< TextureManager::m_epoch when the reference was made.
+    };
+
+    /**
+     * @brief Streams textures in on demand and keeps their memory within a budget.
+     *
+     * Load() returns a reference at once and queues the image for decoding on background
+     * threads (SDL_image, from the asset pack or the file system). As soon as an image is
+     * decoded, a placeholder downsampled to at most placeholderSize texels is uploaded whole;
+     * the full image then follows in bands of rows, limited to uploadBytesPerFrame per
+     * Update() across all textures, so a burst of loads never stalls a frame. Until then
+     * references view the placeholder.
+     *
+     * Textures nobody references stay resident for reuse until resident memory exceeds the
+     * budget, and are then evicted least recently released first: the full image first, then,
+     * if that is not enough, its placeholder. Loading an evicted name again shows its kept
+     * placeholder while the image streams back in. Referenced textures are never evicted, so
+     * the budget can be exceeded by what is in use.
+     *
+     * Load(), Update() and references are for the thread recording frames; decoding is the
+     * only work done elsewhere.
+     */
+    class TextureManager
+    {
+    public:
+        TextureManager();
+        ~TextureManager();
+
+        TextureManager(const TextureManager&) = delete;
+        TextureManager& operator=(const TextureManager&) = delete;
+
+        /**
+         * @brief Starts the decode threads.
+         */
+        void Initialize(const TextureManagerConfig& config = TextureManagerConfig());
+
+        /**
+         * @brief Stops the decode threads and forgets every texture. Nothing is recorded: call
+         * it when the renderer, which destroys its own textures, is going away too. References
+         * still held afterwards view nothing, and releasing them has no effect.
+         */
+        void Shutdown();
+
+        /**
+         * @brief References a texture by name, queueing it for loading if it is not resident.
+         * @param name Asset pack name or file path of an image SDL_image can decode.
+         */
+        TextureRef Load(const std::string& name);
+
+        /**
+         * @brief Whether a texture by that name is loaded or loading.
+         */
+        bool Contains(const std::string& name) const { return m_slots.find(name) != m_slots.end(); }
+
+        /**
+         * @brief Loads a texture again, e.g. after its file changed. References keep viewing the
+         * current version until the new one is fully uploaded, and keep it if the new one fails
+         * to load. A texture that is still loading is loaded again once it finishes.
+         * @return false if no texture by that name is loaded.
+         */
+        bool Reload(const std::string& name);
+
+        /**
+         * @brief Called from Update() when a reload ends: loaded is true once the new version
+         * is fully uploaded and viewed, false if it failed and the current version stays.
+         */
+        using ReloadCallback = std::function<void(const std::string& name, bool loaded)>;
+        void SetReloadCallback(ReloadCallback callback) { m_reloadCallback = std::move(callback); }
+
+        /**
+         * @brief Records the creation and uploads of decoded textures, within the upload budget,
+         * and the destruction of evicted ones. Call once per frame before drawing.
+         */
+        void Update(CommandList& commands);
+
+        /**
+         * @brief Changes the budget, e.g. on a low-memory warning; takes effect on the next Update().
+         */
+        void SetMemoryBudget(std::size_t bytes) { m_config.memoryBudget = bytes; }
+
+        TextureStats GetStats() const;
+
+    private:
+        friend class TextureRef;
+
+        enum class State : std::uint8_t
+        {
+            Free,
+            Decoding,     ///< Queued or being decoded.
+            Uploading,    ///< Decoded; rows of pending are being uploaded into texture.
+            Resident,
+            Evicted,      ///< Only the placeholder is resident.
+            Failed
+        };
+
+        static constexpr std::uint32_t kNone = 0xFFFFFFFFu;
+
+        /**
+         * @brief Intrusive list of unreferenced entries through Entry::lruPrev/lruNext, oldest first.
+         */
+        struct LruList
+        {
+            std::uint32_t head = kNone;
+            std::uint32_t tail = kNone;
+        };
+
+        struct Entry
+        {
+            std::string name;
+            State state = State::Free;
+            std::uint32_t generation = 0;   ///< Incremented when the slot is freed, to ignore stale decodes.
+            int refCount = 0;
+            TextureHandle texture = 0;
+            TextureHandle placeholder = 0;
+            TextureHandle previous = 0;     ///< Version shown while a reload streams in.
+            int width = 0;
+            int height = 0;
+            int placeholderWidth = 0;
+            int placeholderHeight = 0;
+            int previousWidth = 0;
+            int previousHeight = 0;
+            bool reloading = false;         ///< The load in progress replaces an earlier version.
+            bool dirty = false;             ///< The file changed during the load in progress.
+            SDL_Surface* pending = nullptr; ///< Decoded RGBA32 image while Uploading.
+            int uploadedRows = 0;
+            std::chrono::steady_clock::time_point requested;
+            LruList* lru = nullptr;         ///< List the entry is in, if any.
+            std::uint32_t lruPrev = kNone;
+            std::uint32_t lruNext = kNone;
+            std::uint32_t nextFree = kNone;
+        };
+
+        struct DecodeRequest
+        {
+            std::uint32_t slot;
+            std::uint32_t generation;
+            std::string name;
+        };
+
+        struct DecodeResult
+        {
+            std::uint32_t slot;
+            std::uint32_t generation;
+            SDL_Surface* image;                    ///< nullptr if decoding failed.
+            std::vector<std::uint8_t> placeholder; ///< Tightly packed RGBA; empty if the image is already small enough.
+            int placeholderWidth;
+            int placeholderHeight;
+        };
+
+        bool IsCurrent(std::uint32_t slot, std::uint32_t epoch) const
+        {
+            return epoch == m_epoch && slot < m_entries.size();
+        }
+        void AddRef(std::uint32_t slot, std::uint32_t epoch);
+        void Release(std::uint32_t slot, std::uint32_t epoch);
+        TextureView View(std::uint32_t slot, std::uint32_t epoch) const;
+
+        void Request(std::uint32_t slot);
+        void DecodeMain();
+        SDL_Surface* Decode(const std::string& name) const;
+
+        void Receive(CommandList& commands);
+        void UploadRows(CommandList& commands);
+        void Evict(CommandList& commands);
+        void FreeSlot(std::uint32_t slot);
+        void FinishLoad(std::uint32_t slot, CommandList& commands);
+        void FailLoad(std::uint32_t slot, CommandList& commands);
+
+        void Link(LruList& list, std::uint32_t slot);
+        void Unlink(std::uint32_t slot);
+
+        TextureManagerConfig m_config;
+        std::vector<Entry> m_entries;
+        /**
+         * @brief Incremented by Shutdown(), so that references from before it, whose slots may
+         * be reused by new entries, are ignored.
+         */
+        std::uint32_t m_epoch;
+        std::uint32_t m_firstFree;
+        std::unordered_map<std::string, std::uint32_t> m_slots;
+        ReloadCallback m_reloadCallback;
+        LruList m_unusedTextures;       ///< Unreferenced Resident entries.
+        LruList m_unusedPlaceholders;   ///< Unreferenced Evicted entries.
+        std::deque<std::uint32_t> m_uploads;   ///< Uploading entries, in the order they were decoded.
+
+        std::vector<std::thread> m_threads;
+        std::mutex m_requestMutex;
+        std::condition_variable m_requestReady;
+        std::deque<DecodeRequest> m_requests;
+        bool m_stopping;
+        std::mutex m_resultMutex;
+        std::vector<DecodeResult> m_results;
+        std::vector<DecodeResult> m_received;  ///< Swapped with m_results by Update(), keeping both allocations.
+
+        std::size_t m_residentBytes;
+        std::uint32_t m_residentTextures;
+        std::uint32_t m_placeholders;
+        std::uint32_t m_pendingLoads;
+        std::uint64_t m_loads;
+        std::uint64_t m_failures;
+        std::uint64_t m_evictions;
+        std::uint64_t m_reloads;
+        std::uint64_t m_uploadedBytes;
+        double m_totalLoadMilliseconds;
+        double m_maxLoadMilliseconds;
+    };
+}
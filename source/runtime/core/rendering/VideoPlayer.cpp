@@ -0,0 +1,641 @@
+#include "VideoPlayer.h"
+
+#include "Logger.h"
+#include "memory/MemoryTracker.h"
+#include "profiling/Profiler.h"
+#include <algorithm>
+#include <limits>
+
+extern "C"
+{
+#include <libavcodec/avcodec.h>
+#include <libavformat/avformat.h>
+#include <libavutil/avutil.h>
+}
+
+namespace polaris
+{
+    namespace
+    {
+        /**
+         * @brief How late the shown frame may be, in seconds, before the decoder starts skipping frames.
+         */
+        constexpr double kLateThreshold = 0.1;
+
+        std::string ErrorString(int error)
+        {
+            char buffer[128];
+            if (av_strerror(error, buffer, sizeof(buffer)) < 0)
+            {
+                return "unknown error " + std::to_string(error);
+            }
+            return buffer;
+        }
+
+        std::uint64_t ElapsedNanoseconds(std::chrono::steady_clock::time_point start)
+        {
+            return static_cast<std::uint64_t>(
+                std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count());
+        }
+    }
+
+    VideoPlayer::VideoPlayer()
+        : m_format(nullptr),
+          m_codec(nullptr),
+          m_stream(-1),
+          m_timeBase(0.0),
+          m_startPts(0),
+          m_stopping(false),
+          m_seekRequested(false),
+          m_serial(0),
+          m_seekTarget(0.0),
+          m_lagging(false),
+          m_texture(0),
+          m_playing(false),
+          m_finished(false),
+          m_waitingForFrame(true),
+          m_clockBase(0.0),
+          m_position(0.0),
+          m_packetsRead(0),
+          m_framesDecoded(0),
+          m_decodeNanoseconds(0),
+          m_framesShown(0),
+          m_framesDropped(0)
+    {
+    }
+
+    /**
+     * @brief Stops the threads and frees FFmpeg state. The texture can only be released by Close().
+     */
+    VideoPlayer::~VideoPlayer()
+    {
+        Stop();
+    }
+
+    /**
+     * @brief Opens the container and decoder, allocates the packet and frame pools and starts
+     * the demux and decode threads.
+     */
+    bool VideoPlayer::Open(const std::string& path, const VideoPlayerConfig& config)
+    {
+        POLARIS_MEMORY_SCOPE(Assets);
+        if (m_format)
+        {
+            LOG_ERROR("Cannot open video {}: another video is open", path);
+            return false;
+        }
+        m_config = config;
+
+        int result = avformat_open_input(&m_format, path.c_str(), nullptr, nullptr);
+        if (result < 0)
+        {
+            LOG_ERROR("Failed to open video {}: {}", path, ErrorString(result));
+            m_format = nullptr;
+            return false;
+        }
+        result = avformat_find_stream_info(m_format, nullptr);
+        if (result < 0)
+        {
+            LOG_ERROR("Failed to read stream info of {}: {}", path, ErrorString(result));
+            Stop();
+            return false;
+        }
+
+        const AVCodec* decoder = nullptr;
+        m_stream = av_find_best_stream(m_format, AVMEDIA_TYPE_VIDEO, -1, -1, &decoder, 0);
+        if (m_stream < 0 || !decoder)
+        {
+            LOG_ERROR("No decodable video stream in {}", path);
+            Stop();
+            return false;
+        }
+        const AVStream* stream = m_format->streams[m_stream];
+
+        m_codec = avcodec_alloc_context3(decoder);
+        if (!m_codec || avcodec_parameters_to_context(m_codec, stream->codecpar) < 0)
+        {
+            LOG_ERROR("Failed to set up the {} decoder for {}", decoder->name, path);
+            Stop();
+            return false;
+        }
+        m_codec->thread_count = std::max(config.decodeThreads, 0);
+        m_codec->thread_type = FF_THREAD_FRAME | FF_THREAD_SLICE;
+        m_codec->pkt_timebase = stream->time_base;
+        result = avcodec_open2(m_codec, decoder, nullptr);
+        if (result < 0)
+        {
+            LOG_ERROR("Failed to open the {} decoder for {}: {}", decoder->name, path, ErrorString(result));
+            Stop();
+            return false;
+        }
+
+        switch (m_codec->pix_fmt)
+        {
+            case AV_PIX_FMT_YUV420P:
+            case AV_PIX_FMT_YUVJ420P:
+                m_info.format = TextureFormat::IYUV;
+                break;
+            case AV_PIX_FMT_NV12:
+                m_info.format = TextureFormat::NV12;
+                break;
+            default:
+            {
+                const char* name = av_get_pix_fmt_name(m_codec->pix_fmt);
+                LOG_ERROR("Unsupported pixel format {} in {}", name ? name : "unknown", path);
+                Stop();
+                return false;
+            }
+        }
+
+        // Streams that do not say are assumed to follow the usual SD/HD conventions, as players do.
+        const bool fullRange = m_codec->color_range == AVCOL_RANGE_JPEG || m_codec->pix_fmt == AV_PIX_FMT_YUVJ420P;
+        bool bt709 = m_codec->height >= 720;
+        switch (m_codec->colorspace)
+        {
+            case AVCOL_SPC_BT709:
+                bt709 = true;
+                break;
+            case AVCOL_SPC_BT470BG:
+            case AVCOL_SPC_SMPTE170M:
+            case AVCOL_SPC_FCC:
+                bt709 = false;
+                break;
+            default:
+                break;
+        }
+        m_info.colorspace = bt709 ? (fullRange ? YUVColorspace::BT709Full : YUVColorspace::BT709Limited)
+                                  : (fullRange ? YUVColorspace::BT601Full : YUVColorspace::BT601Limited);
+
+        m_timeBase = av_q2d(stream->time_base);
+        m_startPts = stream->start_time != AV_NOPTS_VALUE ? stream->start_time : 0;
+        m_info.width = m_codec->width;
+        m_info.height = m_codec->height;
+        m_info.codec = decoder->name;
+        m_info.frameRate = stream->avg_frame_rate.den != 0 ? av_q2d(stream->avg_frame_rate) : 0.0;
+        if (stream->duration != AV_NOPTS_VALUE)
+        {
+            m_info.duration = static_cast<double>(stream->duration) * m_timeBase;
+        }
+        else if (m_format->duration != AV_NOPTS_VALUE)
+        {
+            m_info.duration = static_cast<double>(m_format->duration) / AV_TIME_BASE;
+        }
+
+        const std::size_t packetCount = static_cast<std::size_t>(std::max(config.packetQueueSize, 1));
+        const std::size_t frameCount = static_cast<std::size_t>(std::max(config.frameQueueSize, 1));
+        m_freePackets = std::make_unique<BoundedQueue<AVPacket*>>(packetCount);
+        m_packetQueue = std::make_unique<BoundedQueue<PacketItem>>(packetCount);
+        m_freeFrames = std::make_unique<BoundedQueue<AVFrame*>>(frameCount);
+        m_frameQueue = std::make_unique<BoundedQueue<FrameItem>>(frameCount);
+        for (std::size_t i = 0; i < packetCount; ++i)
+        {
+            m_packets.push_back(av_packet_alloc());
+            m_freePackets->tryPush(m_packets.back());
+        }
+        for (std::size_t i = 0; i < frameCount; ++i)
+        {
+            m_frames.push_back(av_frame_alloc());
+            m_freeFrames->tryPush(m_frames.back());
+        }
+
+        m_stopping = false;
+        m_seekRequested = false;
+        m_serial = 0;
+        m_seekTarget = 0.0;
+        m_lagging = false;
+        m_playing = false;
+        m_finished = false;
+        m_waitingForFrame = true;
+        m_clockBase = 0.0;
+        m_position = 0.0;
+        m_demuxThread = std::thread(&VideoPlayer::DemuxMain, this);
+        m_decodeThread = std::thread(&VideoPlayer::DecodeMain, this);
+
+        LOG_INFO("Opened video {}: {}x{} {}, {:.2f} fps, {:.1f} s", path, m_info.width, m_info.height,
+                 m_info.codec, m_info.frameRate, m_info.duration);
+        return true;
+    }
+
+    void VideoPlayer::Close(CommandList& commands)
+    {
+        Stop();
+        if (m_texture != 0)
+        {
+            commands.DestroyTexture(m_texture);
+            m_texture = 0;
+        }
+        m_info = VideoInfo();
+    }
+
+    void VideoPlayer::Play()
+    {
+        if (!m_playing)
+        {
+            m_clockStart = std::chrono::steady_clock::now();
+            m_playing = true;
+        }
+    }
+
+    void VideoPlayer::Pause()
+    {
+        if (m_playing)
+        {
+            m_clockBase = GetClock();
+            m_playing = false;
+        }
+    }
+
+    /**
+     * @brief Starts a new serial: the demux thread seeks and discards queued packets, the decode
+     * thread flushes when it sees the new serial, and frames of older serials are dropped here.
+     */
+    void VideoPlayer::Seek(double seconds)
+    {
+        if (!m_format)
+        {
+            return;
+        }
+        seconds = std::max(seconds, 0.0);
+        m_seekTarget = seconds;
+        ++m_serial;
+        {
+            std::lock_guard<std::mutex> lock(m_controlMutex);
+            m_seekRequested = true;
+        }
+        m_controlChanged.notify_one();
+
+        m_frameQueue->drain([this](const FrameItem& item) {
+            if (item.frame)
+            {
+                Recycle(item.frame);
+            }
+        });
+        m_clockBase = seconds;
+        m_position = seconds;
+        m_waitingForFrame = true;
+        m_finished = false;
+        m_lagging = false;
+    }
+
+    void VideoPlayer::SetMasterClock(std::function<double()> clock)
+    {
+        m_masterClock = std::move(clock);
+    }
+
+    /**
+     * @brief Takes every queued frame that is due, keeps the newest and uploads it.
+     */
+    void VideoPlayer::Update(CommandList& commands)
+    {
+        if (!m_format)
+        {
+            return;
+        }
+        POLARIS_PROFILE_SCOPE("VideoPlayer::Update");
+        if (m_texture == 0)
+        {
+            m_texture = commands.CreateTexture(m_info.width, m_info.height, m_info.format, TextureAccess::Streaming,
+                                               m_info.colorspace);
+        }
+
+        const int serial = m_serial.load();
+        FrameItem shown = {nullptr, 0.0, serial};
+        FrameItem item;
+        while (m_frameQueue->tryPeek(item))
+        {
+            if (item.serial != serial)
+            {
+                m_frameQueue->tryPop(item);
+                if (item.frame)
+                {
+                    Recycle(item.frame);
+                }
+                continue;
+            }
+            if (!item.frame)
+            {
+                m_frameQueue->tryPop(item);
+                if (m_config.loop)
+                {
+                    Seek(0.0);
+                }
+                else
+                {
+                    m_finished = true;
+                }
+                break;
+            }
+
+            if (m_waitingForFrame)
+            {
+                m_clockBase = item.time;
+                m_clockStart = std::chrono::steady_clock::now();
+                m_waitingForFrame = false;
+            }
+            if (m_config.syncToClock && item.time > GetClock())
+            {
+                break;
+            }
+
+            m_frameQueue->tryPop(item);
+            if (shown.frame)
+            {
+                Recycle(shown.frame);
+                ++m_framesDropped;
+            }
+            shown = item;
+            if (!m_config.syncToClock)
+            {
+                break;
+            }
+        }
+
+        if (shown.frame)
+        {
+            Upload(shown.frame, commands);
+            Recycle(shown.frame);
+            m_position = shown.time;
+            ++m_framesShown;
+            m_lagging.store(m_config.syncToClock && GetClock() - shown.time > kLateThreshold, std::memory_order_relaxed);
+        }
+    }
+
+    VideoStats VideoPlayer::TakeStats()
+    {
+        VideoStats stats;
+        stats.packetsRead = m_packetsRead.exchange(0);
+        stats.framesDecoded = m_framesDecoded.exchange(0);
+        stats.decodeSeconds = static_cast<double>(m_decodeNanoseconds.exchange(0)) * 1e-9;
+        stats.framesShown = m_framesShown;
+        stats.framesDropped = m_framesDropped;
+        m_framesShown = 0;
+        m_framesDropped = 0;
+        return stats;
+    }
+
+    /**
+     * @brief Closes the queues so blocked threads return, joins them and frees everything
+     * Open() allocated. Safe to call when nothing is open.
+     */
+    void VideoPlayer::Stop()
+    {
+        if (m_demuxThread.joinable() || m_decodeThread.joinable())
+        {
+            {
+                std::lock_guard<std::mutex> lock(m_controlMutex);
+                m_stopping = true;
+            }
+            m_controlChanged.notify_all();
+            m_freePackets->close();
+            m_packetQueue->close();
+            m_freeFrames->close();
+            m_frameQueue->close();
+            m_demuxThread.join();
+            m_decodeThread.join();
+        }
+
+        for (AVPacket*& packet : m_packets)
+        {
+            av_packet_free(&packet);
+        }
+        for (AVFrame*& frame : m_frames)
+        {
+            av_frame_free(&frame);
+        }
+        m_packets.clear();
+        m_frames.clear();
+        m_freePackets.reset();
+        m_packetQueue.reset();
+        m_freeFrames.reset();
+        m_frameQueue.reset();
+        if (m_codec)
+        {
+            avcodec_free_context(&m_codec);
+        }
+        if (m_format)
+        {
+            avformat_close_input(&m_format);
+        }
+        m_stream = -1;
+        m_playing = false;
+    }
+
+    /**
+     * @brief Demux thread: reads packets of the video stream into the packet queue, handling
+     * seeks between reads. At the end of the stream it queues an end marker and sleeps until
+     * the next seek.
+     */
+    void VideoPlayer::DemuxMain()
+    {
+        POLARIS_PROFILE_THREAD("VideoDemux");
+        POLARIS_MEMORY_THREAD_TAG(Assets);
+        int serial = m_serial.load();
+
+        while (!m_stopping)
+        {
+            if (m_seekRequested.exchange(false))
+            {
+                serial = m_serial.load();
+                const std::int64_t timestamp = m_startPts + static_cast<std::int64_t>(m_seekTarget.load() / m_timeBase);
+                const int result = av_seek_frame(m_format, m_stream, timestamp, AVSEEK_FLAG_BACKWARD);
+                if (result < 0)
+                {
+                    LOG_WARN("Video seek failed: {}", ErrorString(result));
+                }
+                m_packetQueue->drain([this](const PacketItem& item) {
+                    if (item.packet)
+                    {
+                        av_packet_unref(item.packet);
+                        m_freePackets->tryPush(item.packet);
+                    }
+                });
+            }
+
+            AVPacket* packet = nullptr;
+            if (!m_freePackets->pop(packet))
+            {
+                break;
+            }
+            const int result = av_read_frame(m_format, packet);
+            if (result < 0)
+            {
+                m_freePackets->tryPush(packet);
+                if (result != AVERROR_EOF)
+                {
+                    LOG_ERROR("Video read failed: {}", ErrorString(result));
+                }
+                if (!m_packetQueue->push({nullptr, serial}))
+                {
+                    break;
+                }
+                std::unique_lock<std::mutex> lock(m_controlMutex);
+                m_controlChanged.wait(lock, [this]() { return m_stopping.load() || m_seekRequested.load(); });
+                continue;
+            }
+
+            if (packet->stream_index != m_stream)
+            {
+                av_packet_unref(packet);
+                m_freePackets->tryPush(packet);
+                continue;
+            }
+            ++m_packetsRead;
+            if (!m_packetQueue->push({packet, serial}))
+            {
+                av_packet_unref(packet);
+                break;
+            }
+        }
+    }
+
+    /**
+     * @brief Decode thread: feeds packets of the current serial to the decoder and queues the
+     * frames it returns. A new serial flushes the decoder, and frames before the seek target
+     * are decoded but not queued.
+     */
+    void VideoPlayer::DecodeMain()
+    {
+        POLARIS_PROFILE_THREAD("VideoDecode");
+        POLARIS_MEMORY_THREAD_TAG(Assets);
+        int decoderSerial = m_serial.load();
+        double skipUntil = -std::numeric_limits<double>::infinity();
+        double lastTime = 0.0;
+
+        PacketItem item;
+        while (m_packetQueue->pop(item))
+        {
+            if (item.serial != m_serial.load())
+            {
+                if (item.packet)
+                {
+                    av_packet_unref(item.packet);
+                    m_freePackets->tryPush(item.packet);
+                }
+                continue;
+            }
+            if (item.serial != decoderSerial)
+            {
+                avcodec_flush_buffers(m_codec);
+                decoderSerial = item.serial;
+                skipUntil = m_seekTarget.load();
+            }
+
+            // Catch up by dropping frames nothing else depends on, before they are decoded
+            m_codec->skip_frame = m_lagging.load(std::memory_order_relaxed) ? AVDISCARD_NONREF : AVDISCARD_DEFAULT;
+
+            const std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+            const int result = avcodec_send_packet(m_codec, item.packet);
+            m_decodeNanoseconds += ElapsedNanoseconds(start);
+            if (item.packet)
+            {
+                av_packet_unref(item.packet);
+                m_freePackets->tryPush(item.packet);
+            }
+            if (result < 0 && result != AVERROR(EAGAIN) && result != AVERROR_EOF)
+            {
+                LOG_WARN("Video decode error: {}", ErrorString(result));
+            }
+
+            if (!ReceiveFrames(decoderSerial, skipUntil, lastTime))
+            {
+                break;
+            }
+            if (!item.packet)
+            {
+                // Fully drained; the decoder needs a flush before it accepts packets again
+                avcodec_flush_buffers(m_codec);
+                if (!m_frameQueue->push({nullptr, lastTime, decoderSerial}))
+                {
+                    break;
+                }
+            }
+        }
+    }
+
+    /**
+     * @brief Moves every frame the decoder has ready into the frame queue, waiting for free
+     * frames as needed.
+     * @return false if the player is stopping.
+     */
+    bool VideoPlayer::ReceiveFrames(int serial, double skipUntil, double& lastTime)
+    {
+        const double frameDuration = m_info.frameRate > 0.0 ? 1.0 / m_info.frameRate : 0.0;
+        for (;;)
+        {
+            AVFrame* frame = nullptr;
+            if (!m_freeFrames->pop(frame))
+            {
+                return false;
+            }
+            const std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+            const int result = avcodec_receive_frame(m_codec, frame);
+            m_decodeNanoseconds += ElapsedNanoseconds(start);
+            if (result < 0)
+            {
+                m_freeFrames->tryPush(frame);
+                if (result != AVERROR(EAGAIN) && result != AVERROR_EOF)
+                {
+                    LOG_WARN("Video decode error: {}", ErrorString(result));
+                }
+                return true;
+            }
+            ++m_framesDecoded;
+
+            const std::int64_t pts = frame->best_effort_timestamp;
+            const double time = pts != AV_NOPTS_VALUE ? static_cast<double>(pts - m_startPts) * m_timeBase
+                                                      : lastTime + frameDuration;
+            lastTime = time;
+            if (time + frameDuration * 0.5 < skipUntil)
+            {
+                Recycle(frame);
+                continue;
+            }
+            if (!m_frameQueue->push({frame, time, serial}))
+            {
+                av_frame_unref(frame);
+                return false;
+            }
+        }
+    }
+
+    double VideoPlayer::GetClock() const
+    {
+        if (m_masterClock)
+        {
+            return m_masterClock();
+        }
+        if (!m_playing || m_waitingForFrame)
+        {
+            return m_clockBase;
+        }
+        return m_clockBase + std::chrono::duration<double>(std::chrono::steady_clock::now() - m_clockStart).count();
+    }
+
+    /**
+     * @brief Releases the frame's picture back to the decoder's buffer pool and the frame to ours.
+     */
+    void VideoPlayer::Recycle(AVFrame* frame)
+    {
+        av_frame_unref(frame);
+        m_freeFrames->tryPush(frame);
+    }
+
+    /**
+     * @brief Records the frame's planes into the texture as they are, without conversion.
+     */
+    void VideoPlayer::Upload(const AVFrame* frame, CommandList& commands)
+    {
+        const int width = std::min(frame->width, m_info.width);
+        const int height = std::min(frame->height, m_info.height);
+        if (m_info.format == TextureFormat::NV12)
+        {
+            commands.UpdateTextureNV(m_texture, width, height, frame->data[0], frame->linesize[0],
+                                     frame->data[1], frame->linesize[1]);
+        }
+        else
+        {
+            commands.UpdateTextureYUV(m_texture, width, height, frame->data[0], frame->linesize[0],
+                                      frame->data[1], frame->linesize[1], frame->data[2], frame->linesize[2]);
+        }
+    }
+}
@@ -0,0 +1,204 @@
+#pragma once
+
+#include "CommandList.h"
+#include "jobs/BoundedQueue.h"
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+struct AVCodecContext;
+struct AVFormatContext;
+struct AVFrame;
+struct AVPacket;
+
+namespace polaris
+{
+    struct VideoPlayerConfig
+    {
+        int packetQueueSize = 64;     ///< Demuxed packets buffered ahead of the decoder.
+        int frameQueueSize = 6;       ///< Decoded frames buffered ahead of display, which is also the frame pool size.
+        int decodeThreads = 0;        ///< FFmpeg decoder threads; 0 lets FFmpeg pick one per core.
+        bool syncToClock = true;      ///< false shows every frame, one per Update(), as soon as it is decoded.
+        bool loop = false;            ///< Seek back to the start at the end of the stream.
+    };
+
+    struct VideoInfo
+    {
+        int width = 0;
+        int height = 0;
+        double duration = 0.0;        ///< Seconds; 0 if unknown.
+        double frameRate = 0.0;       ///< Average frames per second; 0 if unknown.
+        std::string codec;
+        TextureFormat format = TextureFormat::IYUV;   ///< Format of GetTexture(), matching the decoder output.
+        YUVColorspace colorspace = YUVColorspace::BT601Limited;   ///< Matrix and range the stream is encoded with.
+    };
+
+    /**
+     * @brief Playback activity since the stats were last taken.
+     */
+    struct VideoStats
+    {
+        std::uint64_t packetsRead = 0;
+        std::uint64_t framesDecoded = 0;
+        std::uint64_t framesShown = 0;
+        std::uint64_t framesDropped = 0;   ///< Decoded frames that were already late when a later one was due.
+        double decodeSeconds = 0.0;        ///< Time the decode thread spent inside FFmpeg.
+    };
+
+    /**
+     * @brief Plays a video file into a streaming texture, decoding with FFmpeg.
+     *
+     * A demux thread reads packets into a bounded queue and a decode thread turns them into
+     * frames in a second bounded queue, so the file is read and decoded ahead of display
+     * without the main loop ever waiting. Packets and frames come from pools allocated by
+     * Open(); decoded pictures live in FFmpeg's own buffer pool, so steady-state playback does
+     * not allocate frames.
+     *
+     * Update(), called once per frame while recording, shows the newest frame that is due at
+     * the playback clock and drops older ones, then records its planes as-is into an IYUV or
+     * NV12 texture (see CommandList::UpdateTextureYUV). When the shown frame is late, the
+     * decoder skips non-reference frames until playback catches up. The clock is wall time
+     * from the first frame, or a master clock such as the audio position (SetMasterClock).
+     *
+     * Only 8-bit 4:2:0 output (YUV420P, NV12) is supported, which covers H.264 and most
+     * H.265/VP9/AV1 content. All methods are for the thread recording frames.
+     */
+    class VideoPlayer
+    {
+    public:
+        VideoPlayer();
+        ~VideoPlayer();
+
+        VideoPlayer(const VideoPlayer&) = delete;
+        VideoPlayer& operator=(const VideoPlayer&) = delete;
+
+        /**
+         * @brief Opens a file and starts reading and decoding it. Playback starts paused on
+         * the first frame; call Play(). Probing the file blocks, so open at load time.
+         * @return false if the file cannot be opened, has no video or needs an unsupported
+         * pixel format, or a video is already open.
+         */
+        bool Open(const std::string& path, const VideoPlayerConfig& config = VideoPlayerConfig());
+
+        /**
+         * @brief Stops the threads, closes the file and records the destruction of the texture.
+         */
+        void Close(CommandList& commands);
+
+        bool IsOpen() const { return m_format != nullptr; }
+
+        void Play();
+        void Pause();
+        bool IsPlaying() const { return m_playing; }
+
+        /**
+         * @brief Jumps to a time in seconds. Frames already buffered are discarded and the first
+         * frame at or after the target is shown once decoded.
+         */
+        void Seek(double seconds);
+
+        /**
+         * @brief True once the last frame has been shown, unless looping.
+         */
+        bool IsFinished() const { return m_finished; }
+
+        /**
+         * @brief Drives playback from an external clock returning the stream time in seconds,
+         * e.g. the audio position; an empty function restores the wall clock.
+         */
+        void SetMasterClock(std::function<double()> clock);
+
+        /**
+         * @brief Shows the frame due at the playback clock, recording its upload (and, the first
+         * time, the creation of the texture). Never blocks.
+         */
+        void Update(CommandList& commands);
+
+        /**
+         * @brief The streaming texture frames are shown in; 0 before the first Update().
+         */
+        TextureHandle GetTexture() const { return m_texture; }
+
+        /**
+         * @brief Time in seconds of the frame last shown.
+         */
+        double GetPosition() const { return m_position; }
+
+        const VideoInfo& GetInfo() const { return m_info; }
+
+        /**
+         * @brief Returns the counters accumulated since the last call and resets them.
+         */
+        VideoStats TakeStats();
+
+    private:
+        struct PacketItem
+        {
+            AVPacket* packet;   ///< nullptr marks the end of the stream.
+            int serial;         ///< Seek generation the packet was read in.
+        };
+
+        struct FrameItem
+        {
+            AVFrame* frame;     ///< nullptr marks the end of the stream.
+            double time;        ///< Seconds from the start of the stream.
+            int serial;
+        };
+
+        void Stop();
+        void DemuxMain();
+        void DecodeMain();
+        bool ReceiveFrames(int serial, double skipUntil, double& lastTime);
+        double GetClock() const;
+        void Recycle(AVFrame* frame);
+        void Upload(const AVFrame* frame, CommandList& commands);
+
+        VideoPlayerConfig m_config;
+        VideoInfo m_info;
+        AVFormatContext* m_format;
+        AVCodecContext* m_codec;
+        int m_stream;
+        double m_timeBase;          ///< Seconds per stream timestamp unit.
+        std::int64_t m_startPts;    ///< Timestamp of the start of the stream.
+
+        std::vector<AVPacket*> m_packets;   ///< Every pooled packet, for freeing.
+        std::vector<AVFrame*> m_frames;     ///< Every pooled frame, for freeing.
+        std::unique_ptr<BoundedQueue<AVPacket*>> m_freePackets;
+        std::unique_ptr<BoundedQueue<PacketItem>> m_packetQueue;
+        std::unique_ptr<BoundedQueue<AVFrame*>> m_freeFrames;
+        std::unique_ptr<BoundedQueue<FrameItem>> m_frameQueue;
+        std::thread m_demuxThread;
+        std::thread m_decodeThread;
+
+        /// Wakes the demux thread when it is idle at the end of the stream.
+        std::mutex m_controlMutex;
+        std::condition_variable m_controlChanged;
+        std::atomic<bool> m_stopping;
+        std::atomic<bool> m_seekRequested;
+        std::atomic<int> m_serial;
+        std::atomic<double> m_seekTarget;
+        std::atomic<bool> m_lagging;        ///< Set by Update() when shown frames are late.
+
+        TextureHandle m_texture;
+        bool m_playing;
+        bool m_finished;
+        bool m_waitingForFrame;             ///< The clock holds until the first frame after Open() or Seek().
+        double m_clockBase;
+        std::chrono::steady_clock::time_point m_clockStart;
+        double m_position;
+        std::function<double()> m_masterClock;
+
+        std::atomic<std::uint64_t> m_packetsRead;
+        std::atomic<std::uint64_t> m_framesDecoded;
+        std::atomic<std::uint64_t> m_decodeNanoseconds;
+        std::uint64_t m_framesShown;
+        std::uint64_t m_framesDropped;
+    };
+}
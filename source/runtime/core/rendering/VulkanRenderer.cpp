@@ -0,0 +1,2346 @@
+#include "VulkanRenderer.h"
+
+#include "SpriteBatch.h"
+#include "Logger.h"
+#include "profiling/Profiler.h"
+#include <SDL3/SDL_vulkan.h>
+#include <vulkan/vulkan.h>
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace polaris
+{
+    namespace
+    {
+        // SPIR-V compiled from shaders/ by glslc at build time (see CMakeLists.txt)
+        const std::uint32_t kSpriteVertexShader[] = {
+#include "sprite.vert.spv.h"
+        };
+        const std::uint32_t kSpriteFragmentShader[] = {
+#include "sprite.frag.spv.h"
+        };
+
+        constexpr VkFormat kTextureFormat = VK_FORMAT_R8G8B8A8_UNORM;
+        constexpr int kBlendModeCount = 4;
+        constexpr int kMaxTextureSize = 16384;
+        constexpr std::uint32_t kTexturesPerDescriptorPool = 256;
+        constexpr VkDeviceSize kRingGranularity = 64 * 1024;
+        constexpr VkDeviceSize kVertexAlignment = 16;
+
+        /**
+         * @brief Pipelines exist for two colour formats: textures (and the offscreen framebuffer)
+         * and the swapchain.
+         */
+        enum FormatSlot
+        {
+            kTextureSlot,
+            kSwapchainSlot,
+            kFormatSlotCount
+        };
+
+        /**
+         * @brief The uniform block of shaders/sprite.vert, mapping target pixels to clip space.
+         */
+        struct View
+        {
+            float scale[2];
+            float offset[2];
+        };
+
+        const char* ResultName(VkResult result)
+        {
+            switch (result)
+            {
+                case VK_SUCCESS: return "VK_SUCCESS";
+                case VK_NOT_READY: return "VK_NOT_READY";
+                case VK_TIMEOUT: return "VK_TIMEOUT";
+                case VK_SUBOPTIMAL_KHR: return "VK_SUBOPTIMAL_KHR";
+                case VK_ERROR_OUT_OF_HOST_MEMORY: return "VK_ERROR_OUT_OF_HOST_MEMORY";
+                case VK_ERROR_OUT_OF_DEVICE_MEMORY: return "VK_ERROR_OUT_OF_DEVICE_MEMORY";
+                case VK_ERROR_INITIALIZATION_FAILED: return "VK_ERROR_INITIALIZATION_FAILED";
+                case VK_ERROR_DEVICE_LOST: return "VK_ERROR_DEVICE_LOST";
+                case VK_ERROR_MEMORY_MAP_FAILED: return "VK_ERROR_MEMORY_MAP_FAILED";
+                case VK_ERROR_LAYER_NOT_PRESENT: return "VK_ERROR_LAYER_NOT_PRESENT";
+                case VK_ERROR_EXTENSION_NOT_PRESENT: return "VK_ERROR_EXTENSION_NOT_PRESENT";
+                case VK_ERROR_FEATURE_NOT_PRESENT: return "VK_ERROR_FEATURE_NOT_PRESENT";
+                case VK_ERROR_INCOMPATIBLE_DRIVER: return "VK_ERROR_INCOMPATIBLE_DRIVER";
+                case VK_ERROR_OUT_OF_POOL_MEMORY: return "VK_ERROR_OUT_OF_POOL_MEMORY";
+                case VK_ERROR_FRAGMENTED_POOL: return "VK_ERROR_FRAGMENTED_POOL";
+                case VK_ERROR_SURFACE_LOST_KHR: return "VK_ERROR_SURFACE_LOST_KHR";
+                case VK_ERROR_OUT_OF_DATE_KHR: return "VK_ERROR_OUT_OF_DATE_KHR";
+                default: return "VkResult error";
+            }
+        }
+
+        void Check(VkResult result, const char* operation)
+        {
+            if (result != VK_SUCCESS)
+            {
+                throw std::runtime_error(std::string(operation) + " failed: " + ResultName(result));
+            }
+        }
+
+        VkDeviceSize AlignUp(VkDeviceSize value, VkDeviceSize alignment)
+        {
+            return (value + alignment - 1) / alignment * alignment;
+        }
+
+        /**
+         * @brief The fixed-function equivalent of SDL's blend modes, as the SDL renderer draws them.
+         */
+        VkPipelineColorBlendAttachmentState BlendState(BlendMode blend)
+        {
+            VkPipelineColorBlendAttachmentState state = {};
+            state.colorWriteMask = VK_COLOR_COMPONENT_R_BIT | VK_COLOR_COMPONENT_G_BIT | VK_COLOR_COMPONENT_B_BIT |
+                                   VK_COLOR_COMPONENT_A_BIT;
+            state.colorBlendOp = VK_BLEND_OP_ADD;
+            state.alphaBlendOp = VK_BLEND_OP_ADD;
+            switch (blend)
+            {
+                case BlendMode::Blend:
+                    state.blendEnable = VK_TRUE;
+                    state.srcColorBlendFactor = VK_BLEND_FACTOR_SRC_ALPHA;
+                    state.dstColorBlendFactor = VK_BLEND_FACTOR_ONE_MINUS_SRC_ALPHA;
+                    state.srcAlphaBlendFactor = VK_BLEND_FACTOR_ONE;
+                    state.dstAlphaBlendFactor = VK_BLEND_FACTOR_ONE_MINUS_SRC_ALPHA;
+                    break;
+                case BlendMode::Add:
+                    state.blendEnable = VK_TRUE;
+                    state.srcColorBlendFactor = VK_BLEND_FACTOR_SRC_ALPHA;
+                    state.dstColorBlendFactor = VK_BLEND_FACTOR_ONE;
+                    state.srcAlphaBlendFactor = VK_BLEND_FACTOR_ZERO;
+                    state.dstAlphaBlendFactor = VK_BLEND_FACTOR_ONE;
+                    break;
+                case BlendMode::Multiply:
+                    state.blendEnable = VK_TRUE;
+                    state.srcColorBlendFactor = VK_BLEND_FACTOR_DST_COLOR;
+                    state.dstColorBlendFactor = VK_BLEND_FACTOR_ONE_MINUS_SRC_ALPHA;
+                    state.srcAlphaBlendFactor = VK_BLEND_FACTOR_ZERO;
+                    state.dstAlphaBlendFactor = VK_BLEND_FACTOR_ONE;
+                    break;
+                case BlendMode::None:
+                    state.blendEnable = VK_FALSE;
+                    break;
+            }
+            return state;
+        }
+
+        /**
+         * @brief Stage and access of an image's use in a layout, for layout transitions.
+         */
+        void LayoutUsage(VkImageLayout layout, VkPipelineStageFlags& stage, VkAccessFlags& access)
+        {
+            switch (layout)
+            {
+                case VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL:
+                    stage = VK_PIPELINE_STAGE_TRANSFER_BIT;
+                    access = VK_ACCESS_TRANSFER_WRITE_BIT;
+                    break;
+                case VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL:
+                    stage = VK_PIPELINE_STAGE_TRANSFER_BIT;
+                    access = VK_ACCESS_TRANSFER_READ_BIT;
+                    break;
+                case VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL:
+                    stage = VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT;
+                    access = VK_ACCESS_SHADER_READ_BIT;
+                    break;
+                case VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL:
+                    stage = VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT;
+                    access = VK_ACCESS_COLOR_ATTACHMENT_READ_BIT | VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT;
+                    break;
+                case VK_IMAGE_LAYOUT_PRESENT_SRC_KHR:
+                    stage = VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT;
+                    access = 0;
+                    break;
+                default:
+                    // Undefined: nothing to wait for, but a swapchain image may only be written
+                    // after the acquire semaphore wait at the colour output stage
+                    stage = VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT;
+                    access = 0;
+                    break;
+            }
+        }
+
+        void Transition(VkCommandBuffer commands, VkImage image, VkImageLayout from, VkImageLayout to)
+        {
+            VkImageMemoryBarrier barrier = {VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER};
+            VkPipelineStageFlags sourceStage = 0;
+            VkPipelineStageFlags destinationStage = 0;
+            LayoutUsage(from, sourceStage, barrier.srcAccessMask);
+            LayoutUsage(to, destinationStage, barrier.dstAccessMask);
+            if (from == VK_IMAGE_LAYOUT_PRESENT_SRC_KHR)
+            {
+                sourceStage = VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT;
+            }
+            barrier.oldLayout = from;
+            barrier.newLayout = to;
+            barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+            barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+            barrier.image = image;
+            barrier.subresourceRange = {VK_IMAGE_ASPECT_COLOR_BIT, 0, 1, 0, 1};
+            vkCmdPipelineBarrier(commands, sourceStage, destinationStage, 0, 0, nullptr, 0, nullptr, 1, &barrier);
+        }
+
+        bool HasExtension(const std::vector<VkExtensionProperties>& extensions, const char* name)
+        {
+            return std::any_of(extensions.begin(), extensions.end(), [name](const VkExtensionProperties& extension) {
+                return std::strcmp(extension.extensionName, name) == 0;
+            });
+        }
+
+        /**
+         * @brief Logs a validation message; errors are also counted in the std::atomic
+         * counter passed as user data.
+         */
+        VKAPI_ATTR VkBool32 VKAPI_CALL OnValidationMessage(VkDebugUtilsMessageSeverityFlagBitsEXT severity,
+                                                           VkDebugUtilsMessageTypeFlagsEXT,
+                                                           const VkDebugUtilsMessengerCallbackDataEXT* data,
+                                                           void* errorCount)
+        {
+            if (severity & VK_DEBUG_UTILS_MESSAGE_SEVERITY_ERROR_BIT_EXT)
+            {
+                static_cast<std::atomic<std::uint32_t>*>(errorCount)->fetch_add(1, std::memory_order_relaxed);
+                LOG_ERROR("Vulkan: {}", data->pMessage);
+            }
+            else if (severity & VK_DEBUG_UTILS_MESSAGE_SEVERITY_WARNING_BIT_EXT)
+            {
+                LOG_WARN("Vulkan: {}", data->pMessage);
+            }
+            return VK_FALSE;
+        }
+    }
+
+    class VulkanRenderer::Impl
+    {
+    public:
+        Impl(const VulkanRendererConfig& config, TextureHandlePool& textureHandles);
+        ~Impl();
+
+        void Create(SDL_Window* window);
+        void RenderFrame(const CommandList& commands, RenderStats& stats);
+        bool SetVSync(bool enabled);
+        bool ReadPixels(std::vector<std::uint32_t>& pixels, int& width, int& height);
+
+        std::string deviceName;
+        bool validationEnabled = false;                   ///< The layer is loaded and its messages reach us
+        std::atomic<std::uint32_t> validationErrors{0};   ///< Messenger callbacks may come from any thread
+
+    private:
+        /**
+         * @brief A host-visible, persistently mapped buffer.
+         */
+        struct Buffer
+        {
+            VkBuffer buffer = VK_NULL_HANDLE;
+            VkDeviceMemory memory = VK_NULL_HANDLE;
+            VkDeviceSize size = 0;
+            std::uint8_t* mapped = nullptr;
+        };
+
+        struct Image
+        {
+            VkImage image = VK_NULL_HANDLE;
+            VkDeviceMemory memory = VK_NULL_HANDLE;
+            VkImageView view = VK_NULL_HANDLE;
+            int width = 0;
+            int height = 0;
+        };
+
+        /**
+         * @brief A texture, always in SHADER_READ_ONLY_OPTIMAL between command buffers.
+         */
+        struct Texture
+        {
+            Image image;
+            VkDescriptorSet descriptorSet = VK_NULL_HANDLE;
+            VkDescriptorPool descriptorPool = VK_NULL_HANDLE;
+            YUVColorspace colorspace = YUVColorspace::BT601Limited;   ///< Used to decode YUV uploads
+            bool target = false;
+        };
+
+        /**
+         * @brief The ring buffer. head and tail count bytes ever allocated and released, so the
+         * space in use is head - tail; offsets into the buffer are taken modulo its size.
+         */
+        struct Ring
+        {
+            Buffer buffer;
+            VkDescriptorSet viewSet = VK_NULL_HANDLE;   ///< The View uniform, at a dynamic offset
+            std::uint64_t head = 0;
+            std::uint64_t tail = 0;
+            std::uint32_t generation = 0;               ///< Incremented when the ring is replaced
+        };
+
+        struct Allocation
+        {
+            VkBuffer buffer;
+            VkDeviceSize offset;
+            std::uint8_t* data;
+            VkDescriptorSet viewSet;
+        };
+
+        struct Frame
+        {
+            VkCommandPool pool = VK_NULL_HANDLE;
+            VkCommandBuffer commands = VK_NULL_HANDLE;
+            VkSemaphore imageAcquired = VK_NULL_HANDLE;
+            std::uint64_t serial = 0;                   ///< Timeline value signalled when the frame completes
+            std::uint64_t ringEnd = 0;                  ///< Ring head when the frame was submitted
+            std::uint32_t ringGeneration = 0;
+        };
+
+        struct UploadBatch
+        {
+            VkCommandPool pool = VK_NULL_HANDLE;
+            VkCommandBuffer commands = VK_NULL_HANDLE;
+            Buffer staging;
+            VkDeviceSize used = 0;
+            std::uint64_t serial = 0;                   ///< Timeline value signalled when the batch completes
+        };
+
+        /**
+         * @brief Resources released while the GPU may still use them, destroyed once the
+         * timeline reaches serial.
+         */
+        struct Retired
+        {
+            std::uint64_t serial = 0;
+            Buffer buffer;
+            Image image;
+            VkDescriptorSet descriptorSet = VK_NULL_HANDLE;
+            VkDescriptorPool descriptorPool = VK_NULL_HANDLE;
+        };
+
+        /**
+         * @brief The image being drawn into. layout points at where its current layout is tracked.
+         */
+        struct Target
+        {
+            VkImage image = VK_NULL_HANDLE;
+            VkImageView view = VK_NULL_HANDLE;
+            VkExtent2D extent = {0, 0};
+            FormatSlot slot = kTextureSlot;
+            VkImageLayout* layout = nullptr;
+        };
+
+        void CreateInstance(SDL_Window* window);
+        void SelectDevice();
+        void CreateDevice();
+        void CreateSwapchain();
+        void DestroySwapchain();
+        void CreateDescriptorLayouts();
+        void CreatePipelines(FormatSlot slot, VkFormat format);
+        void LoadPipelineCache();
+        void SavePipelineCache();
+
+        std::uint32_t FindMemoryType(std::uint32_t typeBits, VkMemoryPropertyFlags properties) const;
+        void CreateBuffer(VkDeviceSize size, VkBufferUsageFlags usage, Buffer& buffer);
+        void DestroyBuffer(Buffer& buffer);
+        void CreateImage(int width, int height, VkImageUsageFlags usage, Image& image);
+        void DestroyImage(Image& image);
+        void CreateRing(VkDeviceSize size);
+        void Retire(const Retired& resources);
+        void CollectRetired(std::uint64_t completed);
+        std::uint64_t CompletedSerial() const;
+        void WaitForSerial(std::uint64_t serial) const;
+
+        void BeginFrame();
+        void EndFrame(bool present);
+        Allocation AllocateRing(VkDeviceSize size, VkDeviceSize alignment);
+        VkCommandBuffer BeginUpload();
+        std::uint8_t* AllocateStaging(VkDeviceSize size, VkDeviceSize& offset);
+        std::uint64_t SubmitUploads();
+
+        Texture* GetTexture(TextureHandle handle);
+        void CreateTexture(const RenderCommand& command, const CommandList& commands);
+        void UpdateTexture(const RenderCommand& command, const CommandList& commands);
+        void UpdateTextureYUV(const RenderCommand& command, const CommandList& commands);
+        void DestroyTexture(TextureHandle handle);
+        void UploadRegion(Texture& texture, VkDeviceSize offset, std::uint32_t rowLength, const VkRect2D& region);
+
+        void BindTarget(TextureHandle handle);
+        bool AcquireImage();
+        bool OpenPass();
+        void ClosePass();
+        void Clear(const SDL_FColor& color);
+        void DrawSprites(RenderStats& stats);
+        void DrawGeometry(const RenderCommand& command, const CommandList& commands, RenderStats& stats);
+        void EnsureQuadIndices(std::size_t spriteCount);
+        void Bind(BlendMode blend, TextureHandle texture);
+
+        VulkanRendererConfig m_config;
+        TextureHandlePool& m_textureHandles;
+        SDL_Window* m_window;
+        bool m_vsync;
+
+        VkInstance m_instance;
+        VkDebugUtilsMessengerEXT m_messenger;
+        VkSurfaceKHR m_surface;
+        VkPhysicalDevice m_physicalDevice;
+        VkPhysicalDeviceProperties m_properties;
+        VkPhysicalDeviceMemoryProperties m_memoryProperties;
+        std::uint32_t m_queueFamily;
+        VkDevice m_device;
+        VkQueue m_queue;
+        VkSemaphore m_timeline;
+        std::uint64_t m_timelineValue;                  ///< Last value a submission signals
+
+        VkSwapchainKHR m_swapchain;
+        VkFormat m_swapchainFormat;
+        VkExtent2D m_swapchainExtent;
+        std::vector<VkImage> m_swapchainImages;
+        std::vector<VkImageView> m_swapchainViews;
+        std::vector<VkImageLayout> m_swapchainLayouts;
+        std::vector<VkSemaphore> m_renderFinished;      ///< Per swapchain image, waited on by present
+        bool m_swapchainDirty;
+        bool m_hasMailbox;
+        bool m_hasImmediate;
+        std::uint32_t m_imageIndex;
+        bool m_imageAcquired;
+        bool m_waitForAcquire;                          ///< The frame's submit must wait for the acquire
+
+        Image m_offscreen;
+        VkImageLayout m_offscreenLayout;
+
+        VkPipelineCache m_pipelineCache;
+        VkDescriptorSetLayout m_viewLayout;
+        VkDescriptorSetLayout m_textureLayout;
+        VkPipelineLayout m_pipelineLayout;
+        VkShaderModule m_vertexShader;
+        VkShaderModule m_fragmentShader;
+        VkPipeline m_pipelines[kFormatSlotCount][kBlendModeCount];
+        VkSampler m_sampler;
+        VkDescriptorPool m_viewPool;
+        std::vector<VkDescriptorPool> m_texturePools;
+
+        std::vector<Frame> m_frames;
+        std::size_t m_frameIndex;
+        Ring m_ring;
+        Buffer m_quadIndices;
+        std::vector<UploadBatch> m_uploads;
+        UploadBatch* m_upload;                          ///< Batch being recorded, or null
+        std::vector<Retired> m_retired;
+        std::vector<Retired> m_retiring;                ///< Released this frame; serial set on submit
+
+        std::vector<Texture> m_textures;
+        std::vector<SpriteBatch::Texture> m_textureSizes;
+        Texture m_white;
+        SpriteBatch m_spriteBatch;
+
+        // Recording state of the current frame
+        VkCommandBuffer m_commands;
+        TextureHandle m_targetHandle;
+        Target m_target;
+        VkImageLayout m_textureTargetLayout;
+        bool m_passOpen;
+        bool m_clearPending;
+        VkClearColorValue m_clearColor;
+        VkPipeline m_boundPipeline;
+        VkDescriptorSet m_boundTexture;
+        bool m_ringWarned;
+    };
+
+    VulkanRenderer::Impl::Impl(const VulkanRendererConfig& config, TextureHandlePool& textureHandles)
+        : m_config(config), m_textureHandles(textureHandles), m_window(nullptr), m_vsync(true),
+          m_instance(VK_NULL_HANDLE), m_messenger(VK_NULL_HANDLE), m_surface(VK_NULL_HANDLE),
+          m_physicalDevice(VK_NULL_HANDLE), m_properties(), m_memoryProperties(), m_queueFamily(0),
+          m_device(VK_NULL_HANDLE), m_queue(VK_NULL_HANDLE), m_timeline(VK_NULL_HANDLE), m_timelineValue(0),
+          m_swapchain(VK_NULL_HANDLE), m_swapchainFormat(VK_FORMAT_UNDEFINED), m_swapchainExtent{0, 0},
+          m_swapchainDirty(false), m_hasMailbox(false), m_hasImmediate(false), m_imageIndex(0),
+          m_imageAcquired(false), m_waitForAcquire(false), m_offscreenLayout(VK_IMAGE_LAYOUT_UNDEFINED),
+          m_pipelineCache(VK_NULL_HANDLE), m_viewLayout(VK_NULL_HANDLE), m_textureLayout(VK_NULL_HANDLE),
+          m_pipelineLayout(VK_NULL_HANDLE), m_vertexShader(VK_NULL_HANDLE), m_fragmentShader(VK_NULL_HANDLE),
+          m_pipelines(), m_sampler(VK_NULL_HANDLE), m_viewPool(VK_NULL_HANDLE), m_frameIndex(0), m_upload(nullptr),
+          m_commands(VK_NULL_HANDLE), m_targetHandle(0), m_textureTargetLayout(VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL),
+          m_passOpen(false), m_clearPending(false), m_clearColor(), m_boundPipeline(VK_NULL_HANDLE),
+          m_boundTexture(VK_NULL_HANDLE), m_ringWarned(false)
+    {
+        m_config.framesInFlight = std::clamp(m_config.framesInFlight, 2, 3);
+    }
+
+    /**
+     * @brief Waits for the GPU, saves the pipeline cache and destroys everything, including
+     * whatever a failed Create() got to.
+     */
+    VulkanRenderer::Impl::~Impl()
+    {
+        if (m_device)
+        {
+            vkDeviceWaitIdle(m_device);
+            SavePipelineCache();
+
+            CollectRetired(UINT64_MAX);
+            for (Retired& resources : m_retiring)
+            {
+                resources.serial = 0;
+                m_retired.push_back(resources);
+            }
+            m_retiring.clear();
+            CollectRetired(UINT64_MAX);
+
+            for (Texture& texture : m_textures)
+            {
+                DestroyImage(texture.image);
+            }
+            DestroyImage(m_white.image);
+            DestroyImage(m_offscreen);
+            for (UploadBatch& upload : m_uploads)
+            {
+                DestroyBuffer(upload.staging);
+                vkDestroyCommandPool(m_device, upload.pool, nullptr);
+            }
+            for (Frame& frame : m_frames)
+            {
+                vkDestroyCommandPool(m_device, frame.pool, nullptr);
+                vkDestroySemaphore(m_device, frame.imageAcquired, nullptr);
+            }
+            DestroyBuffer(m_ring.buffer);
+            DestroyBuffer(m_quadIndices);
+            DestroySwapchain();
+
+            for (VkDescriptorPool pool : m_texturePools)
+            {
+                vkDestroyDescriptorPool(m_device, pool, nullptr);
+            }
+            vkDestroyDescriptorPool(m_device, m_viewPool, nullptr);
+            vkDestroySampler(m_device, m_sampler, nullptr);
+            for (auto& pipelines : m_pipelines)
+            {
+                for (VkPipeline pipeline : pipelines)
+                {
+                    vkDestroyPipeline(m_device, pipeline, nullptr);
+                }
+            }
+            vkDestroyShaderModule(m_device, m_vertexShader, nullptr);
+            vkDestroyShaderModule(m_device, m_fragmentShader, nullptr);
+            vkDestroyPipelineLayout(m_device, m_pipelineLayout, nullptr);
+            vkDestroyDescriptorSetLayout(m_device, m_viewLayout, nullptr);
+            vkDestroyDescriptorSetLayout(m_device, m_textureLayout, nullptr);
+            vkDestroyPipelineCache(m_device, m_pipelineCache, nullptr);
+            vkDestroySemaphore(m_device, m_timeline, nullptr);
+            vkDestroyDevice(m_device, nullptr);
+        }
+        if (m_instance)
+        {
+            if (m_surface)
+            {
+                vkDestroySurfaceKHR(m_instance, m_surface, nullptr);
+            }
+            if (m_messenger)
+            {
+                auto destroyMessenger = reinterpret_cast<PFN_vkDestroyDebugUtilsMessengerEXT>(
+                    vkGetInstanceProcAddr(m_instance, "vkDestroyDebugUtilsMessengerEXT"));
+                if (destroyMessenger)
+                {
+                    destroyMessenger(m_instance, m_messenger, nullptr);
+                }
+            }
+            vkDestroyInstance(m_instance, nullptr);
+        }
+    }
+
+    void VulkanRenderer::Impl::Create(SDL_Window* window)
+    {
+        // Windows created without SDL_WINDOW_VULKAN (headless ones) are rendered offscreen at
+        // their size
+        int width = m_config.width;
+        int height = m_config.height;
+        if (window)
+        {
+            SDL_GetWindowSizeInPixels(window, &width, &height);
+        }
+        if (window && !(SDL_GetWindowFlags(window) & SDL_WINDOW_VULKAN))
+        {
+            window = nullptr;
+        }
+        m_window = window;
+        CreateInstance(window);
+        SelectDevice();
+        CreateDevice();
+        CreateDescriptorLayouts();
+        LoadPipelineCache();
+        CreatePipelines(kTextureSlot, kTextureFormat);
+
+        m_frames.resize(static_cast<std::size_t>(m_config.framesInFlight));
+        for (Frame& frame : m_frames)
+        {
+            VkCommandPoolCreateInfo poolInfo = {VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO};
+            poolInfo.flags = VK_COMMAND_POOL_CREATE_TRANSIENT_BIT;
+            poolInfo.queueFamilyIndex = m_queueFamily;
+            Check(vkCreateCommandPool(m_device, &poolInfo, nullptr, &frame.pool), "vkCreateCommandPool");
+
+            VkCommandBufferAllocateInfo allocateInfo = {VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO};
+            allocateInfo.commandPool = frame.pool;
+            allocateInfo.level = VK_COMMAND_BUFFER_LEVEL_PRIMARY;
+            allocateInfo.commandBufferCount = 1;
+            Check(vkAllocateCommandBuffers(m_device, &allocateInfo, &frame.commands), "vkAllocateCommandBuffers");
+
+            VkSemaphoreCreateInfo semaphoreInfo = {VK_STRUCTURE_TYPE_SEMAPHORE_CREATE_INFO};
+            Check(vkCreateSemaphore(m_device, &semaphoreInfo, nullptr, &frame.imageAcquired), "vkCreateSemaphore");
+        }
+        CreateRing(AlignUp(std::max<VkDeviceSize>(m_config.ringBufferSize, kRingGranularity), kRingGranularity));
+        EnsureQuadIndices(1024);
+
+        if (m_surface)
+        {
+            CreateSwapchain();
+        }
+        else
+        {
+            CreateImage(std::clamp(width, 1, kMaxTextureSize), std::clamp(height, 1, kMaxTextureSize),
+                        VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT | VK_IMAGE_USAGE_TRANSFER_SRC_BIT, m_offscreen);
+        }
+
+        // Untextured draws sample a white texel, so one pipeline serves both
+        CreateImage(1, 1, VK_IMAGE_USAGE_SAMPLED_BIT | VK_IMAGE_USAGE_TRANSFER_DST_BIT, m_white.image);
+        const std::uint32_t white = 0xFFFFFFFFu;
+        VkDeviceSize offset = 0;
+        std::memcpy(AllocateStaging(sizeof(white), offset), &white, sizeof(white));
+        UploadRegion(m_white, offset, 1, {{0, 0}, {1, 1}});
+        VkDescriptorSetAllocateInfo setInfo = {VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO};
+        setInfo.descriptorPool = m_viewPool;
+        setInfo.descriptorSetCount = 1;
+        setInfo.pSetLayouts = &m_textureLayout;
+        Check(vkAllocateDescriptorSets(m_device, &setInfo, &m_white.descriptorSet), "vkAllocateDescriptorSets");
+        VkDescriptorImageInfo imageInfo = {m_sampler, m_white.image.view, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL};
+        VkWriteDescriptorSet write = {VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET};
+        write.dstSet = m_white.descriptorSet;
+        write.descriptorCount = 1;
+        write.descriptorType = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
+        write.pImageInfo = &imageInfo;
+        vkUpdateDescriptorSets(m_device, 1, &write, 0, nullptr);
+        SubmitUploads();
+
+        BindTarget(0);
+        LOG_INFO("Vulkan renderer on {} (Vulkan {}.{}), {} frames in flight, {}", deviceName,
+                 VK_API_VERSION_MAJOR(m_properties.apiVersion), VK_API_VERSION_MINOR(m_properties.apiVersion),
+                 m_frames.size(), m_surface ? "presenting to the window" : "offscreen");
+    }
+
+    void VulkanRenderer::Impl::CreateInstance(SDL_Window* window)
+    {
+        std::vector<const char*> extensions;
+        if (window)
+        {
+            Uint32 count = 0;
+            const char* const* names = SDL_Vulkan_GetInstanceExtensions(&count);
+            if (names)
+            {
+                extensions.assign(names, names + count);
+            }
+            else
+            {
+                LOG_WARN("No Vulkan surface extensions for the window ({}), rendering offscreen", SDL_GetError());
+                window = nullptr;
+            }
+        }
+
+        std::uint32_t available = 0;
+        vkEnumerateInstanceExtensionProperties(nullptr, &available, nullptr);
+        std::vector<VkExtensionProperties> instanceExtensions(available);
+        vkEnumerateInstanceExtensionProperties(nullptr, &available, instanceExtensions.data());
+
+        VkInstanceCreateInfo instanceInfo = {VK_STRUCTURE_TYPE_INSTANCE_CREATE_INFO};
+        if (HasExtension(instanceExtensions, VK_KHR_PORTABILITY_ENUMERATION_EXTENSION_NAME))
+        {
+            extensions.push_back(VK_KHR_PORTABILITY_ENUMERATION_EXTENSION_NAME);
+            instanceInfo.flags |= VK_INSTANCE_CREATE_ENUMERATE_PORTABILITY_BIT_KHR;
+        }
+
+        const char* validationLayer = "VK_LAYER_KHRONOS_validation";
+        bool validation = false;
+        if (m_config.validation)
+        {
+            std::uint32_t layerCount = 0;
+            vkEnumerateInstanceLayerProperties(&layerCount, nullptr);
+            std::vector<VkLayerProperties> layers(layerCount);
+            vkEnumerateInstanceLayerProperties(&layerCount, layers.data());
+            validation = std::any_of(layers.begin(), layers.end(), [validationLayer](const VkLayerProperties& layer) {
+                return std::strcmp(layer.layerName, validationLayer) == 0;
+            }) && HasExtension(instanceExtensions, VK_EXT_DEBUG_UTILS_EXTENSION_NAME);
+            if (validation)
+            {
+                extensions.push_back(VK_EXT_DEBUG_UTILS_EXTENSION_NAME);
+                instanceInfo.enabledLayerCount = 1;
+                instanceInfo.ppEnabledLayerNames = &validationLayer;
+            }
+            else
+            {
+                LOG_WARN("Vulkan validation requested but {} is not installed", validationLayer);
+            }
+        }
+
+        VkApplicationInfo applicationInfo = {VK_STRUCTURE_TYPE_APPLICATION_INFO};
+        applicationInfo.pApplicationName = "Polaris";
+        applicationInfo.pEngineName = "Polaris";
+        applicationInfo.apiVersion = VK_API_VERSION_1_3;
+        instanceInfo.pApplicationInfo = &applicationInfo;
+        instanceInfo.enabledExtensionCount = static_cast<std::uint32_t>(extensions.size());
+        instanceInfo.ppEnabledExtensionNames = extensions.data();
+        Check(vkCreateInstance(&instanceInfo, nullptr, &m_instance), "vkCreateInstance");
+
+        if (validation)
+        {
+            VkDebugUtilsMessengerCreateInfoEXT messengerInfo = {VK_STRUCTURE_TYPE_DEBUG_UTILS_MESSENGER_CREATE_INFO_EXT};
+            messengerInfo.messageSeverity =
+                VK_DEBUG_UTILS_MESSAGE_SEVERITY_WARNING_BIT_EXT | VK_DEBUG_UTILS_MESSAGE_SEVERITY_ERROR_BIT_EXT;
+            messengerInfo.messageType = VK_DEBUG_UTILS_MESSAGE_TYPE_GENERAL_BIT_EXT |
+                                        VK_DEBUG_UTILS_MESSAGE_TYPE_VALIDATION_BIT_EXT |
+                                        VK_DEBUG_UTILS_MESSAGE_TYPE_PERFORMANCE_BIT_EXT;
+            messengerInfo.pfnUserCallback = OnValidationMessage;
+            messengerInfo.pUserData = &validationErrors;
+            auto createMessenger = reinterpret_cast<PFN_vkCreateDebugUtilsMessengerEXT>(
+                vkGetInstanceProcAddr(m_instance, "vkCreateDebugUtilsMessengerEXT"));
+            if (createMessenger)
+            {
+                createMessenger(m_instance, &messengerInfo, nullptr, &m_messenger);
+            }
+            validationEnabled = m_messenger != VK_NULL_HANDLE;
+            if (!validationEnabled)
+            {
+                LOG_WARN("Vulkan validation requested but its messages cannot be received");
+            }
+        }
+
+        if (window && !SDL_Vulkan_CreateSurface(window, m_instance, nullptr, &m_surface))
+        {
+            LOG_WARN("Failed to create a Vulkan surface ({}), rendering offscreen", SDL_GetError());
+            m_surface = VK_NULL_HANDLE;
+        }
+        if (!m_surface)
+        {
+            m_window = nullptr;
+        }
+    }
+
+    /**
+     * @brief Picks a Vulkan 1.3 device with dynamic rendering, timeline semaphores and a queue
+     * that can draw (and present, with a surface): the one named in the config if any, else the
+     * most capable kind.
+     */
+    void VulkanRenderer::Impl::SelectDevice()
+    {
+        std::uint32_t count = 0;
+        vkEnumeratePhysicalDevices(m_instance, &count, nullptr);
+        std::vector<VkPhysicalDevice> devices(count);
+        vkEnumeratePhysicalDevices(m_instance, &count, devices.data());
+
+        int bestScore = -1;
+        for (VkPhysicalDevice device : devices)
+        {
+            VkPhysicalDeviceProperties properties;
+            vkGetPhysicalDeviceProperties(device, &properties);
+            if (properties.apiVersion < VK_API_VERSION_1_3)
+            {
+                continue;
+            }
+
+            VkPhysicalDeviceVulkan12Features features12 = {VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_VULKAN_1_2_FEATURES};
+            VkPhysicalDeviceVulkan13Features features13 = {VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_VULKAN_1_3_FEATURES};
+            features12.pNext = &features13;
+            VkPhysicalDeviceFeatures2 features = {VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_FEATURES_2};
+            features.pNext = &features12;
+            vkGetPhysicalDeviceFeatures2(device, &features);
+            if (!features12.timelineSemaphore || !features13.dynamicRendering)
+            {
+                continue;
+            }
+
+            std::uint32_t extensionCount = 0;
+            vkEnumerateDeviceExtensionProperties(device, nullptr, &extensionCount, nullptr);
+            std::vector<VkExtensionProperties> extensions(extensionCount);
+            vkEnumerateDeviceExtensionProperties(device, nullptr, &extensionCount, extensions.data());
+            if (m_surface && !HasExtension(extensions, VK_KHR_SWAPCHAIN_EXTENSION_NAME))
+            {
+                continue;
+            }
+
+            std::uint32_t familyCount = 0;
+            vkGetPhysicalDeviceQueueFamilyProperties(device, &familyCount, nullptr);
+            std::vector<VkQueueFamilyProperties> families(familyCount);
+            vkGetPhysicalDeviceQueueFamilyProperties(device, &familyCount, families.data());
+            std::uint32_t family = familyCount;
+            for (std::uint32_t i = 0; i < familyCount && family == familyCount; ++i)
+            {
+                VkBool32 present = VK_TRUE;
+                if (m_surface)
+                {
+                    vkGetPhysicalDeviceSurfaceSupportKHR(device, i, m_surface, &present);
+                }
+                if ((families[i].queueFlags & VK_QUEUE_GRAPHICS_BIT) && present)
+                {
+                    family = i;
+                }
+            }
+            if (family == familyCount)
+            {
+                continue;
+            }
+
+            int score = 0;
+            switch (properties.deviceType)
+            {
+                case VK_PHYSICAL_DEVICE_TYPE_DISCRETE_GPU: score = 4; break;
+                case VK_PHYSICAL_DEVICE_TYPE_INTEGRATED_GPU: score = 3; break;
+                case VK_PHYSICAL_DEVICE_TYPE_VIRTUAL_GPU: score = 2; break;
+                default: score = 1; break;
+            }
+            if (!m_config.deviceName.empty() && std::strstr(properties.deviceName, m_config.deviceName.c_str()))
+            {
+                score += 10;
+            }
+            if (score > bestScore)
+            {
+                bestScore = score;
+                m_physicalDevice = device;
+                m_properties = properties;
+                m_queueFamily = family;
+            }
+        }
+
+        if (!m_physicalDevice)
+        {
+            throw std::runtime_error("No Vulkan 1.3 device with dynamic rendering and timeline semaphores");
+        }
+        if (!m_config.deviceName.empty() && bestScore < 10)
+        {
+            LOG_WARN("No Vulkan device named like {}, using {}", m_config.deviceName, m_properties.deviceName);
+        }
+        deviceName = m_properties.deviceName;
+        vkGetPhysicalDeviceMemoryProperties(m_physicalDevice, &m_memoryProperties);
+    }
+
+    void VulkanRenderer::Impl::CreateDevice()
+    {
+        std::uint32_t extensionCount = 0;
+        vkEnumerateDeviceExtensionProperties(m_physicalDevice, nullptr, &extensionCount, nullptr);
+        std::vector<VkExtensionProperties> available(extensionCount);
+        vkEnumerateDeviceExtensionProperties(m_physicalDevice, nullptr, &extensionCount, available.data());
+        std::vector<const char*> extensions;
+        if (m_surface)
+        {
+            extensions.push_back(VK_KHR_SWAPCHAIN_EXTENSION_NAME);
+        }
+        // Required wherever it is offered (MoltenVK)
+        if (HasExtension(available, "VK_KHR_portability_subset"))
+        {
+            extensions.push_back("VK_KHR_portability_subset");
+        }
+
+        const float priority = 1.0f;
+        VkDeviceQueueCreateInfo queueInfo = {VK_STRUCTURE_TYPE_DEVICE_QUEUE_CREATE_INFO};
+        queueInfo.queueFamilyIndex = m_queueFamily;
+        queueInfo.queueCount = 1;
+        queueInfo.pQueuePriorities = &priority;
+
+        VkPhysicalDeviceVulkan13Features features13 = {VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_VULKAN_1_3_FEATURES};
+        features13.dynamicRendering = VK_TRUE;
+        VkPhysicalDeviceVulkan12Features features12 = {VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_VULKAN_1_2_FEATURES};
+        features12.timelineSemaphore = VK_TRUE;
+        features12.pNext = &features13;
+
+        VkDeviceCreateInfo deviceInfo = {VK_STRUCTURE_TYPE_DEVICE_CREATE_INFO};
+        deviceInfo.pNext = &features12;
+        deviceInfo.queueCreateInfoCount = 1;
+        deviceInfo.pQueueCreateInfos = &queueInfo;
+        deviceInfo.enabledExtensionCount = static_cast<std::uint32_t>(extensions.size());
+        deviceInfo.ppEnabledExtensionNames = extensions.data();
+        Check(vkCreateDevice(m_physicalDevice, &deviceInfo, nullptr, &m_device), "vkCreateDevice");
+        vkGetDeviceQueue(m_device, m_queueFamily, 0, &m_queue);
+
+        VkSemaphoreTypeCreateInfo typeInfo = {VK_STRUCTURE_TYPE_SEMAPHORE_TYPE_CREATE_INFO};
+        typeInfo.semaphoreType = VK_SEMAPHORE_TYPE_TIMELINE;
+        typeInfo.initialValue = 0;
+        VkSemaphoreCreateInfo semaphoreInfo = {VK_STRUCTURE_TYPE_SEMAPHORE_CREATE_INFO};
+        semaphoreInfo.pNext = &typeInfo;
+        Check(vkCreateSemaphore(m_device, &semaphoreInfo, nullptr, &m_timeline), "vkCreateSemaphore");
+    }
+
+    /**
+     * @brief (Re)creates the swapchain at the window's current size. A minimised window gets
+     * none; frames then skip drawing to it until it is restored.
+     */
+    void VulkanRenderer::Impl::CreateSwapchain()
+    {
+        VkSurfaceCapabilitiesKHR capabilities;
+        Check(vkGetPhysicalDeviceSurfaceCapabilitiesKHR(m_physicalDevice, m_surface, &capabilities),
+              "vkGetPhysicalDeviceSurfaceCapabilitiesKHR");
+        VkExtent2D extent = capabilities.currentExtent;
+        if (extent.width == UINT32_MAX)
+        {
+            int width = 0;
+            int height = 0;
+            SDL_GetWindowSizeInPixels(m_window, &width, &height);
+            extent.width = std::clamp(static_cast<std::uint32_t>(std::max(width, 0)), capabilities.minImageExtent.width,
+                                      capabilities.maxImageExtent.width);
+            extent.height = std::clamp(static_cast<std::uint32_t>(std::max(height, 0)),
+                                       capabilities.minImageExtent.height, capabilities.maxImageExtent.height);
+        }
+        m_swapchainDirty = false;
+        if (extent.width == 0 || extent.height == 0)
+        {
+            DestroySwapchain();
+            return;
+        }
+
+        std::uint32_t formatCount = 0;
+        vkGetPhysicalDeviceSurfaceFormatsKHR(m_physicalDevice, m_surface, &formatCount, nullptr);
+        std::vector<VkSurfaceFormatKHR> formats(formatCount);
+        vkGetPhysicalDeviceSurfaceFormatsKHR(m_physicalDevice, m_surface, &formatCount, formats.data());
+        if (formats.empty())
+        {
+            throw std::runtime_error("Vulkan surface has no formats");
+        }
+        // UNORM, not sRGB: the SDL renderer blends in gamma space, and so do we
+        VkSurfaceFormatKHR format = formats[0];
+        for (const VkSurfaceFormatKHR& candidate : formats)
+        {
+            if ((candidate.format == VK_FORMAT_B8G8R8A8_UNORM || candidate.format == VK_FORMAT_R8G8B8A8_UNORM) &&
+                candidate.colorSpace == VK_COLOR_SPACE_SRGB_NONLINEAR_KHR)
+            {
+                format = candidate;
+                break;
+            }
+        }
+        if (format.format == VK_FORMAT_UNDEFINED)
+        {
+            format = {VK_FORMAT_B8G8R8A8_UNORM, VK_COLOR_SPACE_SRGB_NONLINEAR_KHR};
+        }
+
+        std::uint32_t modeCount = 0;
+        vkGetPhysicalDeviceSurfacePresentModesKHR(m_physicalDevice, m_surface, &modeCount, nullptr);
+        std::vector<VkPresentModeKHR> modes(modeCount);
+        vkGetPhysicalDeviceSurfacePresentModesKHR(m_physicalDevice, m_surface, &modeCount, modes.data());
+        m_hasMailbox = std::find(modes.begin(), modes.end(), VK_PRESENT_MODE_MAILBOX_KHR) != modes.end();
+        m_hasImmediate = std::find(modes.begin(), modes.end(), VK_PRESENT_MODE_IMMEDIATE_KHR) != modes.end();
+        VkPresentModeKHR presentMode = VK_PRESENT_MODE_FIFO_KHR;
+        if (!m_vsync)
+        {
+            presentMode = m_hasMailbox ? VK_PRESENT_MODE_MAILBOX_KHR
+                                       : (m_hasImmediate ? VK_PRESENT_MODE_IMMEDIATE_KHR : VK_PRESENT_MODE_FIFO_KHR);
+        }
+
+        std::uint32_t imageCount = std::max<std::uint32_t>(capabilities.minImageCount + 1,
+                                                           static_cast<std::uint32_t>(m_frames.size()));
+        if (capabilities.maxImageCount > 0)
+        {
+            imageCount = std::min(imageCount, capabilities.maxImageCount);
+        }
+        VkCompositeAlphaFlagBitsKHR compositeAlpha = VK_COMPOSITE_ALPHA_OPAQUE_BIT_KHR;
+        if (!(capabilities.supportedCompositeAlpha & compositeAlpha))
+        {
+            compositeAlpha = VK_COMPOSITE_ALPHA_INHERIT_BIT_KHR;
+        }
+
+        VkSwapchainCreateInfoKHR swapchainInfo = {VK_STRUCTURE_TYPE_SWAPCHAIN_CREATE_INFO_KHR};
+        swapchainInfo.surface = m_surface;
+        swapchainInfo.minImageCount = imageCount;
+        swapchainInfo.imageFormat = format.format;
+        swapchainInfo.imageColorSpace = format.colorSpace;
+        swapchainInfo.imageExtent = extent;
+        swapchainInfo.imageArrayLayers = 1;
+        swapchainInfo.imageUsage = VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT;
+        swapchainInfo.imageSharingMode = VK_SHARING_MODE_EXCLUSIVE;
+        swapchainInfo.preTransform = capabilities.currentTransform;
+        swapchainInfo.compositeAlpha = compositeAlpha;
+        swapchainInfo.presentMode = presentMode;
+        swapchainInfo.clipped = VK_TRUE;
+        swapchainInfo.oldSwapchain = m_swapchain;
+        VkSwapchainKHR swapchain = VK_NULL_HANDLE;
+        Check(vkCreateSwapchainKHR(m_device, &swapchainInfo, nullptr, &swapchain), "vkCreateSwapchainKHR");
+        DestroySwapchain();
+        m_swapchain = swapchain;
+        m_swapchainExtent = extent;
+
+        std::uint32_t count = 0;
+        vkGetSwapchainImagesKHR(m_device, m_swapchain, &count, nullptr);
+        m_swapchainImages.resize(count);
+        vkGetSwapchainImagesKHR(m_device, m_swapchain, &count, m_swapchainImages.data());
+        m_swapchainLayouts.assign(count, VK_IMAGE_LAYOUT_UNDEFINED);
+        for (VkImage image : m_swapchainImages)
+        {
+            VkImageViewCreateInfo viewInfo = {VK_STRUCTURE_TYPE_IMAGE_VIEW_CREATE_INFO};
+            viewInfo.image = image;
+            viewInfo.viewType = VK_IMAGE_VIEW_TYPE_2D;
+            viewInfo.format = format.format;
+            viewInfo.subresourceRange = {VK_IMAGE_ASPECT_COLOR_BIT, 0, 1, 0, 1};
+            VkImageView view = VK_NULL_HANDLE;
+            Check(vkCreateImageView(m_device, &viewInfo, nullptr, &view), "vkCreateImageView");
+            m_swapchainViews.push_back(view);
+
+            VkSemaphoreCreateInfo semaphoreInfo = {VK_STRUCTURE_TYPE_SEMAPHORE_CREATE_INFO};
+            VkSemaphore semaphore = VK_NULL_HANDLE;
+            Check(vkCreateSemaphore(m_device, &semaphoreInfo, nullptr, &semaphore), "vkCreateSemaphore");
+            m_renderFinished.push_back(semaphore);
+        }
+
+        if (format.format != m_swapchainFormat)
+        {
+            m_swapchainFormat = format.format;
+            CreatePipelines(kSwapchainSlot, format.format);
+        }
+    }
+
+    /**
+     * @brief Destroys the swapchain with its views and semaphores. The GPU must be idle.
+     */
+    void VulkanRenderer::Impl::DestroySwapchain()
+    {
+        for (VkImageView view : m_swapchainViews)
+        {
+            vkDestroyImageView(m_device, view, nullptr);
+        }
+        for (VkSemaphore semaphore : m_renderFinished)
+        {
+            vkDestroySemaphore(m_device, semaphore, nullptr);
+        }
+        m_swapchainViews.clear();
+        m_renderFinished.clear();
+        m_swapchainImages.clear();
+        m_swapchainLayouts.clear();
+        if (m_swapchain)
+        {
+            vkDestroySwapchainKHR(m_device, m_swapchain, nullptr);
+            m_swapchain = VK_NULL_HANDLE;
+        }
+        m_swapchainExtent = {0, 0};
+        m_imageAcquired = false;
+    }
+
+    void VulkanRenderer::Impl::CreateDescriptorLayouts()
+    {
+        VkDescriptorSetLayoutBinding viewBinding = {};
+        viewBinding.binding = 0;
+        viewBinding.descriptorType = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC;
+        viewBinding.descriptorCount = 1;
+        viewBinding.stageFlags = VK_SHADER_STAGE_VERTEX_BIT;
+        VkDescriptorSetLayoutCreateInfo layoutInfo = {VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO};
+        layoutInfo.bindingCount = 1;
+        layoutInfo.pBindings = &viewBinding;
+        Check(vkCreateDescriptorSetLayout(m_device, &layoutInfo, nullptr, &m_viewLayout), "vkCreateDescriptorSetLayout");
+
+        VkDescriptorSetLayoutBinding textureBinding = {};
+        textureBinding.binding = 0;
+        textureBinding.descriptorType = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
+        textureBinding.descriptorCount = 1;
+        textureBinding.stageFlags = VK_SHADER_STAGE_FRAGMENT_BIT;
+        layoutInfo.pBindings = &textureBinding;
+        Check(vkCreateDescriptorSetLayout(m_device, &layoutInfo, nullptr, &m_textureLayout),
+              "vkCreateDescriptorSetLayout");
+
+        const VkDescriptorSetLayout setLayouts[] = {m_viewLayout, m_textureLayout};
+        VkPipelineLayoutCreateInfo pipelineLayoutInfo = {VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO};
+        pipelineLayoutInfo.setLayoutCount = 2;
+        pipelineLayoutInfo.pSetLayouts = setLayouts;
+        Check(vkCreatePipelineLayout(m_device, &pipelineLayoutInfo, nullptr, &m_pipelineLayout),
+              "vkCreatePipelineLayout");
+
+        // The ring's view sets and the white texture's set; rings are only replaced when grown
+        const VkDescriptorPoolSize poolSizes[] = {
+            {VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC, 8},
+            {VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, 1},
+        };
+        VkDescriptorPoolCreateInfo poolInfo = {VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO};
+        poolInfo.flags = VK_DESCRIPTOR_POOL_CREATE_FREE_DESCRIPTOR_SET_BIT;
+        poolInfo.maxSets = 9;
+        poolInfo.poolSizeCount = 2;
+        poolInfo.pPoolSizes = poolSizes;
+        Check(vkCreateDescriptorPool(m_device, &poolInfo, nullptr, &m_viewPool), "vkCreateDescriptorPool");
+
+        VkSamplerCreateInfo samplerInfo = {VK_STRUCTURE_TYPE_SAMPLER_CREATE_INFO};
+        samplerInfo.magFilter = VK_FILTER_LINEAR;
+        samplerInfo.minFilter = VK_FILTER_LINEAR;
+        samplerInfo.mipmapMode = VK_SAMPLER_MIPMAP_MODE_NEAREST;
+        samplerInfo.addressModeU = VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_EDGE;
+        samplerInfo.addressModeV = VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_EDGE;
+        samplerInfo.addressModeW = VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_EDGE;
+        samplerInfo.maxLod = 0.0f;
+        Check(vkCreateSampler(m_device, &samplerInfo, nullptr, &m_sampler), "vkCreateSampler");
+
+        VkShaderModuleCreateInfo shaderInfo = {VK_STRUCTURE_TYPE_SHADER_MODULE_CREATE_INFO};
+        shaderInfo.codeSize = sizeof(kSpriteVertexShader);
+        shaderInfo.pCode = kSpriteVertexShader;
+        Check(vkCreateShaderModule(m_device, &shaderInfo, nullptr, &m_vertexShader), "vkCreateShaderModule");
+        shaderInfo.codeSize = sizeof(kSpriteFragmentShader);
+        shaderInfo.pCode = kSpriteFragmentShader;
+        Check(vkCreateShaderModule(m_device, &shaderInfo, nullptr, &m_fragmentShader), "vkCreateShaderModule");
+    }
+
+    /**
+     * @brief Creates the pipeline of every blend mode for a colour format, through the pipeline
+     * cache; with a warm cache this skips shader compilation in the driver.
+     */
+    void VulkanRenderer::Impl::CreatePipelines(FormatSlot slot, VkFormat format)
+    {
+        POLARIS_PROFILE_SCOPE("VulkanRenderer::CreatePipelines");
+        for (VkPipeline& pipeline : m_pipelines[slot])
+        {
+            vkDestroyPipeline(m_device, pipeline, nullptr);
+            pipeline = VK_NULL_HANDLE;
+        }
+
+        VkPipelineShaderStageCreateInfo stages[2] = {
+            {VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO},
+            {VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO},
+        };
+        stages[0].stage = VK_SHADER_STAGE_VERTEX_BIT;
+        stages[0].module = m_vertexShader;
+        stages[0].pName = "main";
+        stages[1].stage = VK_SHADER_STAGE_FRAGMENT_BIT;
+        stages[1].module = m_fragmentShader;
+        stages[1].pName = "main";
+
+        const VkVertexInputBindingDescription binding = {0, sizeof(SDL_Vertex), VK_VERTEX_INPUT_RATE_VERTEX};
+        const VkVertexInputAttributeDescription attributes[] = {
+            {0, 0, VK_FORMAT_R32G32_SFLOAT, static_cast<std::uint32_t>(offsetof(SDL_Vertex, position))},
+            {1, 0, VK_FORMAT_R32G32B32A32_SFLOAT, static_cast<std::uint32_t>(offsetof(SDL_Vertex, color))},
+            {2, 0, VK_FORMAT_R32G32_SFLOAT, static_cast<std::uint32_t>(offsetof(SDL_Vertex, tex_coord))},
+        };
+        VkPipelineVertexInputStateCreateInfo vertexInput = {VK_STRUCTURE_TYPE_PIPELINE_VERTEX_INPUT_STATE_CREATE_INFO};
+        vertexInput.vertexBindingDescriptionCount = 1;
+        vertexInput.pVertexBindingDescriptions = &binding;
+        vertexInput.vertexAttributeDescriptionCount = 3;
+        vertexInput.pVertexAttributeDescriptions = attributes;
+
+        VkPipelineInputAssemblyStateCreateInfo inputAssembly = {
+            VK_STRUCTURE_TYPE_PIPELINE_INPUT_ASSEMBLY_STATE_CREATE_INFO};
+        inputAssembly.topology = VK_PRIMITIVE_TOPOLOGY_TRIANGLE_LIST;
+
+        VkPipelineViewportStateCreateInfo viewport = {VK_STRUCTURE_TYPE_PIPELINE_VIEWPORT_STATE_CREATE_INFO};
+        viewport.viewportCount = 1;
+        viewport.scissorCount = 1;
+
+        VkPipelineRasterizationStateCreateInfo rasterization = {
+            VK_STRUCTURE_TYPE_PIPELINE_RASTERIZATION_STATE_CREATE_INFO};
+        rasterization.polygonMode = VK_POLYGON_MODE_FILL;
+        rasterization.cullMode = VK_CULL_MODE_NONE;
+        rasterization.frontFace = VK_FRONT_FACE_COUNTER_CLOCKWISE;
+        rasterization.lineWidth = 1.0f;
+
+        VkPipelineMultisampleStateCreateInfo multisample = {VK_STRUCTURE_TYPE_PIPELINE_MULTISAMPLE_STATE_CREATE_INFO};
+        multisample.rasterizationSamples = VK_SAMPLE_COUNT_1_BIT;
+
+        const VkDynamicState dynamicStates[] = {VK_DYNAMIC_STATE_VIEWPORT, VK_DYNAMIC_STATE_SCISSOR};
+        VkPipelineDynamicStateCreateInfo dynamic = {VK_STRUCTURE_TYPE_PIPELINE_DYNAMIC_STATE_CREATE_INFO};
+        dynamic.dynamicStateCount = 2;
+        dynamic.pDynamicStates = dynamicStates;
+
+        VkPipelineRenderingCreateInfo rendering = {VK_STRUCTURE_TYPE_PIPELINE_RENDERING_CREATE_INFO};
+        rendering.colorAttachmentCount = 1;
+        rendering.pColorAttachmentFormats = &format;
+
+        VkPipelineColorBlendAttachmentState blends[kBlendModeCount];
+        VkPipelineColorBlendStateCreateInfo colorBlends[kBlendModeCount];
+        VkGraphicsPipelineCreateInfo pipelineInfos[kBlendModeCount];
+        for (int i = 0; i < kBlendModeCount; ++i)
+        {
+            blends[i] = BlendState(static_cast<BlendMode>(i));
+            colorBlends[i] = {VK_STRUCTURE_TYPE_PIPELINE_COLOR_BLEND_STATE_CREATE_INFO};
+            colorBlends[i].attachmentCount = 1;
+            colorBlends[i].pAttachments = &blends[i];
+
+            VkGraphicsPipelineCreateInfo& info = pipelineInfos[i];
+            info = {VK_STRUCTURE_TYPE_GRAPHICS_PIPELINE_CREATE_INFO};
+            info.pNext = &rendering;
+            info.stageCount = 2;
+            info.pStages = stages;
+            info.pVertexInputState = &vertexInput;
+            info.pInputAssemblyState = &inputAssembly;
+            info.pViewportState = &viewport;
+            info.pRasterizationState = &rasterization;
+            info.pMultisampleState = &multisample;
+            info.pColorBlendState = &colorBlends[i];
+            info.pDynamicState = &dynamic;
+            info.layout = m_pipelineLayout;
+        }
+        Check(vkCreateGraphicsPipelines(m_device, m_pipelineCache, kBlendModeCount, pipelineInfos, nullptr,
+                                        m_pipelines[slot]),
+              "vkCreateGraphicsPipelines");
+    }
+
+    /**
+     * @brief Creates the pipeline cache, seeded from disk if the file was written by this
+     * device and driver (the header's vendor, device and cache UUID match).
+     */
+    void VulkanRenderer::Impl::LoadPipelineCache()
+    {
+        std::string data;
+        if (!m_config.pipelineCachePath.empty())
+        {
+            std::ifstream file(m_config.pipelineCachePath, std::ios::binary);
+            if (file.is_open())
+            {
+                data.assign(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+            }
+        }
+
+        VkPipelineCacheHeaderVersionOne header = {};
+        if (!data.empty())
+        {
+            if (data.size() >= sizeof(header))
+            {
+                std::memcpy(&header, data.data(), sizeof(header));
+            }
+            const bool valid = data.size() >= sizeof(header) && header.headerSize >= sizeof(header) &&
+                               header.headerVersion == VK_PIPELINE_CACHE_HEADER_VERSION_ONE &&
+                               header.vendorID == m_properties.vendorID && header.deviceID == m_properties.deviceID &&
+                               std::memcmp(header.pipelineCacheUUID, m_properties.pipelineCacheUUID, VK_UUID_SIZE) == 0;
+            if (!valid)
+            {
+                LOG_INFO("Pipeline cache {} is from another device or driver, rebuilding it",
+                         m_config.pipelineCachePath);
+                data.clear();
+            }
+        }
+
+        VkPipelineCacheCreateInfo cacheInfo = {VK_STRUCTURE_TYPE_PIPELINE_CACHE_CREATE_INFO};
+        cacheInfo.initialDataSize = data.size();
+        cacheInfo.pInitialData = data.empty() ? nullptr : data.data();
+        Check(vkCreatePipelineCache(m_device, &cacheInfo, nullptr, &m_pipelineCache), "vkCreatePipelineCache");
+        if (!data.empty())
+        {
+            LOG_INFO("Loaded {} bytes of pipeline cache from {}", data.size(), m_config.pipelineCachePath);
+        }
+    }
+
+    /**
+     * @brief Writes the pipeline cache to a temporary file and renames it over the old one, so
+     * an interrupted save never leaves a truncated cache behind.
+     */
+    void VulkanRenderer::Impl::SavePipelineCache()
+    {
+        if (!m_pipelineCache || m_config.pipelineCachePath.empty())
+        {
+            return;
+        }
+        std::size_t size = 0;
+        if (vkGetPipelineCacheData(m_device, m_pipelineCache, &size, nullptr) != VK_SUCCESS || size == 0)
+        {
+            return;
+        }
+        std::vector<char> data(size);
+        if (vkGetPipelineCacheData(m_device, m_pipelineCache, &size, data.data()) != VK_SUCCESS)
+        {
+            return;
+        }
+
+        const std::string temporary = m_config.pipelineCachePath + ".tmp";
+        {
+            std::ofstream file(temporary, std::ios::binary | std::ios::trunc);
+            file.write(data.data(), static_cast<std::streamsize>(size));
+            if (!file)
+            {
+                LOG_WARN("Failed to write pipeline cache {}", temporary);
+                return;
+            }
+        }
+        std::remove(m_config.pipelineCachePath.c_str());
+        if (std::rename(temporary.c_str(), m_config.pipelineCachePath.c_str()) != 0)
+        {
+            LOG_WARN("Failed to replace pipeline cache {}", m_config.pipelineCachePath);
+        }
+    }
+
+    std::uint32_t VulkanRenderer::Impl::FindMemoryType(std::uint32_t typeBits, VkMemoryPropertyFlags properties) const
+    {
+        for (std::uint32_t i = 0; i < m_memoryProperties.memoryTypeCount; ++i)
+        {
+            if ((typeBits & (1u << i)) && (m_memoryProperties.memoryTypes[i].propertyFlags & properties) == properties)
+            {
+                return i;
+            }
+        }
+        throw std::runtime_error("No suitable Vulkan memory type");
+    }
+
+    /**
+     * @brief Creates a host-visible, coherent buffer and maps it for its whole lifetime.
+     */
+    void VulkanRenderer::Impl::CreateBuffer(VkDeviceSize size, VkBufferUsageFlags usage, Buffer& buffer)
+    {
+        VkBufferCreateInfo bufferInfo = {VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO};
+        bufferInfo.size = size;
+        bufferInfo.usage = usage;
+        bufferInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+        Check(vkCreateBuffer(m_device, &bufferInfo, nullptr, &buffer.buffer), "vkCreateBuffer");
+
+        VkMemoryRequirements requirements;
+        vkGetBufferMemoryRequirements(m_device, buffer.buffer, &requirements);
+        VkMemoryAllocateInfo allocateInfo = {VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO};
+        allocateInfo.allocationSize = requirements.size;
+        allocateInfo.memoryTypeIndex = FindMemoryType(
+            requirements.memoryTypeBits, VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT);
+        Check(vkAllocateMemory(m_device, &allocateInfo, nullptr, &buffer.memory), "vkAllocateMemory");
+        Check(vkBindBufferMemory(m_device, buffer.buffer, buffer.memory, 0), "vkBindBufferMemory");
+        void* mapped = nullptr;
+        Check(vkMapMemory(m_device, buffer.memory, 0, VK_WHOLE_SIZE, 0, &mapped), "vkMapMemory");
+        buffer.mapped = static_cast<std::uint8_t*>(mapped);
+        buffer.size = size;
+    }
+
+    void VulkanRenderer::Impl::DestroyBuffer(Buffer& buffer)
+    {
+        vkDestroyBuffer(m_device, buffer.buffer, nullptr);
+        vkFreeMemory(m_device, buffer.memory, nullptr);
+        buffer = Buffer();
+    }
+
+    void VulkanRenderer::Impl::CreateImage(int width, int height, VkImageUsageFlags usage, Image& image)
+    {
+        VkImageCreateInfo imageInfo = {VK_STRUCTURE_TYPE_IMAGE_CREATE_INFO};
+        imageInfo.imageType = VK_IMAGE_TYPE_2D;
+        imageInfo.format = kTextureFormat;
+        imageInfo.extent = {static_cast<std::uint32_t>(width), static_cast<std::uint32_t>(height), 1};
+        imageInfo.mipLevels = 1;
+        imageInfo.arrayLayers = 1;
+        imageInfo.samples = VK_SAMPLE_COUNT_1_BIT;
+        imageInfo.tiling = VK_IMAGE_TILING_OPTIMAL;
+        imageInfo.usage = usage;
+        imageInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+        imageInfo.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+        Check(vkCreateImage(m_device, &imageInfo, nullptr, &image.image), "vkCreateImage");
+
+        VkMemoryRequirements requirements;
+        vkGetImageMemoryRequirements(m_device, image.image, &requirements);
+        VkMemoryAllocateInfo allocateInfo = {VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO};
+        allocateInfo.allocationSize = requirements.size;
+        allocateInfo.memoryTypeIndex = FindMemoryType(requirements.memoryTypeBits, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT);
+        Check(vkAllocateMemory(m_device, &allocateInfo, nullptr, &image.memory), "vkAllocateMemory");
+        Check(vkBindImageMemory(m_device, image.image, image.memory, 0), "vkBindImageMemory");
+
+        VkImageViewCreateInfo viewInfo = {VK_STRUCTURE_TYPE_IMAGE_VIEW_CREATE_INFO};
+        viewInfo.image = image.image;
+        viewInfo.viewType = VK_IMAGE_VIEW_TYPE_2D;
+        viewInfo.format = kTextureFormat;
+        viewInfo.subresourceRange = {VK_IMAGE_ASPECT_COLOR_BIT, 0, 1, 0, 1};
+        Check(vkCreateImageView(m_device, &viewInfo, nullptr, &image.view), "vkCreateImageView");
+        image.width = width;
+        image.height = height;
+    }
+
+    void VulkanRenderer::Impl::DestroyImage(Image& image)
+    {
+        vkDestroyImageView(m_device, image.view, nullptr);
+        vkDestroyImage(m_device, image.image, nullptr);
+        vkFreeMemory(m_device, image.memory, nullptr);
+        image = Image();
+    }
+
+    /**
+     * @brief Replaces the ring buffer with an empty one of the given size. The old one is
+     * retired, as frames in flight may still read it.
+     */
+    void VulkanRenderer::Impl::CreateRing(VkDeviceSize size)
+    {
+        if (m_ring.buffer.buffer)
+        {
+            Retired retired;
+            retired.buffer = m_ring.buffer;
+            retired.descriptorSet = m_ring.viewSet;
+            retired.descriptorPool = m_viewPool;
+            Retire(retired);
+        }
+
+        Ring ring;
+        ring.generation = m_ring.generation + 1;
+        CreateBuffer(size,
+                     VK_BUFFER_USAGE_VERTEX_BUFFER_BIT | VK_BUFFER_USAGE_INDEX_BUFFER_BIT |
+                         VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT,
+                     ring.buffer);
+
+        VkDescriptorSetAllocateInfo setInfo = {VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO};
+        setInfo.descriptorPool = m_viewPool;
+        setInfo.descriptorSetCount = 1;
+        setInfo.pSetLayouts = &m_viewLayout;
+        Check(vkAllocateDescriptorSets(m_device, &setInfo, &ring.viewSet), "vkAllocateDescriptorSets");
+        VkDescriptorBufferInfo bufferInfo = {ring.buffer.buffer, 0, sizeof(View)};
+        VkWriteDescriptorSet write = {VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET};
+        write.dstSet = ring.viewSet;
+        write.descriptorCount = 1;
+        write.descriptorType = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC;
+        write.pBufferInfo = &bufferInfo;
+        vkUpdateDescriptorSets(m_device, 1, &write, 0, nullptr);
+        m_ring = ring;
+    }
+
+    /**
+     * @brief Queues resources for destruction once everything submitted so far, and the frame
+     * being recorded, has completed.
+     */
+    void VulkanRenderer::Impl::Retire(const Retired& resources)
+    {
+        m_retiring.push_back(resources);
+    }
+
+    void VulkanRenderer::Impl::CollectRetired(std::uint64_t completed)
+    {
+        std::size_t kept = 0;
+        for (Retired& resources : m_retired)
+        {
+            if (resources.serial > completed)
+            {
+                m_retired[kept++] = resources;
+                continue;
+            }
+            if (resources.descriptorSet)
+            {
+                vkFreeDescriptorSets(m_device, resources.descriptorPool, 1, &resources.descriptorSet);
+            }
+            if (resources.buffer.buffer)
+            {
+                DestroyBuffer(resources.buffer);
+            }
+            if (resources.image.image)
+            {
+                DestroyImage(resources.image);
+            }
+        }
+        m_retired.resize(kept);
+    }
+
+    std::uint64_t VulkanRenderer::Impl::CompletedSerial() const
+    {
+        std::uint64_t value = 0;
+        Check(vkGetSemaphoreCounterValue(m_device, m_timeline, &value), "vkGetSemaphoreCounterValue");
+        return value;
+    }
+
+    void VulkanRenderer::Impl::WaitForSerial(std::uint64_t serial) const
+    {
+        if (serial == 0)
+        {
+            return;
+        }
+        VkSemaphoreWaitInfo waitInfo = {VK_STRUCTURE_TYPE_SEMAPHORE_WAIT_INFO};
+        waitInfo.semaphoreCount = 1;
+        waitInfo.pSemaphores = &m_timeline;
+        waitInfo.pValues = &serial;
+        Check(vkWaitSemaphores(m_device, &waitInfo, UINT64_MAX), "vkWaitSemaphores");
+    }
+
+    /**
+     * @brief Waits until the frame that last used this frame slot has completed, reclaims its
+     * ring space and whatever was retired before it, and starts recording.
+     */
+    void VulkanRenderer::Impl::BeginFrame()
+    {
+        Frame& frame = m_frames[m_frameIndex];
+        {
+            POLARIS_PROFILE_SCOPE("VulkanRenderer::WaitForFrame");
+            WaitForSerial(frame.serial);
+        }
+        if (frame.ringGeneration == m_ring.generation)
+        {
+            m_ring.tail = std::max(m_ring.tail, frame.ringEnd);
+        }
+        CollectRetired(CompletedSerial());
+
+        if (m_surface && !m_swapchainDirty && !m_imageAcquired)
+        {
+            int width = 0;
+            int height = 0;
+            SDL_GetWindowSizeInPixels(m_window, &width, &height);
+            m_swapchainDirty = static_cast<std::uint32_t>(width) != m_swapchainExtent.width ||
+                               static_cast<std::uint32_t>(height) != m_swapchainExtent.height;
+        }
+        if (m_surface && m_swapchainDirty && !m_imageAcquired)
+        {
+            vkDeviceWaitIdle(m_device);
+            CreateSwapchain();
+            BindTarget(m_targetHandle);
+        }
+
+        Check(vkResetCommandPool(m_device, frame.pool, 0), "vkResetCommandPool");
+        VkCommandBufferBeginInfo beginInfo = {VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO};
+        beginInfo.flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT;
+        Check(vkBeginCommandBuffer(frame.commands, &beginInfo), "vkBeginCommandBuffer");
+        m_commands = frame.commands;
+        m_waitForAcquire = false;
+        m_ringWarned = false;
+    }
+
+    /**
+     * @brief Submits the frame after the uploads it depends on, and presents if asked to. The
+     * frame waits on the uploads' timeline value and on the image acquire, and signals the next
+     * timeline value, which BeginFrame() waits for before reusing the slot.
+     */
+    void VulkanRenderer::Impl::EndFrame(bool present)
+    {
+        Frame& frame = m_frames[m_frameIndex];
+        ClosePass();
+        present = present && m_imageAcquired;
+        if (present)
+        {
+            VkImageLayout& layout = m_swapchainLayouts[m_imageIndex];
+            Transition(m_commands, m_swapchainImages[m_imageIndex], layout, VK_IMAGE_LAYOUT_PRESENT_SRC_KHR);
+            layout = VK_IMAGE_LAYOUT_PRESENT_SRC_KHR;
+        }
+        Check(vkEndCommandBuffer(m_commands), "vkEndCommandBuffer");
+
+        const std::uint64_t uploads = SubmitUploads();
+        std::vector<VkSemaphore> waitSemaphores;
+        std::vector<std::uint64_t> waitValues;
+        std::vector<VkPipelineStageFlags> waitStages;
+        if (uploads)
+        {
+            waitSemaphores.push_back(m_timeline);
+            waitValues.push_back(uploads);
+            waitStages.push_back(VK_PIPELINE_STAGE_ALL_COMMANDS_BIT);
+        }
+        if (m_waitForAcquire)
+        {
+            waitSemaphores.push_back(frame.imageAcquired);
+            waitValues.push_back(0);
+            waitStages.push_back(VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT);
+        }
+        const VkSemaphore signalSemaphores[] = {m_timeline, present ? m_renderFinished[m_imageIndex] : VK_NULL_HANDLE};
+        const std::uint64_t signalValues[] = {++m_timelineValue, 0};
+
+        VkTimelineSemaphoreSubmitInfo timelineInfo = {VK_STRUCTURE_TYPE_TIMELINE_SEMAPHORE_SUBMIT_INFO};
+        timelineInfo.waitSemaphoreValueCount = static_cast<std::uint32_t>(waitValues.size());
+        timelineInfo.pWaitSemaphoreValues = waitValues.data();
+        timelineInfo.signalSemaphoreValueCount = present ? 2 : 1;
+        timelineInfo.pSignalSemaphoreValues = signalValues;
+        VkSubmitInfo submitInfo = {VK_STRUCTURE_TYPE_SUBMIT_INFO};
+        submitInfo.pNext = &timelineInfo;
+        submitInfo.waitSemaphoreCount = static_cast<std::uint32_t>(waitSemaphores.size());
+        submitInfo.pWaitSemaphores = waitSemaphores.data();
+        submitInfo.pWaitDstStageMask = waitStages.data();
+        submitInfo.commandBufferCount = 1;
+        submitInfo.pCommandBuffers = &m_commands;
+        submitInfo.signalSemaphoreCount = present ? 2 : 1;
+        submitInfo.pSignalSemaphores = signalSemaphores;
+        Check(vkQueueSubmit(m_queue, 1, &submitInfo, VK_NULL_HANDLE), "vkQueueSubmit");
+
+        frame.serial = m_timelineValue;
+        frame.ringEnd = m_ring.head;
+        frame.ringGeneration = m_ring.generation;
+        for (Retired& resources : m_retiring)
+        {
+            resources.serial = m_timelineValue;
+            m_retired.push_back(resources);
+        }
+        m_retiring.clear();
+        m_commands = VK_NULL_HANDLE;
+        m_frameIndex = (m_frameIndex + 1) % m_frames.size();
+
+        if (present)
+        {
+            VkPresentInfoKHR presentInfo = {VK_STRUCTURE_TYPE_PRESENT_INFO_KHR};
+            presentInfo.waitSemaphoreCount = 1;
+            presentInfo.pWaitSemaphores = &m_renderFinished[m_imageIndex];
+            presentInfo.swapchainCount = 1;
+            presentInfo.pSwapchains = &m_swapchain;
+            presentInfo.pImageIndices = &m_imageIndex;
+            const VkResult result = vkQueuePresentKHR(m_queue, &presentInfo);
+            if (result == VK_ERROR_OUT_OF_DATE_KHR || result == VK_SUBOPTIMAL_KHR)
+            {
+                m_swapchainDirty = true;
+            }
+            else if (result != VK_SUCCESS)
+            {
+                Check(result, "vkQueuePresentKHR");
+            }
+            m_swapchainLayouts[m_imageIndex] = VK_IMAGE_LAYOUT_UNDEFINED;
+            m_imageAcquired = false;
+        }
+    }
+
+    /**
+     * @brief Allocates from the ring buffer, growing it if the frames in flight have used it up.
+     */
+    VulkanRenderer::Impl::Allocation VulkanRenderer::Impl::AllocateRing(VkDeviceSize size, VkDeviceSize alignment)
+    {
+        VkDeviceSize capacity = m_ring.buffer.size;
+        std::uint64_t position = AlignUp(m_ring.head, alignment);
+        if (position % capacity + size > capacity)
+        {
+            position = AlignUp(position + 1, capacity);
+        }
+        if (size > capacity || position + size - m_ring.tail > capacity)
+        {
+            const VkDeviceSize grown = AlignUp(std::max(capacity * 2, size * 2), kRingGranularity);
+            if (!m_ringWarned)
+            {
+                LOG_INFO("Growing the Vulkan ring buffer to {} KB", grown / 1024);
+                m_ringWarned = true;
+            }
+            CreateRing(grown);
+            capacity = grown;
+            position = 0;
+        }
+        m_ring.head = position + size;
+        const VkDeviceSize offset = position % capacity;
+        return {m_ring.buffer.buffer, offset, m_ring.buffer.mapped + offset, m_ring.viewSet};
+    }
+
+    /**
+     * @brief Returns the upload command buffer, starting a batch whose staging buffer the GPU
+     * has finished with if none is being recorded.
+     */
+    VkCommandBuffer VulkanRenderer::Impl::BeginUpload()
+    {
+        if (m_upload)
+        {
+            return m_upload->commands;
+        }
+
+        const std::uint64_t completed = CompletedSerial();
+        for (UploadBatch& upload : m_uploads)
+        {
+            if (upload.serial <= completed)
+            {
+                m_upload = &upload;
+                break;
+            }
+        }
+        if (!m_upload)
+        {
+            UploadBatch upload;
+            VkCommandPoolCreateInfo poolInfo = {VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO};
+            poolInfo.flags = VK_COMMAND_POOL_CREATE_TRANSIENT_BIT;
+            poolInfo.queueFamilyIndex = m_queueFamily;
+            Check(vkCreateCommandPool(m_device, &poolInfo, nullptr, &upload.pool), "vkCreateCommandPool");
+            VkCommandBufferAllocateInfo allocateInfo = {VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO};
+            allocateInfo.commandPool = upload.pool;
+            allocateInfo.level = VK_COMMAND_BUFFER_LEVEL_PRIMARY;
+            allocateInfo.commandBufferCount = 1;
+            Check(vkAllocateCommandBuffers(m_device, &allocateInfo, &upload.commands), "vkAllocateCommandBuffers");
+            CreateBuffer(AlignUp(std::max<VkDeviceSize>(m_config.stagingBufferSize, 4), 4),
+                         VK_BUFFER_USAGE_TRANSFER_SRC_BIT, upload.staging);
+            m_uploads.push_back(upload);
+            m_upload = &m_uploads.back();
+        }
+
+        Check(vkResetCommandPool(m_device, m_upload->pool, 0), "vkResetCommandPool");
+        VkCommandBufferBeginInfo beginInfo = {VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO};
+        beginInfo.flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT;
+        Check(vkBeginCommandBuffer(m_upload->commands, &beginInfo), "vkBeginCommandBuffer");
+        m_upload->used = 0;
+        return m_upload->commands;
+    }
+
+    /**
+     * @brief Allocates staging memory in the current upload batch. A full staging buffer is
+     * retired, as copies already recorded read from it, and replaced with a larger one.
+     */
+    std::uint8_t* VulkanRenderer::Impl::AllocateStaging(VkDeviceSize size, VkDeviceSize& offset)
+    {
+        BeginUpload();
+        // Texel copies need 4-byte aligned buffer offsets for RGBA8
+        offset = AlignUp(m_upload->used, 4);
+        if (offset + size > m_upload->staging.size)
+        {
+            Retired retired;
+            retired.buffer = m_upload->staging;
+            Retire(retired);
+            CreateBuffer(AlignUp(std::max(m_upload->staging.size * 2, size), 4), VK_BUFFER_USAGE_TRANSFER_SRC_BIT,
+                         m_upload->staging);
+            offset = 0;
+        }
+        m_upload->used = offset + size;
+        return m_upload->staging.mapped + offset;
+    }
+
+    /**
+     * @brief Submits the upload batch being recorded, if any.
+     * @return The timeline value signalled once its copies complete, or 0 without uploads.
+     */
+    std::uint64_t VulkanRenderer::Impl::SubmitUploads()
+    {
+        if (!m_upload)
+        {
+            return 0;
+        }
+        Check(vkEndCommandBuffer(m_upload->commands), "vkEndCommandBuffer");
+        m_upload->serial = ++m_timelineValue;
+
+        VkTimelineSemaphoreSubmitInfo timelineInfo = {VK_STRUCTURE_TYPE_TIMELINE_SEMAPHORE_SUBMIT_INFO};
+        timelineInfo.signalSemaphoreValueCount = 1;
+        timelineInfo.pSignalSemaphoreValues = &m_upload->serial;
+        VkSubmitInfo submitInfo = {VK_STRUCTURE_TYPE_SUBMIT_INFO};
+        submitInfo.pNext = &timelineInfo;
+        submitInfo.commandBufferCount = 1;
+        submitInfo.pCommandBuffers = &m_upload->commands;
+        submitInfo.signalSemaphoreCount = 1;
+        submitInfo.pSignalSemaphores = &m_timeline;
+        Check(vkQueueSubmit(m_queue, 1, &submitInfo, VK_NULL_HANDLE), "vkQueueSubmit");
+
+        const std::uint64_t serial = m_upload->serial;
+        m_upload = nullptr;
+        return serial;
+    }
+
+    VulkanRenderer::Impl::Texture* VulkanRenderer::Impl::GetTexture(TextureHandle handle)
+    {
+        return handle != 0 && handle < m_textures.size() && m_textures[handle].image.image ? &m_textures[handle]
+                                                                                           : nullptr;
+    }
+
+    /**
+     * @brief Records a copy from the staging buffer into part of a texture. The texture is in
+     * SHADER_READ_ONLY_OPTIMAL before and after; on the same queue, the barrier also waits for
+     * earlier frames still sampling it.
+     */
+    void VulkanRenderer::Impl::UploadRegion(Texture& texture, VkDeviceSize offset, std::uint32_t rowLength,
+                                            const VkRect2D& region)
+    {
+        VkCommandBuffer commands = BeginUpload();
+        const bool whole = region.offset.x == 0 && region.offset.y == 0 &&
+                           region.extent.width == static_cast<std::uint32_t>(texture.image.width) &&
+                           region.extent.height == static_cast<std::uint32_t>(texture.image.height);
+        Transition(commands, texture.image.image,
+                   whole ? VK_IMAGE_LAYOUT_UNDEFINED : VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL,
+                   VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL);
+        VkBufferImageCopy copy = {};
+        copy.bufferOffset = offset;
+        copy.bufferRowLength = rowLength;
+        copy.imageSubresource = {VK_IMAGE_ASPECT_COLOR_BIT, 0, 0, 1};
+        copy.imageOffset = {region.offset.x, region.offset.y, 0};
+        copy.imageExtent = {region.extent.width, region.extent.height, 1};
+        vkCmdCopyBufferToImage(commands, m_upload->staging.buffer, texture.image.image,
+                               VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, 1, &copy);
+        Transition(commands, texture.image.image, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+                   VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL);
+    }
+
+    void VulkanRenderer::Impl::CreateTexture(const RenderCommand& command, const CommandList& commands)
+    {
+        if (command.width <= 0 || command.height <= 0 || command.width > kMaxTextureSize ||
+            command.height > kMaxTextureSize)
+        {
+            LOG_ERROR("Failed to create {}x{} texture: unsupported size", command.width, command.height);
+            return;
+        }
+        if (command.texture >= m_textures.size())
+        {
+            m_textures.resize(command.texture + 1);
+            m_textureSizes.resize(command.texture + 1);
+        }
+        if (GetTexture(command.texture))
+        {
+            DestroyTexture(command.texture);
+        }
+
+        Texture& texture = m_textures[command.texture];
+        texture.target = command.access == TextureAccess::Target;
+        texture.colorspace = command.colorspace;
+        CreateImage(command.width, command.height,
+                    VK_IMAGE_USAGE_SAMPLED_BIT | VK_IMAGE_USAGE_TRANSFER_DST_BIT |
+                        (texture.target ? VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT : 0),
+                    texture.image);
+
+        // Allocate from the newest pool, adding one when it runs out
+        VkDescriptorSetAllocateInfo setInfo = {VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO};
+        setInfo.descriptorSetCount = 1;
+        setInfo.pSetLayouts = &m_textureLayout;
+        VkResult result = VK_ERROR_OUT_OF_POOL_MEMORY;
+        if (!m_texturePools.empty())
+        {
+            setInfo.descriptorPool = m_texturePools.back();
+            result = vkAllocateDescriptorSets(m_device, &setInfo, &texture.descriptorSet);
+        }
+        if (result == VK_ERROR_OUT_OF_POOL_MEMORY || result == VK_ERROR_FRAGMENTED_POOL)
+        {
+            const VkDescriptorPoolSize poolSize = {VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, kTexturesPerDescriptorPool};
+            VkDescriptorPoolCreateInfo poolInfo = {VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO};
+            poolInfo.flags = VK_DESCRIPTOR_POOL_CREATE_FREE_DESCRIPTOR_SET_BIT;
+            poolInfo.maxSets = kTexturesPerDescriptorPool;
+            poolInfo.poolSizeCount = 1;
+            poolInfo.pPoolSizes = &poolSize;
+            VkDescriptorPool pool = VK_NULL_HANDLE;
+            Check(vkCreateDescriptorPool(m_device, &poolInfo, nullptr, &pool), "vkCreateDescriptorPool");
+            m_texturePools.push_back(pool);
+            setInfo.descriptorPool = pool;
+            result = vkAllocateDescriptorSets(m_device, &setInfo, &texture.descriptorSet);
+        }
+        Check(result, "vkAllocateDescriptorSets");
+        texture.descriptorPool = setInfo.descriptorPool;
+
+        VkDescriptorImageInfo imageInfo = {m_sampler, texture.image.view, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL};
+        VkWriteDescriptorSet write = {VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET};
+        write.dstSet = texture.descriptorSet;
+        write.descriptorCount = 1;
+        write.descriptorType = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
+        write.pImageInfo = &imageInfo;
+        vkUpdateDescriptorSets(m_device, 1, &write, 0, nullptr);
+
+        // Initial contents: the pixels, or transparent black (opaque black for YUV, like SDL)
+        const std::size_t texels = static_cast<std::size_t>(command.width) * command.height;
+        VkDeviceSize offset = 0;
+        std::uint8_t* staging = AllocateStaging(texels * 4, offset);
+        const std::size_t copied = std::min<std::size_t>(command.count, texels * 4);
+        std::memcpy(staging, commands.GetPayload(command.first), copied);
+        const std::uint32_t fill = command.format == TextureFormat::RGBA8 ? 0u : 0xFF000000u;
+        for (std::size_t i = copied / 4; i < texels; ++i)
+        {
+            std::memcpy(staging + i * 4, &fill, sizeof(fill));
+        }
+        UploadRegion(texture, offset, 0,
+                     {{0, 0}, {static_cast<std::uint32_t>(command.width), static_cast<std::uint32_t>(command.height)}});
+
+        m_textureSizes[command.texture] = {nullptr, static_cast<float>(command.width),
+                                           static_cast<float>(command.height)};
+    }
+
+    void VulkanRenderer::Impl::UpdateTexture(const RenderCommand& command, const CommandList& commands)
+    {
+        Texture* texture = GetTexture(command.texture);
+        if (!texture || command.pitch <= 0)
+        {
+            return;
+        }
+        SDL_Rect region = {0, 0, texture->image.width, texture->image.height};
+        if (command.hasRegion)
+        {
+            region = command.region;
+        }
+        const int rows = std::min(region.h, static_cast<int>(command.count / command.pitch));
+        const int columns = std::min(region.w, command.pitch / 4);
+        const int left = std::max(region.x, 0);
+        const int top = std::max(region.y, 0);
+        const int right = std::min(region.x + columns, texture->image.width);
+        const int bottom = std::min(region.y + rows, texture->image.height);
+        if (left >= right || top >= bottom)
+        {
+            return;
+        }
+
+        const std::size_t rowSize = static_cast<std::size_t>(right - left) * 4;
+        VkDeviceSize offset = 0;
+        std::uint8_t* staging = AllocateStaging(rowSize * (bottom - top), offset);
+        const std::uint8_t* payload = commands.GetPayload(command.first);
+        for (int y = top; y < bottom; ++y)
+        {
+            std::memcpy(staging + rowSize * (y - top),
+                        payload + static_cast<std::size_t>(y - region.y) * command.pitch + (left - region.x) * 4,
+                        rowSize);
+        }
+        UploadRegion(*texture, offset, 0,
+                     {{left, top}, {static_cast<std::uint32_t>(right - left), static_cast<std::uint32_t>(bottom - top)}});
+    }
+
+    void VulkanRenderer::Impl::UpdateTextureYUV(const RenderCommand& command, const CommandList& commands)
+    {
+        Texture* texture = GetTexture(command.texture);
+        if (!texture)
+        {
+            return;
+        }
+        if (command.region.w > texture->image.width || command.region.h > texture->image.height)
+        {
+            LOG_ERROR("Failed to update texture {}: {}x{} YUV upload is larger than the texture", command.texture,
+                      command.region.w, command.region.h);
+            return;
+        }
+        VkDeviceSize offset = 0;
+        std::uint8_t* staging = AllocateStaging(static_cast<VkDeviceSize>(command.region.w) * command.region.h * 4,
+                                                offset);
+        commands.DecodeYUV(command, texture->colorspace, reinterpret_cast<std::uint32_t*>(staging), command.region.w);
+        UploadRegion(*texture, offset, 0,
+                     {{0, 0}, {static_cast<std::uint32_t>(command.region.w), static_cast<std::uint32_t>(command.region.h)}});
+    }
+
+    void VulkanRenderer::Impl::DestroyTexture(TextureHandle handle)
+    {
+        Texture* texture = GetTexture(handle);
+        if (!texture)
+        {
+            return;
+        }
+        if (handle == m_targetHandle)
+        {
+            ClosePass();
+            BindTarget(0);
+        }
+        Retired retired;
+        retired.image = texture->image;
+        retired.descriptorSet = texture->descriptorSet;
+        retired.descriptorPool = texture->descriptorPool;
+        Retire(retired);
+        *texture = Texture();
+        m_textureSizes[handle] = SpriteBatch::Texture();
+    }
+
+    /**
+     * @brief Draws into a target texture from now on, or into the window (or offscreen image)
+     * for 0 or a handle that is not a target texture. No pass may be open.
+     */
+    void VulkanRenderer::Impl::BindTarget(TextureHandle handle)
+    {
+        Texture* texture = GetTexture(handle);
+        if (texture && !texture->target)
+        {
+            LOG_WARN("Texture {} was not created as a render target", handle);
+            texture = nullptr;
+        }
+
+        m_target = Target();
+        m_targetHandle = texture ? handle : 0;
+        if (texture)
+        {
+            m_target.image = texture->image.image;
+            m_target.view = texture->image.view;
+            m_target.extent = {static_cast<std::uint32_t>(texture->image.width),
+                               static_cast<std::uint32_t>(texture->image.height)};
+            m_target.slot = kTextureSlot;
+            m_textureTargetLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+            m_target.layout = &m_textureTargetLayout;
+        }
+        else if (!m_surface)
+        {
+            m_target.image = m_offscreen.image;
+            m_target.view = m_offscreen.view;
+            m_target.extent = {static_cast<std::uint32_t>(m_offscreen.width),
+                               static_cast<std::uint32_t>(m_offscreen.height)};
+            m_target.slot = kTextureSlot;
+            m_target.layout = &m_offscreenLayout;
+        }
+        else
+        {
+            // The swapchain image is only known once acquired, in OpenPass()
+            m_target.extent = m_swapchainExtent;
+            m_target.slot = kSwapchainSlot;
+        }
+    }
+
+    /**
+     * @brief Acquires the next swapchain image, recreating an out of date swapchain once.
+     * @return false if there is no image to draw into this frame.
+     */
+    bool VulkanRenderer::Impl::AcquireImage()
+    {
+        if (m_imageAcquired)
+        {
+            return true;
+        }
+        for (int attempt = 0; attempt < 2 && m_swapchain; ++attempt)
+        {
+            const VkResult result = vkAcquireNextImageKHR(m_device, m_swapchain, UINT64_MAX,
+                                                          m_frames[m_frameIndex].imageAcquired, VK_NULL_HANDLE,
+                                                          &m_imageIndex);
+            if (result == VK_SUCCESS || result == VK_SUBOPTIMAL_KHR)
+            {
+                m_swapchainDirty = result == VK_SUBOPTIMAL_KHR;
+                m_imageAcquired = true;
+                m_waitForAcquire = true;
+                return true;
+            }
+            if (result != VK_ERROR_OUT_OF_DATE_KHR)
+            {
+                Check(result, "vkAcquireNextImageKHR");
+            }
+            vkDeviceWaitIdle(m_device);
+            CreateSwapchain();
+        }
+        return false;
+    }
+
+    /**
+     * @brief Begins dynamic rendering into the target, applying a pending clear as its load
+     * operation, and binds the View uniform for the target's size.
+     * @return false if there is nothing to draw into (a minimised window).
+     */
+    bool VulkanRenderer::Impl::OpenPass()
+    {
+        if (m_passOpen)
+        {
+            return true;
+        }
+        if (m_target.slot == kSwapchainSlot && m_targetHandle == 0)
+        {
+            if (!AcquireImage())
+            {
+                return false;
+            }
+            m_target.image = m_swapchainImages[m_imageIndex];
+            m_target.view = m_swapchainViews[m_imageIndex];
+            m_target.extent = m_swapchainExtent;
+            m_target.layout = &m_swapchainLayouts[m_imageIndex];
+        }
+        if (!m_target.image)
+        {
+            return false;
+        }
+
+        Transition(m_commands, m_target.image, *m_target.layout, VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL);
+        *m_target.layout = VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL;
+
+        VkRenderingAttachmentInfo attachment = {VK_STRUCTURE_TYPE_RENDERING_ATTACHMENT_INFO};
+        attachment.imageView = m_target.view;
+        attachment.imageLayout = VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL;
+        attachment.loadOp = m_clearPending ? VK_ATTACHMENT_LOAD_OP_CLEAR : VK_ATTACHMENT_LOAD_OP_LOAD;
+        attachment.storeOp = VK_ATTACHMENT_STORE_OP_STORE;
+        attachment.clearValue.color = m_clearColor;
+        m_clearPending = false;
+
+        VkRenderingInfo renderingInfo = {VK_STRUCTURE_TYPE_RENDERING_INFO};
+        renderingInfo.renderArea = {{0, 0}, m_target.extent};
+        renderingInfo.layerCount = 1;
+        renderingInfo.colorAttachmentCount = 1;
+        renderingInfo.pColorAttachments = &attachment;
+        vkCmdBeginRendering(m_commands, &renderingInfo);
+        m_passOpen = true;
+
+        const float width = static_cast<float>(m_target.extent.width);
+        const float height = static_cast<float>(m_target.extent.height);
+        const VkViewport viewport = {0.0f, 0.0f, width, height, 0.0f, 1.0f};
+        const VkRect2D scissor = {{0, 0}, m_target.extent};
+        vkCmdSetViewport(m_commands, 0, 1, &viewport);
+        vkCmdSetScissor(m_commands, 0, 1, &scissor);
+
+        const View view = {{2.0f / width, 2.0f / height}, {-1.0f, -1.0f}};
+        const Allocation uniform = AllocateRing(sizeof(View), m_properties.limits.minUniformBufferOffsetAlignment);
+        std::memcpy(uniform.data, &view, sizeof(View));
+        const std::uint32_t dynamicOffset = static_cast<std::uint32_t>(uniform.offset);
+        vkCmdBindDescriptorSets(m_commands, VK_PIPELINE_BIND_POINT_GRAPHICS, m_pipelineLayout, 0, 1, &uniform.viewSet,
+                                1, &dynamicOffset);
+        m_boundPipeline = VK_NULL_HANDLE;
+        m_boundTexture = VK_NULL_HANDLE;
+        return true;
+    }
+
+    /**
+     * @brief Ends the open pass, after opening one for a pending clear, and returns a target
+     * texture to SHADER_READ_ONLY_OPTIMAL for sampling.
+     */
+    void VulkanRenderer::Impl::ClosePass()
+    {
+        if (m_clearPending && !OpenPass())
+        {
+            m_clearPending = false;
+        }
+        if (!m_passOpen)
+        {
+            return;
+        }
+        vkCmdEndRendering(m_commands);
+        m_passOpen = false;
+        if (m_targetHandle != 0)
+        {
+            Transition(m_commands, m_target.image, *m_target.layout, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL);
+            *m_target.layout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+        }
+    }
+
+    void VulkanRenderer::Impl::Clear(const SDL_FColor& color)
+    {
+        m_clearColor.float32[0] = color.r;
+        m_clearColor.float32[1] = color.g;
+        m_clearColor.float32[2] = color.b;
+        m_clearColor.float32[3] = color.a;
+        if (!m_passOpen)
+        {
+            m_clearPending = true;
+            return;
+        }
+        VkClearAttachment attachment = {};
+        attachment.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+        attachment.colorAttachment = 0;
+        attachment.clearValue.color = m_clearColor;
+        const VkClearRect rect = {{{0, 0}, m_target.extent}, 0, 1};
+        vkCmdClearAttachments(m_commands, 1, &attachment, 1, &rect);
+    }
+
+    void VulkanRenderer::Impl::Bind(BlendMode blend, TextureHandle handle)
+    {
+        const VkPipeline pipeline = m_pipelines[m_target.slot][static_cast<int>(blend)];
+        if (pipeline != m_boundPipeline)
+        {
+            vkCmdBindPipeline(m_commands, VK_PIPELINE_BIND_POINT_GRAPHICS, pipeline);
+            m_boundPipeline = pipeline;
+        }
+        const Texture* texture = GetTexture(handle);
+        const VkDescriptorSet set = texture ? texture->descriptorSet : m_white.descriptorSet;
+        if (set != m_boundTexture)
+        {
+            vkCmdBindDescriptorSets(m_commands, VK_PIPELINE_BIND_POINT_GRAPHICS, m_pipelineLayout, 1, 1, &set, 0,
+                                    nullptr);
+            m_boundTexture = set;
+        }
+    }
+
+    /**
+     * @brief Makes the shared quad index buffer (0,1,2, 2,3,0, 4,5,6, ...) cover spriteCount
+     * sprites. It only ever grows; the old one is retired.
+     */
+    void VulkanRenderer::Impl::EnsureQuadIndices(std::size_t spriteCount)
+    {
+        const VkDeviceSize size = static_cast<VkDeviceSize>(spriteCount) * 6 * sizeof(std::uint32_t);
+        if (m_quadIndices.size >= size)
+        {
+            return;
+        }
+        if (m_quadIndices.buffer)
+        {
+            Retired retired;
+            retired.buffer = m_quadIndices;
+            Retire(retired);
+        }
+        const std::size_t capacity = std::max<std::size_t>(spriteCount, static_cast<std::size_t>(m_quadIndices.size / 24) * 2);
+        CreateBuffer(static_cast<VkDeviceSize>(capacity) * 6 * sizeof(std::uint32_t), VK_BUFFER_USAGE_INDEX_BUFFER_BIT,
+                     m_quadIndices);
+        std::uint32_t* indices = reinterpret_cast<std::uint32_t*>(m_quadIndices.mapped);
+        for (std::size_t i = 0; i < capacity; ++i)
+        {
+            const std::uint32_t first = static_cast<std::uint32_t>(i * 4);
+            const std::uint32_t quad[] = {first, first + 1, first + 2, first + 2, first + 3, first};
+            std::memcpy(indices + i * 6, quad, sizeof(quad));
+        }
+    }
+
+    /**
+     * @brief Draws the queued sprites with one indexed draw per run of sprites sharing a
+     * texture and blend mode, from vertices written straight into the ring buffer.
+     */
+    void VulkanRenderer::Impl::DrawSprites(RenderStats& stats)
+    {
+        const std::vector<const Sprite*>& sprites = m_spriteBatch.Prepare(m_textureSizes);
+        if (sprites.empty() || !OpenPass())
+        {
+            return;
+        }
+
+        POLARIS_PROFILE_SCOPE("VulkanRenderer::DrawSprites");
+        const std::vector<SDL_Vertex>& vertices = m_spriteBatch.GetVertices();
+        EnsureQuadIndices(sprites.size());
+        const VkDeviceSize size = vertices.size() * sizeof(SDL_Vertex);
+        const Allocation allocation = AllocateRing(size, kVertexAlignment);
+        std::memcpy(allocation.data, vertices.data(), size);
+        vkCmdBindVertexBuffers(m_commands, 0, 1, &allocation.buffer, &allocation.offset);
+        vkCmdBindIndexBuffer(m_commands, m_quadIndices.buffer, 0, VK_INDEX_TYPE_UINT32);
+
+        std::size_t first = 0;
+        while (first < sprites.size())
+        {
+            const Sprite& sprite = *sprites[first];
+            std::size_t last = first + 1;
+            while (last < sprites.size() && sprites[last]->texture == sprite.texture &&
+                   sprites[last]->blend == sprite.blend)
+            {
+                ++last;
+            }
+            Bind(sprite.blend, sprite.texture);
+            vkCmdDrawIndexed(m_commands, static_cast<std::uint32_t>((last - first) * 6), 1,
+                             static_cast<std::uint32_t>(first * 6), 0, 0);
+            ++stats.drawCalls;
+            first = last;
+        }
+
+        stats.sprites += static_cast<std::uint32_t>(sprites.size());
+        stats.vertices += static_cast<std::uint32_t>(vertices.size());
+        ++stats.flushes;
+    }
+
+    void VulkanRenderer::Impl::DrawGeometry(const RenderCommand& command, const CommandList& commands,
+                                            RenderStats& stats)
+    {
+        const std::uint32_t drawn = command.indexCount ? command.indexCount : command.count;
+        if (drawn < 3 || !OpenPass())
+        {
+            return;
+        }
+        const int* indices = commands.GetIndices().data() + command.firstIndex;
+        if (command.indexCount && !std::all_of(indices, indices + command.indexCount, [&command](int index) {
+                return index >= 0 && static_cast<std::uint32_t>(index) < command.count;
+            }))
+        {
+            LOG_ERROR("DrawGeometry indices out of range for {} vertices", command.count);
+            return;
+        }
+
+        const VkDeviceSize vertexSize = command.count * sizeof(SDL_Vertex);
+        const Allocation vertices = AllocateRing(vertexSize, kVertexAlignment);
+        std::memcpy(vertices.data, commands.GetVertices().data() + command.first, vertexSize);
+        vkCmdBindVertexBuffers(m_commands, 0, 1, &vertices.buffer, &vertices.offset);
+        Bind(BlendMode::Blend, command.texture);
+        if (command.indexCount)
+        {
+            const VkDeviceSize indexSize = command.indexCount * sizeof(std::uint32_t);
+            const Allocation allocation = AllocateRing(indexSize, sizeof(std::uint32_t));
+            std::memcpy(allocation.data, indices, indexSize);
+            vkCmdBindIndexBuffer(m_commands, allocation.buffer, allocation.offset, VK_INDEX_TYPE_UINT32);
+            vkCmdDrawIndexed(m_commands, command.indexCount - command.indexCount % 3, 1, 0, 0, 0);
+        }
+        else
+        {
+            vkCmdDraw(m_commands, command.count - command.count % 3, 1, 0, 0);
+        }
+        ++stats.drawCalls;
+        stats.vertices += command.count;
+    }
+
+    /**
+     * @brief Records a command list into the next frame slot and submits it. Sprites are
+     * queued in the sprite batch and drawn before any other command, as in the SDL renderer.
+     */
+    void VulkanRenderer::Impl::RenderFrame(const CommandList& commands, RenderStats& stats)
+    {
+        BeginFrame();
+        bool present = false;
+
+        for (const RenderCommand& command : commands.GetCommands())
+        {
+            if (command.type == RenderCommandType::DrawSprites)
+            {
+                m_spriteBatch.Add(commands.GetSprites().data() + command.first, command.count);
+                continue;
+            }
+            DrawSprites(stats);
+
+            switch (command.type)
+            {
+                case RenderCommandType::Clear:
+                    Clear(command.color);
+                    ++stats.drawCalls;
+                    break;
+
+                case RenderCommandType::DrawGeometry:
+                    DrawGeometry(command, commands, stats);
+                    break;
+
+                case RenderCommandType::SetTarget:
+                    ClosePass();
+                    BindTarget(command.texture);
+                    break;
+
+                case RenderCommandType::Present:
+                    // Present even when nothing was drawn this frame, so FIFO still paces it
+                    present = true;
+                    if (m_surface)
+                    {
+                        AcquireImage();
+                    }
+                    break;
+
+                case RenderCommandType::CreateTexture:
+                    CreateTexture(command, commands);
+                    break;
+
+                case RenderCommandType::UpdateTexture:
+                    UpdateTexture(command, commands);
+                    break;
+
+                case RenderCommandType::UpdateTextureYUV:
+                case RenderCommandType::UpdateTextureNV:
+                    UpdateTextureYUV(command, commands);
+                    break;
+
+                case RenderCommandType::DestroyTexture:
+                    DestroyTexture(command.texture);
+                    m_textureHandles.Release(command.texture);
+                    break;
+
+                case RenderCommandType::DrawSprites:
+                    break;
+            }
+        }
+
+        DrawSprites(stats);
+        EndFrame(present);
+    }
+
+    bool VulkanRenderer::Impl::SetVSync(bool enabled)
+    {
+        if (!m_surface)
+        {
+            return !enabled;
+        }
+        if (enabled != m_vsync)
+        {
+            m_vsync = enabled;
+            m_swapchainDirty = true;
+        }
+        return enabled || m_hasMailbox || m_hasImmediate;
+    }
+
+    /**
+     * @brief Copies the offscreen image into a host-visible buffer through an upload batch,
+     * which the queue runs after every frame submitted so far, and waits for it.
+     */
+    bool VulkanRenderer::Impl::ReadPixels(std::vector<std::uint32_t>& pixels, int& width, int& height)
+    {
+        if (!m_offscreen.image)
+        {
+            return false;
+        }
+        width = m_offscreen.width;
+        height = m_offscreen.height;
+        Buffer readback;
+        CreateBuffer(static_cast<VkDeviceSize>(width) * height * 4, VK_BUFFER_USAGE_TRANSFER_DST_BIT, readback);
+
+        VkCommandBuffer commands = BeginUpload();
+        Transition(commands, m_offscreen.image, m_offscreenLayout, VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL);
+        m_offscreenLayout = VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL;
+        VkBufferImageCopy copy = {};
+        copy.imageSubresource = {VK_IMAGE_ASPECT_COLOR_BIT, 0, 0, 1};
+        copy.imageExtent = {static_cast<std::uint32_t>(width), static_cast<std::uint32_t>(height), 1};
+        vkCmdCopyImageToBuffer(commands, m_offscreen.image, VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL, readback.buffer, 1,
+                               &copy);
+        VkMemoryBarrier barrier = {VK_STRUCTURE_TYPE_MEMORY_BARRIER};
+        barrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+        barrier.dstAccessMask = VK_ACCESS_HOST_READ_BIT;
+        vkCmdPipelineBarrier(commands, VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_HOST_BIT, 0, 1, &barrier, 0,
+                             nullptr, 0, nullptr);
+        WaitForSerial(SubmitUploads());
+
+        pixels.resize(static_cast<std::size_t>(width) * height);
+        std::memcpy(pixels.data(), readback.mapped, pixels.size() * 4);
+        DestroyBuffer(readback);
+        return true;
+    }
+
+    VulkanRenderer::VulkanRenderer(const VulkanRendererConfig& config)
+        : m_impl(new Impl(config, m_textureHandles))
+    {
+    }
+
+    VulkanRenderer::~VulkanRenderer() = default;
+
+    void VulkanRenderer::CreateRenderer(SDL_Window* window)
+    {
+        POLARIS_PROFILE_SCOPE("VulkanRenderer::CreateRenderer");
+        m_impl->Create(window);
+    }
+
+    void VulkanRenderer::RenderFrame(const CommandList& commands)
+    {
+        POLARIS_PROFILE_SCOPE("VulkanRenderer::RenderFrame");
+        RenderStats stats;
+        m_impl->RenderFrame(commands, stats);
+        PublishStats(stats);
+    }
+
+    bool VulkanRenderer::SetVSync(bool enabled)
+    {
+        return m_impl->SetVSync(enabled);
+    }
+
+    bool VulkanRenderer::ReadPixels(std::vector<std::uint32_t>& pixels, int& width, int& height)
+    {
+        return m_impl->ReadPixels(pixels, width, height);
+    }
+
+    const std::string& VulkanRenderer::GetDeviceName() const
+    {
+        return m_impl->deviceName;
+    }
+
+    bool VulkanRenderer::IsValidationEnabled() const
+    {
+        return m_impl->validationEnabled;
+    }
+
+    std::uint32_t VulkanRenderer::GetValidationErrorCount() const
+    {
+        return m_impl->validationErrors.load(std::memory_order_relaxed);
+    }
+}
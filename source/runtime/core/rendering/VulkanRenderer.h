@@ -0,0 +1,120 @@
+#pragma once
+
+#include "PlatformRenderer.h"
+#include <SDL3/SDL.h>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace polaris
+{
+    /**
+     * @brief Settings of the Vulkan renderer.
+     */
+    struct VulkanRendererConfig
+    {
+        /**
+         * @brief Frames the CPU may record ahead of the GPU, each with its own command pool and
+         * share of the ring buffer; clamped to 2-3.
+         */
+        int framesInFlight = 2;
+        /**
+         * @brief Initial size in bytes of the persistently mapped ring buffer holding each
+         * frame's vertices, indices and uniforms. It grows if frames in flight need more.
+         */
+        std::size_t ringBufferSize = 8 * 1024 * 1024;
+        /**
+         * @brief Initial size in bytes of each staging buffer used for texture uploads; grows
+         * for larger uploads.
+         */
+        std::size_t stagingBufferSize = 4 * 1024 * 1024;
+        /**
+         * @brief File the pipeline cache is loaded from at startup and saved to at shutdown;
+         * empty disables the cache. Data from another device or driver is ignored.
+         */
+        std::string pipelineCachePath = "polaris_pipelines.cache";
+        /**
+         * @brief Enable VK_LAYER_KHRONOS_validation, when installed, and log its messages.
+         */
+        bool validation = false;
+        /**
+         * @brief Use the first device whose name contains this, e.g. "llvmpipe" for Mesa's
+         * lavapipe CPU implementation; empty prefers discrete, then integrated GPUs.
+         */
+        std::string deviceName;
+        /**
+         * @brief Offscreen framebuffer size when the renderer is created without a window.
+         */
+        int width = 1280;
+        int height = 720;
+    };
+
+    /**
+     * @brief Renders with Vulkan 1.3 (dynamic rendering, timeline semaphores).
+     *
+     * Up to framesInFlight frames are recorded ahead of the GPU, each into a command buffer from
+     * its own pool. Vertices, indices and per-target uniforms are written into one persistently
+     * mapped ring buffer, whose space is reclaimed as frames complete. Texture uploads are
+     * recorded into separate upload command buffers with their own staging buffers; each batch
+     * is submitted before the frame that needs it and signals a timeline semaphore, which the
+     * frame waits on, and which also tells when staging buffers and destroyed resources may be
+     * reused. Pipelines are created from a pipeline cache kept on disk.
+     *
+     * Sprites are batched by SpriteBatch into one indexed draw per run of texture and blend
+     * mode. Uploads take effect before the draws of the command list that records them. YUV
+     * textures are converted to RGBA on upload. Without a window created with SDL_WINDOW_VULKAN
+     * (headless ones are not), or if it has no surface, frames are rendered into an offscreen
+     * image.
+     */
+    class VulkanRenderer: public PlatformRenderer
+    {
+    public:
+        explicit VulkanRenderer(const VulkanRendererConfig& config = VulkanRendererConfig());
+        ~VulkanRenderer();
+
+        /**
+         * @brief Creates the instance, device, swapchain and pipelines.
+         * @throws std::runtime_error if there is no Vulkan 1.3 device or creation fails.
+         */
+        void CreateRenderer(SDL_Window* window) override;
+
+        void RenderFrame(const CommandList& commands) override;
+
+        /**
+         * @brief Switches between FIFO and mailbox (or immediate) presentation; the swapchain
+         * is recreated before the next frame.
+         * @return true if the requested mode is available.
+         */
+        bool SetVSync(bool enabled) override;
+
+        /**
+         * @brief Copies the offscreen image once every frame submitted so far has completed.
+         * Call it on the render thread, between frames.
+         * @param pixels Receives width * height pixels, rows top to bottom, each RGBA8 (bytes R, G, B, A).
+         * @return false when rendering to a window, which has no offscreen image.
+         */
+        bool ReadPixels(std::vector<std::uint32_t>& pixels, int& width, int& height);
+
+        /**
+         * @brief Name of the device in use; empty before CreateRenderer().
+         */
+        const std::string& GetDeviceName() const;
+
+        /**
+         * @brief True if validation was requested and VK_LAYER_KHRONOS_validation is active.
+         * A missing layer only logs a warning, so check this before trusting a zero error count.
+         */
+        bool IsValidationEnabled() const;
+
+        /**
+         * @brief Number of errors the validation layer has reported; 0 without validation.
+         */
+        std::uint32_t GetValidationErrorCount() const;
+
+    private:
+        class Impl;
+        std::unique_ptr<Impl> m_impl;
+    };
+}
@@ -0,0 +1,14 @@
+#version 450
+
+layout(location = 0) in vec4 inColor;
+layout(location = 1) in vec2 inTexCoord;
+
+// Untextured draws sample a 1x1 white texture
+layout(set = 1, binding = 0) uniform sampler2D spriteTexture;
+
+layout(location = 0) out vec4 outColor;
+
+void main()
+{
+    outColor = texture(spriteTexture, inTexCoord) * inColor;
+}
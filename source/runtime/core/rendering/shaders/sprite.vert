@@ -0,0 +1,23 @@
+#version 450
+
+// Vertices are SDL_Vertex: position in target pixels, colour, normalised texture coordinates
+layout(location = 0) in vec2 inPosition;
+layout(location = 1) in vec4 inColor;
+layout(location = 2) in vec2 inTexCoord;
+
+// Maps target pixels to clip space; written to the frame's ring buffer per target
+layout(set = 0, binding = 0) uniform View
+{
+    vec2 scale;
+    vec2 offset;
+} view;
+
+layout(location = 0) out vec4 outColor;
+layout(location = 1) out vec2 outTexCoord;
+
+void main()
+{
+    gl_Position = vec4(inPosition * view.scale + view.offset, 0.0, 1.0);
+    outColor = inColor;
+    outTexCoord = inTexCoord;
+}
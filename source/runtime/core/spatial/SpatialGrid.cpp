@@ -0,0 +1,239 @@
+#include "spatial/SpatialGrid.h"
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+#include <utility>
+
+namespace polaris {
+
+namespace {
+
+/**
+ * @brief Cell coordinates are clamped to this, keeping huge or infinite bounds representable.
+ */
+constexpr float kMaxCellCoordinate = 1073741824.0f;   // 2^30
+
+} // namespace
+
+SpatialGrid::SpatialGrid(float cellSize) : m_cellSize(cellSize), m_inverseCellSize(1.0f / cellSize) {}
+
+void SpatialGrid::setCellSize(float cellSize) {
+    if (m_count != 0) {
+        throw std::logic_error("SpatialGrid::setCellSize on a non-empty grid");
+    }
+    m_cellSize = cellSize;
+    m_inverseCellSize = 1.0f / cellSize;
+}
+
+SpatialHandle SpatialGrid::insert(const Bounds& bounds, std::uint64_t userData) {
+    SpatialHandle handle;
+    if (!m_freeHandles.empty()) {
+        handle = m_freeHandles.back();
+        m_freeHandles.pop_back();
+    } else {
+        handle = static_cast<SpatialHandle>(m_objects.size());
+        m_objects.emplace_back();
+    }
+
+    Object& object = m_objects[handle];
+    object.bounds = bounds;
+    object.userData = userData;
+    object.cells = getCellRange(bounds);
+    object.alive = true;
+    link(handle);
+    ++m_count;
+    ++m_inserts;
+    return handle;
+}
+
+/**
+ * @brief Stores the new bounds, and relinks the object only if it now touches other cells.
+ */
+void SpatialGrid::update(SpatialHandle handle, const Bounds& bounds) {
+    Object& object = m_objects[handle];
+    object.bounds = bounds;
+    ++m_updates;
+
+    const CellRange cells = getCellRange(bounds);
+    if (cells == object.cells) {
+        return;
+    }
+    const bool large = cells.getCellCount() > kMaxCellsPerObject;
+    if (large && object.large) {
+        object.cells = cells;
+        return;
+    }
+    unlink(handle);
+    object.cells = cells;
+    link(handle);
+    ++m_cellMoves;
+}
+
+void SpatialGrid::remove(SpatialHandle handle) {
+    Object& object = m_objects[handle];
+    if (!object.alive) {
+        return;
+    }
+    unlink(handle);
+    object.alive = false;
+    m_freeHandles.push_back(handle);
+    --m_count;
+    ++m_removes;
+}
+
+void SpatialGrid::clear() {
+    std::vector<Object>().swap(m_objects);
+    std::vector<SpatialHandle>().swap(m_freeHandles);
+    std::vector<Cell>().swap(m_cells);
+    std::vector<std::uint32_t>().swap(m_table);
+    std::vector<std::vector<SpatialHandle>>().swap(m_spareLists);
+    std::vector<SpatialHandle>().swap(m_large);
+    m_count = 0;
+}
+
+SpatialStats SpatialGrid::takeStats() {
+    SpatialStats stats;
+    stats.inserts = std::exchange(m_inserts, 0);
+    stats.updates = std::exchange(m_updates, 0);
+    stats.cellMoves = std::exchange(m_cellMoves, 0);
+    stats.removes = std::exchange(m_removes, 0);
+    stats.queries = m_queries.exchange(0, std::memory_order_relaxed);
+    stats.cellsVisited = m_cellsVisited.exchange(0, std::memory_order_relaxed);
+    stats.candidates = m_candidates.exchange(0, std::memory_order_relaxed);
+    stats.results = m_results.exchange(0, std::memory_order_relaxed);
+    return stats;
+}
+
+std::int32_t SpatialGrid::toCell(float coordinate) const {
+    const float cell = std::floor(coordinate * m_inverseCellSize);
+    // The negated comparison also maps NaN to the lower limit
+    if (!(cell > -kMaxCellCoordinate)) {
+        return -static_cast<std::int32_t>(kMaxCellCoordinate);
+    }
+    if (cell > kMaxCellCoordinate) {
+        return static_cast<std::int32_t>(kMaxCellCoordinate);
+    }
+    return static_cast<std::int32_t>(cell);
+}
+
+/**
+ * @brief Cells touched by bounds. Max is exclusive, so a box ending exactly on a cell border
+ * does not reach into the next cell.
+ */
+SpatialGrid::CellRange SpatialGrid::getCellRange(const Bounds& bounds) const {
+    CellRange range{toCell(bounds.minX), toCell(bounds.minY), toCell(bounds.maxX), toCell(bounds.maxY)};
+    if (range.maxX > range.minX && bounds.maxX == std::floor(bounds.maxX * m_inverseCellSize) * m_cellSize) {
+        --range.maxX;
+    }
+    if (range.maxY > range.minY && bounds.maxY == std::floor(bounds.maxY * m_inverseCellSize) * m_cellSize) {
+        --range.maxY;
+    }
+    return range;
+}
+
+/**
+ * @brief Adds the object to the cells of its cell range, creating cells as needed, or to the
+ * large-object list.
+ */
+void SpatialGrid::link(SpatialHandle handle) {
+    Object& object = m_objects[handle];
+    object.large = object.cells.getCellCount() > kMaxCellsPerObject;
+    if (object.large) {
+        m_large.push_back(handle);
+        return;
+    }
+
+    for (std::int32_t y = object.cells.minY; y <= object.cells.maxY; ++y) {
+        for (std::int32_t x = object.cells.minX; x <= object.cells.maxX; ++x) {
+            getOrCreateCell(x, y).objects.push_back(handle);
+        }
+    }
+}
+
+/**
+ * @brief Removes the object from its cells; cells left empty are dropped so that queries and
+ * memory only see occupied space.
+ */
+void SpatialGrid::unlink(SpatialHandle handle) {
+    Object& object = m_objects[handle];
+    if (object.large) {
+        const auto found = std::find(m_large.begin(), m_large.end(), handle);
+        *found = m_large.back();
+        m_large.pop_back();
+        return;
+    }
+
+    for (std::int32_t y = object.cells.minY; y <= object.cells.maxY; ++y) {
+        for (std::int32_t x = object.cells.minX; x <= object.cells.maxX; ++x) {
+            const std::size_t slot = findSlot(x, y);
+            std::vector<SpatialHandle>& objects = m_cells[m_table[slot]].objects;
+            *std::find(objects.begin(), objects.end(), handle) = objects.back();
+            objects.pop_back();
+            if (objects.empty()) {
+                removeCell(slot);
+            }
+        }
+    }
+}
+
+SpatialGrid::Cell& SpatialGrid::getOrCreateCell(std::int32_t x, std::int32_t y) {
+    if ((m_cells.size() + 1) * 2 > m_table.size()) {
+        growTable();
+    }
+    const std::size_t slot = findSlot(x, y);
+    if (m_table[slot] != kEmptySlot) {
+        return m_cells[m_table[slot]];
+    }
+
+    Cell cell{x, y, {}};
+    if (!m_spareLists.empty()) {
+        cell.objects = std::move(m_spareLists.back());
+        m_spareLists.pop_back();
+    }
+    m_table[slot] = static_cast<std::uint32_t>(m_cells.size());
+    m_cells.push_back(std::move(cell));
+    return m_cells.back();
+}
+
+/**
+ * @brief Drops the empty cell in slot, keeping its list's capacity for reuse. The cell array
+ * is compacted by moving the last cell into the hole, and the table by shifting later
+ * entries of the probe run back, so lookups never need tombstones.
+ */
+void SpatialGrid::removeCell(std::size_t slot) {
+    const std::uint32_t index = m_table[slot];
+    m_spareLists.push_back(std::move(m_cells[index].objects));
+
+    const std::uint32_t last = static_cast<std::uint32_t>(m_cells.size() - 1);
+    if (index != last) {
+        m_table[findSlot(m_cells[last].x, m_cells[last].y)] = index;
+        m_cells[index] = std::move(m_cells[last]);
+    }
+    m_cells.pop_back();
+
+    const std::size_t mask = m_table.size() - 1;
+    std::size_t hole = slot;
+    m_table[hole] = kEmptySlot;
+    for (std::size_t next = (hole + 1) & mask; m_table[next] != kEmptySlot; next = (next + 1) & mask) {
+        // An entry may fill the hole if its probe run started at or before it
+        const Cell& cell = m_cells[m_table[next]];
+        const std::size_t home = homeSlot(cell.x, cell.y, mask);
+        if (((next - home) & mask) >= ((next - hole) & mask)) {
+            m_table[hole] = m_table[next];
+            m_table[next] = kEmptySlot;
+            hole = next;
+        }
+    }
+}
+
+/**
+ * @brief Doubles the table and reinserts every cell.
+ */
+void SpatialGrid::growTable() {
+    m_table.assign(std::max<std::size_t>(64, m_table.size() * 2), kEmptySlot);
+    for (std::size_t i = 0; i < m_cells.size(); ++i) {
+        m_table[findSlot(m_cells[i].x, m_cells[i].y)] = static_cast<std::uint32_t>(i);
+    }
+}
+
+} // namespace polaris
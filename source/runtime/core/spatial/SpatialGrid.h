@@ -0,0 +1,276 @@
+#ifndef POLARIS_SPATIALGRID_H
+#define POLARIS_SPATIALGRID_H
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace polaris {
+
+/**
+ * @brief Axis-aligned box in world units, min inclusive and max exclusive.
+ */
+struct Bounds {
+    float minX = 0.0f;
+    float minY = 0.0f;
+    float maxX = 0.0f;
+    float maxY = 0.0f;
+
+    static Bounds fromRect(float x, float y, float width, float height) { return {x, y, x + width, y + height}; }
+
+    bool overlaps(const Bounds& other) const {
+        return minX < other.maxX && other.minX < maxX && minY < other.maxY && other.minY < maxY;
+    }
+};
+
+using SpatialHandle = std::uint32_t;
+
+constexpr SpatialHandle kInvalidSpatialHandle = 0xFFFFFFFFu;
+
+/**
+ * @brief Work done by a SpatialGrid since its stats were last taken.
+ */
+struct SpatialStats {
+    std::uint64_t inserts = 0;
+    std::uint64_t updates = 0;
+    std::uint64_t cellMoves = 0;      ///< Updates that moved an object to different cells
+    std::uint64_t removes = 0;
+    std::uint64_t queries = 0;
+    std::uint64_t cellsVisited = 0;   ///< Occupied cells looked at by queries
+    std::uint64_t candidates = 0;     ///< Objects tested against a query region
+    std::uint64_t results = 0;        ///< Objects reported by queries
+};
+
+/**
+ * @brief Uniform hash grid over 2D bounding boxes, for view culling and proximity queries.
+ *
+ * Space is divided into square cells; only occupied cells exist, in a hash table, so the
+ * world can be any size and empty space costs nothing. An object is listed in every cell its
+ * bounds touch, and a query visits the cells its region touches, so its cost depends on the
+ * size of the region and how many objects are in it, not on the size of the world. Objects spanning more than
+ * kMaxCellsPerObject cells are kept in a separate list that every query checks.
+ *
+ * Moving an object within its cells only stores the new bounds; the cell lists change only
+ * when it crosses a cell border. Pick a cell size around the size of a typical object, or of
+ * the typical query region if that is smaller.
+ *
+ * Queries may run concurrently with each other; insert, update and remove need exclusive access.
+ */
+class SpatialGrid {
+public:
+    static constexpr int kMaxCellsPerObject = 16;
+
+    explicit SpatialGrid(float cellSize = 128.0f);
+
+    /**
+     * @throws std::logic_error if the grid is not empty.
+     */
+    void setCellSize(float cellSize);
+    float getCellSize() const { return m_cellSize; }
+
+    /**
+     * @brief Adds an object; userData is handed back by queries, e.g. an index or an Entity.
+     */
+    SpatialHandle insert(const Bounds& bounds, std::uint64_t userData = 0);
+
+    /**
+     * @brief Moves or resizes an object.
+     */
+    void update(SpatialHandle handle, const Bounds& bounds);
+
+    void remove(SpatialHandle handle);
+
+    /**
+     * @brief Removes every object and frees the grid's memory.
+     */
+    void clear();
+
+    const Bounds& getBounds(SpatialHandle handle) const { return m_objects[handle].bounds; }
+    std::uint64_t getUserData(SpatialHandle handle) const { return m_objects[handle].userData; }
+    std::size_t getCount() const { return m_count; }
+    std::size_t getCellCount() const { return m_cells.size(); }
+
+    /**
+     * @brief Calls function(SpatialHandle, std::uint64_t userData) once for every object whose
+     * bounds overlap region. The function must not modify the grid.
+     */
+    template <typename F>
+    void query(const Bounds& region, F&& function) const;
+
+    /**
+     * @brief Calls function(SpatialHandle, std::uint64_t userData) for every object whose bounds
+     * come within radius of (x, y).
+     */
+    template <typename F>
+    void queryRadius(float x, float y, float radius, F&& function) const {
+        const float radiusSquared = radius * radius;
+        query(Bounds{x - radius, y - radius, x + radius, y + radius},
+              [&](SpatialHandle handle, std::uint64_t userData) {
+                  const Bounds& b = m_objects[handle].bounds;
+                  const float dx = x - std::clamp(x, b.minX, b.maxX);
+                  const float dy = y - std::clamp(y, b.minY, b.maxY);
+                  if (dx * dx + dy * dy <= radiusSquared) {
+                      function(handle, userData);
+                  }
+              });
+    }
+
+    /**
+     * @brief Returns the counters accumulated since the last call and resets them.
+     */
+    SpatialStats takeStats();
+
+private:
+    struct CellRange {
+        std::int32_t minX, minY, maxX, maxY;
+
+        bool operator==(const CellRange& o) const {
+            return minX == o.minX && minY == o.minY && maxX == o.maxX && maxY == o.maxY;
+        }
+        bool operator!=(const CellRange& o) const { return !(*this == o); }
+        std::int64_t getCellCount() const {
+            return (static_cast<std::int64_t>(maxX) - minX + 1) * (static_cast<std::int64_t>(maxY) - minY + 1);
+        }
+    };
+
+    struct Object {
+        Bounds bounds;
+        std::uint64_t userData;
+        CellRange cells;
+        bool large;      ///< In m_large rather than in cells
+        bool alive;
+    };
+
+    struct Cell {
+        std::int32_t x, y;
+        std::vector<SpatialHandle> objects;
+    };
+
+    static constexpr std::uint32_t kEmptySlot = 0xFFFFFFFFu;
+
+    /**
+     * @brief Multiplicative hash of both coordinates; the table size is a power of two.
+     */
+    static std::size_t homeSlot(std::int32_t x, std::int32_t y, std::size_t mask) {
+        const std::uint64_t key =
+            (static_cast<std::uint64_t>(static_cast<std::uint32_t>(x)) << 32) | static_cast<std::uint32_t>(y);
+        return static_cast<std::size_t>((key * 0x9E3779B97F4A7C15ull) >> 32) & mask;
+    }
+
+    /**
+     * @brief Slot in m_table holding cell (x, y), or the empty slot where it would go.
+     */
+    std::size_t findSlot(std::int32_t x, std::int32_t y) const {
+        const std::size_t mask = m_table.size() - 1;
+        std::size_t slot = homeSlot(x, y, mask);
+        while (m_table[slot] != kEmptySlot && (m_cells[m_table[slot]].x != x || m_cells[m_table[slot]].y != y)) {
+            slot = (slot + 1) & mask;
+        }
+        return slot;
+    }
+
+    const Cell* findCell(std::int32_t x, std::int32_t y) const {
+        if (m_cells.empty()) {
+            return nullptr;
+        }
+        const std::uint32_t index = m_table[findSlot(x, y)];
+        return index == kEmptySlot ? nullptr : &m_cells[index];
+    }
+
+    std::int32_t toCell(float coordinate) const;
+    CellRange getCellRange(const Bounds& bounds) const;
+    void link(SpatialHandle handle);
+    void unlink(SpatialHandle handle);
+    Cell& getOrCreateCell(std::int32_t x, std::int32_t y);
+    void removeCell(std::size_t slot);
+    void growTable();
+
+    /**
+     * @brief Reports the objects of one cell overlapping region. An object in several cells
+     * is reported only from the first cell (lowest x, then y) shared by it and the region,
+     * which needs no per-query bookkeeping and so keeps queries const.
+     */
+    template <typename F>
+    void queryCell(const Cell& cell, const Bounds& region, const CellRange& range, F& function,
+                   std::uint64_t& candidates, std::uint64_t& results) const {
+        for (SpatialHandle handle : cell.objects) {
+            const Object& object = m_objects[handle];
+            ++candidates;
+            if (std::max(object.cells.minX, range.minX) != cell.x || std::max(object.cells.minY, range.minY) != cell.y) {
+                continue;
+            }
+            if (object.bounds.overlaps(region)) {
+                ++results;
+                function(handle, object.userData);
+            }
+        }
+    }
+
+    float m_cellSize;
+    float m_inverseCellSize;
+    std::vector<Object> m_objects;
+    std::vector<SpatialHandle> m_freeHandles;
+    std::size_t m_count = 0;
+    std::vector<Cell> m_cells;
+    /// Open-addressing table of indices into m_cells, at most half full
+    std::vector<std::uint32_t> m_table;
+    /// Object lists of cells that emptied, kept with their capacity for the next new cell
+    std::vector<std::vector<SpatialHandle>> m_spareLists;
+    std::vector<SpatialHandle> m_large;
+
+    std::uint64_t m_inserts = 0;
+    std::uint64_t m_updates = 0;
+    std::uint64_t m_cellMoves = 0;
+    std::uint64_t m_removes = 0;
+    mutable std::atomic<std::uint64_t> m_queries{0};
+    mutable std::atomic<std::uint64_t> m_cellsVisited{0};
+    mutable std::atomic<std::uint64_t> m_candidates{0};
+    mutable std::atomic<std::uint64_t> m_results{0};
+};
+
+template <typename F>
+void SpatialGrid::query(const Bounds& region, F&& function) const {
+    const CellRange range = getCellRange(region);
+    std::uint64_t visited = 0;
+    std::uint64_t candidates = 0;
+    std::uint64_t results = 0;
+
+    if (range.getCellCount() <= static_cast<std::int64_t>(m_cells.size())) {
+        for (std::int32_t y = range.minY; y <= range.maxY; ++y) {
+            for (std::int32_t x = range.minX; x <= range.maxX; ++x) {
+                if (const Cell* cell = findCell(x, y)) {
+                    ++visited;
+                    queryCell(*cell, region, range, function, candidates, results);
+                }
+            }
+        }
+    } else {
+        // The region covers more cells than exist: walk the occupied ones instead
+        for (const Cell& cell : m_cells) {
+            if (cell.x >= range.minX && cell.x <= range.maxX && cell.y >= range.minY && cell.y <= range.maxY) {
+                ++visited;
+                queryCell(cell, region, range, function, candidates, results);
+            }
+        }
+    }
+
+    for (SpatialHandle handle : m_large) {
+        const Object& object = m_objects[handle];
+        ++candidates;
+        if (object.bounds.overlaps(region)) {
+            ++results;
+            function(handle, object.userData);
+        }
+    }
+
+    m_queries.fetch_add(1, std::memory_order_relaxed);
+    m_cellsVisited.fetch_add(visited, std::memory_order_relaxed);
+    m_candidates.fetch_add(candidates, std::memory_order_relaxed);
+    m_results.fetch_add(results, std::memory_order_relaxed);
+}
+
+} // namespace polaris
+
+#endif // POLARIS_SPATIALGRID_H
@@ -0,0 +1,164 @@
+//
+// polaris-test-vulkan: renders a clear and a few textured sprites with polaris::VulkanRenderer
+// offscreen, reads the image back and checks its pixels. Runs on Mesa's lavapipe (llvmpipe)
+// with VK_LAYER_KHRONOS_validation, so it needs no GPU, and fails on any validation error.
+// Without lavapipe or the validation layer the result would prove nothing, so the test is
+// skipped (exit code 77, CTest's SKIP_RETURN_CODE) instead.
+//
+// Usage: polaris-test-vulkan (registered with CTest as vulkan-offscreen)
+//
+
+#include "Logger.h"
+#include "rendering/CommandList.h"
+#include "rendering/VulkanRenderer.h"
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <exception>
+#include <vector>
+
+namespace {
+
+constexpr int kWidth = 64;
+constexpr int kHeight = 64;
+constexpr int kFrames = 3;
+constexpr int kTolerance = 2;
+constexpr int kSkipped = 77;
+
+struct Expected {
+    const char* what;
+    int x, y;
+    int r, g, b;
+};
+
+/**
+ * @brief A solid 8x8 texture. Linear filtering of a solid texture gives exactly its colour.
+ */
+std::vector<std::uint8_t> solidPixels(std::uint8_t r, std::uint8_t g, std::uint8_t b) {
+    std::vector<std::uint8_t> pixels(8 * 8 * 4);
+    for (std::size_t i = 0; i < pixels.size(); i += 4) {
+        pixels[i] = r;
+        pixels[i + 1] = g;
+        pixels[i + 2] = b;
+        pixels[i + 3] = 255;
+    }
+    return pixels;
+}
+
+polaris::Sprite makeSprite(float x, float y, polaris::TextureHandle texture) {
+    polaris::Sprite sprite;
+    sprite.destination = {x, y, 16.0f, 16.0f};
+    sprite.texture = texture;
+    return sprite;
+}
+
+bool checkPixels(const std::vector<std::uint32_t>& pixels, int width) {
+    // Clear colour 0.2, 0.4, 0.6 is 51, 102, 153; the half transparent red sprite blends to
+    // 0.5 * 255 + 0.5 * clear
+    static const Expected kExpected[] = {
+        {"clear", 0, 0, 51, 102, 153},
+        {"clear between sprites", 24, 12, 51, 102, 153},
+        {"red sprite", 12, 12, 255, 0, 0},
+        {"green sprite", 36, 12, 0, 255, 0},
+        {"tinted red sprite", 12, 36, 153, 51, 77},
+        {"additive white rectangle", 36, 36, 255, 255, 255},
+        {"clear below sprites", 36, 60, 51, 102, 153},
+    };
+
+    bool passed = true;
+    for (const Expected& expected : kExpected) {
+        std::uint8_t texel[4];
+        std::memcpy(texel, &pixels[static_cast<std::size_t>(expected.y) * width + expected.x], sizeof(texel));
+        const bool match = std::abs(texel[0] - expected.r) <= kTolerance &&
+                           std::abs(texel[1] - expected.g) <= kTolerance &&
+                           std::abs(texel[2] - expected.b) <= kTolerance;
+        if (!match) {
+            std::fprintf(stderr, "FAIL %s at (%d, %d): got %d %d %d, expected %d %d %d\n", expected.what, expected.x,
+                         expected.y, texel[0], texel[1], texel[2], expected.r, expected.g, expected.b);
+            passed = false;
+        }
+    }
+    return passed;
+}
+
+} // namespace
+
+int main() {
+    polaris::LoggerConfig loggerConfig;
+    polaris::Logger::getInstance().initialize("", loggerConfig);
+
+    int result = 1;
+    try {
+        polaris::VulkanRendererConfig config;
+        config.deviceName = "llvmpipe";
+        config.validation = true;
+        config.pipelineCachePath.clear();
+        config.width = kWidth;
+        config.height = kHeight;
+
+        polaris::VulkanRenderer renderer(config);
+        renderer.CreateRenderer(nullptr);
+        std::printf("device: %s\n", renderer.GetDeviceName().c_str());
+        if (!std::strstr(renderer.GetDeviceName().c_str(), "llvmpipe")) {
+            std::fprintf(stderr, "SKIP lavapipe (llvmpipe) is not installed\n");
+            polaris::Logger::getInstance().shutdown();
+            return kSkipped;
+        }
+        if (!renderer.IsValidationEnabled()) {
+            std::fprintf(stderr, "SKIP VK_LAYER_KHRONOS_validation is not installed\n");
+            polaris::Logger::getInstance().shutdown();
+            return kSkipped;
+        }
+
+        polaris::CommandList commands(&renderer.GetTextureHandles());
+        const std::vector<std::uint8_t> red = solidPixels(255, 0, 0);
+        const std::vector<std::uint8_t> green = solidPixels(0, 255, 0);
+        const polaris::TextureHandle redTexture = commands.CreateTexture(8, 8, polaris::TextureAccess::Static, red.data());
+        const polaris::TextureHandle greenTexture =
+            commands.CreateTexture(8, 8, polaris::TextureAccess::Static, green.data());
+
+        // Several frames, so frame slots and the ring buffer are reused before the readback
+        for (int frame = 0; frame < kFrames; ++frame) {
+            commands.Clear({0.2f, 0.4f, 0.6f, 1.0f});
+            commands.DrawSprite(makeSprite(4.0f, 4.0f, redTexture));
+            commands.DrawSprite(makeSprite(28.0f, 4.0f, greenTexture));
+            polaris::Sprite tinted = makeSprite(4.0f, 28.0f, redTexture);
+            tinted.color = {1.0f, 1.0f, 1.0f, 0.5f};
+            commands.DrawSprite(tinted);
+            polaris::Sprite additive = makeSprite(28.0f, 28.0f, 0);
+            additive.blend = polaris::BlendMode::Add;
+            commands.DrawSprite(additive);
+            commands.Present();
+            renderer.RenderFrame(commands);
+            commands.Reset();
+        }
+
+        std::vector<std::uint32_t> pixels;
+        int width = 0;
+        int height = 0;
+        bool passed = renderer.ReadPixels(pixels, width, height) && width == kWidth && height == kHeight;
+        if (!passed) {
+            std::fprintf(stderr, "FAIL readback of the %dx%d offscreen image\n", kWidth, kHeight);
+        } else {
+            passed = checkPixels(pixels, width);
+        }
+
+        commands.DestroyTexture(redTexture);
+        commands.DestroyTexture(greenTexture);
+        renderer.RenderFrame(commands);
+
+        const std::uint32_t validationErrors = renderer.GetValidationErrorCount();
+        if (validationErrors != 0) {
+            std::fprintf(stderr, "FAIL %u validation errors\n", validationErrors);
+        }
+        result = passed && validationErrors == 0 ? 0 : 1;
+    } catch (const std::exception& e) {
+        std::fprintf(stderr, "FAIL %s\n", e.what());
+        result = 1;
+    }
+
+    std::printf("%s\n", result == 0 ? "PASSED" : "FAILED");
+    polaris::Logger::getInstance().shutdown();
+    return result;
+}
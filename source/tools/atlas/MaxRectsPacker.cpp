@@ -0,0 +1,110 @@
+#include "MaxRectsPacker.h"
+
+#include <algorithm>
+#include <climits>
+
+namespace polaris {
+
+namespace {
+
+bool contains(const PackRect& outer, const PackRect& inner) {
+    return inner.x >= outer.x && inner.y >= outer.y &&
+           inner.x + inner.width <= outer.x + outer.width &&
+           inner.y + inner.height <= outer.y + outer.height;
+}
+
+} // namespace
+
+MaxRectsPacker::MaxRectsPacker(int width, int height) {
+    m_free.push_back({0, 0, width, height});
+}
+
+/**
+ * @brief Places a rectangle at the best-short-side-fit position, ties broken by the long side.
+ */
+bool MaxRectsPacker::insert(int width, int height, PackRect& placed) {
+    int bestShort = INT_MAX;
+    int bestLong = INT_MAX;
+    const PackRect* best = nullptr;
+
+    for (const PackRect& free : m_free) {
+        if (width > free.width || height > free.height) {
+            continue;
+        }
+        const int leftoverX = free.width - width;
+        const int leftoverY = free.height - height;
+        const int shortSide = std::min(leftoverX, leftoverY);
+        const int longSide = std::max(leftoverX, leftoverY);
+        if (shortSide < bestShort || (shortSide == bestShort && longSide < bestLong)) {
+            bestShort = shortSide;
+            bestLong = longSide;
+            best = &free;
+        }
+    }
+
+    if (!best) {
+        return false;
+    }
+
+    placed = {best->x, best->y, width, height};
+    splitFreeRects(placed);
+    pruneFreeRects();
+    return true;
+}
+
+/**
+ * @brief Replaces every free rectangle overlapping the used one by the (up to four) maximal
+ * rectangles of it that remain free.
+ */
+void MaxRectsPacker::splitFreeRects(const PackRect& used) {
+    std::vector<PackRect> next;
+    next.reserve(m_free.size() + 4);
+
+    for (const PackRect& free : m_free) {
+        const bool overlaps = used.x < free.x + free.width && used.x + used.width > free.x &&
+                              used.y < free.y + free.height && used.y + used.height > free.y;
+        if (!overlaps) {
+            next.push_back(free);
+            continue;
+        }
+
+        if (used.x > free.x) {
+            next.push_back({free.x, free.y, used.x - free.x, free.height});
+        }
+        if (used.x + used.width < free.x + free.width) {
+            const int right = used.x + used.width;
+            next.push_back({right, free.y, free.x + free.width - right, free.height});
+        }
+        if (used.y > free.y) {
+            next.push_back({free.x, free.y, free.width, used.y - free.y});
+        }
+        if (used.y + used.height < free.y + free.height) {
+            const int bottom = used.y + used.height;
+            next.push_back({free.x, bottom, free.width, free.y + free.height - bottom});
+        }
+    }
+
+    m_free.swap(next);
+}
+
+/**
+ * @brief Removes free rectangles contained in another, keeping the list maximal.
+ */
+void MaxRectsPacker::pruneFreeRects() {
+    for (std::size_t i = 0; i < m_free.size(); ++i) {
+        for (std::size_t j = i + 1; j < m_free.size();) {
+            if (contains(m_free[j], m_free[i])) {
+                m_free.erase(m_free.begin() + static_cast<std::ptrdiff_t>(i));
+                --i;
+                break;
+            }
+            if (contains(m_free[i], m_free[j])) {
+                m_free.erase(m_free.begin() + static_cast<std::ptrdiff_t>(j));
+            } else {
+                ++j;
+            }
+        }
+    }
+}
+
+} // namespace polaris
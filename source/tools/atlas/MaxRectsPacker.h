@@ -0,0 +1,45 @@
+#ifndef POLARIS_MAX_RECTS_PACKER_H
+#define POLARIS_MAX_RECTS_PACKER_H
+
+#include <vector>
+
+namespace polaris {
+
+struct PackRect {
+    int x = 0;
+    int y = 0;
+    int width = 0;
+    int height = 0;
+};
+
+/**
+ * @brief MaxRects bin packer (Jylänki, "A Thousand Ways to Pack the Bin") using the
+ * best-short-side-fit heuristic, without rotation.
+ *
+ * Keeps the list of maximal free rectangles of the bin; each insertion picks the free
+ * rectangle that leaves the smallest leftover on its shorter side, then splits every free
+ * rectangle the placement overlaps and drops those contained in another.
+ */
+class MaxRectsPacker {
+public:
+    MaxRectsPacker(int width, int height);
+
+    /**
+     * @brief Places a rectangle.
+     * @param width Width to reserve.
+     * @param height Height to reserve.
+     * @param placed Receives the position on success.
+     * @return false if the rectangle does not fit in the remaining space.
+     */
+    bool insert(int width, int height, PackRect& placed);
+
+private:
+    void splitFreeRects(const PackRect& used);
+    void pruneFreeRects();
+
+    std::vector<PackRect> m_free;
+};
+
+} // namespace polaris
+
+#endif // POLARIS_MAX_RECTS_PACKER_H
@@ -0,0 +1,282 @@
+//
+// polaris-atlas: packs a directory of images into power-of-two atlas pages and writes the
+// .patlas index read by polaris::AtlasRegistry.
+//
+// Usage: polaris-atlas [--max-size N] [--padding N] [--extrude N] [--no-trim] input-dir output.patlas
+//
+
+#include "AtlasFormat.h"
+#include "MaxRectsPacker.h"
+#include <SDL3/SDL.h>
+#include <SDL3_image/SDL_image.h>
+#include <algorithm>
+#include <cctype>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <iostream>
+#include <string>
+#include <vector>
+
+namespace {
+
+struct Image {
+    std::string name;
+    SDL_Surface* surface = nullptr; // RGBA32
+    polaris::PackRect trimmed;      // Opaque bounds within the surface
+    int page = -1;
+    polaris::PackRect placed;       // Trimmed image position in its page
+};
+
+void printUsage() {
+    std::cerr << "Usage: polaris-atlas [options] input-dir output.patlas\n"
+              << "  --max-size N  largest page width/height, a power of two (default 2048)\n"
+              << "  --padding N   empty texels between images (default 2)\n"
+              << "  --extrude N   texels of each image's edge repeated around it (default 1)\n"
+              << "  --no-trim     keep fully transparent borders\n";
+}
+
+bool isImageFile(const std::filesystem::path& path) {
+    std::string extension = path.extension().string();
+    std::transform(extension.begin(), extension.end(), extension.begin(),
+                   [](unsigned char c) { return static_cast<char>(std::tolower(c)); });
+    return extension == ".png" || extension == ".jpg" || extension == ".jpeg" || extension == ".bmp" ||
+           extension == ".tga" || extension == ".gif" || extension == ".qoi";
+}
+
+int nextPowerOfTwo(int value) {
+    int result = 1;
+    while (result < value) {
+        result *= 2;
+    }
+    return result;
+}
+
+const std::uint8_t* pixelAt(const SDL_Surface* surface, int x, int y) {
+    return static_cast<const std::uint8_t*>(surface->pixels) + y * surface->pitch + x * 4;
+}
+
+/**
+ * @brief Smallest rectangle containing every pixel with non-zero alpha. A fully transparent
+ * image keeps a single texel so it still has a valid rectangle.
+ */
+polaris::PackRect opaqueBounds(const SDL_Surface* surface) {
+    int minX = surface->w, minY = surface->h, maxX = -1, maxY = -1;
+    for (int y = 0; y < surface->h; ++y) {
+        for (int x = 0; x < surface->w; ++x) {
+            if (pixelAt(surface, x, y)[3] != 0) {
+                minX = std::min(minX, x);
+                maxX = std::max(maxX, x);
+                minY = std::min(minY, y);
+                maxY = std::max(maxY, y);
+            }
+        }
+    }
+    if (maxX < 0) {
+        return {0, 0, 1, 1};
+    }
+    return {minX, minY, maxX - minX + 1, maxY - minY + 1};
+}
+
+/**
+ * @brief Copies the trimmed image into the page, then repeats its outermost texels extrude
+ * times around it so filtering at the edges never samples a neighbour.
+ */
+void blitExtruded(const Image& image, SDL_Surface* page, int extrude) {
+    const polaris::PackRect& src = image.trimmed;
+    const polaris::PackRect& dst = image.placed;
+    for (int y = -extrude; y < dst.height + extrude; ++y) {
+        const int sy = src.y + std::clamp(y, 0, src.height - 1);
+        for (int x = -extrude; x < dst.width + extrude; ++x) {
+            const int sx = src.x + std::clamp(x, 0, src.width - 1);
+            std::uint8_t* target = static_cast<std::uint8_t*>(page->pixels) +
+                                   (dst.y + y) * page->pitch + (dst.x + x) * 4;
+            std::memcpy(target, pixelAt(image.surface, sx, sy), 4);
+        }
+    }
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    int maxSize = 2048;
+    int padding = 2;
+    int extrude = 1;
+    bool trim = true;
+    std::vector<std::string> positional;
+
+    for (int i = 1; i < argc; ++i) {
+        if (std::strcmp(argv[i], "--max-size") == 0 && i + 1 < argc) {
+            maxSize = std::atoi(argv[++i]);
+        } else if (std::strcmp(argv[i], "--padding") == 0 && i + 1 < argc) {
+            padding = std::atoi(argv[++i]);
+        } else if (std::strcmp(argv[i], "--extrude") == 0 && i + 1 < argc) {
+            extrude = std::atoi(argv[++i]);
+        } else if (std::strcmp(argv[i], "--no-trim") == 0) {
+            trim = false;
+        } else if (std::strcmp(argv[i], "-h") == 0 || std::strcmp(argv[i], "--help") == 0) {
+            printUsage();
+            return 0;
+        } else {
+            positional.push_back(argv[i]);
+        }
+    }
+
+    if (positional.size() != 2 || maxSize <= 0 || maxSize > 32768 || nextPowerOfTwo(maxSize) != maxSize ||
+        padding < 0 || extrude < 0) {
+        printUsage();
+        return 1;
+    }
+
+    const std::filesystem::path inputDir = positional[0];
+    const std::filesystem::path outputPath = positional[1];
+
+    // Collect images in a stable order so repeated runs produce identical atlases
+    std::vector<std::filesystem::path> files;
+    std::error_code error;
+    for (std::filesystem::recursive_directory_iterator it(inputDir, error), end; !error && it != end; it.increment(error)) {
+        if (it->is_regular_file() && isImageFile(it->path())) {
+            files.push_back(it->path());
+        }
+    }
+    if (error || files.empty()) {
+        std::cerr << "No images found in " << inputDir.string() << std::endl;
+        return 1;
+    }
+    std::sort(files.begin(), files.end());
+
+    std::vector<Image> images;
+    std::vector<std::uint64_t> hashes;
+    for (const std::filesystem::path& file : files) {
+        SDL_Surface* loaded = IMG_Load(file.string().c_str());
+        SDL_Surface* surface = loaded ? SDL_ConvertSurface(loaded, SDL_PIXELFORMAT_RGBA32) : nullptr;
+        if (loaded) {
+            SDL_DestroySurface(loaded);
+        }
+        if (!surface) {
+            std::cerr << "Failed to load " << file.string() << ": " << SDL_GetError() << std::endl;
+            return 1;
+        }
+
+        Image image;
+        image.name = file.lexically_relative(inputDir).replace_extension().generic_string();
+        image.surface = surface;
+        image.trimmed = trim ? opaqueBounds(surface) : polaris::PackRect{0, 0, surface->w, surface->h};
+
+        const std::uint64_t hash = polaris::HashAtlasName(image.name);
+        if (hash == 0 || std::find(hashes.begin(), hashes.end(), hash) != hashes.end()) {
+            std::cerr << "Sprite name " << image.name << " is duplicated or collides with another name" << std::endl;
+            return 1;
+        }
+        hashes.push_back(hash);
+
+        if (image.trimmed.width + 2 * extrude + padding > maxSize ||
+            image.trimmed.height + 2 * extrude + padding > maxSize) {
+            std::cerr << image.name << " does not fit in a " << maxSize << "x" << maxSize << " page" << std::endl;
+            return 1;
+        }
+        images.push_back(image);
+    }
+
+    // Large images first: MaxRects packs tighter when the hard-to-place rectangles go in early
+    std::vector<Image*> remaining;
+    for (Image& image : images) {
+        remaining.push_back(&image);
+    }
+    std::stable_sort(remaining.begin(), remaining.end(), [](const Image* a, const Image* b) {
+        const int sideA = std::max(a->trimmed.width, a->trimmed.height);
+        const int sideB = std::max(b->trimmed.width, b->trimmed.height);
+        if (sideA != sideB) {
+            return sideA > sideB;
+        }
+        return a->trimmed.width * a->trimmed.height > b->trimmed.width * b->trimmed.height;
+    });
+
+    // Fill pages one at a time; what does not fit moves on to the next page
+    std::vector<polaris::AtlasPageInfo> pages;
+    while (!remaining.empty()) {
+        const int pageIndex = static_cast<int>(pages.size());
+        polaris::MaxRectsPacker packer(maxSize, maxSize);
+        std::vector<Image*> deferred;
+        int usedWidth = 0;
+        int usedHeight = 0;
+
+        for (Image* image : remaining) {
+            polaris::PackRect cell;
+            const int cellWidth = image->trimmed.width + 2 * extrude + padding;
+            const int cellHeight = image->trimmed.height + 2 * extrude + padding;
+            if (!packer.insert(cellWidth, cellHeight, cell)) {
+                deferred.push_back(image);
+                continue;
+            }
+            image->page = pageIndex;
+            image->placed = {cell.x + extrude, cell.y + extrude, image->trimmed.width, image->trimmed.height};
+            usedWidth = std::max(usedWidth, cell.x + cellWidth - padding);
+            usedHeight = std::max(usedHeight, cell.y + cellHeight - padding);
+        }
+
+        polaris::AtlasPageInfo page;
+        page.width = static_cast<std::uint16_t>(nextPowerOfTwo(usedWidth));
+        page.height = static_cast<std::uint16_t>(nextPowerOfTwo(usedHeight));
+        page.file = outputPath.stem().string() + "_" + std::to_string(pageIndex) + ".png";
+        pages.push_back(page);
+        remaining.swap(deferred);
+    }
+
+    std::vector<polaris::AtlasSpriteEntry> sprites;
+    int exitCode = 0;
+    for (std::size_t pageIndex = 0; pageIndex < pages.size(); ++pageIndex) {
+        const polaris::AtlasPageInfo& info = pages[pageIndex];
+        SDL_Surface* page = SDL_CreateSurface(info.width, info.height, SDL_PIXELFORMAT_RGBA32);
+        if (!page) {
+            std::cerr << "Failed to create page surface: " << SDL_GetError() << std::endl;
+            return 1;
+        }
+
+        for (const Image& image : images) {
+            if (image.page != static_cast<int>(pageIndex)) {
+                continue;
+            }
+            blitExtruded(image, page, extrude);
+
+            polaris::AtlasSpriteEntry entry;
+            entry.nameHash = polaris::HashAtlasName(image.name);
+            entry.page = static_cast<std::uint16_t>(pageIndex);
+            entry.x = static_cast<std::uint16_t>(image.placed.x);
+            entry.y = static_cast<std::uint16_t>(image.placed.y);
+            entry.width = static_cast<std::uint16_t>(image.placed.width);
+            entry.height = static_cast<std::uint16_t>(image.placed.height);
+            entry.trimX = static_cast<std::uint16_t>(image.trimmed.x);
+            entry.trimY = static_cast<std::uint16_t>(image.trimmed.y);
+            entry.sourceWidth = static_cast<std::uint16_t>(image.surface->w);
+            entry.sourceHeight = static_cast<std::uint16_t>(image.surface->h);
+            entry.u0 = static_cast<float>(image.placed.x) / info.width;
+            entry.v0 = static_cast<float>(image.placed.y) / info.height;
+            entry.u1 = static_cast<float>(image.placed.x + image.placed.width) / info.width;
+            entry.v1 = static_cast<float>(image.placed.y + image.placed.height) / info.height;
+            sprites.push_back(entry);
+        }
+
+        const std::string pagePath = (outputPath.parent_path() / info.file).string();
+        if (!IMG_SavePNG(page, pagePath.c_str())) {
+            std::cerr << "Failed to write " << pagePath << ": " << SDL_GetError() << std::endl;
+            exitCode = 1;
+        }
+        SDL_DestroySurface(page);
+        std::cout << info.file << ": " << info.width << "x" << info.height << std::endl;
+    }
+
+    for (Image& image : images) {
+        SDL_DestroySurface(image.surface);
+    }
+
+    if (exitCode == 0 && !polaris::WriteAtlasIndex(outputPath.string(), pages, sprites)) {
+        std::cerr << "Failed to write " << outputPath.string() << std::endl;
+        exitCode = 1;
+    }
+    if (exitCode == 0) {
+        std::cout << sprites.size() << " sprites on " << pages.size() << " pages" << std::endl;
+    }
+    return exitCode;
+}
@@ -0,0 +1,88 @@
+//
+// polaris-logdecode: converts binary (.plog) log files written by polaris::Logger back to text.
+//
+// Usage: polaris-logdecode [--sites] [-o output.log] file.plog [more.plog ...]
+//
+
+#include "BinaryLog.h"
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <vector>
+
+namespace {
+
+void printUsage() {
+    std::cerr << "Usage: polaris-logdecode [--sites] [-o output.log] file.plog [more.plog ...]\n"
+              << "  --sites   append the source file and line of each log call\n"
+              << "  -o FILE   write to FILE instead of stdout\n";
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    bool showSites = false;
+    std::string outputPath;
+    std::vector<std::string> inputs;
+
+    for (int i = 1; i < argc; ++i) {
+        if (std::strcmp(argv[i], "--sites") == 0) {
+            showSites = true;
+        } else if (std::strcmp(argv[i], "-o") == 0 && i + 1 < argc) {
+            outputPath = argv[++i];
+        } else if (std::strcmp(argv[i], "-h") == 0 || std::strcmp(argv[i], "--help") == 0) {
+            printUsage();
+            return 0;
+        } else {
+            inputs.push_back(argv[i]);
+        }
+    }
+
+    if (inputs.empty()) {
+        printUsage();
+        return 1;
+    }
+
+    std::ofstream outputFile;
+    if (!outputPath.empty()) {
+        outputFile.open(outputPath);
+        if (!outputFile.is_open()) {
+            std::cerr << "Failed to open output file: " << outputPath << std::endl;
+            return 1;
+        }
+    }
+    std::ostream& out = outputPath.empty() ? std::cout : outputFile;
+
+    int exitCode = 0;
+    for (const std::string& input : inputs) {
+        polaris::BinaryLogReader reader;
+        if (!reader.open(input)) {
+            std::cerr << "Not a readable .plog file: " << input << std::endl;
+            exitCode = 1;
+            continue;
+        }
+
+        polaris::BinaryLogReader::Entry entry;
+        std::size_t count = 0;
+        while (reader.next(entry)) {
+            out << reader.format(entry);
+            if (showSites) {
+                if (const polaris::BinaryLogReader::Site* site = reader.site(entry.siteId)) {
+                    if (!site->file.empty()) {
+                        out << "  (" << site->file << ':' << site->line << ')';
+                    }
+                }
+            }
+            out << '\n';
+            ++count;
+        }
+
+        if (!reader.atEnd()) {
+            std::cerr << input << ": stopped at a truncated or corrupt record after " << count << " entries" << std::endl;
+            exitCode = 1;
+        }
+    }
+
+    return exitCode;
+}
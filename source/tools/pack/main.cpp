@@ -0,0 +1,151 @@
+//
+// polaris-pack: packs a directory of assets into one .ppak file read (memory-mapped) by
+// polaris::AssetPack, compressing the entries that benefit from it.
+//
+// Usage: polaris-pack [--align N] [--no-compress] input-dir output.ppak
+//        polaris-pack --list pack.ppak
+//
+
+#include "assets/Lz4Block.h"
+#include "assets/PackFormat.h"
+#include <algorithm>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace {
+
+void printUsage() {
+    std::cerr << "Usage: polaris-pack [options] input-dir output.ppak\n"
+              << "       polaris-pack --list pack.ppak\n"
+              << "  --align N      alignment of entries smaller than a page, a power of two (default 16)\n"
+              << "  --no-compress  store every entry as-is\n"
+              << "  --list         print the entries of a pack and check that they decompress\n";
+}
+
+/**
+ * @brief Prints a pack's index and decompresses every compressed entry to check it.
+ */
+int listPack(const std::string& path) {
+    std::ifstream file(path, std::ios::binary);
+    polaris::PackHeader header;
+    if (!file.read(reinterpret_cast<char*>(&header), sizeof(header)) ||
+        std::memcmp(header.magic, polaris::kPackMagic, sizeof(header.magic)) != 0 ||
+        header.version != polaris::kPackVersion) {
+        std::cerr << path << " is not a version " << polaris::kPackVersion << " asset pack" << std::endl;
+        return 1;
+    }
+    std::vector<polaris::PackEntry> entries(header.entryCount);
+    std::string names(header.namesSize, '\0');
+    file.read(reinterpret_cast<char*>(entries.data()),
+              static_cast<std::streamsize>(entries.size() * sizeof(polaris::PackEntry)));
+    file.read(names.data(), static_cast<std::streamsize>(names.size()));
+    if (!file) {
+        std::cerr << path << " is truncated" << std::endl;
+        return 1;
+    }
+
+    // List in file order, which is the order the pack was built in
+    std::sort(entries.begin(), entries.end(),
+              [](const polaris::PackEntry& a, const polaris::PackEntry& b) { return a.offset < b.offset; });
+    int exitCode = 0;
+    std::vector<std::uint8_t> stored;
+    std::vector<std::uint8_t> data;
+    for (const polaris::PackEntry& entry : entries) {
+        const std::string name = static_cast<std::size_t>(entry.nameOffset) + entry.nameLength <= names.size()
+                                     ? names.substr(entry.nameOffset, entry.nameLength)
+                                     : std::string("<invalid name>");
+        std::cout << name << ": " << entry.size << " bytes";
+        if (entry.compression == static_cast<std::uint8_t>(polaris::PackCompression::Lz4)) {
+            std::cout << ", " << entry.storedSize << " stored";
+            stored.resize(static_cast<std::size_t>(entry.storedSize));
+            data.resize(static_cast<std::size_t>(entry.size));
+            file.seekg(static_cast<std::streamoff>(entry.offset));
+            if (!file.read(reinterpret_cast<char*>(stored.data()), static_cast<std::streamsize>(stored.size())) ||
+                !polaris::lz4Decompress(stored.data(), stored.size(), data.data(), data.size())) {
+                std::cout << " CORRUPT";
+                file.clear();
+                exitCode = 1;
+            }
+        }
+        std::cout << std::endl;
+    }
+    std::cout << entries.size() << " assets, " << header.fileSize << " bytes" << std::endl;
+    return exitCode;
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    polaris::PackWriteOptions options;
+    bool list = false;
+    std::vector<std::string> positional;
+
+    for (int i = 1; i < argc; ++i) {
+        if (std::strcmp(argv[i], "--align") == 0 && i + 1 < argc) {
+            options.alignment = static_cast<std::uint32_t>(std::atoi(argv[++i]));
+        } else if (std::strcmp(argv[i], "--no-compress") == 0) {
+            options.compress = false;
+        } else if (std::strcmp(argv[i], "--list") == 0) {
+            list = true;
+        } else if (std::strcmp(argv[i], "-h") == 0 || std::strcmp(argv[i], "--help") == 0) {
+            printUsage();
+            return 0;
+        } else {
+            positional.push_back(argv[i]);
+        }
+    }
+
+    if (list) {
+        if (positional.size() != 1) {
+            printUsage();
+            return 1;
+        }
+        return listPack(positional[0]);
+    }
+    if (positional.size() != 2) {
+        printUsage();
+        return 1;
+    }
+
+    const std::filesystem::path inputDir(positional[0]);
+    std::error_code ec;
+    if (!std::filesystem::is_directory(inputDir, ec)) {
+        std::cerr << inputDir.string() << " is not a directory" << std::endl;
+        return 1;
+    }
+
+    // Sorted names give the same pack, byte for byte, for the same directory
+    std::vector<polaris::PackSource> sources;
+    for (const auto& item : std::filesystem::recursive_directory_iterator(inputDir, ec)) {
+        if (item.is_regular_file()) {
+            polaris::PackSource source;
+            source.name = item.path().lexically_relative(inputDir).generic_string();
+            source.path = item.path().string();
+            sources.push_back(std::move(source));
+        }
+    }
+    if (ec) {
+        std::cerr << "Failed to scan " << inputDir.string() << ": " << ec.message() << std::endl;
+        return 1;
+    }
+    std::sort(sources.begin(), sources.end(),
+              [](const polaris::PackSource& a, const polaris::PackSource& b) { return a.name < b.name; });
+
+    polaris::PackWriteStats stats;
+    std::string error;
+    if (!polaris::writePack(positional[1], std::move(sources), options, stats, error)) {
+        std::cerr << "Failed to write " << positional[1] << ": " << error << std::endl;
+        return 1;
+    }
+
+    std::cout << stats.entries << " assets (" << stats.compressedEntries << " compressed), " << stats.originalBytes
+              << " bytes stored in " << stats.storedBytes << ", pack is " << stats.fileBytes << " bytes" << std::endl;
+    return 0;
+}